@@ -1,5 +1,4 @@
 struct Uniforms {
-  modelViewProjectionMatrix : mat4x4<f32>,
   frame: u32,
   frame_radians: f32,
   image_width: u32,
@@ -7,6 +6,8 @@ struct Uniforms {
 }
 
 @binding(0) @group(0) var<uniform> uniforms : Uniforms;
+// The entity drawn, written by radiant_renderables_draw.
+@binding(0) @group(1) var<uniform> modelViewProjectionMatrix : mat4x4<f32>;
 struct VertexInput {
   @location(0) pos: vec3f,
 }
@@ -18,7 +19,7 @@ struct VertexOutput {
 
 @vertex
 fn vs_main(in : VertexInput) -> VertexOutput {
-  let projected = uniforms.modelViewProjectionMatrix * vec4(in.pos, 1);
+  let projected = modelViewProjectionMatrix * vec4(in.pos, 1);
   var uv =  in.pos.xyz /
                 vec3(f32(uniforms.image_width), f32(uniforms.image_height), f32(uniforms.image_width));
   return VertexOutput(projected, uv);
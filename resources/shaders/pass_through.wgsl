@@ -1,10 +1,11 @@
 struct Uniforms {
-  modelViewProjectionMatrix : mat4x4<f32>,
   frame: u32,
   frame_radians: f32,
 }
 
 @binding(0) @group(0) var<uniform> uniforms : Uniforms;
+// The entity drawn, written by radiant_renderables_draw.
+@binding(0) @group(1) var<uniform> modelViewProjectionMatrix : mat4x4<f32>;
 struct VertexInput {
   @location(0) pos: vec3f,
   @location(1) color: vec3f,
@@ -21,7 +22,7 @@ fn vs_main(in : VertexInput) -> VertexOutput {
   let pos  = in.pos + select(vec3f(1, 0, 0), // sin(uniforms.frame_radians), 0),
                              vec3f(-1, 0, 0), //cos(uniforms.frame_radians), 0),
                              in.instance == 0);
-  let projected = uniforms.modelViewProjectionMatrix * vec4(pos, 1);
+  let projected = modelViewProjectionMatrix * vec4(pos, 1);
   return VertexOutput(projected, in.color);
 }
 
@@ -0,0 +1,241 @@
+// Ray casts a radiant_bvh_t in a compute shader, one primary ray per pixel
+// and one shadow ray towards the sun, writing into a storage texture which
+// vs_present/fs_present then draw to the swapchain.
+
+struct Uniforms {
+  inverse_projection_view: mat4x4f,
+  eye: vec3f,
+  width: u32,
+  sun_direction: vec3f,
+  height: u32,
+  sun_colour: vec3f,
+  node_count: u32,
+  sky_zenith: vec3f,
+  shadows: u32,
+  sky_horizon: vec3f,
+}
+
+// A radiant_bvh_node_t. Interior nodes have a zero count and their children
+// at first and first + 1, leaves cover count triangles from first.
+struct Node {
+  min_x: f32,
+  min_y: f32,
+  min_z: f32,
+  max_x: f32,
+  max_y: f32,
+  max_z: f32,
+  first: u32,
+  count: u32,
+}
+
+// A radiant_bvh_gpu_triangle_t.
+struct Triangle {
+  v0: vec3f,
+  colour0: u32,
+  edge1: vec3f,
+  colour1: u32,
+  edge2: vec3f,
+  colour2: u32,
+}
+
+struct Hit {
+  t: f32,
+  u: f32,
+  v: f32,
+  index: u32,
+}
+
+@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var<storage, read> nodes: array<Node>;
+@group(0) @binding(2) var<storage, read> triangles: array<Triangle>;
+@group(0) @binding(3) var output: texture_storage_2d<rgba8unorm, write>;
+
+// Read by fs_present, bound on its own by the present pipeline.
+@group(0) @binding(4) var presented: texture_2d<f32>;
+
+const kPi = 3.14159265;
+// Longer than any ray, there is no infinity literal.
+const kFar = 3.0e38;
+const kMiss = 0xffffffffu;
+// RADIANT_BVH_MAX_DEPTH, visiting the near child first never stacks more.
+const kStackSize = 64;
+
+fn sky(direction: vec3f) -> vec3f {
+  let height = max(direction.y, 0.0);
+  return mix(uniforms.sky_horizon, uniforms.sky_zenith, height);
+}
+
+// Returns where the ray enters the node, or kFar if it misses or only enters
+// beyond t_max.
+fn intersect_node(node: Node, origin: vec3f, inv: vec3f, t_max: f32) -> f32 {
+  let t0 = (vec3f(node.min_x, node.min_y, node.min_z) - origin) * inv;
+  let t1 = (vec3f(node.max_x, node.max_y, node.max_z) - origin) * inv;
+  let near = min(t0, t1);
+  let far = max(t0, t1);
+  let enter = max(max(near.x, near.y), max(near.z, 0.0));
+  let exit = min(min(far.x, far.y), min(far.z, t_max));
+  return select(kFar, enter, enter <= exit);
+}
+
+// Moller-Trumbore, returns (t, u, v) with t < 0 for a miss.
+fn intersect_triangle(tri: Triangle,
+                      origin: vec3f,
+                      direction: vec3f,
+                      t_max: f32) -> vec3f {
+  let p = cross(direction, tri.edge2);
+  let det = dot(tri.edge1, p);
+  if (abs(det) < 1e-12) {
+    return vec3f(-1.0);
+  }
+  let inv_det = 1.0 / det;
+  let s = origin - tri.v0;
+  let u = dot(s, p) * inv_det;
+  let q = cross(s, tri.edge1);
+  let v = dot(direction, q) * inv_det;
+  let t = dot(tri.edge2, q) * inv_det;
+  if (u < 0.0 || u > 1.0 || v < 0.0 || u + v > 1.0 || t < 0.0 || t > t_max) {
+    return vec3f(-1.0);
+  }
+  return vec3f(t, u, v);
+}
+
+// Returns the closest hit along the ray, or with any_hit the first found.
+fn trace(origin: vec3f, direction: vec3f, any_hit: bool) -> Hit {
+  var hit = Hit(kFar, 0.0, 0.0, kMiss);
+  if (uniforms.node_count == 0u) {
+    return hit;
+  }
+  // Zero components become tiny so the slabs stay finite.
+  let safe = select(direction, vec3f(1e-30), abs(direction) < vec3f(1e-30));
+  let inv = 1.0 / safe;
+
+  var stack: array<u32, kStackSize>;
+  var stack_t: array<f32, kStackSize>;
+  var top = 0u;
+  var current = 0u;
+  if (intersect_node(nodes[0], origin, inv, hit.t) == kFar) {
+    return hit;
+  }
+
+  loop {
+    let node = nodes[current];
+    if (node.count > 0u) {
+      for (var i = node.first; i < node.first + node.count; i++) {
+        let h = intersect_triangle(triangles[i], origin, direction, hit.t);
+        if (h.x >= 0.0) {
+          hit = Hit(h.x, h.y, h.z, i);
+          if (any_hit) {
+            return hit;
+          }
+        }
+      }
+    } else {
+      let left = node.first;
+      let right = node.first + 1u;
+      let t_left = intersect_node(nodes[left], origin, inv, hit.t);
+      let t_right = intersect_node(nodes[right], origin, inv, hit.t);
+      let near = select(right, left, t_left <= t_right);
+      let far = select(left, right, t_left <= t_right);
+      let t_near = min(t_left, t_right);
+      let t_far = max(t_left, t_right);
+      if (t_near < kFar) {
+        if (t_far < kFar) {
+          stack[top] = far;
+          stack_t[top] = t_far;
+          top++;
+        }
+        current = near;
+        continue;
+      }
+    }
+
+    // Pop the next node the ray still reaches before the closest hit.
+    var found = false;
+    while (top > 0u && !found) {
+      top--;
+      found = stack_t[top] <= hit.t;
+      current = stack[top];
+    }
+    if (!found) {
+      break;
+    }
+  }
+  return hit;
+}
+
+fn unpack_colour(colour: u32) -> vec3f {
+  return unpack4x8unorm(colour).rgb;
+}
+
+// Returns the radiance seen along the ray from the eye.
+fn shade(direction: vec3f) -> vec3f {
+  let hit = trace(uniforms.eye, direction, false);
+  if (hit.index == kMiss) {
+    return sky(direction);
+  }
+
+  let tri = triangles[hit.index];
+  var n = normalize(cross(tri.edge1, tri.edge2));
+  if (dot(n, direction) > 0.0) {
+    n = -n;
+  }
+  let w = 1.0 - hit.u - hit.v;
+  let albedo = unpack_colour(tri.colour0) * w +
+               unpack_colour(tri.colour1) * hit.u +
+               unpack_colour(tri.colour2) * hit.v;
+
+  // The sky lights the surface as if nothing blocked it.
+  var light = sky(n);
+  let cos_sun = dot(n, uniforms.sun_direction);
+  if (cos_sun > 0.0 && any(uniforms.sun_colour > vec3f(0.0))) {
+    var visible = true;
+    if (uniforms.shadows != 0u) {
+      // Lift the shadow ray off the surface so it does not hit it again.
+      let p = uniforms.eye + direction * hit.t;
+      let scale = max(max(abs(p.x), abs(p.y)), abs(p.z));
+      let origin = p + n * (1e-4 * (1.0 + scale));
+      visible = trace(origin, uniforms.sun_direction, true).index == kMiss;
+    }
+    if (visible) {
+      light += uniforms.sun_colour * (cos_sun / kPi);
+    }
+  }
+  return albedo * light;
+}
+
+@compute @workgroup_size(8, 8)
+fn cs_main(@builtin(global_invocation_id) id: vec3u) {
+  if (id.x >= uniforms.width || id.y >= uniforms.height) {
+    return;
+  }
+
+  // Any depth between the planes lies on the ray, halfway suits both depth
+  // ranges.
+  let pixel = vec2f(id.xy) + vec2f(0.5);
+  let size = vec2f(f32(uniforms.width), f32(uniforms.height));
+  let ndc = vec2f(pixel.x / size.x * 2.0 - 1.0, 1.0 - pixel.y / size.y * 2.0);
+  let p = uniforms.inverse_projection_view * vec4f(ndc, 0.5, 1.0);
+  let direction = normalize(p.xyz / p.w - uniforms.eye);
+
+  textureStore(output, id.xy, vec4f(shade(direction), 1.0));
+}
+
+struct PresentOutput {
+  @builtin(position) pos: vec4f,
+  @location(0) uv: vec2f,
+}
+
+// A triangle covering the target.
+@vertex
+fn vs_present(@builtin(vertex_index) index: u32) -> PresentOutput {
+  let uv = vec2f(f32((index << 1u) & 2u), f32(index & 2u));
+  let pos = vec4f(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, 0.0, 1.0);
+  return PresentOutput(pos, uv);
+}
+
+@fragment
+fn fs_present(in: PresentOutput) -> @location(0) vec4f {
+  let size = textureDimensions(presented);
+  let texel = min(vec2u(in.uv * vec2f(size)), size - vec2u(1u));
+  return textureLoad(presented, texel, 0);
+}
@@ -0,0 +1,337 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/adapter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/array_element_count.h"
+#include "src/assert.h"
+
+typedef struct named_policy_t {
+  const char* name;
+  radiant_adapter_policy_t policy;
+  /// Unused padding
+  RADIANT_PAD(4);
+} named_policy_t;
+
+typedef struct named_backend_t {
+  const char* name;
+  WGPUBackendType backend;
+  /// Unused padding
+  RADIANT_PAD(4);
+} named_backend_t;
+
+static const named_policy_t kPolicies[] = {
+    {.name = "high-performance",
+     .policy = radiant_adapter_policy_high_performance},
+    {.name = "low-power", .policy = radiant_adapter_policy_low_power},
+    {.name = "software", .policy = radiant_adapter_policy_software},
+};
+
+static const named_backend_t kBackends[] = {
+    {.name = "d3d11", .backend = WGPUBackendType_D3D11},
+    {.name = "d3d12", .backend = WGPUBackendType_D3D12},
+    {.name = "metal", .backend = WGPUBackendType_Metal},
+    {.name = "vulkan", .backend = WGPUBackendType_Vulkan},
+    {.name = "opengl", .backend = WGPUBackendType_OpenGL},
+    {.name = "opengles", .backend = WGPUBackendType_OpenGLES},
+    {.name = "null", .backend = WGPUBackendType_Null},
+};
+
+radiant_adapter_features_t radiant_adapter_features_from_list(
+    const WGPUFeatureName* features,
+    uint32_t count) {
+  RADIANT_ASSERT(features || count == 0);
+  radiant_adapter_features_t set = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    if ((uint32_t)features[i] < 64) {
+      set |= RADIANT_ADAPTER_FEATURE(features[i]);
+    }
+  }
+  return set;
+}
+
+radiant_adapter_limits_t radiant_adapter_limits_from_wgpu(
+    const WGPULimits* limits) {
+  RADIANT_ASSERT(limits);
+  return (radiant_adapter_limits_t){
+      .max_buffer_size = limits->maxBufferSize,
+      .max_storage_buffer_binding_size = limits->maxStorageBufferBindingSize,
+      .max_uniform_buffer_binding_size = limits->maxUniformBufferBindingSize,
+      .max_bind_groups = limits->maxBindGroups,
+      .max_storage_buffers_per_shader_stage =
+          limits->maxStorageBuffersPerShaderStage,
+      .max_compute_workgroup_storage_size =
+          limits->maxComputeWorkgroupStorageSize,
+      .max_compute_invocations_per_workgroup =
+          limits->maxComputeInvocationsPerWorkgroup,
+  };
+}
+
+void radiant_adapter_limits_to_wgpu(radiant_adapter_limits_t limits,
+                                    WGPULimits* out) {
+  RADIANT_ASSERT(out);
+  if (limits.max_buffer_size) {
+    out->maxBufferSize = limits.max_buffer_size;
+  }
+  if (limits.max_storage_buffer_binding_size) {
+    out->maxStorageBufferBindingSize = limits.max_storage_buffer_binding_size;
+  }
+  if (limits.max_uniform_buffer_binding_size) {
+    out->maxUniformBufferBindingSize = limits.max_uniform_buffer_binding_size;
+  }
+  if (limits.max_bind_groups) {
+    out->maxBindGroups = limits.max_bind_groups;
+  }
+  if (limits.max_storage_buffers_per_shader_stage) {
+    out->maxStorageBuffersPerShaderStage =
+        limits.max_storage_buffers_per_shader_stage;
+  }
+  if (limits.max_compute_workgroup_storage_size) {
+    out->maxComputeWorkgroupStorageSize =
+        limits.max_compute_workgroup_storage_size;
+  }
+  if (limits.max_compute_invocations_per_workgroup) {
+    out->maxComputeInvocationsPerWorkgroup =
+        limits.max_compute_invocations_per_workgroup;
+  }
+}
+
+/// Negotiates one limit, |requested| of an adapter that has |available|.
+/// Returns false if it cannot be met.
+static bool negotiate_u64(uint64_t* requested, uint64_t available, bool clamp) {
+  if (*requested <= available) {
+    return true;
+  }
+  *requested = available;
+  return clamp;
+}
+
+static bool negotiate_u32(uint32_t* requested, uint32_t available, bool clamp) {
+  if (*requested <= available) {
+    return true;
+  }
+  *requested = available;
+  return clamp;
+}
+
+radiant_adapter_negotiate_result_t radiant_adapter_negotiate(
+    const radiant_adapter_requirements_t* requirements,
+    radiant_adapter_features_t features,
+    const radiant_adapter_limits_t* limits) {
+  RADIANT_ASSERT(requirements);
+  RADIANT_ASSERT(limits);
+  radiant_adapter_negotiate_result_t result = {0};
+  if ((requirements->required_features & ~features) != 0) {
+    return result;
+  }
+  result.features = requirements->required_features |
+                    (requirements->optional_features & features);
+
+  radiant_adapter_limits_t* out = &result.limits;
+  *out = requirements->limits;
+  bool clamp = requirements->clamp_limits;
+  bool met = true;
+  met &= negotiate_u64(&out->max_buffer_size, limits->max_buffer_size, clamp);
+  met &= negotiate_u64(&out->max_storage_buffer_binding_size,
+                       limits->max_storage_buffer_binding_size, clamp);
+  met &= negotiate_u64(&out->max_uniform_buffer_binding_size,
+                       limits->max_uniform_buffer_binding_size, clamp);
+  met &= negotiate_u32(&out->max_bind_groups, limits->max_bind_groups, clamp);
+  met &= negotiate_u32(&out->max_storage_buffers_per_shader_stage,
+                       limits->max_storage_buffers_per_shader_stage, clamp);
+  met &= negotiate_u32(&out->max_compute_workgroup_storage_size,
+                       limits->max_compute_workgroup_storage_size, clamp);
+  met &= negotiate_u32(&out->max_compute_invocations_per_workgroup,
+                       limits->max_compute_invocations_per_workgroup, clamp);
+  result.succeeded = met;
+  return result;
+}
+
+/// Returns true if the |len| characters at |token| are exactly |name|.
+static bool token_is(const char* token, size_t len, const char* name) {
+  return strlen(name) == len && strncmp(token, name, len) == 0;
+}
+
+bool radiant_adapter_selection_parse(const char* text,
+                                     radiant_adapter_selection_t* selection) {
+  RADIANT_ASSERT(text);
+  RADIANT_ASSERT(selection);
+  radiant_adapter_selection_t parsed = *selection;
+  bool has_policy = false;
+  bool has_backend = false;
+
+  const char* token = text;
+  for (;;) {
+    size_t len = strcspn(token, ",");
+    bool matched = false;
+    for (uint32_t i = 0; i < RADIANT_ARRAY_ELEMENT_COUNT(kPolicies); ++i) {
+      if (token_is(token, len, kPolicies[i].name)) {
+        if (has_policy) {
+          return false;
+        }
+        parsed.policy = kPolicies[i].policy;
+        has_policy = true;
+        matched = true;
+      }
+    }
+    for (uint32_t i = 0; i < RADIANT_ARRAY_ELEMENT_COUNT(kBackends); ++i) {
+      if (token_is(token, len, kBackends[i].name)) {
+        if (has_backend) {
+          return false;
+        }
+        parsed.backend = kBackends[i].backend;
+        has_backend = true;
+        matched = true;
+      }
+    }
+    if (!matched) {
+      return false;
+    }
+    if (token[len] == '\0') {
+      break;
+    }
+    token += len + 1;
+  }
+
+  *selection = parsed;
+  return true;
+}
+
+radiant_adapter_selection_t radiant_adapter_selection_from_environment(
+    radiant_adapter_selection_t fallback) {
+  const char* text = getenv(RADIANT_ADAPTER_ENVIRONMENT);
+  if (!text) {
+    return fallback;
+  }
+  radiant_adapter_selection_t selection = fallback;
+  if (!radiant_adapter_selection_parse(text, &selection)) {
+    fprintf(stderr, "Ignoring unknown %s: %s\n", RADIANT_ADAPTER_ENVIRONMENT,
+            text);
+    return fallback;
+  }
+  return selection;
+}
+
+/// Returns the preference for |type| under |policy|, zero if unacceptable.
+static uint32_t type_rank(WGPUAdapterType type,
+                          radiant_adapter_policy_t policy) {
+  if (policy == radiant_adapter_policy_software) {
+    return type == WGPUAdapterType_CPU ? 1 : 0;
+  }
+  bool low_power = policy == radiant_adapter_policy_low_power;
+  switch (type) {
+    case WGPUAdapterType_DiscreteGPU:
+      return low_power ? 3 : 4;
+    case WGPUAdapterType_IntegratedGPU:
+      return low_power ? 4 : 3;
+    case WGPUAdapterType_Unknown:
+      return 2;
+    case WGPUAdapterType_CPU:
+      return 1;
+    case WGPUAdapterType_Force32:
+      break;
+  }
+  return 0;
+}
+
+/// Returns the preference for |backend|, native APIs over translated ones.
+static uint32_t backend_rank(WGPUBackendType backend) {
+  switch (backend) {
+    case WGPUBackendType_D3D12:
+    case WGPUBackendType_Metal:
+    case WGPUBackendType_Vulkan:
+      return 3;
+    case WGPUBackendType_D3D11:
+      return 2;
+    case WGPUBackendType_OpenGL:
+    case WGPUBackendType_OpenGLES:
+    case WGPUBackendType_WebGPU:
+    case WGPUBackendType_Null:
+      return 1;
+    case WGPUBackendType_Undefined:
+    case WGPUBackendType_Force32:
+      break;
+  }
+  return 0;
+}
+
+uint32_t radiant_adapter_score(const radiant_adapter_info_t* info,
+                               radiant_adapter_selection_t selection) {
+  RADIANT_ASSERT(info);
+  WGPUBackendType backend = info->properties.backendType;
+  if (selection.backend == WGPUBackendType_Undefined
+          ? backend == WGPUBackendType_Null
+          : backend != selection.backend) {
+    return 0;
+  }
+  uint32_t type = type_rank(info->properties.adapterType, selection.policy);
+  if (type == 0) {
+    return 0;
+  }
+  radiant_adapter_limits_t limits =
+      radiant_adapter_limits_from_wgpu(&info->limits.limits);
+  radiant_adapter_features_t feature_set =
+      radiant_adapter_features_from_list(info->features, info->feature_count);
+  if (!radiant_adapter_negotiate(&selection.requirements, feature_set,
+                                 &limits)
+           .succeeded) {
+    return 0;
+  }
+  uint32_t features = info->feature_count < 255 ? info->feature_count : 255;
+  return (type << 16) | (backend_rank(backend) << 8) | features;
+}
+
+uint32_t radiant_adapter_select(const radiant_adapter_info_t* infos,
+                                uint32_t count,
+                                radiant_adapter_selection_t selection) {
+  RADIANT_ASSERT(infos || count == 0);
+  uint32_t best = RADIANT_ADAPTER_NONE;
+  uint32_t best_score = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t score = radiant_adapter_score(&infos[i], selection);
+    if (score > best_score) {
+      best = i;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+const char* radiant_adapter_backend_name(WGPUBackendType backend) {
+  for (uint32_t i = 0; i < RADIANT_ARRAY_ELEMENT_COUNT(kBackends); ++i) {
+    if (kBackends[i].backend == backend) {
+      return kBackends[i].name;
+    }
+  }
+  return backend == WGPUBackendType_WebGPU ? "webgpu" : "unknown";
+}
+
+const char* radiant_adapter_type_name(WGPUAdapterType type) {
+  switch (type) {
+    case WGPUAdapterType_DiscreteGPU:
+      return "discrete GPU";
+    case WGPUAdapterType_IntegratedGPU:
+      return "integrated GPU";
+    case WGPUAdapterType_CPU:
+      return "CPU";
+    case WGPUAdapterType_Unknown:
+    case WGPUAdapterType_Force32:
+      break;
+  }
+  return "unknown";
+}
@@ -0,0 +1,164 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/pad.h"
+#include "src/wgpu.h"
+
+/// Returned by radiant_adapter_select when no adapter is acceptable.
+#define RADIANT_ADAPTER_NONE UINT32_MAX
+
+/// The environment variable radiant_adapter_selection_from_environment reads.
+#define RADIANT_ADAPTER_ENVIRONMENT "RADIANT_ADAPTER"
+
+/// How an adapter is chosen among those available
+typedef enum radiant_adapter_policy_t {
+  /// The adapter WebGPU picks by default, without enumerating
+  radiant_adapter_policy_default,
+  /// Prefers discrete GPUs, then integrated GPUs
+  radiant_adapter_policy_high_performance,
+  /// Prefers integrated GPUs, then discrete GPUs
+  radiant_adapter_policy_low_power,
+  /// Only accepts CPU adapters, SwiftShader or lavapipe
+  radiant_adapter_policy_software,
+} radiant_adapter_policy_t;
+
+/// A set of standard WebGPU features, see RADIANT_ADAPTER_FEATURE
+typedef uint64_t radiant_adapter_features_t;
+
+/// Returns the bit of feature |name| in a radiant_adapter_features_t. Only
+/// the standard features fit, Dawn's own start well above 64.
+#define RADIANT_ADAPTER_FEATURE(name) ((radiant_adapter_features_t)1 << (name))
+
+/// The device limits radiant uses. In requirements zero keeps the WebGPU
+/// default, anything else is the least the device must have.
+typedef struct radiant_adapter_limits_t {
+  uint64_t max_buffer_size;
+  uint64_t max_storage_buffer_binding_size;
+  uint64_t max_uniform_buffer_binding_size;
+  uint32_t max_bind_groups;
+  uint32_t max_storage_buffers_per_shader_stage;
+  uint32_t max_compute_workgroup_storage_size;
+  uint32_t max_compute_invocations_per_workgroup;
+} radiant_adapter_limits_t;
+
+/// What a device must, or would like to, support
+typedef struct radiant_adapter_requirements_t {
+  /// Features the device cannot be created without
+  radiant_adapter_features_t required_features;
+  /// Features enabled when the adapter has them
+  radiant_adapter_features_t optional_features;
+  /// Limits above the WebGPU defaults
+  radiant_adapter_limits_t limits;
+  /// If true limits beyond the adapter are lowered to the adapter's,
+  /// otherwise they rule the adapter out.
+  bool clamp_limits;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_adapter_requirements_t;
+
+/// An adapter selection, the zero value picks the default adapter with no
+/// requirements.
+typedef struct radiant_adapter_selection_t {
+  radiant_adapter_policy_t policy;
+  /// Only adapters of this backend are accepted, WGPUBackendType_Undefined
+  /// for any backend but the null one. WGPUBackendType_Null selects Dawn's
+  /// null backend, which validates commands but never executes them.
+  WGPUBackendType backend;
+  /// Adapters that cannot meet these are not accepted
+  radiant_adapter_requirements_t requirements;
+} radiant_adapter_selection_t;
+
+/// Result of negotiating requirements with an adapter
+typedef struct radiant_adapter_negotiate_result_t {
+  /// The features to enable. Only valid if |succeeded| is true.
+  radiant_adapter_features_t features;
+  /// The limits to ask for, zero for the default. Only valid if |succeeded|
+  /// is true.
+  radiant_adapter_limits_t limits;
+  /// True if the adapter meets the requirements. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_adapter_negotiate_result_t;
+
+/// An adapter and what it is capable of
+typedef struct radiant_adapter_info_t {
+  WGPUAdapter adapter;
+  /// The strings are owned by |adapter|
+  WGPUAdapterProperties properties;
+  WGPUSupportedLimits limits;
+  /// The |feature_count| features the adapter supports
+  WGPUFeatureName* features;
+  uint32_t feature_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_adapter_info_t;
+
+/// Returns the standard features among the |count| in |features|.
+radiant_adapter_features_t radiant_adapter_features_from_list(
+    const WGPUFeatureName* features,
+    uint32_t count);
+
+/// Returns the limits radiant uses out of |limits|.
+radiant_adapter_limits_t radiant_adapter_limits_from_wgpu(
+    const WGPULimits* limits);
+
+/// Stores the non zero fields of |limits| into |out|, leaving the rest.
+void radiant_adapter_limits_to_wgpu(radiant_adapter_limits_t limits,
+                                    WGPULimits* out);
+
+/// Checks |requirements| against an adapter with |features| and |limits|
+/// and returns what to create its device with.
+radiant_adapter_negotiate_result_t radiant_adapter_negotiate(
+    const radiant_adapter_requirements_t* requirements,
+    radiant_adapter_features_t features,
+    const radiant_adapter_limits_t* limits);
+
+/// Parses a comma separated selection from |text| into |selection|, at most
+/// one policy, "high-performance", "low-power" or "software", and one
+/// backend, "d3d11", "d3d12", "metal", "vulkan", "opengl", "opengles" or
+/// "null". Unset parts and the requirements are left as they were. Returns
+/// false, leaving |selection| untouched, if |text| has anything else.
+bool radiant_adapter_selection_parse(const char* text,
+                                     radiant_adapter_selection_t* selection);
+
+/// Returns the selection in the RADIANT_ADAPTER environment variable, or
+/// |fallback| if it is unset or cannot be parsed.
+radiant_adapter_selection_t radiant_adapter_selection_from_environment(
+    radiant_adapter_selection_t fallback);
+
+/// Returns how well |info| suits |selection|, higher is better and zero
+/// means unacceptable, as are adapters that do not meet the requirements.
+/// Adapter type ranks first, then native backends over
+/// translated ones, then the number of features.
+uint32_t radiant_adapter_score(const radiant_adapter_info_t* info,
+                               radiant_adapter_selection_t selection);
+
+/// Returns the index of the best of the |count| adapters in |infos| for
+/// |selection|, the first on a tie, or RADIANT_ADAPTER_NONE if none is
+/// acceptable.
+uint32_t radiant_adapter_select(const radiant_adapter_info_t* infos,
+                                uint32_t count,
+                                radiant_adapter_selection_t selection);
+
+/// Returns a printable name for |backend|.
+const char* radiant_adapter_backend_name(WGPUBackendType backend);
+
+/// Returns a printable name for |type|.
+const char* radiant_adapter_type_name(WGPUAdapterType type);
@@ -0,0 +1,251 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/adapter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/test.h"
+
+/// Features for test adapters, which have the first |feature_count|.
+static WGPUFeatureName kFeatures[] = {
+    WGPUFeatureName_DepthClipControl,
+    WGPUFeatureName_Depth32FloatStencil8,
+    WGPUFeatureName_TimestampQuery,
+    WGPUFeatureName_PipelineStatisticsQuery,
+    WGPUFeatureName_TextureCompressionBC,
+    WGPUFeatureName_TextureCompressionETC2,
+    WGPUFeatureName_TextureCompressionASTC,
+    WGPUFeatureName_IndirectFirstInstance,
+    WGPUFeatureName_ShaderF16,
+    WGPUFeatureName_RG11B10UfloatRenderable,
+};
+
+static radiant_adapter_info_t info(WGPUAdapterType type,
+                                   WGPUBackendType backend,
+                                   uint32_t feature_count) {
+  return (radiant_adapter_info_t){
+      .properties =
+          {
+              .adapterType = type,
+              .backendType = backend,
+          },
+      .limits =
+          {
+              .limits =
+                  {
+                      .maxBufferSize = 1 << 28,
+                      .maxBindGroups = 4,
+                  },
+          },
+      .features = kFeatures,
+      .feature_count = feature_count,
+  };
+}
+
+static bool parse() {
+  radiant_adapter_selection_t selection = {0};
+  RADIANT_EXPECT_TRUE(radiant_adapter_selection_parse("low-power", &selection));
+  RADIANT_EXPECT_EQ(selection.policy, radiant_adapter_policy_low_power);
+  RADIANT_EXPECT_EQ(selection.backend, WGPUBackendType_Undefined);
+
+  RADIANT_EXPECT_TRUE(
+      radiant_adapter_selection_parse("vulkan,software", &selection));
+  RADIANT_EXPECT_EQ(selection.policy, radiant_adapter_policy_software);
+  RADIANT_EXPECT_EQ(selection.backend, WGPUBackendType_Vulkan);
+
+  // A backend alone keeps the policy.
+  RADIANT_EXPECT_TRUE(radiant_adapter_selection_parse("null", &selection));
+  RADIANT_EXPECT_EQ(selection.policy, radiant_adapter_policy_software);
+  RADIANT_EXPECT_EQ(selection.backend, WGPUBackendType_Null);
+
+  // Failures leave the selection alone.
+  radiant_adapter_selection_t before = selection;
+  RADIANT_EXPECT_FALSE(radiant_adapter_selection_parse("", &selection));
+  RADIANT_EXPECT_FALSE(radiant_adapter_selection_parse("fast", &selection));
+  RADIANT_EXPECT_FALSE(radiant_adapter_selection_parse("vulkan,", &selection));
+  RADIANT_EXPECT_FALSE(
+      radiant_adapter_selection_parse("metal,vulkan", &selection));
+  RADIANT_EXPECT_FALSE(
+      radiant_adapter_selection_parse("software,low-power", &selection));
+  RADIANT_EXPECT_FALSE(radiant_adapter_selection_parse("vulkanx", &selection));
+  RADIANT_EXPECT_TRUE(memcmp(&before, &selection, sizeof(selection)) == 0);
+  return true;
+}
+
+static bool environment() {
+  radiant_adapter_selection_t fallback = {
+      .policy = radiant_adapter_policy_high_performance,
+  };
+  unsetenv(RADIANT_ADAPTER_ENVIRONMENT);
+  RADIANT_EXPECT_EQ(radiant_adapter_selection_from_environment(fallback).policy,
+                    radiant_adapter_policy_high_performance);
+
+  setenv(RADIANT_ADAPTER_ENVIRONMENT, "software", 1);
+  RADIANT_EXPECT_EQ(radiant_adapter_selection_from_environment(fallback).policy,
+                    radiant_adapter_policy_software);
+
+  setenv(RADIANT_ADAPTER_ENVIRONMENT, "no-such-policy", 1);
+  RADIANT_EXPECT_EQ(radiant_adapter_selection_from_environment(fallback).policy,
+                    radiant_adapter_policy_high_performance);
+  unsetenv(RADIANT_ADAPTER_ENVIRONMENT);
+  return true;
+}
+
+static bool select_by_policy() {
+  radiant_adapter_info_t infos[] = {
+      info(WGPUAdapterType_CPU, WGPUBackendType_Vulkan, 10),
+      info(WGPUAdapterType_IntegratedGPU, WGPUBackendType_Vulkan, 4),
+      info(WGPUAdapterType_DiscreteGPU, WGPUBackendType_OpenGLES, 2),
+      info(WGPUAdapterType_DiscreteGPU, WGPUBackendType_Vulkan, 2),
+      info(WGPUAdapterType_CPU, WGPUBackendType_Null, 0),
+  };
+  uint32_t count = 5;
+  radiant_adapter_selection_t selection = {
+      .policy = radiant_adapter_policy_high_performance,
+  };
+  // Native backends win over translated ones.
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, count, selection), 3);
+
+  selection.policy = radiant_adapter_policy_low_power;
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, count, selection), 1);
+
+  selection.policy = radiant_adapter_policy_software;
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, count, selection), 0);
+
+  selection.policy = radiant_adapter_policy_high_performance;
+  selection.backend = WGPUBackendType_OpenGLES;
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, count, selection), 2);
+
+  // The null backend only when asked for.
+  selection.backend = WGPUBackendType_Null;
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, count, selection), 4);
+  RADIANT_EXPECT_EQ(radiant_adapter_score(&infos[4],
+                                          (radiant_adapter_selection_t){0}),
+                    0);
+
+  selection.backend = WGPUBackendType_Metal;
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, count, selection),
+                    RADIANT_ADAPTER_NONE);
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, 0, selection),
+                    RADIANT_ADAPTER_NONE);
+  return true;
+}
+
+static bool ties_and_features() {
+  radiant_adapter_info_t infos[] = {
+      info(WGPUAdapterType_DiscreteGPU, WGPUBackendType_Vulkan, 2),
+      info(WGPUAdapterType_DiscreteGPU, WGPUBackendType_Vulkan, 2),
+      info(WGPUAdapterType_DiscreteGPU, WGPUBackendType_Vulkan, 3),
+  };
+  radiant_adapter_selection_t selection = {0};
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, 2, selection), 0);
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, 3, selection), 2);
+  return true;
+}
+
+static bool negotiate() {
+  radiant_adapter_features_t clip =
+      RADIANT_ADAPTER_FEATURE(WGPUFeatureName_DepthClipControl);
+  radiant_adapter_features_t depth32 =
+      RADIANT_ADAPTER_FEATURE(WGPUFeatureName_Depth32FloatStencil8);
+  radiant_adapter_features_t timestamp =
+      RADIANT_ADAPTER_FEATURE(WGPUFeatureName_TimestampQuery);
+  radiant_adapter_features_t f16 =
+      RADIANT_ADAPTER_FEATURE(WGPUFeatureName_ShaderF16);
+  radiant_adapter_features_t features =
+      radiant_adapter_features_from_list(kFeatures, 3);
+  RADIANT_EXPECT_TRUE(features == (clip | depth32 | timestamp));
+  radiant_adapter_limits_t limits = {
+      .max_buffer_size = 1 << 30,
+      .max_bind_groups = 4,
+  };
+
+  radiant_adapter_requirements_t requirements = {
+      .required_features = timestamp,
+      .optional_features = clip | f16,
+      .limits = {.max_buffer_size = 1 << 29},
+  };
+  radiant_adapter_negotiate_result_t result =
+      radiant_adapter_negotiate(&requirements, features, &limits);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  // Optional features the adapter lacks are left out.
+  RADIANT_EXPECT_TRUE(result.features == (timestamp | clip));
+  RADIANT_EXPECT_TRUE(result.limits.max_buffer_size == 1 << 29);
+  RADIANT_EXPECT_EQ(result.limits.max_bind_groups, 0);
+
+  // Missing required features or limits fail, unless limits clamp.
+  requirements.limits.max_bind_groups = 8;
+  RADIANT_EXPECT_FALSE(
+      radiant_adapter_negotiate(&requirements, features, &limits).succeeded);
+  requirements.clamp_limits = true;
+  result = radiant_adapter_negotiate(&requirements, features, &limits);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  RADIANT_EXPECT_EQ(result.limits.max_bind_groups, 4);
+  requirements.required_features |= f16;
+  RADIANT_EXPECT_FALSE(
+      radiant_adapter_negotiate(&requirements, features, &limits).succeeded);
+
+  // Limits only overwrite what was asked for.
+  WGPULimits wgpu_limits = {
+      .maxBufferSize = WGPU_LIMIT_U64_UNDEFINED,
+      .maxBindGroups = WGPU_LIMIT_U32_UNDEFINED,
+  };
+  radiant_adapter_limits_to_wgpu(result.limits, &wgpu_limits);
+  RADIANT_EXPECT_TRUE(wgpu_limits.maxBufferSize == 1 << 29);
+  RADIANT_EXPECT_EQ(wgpu_limits.maxBindGroups, 4);
+  RADIANT_EXPECT_TRUE(wgpu_limits.maxStorageBufferBindingSize == 0);
+  return true;
+}
+
+static bool select_with_requirements() {
+  radiant_adapter_info_t infos[] = {
+      info(WGPUAdapterType_DiscreteGPU, WGPUBackendType_Vulkan, 2),
+      info(WGPUAdapterType_IntegratedGPU, WGPUBackendType_Vulkan, 8),
+  };
+  radiant_adapter_selection_t selection = {0};
+  selection.requirements.required_features =
+      RADIANT_ADAPTER_FEATURE(WGPUFeatureName_IndirectFirstInstance);
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, 2, selection), 1);
+
+  selection.requirements.limits.max_bind_groups = 5;
+  RADIANT_EXPECT_EQ(radiant_adapter_select(infos, 2, selection),
+                    RADIANT_ADAPTER_NONE);
+  return true;
+}
+
+static bool names() {
+  RADIANT_EXPECT_TRUE(
+      strcmp(radiant_adapter_backend_name(WGPUBackendType_Vulkan), "vulkan") ==
+      0);
+  RADIANT_EXPECT_TRUE(
+      strcmp(radiant_adapter_backend_name(WGPUBackendType_Undefined),
+             "unknown") == 0);
+  RADIANT_EXPECT_TRUE(
+      strcmp(radiant_adapter_type_name(WGPUAdapterType_CPU), "CPU") == 0);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("adapter");
+  RADIANT_TEST(parse);
+  RADIANT_TEST(environment);
+  RADIANT_TEST(select_by_policy);
+  RADIANT_TEST(ties_and_features);
+  RADIANT_TEST(negotiate);
+  RADIANT_TEST(select_with_requirements);
+  RADIANT_TEST(names);
+  return radiant_suite_end();
+}
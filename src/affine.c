@@ -0,0 +1,154 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/affine.h"
+
+#include <math.h>
+
+#include "src/simd.h"
+
+radiant_affine_t radiant_affine_identity(void) {
+  return (radiant_affine_t){
+      // clang-format off
+      .data = {
+          1.f, 0.f, 0.f, 0.f,
+          0.f, 1.f, 0.f, 0.f,
+          0.f, 0.f, 1.f, 0.f,
+      },
+      // clang-format on
+  };
+}
+
+radiant_affine_t radiant_affine_from_mat4x4(radiant_mat4x4_t m) {
+  radiant_affine_t a;
+  for (uint32_t row = 0; row < 3; ++row) {
+    for (uint32_t col = 0; col < 4; ++col) {
+      a.data[(row * 4) + col] = m.data[(col * 4) + row];
+    }
+  }
+  return a;
+}
+
+radiant_affine_t radiant_trs_to_affine(radiant_trs_t trs) {
+  radiant_mat3x3_t r = radiant_quat_to_mat3x3(trs.rotation);
+  radiant_vec3_t s = trs.scale;
+  radiant_vec3_t t = trs.translation;
+  return (radiant_affine_t){
+      // clang-format off
+      .data = {
+          r.data[0] * s.x, r.data[4] * s.y, r.data[8] * s.z, t.x,
+          r.data[1] * s.x, r.data[5] * s.y, r.data[9] * s.z, t.y,
+          r.data[2] * s.x, r.data[6] * s.y, r.data[10] * s.z, t.z,
+      },
+      // clang-format on
+  };
+}
+
+radiant_mat4x4_t radiant_affine_to_mat4x4(radiant_affine_t a) {
+  radiant_mat4x4_t m;
+  for (uint32_t col = 0; col < 4; ++col) {
+    for (uint32_t row = 0; row < 3; ++row) {
+      m.data[(col * 4) + row] = a.data[(row * 4) + col];
+    }
+    m.data[(col * 4) + 3] = col == 3 ? 1.f : 0.f;
+  }
+  return m;
+}
+
+radiant_affine_t radiant_affine_mul(radiant_affine_t a, radiant_affine_t b) {
+  radiant_affine_t r;
+  radiant_simd_ops()->affine_mul(&r, &a, &b);
+  return r;
+}
+
+radiant_point3_t radiant_affine_transform_point3(radiant_affine_t a,
+                                                 radiant_point3_t p) {
+  const float* d = a.data;
+  return (radiant_point3_t){
+      .x = (d[0] * p.x) + (d[1] * p.y) + (d[2] * p.z) + d[3],
+      .y = (d[4] * p.x) + (d[5] * p.y) + (d[6] * p.z) + d[7],
+      .z = (d[8] * p.x) + (d[9] * p.y) + (d[10] * p.z) + d[11],
+  };
+}
+
+radiant_vec3_t radiant_affine_transform_vec3(radiant_affine_t a,
+                                             radiant_vec3_t v) {
+  const float* d = a.data;
+  return (radiant_vec3_t){
+      .x = (d[0] * v.x) + (d[1] * v.y) + (d[2] * v.z),
+      .y = (d[4] * v.x) + (d[5] * v.y) + (d[6] * v.z),
+      .z = (d[8] * v.x) + (d[9] * v.y) + (d[10] * v.z),
+  };
+}
+
+radiant_affine_t radiant_affine_inverse_rigid(radiant_affine_t a) {
+  const float* d = a.data;
+  float tx = d[3];
+  float ty = d[7];
+  float tz = d[11];
+
+  // The inverse of a rotation is its transpose, the translation is then
+  // -R^T * t.
+  return (radiant_affine_t){
+      // clang-format off
+      .data = {
+          d[0], d[4], d[8], -((d[0] * tx) + (d[4] * ty) + (d[8] * tz)),
+          d[1], d[5], d[9], -((d[1] * tx) + (d[5] * ty) + (d[9] * tz)),
+          d[2], d[6], d[10], -((d[2] * tx) + (d[6] * ty) + (d[10] * tz)),
+      },
+      // clang-format on
+  };
+}
+
+radiant_affine_inverse_result_t radiant_affine_inverse(radiant_affine_t a) {
+  const float* d = a.data;
+  radiant_affine_inverse_result_t result = {0};
+
+  // Cofactors of the upper 3x3, the inverse is their transpose over the
+  // determinant.
+  float c00 = (d[5] * d[10]) - (d[6] * d[9]);
+  float c01 = (d[6] * d[8]) - (d[4] * d[10]);
+  float c02 = (d[4] * d[9]) - (d[5] * d[8]);
+  float det = (d[0] * c00) + (d[1] * c01) + (d[2] * c02);
+  float inv_det = 1.f / det;
+  if (!isfinite(inv_det)) {
+    return result;
+  }
+
+  float r[9] = {
+      c00 * inv_det,
+      ((d[2] * d[9]) - (d[1] * d[10])) * inv_det,
+      ((d[1] * d[6]) - (d[2] * d[5])) * inv_det,
+      c01 * inv_det,
+      ((d[0] * d[10]) - (d[2] * d[8])) * inv_det,
+      ((d[2] * d[4]) - (d[0] * d[6])) * inv_det,
+      c02 * inv_det,
+      ((d[1] * d[8]) - (d[0] * d[9])) * inv_det,
+      ((d[0] * d[5]) - (d[1] * d[4])) * inv_det,
+  };
+
+  float tx = d[3];
+  float ty = d[7];
+  float tz = d[11];
+  for (uint32_t row = 0; row < 3; ++row) {
+    const float* ri = &r[row * 3];
+    float* out = &result.inverse.data[row * 4];
+    out[0] = ri[0];
+    out[1] = ri[1];
+    out[2] = ri[2];
+    out[3] = -((ri[0] * tx) + (ri[1] * ty) + (ri[2] * tz));
+  }
+  result.succeeded = true;
+  return result;
+}
@@ -0,0 +1,84 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "src/mat4x4.h"
+#include "src/pad.h"
+#include "src/point3.h"
+#include "src/trs.h"
+#include "src/vec3.h"
+
+/// An affine transform, the upper 3 rows of a 4x4 matrix whose bottom row is
+/// always (0, 0, 0, 1).
+typedef struct radiant_affine_t {
+  /// Matrix data in row-major order.
+  ///
+  /// | a b c d |
+  /// | e f g h |
+  /// | i j k l |
+  ///
+  /// Stored as:
+  /// [a b c d e f g h i j k l]
+  ///
+  /// (d, h, l) is the translation. The rows can be uploaded as three vec4f
+  /// and applied in WGSL as vec4f(dot(row0, p), dot(row1, p), dot(row2, p)).
+  float data[12];
+} radiant_affine_t;
+
+/// Returns the identity transform.
+radiant_affine_t radiant_affine_identity(void);
+
+/// Returns the upper 3 rows of |m|. The bottom row of |m| is assumed to be
+/// (0, 0, 0, 1).
+radiant_affine_t radiant_affine_from_mat4x4(radiant_mat4x4_t m);
+
+/// Returns translation * rotation * scale for |trs|, as
+/// radiant_trs_to_mat4x4 but without the bottom row.
+radiant_affine_t radiant_trs_to_affine(radiant_trs_t trs);
+
+/// Returns |a| as a 4x4 matrix.
+radiant_mat4x4_t radiant_affine_to_mat4x4(radiant_affine_t a);
+
+/// Returns |a| * |b|, the transform |b| followed by |a|.
+radiant_affine_t radiant_affine_mul(radiant_affine_t a, radiant_affine_t b);
+
+/// Returns |a| applied to |p|.
+radiant_point3_t radiant_affine_transform_point3(radiant_affine_t a,
+                                                 radiant_point3_t p);
+
+/// Returns |a| applied to |v|, translation is ignored.
+radiant_vec3_t radiant_affine_transform_vec3(radiant_affine_t a,
+                                             radiant_vec3_t v);
+
+/// The result of inverting an affine transform.
+typedef struct radiant_affine_inverse_result_t {
+  /// The inverse. Only valid if |succeeded| is true.
+  radiant_affine_t inverse;
+  /// True if the transform was invertible. False if it is singular.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(3);
+} radiant_affine_inverse_result_t;
+
+/// Returns the inverse of |a|, which only needs the inverse of the upper 3x3
+/// so is much cheaper than radiant_mat4x4_inverse. Fails if |a| is singular.
+radiant_affine_inverse_result_t radiant_affine_inverse(radiant_affine_t a);
+
+/// Returns the inverse of |a|. |a| must be a rigid transform, only rotation
+/// and translation, so the inverse is the transposed rotation and the
+/// negated, rotated, translation.
+radiant_affine_t radiant_affine_inverse_rigid(radiant_affine_t a);
@@ -0,0 +1,92 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares composing transforms as radiant_affine_t against
+// radiant_mat4x4_t, for each supported SIMD backend.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/affine.h"
+#include "src/bench.h"
+#include "src/simd.h"
+
+static const uint32_t kCount = 100000;
+static const uint32_t kIterations = 100;
+
+typedef struct bench_data_t {
+  radiant_mat4x4_t parent;
+  radiant_mat4x4_t* mats;
+  radiant_affine_t parent_affine;
+  radiant_affine_t* affines;
+} bench_data_t;
+
+static void mat4x4_loop(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data->mats[i] = radiant_mat4x4_mul(data->parent, data->mats[i]);
+  }
+}
+
+static void affine_loop(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data->affines[i] =
+        radiant_affine_mul(data->parent_affine, data->affines[i]);
+  }
+}
+
+int main() {
+  radiant_mat4x4_t parent = radiant_mat4x4_rotate_y(0.001f);
+  bench_data_t data = {
+      .parent = parent,
+      .mats = (radiant_mat4x4_t*)malloc(kCount * sizeof(radiant_mat4x4_t)),
+      .parent_affine = radiant_affine_from_mat4x4(parent),
+      .affines = (radiant_affine_t*)malloc(kCount * sizeof(radiant_affine_t)),
+  };
+  if (!data.mats || !data.affines) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data.mats[i] =
+        radiant_mat4x4_translate((radiant_vec3_t){(float)i, 0.f, 1.f});
+    data.affines[i] = radiant_affine_from_mat4x4(data.mats[i]);
+  }
+
+  printf("Composing %u transforms, %u vs %u bytes each\n", kCount,
+         (uint32_t)sizeof(radiant_mat4x4_t),
+         (uint32_t)sizeof(radiant_affine_t));
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "mat4x4_mul [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, mat4x4_loop, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "affine_mul [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, affine_loop, &data, kIterations, kCount);
+  }
+  radiant_simd_set_backend(original);
+
+  free(data.mats);
+  free(data.affines);
+  return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/affine.h"
+
+#include "src/quat.h"
+#include "src/test.h"
+
+static bool mat4x4_equal(radiant_mat4x4_t a, radiant_mat4x4_t b) {
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (!radiant_equal(a.data[i], b.data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static radiant_mat4x4_t transform_a(void) {
+  return radiant_mat4x4_mul(
+      radiant_mat4x4_translate((radiant_vec3_t){1.f, -2.f, 3.f}),
+      radiant_mat4x4_mul(radiant_mat4x4_rotate((radiant_point3_t){0.3f, 1.1f,
+                                                                  -0.4f}),
+                         radiant_mat4x4_scale(2.f, 0.5f, 1.5f)));
+}
+
+static radiant_mat4x4_t transform_b(void) {
+  return radiant_mat4x4_mul(
+      radiant_mat4x4_translate((radiant_vec3_t){-4.f, 0.5f, 2.f}),
+      radiant_mat4x4_rotate((radiant_point3_t){-1.2f, 0.2f, 0.9f}));
+}
+
+static bool identity() {
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(radiant_affine_identity()),
+                   radiant_mat4x4_identity()));
+  return true;
+}
+
+static bool layout() {
+  radiant_affine_t a = radiant_affine_from_mat4x4(
+      radiant_mat4x4_translate((radiant_vec3_t){1.f, 2.f, 3.f}));
+  RADIANT_EXPECT_FLOAT_EQ(a.data[3], 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(a.data[7], 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(a.data[11], 3.f);
+  RADIANT_EXPECT_EQ((uint32_t)sizeof(radiant_affine_t), 48u);
+  return true;
+}
+
+static bool trs_to_affine() {
+  radiant_point3_t angles = {0.3f, 1.1f, -0.4f};
+  radiant_trs_t trs = {
+      .translation = {1.f, -2.f, 3.f},
+      .rotation = radiant_quat_from_euler(angles),
+      .scale = {2.f, 0.5f, 1.5f},
+  };
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(radiant_trs_to_affine(trs)),
+                   radiant_mat4x4_mul(
+                       radiant_mat4x4_translate(trs.translation),
+                       radiant_mat4x4_mul(radiant_quat_to_mat4x4(trs.rotation),
+                                          radiant_mat4x4_scale(2.f, 0.5f,
+                                                               1.5f)))));
+  return true;
+}
+
+static bool round_trip() {
+  radiant_mat4x4_t m = transform_a();
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(radiant_affine_from_mat4x4(m)), m));
+  return true;
+}
+
+static bool mul() {
+  radiant_mat4x4_t a = transform_a();
+  radiant_mat4x4_t b = transform_b();
+
+  radiant_affine_t r = radiant_affine_mul(radiant_affine_from_mat4x4(a),
+                                          radiant_affine_from_mat4x4(b));
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(r), radiant_mat4x4_mul(a, b)));
+  return true;
+}
+
+static bool transform() {
+  radiant_mat4x4_t m = transform_a();
+  radiant_affine_t a = radiant_affine_from_mat4x4(m);
+
+  radiant_point3_t p = {1.5f, -0.5f, 4.f};
+  radiant_point3_t ep = radiant_mat4x4_mul(m, p);
+  radiant_point3_t rp = radiant_affine_transform_point3(a, p);
+  RADIANT_EXPECT_FLOAT_EQ(ep.x, rp.x);
+  RADIANT_EXPECT_FLOAT_EQ(ep.y, rp.y);
+  RADIANT_EXPECT_FLOAT_EQ(ep.z, rp.z);
+
+  radiant_vec3_t v = {1.5f, -0.5f, 4.f};
+  radiant_vec3_t ev = radiant_mat4x4_mul(m, v);
+  radiant_vec3_t rv = radiant_affine_transform_vec3(a, v);
+  RADIANT_EXPECT_FLOAT_EQ(ev.x, rv.x);
+  RADIANT_EXPECT_FLOAT_EQ(ev.y, rv.y);
+  RADIANT_EXPECT_FLOAT_EQ(ev.z, rv.z);
+  return true;
+}
+
+static bool inverse_rigid() {
+  radiant_affine_t a = radiant_affine_from_mat4x4(transform_b());
+  radiant_affine_t inv = radiant_affine_inverse_rigid(a);
+
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(radiant_affine_mul(a, inv)),
+                   radiant_mat4x4_identity()));
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(radiant_affine_mul(inv, a)),
+                   radiant_mat4x4_identity()));
+  return true;
+}
+
+static bool inverse() {
+  radiant_mat4x4_t m = transform_a();
+  radiant_affine_inverse_result_t r =
+      radiant_affine_inverse(radiant_affine_from_mat4x4(m));
+  RADIANT_EXPECT_TRUE(r.succeeded);
+
+  radiant_mat4x4_inverse_result_t expected = radiant_mat4x4_inverse(m);
+  RADIANT_EXPECT_TRUE(expected.succeeded);
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_affine_to_mat4x4(r.inverse), expected.inverse));
+
+  radiant_affine_t flat = radiant_affine_from_mat4x4(
+      radiant_mat4x4_scale(1.f, 1.f, 0.f));
+  RADIANT_EXPECT_FALSE(radiant_affine_inverse(flat).succeeded);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("affine");
+  RADIANT_TEST(identity);
+  RADIANT_TEST(layout);
+  RADIANT_TEST(trs_to_affine);
+  RADIANT_TEST(round_trip);
+  RADIANT_TEST_ALL_BACKENDS(mul);
+  RADIANT_TEST(transform);
+  RADIANT_TEST_ALL_BACKENDS(inverse_rigid);
+  RADIANT_TEST_ALL_BACKENDS(inverse);
+  return radiant_suite_end();
+}
@@ -1,6 +1,10 @@
 #include "src/angle.h"
 
+#include <math.h>
+
+#include "src/assert.h"
 #include "src/constants.h"
+#include "src/simd.h"
 
 static const float kPiBy180 = RADIANT_PI / 180.f;
 static const float k180ByPi = 180.f / RADIANT_PI;
@@ -12,3 +16,48 @@ float radiant_deg_to_rad(float degrees) {
 float radiant_rad_to_deg(float radians) {
   return radians * k180ByPi;
 }
+
+radiant_sincos_t radiant_sincos(float radians) {
+  if (!(fabsf(radians) <= RADIANT_SINCOS_MAX_FAST)) {
+    return (radiant_sincos_t){.sin = sinf(radians), .cos = cosf(radians)};
+  }
+
+  // Reduce to r in [-pi/4, pi/4] with radians = q * pi/2 + r. pi/2 is split
+  // in three so the first products are exact (Cody-Waite).
+  int32_t q = (int32_t)((radians * RADIANT_SINCOS_2_BY_PI) +
+                        (radians < 0.f ? -.5f : .5f));
+  float j = (float)q;
+  float r = radians - (j * RADIANT_SINCOS_PI_BY_2_HI);
+  r -= j * RADIANT_SINCOS_PI_BY_2_MID;
+  r -= j * RADIANT_SINCOS_PI_BY_2_LO;
+
+  float r2 = r * r;
+  float s = RADIANT_SINCOS_S3;
+  s = (s * r2) + RADIANT_SINCOS_S2;
+  s = (s * r2) + RADIANT_SINCOS_S1;
+  s = (s * r2 * r) + r;
+  float c = RADIANT_SINCOS_C3;
+  c = (c * r2) + RADIANT_SINCOS_C2;
+  c = (c * r2) + RADIANT_SINCOS_C1;
+  c = (c * r2 * r2) - (.5f * r2) + 1.f;
+
+  // Rotate the result into quadrant q.
+  switch (q & 3) {
+    case 0:
+      return (radiant_sincos_t){.sin = s, .cos = c};
+    case 1:
+      return (radiant_sincos_t){.sin = c, .cos = -s};
+    case 2:
+      return (radiant_sincos_t){.sin = -s, .cos = -c};
+    default:
+      return (radiant_sincos_t){.sin = -c, .cos = s};
+  }
+}
+
+void radiant_sincos_batch(const float* radians,
+                          float* sin_out,
+                          float* cos_out,
+                          uint32_t count) {
+  RADIANT_ASSERT((radians && sin_out && cos_out) || count == 0);
+  radiant_simd_ops()->sincos_batch(sin_out, cos_out, radians, count);
+}
@@ -1,4 +1,32 @@
 #pragma once
 
+#include <stdint.h>
+
 float radiant_deg_to_rad(float degrees);
 float radiant_rad_to_deg(float radians);
+
+/// The sine and cosine of an angle.
+typedef struct radiant_sincos_t {
+  /// The sine
+  float sin;
+  /// The cosine
+  float cos;
+} radiant_sincos_t;
+
+/// Inputs with a larger magnitude than this are passed to libm, which is
+/// slower but reduces the angle exactly.
+#define RADIANT_SINCOS_MAX_FAST 8192.f
+
+/// Returns the sine and cosine of |radians| using a polynomial, several times
+/// faster than sinf and cosf when batched. Within RADIANT_SINCOS_MAX_FAST the
+/// absolute error is below 1e-7, 1.5 ulp for results near 1.
+radiant_sincos_t radiant_sincos(float radians);
+
+/// Stores the sine and cosine of |radians|[i] into |sin_out|[i] and
+/// |cos_out|[i] for |count| angles, using the widest SIMD backend available.
+/// Matches radiant_sincos within its error bound. The outputs may alias
+/// |radians|.
+void radiant_sincos_batch(const float* radians,
+                          float* sin_out,
+                          float* cos_out,
+                          uint32_t count);
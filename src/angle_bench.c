@@ -0,0 +1,155 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports the accuracy of radiant_sincos and radiant_sincos_batch against a
+// double precision reference, next to libm's sinf and cosf, then compares the
+// throughput per lane of each.
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/angle.h"
+#include "src/bench.h"
+#include "src/constants.h"
+#include "src/simd.h"
+
+static const uint32_t kCount = 1u << 20;
+static const uint32_t kIterations = 50;
+
+typedef struct bench_data_t {
+  float* radians;
+  float* sin_out;
+  float* cos_out;
+} bench_data_t;
+
+/// The largest errors seen against the double precision reference.
+typedef struct error_t {
+  /// Absolute error
+  double abs;
+  /// Error in units of the last place of the correctly rounded result
+  double ulp;
+} error_t;
+
+static double ulp(double reference) {
+  float f = fabsf((float)reference);
+  return f == 0.f ? (double)FLT_TRUE_MIN
+                  : (double)(nextafterf(f, INFINITY) - f);
+}
+
+static void accumulate(error_t* e, double reference, float value) {
+  double abs = fabs(reference - (double)value);
+  e->abs = fmax(e->abs, abs);
+  e->ulp = fmax(e->ulp, abs / ulp(reference));
+}
+
+static void report(const char* name, const bench_data_t* data, bool libm) {
+  error_t sin_error = {0};
+  error_t cos_error = {0};
+  for (uint32_t i = 0; i < kCount; ++i) {
+    double x = (double)data->radians[i];
+    float s = libm ? sinf(data->radians[i]) : data->sin_out[i];
+    float c = libm ? cosf(data->radians[i]) : data->cos_out[i];
+    accumulate(&sin_error, sin(x), s);
+    accumulate(&cos_error, cos(x), c);
+  }
+  printf("%-40s sin %.3g abs %8.1f ulp, cos %.3g abs %8.1f ulp\n", name,
+         sin_error.abs, sin_error.ulp, cos_error.abs, cos_error.ulp);
+}
+
+static void fill(bench_data_t* data, float range) {
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data->radians[i] = range * (((float)i / (float)kCount) * 2.f - 1.f);
+  }
+}
+
+static void libm_loop(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data->sin_out[i] = sinf(data->radians[i]);
+    data->cos_out[i] = cosf(data->radians[i]);
+  }
+}
+
+static void sincos_loop(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_sincos_t sc = radiant_sincos(data->radians[i]);
+    data->sin_out[i] = sc.sin;
+    data->cos_out[i] = sc.cos;
+  }
+}
+
+static void sincos_batch(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_sincos_batch(data->radians, data->sin_out, data->cos_out, kCount);
+}
+
+int main() {
+  bench_data_t data = {
+      .radians = (float*)malloc(kCount * sizeof(float)),
+      .sin_out = (float*)malloc(kCount * sizeof(float)),
+      .cos_out = (float*)malloc(kCount * sizeof(float)),
+  };
+  if (!data.radians || !data.sin_out || !data.cos_out) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  const float ranges[] = {RADIANT_PI, 100.f, RADIANT_SINCOS_MAX_FAST};
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+    fill(&data, ranges[r]);
+    printf("Accuracy over [-%g, %g], %u samples\n", (double)ranges[r],
+           (double)ranges[r], kCount);
+    report("libm sinf, cosf", &data, true);
+    sincos_loop(&data);
+    report("radiant_sincos", &data, false);
+    for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+      radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+      if (!radiant_simd_set_backend(backend)) {
+        continue;
+      }
+      char name[64];
+      snprintf(name, sizeof(name), "radiant_sincos_batch [%s]",
+               radiant_simd_backend_name(backend));
+      sincos_batch(&data);
+      report(name, &data, false);
+    }
+    radiant_simd_set_backend(original);
+  }
+
+  fill(&data, 100.f);
+  printf("Computing %u sines and cosines\n", kCount);
+  radiant_bench_run("libm sinf, cosf", libm_loop, &data, kIterations, kCount);
+  radiant_bench_run("radiant_sincos", sincos_loop, &data, kIterations,
+                    kCount);
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "radiant_sincos_batch [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, sincos_batch, &data, kIterations, kCount);
+  }
+  radiant_simd_set_backend(original);
+
+  free(data.radians);
+  free(data.sin_out);
+  free(data.cos_out);
+  return 0;
+}
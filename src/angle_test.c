@@ -0,0 +1,92 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/angle.h"
+
+#include <math.h>
+
+#include "src/constants.h"
+#include "src/simd.h"
+#include "src/test.h"
+
+/// Not a multiple of any vector width.
+#define COUNT 4099
+
+static bool deg_to_rad() {
+  RADIANT_EXPECT_FLOAT_EQ(radiant_deg_to_rad(180.f), RADIANT_PI);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_rad_to_deg(RADIANT_PI), 180.f);
+  return true;
+}
+
+static bool sincos_accuracy() {
+  radiant_sincos_t zero = radiant_sincos(0.f);
+  RADIANT_EXPECT_FLOAT_EQ(zero.sin, 0.f);
+  RADIANT_EXPECT_FLOAT_EQ(zero.cos, 1.f);
+
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    float x = RADIANT_SINCOS_MAX_FAST * (((float)i / COUNT) * 2.f - 1.f);
+    radiant_sincos_t sc = radiant_sincos(x);
+    RADIANT_EXPECT_TRUE(fabs(sin((double)x) - (double)sc.sin) < 1e-7);
+    RADIANT_EXPECT_TRUE(fabs(cos((double)x) - (double)sc.cos) < 1e-7);
+  }
+  return true;
+}
+
+static bool sincos_large() {
+  // Beyond the fast range the result comes from libm.
+  const float inputs[] = {1e6f, -3e7f, INFINITY, NAN};
+  for (uint32_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+    radiant_sincos_t sc = radiant_sincos(inputs[i]);
+    float s = sinf(inputs[i]);
+    float c = cosf(inputs[i]);
+    RADIANT_EXPECT_TRUE(sc.sin == s || (isnan(sc.sin) && isnan(s)));
+    RADIANT_EXPECT_TRUE(sc.cos == c || (isnan(sc.cos) && isnan(c)));
+  }
+  return true;
+}
+
+static bool sincos_batch() {
+  float radians[COUNT];
+  float sin_out[COUNT];
+  float cos_out[COUNT];
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radians[i] = 100.f * (((float)i / COUNT) * 2.f - 1.f);
+  }
+  // A vector with one slow lane.
+  radians[9] = 1e6f;
+  radiant_sincos_batch(radians, sin_out, cos_out, COUNT);
+
+  // Backends with FMA round differently, so compare against the reference.
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    double x = (double)radians[i];
+    RADIANT_EXPECT_TRUE(fabs(sin(x) - (double)sin_out[i]) < 1e-7);
+    RADIANT_EXPECT_TRUE(fabs(cos(x) - (double)cos_out[i]) < 1e-7);
+  }
+
+  // In place.
+  radiant_sincos_batch(radians, radians, cos_out, COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    RADIANT_EXPECT_FLOAT_EQ(radians[i], sin_out[i]);
+  }
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("angle");
+  RADIANT_TEST(deg_to_rad);
+  RADIANT_TEST(sincos_accuracy);
+  RADIANT_TEST(sincos_large);
+  RADIANT_TEST_ALL_BACKENDS(sincos_batch);
+  return radiant_suite_end();
+}
@@ -0,0 +1,43 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bench.h"
+
+#include <stdio.h>
+
+#include "src/assert.h"
+#include "src/time.h"
+
+double radiant_bench_run(const char* name,
+                         radiant_bench_fn_t fn,
+                         void* userdata,
+                         uint32_t iterations,
+                         uint32_t items_per_iteration) {
+  RADIANT_ASSERT(iterations > 0);
+
+  fn(userdata);
+
+  radiant_time_t start = radiant_time();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    fn(userdata);
+  }
+  double ms = radiant_time_diff_to_ms(radiant_time_sub(radiant_time(), start)) /
+              (double)iterations;
+
+  double items_per_sec =
+      ms > 0.0 ? (double)items_per_iteration / ms * 1e3 : 0.0;
+  printf("%-40s %10.4f ms/iter %10.2f Mitems/s\n", name, ms,
+         items_per_sec / 1e6);
+  return ms;
+}
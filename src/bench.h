@@ -0,0 +1,30 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+/// Prototype of a benchmarked function. |userdata| is passed through from
+/// radiant_bench_run.
+typedef void (*radiant_bench_fn_t)(void* userdata);
+
+/// Runs |fn| |iterations| times, after one warm up call, and prints the time
+/// per iteration along with the throughput given that each call processes
+/// |items_per_iteration| items. Returns the milliseconds per iteration.
+double radiant_bench_run(const char* name,
+                         radiant_bench_fn_t fn,
+                         void* userdata,
+                         uint32_t iterations,
+                         uint32_t items_per_iteration);
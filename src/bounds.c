@@ -0,0 +1,134 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bounds.h"
+
+#include <math.h>
+
+#include "src/assert.h"
+
+radiant_aabb_t radiant_aabb_from_points(const radiant_point3_t* points,
+                                        uint32_t count) {
+  RADIANT_ASSERT(points);
+  RADIANT_ASSERT(count > 0);
+
+  radiant_aabb_t box = {.min = points[0], .max = points[0]};
+  for (uint32_t i = 1; i < count; ++i) {
+    box.min.x = fminf(box.min.x, points[i].x);
+    box.min.y = fminf(box.min.y, points[i].y);
+    box.min.z = fminf(box.min.z, points[i].z);
+    box.max.x = fmaxf(box.max.x, points[i].x);
+    box.max.y = fmaxf(box.max.y, points[i].y);
+    box.max.z = fmaxf(box.max.z, points[i].z);
+  }
+  return box;
+}
+
+radiant_point3_t radiant_aabb_centre(radiant_aabb_t box) {
+  return (radiant_point3_t){
+      .x = (box.min.x + box.max.x) * .5f,
+      .y = (box.min.y + box.max.y) * .5f,
+      .z = (box.min.z + box.max.z) * .5f,
+  };
+}
+
+radiant_vec3_t radiant_aabb_half_extent(radiant_aabb_t box) {
+  return (radiant_vec3_t){
+      .x = (box.max.x - box.min.x) * .5f,
+      .y = (box.max.y - box.min.y) * .5f,
+      .z = (box.max.z - box.min.z) * .5f,
+  };
+}
+
+float radiant_aabb_surface_area(radiant_aabb_t box) {
+  float x = box.max.x - box.min.x;
+  float y = box.max.y - box.min.y;
+  float z = box.max.z - box.min.z;
+  return 2.f * ((x * y) + (y * z) + (z * x));
+}
+
+radiant_aabb_t radiant_aabb_union(radiant_aabb_t a, radiant_aabb_t b) {
+  return (radiant_aabb_t){
+      .min = {fminf(a.min.x, b.min.x), fminf(a.min.y, b.min.y),
+              fminf(a.min.z, b.min.z)},
+      .max = {fmaxf(a.max.x, b.max.x), fmaxf(a.max.y, b.max.y),
+              fmaxf(a.max.z, b.max.z)},
+  };
+}
+
+radiant_aabb_t radiant_aabb_transform(radiant_aabb_t box, radiant_mat4x4_t m) {
+  // Transform the centre, then the extent by the absolute matrix (Arvo).
+  radiant_point3_t c = radiant_aabb_centre(box);
+  radiant_vec3_t e = radiant_aabb_half_extent(box);
+
+  float centre[3];
+  float extent[3];
+  for (uint32_t r = 0; r < 3; ++r) {
+    centre[r] = (m.data[r] * c.x) + (m.data[4 + r] * c.y) +
+                (m.data[8 + r] * c.z) + m.data[12 + r];
+    extent[r] = (fabsf(m.data[r]) * e.x) + (fabsf(m.data[4 + r]) * e.y) +
+                (fabsf(m.data[8 + r]) * e.z);
+  }
+  return (radiant_aabb_t){
+      .min = {centre[0] - extent[0], centre[1] - extent[1],
+              centre[2] - extent[2]},
+      .max = {centre[0] + extent[0], centre[1] + extent[1],
+              centre[2] + extent[2]},
+  };
+}
+
+radiant_sphere_t radiant_sphere_from_aabb(radiant_aabb_t box) {
+  radiant_vec3_t e = radiant_aabb_half_extent(box);
+  return (radiant_sphere_t){
+      .centre = radiant_aabb_centre(box),
+      .radius = sqrtf((e.x * e.x) + (e.y * e.y) + (e.z * e.z)),
+  };
+}
+
+radiant_aabb_soa_t radiant_aabb_soa_create(uint32_t count) {
+  radiant_aabb_soa_t soa = {
+      .centres = radiant_point3_soa_create(count),
+      .half_extents = radiant_vec3_soa_create(count),
+  };
+  if (soa.centres.count != count || soa.half_extents.count != count) {
+    radiant_aabb_soa_destroy(soa);
+    return (radiant_aabb_soa_t){0};
+  }
+  return soa;
+}
+
+void radiant_aabb_soa_destroy(radiant_aabb_soa_t soa) {
+  radiant_point3_soa_destroy(soa.centres);
+  radiant_vec3_soa_destroy(soa.half_extents);
+}
+
+uint32_t radiant_aabb_soa_count(radiant_aabb_soa_t soa) {
+  return soa.centres.count;
+}
+
+radiant_aabb_t radiant_aabb_soa_get(radiant_aabb_soa_t soa, uint32_t idx) {
+  radiant_point3_t c = radiant_point3_soa_get(soa.centres, idx);
+  radiant_vec3_t e = radiant_vec3_soa_get(soa.half_extents, idx);
+  return (radiant_aabb_t){
+      .min = {c.x - e.x, c.y - e.y, c.z - e.z},
+      .max = {c.x + e.x, c.y + e.y, c.z + e.z},
+  };
+}
+
+void radiant_aabb_soa_set(radiant_aabb_soa_t soa,
+                          uint32_t idx,
+                          radiant_aabb_t box) {
+  radiant_point3_soa_set(soa.centres, idx, radiant_aabb_centre(box));
+  radiant_vec3_soa_set(soa.half_extents, idx, radiant_aabb_half_extent(box));
+}
@@ -0,0 +1,88 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/mat4x4.h"
+#include "src/point3.h"
+#include "src/soa.h"
+#include "src/vec3.h"
+
+/// An axis aligned bounding box.
+typedef struct radiant_aabb_t {
+  /// The corner with the smallest coordinates
+  radiant_point3_t min;
+  /// The corner with the largest coordinates
+  radiant_point3_t max;
+} radiant_aabb_t;
+
+/// A bounding sphere.
+typedef struct radiant_sphere_t {
+  /// The centre of the sphere
+  radiant_point3_t centre;
+  /// The radius of the sphere
+  float radius;
+} radiant_sphere_t;
+
+/// Returns the smallest box holding the |count| |points|. |count| must not be
+/// zero.
+radiant_aabb_t radiant_aabb_from_points(const radiant_point3_t* points,
+                                        uint32_t count);
+
+/// Returns the centre of |box|.
+radiant_point3_t radiant_aabb_centre(radiant_aabb_t box);
+
+/// Returns half the size of |box| along each axis.
+radiant_vec3_t radiant_aabb_half_extent(radiant_aabb_t box);
+
+/// Returns the surface area of |box|, the measure the surface area heuristic
+/// uses for the chance of a ray hitting it.
+float radiant_aabb_surface_area(radiant_aabb_t box);
+
+/// Returns the smallest box holding |a| and |b|.
+radiant_aabb_t radiant_aabb_union(radiant_aabb_t a, radiant_aabb_t b);
+
+/// Returns the box holding |box| transformed by the affine matrix |m|. The
+/// result is not the tightest fit for rotations but is cheap to compute.
+radiant_aabb_t radiant_aabb_transform(radiant_aabb_t box, radiant_mat4x4_t m);
+
+/// Returns the sphere passing through the corners of |box|.
+radiant_sphere_t radiant_sphere_from_aabb(radiant_aabb_t box);
+
+/// A stream of boxes stored as structure-of-arrays, in centre and half extent
+/// form which is what the culling kernels consume.
+typedef struct radiant_aabb_soa_t {
+  /// The box centres
+  radiant_point3_soa_t centres;
+  /// Half the size of each box along each axis
+  radiant_vec3_soa_t half_extents;
+} radiant_aabb_soa_t;
+
+/// Creates a stream of |count| boxes. Returns an empty stream, with a count of
+/// zero, if the allocation fails.
+radiant_aabb_soa_t radiant_aabb_soa_create(uint32_t count);
+/// Destroys |soa|.
+void radiant_aabb_soa_destroy(radiant_aabb_soa_t soa);
+
+/// Returns the number of boxes in |soa|.
+uint32_t radiant_aabb_soa_count(radiant_aabb_soa_t soa);
+
+/// Returns the box at |idx| in |soa|.
+radiant_aabb_t radiant_aabb_soa_get(radiant_aabb_soa_t soa, uint32_t idx);
+/// Sets the box at |idx| in |soa| to |box|.
+void radiant_aabb_soa_set(radiant_aabb_soa_t soa,
+                          uint32_t idx,
+                          radiant_aabb_t box);
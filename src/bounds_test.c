@@ -0,0 +1,129 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bounds.h"
+
+#include "src/test.h"
+
+static bool from_points() {
+  const radiant_point3_t points[] = {
+      {1.f, -2.f, 3.f},
+      {-4.f, 5.f, 0.f},
+      {2.f, 0.f, -6.f},
+  };
+  radiant_aabb_t box = radiant_aabb_from_points(points, 3);
+  RADIANT_EXPECT_FLOAT_EQ(box.min.x, -4.f);
+  RADIANT_EXPECT_FLOAT_EQ(box.min.y, -2.f);
+  RADIANT_EXPECT_FLOAT_EQ(box.min.z, -6.f);
+  RADIANT_EXPECT_FLOAT_EQ(box.max.x, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(box.max.y, 5.f);
+  RADIANT_EXPECT_FLOAT_EQ(box.max.z, 3.f);
+  return true;
+}
+
+static bool centre_and_extent() {
+  radiant_aabb_t box = {{-1.f, 0.f, 2.f}, {3.f, 4.f, 2.f}};
+  radiant_point3_t c = radiant_aabb_centre(box);
+  radiant_vec3_t e = radiant_aabb_half_extent(box);
+  RADIANT_EXPECT_FLOAT_EQ(c.x, 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(c.y, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(c.z, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(e.x, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(e.y, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(e.z, 0.f);
+  return true;
+}
+
+static bool surface_area() {
+  radiant_aabb_t box = {{0.f, 0.f, 0.f}, {1.f, 2.f, 3.f}};
+  RADIANT_EXPECT_FLOAT_EQ(radiant_aabb_surface_area(box), 22.f);
+  // Flat boxes still have the area of both faces.
+  box.max.z = 0.f;
+  RADIANT_EXPECT_FLOAT_EQ(radiant_aabb_surface_area(box), 4.f);
+  return true;
+}
+
+static bool union_() {
+  radiant_aabb_t a = {{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}};
+  radiant_aabb_t b = {{-1.f, .5f, 2.f}, {.5f, 3.f, 4.f}};
+  radiant_aabb_t u = radiant_aabb_union(a, b);
+  RADIANT_EXPECT_FLOAT_EQ(u.min.x, -1.f);
+  RADIANT_EXPECT_FLOAT_EQ(u.min.y, 0.f);
+  RADIANT_EXPECT_FLOAT_EQ(u.min.z, 0.f);
+  RADIANT_EXPECT_FLOAT_EQ(u.max.x, 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(u.max.y, 3.f);
+  RADIANT_EXPECT_FLOAT_EQ(u.max.z, 4.f);
+  return true;
+}
+
+static bool transform() {
+  radiant_aabb_t box = {{-1.f, -2.f, -3.f}, {1.f, 2.f, 3.f}};
+
+  radiant_aabb_t moved = radiant_aabb_transform(
+      box, radiant_mat4x4_translate((radiant_vec3_t){10.f, 0.f, -1.f}));
+  RADIANT_EXPECT_FLOAT_EQ(moved.min.x, 9.f);
+  RADIANT_EXPECT_FLOAT_EQ(moved.max.z, 2.f);
+
+  // A quarter turn around z swaps the x and y extents.
+  radiant_aabb_t turned =
+      radiant_aabb_transform(box, radiant_mat4x4_rotate_z(1.5707964f));
+  RADIANT_EXPECT_FLOAT_EQ(turned.min.x, -2.f);
+  RADIANT_EXPECT_FLOAT_EQ(turned.max.x, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(turned.min.y, -1.f);
+  RADIANT_EXPECT_FLOAT_EQ(turned.max.y, 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(turned.max.z, 3.f);
+  return true;
+}
+
+static bool sphere_from_aabb() {
+  radiant_aabb_t box = {{1.f, 1.f, 1.f}, {3.f, 5.f, 5.f}};
+  radiant_sphere_t s = radiant_sphere_from_aabb(box);
+  RADIANT_EXPECT_FLOAT_EQ(s.centre.x, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(s.centre.y, 3.f);
+  RADIANT_EXPECT_FLOAT_EQ(s.centre.z, 3.f);
+  RADIANT_EXPECT_FLOAT_EQ(s.radius, 3.f);
+  return true;
+}
+
+static bool soa() {
+  radiant_aabb_soa_t boxes = radiant_aabb_soa_create(3);
+  RADIANT_EXPECT_EQ(radiant_aabb_soa_count(boxes), 3u);
+
+  radiant_aabb_t box = {{-1.f, 2.f, 0.f}, {3.f, 4.f, .5f}};
+  radiant_aabb_soa_set(boxes, 1, box);
+  radiant_aabb_t r = radiant_aabb_soa_get(boxes, 1);
+  RADIANT_EXPECT_FLOAT_EQ(r.min.x, box.min.x);
+  RADIANT_EXPECT_FLOAT_EQ(r.min.y, box.min.y);
+  RADIANT_EXPECT_FLOAT_EQ(r.min.z, box.min.z);
+  RADIANT_EXPECT_FLOAT_EQ(r.max.x, box.max.x);
+  RADIANT_EXPECT_FLOAT_EQ(r.max.y, box.max.y);
+  RADIANT_EXPECT_FLOAT_EQ(r.max.z, box.max.z);
+  radiant_aabb_soa_destroy(boxes);
+
+  radiant_aabb_soa_t empty = radiant_aabb_soa_create(0);
+  RADIANT_EXPECT_EQ(radiant_aabb_soa_count(empty), 0u);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("bounds");
+  RADIANT_TEST(from_points);
+  RADIANT_TEST(centre_and_extent);
+  RADIANT_TEST(surface_area);
+  RADIANT_TEST(union_);
+  RADIANT_TEST(transform);
+  RADIANT_TEST(sphere_from_aabb);
+  RADIANT_TEST(soa);
+  return radiant_suite_end();
+}
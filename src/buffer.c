@@ -34,3 +34,41 @@ void radiant_buffer_write(radiant_buffer_t buffer,
   WGPUQueue queue = wgpuDeviceGetQueue(buffer.engine.device);
   wgpuQueueWriteBuffer(queue, buffer.buffer, 0, data, data_size_in_bytes);
 }
+
+/// State shared with the map callback.
+typedef struct map_state_t {
+  WGPUBufferMapAsyncStatus status;
+  bool done;
+  /// Unused padding
+  RADIANT_PAD(3);
+} map_state_t;
+
+/// Callback when a buffer map finishes
+static void map_callback(WGPUBufferMapAsyncStatus status, void* userdata) {
+  map_state_t* state = (map_state_t*)userdata;
+  state->status = status;
+  state->done = true;
+}
+
+radiant_buffer_map_result_t radiant_buffer_map_read(radiant_buffer_t buffer,
+                                                    uint64_t size_in_bytes) {
+  map_state_t state = {0};
+  wgpuBufferMapAsync(buffer.buffer, WGPUMapMode_Read, 0, (size_t)size_in_bytes,
+                     map_callback, &state);
+  while (!state.done) {
+    wgpuInstanceProcessEvents(buffer.engine.instance);
+  }
+  if (state.status != WGPUBufferMapAsyncStatus_Success) {
+    fprintf(stderr, "Failed to map buffer: %d\n", (int)state.status);
+    return (radiant_buffer_map_result_t){0};
+  }
+  return (radiant_buffer_map_result_t){
+      .data = wgpuBufferGetConstMappedRange(buffer.buffer, 0,
+                                            (size_t)size_in_bytes),
+      .succeeded = true,
+  };
+}
+
+void radiant_buffer_unmap(radiant_buffer_t buffer) {
+  wgpuBufferUnmap(buffer.buffer);
+}
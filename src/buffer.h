@@ -60,3 +60,23 @@ void radiant_buffer_destroy(radiant_buffer_t buffer);
 void radiant_buffer_write(radiant_buffer_t buffer,
                           uint64_t data_size_in_bytes,
                           const void* data);
+
+/// Results of mapping a buffer
+typedef struct radiant_buffer_map_result_t {
+  /// The mapped bytes. Only valid if |succeeded| is true, and until the
+  /// buffer is unmapped.
+  const void* data;
+  /// True if the buffer was successfully mapped. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_buffer_map_result_t;
+
+/// Maps the first |size_in_bytes| of |buffer| for reading. Blocks, processing
+/// events, until the work already submitted to the GPU is finished so the
+/// buffer can be read. The |buffer| needs the `radiant_buffer_usage_map_read`
+/// usage. Call radiant_buffer_unmap when done with the data.
+radiant_buffer_map_result_t radiant_buffer_map_read(radiant_buffer_t buffer,
+                                                    uint64_t size_in_bytes);
+/// Unmaps the |buffer| after radiant_buffer_map_read.
+void radiant_buffer_unmap(radiant_buffer_t buffer);
@@ -0,0 +1,732 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bvh.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/assert.h"
+#include "src/job.h"
+#include "src/time.h"
+
+/// Bins per axis when searching for a split. Ranges with fewer triangles
+/// use one bin per triangle.
+#define BINS 16
+/// Ranges at this depth are built as subtrees in parallel. Fixed, rather
+/// than derived from the thread count, so the tree is always the same.
+#define PARALLEL_DEPTH 6
+/// The most subtrees the top levels are cut into.
+#define MAX_SUBTREES (1 << PARALLEL_DEPTH)
+/// The most pieces a range is binned in by parallel binning.
+#define MAX_CHUNKS 32
+
+/// Costs used by the surface area heuristic, relative to each other.
+static const float kTraversalCost = 1.f;
+static const float kIntersectionCost = 1.f;
+/// Ranges smaller than this are built as a subtree, however shallow.
+static const uint32_t kMinSubtreeTriangles = 1024;
+/// Ranges at least this large are binned in parallel.
+static const uint32_t kMinParallelBinTriangles = 65536;
+/// Alignment of the node array, a cache line.
+static const size_t kNodeAlignment = 64;
+
+/// A range left by the top levels for a job to build.
+typedef struct subtree_t {
+  /// The index of the subtree root in the top level nodes
+  uint32_t root;
+  /// The first entry of the range in the triangle order
+  uint32_t begin;
+  /// One past the last entry of the range
+  uint32_t end;
+  /// The depth of the root
+  uint32_t depth;
+  /// Scratch the subtree is built into, with the root at 1 and the pairs of
+  /// children from 2 so they stay aligned when moved into place
+  radiant_bvh_node_t* nodes;
+  /// The number of scratch nodes used, including 0 and 1
+  uint32_t node_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} subtree_t;
+
+/// A triangle being sorted into the tree. Partitioning moves these rather
+/// than indices so binning reads memory in order.
+typedef struct ref_t {
+  /// The bounds of the triangle
+  radiant_aabb_t bounds;
+  /// The centre of |bounds|
+  radiant_point3_t centroid;
+  /// The index of the triangle in the mesh
+  uint32_t index;
+} ref_t;
+
+/// The state of a build shared by every thread.
+typedef struct builder_t {
+  /// Every triangle, partitioned in place into leaf order
+  ref_t* refs;
+  /// Where the top levels record ranges for jobs, NULL within a job
+  subtree_t* subtrees;
+  uint32_t subtree_count;
+  uint32_t max_leaf_size;
+  uint32_t thread_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} builder_t;
+
+/// The nodes being built by one thread.
+typedef struct arena_t {
+  radiant_bvh_node_t* nodes;
+  uint32_t node_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} arena_t;
+
+/// Bounds of a range of triangles and of their centroids.
+typedef struct range_t {
+  radiant_aabb_t bounds;
+  radiant_aabb_t centroid_bounds;
+} range_t;
+
+/// Triangles binned by centroid along each axis.
+typedef struct bins_t {
+  radiant_aabb_t bounds[3][BINS];
+  uint32_t count[3][BINS];
+  /// The number of bins in use
+  uint32_t size;
+} bins_t;
+
+/// Work for parallel binning: a range split in |chunk_count| pieces, each
+/// binned into its own |bins| or |ranges| entry.
+typedef struct chunks_t {
+  const builder_t* builder;
+  range_t* ranges;
+  bins_t* bins;
+  radiant_aabb_t centroid_bounds;
+  uint32_t begin;
+  uint32_t end;
+  uint32_t chunk_count;
+  uint32_t bin_count;
+} chunks_t;
+
+static radiant_aabb_t empty_aabb(void) {
+  return (radiant_aabb_t){
+      .min = {INFINITY, INFINITY, INFINITY},
+      .max = {-INFINITY, -INFINITY, -INFINITY},
+  };
+}
+
+// Plain comparisons rather than fminf and fmaxf, whose NaN handling keeps
+// them from becoming single instructions. Nothing here is NaN.
+static float min_f(float a, float b) {
+  return a < b ? a : b;
+}
+
+static float max_f(float a, float b) {
+  return a > b ? a : b;
+}
+
+static radiant_aabb_t merge(radiant_aabb_t a, radiant_aabb_t b) {
+  return (radiant_aabb_t){
+      .min = {min_f(a.min.x, b.min.x), min_f(a.min.y, b.min.y),
+              min_f(a.min.z, b.min.z)},
+      .max = {max_f(a.max.x, b.max.x), max_f(a.max.y, b.max.y),
+              max_f(a.max.z, b.max.z)},
+  };
+}
+
+static radiant_aabb_t grow(radiant_aabb_t box, radiant_point3_t p) {
+  return merge(box, (radiant_aabb_t){p, p});
+}
+
+static float axis_of(radiant_point3_t p, uint32_t axis) {
+  return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+
+static uint32_t mesh_index(const radiant_bvh_mesh_t* mesh, uint32_t i) {
+  uint32_t idx = mesh->index_format == radiant_bvh_index_format_uint16
+                     ? ((const uint16_t*)mesh->indices)[i]
+                     : ((const uint32_t*)mesh->indices)[i];
+  RADIANT_ASSERT(idx < mesh->vertex_count);
+  return idx;
+}
+
+static radiant_point3_t mesh_position(const radiant_bvh_mesh_t* mesh,
+                                      uint32_t vertex) {
+  // The stride need not keep floats aligned, so copy rather than cast.
+  const uint8_t* bytes = (const uint8_t*)mesh->vertices;
+  radiant_point3_t p;
+  memcpy(&p, bytes + ((size_t)vertex * mesh->vertex_stride), sizeof(p));
+  return p;
+}
+
+static void mesh_triangle(const radiant_bvh_mesh_t* mesh,
+                          uint32_t triangle,
+                          radiant_point3_t* a,
+                          radiant_point3_t* b,
+                          radiant_point3_t* c) {
+  *a = mesh_position(mesh, mesh_index(mesh, (3 * triangle)));
+  *b = mesh_position(mesh, mesh_index(mesh, (3 * triangle) + 1));
+  *c = mesh_position(mesh, mesh_index(mesh, (3 * triangle) + 2));
+}
+
+static range_t measure_range(const builder_t* b, uint32_t begin, uint32_t end) {
+  range_t range = {empty_aabb(), empty_aabb()};
+  for (uint32_t i = begin; i < end; ++i) {
+    range.bounds = merge(range.bounds, b->refs[i].bounds);
+    range.centroid_bounds = grow(range.centroid_bounds, b->refs[i].centroid);
+  }
+  return range;
+}
+
+static uint32_t bin_of(radiant_point3_t centroid,
+                       uint32_t axis,
+                       float lo,
+                       float scale,
+                       uint32_t bin_count) {
+  uint32_t bin = (uint32_t)((axis_of(centroid, axis) - lo) * scale);
+  return bin < bin_count ? bin : bin_count - 1;
+}
+
+static void bin_range(const builder_t* b,
+                      uint32_t begin,
+                      uint32_t end,
+                      radiant_aabb_t centroid_bounds,
+                      uint32_t bin_count,
+                      bins_t* bins) {
+  bins->size = bin_count;
+  float lo[3];
+  float scale[3];
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    for (uint32_t k = 0; k < bin_count; ++k) {
+      bins->bounds[axis][k] = empty_aabb();
+      bins->count[axis][k] = 0;
+    }
+    // Flat axes put everything in the first bin, split skips them.
+    lo[axis] = axis_of(centroid_bounds.min, axis);
+    float extent = axis_of(centroid_bounds.max, axis) - lo[axis];
+    scale[axis] = extent > 0.f ? (float)bin_count / extent : 0.f;
+  }
+
+  // All three axes in one pass, so each triangle is read once.
+  for (uint32_t i = begin; i < end; ++i) {
+    const ref_t* ref = &b->refs[i];
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      uint32_t k =
+          bin_of(ref->centroid, axis, lo[axis], scale[axis], bin_count);
+      bins->bounds[axis][k] = merge(bins->bounds[axis][k], ref->bounds);
+      ++bins->count[axis][k];
+    }
+  }
+}
+
+static void chunk_range(const chunks_t* c,
+                        uint32_t chunk,
+                        uint32_t* begin,
+                        uint32_t* end) {
+  uint64_t count = c->end - c->begin;
+  *begin = c->begin + (uint32_t)(count * chunk / c->chunk_count);
+  *end = c->begin + (uint32_t)(count * (chunk + 1) / c->chunk_count);
+}
+
+static void measure_chunk(void* userdata, uint32_t chunk) {
+  chunks_t* c = (chunks_t*)userdata;
+  uint32_t begin;
+  uint32_t end;
+  chunk_range(c, chunk, &begin, &end);
+  c->ranges[chunk] = measure_range(c->builder, begin, end);
+}
+
+static void bin_chunk(void* userdata, uint32_t chunk) {
+  chunks_t* c = (chunks_t*)userdata;
+  uint32_t begin;
+  uint32_t end;
+  chunk_range(c, chunk, &begin, &end);
+  bin_range(c->builder, begin, end, c->centroid_bounds, c->bin_count,
+            &c->bins[chunk]);
+}
+
+/// Measures and bins [|begin|, |end|), in parallel if the range is large
+/// enough and the builder has the threads.
+static range_t measure_and_bin(const builder_t* b,
+                               uint32_t begin,
+                               uint32_t end,
+                               bins_t* bins) {
+  uint32_t bin_count = end - begin < BINS ? end - begin : BINS;
+  uint32_t chunk_count = b->thread_count < MAX_CHUNKS ? b->thread_count
+                                                      : MAX_CHUNKS;
+  if (chunk_count < 2 || end - begin < kMinParallelBinTriangles) {
+    range_t range = measure_range(b, begin, end);
+    bin_range(b, begin, end, range.centroid_bounds, bin_count, bins);
+    return range;
+  }
+
+  range_t ranges[MAX_CHUNKS];
+  bins_t chunk_bins[MAX_CHUNKS];
+  chunks_t chunks = {
+      .builder = b,
+      .ranges = ranges,
+      .bins = chunk_bins,
+      .begin = begin,
+      .end = end,
+      .chunk_count = chunk_count,
+      .bin_count = bin_count,
+  };
+  radiant_job_parallel_for(chunk_count, b->thread_count, measure_chunk,
+                           &chunks);
+  range_t range = ranges[0];
+  for (uint32_t i = 1; i < chunk_count; ++i) {
+    range.bounds = merge(range.bounds, ranges[i].bounds);
+    range.centroid_bounds =
+        merge(range.centroid_bounds, ranges[i].centroid_bounds);
+  }
+
+  chunks.centroid_bounds = range.centroid_bounds;
+  radiant_job_parallel_for(chunk_count, b->thread_count, bin_chunk, &chunks);
+  *bins = chunk_bins[0];
+  for (uint32_t i = 1; i < chunk_count; ++i) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      for (uint32_t k = 0; k < bin_count; ++k) {
+        bins->bounds[axis][k] =
+            merge(bins->bounds[axis][k], chunk_bins[i].bounds[axis][k]);
+        bins->count[axis][k] += chunk_bins[i].count[axis][k];
+      }
+    }
+  }
+  return range;
+}
+
+/// Picks the cheapest split of [|begin|, |end|) by the surface area
+/// heuristic and partitions the range around it, storing the start of the
+/// second half into |mid|. Returns false if the range should be a leaf.
+static bool split(const builder_t* b,
+                  uint32_t begin,
+                  uint32_t end,
+                  uint32_t depth,
+                  const range_t* range,
+                  const bins_t* bins,
+                  uint32_t* mid) {
+  uint32_t count = end - begin;
+  if (count == 1 || depth + 1 >= RADIANT_BVH_MAX_DEPTH) {
+    return false;
+  }
+
+  float parent_area = radiant_aabb_surface_area(range->bounds);
+  float best_cost = INFINITY;
+  uint32_t best_axis = 3;
+  uint32_t best_bin = 0;
+  uint32_t last = bins->size - 1;
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    if (!(axis_of(range->centroid_bounds.max, axis) >
+          axis_of(range->centroid_bounds.min, axis))) {
+      continue;
+    }
+    // The area and count to the right of each split, the split after bin k
+    // having the bins after k on its right.
+    float right_area[BINS];
+    uint32_t right_count[BINS];
+    radiant_aabb_t box = empty_aabb();
+    uint32_t n = 0;
+    for (uint32_t k = last; k > 0; --k) {
+      box = merge(box, bins->bounds[axis][k]);
+      n += bins->count[axis][k];
+      right_area[k] = radiant_aabb_surface_area(box);
+      right_count[k] = n;
+    }
+
+    box = empty_aabb();
+    n = 0;
+    for (uint32_t k = 0; k < last; ++k) {
+      box = merge(box, bins->bounds[axis][k]);
+      n += bins->count[axis][k];
+      if (n == 0 || right_count[k + 1] == 0) {
+        continue;
+      }
+      float cost =
+          kTraversalCost +
+          (kIntersectionCost *
+           ((radiant_aabb_surface_area(box) * (float)n) +
+            (right_area[k + 1] * (float)right_count[k + 1])) /
+           parent_area);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bin = k;
+      }
+    }
+  }
+
+  if (best_axis == 3) {
+    if (count <= b->max_leaf_size) {
+      return false;
+    }
+    // The centroids are all in one place, so any split is as good.
+    *mid = begin + (count / 2);
+    return true;
+  }
+  if (count <= b->max_leaf_size &&
+      kIntersectionCost * (float)count <= best_cost) {
+    return false;
+  }
+
+  float lo = axis_of(range->centroid_bounds.min, best_axis);
+  float scale = (float)bins->size /
+                (axis_of(range->centroid_bounds.max, best_axis) - lo);
+  uint32_t i = begin;
+  uint32_t j = end;
+  while (i < j) {
+    if (bin_of(b->refs[i].centroid, best_axis, lo, scale, bins->size) <=
+        best_bin) {
+      ++i;
+    } else {
+      --j;
+      ref_t t = b->refs[i];
+      b->refs[i] = b->refs[j];
+      b->refs[j] = t;
+    }
+  }
+  *mid = i;
+  return true;
+}
+
+/// Builds the node |node| of |arena| over [|begin|, |end|). In the top
+/// levels, ranges deep or small enough are recorded as subtrees instead.
+static void build(builder_t* b,
+                  arena_t* arena,
+                  uint32_t node,
+                  uint32_t begin,
+                  uint32_t end,
+                  uint32_t depth) {
+  if (b->subtrees &&
+      (depth == PARALLEL_DEPTH || end - begin < kMinSubtreeTriangles)) {
+    RADIANT_ASSERT(b->subtree_count < MAX_SUBTREES);
+    b->subtrees[b->subtree_count++] = (subtree_t){
+        .root = node,
+        .begin = begin,
+        .end = end,
+        .depth = depth,
+    };
+    return;
+  }
+
+  bins_t bins;
+  range_t range = measure_and_bin(b, begin, end, &bins);
+  arena->nodes[node].bounds = range.bounds;
+  uint32_t mid;
+  if (!split(b, begin, end, depth, &range, &bins, &mid)) {
+    arena->nodes[node].first = begin;
+    arena->nodes[node].count = end - begin;
+    return;
+  }
+
+  uint32_t children = arena->node_count;
+  arena->node_count += 2;
+  arena->nodes[node].first = children;
+  arena->nodes[node].count = 0;
+  build(b, arena, children, begin, mid, depth + 1);
+  build(b, arena, children + 1, mid, end, depth + 1);
+}
+
+static void build_subtree(void* userdata, uint32_t index) {
+  const builder_t* top = (const builder_t*)userdata;
+  subtree_t* s = &top->subtrees[index];
+  builder_t b = *top;
+  b.subtrees = NULL;
+  // Parallelism comes from the subtrees, not binning within them.
+  b.thread_count = 1;
+  arena_t arena = {.nodes = s->nodes, .node_count = 2};
+  build(&b, &arena, 1, s->begin, s->end, s->depth);
+  s->node_count = arena.node_count;
+}
+
+static radiant_bvh_stats_t measure(const radiant_bvh_t* bvh) {
+  radiant_bvh_stats_t stats = {0};
+  float root_area = radiant_aabb_surface_area(bvh->nodes[0].bounds);
+  float scale = root_area > 0.f ? 1.f / root_area : 1.f;
+
+  uint32_t stack[RADIANT_BVH_MAX_DEPTH];
+  uint32_t depths[RADIANT_BVH_MAX_DEPTH];
+  uint32_t size = 0;
+  stack[size] = 0;
+  depths[size++] = 1;
+  while (size > 0) {
+    --size;
+    const radiant_bvh_node_t* node = &bvh->nodes[stack[size]];
+    uint32_t depth = depths[size];
+    float area = radiant_aabb_surface_area(node->bounds) * scale;
+    ++stats.node_count;
+    if (depth > stats.max_depth) {
+      stats.max_depth = depth;
+    }
+    if (node->count > 0) {
+      ++stats.leaf_count;
+      stats.sah_cost += area * kIntersectionCost * (float)node->count;
+      continue;
+    }
+    stats.sah_cost += area * kTraversalCost;
+    RADIANT_ASSERT(size + 2 <= RADIANT_BVH_MAX_DEPTH);
+    stack[size] = node->first;
+    depths[size++] = depth + 1;
+    stack[size] = node->first + 1;
+    depths[size++] = depth + 1;
+  }
+  return stats;
+}
+
+radiant_bvh_t radiant_bvh_build(radiant_bvh_build_request_t req) {
+  radiant_time_t start = radiant_time();
+  radiant_bvh_mesh_t mesh = req.mesh;
+  uint32_t count = mesh.triangle_count;
+  if (count == 0) {
+    return (radiant_bvh_t){0};
+  }
+  RADIANT_ASSERT(mesh.vertices);
+  RADIANT_ASSERT(mesh.indices);
+  RADIANT_ASSERT(mesh.vertex_stride >= sizeof(radiant_point3_t));
+
+  builder_t b = {
+      .refs = (ref_t*)malloc(count * sizeof(ref_t)),
+      .max_leaf_size = req.max_leaf_size > 0
+                           ? req.max_leaf_size
+                           : RADIANT_BVH_DEFAULT_MAX_LEAF_SIZE,
+      .thread_count = req.thread_count > 0 ? req.thread_count
+                                           : radiant_job_processor_count(),
+  };
+  // A subtree over n triangles has at most 2n - 1 nodes, plus the unused
+  // node 0 of its scratch.
+  radiant_bvh_node_t* scratch = (radiant_bvh_node_t*)malloc(
+      (2 * (size_t)count + MAX_SUBTREES) * sizeof(radiant_bvh_node_t));
+  if (!b.refs || !scratch) {
+    free(b.refs);
+    free(scratch);
+    return (radiant_bvh_t){0};
+  }
+
+  for (uint32_t t = 0; t < count; ++t) {
+    radiant_point3_t p[3];
+    mesh_triangle(&mesh, t, &p[0], &p[1], &p[2]);
+    radiant_aabb_t bounds = radiant_aabb_from_points(p, 3);
+    b.refs[t] = (ref_t){
+        .bounds = bounds,
+        .centroid = radiant_aabb_centre(bounds),
+        .index = t,
+    };
+  }
+
+  // The top levels, with node 1 unused so the pairs of children line up
+  // with cache lines.
+  radiant_bvh_node_t top_nodes[2 * MAX_SUBTREES] = {0};
+  arena_t top = {.nodes = top_nodes, .node_count = 2};
+  subtree_t subtrees[MAX_SUBTREES];
+  b.subtrees = subtrees;
+  build(&b, &top, 0, 0, count, 0);
+
+  // Jobs are handed out in order, so sort the largest subtrees first to
+  // start them first.
+  for (uint32_t i = 1; i < b.subtree_count; ++i) {
+    subtree_t s = subtrees[i];
+    uint32_t j = i;
+    while (j > 0 &&
+           subtrees[j - 1].end - subtrees[j - 1].begin < s.end - s.begin) {
+      subtrees[j] = subtrees[j - 1];
+      --j;
+    }
+    subtrees[j] = s;
+  }
+  size_t scratch_offset = 0;
+  for (uint32_t i = 0; i < b.subtree_count; ++i) {
+    subtrees[i].nodes = scratch + scratch_offset;
+    scratch_offset += (2 * (size_t)(subtrees[i].end - subtrees[i].begin)) + 1;
+  }
+  radiant_job_parallel_for(b.subtree_count, b.thread_count, build_subtree, &b);
+
+  // Move the subtrees in after the top levels, in the order of their roots
+  // so the layout does not depend on the scheduling.
+  uint32_t node_count = top.node_count;
+  for (uint32_t i = 0; i < b.subtree_count; ++i) {
+    node_count += subtrees[i].node_count - 2;
+  }
+  size_t bytes = node_count * sizeof(radiant_bvh_node_t);
+  bytes = (bytes + kNodeAlignment - 1) / kNodeAlignment * kNodeAlignment;
+  radiant_bvh_t bvh = {
+      .nodes = (radiant_bvh_node_t*)aligned_alloc(kNodeAlignment, bytes),
+      .triangles = radiant_triangle_soa_create(count),
+      .triangle_indices = (uint32_t*)malloc(count * sizeof(uint32_t)),
+      .node_count = node_count,
+  };
+  if (!bvh.nodes || radiant_triangle_soa_count(bvh.triangles) != count ||
+      !bvh.triangle_indices) {
+    free(b.refs);
+    free(scratch);
+    radiant_bvh_destroy(bvh);
+    return (radiant_bvh_t){0};
+  }
+
+  memcpy(bvh.nodes, top.nodes, top.node_count * sizeof(radiant_bvh_node_t));
+  uint32_t base = top.node_count;
+  for (uint32_t root = 0; root < top.node_count; ++root) {
+    for (uint32_t i = 0; i < b.subtree_count; ++i) {
+      const subtree_t* s = &subtrees[i];
+      if (s->root != root) {
+        continue;
+      }
+      // Scratch node k lands at base + k - 2, apart from the root.
+      for (uint32_t k = 1; k < s->node_count; ++k) {
+        radiant_bvh_node_t node = s->nodes[k];
+        if (node.count == 0) {
+          node.first = node.first + base - 2;
+        }
+        bvh.nodes[k == 1 ? root : base + k - 2] = node;
+      }
+      base += s->node_count - 2;
+    }
+  }
+  RADIANT_ASSERT(base == node_count);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    radiant_point3_t p[3];
+    mesh_triangle(&mesh, b.refs[i].index, &p[0], &p[1], &p[2]);
+    radiant_triangle_soa_set(bvh.triangles, i, p[0], p[1], p[2]);
+    bvh.triangle_indices[i] = b.refs[i].index;
+  }
+  free(b.refs);
+  free(scratch);
+
+  bvh.stats = measure(&bvh);
+  bvh.stats.build_ms = radiant_time_diff_to_ms(
+      radiant_time_sub(start, radiant_time()));
+  return bvh;
+}
+
+void radiant_bvh_destroy(radiant_bvh_t bvh) {
+  free(bvh.nodes);
+  radiant_triangle_soa_destroy(bvh.triangles);
+  free(bvh.triangle_indices);
+}
+
+void radiant_bvh_refit(radiant_bvh_t* bvh, radiant_bvh_mesh_t mesh) {
+  RADIANT_ASSERT(bvh);
+  RADIANT_ASSERT(mesh.triangle_count ==
+                 radiant_triangle_soa_count(bvh->triangles));
+  if (bvh->node_count == 0) {
+    return;
+  }
+
+  radiant_time_t start = radiant_time();
+  // Children come after their parents, so walking backwards visits them
+  // first.
+  for (uint32_t i = bvh->node_count; i-- > 0;) {
+    if (i == 1) {
+      continue;
+    }
+    radiant_bvh_node_t* node = &bvh->nodes[i];
+    if (node->count == 0) {
+      node->bounds = merge(bvh->nodes[node->first].bounds,
+                           bvh->nodes[node->first + 1].bounds);
+      continue;
+    }
+    node->bounds = empty_aabb();
+    for (uint32_t j = node->first; j < node->first + node->count; ++j) {
+      radiant_point3_t p[3];
+      mesh_triangle(&mesh, bvh->triangle_indices[j], &p[0], &p[1], &p[2]);
+      radiant_triangle_soa_set(bvh->triangles, j, p[0], p[1], p[2]);
+      node->bounds = merge(node->bounds, radiant_aabb_from_points(p, 3));
+    }
+  }
+
+  bvh->stats = measure(bvh);
+  bvh->stats.build_ms = radiant_time_diff_to_ms(
+      radiant_time_sub(start, radiant_time()));
+}
+
+/// Returns true if |ray| passes through |box| entering no further than its
+/// |t_max|, storing where it enters into |t|.
+static bool enters(const radiant_ray_t* ray,
+                   radiant_vec3_t inv,
+                   radiant_aabb_t box,
+                   float* t) {
+  float x1 = (box.min.x - ray->origin.x) * inv.x;
+  float x2 = (box.max.x - ray->origin.x) * inv.x;
+  float y1 = (box.min.y - ray->origin.y) * inv.y;
+  float y2 = (box.max.y - ray->origin.y) * inv.y;
+  float z1 = (box.min.z - ray->origin.z) * inv.z;
+  float z2 = (box.max.z - ray->origin.z) * inv.z;
+  float t_near = max_f(max_f(min_f(x1, x2), min_f(y1, y2)),
+                       max_f(min_f(z1, z2), ray->t_min));
+  float t_far = min_f(min_f(max_f(x1, x2), max_f(y1, y2)),
+                      min_f(max_f(z1, z2), ray->t_max));
+  *t = t_near;
+  return t_near <= t_far;
+}
+
+radiant_ray_triangle_hit_t radiant_bvh_intersect(const radiant_bvh_t* bvh,
+                                                 radiant_ray_t ray) {
+  RADIANT_ASSERT(bvh);
+  radiant_ray_triangle_hit_t best = {.t = INFINITY};
+  radiant_vec3_t inv = radiant_ray_inv_direction(ray.direction);
+  float t;
+  if (bvh->node_count == 0 || !enters(&ray, inv, bvh->nodes[0].bounds, &t)) {
+    return best;
+  }
+
+  // Nodes still to visit and where the ray enters them, the nearer child is
+  // visited first.
+  uint32_t stack[RADIANT_BVH_MAX_DEPTH];
+  float stack_t[RADIANT_BVH_MAX_DEPTH];
+  uint32_t size = 0;
+  uint32_t idx = 0;
+  for (;;) {
+    const radiant_bvh_node_t* node = &bvh->nodes[idx];
+    if (node->count > 0) {
+      radiant_ray_triangle_hit_t hit = radiant_ray_intersect_triangles(
+          ray, bvh->triangles, node->first, node->first + node->count);
+      if (hit.hit) {
+        best = hit;
+        ray.t_max = hit.t;
+      }
+    } else {
+      float t0;
+      float t1;
+      bool hit0 = enters(&ray, inv, bvh->nodes[node->first].bounds, &t0);
+      bool hit1 = enters(&ray, inv, bvh->nodes[node->first + 1].bounds, &t1);
+      if (hit0 && hit1) {
+        RADIANT_ASSERT(size < RADIANT_BVH_MAX_DEPTH);
+        bool first_nearer = t0 <= t1;
+        stack[size] = first_nearer ? node->first + 1 : node->first;
+        stack_t[size++] = first_nearer ? t1 : t0;
+        idx = first_nearer ? node->first : node->first + 1;
+        continue;
+      }
+      if (hit0 || hit1) {
+        idx = hit0 ? node->first : node->first + 1;
+        continue;
+      }
+    }
+
+    // Skip nodes the ray now enters beyond the closest hit.
+    while (size > 0 && stack_t[size - 1] > ray.t_max) {
+      --size;
+    }
+    if (size == 0) {
+      break;
+    }
+    idx = stack[--size];
+  }
+
+  if (best.hit) {
+    best.index = bvh->triangle_indices[best.index];
+  }
+  return best;
+}
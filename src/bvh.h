@@ -0,0 +1,131 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/bounds.h"
+#include "src/pad.h"
+#include "src/ray.h"
+
+/// The deepest a radiant_bvh_t gets, traversal stacks of this size never
+/// overflow.
+#define RADIANT_BVH_MAX_DEPTH 64
+
+/// Ranges of at most this many triangles become leaves when the surface area
+/// heuristic prefers it, unless the build request says otherwise.
+#define RADIANT_BVH_DEFAULT_MAX_LEAF_SIZE 4
+
+/// The index formats of a radiant_bvh_mesh_t, matching those usable for an
+/// index buffer.
+typedef enum radiant_bvh_index_format_t {
+  /// uint16_t indices
+  radiant_bvh_index_format_uint16,
+  /// uint32_t indices
+  radiant_bvh_index_format_uint32,
+} radiant_bvh_index_format_t;
+
+/// An indexed triangle list, in the layout of the vertex and index arrays
+/// uploaded into radiant_buffer_ts.
+typedef struct radiant_bvh_mesh_t {
+  /// The vertices, each starting with its position as three floats
+  const void* vertices;
+  /// Three indices per triangle, in |index_format|
+  const void* indices;
+  /// The bytes from the start of one vertex to the next
+  uint32_t vertex_stride;
+  /// The number of vertices, every index must be less than this
+  uint32_t vertex_count;
+  /// The number of triangles, a third of the number of indices
+  uint32_t triangle_count;
+  /// The type of |indices|
+  radiant_bvh_index_format_t index_format;
+} radiant_bvh_mesh_t;
+
+/// A node of a radiant_bvh_t. Two nodes fit in a cache line.
+typedef struct radiant_bvh_node_t {
+  /// Bounds of everything below the node
+  radiant_aabb_t bounds;
+  /// For interior nodes the index of the first child, the second child
+  /// follows it. For leaves the index of the first triangle.
+  uint32_t first;
+  /// The number of triangles in a leaf, zero for interior nodes
+  uint32_t count;
+} radiant_bvh_node_t;
+
+/// Figures describing a radiant_bvh_t.
+typedef struct radiant_bvh_stats_t {
+  /// Milliseconds the last build or refit took
+  double build_ms;
+  /// The surface area heuristic cost of the tree, the expected traversal
+  /// cost of a ray hitting the root, relative to testing one triangle
+  float sah_cost;
+  /// The number of nodes, interior and leaf
+  uint32_t node_count;
+  /// The number of leaves
+  uint32_t leaf_count;
+  /// The number of nodes on the longest path from the root to a leaf
+  uint32_t max_depth;
+} radiant_bvh_stats_t;
+
+/// A binary bounding volume hierarchy over the triangles of a mesh.
+typedef struct radiant_bvh_t {
+  /// The nodes in a single 64 byte aligned array. The root is node 0 and
+  /// node 1 is unused so that siblings always share a cache line. Children
+  /// always come after their parent.
+  radiant_bvh_node_t* nodes;
+  /// The triangles in leaf order, each leaf covers a range of them
+  radiant_triangle_soa_t triangles;
+  /// The index in the mesh of each triangle in |triangles|
+  uint32_t* triangle_indices;
+  /// The length of |nodes|, including the unused node
+  uint32_t node_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+  /// Figures from the last build or refit
+  radiant_bvh_stats_t stats;
+} radiant_bvh_t;
+
+/// Structure for requesting a BVH build.
+typedef struct radiant_bvh_build_request_t {
+  /// The triangles to build over
+  radiant_bvh_mesh_t mesh;
+  /// Ranges of at most this many triangles may become leaves. Zero uses
+  /// RADIANT_BVH_DEFAULT_MAX_LEAF_SIZE.
+  uint32_t max_leaf_size;
+  /// The threads to build with, zero uses every processor. The tree is the
+  /// same whatever the thread count.
+  uint32_t thread_count;
+} radiant_bvh_build_request_t;
+
+/// Builds a BVH over |req.mesh| with binned surface area heuristic splits.
+/// The top levels are split on the calling thread, then the subtrees below
+/// them are built in parallel. Returns an empty BVH, with a node count of
+/// zero, if the mesh has no triangles or an allocation fails.
+radiant_bvh_t radiant_bvh_build(radiant_bvh_build_request_t req);
+
+/// Destroys |bvh|.
+void radiant_bvh_destroy(radiant_bvh_t bvh);
+
+/// Updates the bounds of |bvh| after the vertices of |mesh|, the mesh it was
+/// built from, have moved. The topology must be unchanged. The tree keeps
+/// its structure so it degrades as the triangles move from where they were
+/// built, rebuild when |bvh->stats.sah_cost| has grown too far.
+void radiant_bvh_refit(radiant_bvh_t* bvh, radiant_bvh_mesh_t mesh);
+
+/// Returns the closest hit of |ray| against the triangles of |bvh|. The
+/// |index| of the hit is the index of the triangle in the mesh.
+radiant_ray_triangle_hit_t radiant_bvh_intersect(const radiant_bvh_t* bvh,
+                                                 radiant_ray_t ray);
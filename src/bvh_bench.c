@@ -0,0 +1,144 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Builds a BVH over a large heightfield with increasing thread counts, then
+// times refitting it and casting rays through it.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/bvh.h"
+#include "src/job.h"
+
+/// Cells per side of the heightfield, two triangles each.
+#define SIZE 512
+
+static const uint32_t kVertexCount = (SIZE + 1) * (SIZE + 1);
+static const uint32_t kTriangleCount = 2 * SIZE * SIZE;
+static const uint32_t kRays = 100000;
+
+typedef struct bench_data_t {
+  radiant_point3_t* vertices;
+  uint32_t* indices;
+  radiant_bvh_t bvh;
+  uint32_t thread_count;
+  uint32_t hits;
+} bench_data_t;
+
+static radiant_bvh_mesh_t mesh(const bench_data_t* data) {
+  return (radiant_bvh_mesh_t){
+      .vertices = data->vertices,
+      .indices = data->indices,
+      .vertex_stride = sizeof(radiant_point3_t),
+      .vertex_count = kVertexCount,
+      .triangle_count = kTriangleCount,
+      .index_format = radiant_bvh_index_format_uint32,
+  };
+}
+
+static void move(bench_data_t* data, float phase) {
+  for (uint32_t y = 0; y <= SIZE; ++y) {
+    for (uint32_t x = 0; x <= SIZE; ++x) {
+      float fx = (float)x;
+      float fy = (float)y;
+      data->vertices[(y * (SIZE + 1)) + x] = (radiant_point3_t){
+          fx, fy, sinf((fx * 0.05f) + phase) * cosf(fy * 0.03f) * 20.f};
+    }
+  }
+}
+
+static void build(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_bvh_destroy(data->bvh);
+  data->bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh(data),
+      .thread_count = data->thread_count,
+  });
+}
+
+static void refit(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_bvh_refit(&data->bvh, mesh(data));
+}
+
+static void intersect(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < kRays; ++i) {
+    float fi = (float)i;
+    radiant_ray_t ray = {
+        .origin = {fmodf(fi * 7.31f, SIZE), fmodf(fi * 3.17f, SIZE), 50.f},
+        .direction = {fmodf(fi * 0.37f, 2.f) - 1.f,
+                      fmodf(fi * 0.53f, 2.f) - 1.f, -1.f},
+        .t_max = INFINITY,
+    };
+    hits += radiant_bvh_intersect(&data->bvh, ray).hit ? 1 : 0;
+  }
+  data->hits = hits;
+}
+
+int main() {
+  bench_data_t data = {
+      .vertices =
+          (radiant_point3_t*)malloc(kVertexCount * sizeof(radiant_point3_t)),
+      .indices = (uint32_t*)malloc(3 * kTriangleCount * sizeof(uint32_t)),
+  };
+  if (!data.vertices || !data.indices) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+  move(&data, 0.f);
+  uint32_t i = 0;
+  for (uint32_t y = 0; y < SIZE; ++y) {
+    for (uint32_t x = 0; x < SIZE; ++x) {
+      uint32_t v = (y * (SIZE + 1)) + x;
+      uint32_t quad[6] = {v, v + 1, v + SIZE + 1, v + 1, v + SIZE + 2,
+                          v + SIZE + 1};
+      for (uint32_t k = 0; k < 6; ++k) {
+        data.indices[i++] = quad[k];
+      }
+    }
+  }
+
+  uint32_t processors = radiant_job_processor_count();
+  for (uint32_t threads = 1;; threads *= 2) {
+    if (threads > processors) {
+      threads = processors;
+    }
+    data.thread_count = threads;
+    char name[64];
+    snprintf(name, sizeof(name), "bvh_build [%u threads]", threads);
+    radiant_bench_run(name, build, &data, 5, kTriangleCount);
+    if (threads == processors) {
+      break;
+    }
+  }
+  printf("%u triangles: %u nodes, %u leaves, depth %u, SAH cost %.2f\n",
+         kTriangleCount, data.bvh.stats.node_count, data.bvh.stats.leaf_count,
+         data.bvh.stats.max_depth, (double)data.bvh.stats.sah_cost);
+
+  move(&data, 1.f);
+  radiant_bench_run("bvh_refit", refit, &data, 5, kTriangleCount);
+  printf("Refit SAH cost %.2f\n", (double)data.bvh.stats.sah_cost);
+
+  radiant_bench_run("bvh_intersect", intersect, &data, 5, kRays);
+  printf("%u of %u rays hit\n", data.hits, kRays);
+
+  radiant_bvh_destroy(data.bvh);
+  free(data.vertices);
+  free(data.indices);
+  return 0;
+}
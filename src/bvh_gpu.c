@@ -0,0 +1,87 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bvh_gpu.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/assert.h"
+#include "src/pack.h"
+
+static uint32_t mesh_index(const radiant_bvh_mesh_t* mesh, uint32_t i) {
+  if (mesh->index_format == radiant_bvh_index_format_uint16) {
+    return ((const uint16_t*)mesh->indices)[i];
+  }
+  return ((const uint32_t*)mesh->indices)[i];
+}
+
+static uint32_t pack_colour(radiant_colour3_t c) {
+  return (uint32_t)radiant_pack_unorm8(c.r) |
+         ((uint32_t)radiant_pack_unorm8(c.g) << 8) |
+         ((uint32_t)radiant_pack_unorm8(c.b) << 16) | (255u << 24);
+}
+
+/// Returns the packed colour of |vertex| in |req.mesh|.
+static uint32_t vertex_colour(const radiant_bvh_gpu_create_request_t* req,
+                              uint32_t vertex) {
+  if (req->colour_offset == RADIANT_BVH_GPU_NO_COLOUR) {
+    return pack_colour(req->albedo);
+  }
+  radiant_colour3_t c;
+  memcpy(&c,
+         (const uint8_t*)req->mesh.vertices +
+             (vertex * req->mesh.vertex_stride) + req->colour_offset,
+         sizeof(c));
+  return pack_colour(c);
+}
+
+radiant_bvh_gpu_t radiant_bvh_gpu_create(
+    radiant_bvh_gpu_create_request_t req) {
+  RADIANT_ASSERT(req.bvh);
+  const radiant_bvh_t* bvh = req.bvh;
+  uint32_t count = radiant_triangle_soa_count(bvh->triangles);
+  if (bvh->node_count == 0 || count == 0) {
+    return (radiant_bvh_gpu_t){0};
+  }
+
+  radiant_bvh_gpu_triangle_t* triangles = (radiant_bvh_gpu_triangle_t*)malloc(
+      count * sizeof(radiant_bvh_gpu_triangle_t));
+  if (!triangles) {
+    return (radiant_bvh_gpu_t){0};
+  }
+
+  const radiant_triangle_soa_t* soa = &bvh->triangles;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t index = bvh->triangle_indices[i];
+    triangles[i] = (radiant_bvh_gpu_triangle_t){
+        .v0 = {soa->v0.x[i], soa->v0.y[i], soa->v0.z[i]},
+        .colour0 = vertex_colour(&req, mesh_index(&req.mesh, 3 * index)),
+        .edge1 = {soa->edge1.x[i], soa->edge1.y[i], soa->edge1.z[i]},
+        .colour1 =
+            vertex_colour(&req, mesh_index(&req.mesh, (3 * index) + 1)),
+        .edge2 = {soa->edge2.x[i], soa->edge2.y[i], soa->edge2.z[i]},
+        .colour2 =
+            vertex_colour(&req, mesh_index(&req.mesh, (3 * index) + 2)),
+    };
+  }
+  return (radiant_bvh_gpu_t){
+      .triangles = triangles,
+      .triangle_count = count,
+  };
+}
+
+void radiant_bvh_gpu_destroy(radiant_bvh_gpu_t gpu) {
+  free(gpu.triangles);
+}
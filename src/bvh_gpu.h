@@ -0,0 +1,78 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/bvh.h"
+#include "src/colour3.h"
+#include "src/pad.h"
+#include "src/point3.h"
+#include "src/vec3.h"
+
+/// A |colour_offset| for meshes without vertex colours.
+#define RADIANT_BVH_GPU_NO_COLOUR UINT32_MAX
+
+/// A triangle as read by shaders/ray_cast.wgsl, three 16 byte rows. Each
+/// row ends with the colour of a vertex, packed as four radiant_pack_unorm8
+/// bytes with red in the low byte, as unpack4x8unorm reads them.
+typedef struct radiant_bvh_gpu_triangle_t {
+  /// The first vertex
+  radiant_point3_t v0;
+  /// The colour of the first vertex
+  uint32_t colour0;
+  /// The second vertex minus the first
+  radiant_vec3_t edge1;
+  /// The colour of the second vertex
+  uint32_t colour1;
+  /// The third vertex minus the first
+  radiant_vec3_t edge2;
+  /// The colour of the third vertex
+  uint32_t colour2;
+} radiant_bvh_gpu_triangle_t;
+
+/// The triangles of a radiant_bvh_t flattened for upload into a storage
+/// buffer. The nodes of the BVH are uploaded as they are, a
+/// radiant_bvh_node_t is eight 4 byte scalars, so the |first| of a leaf
+/// indexes |triangles| directly.
+typedef struct radiant_bvh_gpu_t {
+  /// The triangles in the leaf order of the BVH
+  radiant_bvh_gpu_triangle_t* triangles;
+  /// The length of |triangles|
+  uint32_t triangle_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_bvh_gpu_t;
+
+/// Structure for requesting a radiant_bvh_gpu_t.
+typedef struct radiant_bvh_gpu_create_request_t {
+  /// The BVH to flatten
+  const radiant_bvh_t* bvh;
+  /// The mesh |bvh| was built over
+  radiant_bvh_mesh_t mesh;
+  /// The byte offset of a radiant_colour3_t in each vertex, or
+  /// RADIANT_BVH_GPU_NO_COLOUR to colour every vertex |albedo|
+  uint32_t colour_offset;
+  /// The colour of the vertices if the mesh has no vertex colours
+  radiant_colour3_t albedo;
+} radiant_bvh_gpu_create_request_t;
+
+/// Flattens the triangles of |req.bvh| with their vertex colours. Returns an
+/// empty radiant_bvh_gpu_t, with a triangle count of zero, if the BVH is
+/// empty or the allocation fails.
+radiant_bvh_gpu_t radiant_bvh_gpu_create(radiant_bvh_gpu_create_request_t req);
+
+/// Destroys |gpu|.
+void radiant_bvh_gpu_destroy(radiant_bvh_gpu_t gpu);
@@ -0,0 +1,192 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bvh_gpu.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "src/pack.h"
+#include "src/test.h"
+
+typedef struct vertex_t {
+  radiant_point3_t position;
+  radiant_colour3_t colour;
+} vertex_t;
+
+/// A strip of quads along x, each vertex a different colour.
+#define QUADS 16
+#define VERTEX_COUNT (2 * (QUADS + 1))
+#define TRIANGLE_COUNT (2 * QUADS)
+
+typedef struct strip_t {
+  vertex_t vertices[VERTEX_COUNT];
+  uint32_t indices[3 * TRIANGLE_COUNT];
+} strip_t;
+
+static void strip_init(strip_t* strip) {
+  for (uint32_t i = 0; i <= QUADS; ++i) {
+    float x = (float)i;
+    float c = x / QUADS;
+    strip->vertices[2 * i] = (vertex_t){{x, 0.f, 0.f}, {c, 0.f, 1.f - c}};
+    strip->vertices[(2 * i) + 1] = (vertex_t){{x, 1.f, 0.5f}, {0.f, c, 1.f}};
+  }
+  for (uint32_t i = 0; i < QUADS; ++i) {
+    uint32_t v = 2 * i;
+    uint32_t quad[6] = {v, v + 2, v + 1, v + 2, v + 3, v + 1};
+    for (uint32_t k = 0; k < 6; ++k) {
+      strip->indices[(6 * i) + k] = quad[k];
+    }
+  }
+}
+
+static radiant_bvh_mesh_t strip_mesh(const strip_t* strip) {
+  return (radiant_bvh_mesh_t){
+      .vertices = strip->vertices,
+      .indices = strip->indices,
+      .vertex_stride = sizeof(vertex_t),
+      .vertex_count = VERTEX_COUNT,
+      .triangle_count = TRIANGLE_COUNT,
+      .index_format = radiant_bvh_index_format_uint32,
+  };
+}
+
+static uint32_t pack(radiant_colour3_t c) {
+  return (uint32_t)radiant_pack_unorm8(c.r) |
+         ((uint32_t)radiant_pack_unorm8(c.g) << 8) |
+         ((uint32_t)radiant_pack_unorm8(c.b) << 16) | 0xff000000u;
+}
+
+static bool layout() {
+  // Mirrors the Node and Triangle structs of shaders/ray_cast.wgsl.
+  RADIANT_EXPECT_EQ((uint32_t)sizeof(radiant_bvh_node_t), 32u);
+  RADIANT_EXPECT_EQ((uint32_t)offsetof(radiant_bvh_node_t, first), 24u);
+  RADIANT_EXPECT_EQ((uint32_t)sizeof(radiant_bvh_gpu_triangle_t), 48u);
+  RADIANT_EXPECT_EQ((uint32_t)offsetof(radiant_bvh_gpu_triangle_t, colour0),
+                    12u);
+  RADIANT_EXPECT_EQ((uint32_t)offsetof(radiant_bvh_gpu_triangle_t, edge1),
+                    16u);
+  RADIANT_EXPECT_EQ((uint32_t)offsetof(radiant_bvh_gpu_triangle_t, edge2),
+                    32u);
+  return true;
+}
+
+static bool empty() {
+  strip_t strip;
+  strip_init(&strip);
+  radiant_bvh_mesh_t mesh = strip_mesh(&strip);
+  mesh.triangle_count = 0;
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh,
+      .thread_count = 1,
+  });
+  radiant_bvh_gpu_t gpu = radiant_bvh_gpu_create(
+      (radiant_bvh_gpu_create_request_t){.bvh = &bvh, .mesh = mesh});
+  RADIANT_EXPECT_EQ(gpu.triangle_count, 0u);
+  RADIANT_EXPECT_NULL(gpu.triangles);
+  radiant_bvh_gpu_destroy(gpu);
+  radiant_bvh_destroy(bvh);
+  return true;
+}
+
+static bool leaf_order_and_colours() {
+  strip_t* strip = (strip_t*)malloc(sizeof(strip_t));
+  strip_init(strip);
+  radiant_bvh_mesh_t mesh = strip_mesh(strip);
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh,
+      .max_leaf_size = 2,
+      .thread_count = 1,
+  });
+  radiant_bvh_gpu_t gpu =
+      radiant_bvh_gpu_create((radiant_bvh_gpu_create_request_t){
+          .bvh = &bvh,
+          .mesh = mesh,
+          .colour_offset = offsetof(vertex_t, colour),
+      });
+  RADIANT_EXPECT_EQ(gpu.triangle_count, (uint32_t)TRIANGLE_COUNT);
+
+  for (uint32_t i = 0; i < gpu.triangle_count; ++i) {
+    const radiant_bvh_gpu_triangle_t* t = &gpu.triangles[i];
+    const uint32_t* index = &strip->indices[3 * bvh.triangle_indices[i]];
+    const vertex_t* a = &strip->vertices[index[0]];
+    const vertex_t* b = &strip->vertices[index[1]];
+    const vertex_t* c = &strip->vertices[index[2]];
+    RADIANT_EXPECT_FLOAT_EQ(t->v0.x, a->position.x);
+    RADIANT_EXPECT_FLOAT_EQ(t->v0.y, a->position.y);
+    RADIANT_EXPECT_FLOAT_EQ(t->v0.z, a->position.z);
+    RADIANT_EXPECT_FLOAT_EQ(t->v0.x + t->edge1.x, b->position.x);
+    RADIANT_EXPECT_FLOAT_EQ(t->v0.y + t->edge1.y, b->position.y);
+    RADIANT_EXPECT_FLOAT_EQ(t->v0.z + t->edge2.z, c->position.z);
+    RADIANT_EXPECT_EQ(t->colour0, pack(a->colour));
+    RADIANT_EXPECT_EQ(t->colour1, pack(b->colour));
+    RADIANT_EXPECT_EQ(t->colour2, pack(c->colour));
+  }
+
+  // Every leaf covers its own triangles.
+  for (uint32_t n = 0; n < bvh.node_count; ++n) {
+    const radiant_bvh_node_t* node = &bvh.nodes[n];
+    if (n == 1 || node->count == 0) {
+      continue;
+    }
+    for (uint32_t i = node->first; i < node->first + node->count; ++i) {
+      RADIANT_EXPECT_TRUE(i < gpu.triangle_count);
+      RADIANT_EXPECT_TRUE(gpu.triangles[i].v0.x >= node->bounds.min.x);
+      RADIANT_EXPECT_TRUE(gpu.triangles[i].v0.x <= node->bounds.max.x);
+    }
+  }
+
+  radiant_bvh_gpu_destroy(gpu);
+  radiant_bvh_destroy(bvh);
+  free(strip);
+  return true;
+}
+
+static bool albedo_without_colours() {
+  strip_t strip;
+  strip_init(&strip);
+  radiant_bvh_mesh_t mesh = strip_mesh(&strip);
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh,
+      .thread_count = 1,
+  });
+  radiant_colour3_t albedo = {0.25f, 0.5f, 1.f};
+  radiant_bvh_gpu_t gpu =
+      radiant_bvh_gpu_create((radiant_bvh_gpu_create_request_t){
+          .bvh = &bvh,
+          .mesh = mesh,
+          .colour_offset = RADIANT_BVH_GPU_NO_COLOUR,
+          .albedo = albedo,
+      });
+  RADIANT_EXPECT_EQ(gpu.triangle_count, (uint32_t)TRIANGLE_COUNT);
+  for (uint32_t i = 0; i < gpu.triangle_count; ++i) {
+    RADIANT_EXPECT_EQ(gpu.triangles[i].colour0, pack(albedo));
+    RADIANT_EXPECT_EQ(gpu.triangles[i].colour1, pack(albedo));
+    RADIANT_EXPECT_EQ(gpu.triangles[i].colour2, pack(albedo));
+  }
+  radiant_bvh_gpu_destroy(gpu);
+  radiant_bvh_destroy(bvh);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("bvh_gpu");
+
+  RADIANT_TEST(layout);
+  RADIANT_TEST(empty);
+  RADIANT_TEST(leaf_order_and_colours);
+  RADIANT_TEST(albedo_without_colours);
+
+  return radiant_suite_end();
+}
@@ -0,0 +1,336 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bvh.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/test.h"
+
+/// A vertex with data after the position, so the stride is exercised.
+typedef struct vertex_t {
+  radiant_point3_t position;
+  float uv[2];
+} vertex_t;
+
+/// A heightfield over a square grid, two triangles per cell.
+typedef struct grid_t {
+  vertex_t* vertices;
+  uint32_t* indices;
+  uint16_t* indices16;
+  uint32_t size;
+  uint32_t triangle_count;
+} grid_t;
+
+static float height(float x, float y, float phase) {
+  return sinf((x * 0.7f) + phase) * cosf(y * 0.45f) * 2.f;
+}
+
+static void grid_move(grid_t* grid, float phase) {
+  uint32_t n = grid->size + 1;
+  for (uint32_t y = 0; y < n; ++y) {
+    for (uint32_t x = 0; x < n; ++x) {
+      float fx = (float)x;
+      float fy = (float)y;
+      grid->vertices[(y * n) + x] = (vertex_t){
+          .position = {fx, fy, height(fx, fy, phase)},
+      };
+    }
+  }
+}
+
+static grid_t grid_create(uint32_t size) {
+  uint32_t n = size + 1;
+  grid_t grid = {
+      .vertices = (vertex_t*)malloc(n * n * sizeof(vertex_t)),
+      .indices = (uint32_t*)malloc(6 * size * size * sizeof(uint32_t)),
+      .indices16 = (uint16_t*)malloc(6 * size * size * sizeof(uint16_t)),
+      .size = size,
+      .triangle_count = 2 * size * size,
+  };
+  grid_move(&grid, 0.f);
+  uint32_t i = 0;
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      uint32_t v = (y * n) + x;
+      uint32_t quad[6] = {v, v + 1, v + n, v + 1, v + n + 1, v + n};
+      for (uint32_t k = 0; k < 6; ++k) {
+        grid.indices[i] = quad[k];
+        grid.indices16[i++] = (uint16_t)quad[k];
+      }
+    }
+  }
+  return grid;
+}
+
+static void grid_destroy(grid_t grid) {
+  free(grid.vertices);
+  free(grid.indices);
+  free(grid.indices16);
+}
+
+static radiant_bvh_mesh_t grid_mesh(const grid_t* grid) {
+  uint32_t n = grid->size + 1;
+  return (radiant_bvh_mesh_t){
+      .vertices = grid->vertices,
+      .indices = grid->indices,
+      .vertex_stride = sizeof(vertex_t),
+      .vertex_count = n * n,
+      .triangle_count = grid->triangle_count,
+      .index_format = radiant_bvh_index_format_uint32,
+  };
+}
+
+static radiant_point3_t vertex(const grid_t* grid, uint32_t i) {
+  return grid->vertices[grid->indices[i]].position;
+}
+
+static bool contains(radiant_aabb_t outer, radiant_aabb_t inner) {
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+         outer.min.z <= inner.min.z && outer.max.x >= inner.max.x &&
+         outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+/// Checks the layout and bounds of |bvh| over |grid|.
+static bool valid(const radiant_bvh_t* bvh,
+                  const grid_t* grid,
+                  uint32_t max_leaf_size) {
+  RADIANT_EXPECT_TRUE(bvh->node_count >= 2);
+  RADIANT_EXPECT_TRUE((((uintptr_t)bvh->nodes) & 63u) == 0);
+
+  // Every triangle appears exactly once.
+  uint8_t* seen = (uint8_t*)calloc(grid->triangle_count, 1);
+  for (uint32_t i = 0; i < grid->triangle_count; ++i) {
+    uint32_t t = bvh->triangle_indices[i];
+    RADIANT_EXPECT_TRUE(t < grid->triangle_count);
+    RADIANT_EXPECT_EQ(seen[t], 0);
+    seen[t] = 1;
+  }
+  free(seen);
+
+  uint32_t leaves = 0;
+  uint32_t covered = 0;
+  for (uint32_t i = 0; i < bvh->node_count; ++i) {
+    if (i == 1) {
+      continue;
+    }
+    const radiant_bvh_node_t* node = &bvh->nodes[i];
+    if (node->count == 0) {
+      RADIANT_EXPECT_TRUE(node->first > i);
+      RADIANT_EXPECT_EQ(node->first & 1u, 0u);
+      RADIANT_EXPECT_TRUE(node->first + 1 < bvh->node_count);
+      RADIANT_EXPECT_TRUE(
+          contains(node->bounds, bvh->nodes[node->first].bounds));
+      RADIANT_EXPECT_TRUE(
+          contains(node->bounds, bvh->nodes[node->first + 1].bounds));
+      continue;
+    }
+
+    ++leaves;
+    covered += node->count;
+    RADIANT_EXPECT_TRUE(node->count <= max_leaf_size);
+    for (uint32_t j = node->first; j < node->first + node->count; ++j) {
+      uint32_t t = bvh->triangle_indices[j];
+      radiant_point3_t p[3] = {vertex(grid, 3 * t), vertex(grid, (3 * t) + 1),
+                               vertex(grid, (3 * t) + 2)};
+      RADIANT_EXPECT_TRUE(
+          contains(node->bounds, radiant_aabb_from_points(p, 3)));
+    }
+  }
+  RADIANT_EXPECT_EQ(covered, grid->triangle_count);
+  RADIANT_EXPECT_EQ(bvh->stats.leaf_count, leaves);
+  RADIANT_EXPECT_EQ(bvh->stats.node_count, (2 * leaves) - 1);
+  RADIANT_EXPECT_EQ(bvh->stats.node_count, bvh->node_count - 1);
+  RADIANT_EXPECT_TRUE(bvh->stats.max_depth <= RADIANT_BVH_MAX_DEPTH);
+  RADIANT_EXPECT_TRUE(bvh->stats.sah_cost > 0.f);
+  RADIANT_EXPECT_TRUE(bvh->stats.build_ms >= 0.0);
+  return true;
+}
+
+/// Checks radiant_bvh_intersect against testing every triangle of |grid|.
+static bool intersects_like_brute_force(const radiant_bvh_t* bvh,
+                                        const grid_t* grid) {
+  float size = (float)grid->size;
+  uint32_t hits = 0;
+  for (uint32_t j = 0; j < 200; ++j) {
+    float fj = (float)j;
+    radiant_ray_t ray = {
+        .origin = {fmodf(fj * 7.31f, size), fmodf(fj * 3.17f, size), 10.f},
+        .direction = {fmodf(fj * 0.37f, 2.f) - 1.f,
+                      fmodf(fj * 0.53f, 2.f) - 1.f, -1.f},
+        .t_max = INFINITY,
+    };
+    radiant_ray_triangle_hit_t hit = radiant_bvh_intersect(bvh, ray);
+
+    radiant_ray_triangle_hit_t expected = {.t = INFINITY};
+    for (uint32_t t = 0; t < grid->triangle_count; ++t) {
+      radiant_ray_triangle_hit_t h = radiant_ray_intersect_triangle(
+          ray, vertex(grid, 3 * t), vertex(grid, (3 * t) + 1),
+          vertex(grid, (3 * t) + 2));
+      if (h.hit && h.t < expected.t) {
+        expected = h;
+      }
+    }
+
+    RADIANT_EXPECT_EQ(hit.hit, expected.hit);
+    if (!expected.hit) {
+      continue;
+    }
+    ++hits;
+    RADIANT_EXPECT_TRUE(fabsf(hit.t - expected.t) < 1e-4f);
+    // Rays through a shared edge may report either triangle, so check the
+    // one reported is hit at the same distance.
+    uint32_t t = hit.index;
+    radiant_ray_triangle_hit_t again = radiant_ray_intersect_triangle(
+        ray, vertex(grid, 3 * t), vertex(grid, (3 * t) + 1),
+        vertex(grid, (3 * t) + 2));
+    RADIANT_EXPECT_TRUE(again.hit);
+    RADIANT_EXPECT_TRUE(fabsf(again.t - hit.t) < 1e-4f);
+  }
+  RADIANT_EXPECT_TRUE(hits > 100);
+  return true;
+}
+
+static bool empty() {
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){0});
+  RADIANT_EXPECT_EQ(bvh.node_count, 0);
+  radiant_ray_t ray = {.direction = {0.f, 0.f, -1.f}, .t_max = INFINITY};
+  RADIANT_EXPECT_FALSE(radiant_bvh_intersect(&bvh, ray).hit);
+  radiant_bvh_destroy(bvh);
+  return true;
+}
+
+static bool single_triangle() {
+  grid_t grid = grid_create(1);
+  radiant_bvh_mesh_t mesh = grid_mesh(&grid);
+  mesh.triangle_count = 1;
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh,
+  });
+  RADIANT_EXPECT_EQ(bvh.node_count, 2);
+  RADIANT_EXPECT_EQ(bvh.stats.leaf_count, 1);
+  RADIANT_EXPECT_EQ(bvh.stats.max_depth, 1);
+  RADIANT_EXPECT_FLOAT_EQ(bvh.stats.sah_cost, 1.f);
+
+  radiant_ray_t ray = {
+      .origin = {0.2f, 0.2f, 10.f},
+      .direction = {0.f, 0.f, -1.f},
+      .t_max = INFINITY,
+  };
+  radiant_ray_triangle_hit_t hit = radiant_bvh_intersect(&bvh, ray);
+  RADIANT_EXPECT_TRUE(hit.hit);
+  RADIANT_EXPECT_EQ(hit.index, 0);
+  radiant_bvh_destroy(bvh);
+  grid_destroy(grid);
+  return true;
+}
+
+static bool build() {
+  grid_t grid = grid_create(40);
+  uint32_t leaf_sizes[] = {0, 1, 8};
+  for (uint32_t i = 0; i < sizeof(leaf_sizes) / sizeof(leaf_sizes[0]); ++i) {
+    radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+        .mesh = grid_mesh(&grid),
+        .max_leaf_size = leaf_sizes[i],
+    });
+    uint32_t max_leaf_size =
+        leaf_sizes[i] > 0 ? leaf_sizes[i] : RADIANT_BVH_DEFAULT_MAX_LEAF_SIZE;
+    RADIANT_EXPECT_TRUE(valid(&bvh, &grid, max_leaf_size));
+    RADIANT_EXPECT_TRUE(intersects_like_brute_force(&bvh, &grid));
+    radiant_bvh_destroy(bvh);
+  }
+  grid_destroy(grid);
+  return true;
+}
+
+static bool index_formats() {
+  grid_t grid = grid_create(20);
+  radiant_bvh_mesh_t mesh = grid_mesh(&grid);
+  radiant_bvh_t bvh32 = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh,
+  });
+  mesh.indices = grid.indices16;
+  mesh.index_format = radiant_bvh_index_format_uint16;
+  radiant_bvh_t bvh16 = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = mesh,
+  });
+  RADIANT_EXPECT_EQ(bvh16.node_count, bvh32.node_count);
+  RADIANT_EXPECT_EQ(memcmp(bvh16.nodes, bvh32.nodes,
+                           bvh16.node_count * sizeof(radiant_bvh_node_t)),
+                    0);
+  radiant_bvh_destroy(bvh32);
+  radiant_bvh_destroy(bvh16);
+  grid_destroy(grid);
+  return true;
+}
+
+static bool thread_count_independent() {
+  // Large enough to be split into parallel subtrees and binned in parallel.
+  grid_t grid = grid_create(200);
+  radiant_bvh_t serial = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = grid_mesh(&grid),
+      .thread_count = 1,
+  });
+  radiant_bvh_t parallel = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = grid_mesh(&grid),
+      .thread_count = 4,
+  });
+  RADIANT_EXPECT_TRUE(valid(&parallel, &grid, 4));
+  RADIANT_EXPECT_EQ(serial.node_count, parallel.node_count);
+  RADIANT_EXPECT_EQ(memcmp(serial.nodes, parallel.nodes,
+                           serial.node_count * sizeof(radiant_bvh_node_t)),
+                    0);
+  RADIANT_EXPECT_EQ(memcmp(serial.triangle_indices, parallel.triangle_indices,
+                           grid.triangle_count * sizeof(uint32_t)),
+                    0);
+  radiant_bvh_destroy(serial);
+  radiant_bvh_destroy(parallel);
+  grid_destroy(grid);
+  return true;
+}
+
+static bool refit() {
+  grid_t grid = grid_create(40);
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = grid_mesh(&grid),
+  });
+  float built_cost = bvh.stats.sah_cost;
+
+  grid_move(&grid, 1.3f);
+  radiant_bvh_refit(&bvh, grid_mesh(&grid));
+  RADIANT_EXPECT_TRUE(valid(&bvh, &grid, 4));
+  RADIANT_EXPECT_TRUE(intersects_like_brute_force(&bvh, &grid));
+  RADIANT_EXPECT_TRUE(bvh.stats.sah_cost != built_cost);
+
+  // Moving back restores the original tree.
+  grid_move(&grid, 0.f);
+  radiant_bvh_refit(&bvh, grid_mesh(&grid));
+  RADIANT_EXPECT_FLOAT_EQ(bvh.stats.sah_cost, built_cost);
+  radiant_bvh_destroy(bvh);
+  grid_destroy(grid);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("bvh");
+  RADIANT_TEST(empty);
+  RADIANT_TEST(single_triangle);
+  RADIANT_TEST(build);
+  RADIANT_TEST(index_formats);
+  RADIANT_TEST(thread_count_independent);
+  RADIANT_TEST(refit);
+  return radiant_suite_end();
+}
@@ -0,0 +1,291 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bvh_wide.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+/// Entries on a traversal stack. Each level visited replaces one entry with
+/// at most RADIANT_BVH_WIDE_MAX_WIDTH children, and the wide tree is no
+/// deeper than the binary one.
+#define STACK_SIZE \
+  ((RADIANT_BVH_MAX_DEPTH * (RADIANT_BVH_WIDE_MAX_WIDTH - 1)) + 1)
+
+static const size_t kNodeAlignment = 64;
+
+/// The child slots of a node of either width. The six bounds arrays follow
+/// each other from |bounds|.
+typedef struct slots_t {
+  float* bounds;
+  uint32_t* child;
+  uint32_t* count;
+} slots_t;
+
+/// Shared state of a collapse. It runs twice, first with no nodes allocated
+/// to count them, then to fill them in.
+typedef struct collapser_t {
+  const radiant_bvh_node_t* nodes;
+  /// The number of leaves below each binary node
+  uint32_t* leaf_counts;
+  radiant_bvh_wide_t* bvh;
+  uint32_t node_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} collapser_t;
+
+/// A child still to visit and where the ray enters it.
+typedef struct entry_t {
+  uint32_t child;
+  uint32_t count;
+  float t;
+} entry_t;
+
+static slots_t slots_of(const radiant_bvh_wide_t* bvh, uint32_t idx) {
+  if (bvh->width == 4) {
+    radiant_bvh4_node_t* node = &bvh->nodes4[idx];
+    return (slots_t){node->min_x, node->child, node->count};
+  }
+  radiant_bvh8_node_t* node = &bvh->nodes8[idx];
+  return (slots_t){node->min_x, node->child, node->count};
+}
+
+/// Emits the wide node standing for the binary interior node |idx| and the
+/// nodes below it. Returns the index of the wide node.
+static uint32_t collapse(collapser_t* c, uint32_t idx) {
+  const uint32_t width = c->bvh->width;
+  uint32_t out = c->node_count++;
+
+  // Open interior slots until the node is full or only leaves are left.
+  // Subtrees whose leaves all fit in the free slots go first, absorbing
+  // them saves a node that would otherwise be mostly empty. Otherwise open
+  // the slot with the largest surface area, the child most rays reach.
+  uint32_t slots[RADIANT_BVH_WIDE_MAX_WIDTH] = {idx};
+  uint32_t n = 1;
+  while (n < width) {
+    uint32_t open = n;
+    bool open_fits = false;
+    float open_area = -1.f;
+    for (uint32_t k = 0; k < n; ++k) {
+      const radiant_bvh_node_t* node = &c->nodes[slots[k]];
+      if (node->count > 0) {
+        continue;
+      }
+      bool fits = c->leaf_counts[slots[k]] - 1 <= width - n;
+      float area = radiant_aabb_surface_area(node->bounds);
+      if ((fits && !open_fits) || (fits == open_fits && area > open_area)) {
+        open = k;
+        open_fits = fits;
+        open_area = area;
+      }
+    }
+    if (open == n) {
+      break;
+    }
+    uint32_t first = c->nodes[slots[open]].first;
+    slots[open] = first;
+    slots[n++] = first + 1;
+  }
+
+  bool fill = c->bvh->nodes4 != NULL;
+  slots_t s = fill ? slots_of(c->bvh, out) : (slots_t){0};
+  for (uint32_t k = 0; k < width; ++k) {
+    if (k >= n) {
+      if (fill) {
+        for (uint32_t axis = 0; axis < 6; ++axis) {
+          s.bounds[(axis * width) + k] = 0.f;
+        }
+        s.child[k] = 0;
+        s.count[k] = RADIANT_BVH_WIDE_EMPTY;
+      }
+      continue;
+    }
+
+    const radiant_bvh_node_t* node = &c->nodes[slots[k]];
+    uint32_t child = node->count > 0 ? node->first : collapse(c, slots[k]);
+    if (fill) {
+      s.bounds[k] = node->bounds.min.x;
+      s.bounds[width + k] = node->bounds.min.y;
+      s.bounds[(2 * width) + k] = node->bounds.min.z;
+      s.bounds[(3 * width) + k] = node->bounds.max.x;
+      s.bounds[(4 * width) + k] = node->bounds.max.y;
+      s.bounds[(5 * width) + k] = node->bounds.max.z;
+      s.child[k] = child;
+      s.count[k] = node->count;
+    }
+  }
+  return out;
+}
+
+radiant_bvh_wide_t radiant_bvh_wide_collapse(const radiant_bvh_t* bvh,
+                                             uint32_t width) {
+  RADIANT_ASSERT(bvh);
+  RADIANT_ASSERT(width == 4 || width == 8);
+  radiant_bvh_wide_t wide = {.width = width};
+  if (bvh->node_count == 0) {
+    return wide;
+  }
+
+  collapser_t c = {
+      .nodes = bvh->nodes,
+      .leaf_counts = (uint32_t*)malloc(bvh->node_count * sizeof(uint32_t)),
+      .bvh = &wide,
+  };
+  if (!c.leaf_counts) {
+    return wide;
+  }
+  // Children come after their parent, so walking backwards counts them
+  // first.
+  for (uint32_t i = bvh->node_count; i-- > 0;) {
+    const radiant_bvh_node_t* node = &bvh->nodes[i];
+    c.leaf_counts[i] = node->count > 0 || i == 1
+                           ? 1
+                           : c.leaf_counts[node->first] +
+                                 c.leaf_counts[node->first + 1];
+  }
+
+  collapse(&c, 0);
+  size_t node_size = width == 4 ? sizeof(radiant_bvh4_node_t)
+                                : sizeof(radiant_bvh8_node_t);
+  void* nodes = aligned_alloc(kNodeAlignment, c.node_count * node_size);
+  if (!nodes) {
+    free(c.leaf_counts);
+    return wide;
+  }
+  if (width == 4) {
+    wide.nodes4 = (radiant_bvh4_node_t*)nodes;
+  } else {
+    wide.nodes8 = (radiant_bvh8_node_t*)nodes;
+  }
+  wide.node_count = c.node_count;
+  c.node_count = 0;
+  collapse(&c, 0);
+  free(c.leaf_counts);
+
+  wide.triangles = bvh->triangles;
+  wide.triangle_indices = bvh->triangle_indices;
+  return wide;
+}
+
+void radiant_bvh_wide_destroy(radiant_bvh_wide_t bvh) {
+  free(bvh.nodes4);
+}
+
+/// Returns the closest hit of |ray| in |bvh|, or if |any_hit| the first hit
+/// found. Children are visited nearest first either way, a near occluder is
+/// the likeliest to be found early.
+static radiant_ray_triangle_hit_t traverse(const radiant_bvh_wide_t* bvh,
+                                           radiant_ray_t ray,
+                                           bool any_hit) {
+  radiant_ray_triangle_hit_t best = {.t = INFINITY};
+  if (bvh->node_count == 0) {
+    return best;
+  }
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+  const radiant_vec3_t inv = radiant_ray_inv_direction(ray.direction);
+  const uint32_t width = bvh->width;
+
+  entry_t stack[STACK_SIZE];
+  uint32_t size = 0;
+  uint32_t idx = 0;
+  for (;;) {
+    slots_t node = slots_of(bvh, idx);
+    float t[RADIANT_BVH_WIDE_MAX_WIDTH];
+    uint32_t mask = ops->ray_intersect_aabbs(t, &ray, &inv, node.bounds, width);
+
+    // Push the children hit sorted so the nearest is on top.
+    uint32_t first = size;
+    for (uint32_t k = 0; k < width; ++k) {
+      if (!((mask >> k) & 1u) || node.count[k] == RADIANT_BVH_WIDE_EMPTY) {
+        continue;
+      }
+      RADIANT_ASSERT(size < STACK_SIZE);
+      uint32_t j = size++;
+      for (; j > first && stack[j - 1].t < t[k]; --j) {
+        stack[j] = stack[j - 1];
+      }
+      stack[j] = (entry_t){node.child[k], node.count[k], t[k]};
+    }
+
+    // Intersect leaves until the next interior node, skipping children the
+    // ray now enters beyond the closest hit.
+    bool descend = false;
+    while (size > 0 && !descend) {
+      entry_t e = stack[--size];
+      if (e.t > ray.t_max) {
+        continue;
+      }
+      if (e.count == 0) {
+        idx = e.child;
+        descend = true;
+        continue;
+      }
+      radiant_ray_triangle_hit_t hit = ops->ray_intersect_triangles(
+          &ray, &bvh->triangles, e.child, e.child + e.count);
+      if (hit.hit) {
+        best = hit;
+        ray.t_max = hit.t;
+        if (any_hit) {
+          size = 0;
+        }
+      }
+    }
+    if (!descend) {
+      break;
+    }
+  }
+
+  if (best.hit) {
+    best.index = bvh->triangle_indices[best.index];
+  }
+  return best;
+}
+
+radiant_ray_triangle_hit_t radiant_bvh_wide_intersect(
+    const radiant_bvh_wide_t* bvh,
+    radiant_ray_t ray) {
+  RADIANT_ASSERT(bvh);
+  return traverse(bvh, ray, false);
+}
+
+bool radiant_bvh_wide_occluded(const radiant_bvh_wide_t* bvh,
+                               radiant_ray_t ray) {
+  RADIANT_ASSERT(bvh);
+  return traverse(bvh, ray, true).hit;
+}
+
+void radiant_bvh_wide_intersect_stream(const radiant_bvh_wide_t* bvh,
+                                       const radiant_ray_t* rays,
+                                       uint32_t count,
+                                       radiant_ray_triangle_hit_t* hits) {
+  RADIANT_ASSERT(bvh);
+  RADIANT_ASSERT((rays && hits) || count == 0);
+  for (uint32_t i = 0; i < count; ++i) {
+    hits[i] = traverse(bvh, rays[i], false);
+  }
+}
+
+void radiant_bvh_wide_occluded_stream(const radiant_bvh_wide_t* bvh,
+                                      const radiant_ray_t* rays,
+                                      uint32_t count,
+                                      bool* occluded) {
+  RADIANT_ASSERT(bvh);
+  RADIANT_ASSERT((rays && occluded) || count == 0);
+  for (uint32_t i = 0; i < count; ++i) {
+    occluded[i] = traverse(bvh, rays[i], true).hit;
+  }
+}
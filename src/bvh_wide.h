@@ -0,0 +1,141 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/bvh.h"
+#include "src/pad.h"
+#include "src/ray.h"
+
+/// The most children a node of a radiant_bvh_wide_t has.
+#define RADIANT_BVH_WIDE_MAX_WIDTH 8
+
+/// The |count| of an unused child slot of a wide node.
+#define RADIANT_BVH_WIDE_EMPTY UINT32_MAX
+
+/// A node of a 4 wide radiant_bvh_wide_t, two cache lines. The bounds of the
+/// children are stored as structure-of-arrays so a ray is tested against all
+/// of them at once. Children are packed into the first slots.
+typedef struct radiant_bvh4_node_t {
+  /// The minimum x of each child
+  float min_x[4];
+  /// The minimum y of each child
+  float min_y[4];
+  /// The minimum z of each child
+  float min_z[4];
+  /// The maximum x of each child
+  float max_x[4];
+  /// The maximum y of each child
+  float max_y[4];
+  /// The maximum z of each child
+  float max_z[4];
+  /// For interior children the index of the child node, for leaves the index
+  /// of the first triangle
+  uint32_t child[4];
+  /// The number of triangles in a leaf, zero for interior children and
+  /// RADIANT_BVH_WIDE_EMPTY for unused slots
+  uint32_t count[4];
+} radiant_bvh4_node_t;
+
+/// A node of an 8 wide radiant_bvh_wide_t, four cache lines. Laid out as
+/// radiant_bvh4_node_t.
+typedef struct radiant_bvh8_node_t {
+  /// The minimum x of each child
+  float min_x[8];
+  /// The minimum y of each child
+  float min_y[8];
+  /// The minimum z of each child
+  float min_z[8];
+  /// The maximum x of each child
+  float max_x[8];
+  /// The maximum y of each child
+  float max_y[8];
+  /// The maximum z of each child
+  float max_z[8];
+  /// For interior children the index of the child node, for leaves the index
+  /// of the first triangle
+  uint32_t child[8];
+  /// The number of triangles in a leaf, zero for interior children and
+  /// RADIANT_BVH_WIDE_EMPTY for unused slots
+  uint32_t count[8];
+} radiant_bvh8_node_t;
+
+/// A bounding volume hierarchy with 4 or 8 children per node, collapsed from
+/// a binary radiant_bvh_t. Traversal tests a ray against every child of a
+/// node with one SIMD kernel, so there are fewer, more predictable steps
+/// than in the binary tree.
+typedef struct radiant_bvh_wide_t {
+  /// The nodes in a single 64 byte aligned array. The root is node 0 and
+  /// children always come after their parent.
+  union {
+    /// The nodes if |width| is 4
+    radiant_bvh4_node_t* nodes4;
+    /// The nodes if |width| is 8
+    radiant_bvh8_node_t* nodes8;
+  };
+  /// The triangles in leaf order, shared with the binary tree
+  radiant_triangle_soa_t triangles;
+  /// The index in the mesh of each triangle in |triangles|, shared with the
+  /// binary tree
+  const uint32_t* triangle_indices;
+  /// The length of |nodes4| or |nodes8|
+  uint32_t node_count;
+  /// The children per node, 4 or 8
+  uint32_t width;
+} radiant_bvh_wide_t;
+
+/// Collapses the binary |bvh| into a tree |width|, 4 or 8, children wide.
+/// Each wide node takes the place of a binary node and the nodes below it,
+/// repeatedly opening the child with the largest surface area until the
+/// node is full. The leaves, and so the triangles, stay the same.
+///
+/// The result shares the triangles of |bvh|, which must outlive it. Collapse
+/// again after radiant_bvh_refit. Returns an empty tree, with a node count of
+/// zero, if |bvh| is empty or an allocation fails.
+radiant_bvh_wide_t radiant_bvh_wide_collapse(const radiant_bvh_t* bvh,
+                                             uint32_t width);
+
+/// Destroys |bvh|, but not the binary tree it was collapsed from.
+void radiant_bvh_wide_destroy(radiant_bvh_wide_t bvh);
+
+/// Returns the closest hit of |ray| against the triangles of |bvh|, at the
+/// distance radiant_bvh_intersect finds in the binary tree. The |index| of the
+/// hit is the index of the triangle in the mesh, if triangles tie either may
+/// be returned. Children are visited nearest first so the ray is shortened
+/// early.
+radiant_ray_triangle_hit_t radiant_bvh_wide_intersect(
+    const radiant_bvh_wide_t* bvh,
+    radiant_ray_t ray);
+
+/// Returns true if |ray| hits any triangle of |bvh|. Stops at the first hit
+/// found, for shadow and visibility rays.
+bool radiant_bvh_wide_occluded(const radiant_bvh_wide_t* bvh,
+                               radiant_ray_t ray);
+
+/// Stores radiant_bvh_wide_intersect(|bvh|, |rays|[i]) into |hits|[i] for
+/// |count| rays.
+void radiant_bvh_wide_intersect_stream(const radiant_bvh_wide_t* bvh,
+                                       const radiant_ray_t* rays,
+                                       uint32_t count,
+                                       radiant_ray_triangle_hit_t* hits);
+
+/// Stores radiant_bvh_wide_occluded(|bvh|, |rays|[i]) into |occluded|[i] for
+/// |count| rays.
+void radiant_bvh_wide_occluded_stream(const radiant_bvh_wide_t* bvh,
+                                      const radiant_ray_t* rays,
+                                      uint32_t count,
+                                      bool* occluded);
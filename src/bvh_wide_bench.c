@@ -0,0 +1,258 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Casts rays through a heightfield and through a cloud of random triangles,
+// comparing the binary BVH with its 4 and 8 wide collapses for each
+// supported SIMD backend.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/bvh.h"
+#include "src/bvh_wide.h"
+#include "src/simd.h"
+
+/// Cells per side of the heightfield, two triangles each.
+#define SIZE 256
+
+static const uint32_t kSoupTriangles = 100000;
+static const uint32_t kRays = 20000;
+static const uint32_t kIterations = 5;
+
+typedef struct scene_t {
+  const char* name;
+  radiant_point3_t* vertices;
+  uint32_t* indices;
+  radiant_ray_t* rays;
+  radiant_bvh_t bvh;
+  radiant_bvh_wide_t bvh4;
+  radiant_bvh_wide_t bvh8;
+  radiant_ray_triangle_hit_t* hits;
+  bool* occluded;
+  uint32_t vertex_count;
+  uint32_t triangle_count;
+} scene_t;
+
+/// Returns a pseudo random float in [0, 1).
+static float random_float(uint32_t* state) {
+  *state = (*state * 1664525u) + 1013904223u;
+  return (float)(*state >> 8) / 16777216.f;
+}
+
+static void allocate(scene_t* scene) {
+  scene->vertices = (radiant_point3_t*)malloc(scene->vertex_count *
+                                              sizeof(radiant_point3_t));
+  scene->indices =
+      (uint32_t*)malloc(3 * scene->triangle_count * sizeof(uint32_t));
+  scene->rays = (radiant_ray_t*)malloc(kRays * sizeof(radiant_ray_t));
+  scene->hits = (radiant_ray_triangle_hit_t*)malloc(
+      kRays * sizeof(radiant_ray_triangle_hit_t));
+  scene->occluded = (bool*)malloc(kRays * sizeof(bool));
+}
+
+/// A rolling heightfield seen from above, most rays hit.
+static scene_t terrain(void) {
+  scene_t scene = {
+      .name = "terrain",
+      .vertex_count = (SIZE + 1) * (SIZE + 1),
+      .triangle_count = 2 * SIZE * SIZE,
+  };
+  allocate(&scene);
+  for (uint32_t y = 0; y <= SIZE; ++y) {
+    for (uint32_t x = 0; x <= SIZE; ++x) {
+      float fx = (float)x;
+      float fy = (float)y;
+      scene.vertices[(y * (SIZE + 1)) + x] = (radiant_point3_t){
+          fx, fy, sinf(fx * 0.05f) * cosf(fy * 0.03f) * 20.f};
+    }
+  }
+  uint32_t i = 0;
+  for (uint32_t y = 0; y < SIZE; ++y) {
+    for (uint32_t x = 0; x < SIZE; ++x) {
+      uint32_t v = (y * (SIZE + 1)) + x;
+      uint32_t quad[6] = {v, v + 1, v + SIZE + 1, v + 1, v + SIZE + 2,
+                          v + SIZE + 1};
+      for (uint32_t k = 0; k < 6; ++k) {
+        scene.indices[i++] = quad[k];
+      }
+    }
+  }
+  uint32_t state = 1;
+  for (uint32_t r = 0; r < kRays; ++r) {
+    scene.rays[r] = (radiant_ray_t){
+        .origin = {random_float(&state) * SIZE, random_float(&state) * SIZE,
+                   50.f},
+        .direction = {(random_float(&state) * 2.f) - 1.f,
+                      (random_float(&state) * 2.f) - 1.f, -1.f},
+        .t_max = INFINITY,
+    };
+  }
+  return scene;
+}
+
+/// Small triangles scattered through a cube, with rays in every direction
+/// from inside it. Incoherent and about half the rays escape.
+static scene_t soup(void) {
+  scene_t scene = {
+      .name = "soup",
+      .vertex_count = 3 * kSoupTriangles,
+      .triangle_count = kSoupTriangles,
+  };
+  allocate(&scene);
+  uint32_t state = 2;
+  for (uint32_t i = 0; i < scene.vertex_count; i += 3) {
+    radiant_point3_t p = {random_float(&state) * 100.f,
+                          random_float(&state) * 100.f,
+                          random_float(&state) * 100.f};
+    for (uint32_t k = 0; k < 3; ++k) {
+      scene.vertices[i + k] = (radiant_point3_t){
+          p.x + random_float(&state), p.y + random_float(&state),
+          p.z + random_float(&state)};
+      scene.indices[i + k] = i + k;
+    }
+  }
+  for (uint32_t r = 0; r < kRays; ++r) {
+    scene.rays[r] = (radiant_ray_t){
+        .origin = {random_float(&state) * 100.f, random_float(&state) * 100.f,
+                   random_float(&state) * 100.f},
+        .direction = {(random_float(&state) * 2.f) - 1.f,
+                      (random_float(&state) * 2.f) - 1.f,
+                      (random_float(&state) * 2.f) - 1.f},
+        .t_max = 20.f,
+    };
+  }
+  return scene;
+}
+
+static void destroy(scene_t scene) {
+  radiant_bvh_wide_destroy(scene.bvh4);
+  radiant_bvh_wide_destroy(scene.bvh8);
+  radiant_bvh_destroy(scene.bvh);
+  free(scene.vertices);
+  free(scene.indices);
+  free(scene.rays);
+  free(scene.hits);
+  free(scene.occluded);
+}
+
+static void collapse4(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  radiant_bvh_wide_destroy(scene->bvh4);
+  scene->bvh4 = radiant_bvh_wide_collapse(&scene->bvh, 4);
+}
+
+static void collapse8(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  radiant_bvh_wide_destroy(scene->bvh8);
+  scene->bvh8 = radiant_bvh_wide_collapse(&scene->bvh, 8);
+}
+
+static void intersect_binary(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  for (uint32_t i = 0; i < kRays; ++i) {
+    scene->hits[i] = radiant_bvh_intersect(&scene->bvh, scene->rays[i]);
+  }
+}
+
+static void intersect4(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  radiant_bvh_wide_intersect_stream(&scene->bvh4, scene->rays, kRays,
+                                    scene->hits);
+}
+
+static void intersect8(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  radiant_bvh_wide_intersect_stream(&scene->bvh8, scene->rays, kRays,
+                                    scene->hits);
+}
+
+static void occluded4(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  radiant_bvh_wide_occluded_stream(&scene->bvh4, scene->rays, kRays,
+                                   scene->occluded);
+}
+
+static void occluded8(void* userdata) {
+  scene_t* scene = (scene_t*)userdata;
+  radiant_bvh_wide_occluded_stream(&scene->bvh8, scene->rays, kRays,
+                                   scene->occluded);
+}
+
+static void run(scene_t* scene) {
+  scene->bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh =
+          {
+              .vertices = scene->vertices,
+              .indices = scene->indices,
+              .vertex_stride = sizeof(radiant_point3_t),
+              .vertex_count = scene->vertex_count,
+              .triangle_count = scene->triangle_count,
+              .index_format = radiant_bvh_index_format_uint32,
+          },
+  });
+  char name[64];
+  snprintf(name, sizeof(name), "bvh_wide_collapse4 [%s]", scene->name);
+  radiant_bench_run(name, collapse4, scene, kIterations, 1);
+  snprintf(name, sizeof(name), "bvh_wide_collapse8 [%s]", scene->name);
+  radiant_bench_run(name, collapse8, scene, kIterations, 1);
+  printf("%u triangles: %u binary nodes, %u BVH4 nodes, %u BVH8 nodes\n",
+         scene->triangle_count, scene->bvh.stats.node_count,
+         scene->bvh4.node_count, scene->bvh8.node_count);
+
+  struct {
+    const char* name;
+    radiant_bench_fn_t fn;
+  } cases[] = {
+      {"bvh_intersect", intersect_binary},
+      {"bvh4_intersect", intersect4},
+      {"bvh8_intersect", intersect8},
+      {"bvh4_occluded", occluded4},
+      {"bvh8_occluded", occluded8},
+  };
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t b = 0; b < radiant_simd_backend_count; ++b) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)b;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+    for (uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+      snprintf(name, sizeof(name), "%s [%s, %s]", cases[c].name, scene->name,
+               radiant_simd_backend_name(backend));
+      radiant_bench_run(name, cases[c].fn, scene, kIterations, kRays);
+    }
+  }
+  radiant_simd_set_backend(original);
+
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < kRays; ++i) {
+    hits += scene->occluded[i] ? 1 : 0;
+  }
+  printf("%u of %u rays hit\n", hits, kRays);
+}
+
+int main() {
+  scene_t scenes[] = {terrain(), soup()};
+  for (uint32_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); ++i) {
+    if (!scenes[i].vertices || !scenes[i].indices || !scenes[i].rays ||
+        !scenes[i].hits || !scenes[i].occluded) {
+      printf("Allocation failed\n");
+      return 1;
+    }
+    run(&scenes[i]);
+    destroy(scenes[i]);
+  }
+  return 0;
+}
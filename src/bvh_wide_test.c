@@ -0,0 +1,359 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/bvh_wide.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "src/simd.h"
+#include "src/test.h"
+
+/// Cells per side of the test heightfield, two triangles each.
+#define SIZE 40
+
+/// Rays cast by each comparison against the binary tree.
+#define RAYS 300
+
+/// A heightfield over a square grid and its binary BVH.
+typedef struct scene_t {
+  radiant_point3_t* vertices;
+  uint32_t* indices;
+  radiant_bvh_t bvh;
+} scene_t;
+
+static scene_t scene_create(uint32_t triangle_count) {
+  uint32_t n = SIZE + 1;
+  scene_t scene = {
+      .vertices = (radiant_point3_t*)malloc(n * n * sizeof(radiant_point3_t)),
+      .indices = (uint32_t*)malloc(6 * SIZE * SIZE * sizeof(uint32_t)),
+  };
+  for (uint32_t y = 0; y < n; ++y) {
+    for (uint32_t x = 0; x < n; ++x) {
+      float fx = (float)x;
+      float fy = (float)y;
+      scene.vertices[(y * n) + x] = (radiant_point3_t){
+          fx, fy, sinf(fx * 0.7f) * cosf(fy * 0.45f) * 2.f};
+    }
+  }
+  uint32_t i = 0;
+  for (uint32_t y = 0; y < SIZE; ++y) {
+    for (uint32_t x = 0; x < SIZE; ++x) {
+      uint32_t v = (y * n) + x;
+      uint32_t quad[6] = {v, v + 1, v + n, v + 1, v + n + 1, v + n};
+      for (uint32_t k = 0; k < 6; ++k) {
+        scene.indices[i++] = quad[k];
+      }
+    }
+  }
+  scene.bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh =
+          {
+              .vertices = scene.vertices,
+              .indices = scene.indices,
+              .vertex_stride = sizeof(radiant_point3_t),
+              .vertex_count = n * n,
+              .triangle_count = triangle_count,
+              .index_format = radiant_bvh_index_format_uint32,
+          },
+  });
+  return scene;
+}
+
+static void scene_destroy(scene_t scene) {
+  radiant_bvh_destroy(scene.bvh);
+  free(scene.vertices);
+  free(scene.indices);
+}
+
+/// Returns ray |i| of a mix of steep, grazing and axis aligned rays.
+static radiant_ray_t scene_ray(uint32_t i) {
+  float fi = (float)i;
+  float size = (float)SIZE;
+  radiant_ray_t ray = {
+      .origin = {fmodf(fi * 7.31f, size), fmodf(fi * 3.17f, size), 10.f},
+      .direction = {fmodf(fi * 0.37f, 2.f) - 1.f,
+                    fmodf(fi * 0.53f, 2.f) - 1.f, -1.f},
+      .t_max = INFINITY,
+  };
+  switch (i % 4) {
+    case 1:
+      ray.origin.z = 0.5f;
+      ray.direction.z = 0.01f;
+      break;
+    case 2:
+      ray.origin.x = floorf(ray.origin.x);
+      ray.direction = (radiant_vec3_t){0.f, 0.f, -1.f};
+      break;
+    case 3:
+      ray.t_min = 2.f;
+      break;
+    default:
+      break;
+  }
+  return ray;
+}
+
+static bool contains(const float* bounds,
+                     uint32_t width,
+                     uint32_t k,
+                     radiant_aabb_t box) {
+  return bounds[k] <= box.min.x && bounds[width + k] <= box.min.y &&
+         bounds[(2 * width) + k] <= box.min.z &&
+         bounds[(3 * width) + k] >= box.max.x &&
+         bounds[(4 * width) + k] >= box.max.y &&
+         bounds[(5 * width) + k] >= box.max.z;
+}
+
+/// Checks the layout of |wide| collapsed from |bvh|.
+static bool valid(const radiant_bvh_wide_t* wide, const radiant_bvh_t* bvh) {
+  RADIANT_EXPECT_TRUE(wide->node_count > 0);
+  RADIANT_EXPECT_TRUE((((uintptr_t)wide->nodes4) & 63u) == 0);
+  RADIANT_EXPECT_TRUE(wide->triangle_indices == bvh->triangle_indices);
+
+  // Every triangle is in exactly one leaf and every node but the root has
+  // exactly one parent.
+  uint32_t triangle_count = bvh->triangles.v0.count;
+  uint8_t* seen = (uint8_t*)calloc(triangle_count, 1);
+  uint8_t* parents = (uint8_t*)calloc(wide->node_count, 1);
+  for (uint32_t i = 0; i < wide->node_count; ++i) {
+    const float* bounds = wide->width == 4 ? wide->nodes4[i].min_x
+                                           : wide->nodes8[i].min_x;
+    const uint32_t* child = wide->width == 4 ? wide->nodes4[i].child
+                                             : wide->nodes8[i].child;
+    const uint32_t* count = wide->width == 4 ? wide->nodes4[i].count
+                                             : wide->nodes8[i].count;
+    uint32_t used = 0;
+    for (uint32_t k = 0; k < wide->width; ++k) {
+      if (count[k] == RADIANT_BVH_WIDE_EMPTY) {
+        continue;
+      }
+      // Children are packed into the first slots.
+      RADIANT_EXPECT_EQ(used++, k);
+      if (count[k] > 0) {
+        for (uint32_t t = child[k]; t < child[k] + count[k]; ++t) {
+          RADIANT_EXPECT_TRUE(t < triangle_count);
+          RADIANT_EXPECT_EQ(seen[t], 0);
+          seen[t] = 1;
+        }
+        continue;
+      }
+      RADIANT_EXPECT_TRUE(child[k] > i);
+      RADIANT_EXPECT_TRUE(child[k] < wide->node_count);
+      RADIANT_EXPECT_EQ(parents[child[k]], 0);
+      parents[child[k]] = 1;
+
+      // The slot bounds contain everything in the child.
+      const float* below = wide->width == 4 ? wide->nodes4[child[k]].min_x
+                                            : wide->nodes8[child[k]].min_x;
+      for (uint32_t j = 0; j < wide->width; ++j) {
+        radiant_aabb_t box = {
+            .min = {below[j], below[wide->width + j],
+                    below[(2 * wide->width) + j]},
+            .max = {below[(3 * wide->width) + j],
+                    below[(4 * wide->width) + j],
+                    below[(5 * wide->width) + j]},
+        };
+        const uint32_t* below_count = wide->width == 4
+                                          ? wide->nodes4[child[k]].count
+                                          : wide->nodes8[child[k]].count;
+        if (below_count[j] != RADIANT_BVH_WIDE_EMPTY) {
+          RADIANT_EXPECT_TRUE(contains(bounds, wide->width, k, box));
+        }
+      }
+    }
+    // Only the root of a single leaf tree has fewer than two children.
+    RADIANT_EXPECT_TRUE(used >= 2 || wide->node_count == 1);
+  }
+  for (uint32_t t = 0; t < triangle_count; ++t) {
+    RADIANT_EXPECT_EQ(seen[t], 1);
+  }
+  for (uint32_t i = 1; i < wide->node_count; ++i) {
+    RADIANT_EXPECT_EQ(parents[i], 1);
+  }
+  free(seen);
+  free(parents);
+  return true;
+}
+
+/// Checks |wide| finds the hits the binary tree it was collapsed from does.
+static bool matches_binary(const radiant_bvh_wide_t* wide,
+                           const radiant_bvh_t* bvh,
+                           const scene_t* scene) {
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < RAYS; ++i) {
+    radiant_ray_t ray = scene_ray(i);
+    radiant_ray_triangle_hit_t expected = radiant_bvh_intersect(bvh, ray);
+    radiant_ray_triangle_hit_t hit = radiant_bvh_wide_intersect(wide, ray);
+    RADIANT_EXPECT_EQ(hit.hit, expected.hit);
+    RADIANT_EXPECT_EQ(radiant_bvh_wide_occluded(wide, ray), expected.hit);
+    if (!expected.hit) {
+      continue;
+    }
+    ++hits;
+    // Both trees test the same leaves with the same kernel.
+    RADIANT_EXPECT_TRUE(hit.t == expected.t);
+    const uint32_t* tri = scene->indices + (3 * hit.index);
+    radiant_ray_triangle_hit_t again = radiant_ray_intersect_triangle(
+        ray, scene->vertices[tri[0]], scene->vertices[tri[1]],
+        scene->vertices[tri[2]]);
+    RADIANT_EXPECT_TRUE(again.hit);
+    RADIANT_EXPECT_TRUE(fabsf(again.t - hit.t) < 1e-4f);
+
+    // Nothing is closer than the closest hit.
+    ray.t_max = hit.t * 0.99f;
+    RADIANT_EXPECT_FALSE(radiant_bvh_wide_occluded(wide, ray));
+  }
+  RADIANT_EXPECT_TRUE(hits > RAYS / 2);
+  return true;
+}
+
+static bool empty() {
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){0});
+  radiant_bvh_wide_t wide = radiant_bvh_wide_collapse(&bvh, 8);
+  RADIANT_EXPECT_EQ(wide.node_count, 0);
+  radiant_ray_t ray = {.direction = {0.f, 0.f, -1.f}, .t_max = INFINITY};
+  RADIANT_EXPECT_FALSE(radiant_bvh_wide_intersect(&wide, ray).hit);
+  RADIANT_EXPECT_FALSE(radiant_bvh_wide_occluded(&wide, ray));
+  radiant_bvh_wide_destroy(wide);
+  radiant_bvh_destroy(bvh);
+  return true;
+}
+
+static bool single_leaf() {
+  scene_t scene = scene_create(1);
+  for (uint32_t width = 4; width <= 8; width += 4) {
+    radiant_bvh_wide_t wide = radiant_bvh_wide_collapse(&scene.bvh, width);
+    RADIANT_EXPECT_EQ(wide.node_count, 1);
+    RADIANT_EXPECT_TRUE(valid(&wide, &scene.bvh));
+    radiant_ray_t ray = {
+        .origin = {0.2f, 0.2f, 10.f},
+        .direction = {0.f, 0.f, -1.f},
+        .t_max = INFINITY,
+    };
+    radiant_ray_triangle_hit_t hit = radiant_bvh_wide_intersect(&wide, ray);
+    RADIANT_EXPECT_TRUE(hit.hit);
+    RADIANT_EXPECT_EQ(hit.index, 0);
+    RADIANT_EXPECT_TRUE(radiant_bvh_wide_occluded(&wide, ray));
+    radiant_bvh_wide_destroy(wide);
+  }
+  scene_destroy(scene);
+  return true;
+}
+
+static bool aabbs_match_single() {
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+  float bounds[6 * RADIANT_BVH_WIDE_MAX_WIDTH];
+  radiant_aabb_t boxes[RADIANT_BVH_WIDE_MAX_WIDTH];
+  for (uint32_t width = 4; width <= 8; width += 4) {
+    for (uint32_t k = 0; k < width; ++k) {
+      float fk = (float)k;
+      boxes[k] = (radiant_aabb_t){
+          .min = {fk - 4.f, -1.f, fk * 0.5f},
+          .max = {fk - 3.f, 1.f + fk, (fk * 0.5f) + 1.f},
+      };
+      bounds[k] = boxes[k].min.x;
+      bounds[width + k] = boxes[k].min.y;
+      bounds[(2 * width) + k] = boxes[k].min.z;
+      bounds[(3 * width) + k] = boxes[k].max.x;
+      bounds[(4 * width) + k] = boxes[k].max.y;
+      bounds[(5 * width) + k] = boxes[k].max.z;
+    }
+    for (uint32_t i = 0; i < RAYS; ++i) {
+      float fi = (float)i;
+      radiant_ray_t ray = {
+          .origin = {fmodf(fi * 1.37f, 12.f) - 6.f, -5.f,
+                     fmodf(fi * 0.71f, 6.f) - 1.f},
+          .direction = {fmodf(fi * 0.37f, 2.f) - 1.f, 1.f,
+                        fmodf(fi * 0.53f, 2.f) - 1.f},
+          .t_max = (i % 3) == 0 ? 5.f : INFINITY,
+      };
+      if ((i % 5) == 0) {
+        // Axis aligned, along the shared faces of neighbouring boxes.
+        ray.origin.x = floorf(ray.origin.x);
+        ray.direction = (radiant_vec3_t){0.f, 1.f, 0.f};
+      }
+      radiant_vec3_t inv = radiant_ray_inv_direction(ray.direction);
+      float t[RADIANT_BVH_WIDE_MAX_WIDTH];
+      uint32_t mask = ops->ray_intersect_aabbs(t, &ray, &inv, bounds, width);
+      for (uint32_t k = 0; k < width; ++k) {
+        radiant_ray_aabb_hit_t expected = radiant_ray_intersect_aabb(ray,
+                                                                     boxes[k]);
+        RADIANT_EXPECT_EQ((mask >> k) & 1u, expected.hit ? 1u : 0u);
+        if (expected.hit) {
+          RADIANT_EXPECT_TRUE(t[k] == expected.t_near);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool collapse() {
+  scene_t scene = scene_create(2 * SIZE * SIZE);
+  for (uint32_t width = 4; width <= 8; width += 4) {
+    radiant_bvh_wide_t wide = radiant_bvh_wide_collapse(&scene.bvh, width);
+    RADIANT_EXPECT_TRUE(valid(&wide, &scene.bvh));
+    // Each wide node absorbs at least one binary interior node.
+    RADIANT_EXPECT_TRUE(wide.node_count <= scene.bvh.stats.node_count / 2);
+    radiant_bvh_wide_destroy(wide);
+  }
+  scene_destroy(scene);
+  return true;
+}
+
+static bool intersect() {
+  scene_t scene = scene_create(2 * SIZE * SIZE);
+  for (uint32_t width = 4; width <= 8; width += 4) {
+    radiant_bvh_wide_t wide = radiant_bvh_wide_collapse(&scene.bvh, width);
+    RADIANT_EXPECT_TRUE(matches_binary(&wide, &scene.bvh, &scene));
+    radiant_bvh_wide_destroy(wide);
+  }
+  scene_destroy(scene);
+  return true;
+}
+
+static bool streams() {
+  scene_t scene = scene_create(2 * SIZE * SIZE);
+  radiant_bvh_wide_t wide = radiant_bvh_wide_collapse(&scene.bvh, 8);
+  radiant_ray_t rays[RAYS];
+  for (uint32_t i = 0; i < RAYS; ++i) {
+    rays[i] = scene_ray(i);
+  }
+  radiant_ray_triangle_hit_t hits[RAYS];
+  bool occluded[RAYS];
+  radiant_bvh_wide_intersect_stream(&wide, rays, RAYS, hits);
+  radiant_bvh_wide_occluded_stream(&wide, rays, RAYS, occluded);
+  for (uint32_t i = 0; i < RAYS; ++i) {
+    radiant_ray_triangle_hit_t hit = radiant_bvh_wide_intersect(&wide, rays[i]);
+    RADIANT_EXPECT_EQ(hits[i].hit, hit.hit);
+    RADIANT_EXPECT_EQ(hits[i].index, hit.index);
+    RADIANT_EXPECT_TRUE(hits[i].t == hit.t);
+    RADIANT_EXPECT_EQ(occluded[i], hit.hit);
+  }
+  radiant_bvh_wide_destroy(wide);
+  scene_destroy(scene);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("bvh_wide");
+  RADIANT_TEST(empty);
+  RADIANT_TEST(single_leaf);
+  RADIANT_TEST_ALL_BACKENDS(aabbs_match_single);
+  RADIANT_TEST(collapse);
+  RADIANT_TEST_ALL_BACKENDS(intersect);
+  RADIANT_TEST_ALL_BACKENDS(streams);
+  return radiant_suite_end();
+}
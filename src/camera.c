@@ -1,5 +1,43 @@
 #include "src/camera.h"
 
+#include <stdatomic.h>
+
+/// Bits of radiant_camera_t::dirty, one for each piece of derived data.
+enum {
+  kDirtyProjection = 1u << 0,
+  kDirtyLookAt = 1u << 1,
+  kDirtyProjectionView = 1u << 2,
+  kDirtyInverseProjection = 1u << 3,
+  kDirtyInverseLookAt = 1u << 4,
+  kDirtyInverseProjectionView = 1u << 5,
+  kDirtyFrustum = 1u << 6,
+
+  /// Everything that depends on the view matrix
+  kDirtyView = kDirtyLookAt | kDirtyProjectionView | kDirtyInverseLookAt |
+               kDirtyInverseProjectionView | kDirtyFrustum,
+  /// Everything that depends on the projection matrix
+  kDirtyProjectionAll = kDirtyProjection | kDirtyProjectionView |
+                        kDirtyInverseProjection |
+                        kDirtyInverseProjectionView | kDirtyFrustum,
+};
+
+/// The source of camera versions, shared so versions are never reused.
+static atomic_uint next_version = 1;
+
+static uint32_t new_version(void) {
+  return (uint32_t)atomic_fetch_add(&next_version, 1);
+}
+
+static void view_changed(radiant_camera_t* cam) {
+  cam->dirty |= kDirtyView;
+  cam->view_version = new_version();
+}
+
+static void projection_changed(radiant_camera_t* cam) {
+  cam->dirty |= kDirtyProjectionAll;
+  cam->projection_version = new_version();
+}
+
 radiant_camera_t radiant_camera_create(radiant_point3_t position,
                                        radiant_point3_t aim_point,
                                        radiant_vec3_t up,
@@ -12,34 +50,129 @@ radiant_camera_t radiant_camera_create(radiant_point3_t position,
           },
       .aim_point = aim_point,
       .up = up,
+      .view = view,
+      .projection = radiant_camera_projection_standard,
   };
-
-  float aspect = view.size.width / view.size.height;
-  float fov_y_radians = view.fov_y_radians;
-  cam.projection_matrix = radiant_mat4x4_perspective(
-      fov_y_radians, aspect, view.planes.near, view.planes.far);
-
-  radiant_camera_update_look_at(&cam);
+  view_changed(&cam);
+  projection_changed(&cam);
   return cam;
 }
 
 void radiant_camera_destroy(radiant_camera_t /*cam*/) {}
 
 void radiant_camera_rotate(radiant_camera_t* cam, radiant_point3_t radians) {
+  radiant_camera_rotate_quat(cam, radiant_quat_from_euler(radians));
+}
+
+void radiant_camera_rotate_quat(radiant_camera_t* cam,
+                                radiant_quat_t rotation) {
   cam->position.current =
-      radiant_mat4x4_mul(radiant_mat4x4_rotate(radians), cam->position.initial);
+      radiant_quat_rotate_point3(rotation, cam->position.initial);
+  view_changed(cam);
+}
+
+void radiant_camera_set_position(radiant_camera_t* cam,
+                                 radiant_point3_t position) {
+  cam->position.initial = position;
+  cam->position.current = position;
+  view_changed(cam);
+}
 
-  radiant_camera_update_look_at(cam);
+void radiant_camera_set_aim_point(radiant_camera_t* cam,
+                                  radiant_point3_t aim_point) {
+  cam->aim_point = aim_point;
+  view_changed(cam);
 }
 
-void radiant_camera_update_look_at(radiant_camera_t* cam) {
-  cam->look_at_matrix =
-      radiant_mat4x4_look_at(cam->position.current, cam->aim_point, cam->up);
+void radiant_camera_set_view(radiant_camera_t* cam, radiant_view_t view) {
+  cam->view = view;
+  projection_changed(cam);
+}
+
+void radiant_camera_set_projection(radiant_camera_t* cam,
+                                   radiant_camera_projection_t projection) {
+  if (cam->projection != projection) {
+    cam->projection = projection;
+    projection_changed(cam);
+  }
+}
+
+radiant_point3_t radiant_camera_position(const radiant_camera_t* cam) {
+  return cam->position.current;
+}
+
+/// Returns true, and marks |flag| up to date, if it was dirty.
+static bool take_dirty(radiant_camera_t* cam, uint32_t flag) {
+  bool dirty = (cam->dirty & flag) != 0;
+  cam->dirty &= ~flag;
+  return dirty;
+}
+
+radiant_mat4x4_t radiant_camera_view_matrix(radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyLookAt)) {
+    cam->look_at_matrix =
+        radiant_mat4x4_look_at(cam->position.current, cam->aim_point, cam->up);
+  }
+  return cam->look_at_matrix;
+}
+
+radiant_mat4x4_t radiant_camera_projection_matrix(radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyProjection)) {
+    float aspect = cam->view.size.width / cam->view.size.height;
+    cam->projection_matrix =
+        cam->projection == radiant_camera_projection_reverse_z_infinite
+            ? radiant_mat4x4_perspective_reverse_z_infinite(
+                  cam->view.fov_y_radians, aspect, cam->view.planes.near)
+            : radiant_mat4x4_perspective(cam->view.fov_y_radians, aspect,
+                                         cam->view.planes.near,
+                                         cam->view.planes.far);
+  }
+  return cam->projection_matrix;
+}
+
+radiant_mat4x4_t radiant_camera_projection_view_matrix(radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyProjectionView)) {
+    cam->projection_view_matrix =
+        radiant_mat4x4_mul(radiant_camera_projection_matrix(cam),
+                           radiant_camera_view_matrix(cam));
+  }
+  return cam->projection_view_matrix;
+}
+
+radiant_mat4x4_inverse_result_t radiant_camera_inverse_view_matrix(
+    radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyInverseLookAt)) {
+    cam->inverse_look_at =
+        radiant_mat4x4_inverse(radiant_camera_view_matrix(cam));
+  }
+  return cam->inverse_look_at;
+}
+
+radiant_mat4x4_inverse_result_t radiant_camera_inverse_projection_matrix(
+    radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyInverseProjection)) {
+    cam->inverse_projection =
+        radiant_mat4x4_inverse(radiant_camera_projection_matrix(cam));
+  }
+  return cam->inverse_projection;
+}
 
-  radiant_camera_update_projection_view_matrix(cam);
+radiant_mat4x4_inverse_result_t radiant_camera_inverse_projection_view_matrix(
+    radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyInverseProjectionView)) {
+    cam->inverse_projection_view =
+        radiant_mat4x4_inverse(radiant_camera_projection_view_matrix(cam));
+  }
+  return cam->inverse_projection_view;
 }
 
-void radiant_camera_update_projection_view_matrix(radiant_camera_t* cam) {
-  cam->projection_view_matrix =
-      radiant_mat4x4_mul(cam->projection_matrix, cam->look_at_matrix);
+radiant_frustum_t radiant_camera_frustum(radiant_camera_t* cam) {
+  if (take_dirty(cam, kDirtyFrustum)) {
+    radiant_mat4x4_t m = radiant_camera_projection_view_matrix(cam);
+    cam->frustum =
+        cam->projection == radiant_camera_projection_reverse_z_infinite
+            ? radiant_frustum_from_mat4x4_reverse_z(m)
+            : radiant_frustum_from_mat4x4(m);
+  }
+  return cam->frustum;
 }
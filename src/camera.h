@@ -1,10 +1,26 @@
 #pragma once
 
+#include <stdint.h>
+
+#include "src/frustum.h"
 #include "src/mat4x4.h"
 #include "src/point3.h"
+#include "src/quat.h"
 #include "src/vec3.h"
 #include "src/view.h"
 
+/// How a camera maps depth into clip space.
+typedef enum radiant_camera_projection_t {
+  /// radiant_mat4x4_perspective, between the near and far planes of the view
+  radiant_camera_projection_standard,
+  /// radiant_mat4x4_perspective_reverse_z_infinite, the far plane of the view
+  /// is ignored
+  radiant_camera_projection_reverse_z_infinite,
+} radiant_camera_projection_t;
+
+/// A camera looking at |aim_point|. The matrices and frustum are derived on
+/// first use after a change, read them through the radiant_camera_*
+/// functions rather than the fields.
 typedef struct radiant_camera_t {
   struct {
     radiant_point3_t initial;
@@ -12,19 +28,74 @@ typedef struct radiant_camera_t {
   } position;
   radiant_point3_t aim_point;
   radiant_vec3_t up;
+  radiant_view_t view;
+  radiant_camera_projection_t projection;
+
+  /// Changes whenever the view matrix does. Versions are unique across
+  /// cameras, so a consumer can keep the last version it saw and skip work
+  /// while it matches.
+  uint32_t view_version;
+  /// Changes whenever the projection matrix does, as |view_version|.
+  uint32_t projection_version;
+  /// The derived data that is out of date, a mask of private flags
+  uint32_t dirty;
 
   radiant_mat4x4_t projection_matrix;
   radiant_mat4x4_t look_at_matrix;
   radiant_mat4x4_t projection_view_matrix;
+  radiant_mat4x4_inverse_result_t inverse_projection;
+  radiant_mat4x4_inverse_result_t inverse_look_at;
+  radiant_mat4x4_inverse_result_t inverse_projection_view;
+  radiant_frustum_t frustum;
 } radiant_camera_t;
 
+/// Creates a camera at |position| looking at |aim_point| with the standard
+/// projection of |view|.
 radiant_camera_t radiant_camera_create(radiant_point3_t position,
                                        radiant_point3_t aim_point,
                                        radiant_vec3_t up,
                                        radiant_view_t view);
 void radiant_camera_destroy(radiant_camera_t cam);
 
+/// Moves the camera to its initial position rotated by |radians| around the
+/// aim point's origin.
 void radiant_camera_rotate(radiant_camera_t* cam, radiant_point3_t radians);
+/// Moves the camera to its initial position rotated by |rotation|.
+void radiant_camera_rotate_quat(radiant_camera_t* cam, radiant_quat_t rotation);
+
+/// Moves the camera to |position|, which also becomes its initial position.
+void radiant_camera_set_position(radiant_camera_t* cam,
+                                 radiant_point3_t position);
+/// Points the camera at |aim_point|.
+void radiant_camera_set_aim_point(radiant_camera_t* cam,
+                                  radiant_point3_t aim_point);
+/// Changes the size, field of view and planes of the camera.
+void radiant_camera_set_view(radiant_camera_t* cam, radiant_view_t view);
+/// Changes how the camera maps depth.
+void radiant_camera_set_projection(radiant_camera_t* cam,
+                                   radiant_camera_projection_t projection);
+
+/// Returns the world space position of the camera.
+radiant_point3_t radiant_camera_position(const radiant_camera_t* cam);
+
+/// Returns the view matrix, from world to camera space.
+radiant_mat4x4_t radiant_camera_view_matrix(radiant_camera_t* cam);
+/// Returns the projection matrix, from camera to clip space.
+radiant_mat4x4_t radiant_camera_projection_matrix(radiant_camera_t* cam);
+/// Returns the projection matrix times the view matrix.
+radiant_mat4x4_t radiant_camera_projection_view_matrix(radiant_camera_t* cam);
+
+/// Returns the inverse of the view matrix, the camera's world transform.
+/// Fails if the camera looks along |up|.
+radiant_mat4x4_inverse_result_t radiant_camera_inverse_view_matrix(
+    radiant_camera_t* cam);
+/// Returns the inverse of the projection matrix.
+radiant_mat4x4_inverse_result_t radiant_camera_inverse_projection_matrix(
+    radiant_camera_t* cam);
+/// Returns the inverse of the projection view matrix, which maps normalized
+/// device coordinates back into the world.
+radiant_mat4x4_inverse_result_t radiant_camera_inverse_projection_view_matrix(
+    radiant_camera_t* cam);
 
-void radiant_camera_update_look_at(radiant_camera_t* cam);
-void radiant_camera_update_projection_view_matrix(radiant_camera_t* cam);
+/// Returns the frustum of the camera, extracted to suit its projection.
+radiant_frustum_t radiant_camera_frustum(radiant_camera_t* cam);
@@ -0,0 +1,169 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/camera.h"
+
+#include "src/constants.h"
+#include "src/equal.h"
+#include "src/test.h"
+
+static bool mat4x4_equal(radiant_mat4x4_t a, radiant_mat4x4_t b) {
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (!radiant_equal(a.data[i], b.data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static radiant_view_t view(void) {
+  return (radiant_view_t){
+      .size = {.width = 1024.f, .height = 768.f},
+      .fov_y_radians = (2.f * RADIANT_PI) / 5.f,
+      .planes = {.near = 1.f, .far = 100.f},
+  };
+}
+
+static radiant_camera_t camera(void) {
+  return radiant_camera_create((radiant_point3_t){0.f, 0.f, 4.f},
+                               (radiant_point3_t){0.f, 0.f, 0.f},
+                               (radiant_vec3_t){0.f, 1.f, 0.f}, view());
+}
+
+static bool matrices() {
+  radiant_camera_t cam = camera();
+  radiant_mat4x4_t look_at = radiant_mat4x4_look_at(
+      cam.position.current, cam.aim_point, cam.up);
+  radiant_mat4x4_t projection =
+      radiant_mat4x4_perspective(view().fov_y_radians, 1024.f / 768.f, 1.f,
+                                 100.f);
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_camera_view_matrix(&cam), look_at));
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_camera_projection_matrix(&cam), projection));
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_camera_projection_view_matrix(&cam),
+                   radiant_mat4x4_mul(projection, look_at)));
+
+  radiant_mat4x4_inverse_result_t inverse_view =
+      radiant_camera_inverse_view_matrix(&cam);
+  RADIANT_EXPECT_TRUE(inverse_view.succeeded);
+  // The camera's world transform puts its origin at its position.
+  radiant_point3_t origin = radiant_mat4x4_mul_point3(
+      inverse_view.inverse, (radiant_point3_t){0.f, 0.f, 0.f});
+  RADIANT_EXPECT_FLOAT_EQ(origin.z, 4.f);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_camera_position(&cam).z, 4.f);
+
+  radiant_mat4x4_inverse_result_t inverse_projection =
+      radiant_camera_inverse_projection_matrix(&cam);
+  RADIANT_EXPECT_TRUE(inverse_projection.succeeded);
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_mat4x4_mul(inverse_projection.inverse, projection),
+                   radiant_mat4x4_identity()));
+
+  // The centre of the near plane unprojects to one unit ahead.
+  radiant_mat4x4_inverse_result_t inverse =
+      radiant_camera_inverse_projection_view_matrix(&cam);
+  RADIANT_EXPECT_TRUE(inverse.succeeded);
+  radiant_point3_t near = radiant_mat4x4_mul_point3(
+      inverse.inverse, (radiant_point3_t){0.f, 0.f, -1.f});
+  RADIANT_EXPECT_FLOAT_EQ(near.z, 3.f);
+  return true;
+}
+
+static bool lazy_and_versioned() {
+  radiant_camera_t cam = camera();
+  radiant_camera_t other = camera();
+  RADIANT_EXPECT_TRUE(cam.view_version != other.view_version);
+  RADIANT_EXPECT_TRUE(cam.projection_version != other.projection_version);
+
+  radiant_camera_frustum(&cam);
+  uint32_t view_version = cam.view_version;
+  uint32_t projection_version = cam.projection_version;
+
+  // Reading derived data changes nothing.
+  radiant_camera_projection_view_matrix(&cam);
+  radiant_camera_inverse_projection_view_matrix(&cam);
+  RADIANT_EXPECT_EQ(cam.view_version, view_version);
+  RADIANT_EXPECT_EQ(cam.projection_version, projection_version);
+
+  // Moving only changes the view, and is picked up on the next read.
+  radiant_mat4x4_t before = radiant_camera_projection_view_matrix(&cam);
+  radiant_camera_rotate(&cam, (radiant_point3_t){0.f, RADIANT_PI / 2.f, 0.f});
+  RADIANT_EXPECT_TRUE(cam.view_version != view_version);
+  RADIANT_EXPECT_EQ(cam.projection_version, projection_version);
+  RADIANT_EXPECT_TRUE(cam.dirty != 0);
+  RADIANT_EXPECT_FALSE(
+      mat4x4_equal(radiant_camera_projection_view_matrix(&cam), before));
+  RADIANT_EXPECT_FLOAT_EQ(radiant_camera_position(&cam).x, 4.f);
+
+  view_version = cam.view_version;
+  radiant_view_t wide = view();
+  wide.size.width = 2048.f;
+  radiant_camera_set_view(&cam, wide);
+  RADIANT_EXPECT_EQ(cam.view_version, view_version);
+  RADIANT_EXPECT_TRUE(cam.projection_version != projection_version);
+
+  // Setting the projection it already has is not a change.
+  projection_version = cam.projection_version;
+  radiant_camera_set_projection(&cam, radiant_camera_projection_standard);
+  RADIANT_EXPECT_EQ(cam.projection_version, projection_version);
+  return true;
+}
+
+static radiant_aabb_t box_at(float z) {
+  return (radiant_aabb_t){
+      .min = {-1.f, -1.f, z - 1.f},
+      .max = {1.f, 1.f, z + 1.f},
+  };
+}
+
+static bool reverse_z_infinite() {
+  radiant_camera_t cam = camera();
+  radiant_frustum_t standard = radiant_camera_frustum(&cam);
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(standard, box_at(-1e4f)));
+
+  radiant_camera_set_projection(&cam,
+                                radiant_camera_projection_reverse_z_infinite);
+  RADIANT_EXPECT_TRUE(mat4x4_equal(
+      radiant_camera_projection_matrix(&cam),
+      radiant_mat4x4_perspective_reverse_z_infinite(
+          view().fov_y_radians, 1024.f / 768.f, 1.f)));
+  radiant_frustum_t frustum = radiant_camera_frustum(&cam);
+  RADIANT_EXPECT_TRUE(radiant_frustum_intersects_aabb(frustum, box_at(-1e4f)));
+  RADIANT_EXPECT_TRUE(radiant_frustum_intersects_aabb(frustum, box_at(0.f)));
+  // Behind the camera.
+  RADIANT_EXPECT_FALSE(radiant_frustum_intersects_aabb(frustum, box_at(8.f)));
+
+  // Unprojecting any depth in (0, 1] lands on the view ray.
+  radiant_mat4x4_inverse_result_t inverse =
+      radiant_camera_inverse_projection_view_matrix(&cam);
+  RADIANT_EXPECT_TRUE(inverse.succeeded);
+  radiant_point3_t near = radiant_mat4x4_mul_point3(
+      inverse.inverse, (radiant_point3_t){0.f, 0.f, 1.f});
+  RADIANT_EXPECT_FLOAT_EQ(near.z, 3.f);
+  radiant_point3_t half = radiant_mat4x4_mul_point3(
+      inverse.inverse, (radiant_point3_t){0.f, 0.f, 0.5f});
+  RADIANT_EXPECT_FLOAT_EQ(half.z, 2.f);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("camera");
+  RADIANT_TEST_ALL_BACKENDS(matrices);
+  RADIANT_TEST(lazy_and_versioned);
+  RADIANT_TEST_ALL_BACKENDS(reverse_z_infinite);
+  return radiant_suite_end();
+}
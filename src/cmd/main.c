@@ -17,29 +17,42 @@
 #include "src/buffer.h"
 #include "src/camera.h"
 #include "src/colour3.h"
+#include "src/ecs.h"
 #include "src/constants.h"
 #include "src/engine.h"
+#include "src/gpu_profiler.h"
 #include "src/mat4x4.h"
+#include "src/pack.h"
+#include "src/pacer.h"
 #include "src/point3.h"
+#include "src/profile.h"
+#include "src/renderable.h"
+#include "src/resize.h"
+#include "src/quat.h"
 #include "src/resource_manager.h"
+#include "src/scene.h"
 #include "src/shader.h"
 #include "src/texture.h"
+#include "src/texture_pool.h"
+#include "src/time.h"
+#include "src/vertex_format.h"
 #include "src/view.h"
 #include "src/window.h"
 
-#include <math.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+/// The most scope names reported on exit
+#define PROFILE_STATS 32
+
+/// Shared by every draw of a frame. The model view projection matrix of each
+/// is bound at RADIANT_RENDERABLES_MVP_GROUP.
 typedef struct Uniforms {
-  radiant_mat4x4_t model_view_projection_matrix;
   uint32_t frame;
   float frame_radians;
   uint32_t image_width;
   uint32_t image_height;
-  // Pad size in order to get correct size for WGSL buffer
-  RADIANT_PAD(sizeof(radiant_mat4x4_t) - (3 * sizeof(uint32_t)) -
-              sizeof(float));
 } Uniforms;
 
 typedef struct Vertex {
@@ -47,14 +60,13 @@ typedef struct Vertex {
   radiant_colour3_t colour;
 } Vertex;
 
-typedef struct RenderBundle {
-  WGPURenderPipeline pipeline;
-  WGPUBindGroup uniform_bind_group;
-  radiant_buffer_t vertex_buffer;
-  radiant_buffer_t index_buffer;
-  uint32_t index_count;
-  uint32_t instance_count;
-} RenderBundle;
+/// Vertex as uploaded to the GPU, 12 bytes rather than the 24 of Vertex.
+typedef struct PackedVertex {
+  /// Position as halves, the fourth is unused
+  uint16_t pos[4];
+  /// Colour as unorm8, the fourth is unused
+  uint8_t colour[4];
+} PackedVertex;
 
 static Vertex pyramid_vertex_data[] = {
     {
@@ -79,6 +91,12 @@ static Vertex pyramid_vertex_data[] = {
     },
 };
 
+/// Bounds of pyramid_vertex_data, used to skip drawing it when off screen.
+static const radiant_aabb_t pyramid_bounds = {
+    .min = {-.5f, -.5f, -.5f},
+    .max = {.5f, .5f, .5f},
+};
+
 static uint16_t pyramid_index_data[] = {
     // clang-format off
     // Face 1
@@ -106,19 +124,62 @@ static uint16_t plane_index_data[] = {
     // clang-format on
 };
 
-static RenderBundle setup_plane_bundle(radiant_engine_t engine,
-                                       radiant_resource_manager_t manager,
-                                       radiant_buffer_t uniform_buffer) {
-  RenderBundle bundle;
+/// Creates the layout of group 0, Uniforms read by the vertex stage.
+static WGPUBindGroupLayout create_uniform_layout(radiant_engine_t engine) {
+  WGPUBindGroupLayoutEntry entries[] = {
+      {
+          .binding = 0,
+          .visibility = WGPUShaderStage_Vertex,
+          .buffer =
+              {
+                  .type = WGPUBufferBindingType_Uniform,
+                  .minBindingSize = sizeof(Uniforms),
+              },
+      },
+  };
+  WGPUBindGroupLayoutDescriptor desc = {
+      .label = "Uniform layout",
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(entries),
+      .entries = entries,
+  };
+  return wgpuDeviceCreateBindGroupLayout(engine.device, &desc);
+}
+
+/// Creates a bind group of |bind_group_layout| reading Uniforms from
+/// |uniform_buffer|.
+static WGPUBindGroup create_uniform_bind_group(
+    radiant_engine_t engine,
+    WGPUBindGroupLayout bind_group_layout,
+    radiant_buffer_t uniform_buffer) {
+  WGPUBindGroupEntry bind_entries[] = {
+      {
+          .binding = 0,
+          .buffer = uniform_buffer.buffer,
+          .size = sizeof(Uniforms),
+      },
+  };
+
+  WGPUBindGroupDescriptor bind_group_desc = {
+      .label = "Uniform bind group",
+      .layout = bind_group_layout,
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(bind_entries),
+      .entries = bind_entries,
+  };
+  return wgpuDeviceCreateBindGroup(engine.device, &bind_group_desc);
+}
+
+/// Leaves the bind group to be set each frame.
+static radiant_draw_t setup_plane_draw(radiant_engine_t engine,
+                                       const char* shader_source,
+                                       WGPUPipelineLayout layout) {
+  RADIANT_PROFILE_SCOPE("Setup plane");
+  radiant_draw_t draw = {
+      .index_format = WGPUIndexFormat_Uint16,
+  };
 
   // Create shader
-  radiant_shader_create_result_t shader_result =
-      radiant_shader_create_from_file(engine, manager, "Checker shader",
-                                      "shaders/checker.wgsl");
-  if (!shader_result.succeeded) {
-    return (RenderBundle){0};
-  }
-  radiant_shader_t shader = shader_result.shader;
+  radiant_shader_t shader =
+      radiant_shader_create(engine, "Checker shader", shader_source);
 
   WGPUVertexAttribute vert_attrs[] = {
       {
@@ -171,6 +232,7 @@ static RenderBundle setup_plane_bundle(radiant_engine_t engine,
 
   WGPURenderPipelineDescriptor pipeline_desc = {
       .label = "Plane Render Pipeline",
+      .layout = layout,
       .primitive =
           {
               .topology = WGPUPrimitiveTopology_TriangleList,
@@ -193,7 +255,7 @@ static RenderBundle setup_plane_bundle(radiant_engine_t engine,
           },
   };
 
-  bundle.pipeline =
+  draw.pipeline =
       wgpuDeviceCreateRenderPipeline(engine.device, &pipeline_desc);
 
   radiant_buffer_create_request_t vertex_buffer_req = {
@@ -202,7 +264,7 @@ static RenderBundle setup_plane_bundle(radiant_engine_t engine,
       .label = "Plane vertex data",
       .size_in_bytes = sizeof(plane_vertex_data),
   };
-  bundle.vertex_buffer =
+  draw.vertex_buffer =
       radiant_buffer_create_with_data(vertex_buffer_req, plane_vertex_data);
 
   radiant_buffer_create_request_t index_buffer_req = {
@@ -211,65 +273,54 @@ static RenderBundle setup_plane_bundle(radiant_engine_t engine,
       .label = "Plane index buffer",
       .size_in_bytes = sizeof(plane_index_data),
   };
-  bundle.index_buffer =
+  draw.index_buffer =
       radiant_buffer_create_with_data(index_buffer_req, plane_index_data);
-  bundle.index_count = RADIANT_ARRAY_ELEMENT_COUNT(plane_index_data);
-  bundle.instance_count = 1;
+  draw.index_count = RADIANT_ARRAY_ELEMENT_COUNT(plane_index_data);
+  draw.instance_count = 1;
 
-  WGPUBindGroupEntry bind_entries[] = {
-      {
-          .binding = 0,
-          .buffer = uniform_buffer.buffer,
-          .size = sizeof(Uniforms),
-      },
-  };
-
-  WGPUBindGroupLayout bind_group_layout =
-      wgpuRenderPipelineGetBindGroupLayout(bundle.pipeline, 0);
-  WGPUBindGroupDescriptor bind_group_desc = {
-      .label = "Uniform bind group",
-      .layout = bind_group_layout,
-      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(bind_entries),
-      .entries = bind_entries,
-  };
-  bundle.uniform_bind_group =
-      wgpuDeviceCreateBindGroup(engine.device, &bind_group_desc);
-
-  wgpuBindGroupLayoutRelease(bind_group_layout);
   radiant_shader_destroy(shader);
 
-  return bundle;
+  return draw;
 }
 
-static RenderBundle setup_pyramid_bundle(radiant_engine_t engine,
-                                         radiant_resource_manager_t manager,
-                                         radiant_buffer_t uniform_buffer) {
-  RenderBundle bundle;
+static PackedVertex pack_vertex(Vertex v) {
+  return (PackedVertex){
+      .pos = {radiant_pack_f16(v.pos.x), radiant_pack_f16(v.pos.y),
+              radiant_pack_f16(v.pos.z), radiant_pack_f16(1.f)},
+      .colour = {radiant_pack_unorm8(v.colour.r),
+                 radiant_pack_unorm8(v.colour.g),
+                 radiant_pack_unorm8(v.colour.b), 255},
+  };
+}
+
+/// Leaves the bind group to be set each frame.
+static radiant_draw_t setup_pyramid_draw(radiant_engine_t engine,
+                                         const char* shader_source,
+                                         WGPUPipelineLayout layout) {
+  RADIANT_PROFILE_SCOPE("Setup pyramid");
+  radiant_draw_t draw = {
+      .index_format = WGPUIndexFormat_Uint16,
+  };
 
   // Create shader
-  radiant_shader_create_result_t shader_result =
-      radiant_shader_create_from_file(engine, manager, "Passthrough shader",
-                                      "shaders/pass_through.wgsl");
-  if (!shader_result.succeeded) {
-    return (RenderBundle){0};
-  }
-  radiant_shader_t shader = shader_result.shader;
+  radiant_shader_t shader =
+      radiant_shader_create(engine, "Passthrough shader", shader_source);
 
   WGPUVertexAttribute vert_attrs[] = {
       {
-          .format = WGPUVertexFormat_Float32x3,
-          .offset = offsetof(Vertex, pos),
+          .format = (WGPUVertexFormat)radiant_vertex_format_float16x4,
+          .offset = offsetof(PackedVertex, pos),
           .shaderLocation = 0,
       },
       {
-          .format = WGPUVertexFormat_Float32x3,
-          .offset = offsetof(Vertex, colour),
+          .format = (WGPUVertexFormat)radiant_vertex_format_unorm8x4,
+          .offset = offsetof(PackedVertex, colour),
           .shaderLocation = 1,
       },
   };
   WGPUVertexBufferLayout vert_buf_layout[] = {
       {
-          .arrayStride = sizeof(Vertex),
+          .arrayStride = sizeof(PackedVertex),
           .attributeCount = RADIANT_ARRAY_ELEMENT_COUNT(vert_attrs),
           .attributes = vert_attrs,
       },
@@ -311,6 +362,7 @@ static RenderBundle setup_pyramid_bundle(radiant_engine_t engine,
 
   WGPURenderPipelineDescriptor pipeline_desc = {
       .label = "Pyramid Render Pipeline",
+      .layout = layout,
       .primitive =
           {
               .topology = WGPUPrimitiveTopology_TriangleList,
@@ -333,17 +385,21 @@ static RenderBundle setup_pyramid_bundle(radiant_engine_t engine,
           },
   };
 
-  bundle.pipeline =
+  draw.pipeline =
       wgpuDeviceCreateRenderPipeline(engine.device, &pipeline_desc);
 
+  PackedVertex packed[RADIANT_ARRAY_ELEMENT_COUNT(pyramid_vertex_data)];
+  for (uint32_t i = 0; i < RADIANT_ARRAY_ELEMENT_COUNT(packed); ++i) {
+    packed[i] = pack_vertex(pyramid_vertex_data[i]);
+  }
   radiant_buffer_create_request_t vertex_buffer_req = {
       .engine = engine,
       .usage = radiant_buffer_usage_vertex,
       .label = "Pyramid vertex data",
-      .size_in_bytes = sizeof(pyramid_vertex_data),
+      .size_in_bytes = sizeof(packed),
   };
-  bundle.vertex_buffer =
-      radiant_buffer_create_with_data(vertex_buffer_req, pyramid_vertex_data);
+  draw.vertex_buffer =
+      radiant_buffer_create_with_data(vertex_buffer_req, packed);
 
   radiant_buffer_create_request_t index_buffer_req = {
       .engine = engine,
@@ -351,45 +407,125 @@ static RenderBundle setup_pyramid_bundle(radiant_engine_t engine,
       .label = "Pyramid index buffer",
       .size_in_bytes = sizeof(pyramid_index_data),
   };
-  bundle.index_buffer =
+  draw.index_buffer =
       radiant_buffer_create_with_data(index_buffer_req, pyramid_index_data);
-  bundle.index_count = RADIANT_ARRAY_ELEMENT_COUNT(pyramid_index_data);
-  bundle.instance_count = 2;
+  draw.index_count = RADIANT_ARRAY_ELEMENT_COUNT(pyramid_index_data);
+  draw.instance_count = 2;
 
-  WGPUBindGroupEntry bind_entries[] = {
-      {
-          .binding = 0,
-          .buffer = uniform_buffer.buffer,
-          .size = sizeof(Uniforms),
-      },
-  };
+  radiant_shader_destroy(shader);
 
-  WGPUBindGroupLayout bind_group_layout =
-      wgpuRenderPipelineGetBindGroupLayout(bundle.pipeline, 0);
-  WGPUBindGroupDescriptor bind_group_desc = {
-      .label = "Uniform bind group",
-      .layout = bind_group_layout,
-      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(bind_entries),
-      .entries = bind_entries,
+  return draw;
+}
+
+/// Files read while the engine starts
+typedef struct assets_t {
+  radiant_resource_manager_t manager;
+  radiant_resource_read_result_t checker_shader;
+  radiant_resource_read_result_t pass_through_shader;
+  double read_ms;
+} assets_t;
+
+static void read_assets(void* userdata) {
+  RADIANT_PROFILE_SCOPE("Read assets");
+  assets_t* assets = (assets_t*)userdata;
+  radiant_time_t begin = radiant_time();
+  assets->checker_shader =
+      radiant_resource_manager_read(assets->manager, "shaders/checker.wgsl");
+  assets->pass_through_shader = radiant_resource_manager_read(
+      assets->manager, "shaders/pass_through.wgsl");
+  assets->read_ms =
+      radiant_time_diff_to_ms(radiant_time_sub(radiant_time(), begin));
+}
+
+/// The multisampled attachments, sized to match the swapchain
+typedef struct attachments_t {
+  radiant_texture_create_request_t depth_req;
+  radiant_texture_create_request_t render_req;
+  radiant_texture_t depth;
+  radiant_texture_t render;
+  radiant_texture_view_t render_view;
+} attachments_t;
+
+static attachments_t acquire_attachments(radiant_engine_t engine,
+                                         radiant_texture_pool_t* pool,
+                                         radiant_size_t size) {
+  attachments_t attachments = {
+      .depth_req =
+          {
+              .engine = engine,
+              .label = "Depth Texture",
+              .format = WGPUTextureFormat_Depth24Plus,
+              .size = size,
+              .samples = 4,
+          },
+      .render_req =
+          {
+              .engine = engine,
+              .label = "Render Texture",
+              .format = WGPUTextureFormat_BGRA8Unorm,
+              .size = size,
+              .samples = 4,
+          },
   };
-  bundle.uniform_bind_group =
-      wgpuDeviceCreateBindGroup(engine.device, &bind_group_desc);
+  attachments.depth =
+      radiant_texture_pool_acquire(pool, attachments.depth_req);
+  attachments.render =
+      radiant_texture_pool_acquire(pool, attachments.render_req);
+  attachments.render_view = radiant_texture_view_create(attachments.render);
+  return attachments;
+}
 
-  wgpuBindGroupLayoutRelease(bind_group_layout);
-  radiant_shader_destroy(shader);
+static void release_attachments(radiant_texture_pool_t* pool,
+                                attachments_t attachments) {
+  radiant_texture_view_destroy(attachments.render_view);
+  radiant_texture_pool_release(pool, attachments.depth, attachments.depth_req);
+  radiant_texture_pool_release(pool, attachments.render,
+                               attachments.render_req);
+}
 
-  return bundle;
+/// Frees the files of |assets| that were read.
+static void free_assets(assets_t* assets) {
+  if (assets->checker_shader.succeeded) {
+    free(assets->checker_shader.data);
+  }
+  if (assets->pass_through_shader.succeeded) {
+    free(assets->pass_through_shader.data);
+  }
 }
 
-static void render_bundle(WGPURenderPassEncoder pass, RenderBundle b) {
-  wgpuRenderPassEncoderSetPipeline(pass, b.pipeline);
-  wgpuRenderPassEncoderSetBindGroup(pass, 0, b.uniform_bind_group, 0, NULL);
-  wgpuRenderPassEncoderSetVertexBuffer(pass, 0, b.vertex_buffer.buffer, 0,
-                                       WGPU_WHOLE_SIZE);
-  wgpuRenderPassEncoderSetIndexBuffer(
-      pass, b.index_buffer.buffer, WGPUIndexFormat_Uint16, 0, WGPU_WHOLE_SIZE);
-  wgpuRenderPassEncoderDrawIndexed(pass, b.index_count, b.instance_count, 0, 0,
-                                   0);
+/// Waits out the engine startup and the asset reads when the window cannot
+/// be created, so no thread is left running on the way out.
+static void cancel_startup(radiant_engine_startup_t* startup,
+                           radiant_job_future_t assets_future,
+                           assets_t* assets) {
+  radiant_engine_cancel(startup);
+  radiant_job_wait(assets_future);
+  free_assets(assets);
+}
+
+/// Prints where the CPU time went, and writes the recorded scopes as a Chrome
+/// trace to the file RADIANT_TRACE names, if set.
+static void report_profile(void) {
+  radiant_profile_stats_t stats[PROFILE_STATS];
+  uint32_t count = radiant_profile_aggregate(stats, PROFILE_STATS);
+  for (uint32_t i = 0; i < count; ++i) {
+    printf("%-16s %8" PRIu64 " calls %10.1f ms %10.1f ms exclusive\n",
+           stats[i].name, stats[i].calls, stats[i].inclusive_ms,
+           stats[i].exclusive_ms);
+  }
+
+  const char* path = getenv("RADIANT_TRACE");
+  if (!path) {
+    return;
+  }
+  radiant_file_result_t file_result = radiant_file_create(path);
+  if (!file_result.succeeded) {
+    fprintf(stderr, "Failed to create trace %s\n", path);
+    return;
+  }
+  radiant_profile_write_chrome_trace(file_result.file);
+  radiant_file_close(file_result.file);
+  printf("Wrote trace to %s\n", path);
 }
 
 int main() {
@@ -403,7 +539,26 @@ int main() {
   }
   radiant_resource_manager_t manager = manager_result.manager;
 
+  // The device, the window and the shader files are all waited on, so start
+  // them together.
+  // Passes are timed on the GPU where the adapter allows it.
+  radiant_engine_startup_t startup =
+      radiant_engine_start((radiant_adapter_selection_t){
+          .requirements =
+              {
+                  .optional_features = RADIANT_ADAPTER_FEATURE(
+                      WGPUFeatureName_TimestampQuery),
+              },
+      });
+  assets_t assets = {.manager = manager};
+  radiant_job_future_t assets_future = radiant_job_async(read_assets, &assets);
+
+  radiant_time_t window_begin = radiant_time();
+  RADIANT_PROFILE_BEGIN("Create window");
   if (!radiant_windows_initialize()) {
+    RADIANT_PROFILE_END();
+    cancel_startup(&startup, assets_future, &assets);
+    radiant_resource_manager_destroy(manager);
     return 1;
   }
 
@@ -423,20 +578,61 @@ int main() {
 
   radiant_window_create_result_t window_result = radiant_window_create(view);
   if (!window_result.succeeded) {
+    RADIANT_PROFILE_END();
+    cancel_startup(&startup, assets_future, &assets);
+    radiant_windows_shutdown();
+    radiant_resource_manager_destroy(manager);
     return 1;
   }
   radiant_window_t window = window_result.window;
+  RADIANT_PROFILE_END();
+  double window_ms =
+      radiant_time_diff_to_ms(radiant_time_sub(radiant_time(), window_begin));
 
   radiant_engine_create_result_t engine_result =
-      radiant_engine_create(window, view);
-  if (!engine_result.succeeded) {
+      radiant_engine_finish(&startup, window, view);
+  radiant_job_wait(assets_future);
+  if (!engine_result.succeeded || !assets.checker_shader.succeeded ||
+      !assets.pass_through_shader.succeeded) {
+    if (engine_result.succeeded) {
+      radiant_engine_destroy(engine_result.engine);
+    }
+    free_assets(&assets);
+    radiant_window_destroy(window);
+    radiant_windows_shutdown();
+    radiant_resource_manager_destroy(manager);
     return 1;
   }
   radiant_engine_t engine = engine_result.engine;
+  printf(
+      "Startup %.1f ms: adapter %.1f ms, device %.1f ms, window %.1f ms, "
+      "assets %.1f ms, waited %.1f ms, swapchain %.1f ms\n",
+      startup.timings.total_ms, startup.timings.adapter_ms,
+      startup.timings.device_ms, window_ms, assets.read_ms,
+      startup.timings.wait_ms, startup.timings.target_ms);
+  WGPUAdapterProperties adapter_properties = {0};
+  wgpuAdapterGetProperties(engine.adapter, &adapter_properties);
+  printf("Adapter: %s, %s on %s\n", adapter_properties.name,
+         radiant_adapter_type_name(adapter_properties.adapterType),
+         radiant_adapter_backend_name(adapter_properties.backendType));
+
+  // Two frames in flight keep the GPU busy without adding much latency, and
+  // fewer when the GPU falls far enough behind that input would feel late.
+  radiant_pacer_t pacer = radiant_pacer_create((radiant_pacer_create_request_t){
+      .engine = engine,
+      .max_latency_ms = 50.0,
+      .frames_in_flight = 2,
+  });
+
+  radiant_gpu_profiler_t profiler = radiant_gpu_profiler_create(
+      (radiant_gpu_profiler_create_request_t){.engine = engine});
+  if (!radiant_gpu_profiler_available(&profiler)) {
+    printf("No timestamp queries, passes will not be timed\n");
+  }
 
-  // Create Uniform Buffer
+  // Create Uniform Buffers, one per frame in flight so a frame never writes
+  // the uniforms the GPU is still drawing an earlier one with.
   Uniforms uniforms = {
-      .model_view_projection_matrix = radiant_mat4x4_identity(),
       .frame = 0,
       .frame_radians = radiant_deg_to_rad(0),
       .image_width = (uint32_t)view.size.width,
@@ -448,59 +644,130 @@ int main() {
       .label = "Uniform data",
       .size_in_bytes = sizeof(uniforms),
   };
-  radiant_buffer_t uniform_buffer =
-      radiant_buffer_create_with_data(uniform_buffer_req, &uniforms);
-
-  // Setup pipelines
-  RenderBundle pyramid_bundle =
-      setup_pyramid_bundle(engine, manager, uniform_buffer);
-
-  RenderBundle plane_bundle =
-      setup_plane_bundle(engine, manager, uniform_buffer);
-
-  // Create depth texture
-  radiant_texture_create_request_t depth_texture_req = {
-      .engine = engine,
-      .label = "Depth Texture",
-      .format = WGPUTextureFormat_Depth24Plus,
-      .size =
-          {
-              .width = (uint32_t)view.size.width,
-              .height = (uint32_t)view.size.height,
-          },
-      .samples = 4,
+  WGPUBindGroupLayout uniform_layout = create_uniform_layout(engine);
+  WGPUBindGroupLayout mvp_layout =
+      radiant_renderables_mvp_layout_create(engine);
+  WGPUBindGroupLayout bind_group_layouts[] = {
+      [0] = uniform_layout,
+      [RADIANT_RENDERABLES_MVP_GROUP] = mvp_layout,
   };
-  radiant_texture_t depth_texture = radiant_texture_create(depth_texture_req);
-
-  // Create render texture
-  radiant_texture_create_request_t render_texture_req = {
-      .engine = engine,
-      .label = "Render Texture",
-      .format = WGPUTextureFormat_BGRA8Unorm,
-      .size =
-          {
-              .width = (uint32_t)view.size.width,
-              .height = (uint32_t)view.size.height,
-          },
-      .samples = 4,
+  WGPUPipelineLayoutDescriptor pipeline_layout_desc = {
+      .label = "Renderable pipeline layout",
+      .bindGroupLayoutCount = RADIANT_ARRAY_ELEMENT_COUNT(bind_group_layouts),
+      .bindGroupLayouts = bind_group_layouts,
   };
-  radiant_texture_t render_texture = radiant_texture_create(render_texture_req);
+  WGPUPipelineLayout pipeline_layout =
+      wgpuDeviceCreatePipelineLayout(engine.device, &pipeline_layout_desc);
+
+  radiant_buffer_t uniform_buffers[RADIANT_PACER_MAX_FRAMES];
+  WGPUBindGroup uniform_bind_groups[RADIANT_PACER_MAX_FRAMES];
+  // The matrices of the entities drawn, also one per frame in flight.
+  radiant_renderables_batch_t batches[RADIANT_PACER_MAX_FRAMES];
+  for (uint32_t i = 0; i < pacer.frames_in_flight; ++i) {
+    uniform_buffers[i] =
+        radiant_buffer_create_with_data(uniform_buffer_req, &uniforms);
+    uniform_bind_groups[i] =
+        create_uniform_bind_group(engine, uniform_layout, uniform_buffers[i]);
+    batches[i] = radiant_renderables_batch_create(
+        (radiant_renderables_batch_create_request_t){
+            .engine = engine,
+            .layout = mvp_layout,
+        });
+  }
 
-  radiant_texture_view_t render_view =
-      radiant_texture_view_create(render_texture);
+  // Setup renderables
+  radiant_ecs_create_result_t ecs_result = radiant_ecs_create();
+  if (!ecs_result.succeeded) {
+    return 1;
+  }
+  radiant_ecs_t ecs = ecs_result.ecs;
+  radiant_renderables_t renderables = radiant_renderables_register(&ecs);
+  radiant_ecs_signature_t renderable_signature =
+      radiant_renderables_signature(renderables);
+
+  radiant_ecs_entity_t pyramid =
+      radiant_ecs_create_entity(&ecs, renderable_signature);
+  radiant_ecs_entity_t plane =
+      radiant_ecs_create_entity(&ecs, renderable_signature);
+  if (!radiant_ecs_alive(&ecs, pyramid) || !radiant_ecs_alive(&ecs, plane)) {
+    return 1;
+  }
+  *(radiant_draw_t*)radiant_ecs_get(&ecs, pyramid, renderables.draw) =
+      setup_pyramid_draw(engine, assets.pass_through_shader.data,
+                         pipeline_layout);
+  *(radiant_aabb_t*)radiant_ecs_get(&ecs, pyramid, renderables.bounds) =
+      pyramid_bounds;
+  *(radiant_draw_t*)radiant_ecs_get(&ecs, plane, renderables.draw) =
+      setup_plane_draw(engine, assets.checker_shader.data, pipeline_layout);
+  *(radiant_aabb_t*)radiant_ecs_get(&ecs, plane, renderables.bounds) =
+      radiant_aabb_from_points(plane_vertex_data,
+                               RADIANT_ARRAY_ELEMENT_COUNT(plane_vertex_data));
+  *(radiant_mat4x4_t*)radiant_ecs_get(&ecs, plane, renderables.transform) =
+      radiant_mat4x4_identity();
+  free_assets(&assets);
+
+  radiant_draw_t* pyramid_draw =
+      (radiant_draw_t*)radiant_ecs_get(&ecs, pyramid, renderables.draw);
+  radiant_draw_t* plane_draw =
+      (radiant_draw_t*)radiant_ecs_get(&ecs, plane, renderables.draw);
+
+  // Window resizes are applied once the size holds for 100 ms, and the
+  // attachments they replace kept for when the size comes back.
+  radiant_resize_t resize = radiant_resize_create(engine.size, 100.0);
+  radiant_texture_pool_t texture_pool = {0};
+  attachments_t attachments =
+      acquire_attachments(engine, &texture_pool, engine.size);
 
   radiant_camera_t cam = radiant_camera_create(
       (radiant_point3_t){0.f, 0.f, 4.f}, (radiant_point3_t){0.f, 0.f, 0.f},
       (radiant_vec3_t){0.f, 1.f, 0.f}, view);
 
+  radiant_scene_create_result_t scene_result = radiant_scene_create(1);
+  if (!scene_result.succeeded) {
+    return 1;
+  }
+  radiant_scene_t scene = scene_result.scene;
+  uint32_t pyramid_node = radiant_scene_add(&scene, RADIANT_SCENE_NO_NODE,
+                                            radiant_trs_identity());
+
   uint32_t frame = 0;
 
   while (!radiant_window_should_close(window)) {
+    RADIANT_PROFILE_SCOPE("Frame");
+    RADIANT_PROFILE_BEGIN("Poll events");
     radiant_windows_poll_events();
     wgpuInstanceProcessEvents(engine.instance);
+    RADIANT_PROFILE_END();
+
+    radiant_size_t framebuffer_size = radiant_window_framebuffer_size(window);
+    if (radiant_resize_update(&resize, framebuffer_size, radiant_time())) {
+      RADIANT_PROFILE_SCOPE("Resize");
+      radiant_engine_resize(&engine, resize.current);
+      release_attachments(&texture_pool, attachments);
+      attachments = acquire_attachments(engine, &texture_pool, resize.current);
+
+      view.size.width = (float)resize.current.width;
+      view.size.height = (float)resize.current.height;
+      radiant_camera_set_view(&cam, view);
+      uniforms.image_width = resize.current.width;
+      uniforms.image_height = resize.current.height;
+    }
+    // Nothing to draw into while minimized, sleep until the window changes.
+    if (radiant_size_empty(framebuffer_size)) {
+      radiant_windows_wait_events();
+      continue;
+    }
 
     frame += 1;
 
+    // Blocks while the GPU is as far behind as the pacer allows.
+    RADIANT_PROFILE_BEGIN("Pace");
+    uint32_t slot = radiant_pacer_begin_frame(&pacer);
+    RADIANT_PROFILE_END();
+    pyramid_draw->bind_group = uniform_bind_groups[slot];
+    plane_draw->bind_group = uniform_bind_groups[slot];
+    radiant_gpu_profiler_begin_frame(&profiler);
+
     WGPUCommandEncoderDescriptor cmd_desc = {
         .label = "Main encoder",
     };
@@ -508,12 +775,12 @@ int main() {
         wgpuDeviceCreateCommandEncoder(engine.device, &cmd_desc);
 
     {
-      WGPUTextureView backbuffer =
-          wgpuSwapChainGetCurrentTextureView(engine.swapchain);
+      RADIANT_PROFILE_SCOPE("Record");
+      WGPUTextureView backbuffer = radiant_engine_current_view(engine);
 
       WGPURenderPassColorAttachment colour_attach[] = {
           {
-              .view = render_view.view,
+              .view = attachments.render_view.view,
               .resolveTarget = backbuffer,
               .loadOp = WGPULoadOp_Clear,
               .storeOp = WGPUStoreOp_Store,
@@ -528,18 +795,22 @@ int main() {
       };
 
       radiant_texture_view_t depth_view =
-          radiant_texture_view_create(depth_texture);
+          radiant_texture_view_create(attachments.depth);
       WGPURenderPassDepthStencilAttachment depth_attach = {
           .view = depth_view.view,
           .depthClearValue = 1.f,
           .depthLoadOp = WGPULoadOp_Clear,
           .depthStoreOp = WGPUStoreOp_Store,
       };
+      radiant_gpu_profiler_render_writes_t timestamps =
+          radiant_gpu_profiler_render_pass(&profiler, "Render pass");
       WGPURenderPassDescriptor pass_desc = {
           .label = "Render pass",
           .colorAttachmentCount = RADIANT_ARRAY_ELEMENT_COUNT(colour_attach),
           .colorAttachments = colour_attach,
           .depthStencilAttachment = &depth_attach,
+          .timestampWriteCount = timestamps.count,
+          .timestampWrites = timestamps.writes,
       };
 
       WGPURenderPassEncoder pass =
@@ -547,22 +818,32 @@ int main() {
 
       // Update uniforms
       {
+        RADIANT_PROFILE_SCOPE("Update");
         float frame_deg = radiant_deg_to_rad((float)(frame % 360));
         // Rotate camera
-        radiant_camera_rotate(&cam, (radiant_point3_t){0.f, frame_deg, 0.f});
+        radiant_camera_rotate_quat(
+            &cam, radiant_quat_from_axis_angle((radiant_vec3_t){0.f, 1.f, 0.f},
+                                               frame_deg));
 
         // Object rotation
-        radiant_mat4x4_t model_matrix = radiant_mat4x4_translate(
-            (radiant_vec3_t){0.f, sinf(frame_deg), 0.f});
-
+        radiant_trs_t pyramid_local = radiant_trs_identity();
+        pyramid_local.translation.y = radiant_sincos(frame_deg).sin;
+        radiant_scene_set_local(&scene, pyramid_node, pyramid_local);
+        radiant_scene_update(&scene);
+        radiant_mat4x4_t model_matrix = radiant_affine_to_mat4x4(
+            radiant_scene_world(&scene, pyramid_node));
+
+        *(radiant_mat4x4_t*)radiant_ecs_get(&ecs, pyramid,
+                                            renderables.transform) =
+            model_matrix;
+
+        // The model view projection matrices are written by
+        // radiant_renderables_draw, from the transform of each entity.
         uniforms.frame = frame;
         uniforms.frame_radians = frame_deg;
-        uniforms.model_view_projection_matrix =
-            radiant_mat4x4_mul(cam.projection_view_matrix, model_matrix);
-        radiant_buffer_write(uniform_buffer, sizeof(uniforms), &uniforms);
+        radiant_buffer_write(uniform_buffers[slot], sizeof(uniforms),
+                             &uniforms);
       }
-      render_bundle(pass, pyramid_bundle);
-
       // Update uniforms
       {
         // Object rotation
@@ -572,7 +853,10 @@ int main() {
         // radiant_buffer_write(uniform_buffer, sizeof(uniforms), &uniforms);
       }
 
-      render_bundle(pass, plane_bundle);
+      // Draws whatever is in view, the pyramid and then the plane.
+      radiant_renderables_draw(&ecs, renderables, radiant_camera_frustum(&cam),
+                               radiant_camera_projection_view_matrix(&cam),
+                               &batches[slot], pass);
 
       wgpuRenderPassEncoderEnd(pass);
       wgpuRenderPassEncoderRelease(pass);
@@ -580,29 +864,57 @@ int main() {
       radiant_texture_view_destroy(depth_view);
     }
 
+    radiant_gpu_profiler_resolve(&profiler, encoder);
     WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, NULL);
     wgpuCommandEncoderRelease(encoder);
 
+    RADIANT_PROFILE_BEGIN("Submit");
     WGPUQueue queue = wgpuDeviceGetQueue(engine.device);
     wgpuQueueSubmit(queue, 1, &commands);
     wgpuCommandBufferRelease(commands);
-
-    wgpuSwapChainPresent(engine.swapchain);
+    radiant_gpu_profiler_end_frame(&profiler);
+    RADIANT_PROFILE_END();
+
+    RADIANT_PROFILE_BEGIN("Present");
+    radiant_engine_present(engine);
+    radiant_pacer_end_frame(&pacer);
+    RADIANT_PROFILE_END();
+
+    if (frame % 600 == 0) {
+      printf("Frame %u: waited %.2f ms, %u frames queued, latency %.2f ms\n",
+             frame, pacer.stats.wait_ms, pacer.stats.queue_depth,
+             pacer.stats.latency_ms);
+      for (uint32_t i = 0; i < profiler.pass_count; ++i) {
+        printf("  %s: %.3f ms GPU, %.3f ms average\n", profiler.passes[i].name,
+               profiler.passes[i].last_ms, profiler.passes[i].average_ms);
+      }
+    }
   }
+  radiant_pacer_destroy(&pacer);
+  report_profile();
+  radiant_gpu_profiler_destroy(&profiler);
 
-  radiant_texture_view_destroy(render_view);
-  radiant_texture_destroy(render_texture);
-  radiant_texture_destroy(depth_texture);
+  release_attachments(&texture_pool, attachments);
+  radiant_texture_pool_destroy(&texture_pool);
 
-  wgpuRenderPipelineRelease(pyramid_bundle.pipeline);
-  wgpuRenderPipelineRelease(plane_bundle.pipeline);
+  for (uint32_t i = 0; i < pacer.frames_in_flight; ++i) {
+    radiant_renderables_batch_destroy(&batches[i]);
+    wgpuBindGroupRelease(uniform_bind_groups[i]);
+    radiant_buffer_destroy(uniform_buffers[i]);
+  }
+  wgpuRenderPipelineRelease(pyramid_draw->pipeline);
+  wgpuRenderPipelineRelease(plane_draw->pipeline);
+  wgpuPipelineLayoutRelease(pipeline_layout);
+  wgpuBindGroupLayoutRelease(mvp_layout);
+  wgpuBindGroupLayoutRelease(uniform_layout);
 
+  radiant_scene_destroy(scene);
   radiant_camera_destroy(cam);
-  radiant_buffer_destroy(uniform_buffer);
-  radiant_buffer_destroy(plane_bundle.index_buffer);
-  radiant_buffer_destroy(plane_bundle.vertex_buffer);
-  radiant_buffer_destroy(pyramid_bundle.index_buffer);
-  radiant_buffer_destroy(pyramid_bundle.vertex_buffer);
+  radiant_buffer_destroy(plane_draw->index_buffer);
+  radiant_buffer_destroy(plane_draw->vertex_buffer);
+  radiant_buffer_destroy(pyramid_draw->index_buffer);
+  radiant_buffer_destroy(pyramid_draw->vertex_buffer);
+  radiant_ecs_destroy(ecs);
   radiant_engine_destroy(engine);
   radiant_window_destroy(window);
   radiant_windows_shutdown();
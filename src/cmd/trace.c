@@ -0,0 +1,190 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Renders the scene of the radiant target with the CPU path tracer and
+// writes it to a float image, a GPU-free reference for the raster and GPU
+// renderers. Usage: radiant_trace [samples] [output.pfm]
+
+#include "src/array_element_count.h"
+#include "src/camera.h"
+#include "src/colour3.h"
+#include "src/constants.h"
+#include "src/job.h"
+#include "src/point3.h"
+#include "src/time.h"
+#include "src/tracer.h"
+#include "src/view.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Samples added per progressive pass.
+#define PASS_SAMPLES 4
+
+typedef struct Vertex {
+  radiant_point3_t pos;
+  radiant_colour3_t colour;
+} Vertex;
+
+// The two pyramid instances of the radiant target, offset along x as its
+// shader does, over the ground plane. The plane is drawn with a near white
+// checker there, here it is a plain grey.
+static Vertex scene_vertex_data[] = {
+    {.pos = {1.f, .5f, 0.f}, .colour = {1.f, 0.f, 0.f}},
+    {.pos = {1.5f, -.5f, -.5f}, .colour = {0.f, 1.f, 0.f}},
+    {.pos = {.5f, -.5f, -.5f}, .colour = {0.f, 0.f, 1.f}},
+    {.pos = {1.f, -.5f, .5f}, .colour = {1.f, 1.f, 0.f}},
+    {.pos = {-1.f, .5f, 0.f}, .colour = {1.f, 0.f, 0.f}},
+    {.pos = {-.5f, -.5f, -.5f}, .colour = {0.f, 1.f, 0.f}},
+    {.pos = {-1.5f, -.5f, -.5f}, .colour = {0.f, 0.f, 1.f}},
+    {.pos = {-1.f, -.5f, .5f}, .colour = {1.f, 1.f, 0.f}},
+    {.pos = {-50.f, -10.f, -100.f}, .colour = {.95f, .95f, .95f}},
+    {.pos = {50.f, -10.f, -100.f}, .colour = {.95f, .95f, .95f}},
+    {.pos = {-50.f, -10.f, 100.f}, .colour = {.95f, .95f, .95f}},
+    {.pos = {50.f, -10.f, 100.f}, .colour = {.95f, .95f, .95f}},
+};
+
+static uint16_t scene_index_data[] = {
+    // clang-format off
+    // Pyramid one
+    0, 1, 2,
+    0, 3, 1,
+    0, 2, 3,
+    3, 2, 1,
+    // Pyramid two
+    4, 5, 6,
+    4, 7, 5,
+    4, 6, 7,
+    7, 6, 5,
+    // Plane
+    8, 9, 10,
+    9, 11, 10,
+    // clang-format on
+};
+
+/// Writes the RGBA |pixels| to |path| as a little endian PFM, which stores
+/// rows from the bottom up.
+static bool write_pfm(const char* path,
+                      const float* pixels,
+                      uint32_t width,
+                      uint32_t height) {
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  fprintf(file, "PF\n%u %u\n-1.0\n", width, height);
+  float* row = (float*)malloc(3 * width * sizeof(float));
+  bool succeeded = row != NULL;
+  for (uint32_t y = height; succeeded && y-- > 0;) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const float* p = pixels + (4 * ((y * width) + x));
+      row[3 * x] = p[0];
+      row[(3 * x) + 1] = p[1];
+      row[(3 * x) + 2] = p[2];
+    }
+    succeeded = fwrite(row, sizeof(float), 3 * width, file) == 3 * width;
+  }
+  free(row);
+  return fclose(file) == 0 && succeeded;
+}
+
+int main(int argc, char** argv) {
+  uint32_t samples = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 64;
+  const char* output = argc > 2 ? argv[2] : "radiant_trace.pfm";
+
+  radiant_view_t view = {
+      .size =
+          {
+              .width = 1024.f,
+              .height = 768.f,
+          },
+      .fov_y_radians = (2.f * RADIANT_PI) / 5.f,
+      .planes =
+          {
+              .near = 1.f,
+              .far = 100.f,
+          },
+  };
+  radiant_camera_t cam = radiant_camera_create(
+      (radiant_point3_t){0.f, 0.f, 4.f}, (radiant_point3_t){0.f, 0.f, 0.f},
+      (radiant_vec3_t){0.f, 1.f, 0.f}, view);
+
+  radiant_tracer_create_request_t req = {
+      .mesh =
+          {
+              .vertices = scene_vertex_data,
+              .indices = scene_index_data,
+              .vertex_stride = sizeof(Vertex),
+              .vertex_count = RADIANT_ARRAY_ELEMENT_COUNT(scene_vertex_data),
+              .triangle_count =
+                  RADIANT_ARRAY_ELEMENT_COUNT(scene_index_data) / 3,
+              .index_format = radiant_bvh_index_format_uint16,
+          },
+      .colour_offset = offsetof(Vertex, colour),
+      .lighting =
+          {
+              .sky_zenith = {.3f, .45f, .8f},
+              .sky_horizon = {.8f, .85f, .9f},
+              .sun_direction = {.5f, 1.f, .8f},
+              .sun_colour = {2.5f, 2.4f, 2.2f},
+          },
+      .camera = cam,
+      .width = (uint32_t)view.size.width,
+      .height = (uint32_t)view.size.height,
+      .max_bounces = 4,
+  };
+  radiant_tracer_create_result_t result = radiant_tracer_create(req);
+  if (!result.succeeded) {
+    fprintf(stderr, "Failed to create tracer\n");
+    return 1;
+  }
+  radiant_tracer_t tracer = result.tracer;
+
+  printf("Tracing %ux%u, %u samples per pixel on %u threads\n", tracer.width,
+         tracer.height, samples, radiant_job_processor_count());
+  radiant_time_t start = radiant_time();
+  while (tracer.sample_count < samples) {
+    uint32_t pass = samples - tracer.sample_count;
+    radiant_tracer_render(&tracer, pass < PASS_SAMPLES ? pass : PASS_SAMPLES);
+    double ms =
+        radiant_time_diff_to_ms(radiant_time_sub(radiant_time(), start));
+    double rate = (double)tracer.sample_count * tracer.width * tracer.height /
+                  ms / 1e3;
+    printf("\r%u/%u samples, %.2f Msamples/s", tracer.sample_count, samples,
+           rate);
+    fflush(stdout);
+  }
+  printf("\n");
+
+  float* pixels =
+      (float*)malloc((size_t)tracer.width * tracer.height * 4 * sizeof(float));
+  if (!pixels) {
+    fprintf(stderr, "Failed to allocate the image\n");
+    radiant_tracer_destroy(tracer);
+    return 1;
+  }
+  radiant_tracer_resolve(&tracer, pixels);
+  bool written = write_pfm(output, pixels, tracer.width, tracer.height);
+  if (!written) {
+    fprintf(stderr, "Failed to write %s\n", output);
+  } else {
+    printf("Wrote %s\n", output);
+  }
+
+  free(pixels);
+  radiant_tracer_destroy(tracer);
+  radiant_camera_destroy(cam);
+  return written ? 0 : 1;
+}
@@ -0,0 +1,438 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ecs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/assert.h"
+#include "src/job.h"
+
+/// The archetype index of free entity slots.
+static const uint32_t kNoArchetype = UINT32_MAX;
+
+/// Chunks are allocated on cache line boundaries.
+static const uint32_t kChunkAlignment = 64;
+
+/// Grows |*array| of |element_size| elements to hold at least |needed|,
+/// doubling |*capacity|. Returns false, leaving the array untouched, if the
+/// allocation fails.
+static bool grow(void** array,
+                 uint32_t* capacity,
+                 uint32_t needed,
+                 size_t element_size) {
+  if (needed <= *capacity) {
+    return true;
+  }
+  uint32_t new_capacity = *capacity ? *capacity * 2 : 16;
+  while (new_capacity < needed) {
+    new_capacity *= 2;
+  }
+  void* grown = realloc(*array, new_capacity * element_size);
+  if (!grown) {
+    return false;
+  }
+  *array = grown;
+  *capacity = new_capacity;
+  return true;
+}
+
+static uint32_t align_up(uint32_t offset) {
+  return (offset + RADIANT_ECS_COLUMN_ALIGNMENT - 1) &
+         ~(uint32_t)(RADIANT_ECS_COLUMN_ALIGNMENT - 1);
+}
+
+/// Lays out the columns of |archetype| for |rows| entities per chunk. Returns
+/// the bytes used.
+static uint32_t layout(const radiant_ecs_t* ecs,
+                       radiant_ecs_archetype_t* archetype,
+                       uint32_t rows) {
+  uint32_t offset = rows * (uint32_t)sizeof(radiant_ecs_entity_t);
+  for (uint32_t c = 0; c < ecs->component_count; ++c) {
+    if (archetype->signature & RADIANT_ECS_SIGNATURE(c)) {
+      offset = align_up(offset);
+      archetype->offsets[c] = (uint16_t)offset;
+      offset += rows * ecs->component_sizes[c];
+    }
+  }
+  return offset;
+}
+
+/// Returns the index of the archetype for |signature|, creating it if needed,
+/// or kNoArchetype if an allocation fails.
+static uint32_t find_archetype(radiant_ecs_t* ecs,
+                               radiant_ecs_signature_t signature) {
+  for (uint32_t i = 0; i < ecs->archetype_count; ++i) {
+    if (ecs->archetypes[i]->signature == signature) {
+      return i;
+    }
+  }
+
+  if (!grow((void**)&ecs->archetypes, &ecs->archetype_capacity,
+            ecs->archetype_count + 1, sizeof(radiant_ecs_archetype_t*))) {
+    return kNoArchetype;
+  }
+  radiant_ecs_archetype_t* archetype =
+      (radiant_ecs_archetype_t*)calloc(1, sizeof(radiant_ecs_archetype_t));
+  if (!archetype) {
+    return kNoArchetype;
+  }
+  archetype->signature = signature;
+
+  // Start from the rows that fit without alignment gaps and drop rows until
+  // the aligned columns fit too.
+  uint32_t row_bytes = sizeof(radiant_ecs_entity_t);
+  for (uint32_t c = 0; c < ecs->component_count; ++c) {
+    if (signature & RADIANT_ECS_SIGNATURE(c)) {
+      row_bytes += ecs->component_sizes[c];
+    }
+  }
+  uint32_t rows = RADIANT_ECS_CHUNK_SIZE / row_bytes;
+  while (rows > 0 && layout(ecs, archetype, rows) > RADIANT_ECS_CHUNK_SIZE) {
+    --rows;
+  }
+  // radiant_ecs_register keeps every component small enough for a row.
+  RADIANT_ASSERT(rows > 0);
+  archetype->rows_per_chunk = rows;
+
+  ecs->archetypes[ecs->archetype_count] = archetype;
+  return ecs->archetype_count++;
+}
+
+/// Zero fills every column of |row| in |chunk|.
+static void clear_row(const radiant_ecs_t* ecs,
+                      const radiant_ecs_chunk_t* chunk,
+                      uint32_t row) {
+  const radiant_ecs_archetype_t* archetype = chunk->archetype;
+  for (uint32_t c = 0; c < ecs->component_count; ++c) {
+    if (archetype->signature & RADIANT_ECS_SIGNATURE(c)) {
+      uint32_t size = ecs->component_sizes[c];
+      memset(chunk->data + archetype->offsets[c] + (row * size), 0, size);
+    }
+  }
+}
+
+/// Appends |entity| to the last chunk of |archetype|, adding a chunk if it is
+/// full, and points its record there. Returns false if an allocation fails.
+static bool push_row(radiant_ecs_t* ecs,
+                     uint32_t archetype_index,
+                     radiant_ecs_entity_t entity) {
+  radiant_ecs_archetype_t* archetype = ecs->archetypes[archetype_index];
+  uint32_t last = archetype->chunk_count - 1;
+  if (archetype->chunk_count == 0 ||
+      archetype->chunks[last].count == archetype->rows_per_chunk) {
+    if (!grow((void**)&archetype->chunks, &archetype->chunk_capacity,
+              archetype->chunk_count + 1, sizeof(radiant_ecs_chunk_t))) {
+      return false;
+    }
+    uint8_t* data =
+        (uint8_t*)aligned_alloc(kChunkAlignment, RADIANT_ECS_CHUNK_SIZE);
+    if (!data) {
+      return false;
+    }
+    last = archetype->chunk_count++;
+    archetype->chunks[last] = (radiant_ecs_chunk_t){
+        .data = data,
+        .archetype = archetype,
+    };
+  }
+
+  radiant_ecs_chunk_t* chunk = &archetype->chunks[last];
+  uint32_t row = chunk->count++;
+  ((radiant_ecs_entity_t*)chunk->data)[row] = entity;
+  clear_row(ecs, chunk, row);
+  ecs->records[entity.index] = (radiant_ecs_record_t){
+      .archetype = archetype_index,
+      .chunk = last,
+      .row = row,
+      .generation = entity.generation,
+  };
+  return true;
+}
+
+/// Removes the row of the entity at |record| by moving the last entity of
+/// the archetype into it, keeping every chunk but the last full.
+static void remove_row(radiant_ecs_t* ecs, radiant_ecs_record_t record) {
+  radiant_ecs_archetype_t* archetype = ecs->archetypes[record.archetype];
+  radiant_ecs_chunk_t* chunk = &archetype->chunks[record.chunk];
+  radiant_ecs_chunk_t* last = &archetype->chunks[archetype->chunk_count - 1];
+  uint32_t last_row = last->count - 1;
+
+  if (chunk != last || record.row != last_row) {
+    radiant_ecs_entity_t* entities = (radiant_ecs_entity_t*)chunk->data;
+    radiant_ecs_entity_t moved = ((radiant_ecs_entity_t*)last->data)[last_row];
+    entities[record.row] = moved;
+    for (uint32_t c = 0; c < ecs->component_count; ++c) {
+      if (archetype->signature & RADIANT_ECS_SIGNATURE(c)) {
+        uint32_t size = ecs->component_sizes[c];
+        uint32_t offset = archetype->offsets[c];
+        memcpy(chunk->data + offset + (record.row * size),
+               last->data + offset + (last_row * size), size);
+      }
+    }
+    ecs->records[moved.index].chunk = record.chunk;
+    ecs->records[moved.index].row = record.row;
+  }
+
+  if (--last->count == 0) {
+    free(last->data);
+    --archetype->chunk_count;
+  }
+}
+
+radiant_ecs_create_result_t radiant_ecs_create(void) {
+  return (radiant_ecs_create_result_t){
+      .succeeded = true,
+  };
+}
+
+void radiant_ecs_destroy(radiant_ecs_t ecs) {
+  for (uint32_t i = 0; i < ecs.archetype_count; ++i) {
+    radiant_ecs_archetype_t* archetype = ecs.archetypes[i];
+    for (uint32_t c = 0; c < archetype->chunk_count; ++c) {
+      free(archetype->chunks[c].data);
+    }
+    free(archetype->chunks);
+    free(archetype);
+  }
+  free(ecs.archetypes);
+  free(ecs.records);
+  free(ecs.free_indices);
+}
+
+radiant_ecs_component_t radiant_ecs_register(radiant_ecs_t* ecs,
+                                             uint32_t size_in_bytes) {
+  // Leave room for the entity handle and the alignment of every column.
+  uint32_t max_size = RADIANT_ECS_CHUNK_SIZE -
+                      ((RADIANT_ECS_MAX_COMPONENTS + 1) *
+                       (RADIANT_ECS_COLUMN_ALIGNMENT +
+                        (uint32_t)sizeof(radiant_ecs_entity_t)));
+  if (ecs->component_count == RADIANT_ECS_MAX_COMPONENTS ||
+      size_in_bytes == 0 || size_in_bytes > max_size) {
+    return RADIANT_ECS_NO_COMPONENT;
+  }
+  ecs->component_sizes[ecs->component_count] = size_in_bytes;
+  return ecs->component_count++;
+}
+
+radiant_ecs_entity_t radiant_ecs_create_entity(
+    radiant_ecs_t* ecs,
+    radiant_ecs_signature_t signature) {
+  RADIANT_ASSERT(ecs->component_count == RADIANT_ECS_MAX_COMPONENTS ||
+                 signature >> ecs->component_count == 0);
+  radiant_ecs_entity_t entity = {0};
+  uint32_t archetype = find_archetype(ecs, signature);
+  if (archetype == kNoArchetype) {
+    return entity;
+  }
+
+  if (ecs->free_count > 0) {
+    entity.index = ecs->free_indices[--ecs->free_count];
+    entity.generation = ecs->records[entity.index].generation + 1;
+  } else {
+    // Every slot can be free at once.
+    if (!grow((void**)&ecs->records, &ecs->record_capacity,
+              ecs->record_count + 1, sizeof(radiant_ecs_record_t)) ||
+        !grow((void**)&ecs->free_indices, &ecs->free_capacity,
+              ecs->record_count + 1, sizeof(uint32_t))) {
+      return entity;
+    }
+    entity.index = ecs->record_count++;
+    entity.generation = 1;
+  }
+
+  if (!push_row(ecs, archetype, entity)) {
+    ecs->records[entity.index] = (radiant_ecs_record_t){
+        .archetype = kNoArchetype,
+        .generation = entity.generation,
+    };
+    ecs->free_indices[ecs->free_count++] = entity.index;
+    return (radiant_ecs_entity_t){0};
+  }
+  ++ecs->entity_count;
+  return entity;
+}
+
+bool radiant_ecs_alive(const radiant_ecs_t* ecs, radiant_ecs_entity_t entity) {
+  return entity.generation != 0 && entity.index < ecs->record_count &&
+         ecs->records[entity.index].generation == entity.generation &&
+         ecs->records[entity.index].archetype != kNoArchetype;
+}
+
+void radiant_ecs_destroy_entity(radiant_ecs_t* ecs,
+                                radiant_ecs_entity_t entity) {
+  if (!radiant_ecs_alive(ecs, entity)) {
+    return;
+  }
+  remove_row(ecs, ecs->records[entity.index]);
+  ecs->records[entity.index].archetype = kNoArchetype;
+  ecs->free_indices[ecs->free_count++] = entity.index;
+  --ecs->entity_count;
+}
+
+radiant_ecs_signature_t radiant_ecs_signature(const radiant_ecs_t* ecs,
+                                              radiant_ecs_entity_t entity) {
+  if (!radiant_ecs_alive(ecs, entity)) {
+    return 0;
+  }
+  return ecs->archetypes[ecs->records[entity.index].archetype]->signature;
+}
+
+void* radiant_ecs_get(const radiant_ecs_t* ecs,
+                      radiant_ecs_entity_t entity,
+                      radiant_ecs_component_t component) {
+  RADIANT_ASSERT(component < ecs->component_count);
+  if (!radiant_ecs_alive(ecs, entity)) {
+    return NULL;
+  }
+  radiant_ecs_record_t record = ecs->records[entity.index];
+  const radiant_ecs_archetype_t* archetype = ecs->archetypes[record.archetype];
+  if (!(archetype->signature & RADIANT_ECS_SIGNATURE(component))) {
+    return NULL;
+  }
+  return archetype->chunks[record.chunk].data + archetype->offsets[component] +
+         (record.row * ecs->component_sizes[component]);
+}
+
+bool radiant_ecs_set_signature(radiant_ecs_t* ecs,
+                               radiant_ecs_entity_t entity,
+                               radiant_ecs_signature_t signature) {
+  if (!radiant_ecs_alive(ecs, entity)) {
+    return false;
+  }
+  radiant_ecs_record_t from = ecs->records[entity.index];
+  if (ecs->archetypes[from.archetype]->signature == signature) {
+    return true;
+  }
+  uint32_t to = find_archetype(ecs, signature);
+  if (to == kNoArchetype || !push_row(ecs, to, entity)) {
+    ecs->records[entity.index] = from;
+    return false;
+  }
+
+  const radiant_ecs_archetype_t* old_archetype =
+      ecs->archetypes[from.archetype];
+  const radiant_ecs_chunk_t* old_chunk = &old_archetype->chunks[from.chunk];
+  radiant_ecs_signature_t kept = old_archetype->signature & signature;
+  for (uint32_t c = 0; c < ecs->component_count; ++c) {
+    if (kept & RADIANT_ECS_SIGNATURE(c)) {
+      uint32_t size = ecs->component_sizes[c];
+      memcpy(radiant_ecs_get(ecs, entity, c),
+             old_chunk->data + old_archetype->offsets[c] + (from.row * size),
+             size);
+    }
+  }
+  remove_row(ecs, from);
+  return true;
+}
+
+void* radiant_ecs_chunk_column(const radiant_ecs_chunk_t* chunk,
+                               radiant_ecs_component_t component) {
+  RADIANT_ASSERT(component < RADIANT_ECS_MAX_COMPONENTS);
+  RADIANT_ASSERT(chunk->archetype->signature &
+                 RADIANT_ECS_SIGNATURE(component));
+  return chunk->data + chunk->archetype->offsets[component];
+}
+
+const radiant_ecs_entity_t* radiant_ecs_chunk_entities(
+    const radiant_ecs_chunk_t* chunk) {
+  return (const radiant_ecs_entity_t*)chunk->data;
+}
+
+static bool matches(const radiant_ecs_archetype_t* archetype,
+                    radiant_ecs_query_t query) {
+  return (archetype->signature & query.all) == query.all &&
+         (archetype->signature & query.none) == 0;
+}
+
+uint32_t radiant_ecs_query_count(const radiant_ecs_t* ecs,
+                                 radiant_ecs_query_t query) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < ecs->archetype_count; ++i) {
+    const radiant_ecs_archetype_t* archetype = ecs->archetypes[i];
+    if (matches(archetype, query) && archetype->chunk_count > 0) {
+      count += ((archetype->chunk_count - 1) * archetype->rows_per_chunk) +
+               archetype->chunks[archetype->chunk_count - 1].count;
+    }
+  }
+  return count;
+}
+
+void radiant_ecs_query_for_each(const radiant_ecs_t* ecs,
+                                radiant_ecs_query_t query,
+                                radiant_ecs_chunk_fn_t fn,
+                                void* userdata) {
+  for (uint32_t i = 0; i < ecs->archetype_count; ++i) {
+    const radiant_ecs_archetype_t* archetype = ecs->archetypes[i];
+    if (!matches(archetype, query)) {
+      continue;
+    }
+    for (uint32_t c = 0; c < archetype->chunk_count; ++c) {
+      fn(userdata, &archetype->chunks[c]);
+    }
+  }
+}
+
+/// The state shared by the threads of radiant_ecs_query_for_each_parallel.
+typedef struct parallel_query_t {
+  const radiant_ecs_chunk_t** chunks;
+  radiant_ecs_chunk_fn_t fn;
+  void* userdata;
+} parallel_query_t;
+
+static void run_chunk(void* userdata, uint32_t index) {
+  parallel_query_t* query = (parallel_query_t*)userdata;
+  query->fn(query->userdata, query->chunks[index]);
+}
+
+void radiant_ecs_query_for_each_parallel(const radiant_ecs_t* ecs,
+                                         radiant_ecs_query_t query,
+                                         uint32_t thread_count,
+                                         radiant_ecs_chunk_fn_t fn,
+                                         void* userdata) {
+  uint32_t chunk_count = 0;
+  for (uint32_t i = 0; i < ecs->archetype_count; ++i) {
+    if (matches(ecs->archetypes[i], query)) {
+      chunk_count += ecs->archetypes[i]->chunk_count;
+    }
+  }
+  if (chunk_count == 0) {
+    return;
+  }
+
+  const radiant_ecs_chunk_t** chunks = (const radiant_ecs_chunk_t**)malloc(
+      chunk_count * sizeof(radiant_ecs_chunk_t*));
+  if (!chunks) {
+    radiant_ecs_query_for_each(ecs, query, fn, userdata);
+    return;
+  }
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < ecs->archetype_count; ++i) {
+    const radiant_ecs_archetype_t* archetype = ecs->archetypes[i];
+    if (matches(archetype, query)) {
+      for (uint32_t c = 0; c < archetype->chunk_count; ++c) {
+        chunks[n++] = &archetype->chunks[c];
+      }
+    }
+  }
+
+  parallel_query_t state = {
+      .chunks = chunks,
+      .fn = fn,
+      .userdata = userdata,
+  };
+  radiant_job_parallel_for(chunk_count, thread_count, run_chunk, &state);
+  free((void*)chunks);
+}
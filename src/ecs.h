@@ -0,0 +1,230 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/pad.h"
+
+/// The most component types an ECS can register, one bit of a signature each.
+#define RADIANT_ECS_MAX_COMPONENTS 64
+
+/// The bytes of each chunk of entities.
+#define RADIANT_ECS_CHUNK_SIZE (16 * 1024)
+
+/// Every column of a chunk starts at a multiple of this many bytes, enough for
+/// AVX loads. Components must not need a larger alignment.
+#define RADIANT_ECS_COLUMN_ALIGNMENT 32
+
+/// The component returned when registering fails.
+#define RADIANT_ECS_NO_COMPONENT UINT32_MAX
+
+/// Identifies a registered component type.
+typedef uint32_t radiant_ecs_component_t;
+
+/// A set of component types, bit i set for component i.
+typedef uint64_t radiant_ecs_signature_t;
+
+/// Returns the signature holding only |component|.
+#define RADIANT_ECS_SIGNATURE(component) \
+  ((radiant_ecs_signature_t)1 << (component))
+
+/// A handle to an entity. The handle goes stale when the entity is destroyed,
+/// even if its index is reused.
+typedef struct radiant_ecs_entity_t {
+  /// The slot of the entity
+  uint32_t index;
+  /// Bumped each time the slot is reused, zero is never a live entity
+  uint32_t generation;
+} radiant_ecs_entity_t;
+
+/// The entities of one signature, grouped into chunks of
+/// RADIANT_ECS_CHUNK_SIZE bytes. Within a chunk each component is a
+/// contiguous column with one element per entity.
+typedef struct radiant_ecs_archetype_t radiant_ecs_archetype_t;
+
+/// Up to |archetype->rows_per_chunk| entities sharing an archetype.
+typedef struct radiant_ecs_chunk_t {
+  /// The columns, RADIANT_ECS_CHUNK_SIZE bytes. The entity handles come
+  /// first, then each component in the order they were registered.
+  uint8_t* data;
+  /// The archetype the chunk belongs to
+  const radiant_ecs_archetype_t* archetype;
+  /// The number of entities in the chunk
+  uint32_t count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_ecs_chunk_t;
+
+struct radiant_ecs_archetype_t {
+  /// The components of every entity in the archetype
+  radiant_ecs_signature_t signature;
+  /// The chunks, all full but the last
+  radiant_ecs_chunk_t* chunks;
+  /// The number of chunks
+  uint32_t chunk_count;
+  /// The number of chunks |chunks| has room for
+  uint32_t chunk_capacity;
+  /// The entities each chunk holds
+  uint32_t rows_per_chunk;
+  /// The byte offset of each component's column in a chunk, only valid for
+  /// the components in |signature|
+  uint16_t offsets[RADIANT_ECS_MAX_COMPONENTS];
+  /// Unused padding
+  RADIANT_PAD(4);
+};
+
+/// @private
+/// Where an entity is stored.
+typedef struct radiant_ecs_record_t {
+  /// Index into the archetypes of the ECS
+  uint32_t archetype;
+  /// Index into the chunks of the archetype
+  uint32_t chunk;
+  /// The entity's row in the chunk
+  uint32_t row;
+  /// The generation of the live entity, or of the last one if the slot is
+  /// free
+  uint32_t generation;
+} radiant_ecs_record_t;
+
+/// An archetype entity component system. Entities with the same components
+/// share an archetype and are stored densely, so queries iterate whole chunks
+/// linearly.
+///
+/// Note: not thread safe. Queries may run over several threads but must not
+/// create, destroy or change the components of entities.
+typedef struct radiant_ecs_t {
+  /// The size in bytes of each registered component
+  uint32_t component_sizes[RADIANT_ECS_MAX_COMPONENTS];
+  /// The number of registered components
+  uint32_t component_count;
+  /// The number of archetypes
+  uint32_t archetype_count;
+  /// The archetypes, allocated one by one so chunks can point at them
+  radiant_ecs_archetype_t** archetypes;
+  /// The number of archetypes |archetypes| has room for
+  uint32_t archetype_capacity;
+  /// The number of entity slots used, live or free
+  uint32_t record_count;
+  /// Where each entity is stored, indexed by radiant_ecs_entity_t::index
+  radiant_ecs_record_t* records;
+  /// The number of slots |records| has room for
+  uint32_t record_capacity;
+  /// The number of free slots
+  uint32_t free_count;
+  /// The free slots, reused last in first out
+  uint32_t* free_indices;
+  /// The number of live entities
+  uint32_t entity_count;
+  /// The number of slots |free_indices| has room for
+  uint32_t free_capacity;
+} radiant_ecs_t;
+
+/// Results of creating an ECS
+typedef struct radiant_ecs_create_result_t {
+  /// The ECS. Only valid if |succeeded| is true.
+  radiant_ecs_t ecs;
+  /// True if the ECS was successfully created. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_ecs_create_result_t;
+
+/// Creates an ECS without components or entities.
+radiant_ecs_create_result_t radiant_ecs_create(void);
+
+/// Destroys |ecs| and every entity in it.
+void radiant_ecs_destroy(radiant_ecs_t ecs);
+
+/// Registers a component type of |size_in_bytes|. Returns the new component,
+/// or RADIANT_ECS_NO_COMPONENT if RADIANT_ECS_MAX_COMPONENTS are registered or
+/// the size is zero or too large to fit a chunk.
+radiant_ecs_component_t radiant_ecs_register(radiant_ecs_t* ecs,
+                                             uint32_t size_in_bytes);
+
+/// Creates an entity with the components in |signature|, zero filled. Returns
+/// an entity with a zero generation if an allocation fails.
+radiant_ecs_entity_t radiant_ecs_create_entity(
+    radiant_ecs_t* ecs,
+    radiant_ecs_signature_t signature);
+
+/// Destroys |entity|. Does nothing if it is not alive.
+void radiant_ecs_destroy_entity(radiant_ecs_t* ecs,
+                                radiant_ecs_entity_t entity);
+
+/// Returns true if |entity| has been created and not destroyed.
+bool radiant_ecs_alive(const radiant_ecs_t* ecs, radiant_ecs_entity_t entity);
+
+/// Returns the components of |entity|, zero if it is not alive.
+radiant_ecs_signature_t radiant_ecs_signature(const radiant_ecs_t* ecs,
+                                              radiant_ecs_entity_t entity);
+
+/// Returns the |component| of |entity|, or NULL if the entity is not alive or
+/// does not have the component. The pointer is valid until entities are
+/// next created, destroyed or change components.
+void* radiant_ecs_get(const radiant_ecs_t* ecs,
+                      radiant_ecs_entity_t entity,
+                      radiant_ecs_component_t component);
+
+/// Changes the components of |entity| to |signature|, moving it to that
+/// archetype. Components it keeps are copied, new ones are zero filled.
+/// Returns false if the entity is not alive or an allocation fails.
+bool radiant_ecs_set_signature(radiant_ecs_t* ecs,
+                               radiant_ecs_entity_t entity,
+                               radiant_ecs_signature_t signature);
+
+/// Returns the column of |component| in |chunk|, |chunk->count| elements. The
+/// archetype of the chunk must have the component.
+void* radiant_ecs_chunk_column(const radiant_ecs_chunk_t* chunk,
+                               radiant_ecs_component_t component);
+
+/// Returns the entity handles of |chunk|, |chunk->count| of them.
+const radiant_ecs_entity_t* radiant_ecs_chunk_entities(
+    const radiant_ecs_chunk_t* chunk);
+
+/// Selects the archetypes with every component of |all| and none of |none|.
+typedef struct radiant_ecs_query_t {
+  /// Components the entities must have
+  radiant_ecs_signature_t all;
+  /// Components the entities must not have
+  radiant_ecs_signature_t none;
+} radiant_ecs_query_t;
+
+/// The function run for each chunk matching a query. |userdata| is passed
+/// through unchanged.
+typedef void (*radiant_ecs_chunk_fn_t)(void* userdata,
+                                       const radiant_ecs_chunk_t* chunk);
+
+/// Returns the number of entities matching |query|.
+uint32_t radiant_ecs_query_count(const radiant_ecs_t* ecs,
+                                 radiant_ecs_query_t query);
+
+/// Calls |fn| for each non-empty chunk matching |query|, in archetype order.
+void radiant_ecs_query_for_each(const radiant_ecs_t* ecs,
+                                radiant_ecs_query_t query,
+                                radiant_ecs_chunk_fn_t fn,
+                                void* userdata);
+
+/// Calls |fn| for each non-empty chunk matching |query| spread over
+/// |thread_count| threads as radiant_job_parallel_for does. Chunks never
+/// share entities so |fn| may write to any column of its chunk. Falls back
+/// to the calling thread if an allocation fails.
+void radiant_ecs_query_for_each_parallel(const radiant_ecs_t* ecs,
+                                         radiant_ecs_query_t query,
+                                         uint32_t thread_count,
+                                         radiant_ecs_chunk_fn_t fn,
+                                         void* userdata);
@@ -0,0 +1,132 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Moves entities by their velocity through an ECS query, on one thread and
+// spread over every processor, against the same update over an array of
+// structs holding every component.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/bounds.h"
+#include "src/ecs.h"
+#include "src/job.h"
+#include "src/mat4x4.h"
+
+static const uint32_t kCount = 1 << 17;
+static const uint32_t kIterations = 100;
+
+/// An entity as one struct, as a renderable was stored before the ECS.
+typedef struct object_t {
+  radiant_mat4x4_t transform;
+  radiant_aabb_t bounds;
+  radiant_vec3_t velocity;
+} object_t;
+
+typedef struct bench_data_t {
+  radiant_ecs_t ecs;
+  object_t* objects;
+  radiant_ecs_component_t transform;
+  radiant_ecs_component_t bounds;
+  radiant_ecs_component_t velocity;
+  /// Unused padding
+  RADIANT_PAD(4);
+} bench_data_t;
+
+static void move(radiant_mat4x4_t* transform, radiant_vec3_t velocity) {
+  transform->data[12] += velocity.x;
+  transform->data[13] += velocity.y;
+  transform->data[14] += velocity.z;
+}
+
+static void array_of_structs(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    move(&data->objects[i].transform, data->objects[i].velocity);
+  }
+}
+
+static void move_chunk(void* userdata, const radiant_ecs_chunk_t* chunk) {
+  const bench_data_t* data = (const bench_data_t*)userdata;
+  radiant_mat4x4_t* transforms =
+      (radiant_mat4x4_t*)radiant_ecs_chunk_column(chunk, data->transform);
+  const radiant_vec3_t* velocities = (const radiant_vec3_t*)
+      radiant_ecs_chunk_column(chunk, data->velocity);
+  for (uint32_t i = 0; i < chunk->count; ++i) {
+    move(&transforms[i], velocities[i]);
+  }
+}
+
+static radiant_ecs_query_t moving(const bench_data_t* data) {
+  return (radiant_ecs_query_t){
+      .all = RADIANT_ECS_SIGNATURE(data->transform) |
+             RADIANT_ECS_SIGNATURE(data->velocity),
+  };
+}
+
+static void query(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_ecs_query_for_each(&data->ecs, moving(data), move_chunk, data);
+}
+
+static void query_parallel(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_ecs_query_for_each_parallel(&data->ecs, moving(data), 0, move_chunk,
+                                      data);
+}
+
+int main() {
+  bench_data_t data = {
+      .ecs = radiant_ecs_create().ecs,
+      .objects = (object_t*)calloc(kCount, sizeof(object_t)),
+  };
+  if (!data.objects) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+  data.transform = radiant_ecs_register(&data.ecs, sizeof(radiant_mat4x4_t));
+  data.bounds = radiant_ecs_register(&data.ecs, sizeof(radiant_aabb_t));
+  data.velocity = radiant_ecs_register(&data.ecs, sizeof(radiant_vec3_t));
+
+  radiant_ecs_signature_t signature = RADIANT_ECS_SIGNATURE(data.transform) |
+                                      RADIANT_ECS_SIGNATURE(data.bounds) |
+                                      RADIANT_ECS_SIGNATURE(data.velocity);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_vec3_t velocity = {(float)(i % 3), 1.f, -(float)(i % 5)};
+    data.objects[i].transform = radiant_mat4x4_identity();
+    data.objects[i].velocity = velocity;
+
+    radiant_ecs_entity_t e = radiant_ecs_create_entity(&data.ecs, signature);
+    if (!radiant_ecs_alive(&data.ecs, e)) {
+      printf("Allocation failed\n");
+      return 1;
+    }
+    *(radiant_mat4x4_t*)radiant_ecs_get(&data.ecs, e, data.transform) =
+        radiant_mat4x4_identity();
+    *(radiant_vec3_t*)radiant_ecs_get(&data.ecs, e, data.velocity) = velocity;
+  }
+
+  printf("Moving %u entities, %u threads\n", kCount,
+         radiant_job_processor_count());
+  radiant_bench_run("array of structs", array_of_structs, &data, kIterations,
+                    kCount);
+  radiant_bench_run("query", query, &data, kIterations, kCount);
+  radiant_bench_run("query parallel", query_parallel, &data, kIterations,
+                    kCount);
+
+  free(data.objects);
+  radiant_ecs_destroy(data.ecs);
+  return 0;
+}
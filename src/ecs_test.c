@@ -0,0 +1,265 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ecs.h"
+
+#include <stdatomic.h>
+
+#include "src/bounds.h"
+#include "src/mat4x4.h"
+#include "src/test.h"
+
+typedef struct test_world_t {
+  radiant_ecs_t ecs;
+  radiant_ecs_component_t transform;
+  radiant_ecs_component_t bounds;
+  radiant_ecs_component_t id;
+  /// Unused padding
+  RADIANT_PAD(4);
+} test_world_t;
+
+static test_world_t world_create(void) {
+  test_world_t world = {.ecs = radiant_ecs_create().ecs};
+  world.transform =
+      radiant_ecs_register(&world.ecs, sizeof(radiant_mat4x4_t));
+  world.bounds = radiant_ecs_register(&world.ecs, sizeof(radiant_aabb_t));
+  world.id = radiant_ecs_register(&world.ecs, sizeof(uint32_t));
+  return world;
+}
+
+static bool register_components() {
+  radiant_ecs_t ecs = radiant_ecs_create().ecs;
+  RADIANT_EXPECT_EQ(radiant_ecs_register(&ecs, 0), RADIANT_ECS_NO_COMPONENT);
+  RADIANT_EXPECT_EQ(radiant_ecs_register(&ecs, RADIANT_ECS_CHUNK_SIZE),
+                    RADIANT_ECS_NO_COMPONENT);
+  for (uint32_t i = 0; i < RADIANT_ECS_MAX_COMPONENTS; ++i) {
+    RADIANT_EXPECT_EQ(radiant_ecs_register(&ecs, 4), i);
+  }
+  RADIANT_EXPECT_EQ(radiant_ecs_register(&ecs, 4), RADIANT_ECS_NO_COMPONENT);
+
+  // Every component at once still fits a chunk.
+  radiant_ecs_entity_t e = radiant_ecs_create_entity(&ecs, UINT64_MAX);
+  RADIANT_EXPECT_TRUE(radiant_ecs_alive(&ecs, e));
+  RADIANT_EXPECT_NOT_NULL(radiant_ecs_get(&ecs, e, 63));
+  radiant_ecs_destroy(ecs);
+  return true;
+}
+
+static bool create_and_get() {
+  test_world_t w = world_create();
+  radiant_ecs_signature_t signature =
+      RADIANT_ECS_SIGNATURE(w.transform) | RADIANT_ECS_SIGNATURE(w.id);
+  radiant_ecs_entity_t e = radiant_ecs_create_entity(&w.ecs, signature);
+  RADIANT_EXPECT_TRUE(radiant_ecs_alive(&w.ecs, e));
+  RADIANT_EXPECT_TRUE(radiant_ecs_signature(&w.ecs, e) == signature);
+  RADIANT_EXPECT_EQ(w.ecs.entity_count, 1u);
+
+  uint32_t* id = (uint32_t*)radiant_ecs_get(&w.ecs, e, w.id);
+  RADIANT_EXPECT_NOT_NULL(id);
+  RADIANT_EXPECT_EQ(*id, 0u);
+  *id = 42;
+  RADIANT_EXPECT_EQ(*(uint32_t*)radiant_ecs_get(&w.ecs, e, w.id), 42u);
+  RADIANT_EXPECT_NULL(radiant_ecs_get(&w.ecs, e, w.bounds));
+
+  radiant_mat4x4_t* transform =
+      (radiant_mat4x4_t*)radiant_ecs_get(&w.ecs, e, w.transform);
+  uint32_t misalignment =
+      (uint32_t)((uintptr_t)transform % RADIANT_ECS_COLUMN_ALIGNMENT);
+  RADIANT_EXPECT_EQ(misalignment, 0u);
+  radiant_ecs_destroy(w.ecs);
+  return true;
+}
+
+static bool destroy_and_reuse() {
+  test_world_t w = world_create();
+  radiant_ecs_signature_t signature = RADIANT_ECS_SIGNATURE(w.id);
+  radiant_ecs_entity_t a = radiant_ecs_create_entity(&w.ecs, signature);
+  radiant_ecs_entity_t b = radiant_ecs_create_entity(&w.ecs, signature);
+  *(uint32_t*)radiant_ecs_get(&w.ecs, b, w.id) = 7;
+
+  radiant_ecs_destroy_entity(&w.ecs, a);
+  RADIANT_EXPECT_FALSE(radiant_ecs_alive(&w.ecs, a));
+  RADIANT_EXPECT_NULL(radiant_ecs_get(&w.ecs, a, w.id));
+  RADIANT_EXPECT_TRUE(radiant_ecs_signature(&w.ecs, a) == 0);
+  // b moved into a's row and kept its data.
+  RADIANT_EXPECT_EQ(*(uint32_t*)radiant_ecs_get(&w.ecs, b, w.id), 7u);
+  RADIANT_EXPECT_EQ(w.ecs.entity_count, 1u);
+
+  // The slot is reused, the stale handle stays dead.
+  radiant_ecs_entity_t c = radiant_ecs_create_entity(&w.ecs, signature);
+  RADIANT_EXPECT_EQ(c.index, a.index);
+  RADIANT_EXPECT_TRUE(c.generation != a.generation);
+  RADIANT_EXPECT_FALSE(radiant_ecs_alive(&w.ecs, a));
+  RADIANT_EXPECT_TRUE(radiant_ecs_alive(&w.ecs, c));
+  RADIANT_EXPECT_EQ(*(uint32_t*)radiant_ecs_get(&w.ecs, c, w.id), 0u);
+
+  radiant_ecs_destroy_entity(&w.ecs, a);
+  RADIANT_EXPECT_EQ(w.ecs.entity_count, 2u);
+  RADIANT_EXPECT_FALSE(
+      radiant_ecs_alive(&w.ecs, (radiant_ecs_entity_t){0, 0}));
+  radiant_ecs_destroy(w.ecs);
+  return true;
+}
+
+#define MANY 2000
+
+static bool chunks() {
+  test_world_t w = world_create();
+  radiant_ecs_signature_t signature =
+      RADIANT_ECS_SIGNATURE(w.transform) | RADIANT_ECS_SIGNATURE(w.id);
+  radiant_ecs_entity_t entities[MANY];
+  for (uint32_t i = 0; i < MANY; ++i) {
+    entities[i] = radiant_ecs_create_entity(&w.ecs, signature);
+    *(uint32_t*)radiant_ecs_get(&w.ecs, entities[i], w.id) = i;
+  }
+
+  const radiant_ecs_archetype_t* archetype = w.ecs.archetypes[0];
+  // 64 bytes of matrix, 4 of id and 8 of handle per entity.
+  RADIANT_EXPECT_TRUE(archetype->rows_per_chunk > 200);
+  RADIANT_EXPECT_TRUE(archetype->rows_per_chunk <=
+                      RADIANT_ECS_CHUNK_SIZE / (64 + 4 + 8));
+  RADIANT_EXPECT_EQ(archetype->chunk_count,
+                    (MANY + archetype->rows_per_chunk - 1) /
+                        archetype->rows_per_chunk);
+
+  // Remove every other entity, the rest keep their data and the chunks stay
+  // dense.
+  for (uint32_t i = 0; i < MANY; i += 2) {
+    radiant_ecs_destroy_entity(&w.ecs, entities[i]);
+  }
+  for (uint32_t i = 1; i < MANY; i += 2) {
+    RADIANT_EXPECT_EQ(*(uint32_t*)radiant_ecs_get(&w.ecs, entities[i], w.id),
+                      i);
+  }
+  RADIANT_EXPECT_EQ(archetype->chunk_count,
+                    ((MANY / 2) + archetype->rows_per_chunk - 1) /
+                        archetype->rows_per_chunk);
+  for (uint32_t c = 0; c + 1 < archetype->chunk_count; ++c) {
+    RADIANT_EXPECT_EQ(archetype->chunks[c].count, archetype->rows_per_chunk);
+  }
+  radiant_ecs_destroy(w.ecs);
+  return true;
+}
+
+static bool set_signature() {
+  test_world_t w = world_create();
+  radiant_ecs_entity_t e =
+      radiant_ecs_create_entity(&w.ecs, RADIANT_ECS_SIGNATURE(w.id));
+  radiant_ecs_entity_t other =
+      radiant_ecs_create_entity(&w.ecs, RADIANT_ECS_SIGNATURE(w.id));
+  *(uint32_t*)radiant_ecs_get(&w.ecs, e, w.id) = 5;
+  *(uint32_t*)radiant_ecs_get(&w.ecs, other, w.id) = 6;
+
+  radiant_ecs_signature_t grown =
+      RADIANT_ECS_SIGNATURE(w.id) | RADIANT_ECS_SIGNATURE(w.bounds);
+  RADIANT_EXPECT_TRUE(radiant_ecs_set_signature(&w.ecs, e, grown));
+  RADIANT_EXPECT_TRUE(radiant_ecs_signature(&w.ecs, e) == grown);
+  RADIANT_EXPECT_EQ(*(uint32_t*)radiant_ecs_get(&w.ecs, e, w.id), 5u);
+  radiant_aabb_t* bounds =
+      (radiant_aabb_t*)radiant_ecs_get(&w.ecs, e, w.bounds);
+  RADIANT_EXPECT_NOT_NULL(bounds);
+  RADIANT_EXPECT_FLOAT_EQ(bounds->max.x, 0.f);
+  RADIANT_EXPECT_EQ(*(uint32_t*)radiant_ecs_get(&w.ecs, other, w.id), 6u);
+
+  RADIANT_EXPECT_TRUE(
+      radiant_ecs_set_signature(&w.ecs, e, RADIANT_ECS_SIGNATURE(w.bounds)));
+  RADIANT_EXPECT_NULL(radiant_ecs_get(&w.ecs, e, w.id));
+  RADIANT_EXPECT_EQ(w.ecs.entity_count, 2u);
+
+  radiant_ecs_destroy_entity(&w.ecs, e);
+  RADIANT_EXPECT_FALSE(radiant_ecs_set_signature(&w.ecs, e, grown));
+  radiant_ecs_destroy(w.ecs);
+  return true;
+}
+
+typedef struct sum_t {
+  radiant_ecs_component_t id;
+  /// Unused padding
+  RADIANT_PAD(4);
+  atomic_uint_fast64_t sum;
+  atomic_uint_fast32_t chunks;
+} sum_t;
+
+static void add_ids(void* userdata, const radiant_ecs_chunk_t* chunk) {
+  sum_t* sum = (sum_t*)userdata;
+  const uint32_t* ids =
+      (const uint32_t*)radiant_ecs_chunk_column(chunk, sum->id);
+  const radiant_ecs_entity_t* entities = radiant_ecs_chunk_entities(chunk);
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < chunk->count; ++i) {
+    total += ids[i] + (entities[i].generation - 1);
+  }
+  atomic_fetch_add(&sum->sum, total);
+  atomic_fetch_add(&sum->chunks, 1);
+}
+
+static bool queries() {
+  test_world_t w = world_create();
+  radiant_ecs_signature_t id = RADIANT_ECS_SIGNATURE(w.id);
+  radiant_ecs_signature_t with_bounds = id | RADIANT_ECS_SIGNATURE(w.bounds);
+  uint64_t expected_all = 0;
+  uint64_t expected_bounds = 0;
+  for (uint32_t i = 0; i < MANY; ++i) {
+    bool bounded = i % 3 == 0;
+    radiant_ecs_entity_t e =
+        radiant_ecs_create_entity(&w.ecs, bounded ? with_bounds : id);
+    *(uint32_t*)radiant_ecs_get(&w.ecs, e, w.id) = i;
+    expected_all += i;
+    expected_bounds += bounded ? i : 0;
+  }
+  radiant_ecs_create_entity(&w.ecs, RADIANT_ECS_SIGNATURE(w.transform));
+
+  radiant_ecs_query_t all = {.all = id};
+  radiant_ecs_query_t bounded = {.all = with_bounds};
+  radiant_ecs_query_t unbounded = {
+      .all = id,
+      .none = RADIANT_ECS_SIGNATURE(w.bounds),
+  };
+  RADIANT_EXPECT_EQ(radiant_ecs_query_count(&w.ecs, all), (uint32_t)MANY);
+  RADIANT_EXPECT_EQ(radiant_ecs_query_count(&w.ecs, bounded),
+                    (uint32_t)(MANY + 2) / 3);
+  RADIANT_EXPECT_EQ(radiant_ecs_query_count(&w.ecs, unbounded),
+                    (uint32_t)MANY - ((MANY + 2) / 3));
+  RADIANT_EXPECT_EQ(radiant_ecs_query_count(&w.ecs, (radiant_ecs_query_t){0}),
+                    (uint32_t)MANY + 1);
+
+  sum_t sum = {.id = w.id};
+  radiant_ecs_query_for_each(&w.ecs, all, add_ids, &sum);
+  RADIANT_EXPECT_TRUE(atomic_load(&sum.sum) == expected_all);
+
+  sum_t serial = {.id = w.id};
+  radiant_ecs_query_for_each(&w.ecs, bounded, add_ids, &serial);
+  RADIANT_EXPECT_TRUE(atomic_load(&serial.sum) == expected_bounds);
+  for (uint32_t threads = 1; threads <= 4; ++threads) {
+    sum_t parallel = {.id = w.id};
+    radiant_ecs_query_for_each_parallel(&w.ecs, bounded, threads, add_ids,
+                                        &parallel);
+    RADIANT_EXPECT_TRUE(atomic_load(&parallel.sum) == expected_bounds);
+    RADIANT_EXPECT_EQ((uint32_t)atomic_load(&parallel.chunks),
+                      (uint32_t)atomic_load(&serial.chunks));
+  }
+  radiant_ecs_destroy(w.ecs);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("ecs");
+  RADIANT_TEST(register_components);
+  RADIANT_TEST(create_and_get);
+  RADIANT_TEST(destroy_and_reuse);
+  RADIANT_TEST(chunks);
+  RADIANT_TEST(set_signature);
+  RADIANT_TEST(queries);
+  return radiant_suite_end();
+}
@@ -13,10 +13,16 @@
 // limitations under the License.
 
 #include "src/engine.h"
+#include "src/array_element_count.h"
+#include "src/assert.h"
 #include "src/glfw.h"
 #include "src/no_return.h"
+#include "src/profile.h"
+#include "src/time.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #if defined(__APPLE__)
 #include "src/surface_metal.h"
@@ -135,64 +141,453 @@ static radiant_surface_descriptor_t create_surface_descriptor(
 #endif
 }
 
-radiant_engine_create_result_t radiant_engine_create(radiant_window_t window,
-                                                     radiant_view_t view) {
-  radiant_engine_create_result_t result = {
-      .engine = {0},
-      .succeeded = true,
+/// Feature bits a radiant_adapter_features_t has room for
+#define MAX_FEATURES 64
+
+/// Backends radiant_engine_enumerate_adapters requests adapters from
+static const WGPUBackendType kBackends[] = {
+    WGPUBackendType_D3D12,  WGPUBackendType_Metal,  WGPUBackendType_Vulkan,
+    WGPUBackendType_D3D11,  WGPUBackendType_OpenGL, WGPUBackendType_OpenGLES,
+    WGPUBackendType_Null,
+};
+
+/// Power preferences radiant_engine_enumerate_adapters requests adapters with
+static const WGPUPowerPreference kPowerPreferences[] = {
+    WGPUPowerPreference_HighPerformance,
+    WGPUPowerPreference_LowPower,
+};
+
+/// Callback storing the adapter, if any, into the WGPUAdapter at |userdata|
+static void adapter_enumerate_callback(WGPURequestAdapterStatus status,
+                                       WGPUAdapter adapter,
+                                       char const* /* message */,
+                                       void* userdata) {
+  if (status == WGPURequestAdapterStatus_Success) {
+    *(WGPUAdapter*)userdata = adapter;
+  }
+}
+
+/// Returns true if |a| and |b| describe the same physical adapter.
+static bool same_adapter(const WGPUAdapterProperties* a,
+                         const WGPUAdapterProperties* b) {
+  return a->backendType == b->backendType &&
+         a->adapterType == b->adapterType && a->vendorID == b->vendorID &&
+         a->deviceID == b->deviceID &&
+         strcmp(a->name ? a->name : "", b->name ? b->name : "") == 0;
+}
+
+radiant_engine_adapters_t radiant_engine_enumerate_adapters(
+    WGPUInstance instance) {
+  enum {
+    kMaxAdapters = RADIANT_ARRAY_ELEMENT_COUNT(kBackends) * 2 *
+                   RADIANT_ARRAY_ELEMENT_COUNT(kPowerPreferences),
   };
-  radiant_engine_t* engine = &result.engine;
+  radiant_engine_adapters_t adapters = {
+      .infos = (radiant_adapter_info_t*)calloc(kMaxAdapters,
+                                               sizeof(radiant_adapter_info_t)),
+  };
+  if (!adapters.infos) {
+    return adapters;
+  }
+
+  for (uint32_t b = 0; b < RADIANT_ARRAY_ELEMENT_COUNT(kBackends); ++b) {
+    for (uint32_t fallback = 0; fallback < 2; ++fallback) {
+      for (uint32_t p = 0; p < RADIANT_ARRAY_ELEMENT_COUNT(kPowerPreferences);
+           ++p) {
+        WGPURequestAdapterOptions options = {
+            .powerPreference = kPowerPreferences[p],
+            .backendType = kBackends[b],
+            .forceFallbackAdapter = fallback != 0,
+        };
+        WGPUAdapter adapter = NULL;
+        wgpuInstanceRequestAdapter(instance, &options,
+                                   adapter_enumerate_callback, &adapter);
+        if (!adapter) {
+          continue;
+        }
+
+        radiant_adapter_info_t* info = &adapters.infos[adapters.count];
+        info->adapter = adapter;
+        wgpuAdapterGetProperties(adapter, &info->properties);
+        bool duplicate = false;
+        for (uint32_t i = 0; i < adapters.count; ++i) {
+          duplicate = duplicate || same_adapter(&adapters.infos[i].properties,
+                                                &info->properties);
+        }
+        if (duplicate) {
+          wgpuAdapterRelease(adapter);
+          *info = (radiant_adapter_info_t){0};
+          continue;
+        }
+
+        wgpuAdapterGetLimits(adapter, &info->limits);
+        size_t feature_count = wgpuAdapterEnumerateFeatures(adapter, NULL);
+        info->features =
+            (WGPUFeatureName*)malloc(feature_count * sizeof(WGPUFeatureName));
+        if (info->features) {
+          wgpuAdapterEnumerateFeatures(adapter, info->features);
+          info->feature_count = (uint32_t)feature_count;
+        }
+        ++adapters.count;
+      }
+    }
+  }
+  return adapters;
+}
+
+void radiant_engine_adapters_destroy(radiant_engine_adapters_t adapters) {
+  for (uint32_t i = 0; i < adapters.count; ++i) {
+    if (adapters.infos[i].adapter) {
+      wgpuAdapterRelease(adapters.infos[i].adapter);
+    }
+    free(adapters.infos[i].features);
+  }
+  free(adapters.infos);
+}
+
+/// Stores the adapter |selection| picks into |engine|, enumerating them
+/// unless the default adapter is asked for. Returns false if there is none.
+static bool acquire_adapter(radiant_engine_create_result_t* result,
+                            radiant_adapter_selection_t selection) {
+  radiant_engine_t* engine = &result->engine;
+  if (selection.policy == radiant_adapter_policy_default &&
+      selection.backend == WGPUBackendType_Undefined) {
+    WGPURequestAdapterOptions adapter_options = {0};
+    wgpuInstanceRequestAdapter(engine->instance, &adapter_options,
+                               adapter_request_callback, result);
+    return result->succeeded && engine->adapter;
+  }
+
+  radiant_engine_adapters_t adapters =
+      radiant_engine_enumerate_adapters(engine->instance);
+  uint32_t best =
+      radiant_adapter_select(adapters.infos, adapters.count, selection);
+  if (best == RADIANT_ADAPTER_NONE) {
+    fprintf(stderr, "No adapter matches the selection\n");
+  } else {
+    // Take the adapter out of the list so destroying it keeps this one.
+    engine->adapter = adapters.infos[best].adapter;
+    adapters.infos[best].adapter = NULL;
+  }
+  radiant_engine_adapters_destroy(adapters);
+  return engine->adapter != NULL;
+}
+
+/// Negotiates |requirements| with |adapter|.
+static radiant_adapter_negotiate_result_t negotiate(
+    WGPUAdapter adapter,
+    const radiant_adapter_requirements_t* requirements) {
+  radiant_adapter_features_t features = 0;
+  for (uint32_t i = 0; i < MAX_FEATURES; ++i) {
+    if (wgpuAdapterHasFeature(adapter, (WGPUFeatureName)i)) {
+      features |= RADIANT_ADAPTER_FEATURE(i);
+    }
+  }
+  WGPUSupportedLimits supported = {0};
+  wgpuAdapterGetLimits(adapter, &supported);
+  radiant_adapter_limits_t limits =
+      radiant_adapter_limits_from_wgpu(&supported.limits);
+  return radiant_adapter_negotiate(requirements, features, &limits);
+}
+
+/// State shared between radiant_engine_start and its startup thread
+typedef struct startup_state_t {
+  /// The engine so far, the instance, adapter and device once started
+  radiant_engine_create_result_t result;
+  radiant_time_t start;
+  double adapter_ms;
+  double device_ms;
+  radiant_adapter_selection_t selection;
+} startup_state_t;
 
+/// Creates the instance, adapter and device of the engine in |userdata|, a
+/// startup_state_t, on the adapter it selects. Releases anything created if
+/// there is no such adapter.
+static void create_device(void* userdata) {
+  RADIANT_PROFILE_SCOPE("Create device");
+  startup_state_t* state = (startup_state_t*)userdata;
+  radiant_engine_create_result_t* result = &state->result;
+  radiant_engine_t* engine = &result->engine;
+
+  radiant_time_t begin = radiant_time();
   WGPUInstanceDescriptor instance_descriptor = {0};
   engine->instance = wgpuCreateInstance(&instance_descriptor);
 
-  WGPURequestAdapterOptions adapter_options = {0};
-  wgpuInstanceRequestAdapter(engine->instance, &adapter_options,
-                             adapter_request_callback, &result);
-  if (!result.succeeded) {
+  RADIANT_PROFILE_BEGIN("Acquire adapter");
+  bool acquired = acquire_adapter(result, state->selection);
+  RADIANT_PROFILE_END();
+  radiant_time_t adapter_end = radiant_time();
+  state->adapter_ms =
+      radiant_time_diff_to_ms(radiant_time_sub(adapter_end, begin));
+  if (!acquired) {
+    result->succeeded = false;
     wgpuInstanceRelease(engine->instance);
-    return result;
+    return;
+  }
+
+  radiant_adapter_negotiate_result_t negotiated = negotiate(engine->adapter,
+      &state->selection.requirements);
+  WGPUFeatureName features[MAX_FEATURES];
+  uint32_t feature_count = 0;
+  for (uint32_t i = 0; i < MAX_FEATURES; ++i) {
+    if (negotiated.features & RADIANT_ADAPTER_FEATURE(i)) {
+      features[feature_count++] = (WGPUFeatureName)i;
+    }
   }
+  WGPURequiredLimits required_limits = {0};
+  // Every WGPU_LIMIT_U32_UNDEFINED and WGPU_LIMIT_U64_UNDEFINED is all ones.
+  memset(&required_limits.limits, 0xff, sizeof(required_limits.limits));
+  radiant_adapter_limits_to_wgpu(negotiated.limits, &required_limits.limits);
 
   WGPUDeviceDescriptor device_descriptor = {
       .label = "Primary device",
+      .requiredFeaturesCount = feature_count,
+      .requiredFeatures = features,
+      .requiredLimits = &required_limits,
   };
-  engine->device = wgpuAdapterCreateDevice(engine->adapter, &device_descriptor);
+  if (negotiated.succeeded) {
+    engine->device =
+        wgpuAdapterCreateDevice(engine->adapter, &device_descriptor);
+  }
+  state->device_ms =
+      radiant_time_diff_to_ms(radiant_time_sub(radiant_time(), adapter_end));
+  if (!engine->device) {
+    fprintf(stderr, "The adapter does not meet the device requirements\n");
+    result->succeeded = false;
+    wgpuAdapterRelease(engine->adapter);
+    wgpuInstanceRelease(engine->instance);
+    return;
+  }
+
+  for (uint32_t i = 0; i < MAX_FEATURES; ++i) {
+    if (wgpuDeviceHasFeature(engine->device, (WGPUFeatureName)i)) {
+      engine->features |= RADIANT_ADAPTER_FEATURE(i);
+    }
+  }
+  WGPUSupportedLimits device_limits = {0};
+  wgpuDeviceGetLimits(engine->device, &device_limits);
+  engine->limits = radiant_adapter_limits_from_wgpu(&device_limits.limits);
 
   wgpuDeviceSetUncapturedErrorCallback(engine->device,
                                        uncaptured_error_callback, NULL);
   wgpuDeviceSetDeviceLostCallback(engine->device, device_lost_callback, NULL);
   wgpuDeviceSetLoggingCallback(engine->device, logging_callback, NULL);
+}
 
-  radiant_surface_descriptor_t chain_surface_descriptor =
-      create_surface_descriptor(window.glfw_window);
-  WGPUSurfaceDescriptor surface_descriptor = {
-      .nextInChain = (WGPUChainedStruct*)&chain_surface_descriptor,
-      .label = "Primary surface",
+radiant_engine_startup_t radiant_engine_start(
+    radiant_adapter_selection_t selection) {
+  RADIANT_PROFILE_SCOPE("Start engine");
+  radiant_engine_startup_t startup = {0};
+  startup_state_t* state = (startup_state_t*)malloc(sizeof(startup_state_t));
+  RADIANT_ASSERT(state);
+  *state = (startup_state_t){
+      .result = {.succeeded = true},
+      .start = radiant_time(),
+      .selection = radiant_adapter_selection_from_environment(selection),
   };
-  engine->surface =
-      wgpuInstanceCreateSurface(engine->instance, &surface_descriptor);
+  startup.state = state;
+  startup.future = radiant_job_async(create_device, state);
+  return startup;
+}
+
+/// Waits for the startup thread of |startup| and returns its engine, freeing
+/// the shared state. Returns the start time in |start|.
+static radiant_engine_create_result_t join_startup(
+    radiant_engine_startup_t* startup,
+    radiant_time_t* start) {
+  RADIANT_ASSERT(startup->state);
+  radiant_time_t begin = radiant_time();
+  RADIANT_PROFILE_BEGIN("Wait for device");
+  radiant_job_wait(startup->future);
+  RADIANT_PROFILE_END();
+  radiant_time_t end = radiant_time();
+  startup_state_t* state = (startup_state_t*)startup->state;
+  startup->timings = (radiant_engine_startup_timings_t){
+      .adapter_ms = state->adapter_ms,
+      .device_ms = state->device_ms,
+      .wait_ms = radiant_time_diff_to_ms(radiant_time_sub(end, begin)),
+  };
+  radiant_engine_create_result_t result = state->result;
+  *start = state->start;
+  free(state);
+  startup->state = NULL;
+  return result;
+}
 
+/// Records the time spent creating the target since |begin| and the total
+/// since |start| into |timings|.
+static void finish_timings(radiant_engine_startup_timings_t* timings,
+                           radiant_time_t start,
+                           radiant_time_t begin) {
+  radiant_time_t end = radiant_time();
+  timings->target_ms = radiant_time_diff_to_ms(radiant_time_sub(end, begin));
+  timings->total_ms = radiant_time_diff_to_ms(radiant_time_sub(end, start));
+}
+
+/// Creates the swapchain of |engine| at |size|.
+static void create_swapchain(radiant_engine_t* engine, radiant_size_t size) {
   WGPUSwapChainDescriptor swapchain_descriptor = {
       .label = "Primary swapchain",
       .usage = WGPUTextureUsage_RenderAttachment,
-      .format = WGPUTextureFormat_BGRA8Unorm,
-      .width = (uint32_t)view.size.width,
-      .height = (uint32_t)view.size.height,
+      .format = engine->format,
+      .width = size.width,
+      .height = size.height,
       .presentMode = WGPUPresentMode_Mailbox,
   };
   engine->swapchain = wgpuDeviceCreateSwapChain(engine->device, engine->surface,
                                                 &swapchain_descriptor);
+  engine->size = size;
+}
+
+/// Creates the offscreen target of a headless |engine| at |size|.
+static void create_target(radiant_engine_t* engine, radiant_size_t size) {
+  WGPUTextureDescriptor target_descriptor = {
+      .label = "Offscreen target",
+      .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_CopySrc |
+               WGPUTextureUsage_TextureBinding,
+      .dimension = WGPUTextureDimension_2D,
+      .size =
+          {
+              .width = size.width,
+              .height = size.height,
+              .depthOrArrayLayers = 1,
+          },
+      .format = engine->format,
+      .mipLevelCount = 1,
+      .sampleCount = 1,
+  };
+  engine->target = wgpuDeviceCreateTexture(engine->device, &target_descriptor);
+  engine->target_view = wgpuTextureCreateView(engine->target, NULL);
+  engine->size = size;
+}
+
+radiant_engine_create_result_t radiant_engine_finish(
+    radiant_engine_startup_t* startup,
+    radiant_window_t window,
+    radiant_view_t view) {
+  RADIANT_PROFILE_SCOPE("Finish engine");
+  radiant_time_t start = 0;
+  radiant_engine_create_result_t result = join_startup(startup, &start);
+  if (!result.succeeded) {
+    // No target is created, it is timed as taking none.
+    finish_timings(&startup->timings, start, radiant_time());
+    return result;
+  }
+  radiant_engine_t* engine = &result.engine;
+  radiant_time_t begin = radiant_time();
+
+  radiant_surface_descriptor_t chain_surface_descriptor =
+      create_surface_descriptor(window.glfw_window);
+  WGPUSurfaceDescriptor surface_descriptor = {
+      .nextInChain = (WGPUChainedStruct*)&chain_surface_descriptor,
+      .label = "Primary surface",
+  };
+  engine->surface =
+      wgpuInstanceCreateSurface(engine->instance, &surface_descriptor);
+
+  engine->format = WGPUTextureFormat_BGRA8Unorm;
+  create_swapchain(engine, (radiant_size_t){
+                               .width = (uint32_t)view.size.width,
+                               .height = (uint32_t)view.size.height,
+                           });
 
+  finish_timings(&startup->timings, start, begin);
   return result;
 }
 
-void radiant_engine_destroy(radiant_engine_t engine) {
-  wgpuSwapChainRelease(engine.swapchain);
-  wgpuSurfaceRelease(engine.surface);
+radiant_engine_create_result_t radiant_engine_finish_headless(
+    radiant_engine_startup_t* startup,
+    radiant_size_t size,
+    WGPUTextureFormat format) {
+  RADIANT_PROFILE_SCOPE("Finish engine");
+  radiant_time_t start = 0;
+  radiant_engine_create_result_t result = join_startup(startup, &start);
+  if (!result.succeeded) {
+    // No target is created, it is timed as taking none.
+    finish_timings(&startup->timings, start, radiant_time());
+    return result;
+  }
+  radiant_engine_t* engine = &result.engine;
+  radiant_time_t begin = radiant_time();
+
+  engine->format = format;
+  create_target(engine, size);
+
+  finish_timings(&startup->timings, start, begin);
+  return result;
+}
+
+/// Releases the device, adapter and instance of |engine|.
+static void release_device(radiant_engine_t engine) {
   // Remove the device lost callback as it will be lost when we release it.
   wgpuDeviceSetDeviceLostCallback(engine.device, NULL, NULL);
   wgpuDeviceRelease(engine.device);
   wgpuAdapterRelease(engine.adapter);
   wgpuInstanceRelease(engine.instance);
 }
+
+void radiant_engine_cancel(radiant_engine_startup_t* startup) {
+  RADIANT_PROFILE_SCOPE("Cancel engine");
+  radiant_time_t start = 0;
+  radiant_engine_create_result_t result = join_startup(startup, &start);
+  finish_timings(&startup->timings, start, radiant_time());
+  if (result.succeeded) {
+    release_device(result.engine);
+  }
+}
+
+radiant_engine_create_result_t radiant_engine_create(
+    radiant_window_t window,
+    radiant_view_t view,
+    radiant_adapter_selection_t adapter) {
+  RADIANT_PROFILE_SCOPE("Create engine");
+  radiant_engine_startup_t startup = radiant_engine_start(adapter);
+  return radiant_engine_finish(&startup, window, view);
+}
+
+radiant_engine_create_result_t radiant_engine_create_headless(
+    radiant_engine_headless_create_request_t req) {
+  RADIANT_PROFILE_SCOPE("Create engine");
+  radiant_engine_startup_t startup = radiant_engine_start(req.adapter);
+  return radiant_engine_finish_headless(&startup, req.size, req.format);
+}
+
+WGPUTextureView radiant_engine_current_view(radiant_engine_t engine) {
+  if (engine.target_view) {
+    return engine.target_view;
+  }
+  return wgpuSwapChainGetCurrentTextureView(engine.swapchain);
+}
+
+void radiant_engine_present(radiant_engine_t engine) {
+  if (engine.swapchain) {
+    wgpuSwapChainPresent(engine.swapchain);
+  }
+}
+
+void radiant_engine_resize(radiant_engine_t* engine, radiant_size_t size) {
+  RADIANT_ASSERT(size.width > 0 && size.height > 0);
+  if (size.width == engine->size.width && size.height == engine->size.height) {
+    return;
+  }
+  RADIANT_PROFILE_SCOPE("Resize engine");
+  if (engine->target) {
+    wgpuTextureViewRelease(engine->target_view);
+    wgpuTextureRelease(engine->target);
+    create_target(engine, size);
+  } else {
+    wgpuSwapChainRelease(engine->swapchain);
+    create_swapchain(engine, size);
+  }
+}
+
+void radiant_engine_destroy(radiant_engine_t engine) {
+  if (engine.target) {
+    wgpuTextureViewRelease(engine.target_view);
+    wgpuTextureRelease(engine.target);
+  } else {
+    wgpuSwapChainRelease(engine.swapchain);
+    wgpuSurfaceRelease(engine.surface);
+  }
+  release_device(engine);
+}
@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include "src/adapter.h"
+#include "src/job.h"
 #include "src/pad.h"
+#include "src/size.h"
 #include "src/view.h"
 #include "src/wgpu.h"
 #include "src/window.h"
@@ -24,10 +27,47 @@ typedef struct radiant_engine_t {
   WGPUInstance instance;
   WGPUAdapter adapter;
   WGPUDevice device;
+  /// The window surface, NULL for a headless engine
   WGPUSurface surface;
+  /// The window swapchain, NULL for a headless engine
   WGPUSwapChain swapchain;
+  /// The offscreen colour target of a headless engine, NULL otherwise
+  WGPUTexture target;
+  /// A view of |target|
+  WGPUTextureView target_view;
+  /// The size of the swapchain or offscreen target
+  radiant_size_t size;
+  /// The format of the swapchain or offscreen target
+  WGPUTextureFormat format;
+  /// Unused padding
+  RADIANT_PAD(4);
+  /// The standard features enabled on |device|
+  radiant_adapter_features_t features;
+  /// The limits of |device|
+  radiant_adapter_limits_t limits;
 } radiant_engine_t;
 
+/// Parameters for creating a headless engine
+typedef struct radiant_engine_headless_create_request_t {
+  /// The adapter to run on, see radiant_engine_start
+  radiant_adapter_selection_t adapter;
+  /// The size of the offscreen target
+  radiant_size_t size;
+  /// The format of the offscreen target
+  WGPUTextureFormat format;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_engine_headless_create_request_t;
+
+/// Adapters found by radiant_engine_enumerate_adapters
+typedef struct radiant_engine_adapters_t {
+  /// The |count| adapters, in a fixed order for a given machine
+  radiant_adapter_info_t* infos;
+  uint32_t count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_engine_adapters_t;
+
 /// Results of creating an engine
 typedef struct radiant_engine_create_result_t {
   /// The engine handle. Only valid if |succeeded| is true.
@@ -38,9 +78,99 @@ typedef struct radiant_engine_create_result_t {
   RADIANT_PAD(7);
 } radiant_engine_create_result_t;
 
-/// Creates and initializes a new engine based on the given |window|.
-radiant_engine_create_result_t radiant_engine_create(radiant_window_t window,
-                                                     radiant_view_t view);
+/// Milliseconds spent in each phase of starting an engine. Phases that did
+/// not run, as an earlier one failed, are zero.
+typedef struct radiant_engine_startup_timings_t {
+  /// Requesting the adapter, on the startup thread
+  double adapter_ms;
+  /// Creating the device, on the startup thread
+  double device_ms;
+  /// Blocked in radiant_engine_finish waiting for the startup thread
+  double wait_ms;
+  /// Creating the surface and swapchain, or the offscreen target
+  double target_ms;
+  /// From radiant_engine_start until radiant_engine_finish returned
+  double total_ms;
+} radiant_engine_startup_timings_t;
+
+/// An engine being started by radiant_engine_start
+typedef struct radiant_engine_startup_t {
+  /// @private
+  /// The startup thread
+  radiant_job_future_t future;
+  /// @private
+  /// State shared with the startup thread, freed by radiant_engine_finish
+  void* state;
+  /// The phase timings, filled in by radiant_engine_finish
+  radiant_engine_startup_timings_t timings;
+} radiant_engine_startup_t;
+
+/// Returns every adapter |instance| offers, found by requesting each backend
+/// with and without the fallback adapter at both power preferences. The
+/// caller owns the adapters and must call radiant_engine_adapters_destroy.
+radiant_engine_adapters_t radiant_engine_enumerate_adapters(
+    WGPUInstance instance);
+
+/// Releases the adapters in |adapters| that are not NULL and frees the list.
+void radiant_engine_adapters_destroy(radiant_engine_adapters_t adapters);
+
+/// Starts acquiring the adapter |selection| picks and creating its device,
+/// with the features and limits it requires, on another thread, and returns
+/// at once so the window can be created and assets read meanwhile. A
+/// policy or backend in the RADIANT_ADAPTER environment variable overrides
+/// that of |selection|. Anything but the default policy on any backend
+/// enumerates the adapters and takes the best by radiant_adapter_select.
+/// Must be completed by exactly one of radiant_engine_finish,
+/// radiant_engine_finish_headless or radiant_engine_cancel.
+radiant_engine_startup_t radiant_engine_start(
+    radiant_adapter_selection_t selection);
+
+/// Waits for the device of |startup| and creates the surface and swapchain
+/// for |window|. Fills in |startup->timings|, also when it fails.
+radiant_engine_create_result_t radiant_engine_finish(
+    radiant_engine_startup_t* startup,
+    radiant_window_t window,
+    radiant_view_t view);
+
+/// Waits for the device of |startup| and creates an offscreen target of
+/// |size| and |format|, see radiant_engine_create_headless. Fills in
+/// |startup->timings|, also when it fails.
+radiant_engine_create_result_t radiant_engine_finish_headless(
+    radiant_engine_startup_t* startup,
+    radiant_size_t size,
+    WGPUTextureFormat format);
+
+/// Waits for the startup thread of |startup|, as it cannot be stopped, and
+/// releases the device it created, if any. For when the engine is no longer
+/// wanted, such as after failing to create its window.
+void radiant_engine_cancel(radiant_engine_startup_t* startup);
+
+/// Creates and initializes a new engine based on the given |window|, on the
+/// adapter |adapter| selects. The device gets the required features and
+/// limits of the selection and whichever optional features the adapter has;
+/// creation fails if the adapter cannot meet the requirements.
+radiant_engine_create_result_t radiant_engine_create(
+    radiant_window_t window,
+    radiant_view_t view,
+    radiant_adapter_selection_t adapter);
+
+/// Creates and initializes a new engine without a window, rendering into an
+/// offscreen target of |req.size| instead of a swapchain. The target can be
+/// copied from for readback. Fails if the requested adapter is unavailable.
+radiant_engine_create_result_t radiant_engine_create_headless(
+    radiant_engine_headless_create_request_t req);
+
+/// Returns the view to render the current frame into, the swapchain's current
+/// texture or the offscreen target of a headless engine.
+WGPUTextureView radiant_engine_current_view(radiant_engine_t engine);
+
+/// Recreates the swapchain, or the offscreen target of a headless engine, at
+/// |size|, which must not be empty. Does nothing if |engine| is already that
+/// size. Views from radiant_engine_current_view are invalid afterwards.
+void radiant_engine_resize(radiant_engine_t* engine, radiant_size_t size);
+
+/// Presents the current frame. Does nothing for a headless engine.
+void radiant_engine_present(radiant_engine_t engine);
 
 /// Destroys the |engine|.
 void radiant_engine_destroy(radiant_engine_t engine);
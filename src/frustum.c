@@ -0,0 +1,115 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/frustum.h"
+
+#include <math.h>
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+/// Returns the plane a * x + b * y + c * z + d = 0 with a unit normal.
+static radiant_plane_t normalized_plane(float a, float b, float c, float d) {
+  float len = sqrtf((a * a) + (b * b) + (c * c));
+  float inv = len > 0.f ? 1.f / len : 1.f;
+  return (radiant_plane_t){
+      .normal = {a * inv, b * inv, c * inv},
+      .distance = d * inv,
+  };
+}
+
+/// Returns the plane row 3 + |sign| * row |i| of the column-major |m|.
+static radiant_plane_t row_plane(const radiant_mat4x4_t* m,
+                                 uint32_t i,
+                                 float sign) {
+  const float* d = m->data;
+  return normalized_plane(d[3] + (sign * d[i]), d[7] + (sign * d[4 + i]),
+                          d[11] + (sign * d[8 + i]),
+                          d[15] + (sign * d[12 + i]));
+}
+
+radiant_frustum_t radiant_frustum_from_mat4x4(radiant_mat4x4_t m) {
+  return (radiant_frustum_t){
+      .planes =
+          {
+              [radiant_frustum_plane_left] = row_plane(&m, 0, 1.f),
+              [radiant_frustum_plane_right] = row_plane(&m, 0, -1.f),
+              [radiant_frustum_plane_bottom] = row_plane(&m, 1, 1.f),
+              [radiant_frustum_plane_top] = row_plane(&m, 1, -1.f),
+              [radiant_frustum_plane_near] = row_plane(&m, 2, 1.f),
+              [radiant_frustum_plane_far] = row_plane(&m, 2, -1.f),
+          },
+  };
+}
+
+radiant_frustum_t radiant_frustum_from_mat4x4_reverse_z(radiant_mat4x4_t m) {
+  const float* d = m.data;
+  return (radiant_frustum_t){
+      .planes =
+          {
+              [radiant_frustum_plane_left] = row_plane(&m, 0, 1.f),
+              [radiant_frustum_plane_right] = row_plane(&m, 0, -1.f),
+              [radiant_frustum_plane_bottom] = row_plane(&m, 1, 1.f),
+              [radiant_frustum_plane_top] = row_plane(&m, 1, -1.f),
+              [radiant_frustum_plane_near] = row_plane(&m, 2, -1.f),
+              // z >= 0. At infinity the row is (0, 0, 0, near) and the plane
+              // holds everywhere.
+              [radiant_frustum_plane_far] =
+                  normalized_plane(d[2], d[6], d[10], d[14]),
+          },
+  };
+}
+
+bool radiant_frustum_intersects_aabb(radiant_frustum_t frustum,
+                                     radiant_aabb_t box) {
+  radiant_point3_t c = radiant_aabb_centre(box);
+  radiant_vec3_t e = radiant_aabb_half_extent(box);
+  for (uint32_t i = 0; i < radiant_frustum_plane_count; ++i) {
+    radiant_plane_t p = frustum.planes[i];
+    float dist = (p.normal.x * c.x) + (p.normal.y * c.y) +
+                 (p.normal.z * c.z) + p.distance;
+    float radius = (fabsf(p.normal.x) * e.x) + (fabsf(p.normal.y) * e.y) +
+                   (fabsf(p.normal.z) * e.z);
+    if (dist + radius < 0.f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool radiant_frustum_intersects_sphere(radiant_frustum_t frustum,
+                                       radiant_sphere_t sphere) {
+  radiant_point3_t c = sphere.centre;
+  for (uint32_t i = 0; i < radiant_frustum_plane_count; ++i) {
+    radiant_plane_t p = frustum.planes[i];
+    float dist = (p.normal.x * c.x) + (p.normal.y * c.y) +
+                 (p.normal.z * c.z) + p.distance;
+    if (dist + sphere.radius < 0.f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t radiant_frustum_cull_aabbs(radiant_frustum_t frustum,
+                                    radiant_aabb_soa_t boxes,
+                                    uint32_t begin,
+                                    uint32_t end,
+                                    uint32_t* visible) {
+  RADIANT_ASSERT(begin <= end);
+  RADIANT_ASSERT(end <= radiant_aabb_soa_count(boxes));
+  RADIANT_ASSERT(visible || begin == end);
+  return radiant_simd_ops()->frustum_cull_aabbs(&frustum, &boxes, begin, end,
+                                                visible);
+}
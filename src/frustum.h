@@ -0,0 +1,81 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/bounds.h"
+#include "src/mat4x4.h"
+#include "src/vec3.h"
+
+/// A plane. Points p with dot(|normal|, p) + |distance| >= 0 are on the
+/// inside.
+typedef struct radiant_plane_t {
+  /// The unit normal, pointing inside
+  radiant_vec3_t normal;
+  /// The signed distance from the origin along |normal|
+  float distance;
+} radiant_plane_t;
+
+/// The planes of a view frustum.
+typedef enum radiant_frustum_plane_t {
+  radiant_frustum_plane_left,
+  radiant_frustum_plane_right,
+  radiant_frustum_plane_bottom,
+  radiant_frustum_plane_top,
+  radiant_frustum_plane_near,
+  radiant_frustum_plane_far,
+
+  /// Number of planes
+  radiant_frustum_plane_count,
+} radiant_frustum_plane_t;
+
+/// A view frustum, indexed by radiant_frustum_plane_t.
+typedef struct radiant_frustum_t {
+  /// The planes, normalized and facing inside
+  radiant_plane_t planes[radiant_frustum_plane_count];
+} radiant_frustum_t;
+
+/// Extracts the frustum of the projection view matrix |m| (Gribb and
+/// Hartmann). Clip space z is taken to be in [-w, w] as produced by
+/// radiant_mat4x4_perspective.
+radiant_frustum_t radiant_frustum_from_mat4x4(radiant_mat4x4_t m);
+
+/// Extracts the frustum of the projection view matrix |m| with clip space z
+/// in [0, w] and the near plane at w, as produced by
+/// radiant_mat4x4_perspective_reverse_z_infinite. Without a far plane the
+/// far plane of the frustum never culls.
+radiant_frustum_t radiant_frustum_from_mat4x4_reverse_z(radiant_mat4x4_t m);
+
+/// Returns false if |box| is fully outside |frustum|. Boxes near a corner of
+/// the frustum may be reported as intersecting when they are just outside.
+bool radiant_frustum_intersects_aabb(radiant_frustum_t frustum,
+                                     radiant_aabb_t box);
+
+/// Returns false if |sphere| is fully outside |frustum|, with the same
+/// caveat as radiant_frustum_intersects_aabb.
+bool radiant_frustum_intersects_sphere(radiant_frustum_t frustum,
+                                       radiant_sphere_t sphere);
+
+/// Tests the boxes [|begin|, |end|) of |boxes| against |frustum| and stores
+/// the indices of those not fully outside, in increasing order, into
+/// |visible|, which must hold |end| - |begin| indices. Returns the number of
+/// visible boxes.
+uint32_t radiant_frustum_cull_aabbs(radiant_frustum_t frustum,
+                                    radiant_aabb_soa_t boxes,
+                                    uint32_t begin,
+                                    uint32_t end,
+                                    uint32_t* visible);
@@ -0,0 +1,116 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Culls a grid of boxes against a camera frustum for each supported SIMD
+// backend, compared against testing each box with
+// radiant_frustum_intersects_aabb.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/frustum.h"
+#include "src/simd.h"
+
+/// Boxes per side of the cubic grid.
+#define GRID 50
+
+static const uint32_t kCount = GRID * GRID * GRID;
+static const uint32_t kIterations = 200;
+
+typedef struct bench_data_t {
+  radiant_frustum_t frustum;
+  radiant_aabb_soa_t boxes;
+  uint32_t* visible;
+  uint32_t visible_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} bench_data_t;
+
+static void single(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    if (radiant_frustum_intersects_aabb(
+            data->frustum, radiant_aabb_soa_get(data->boxes, i))) {
+      data->visible[count++] = i;
+    }
+  }
+  data->visible_count = count;
+}
+
+static void batch(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  data->visible_count = radiant_frustum_cull_aabbs(
+      data->frustum, data->boxes, 0, kCount, data->visible);
+}
+
+int main() {
+  radiant_mat4x4_t projection =
+      radiant_mat4x4_perspective(1.f, 1.5f, 0.1f, 100.f);
+  radiant_mat4x4_t view =
+      radiant_mat4x4_look_at((radiant_point3_t){0.f, 0.f, 0.f},
+                             (radiant_point3_t){1.f, 0.f, -1.f},
+                             (radiant_vec3_t){0.f, 1.f, 0.f});
+  bench_data_t data = {
+      .frustum =
+          radiant_frustum_from_mat4x4(radiant_mat4x4_mul(projection, view)),
+      .boxes = radiant_aabb_soa_create(kCount),
+      .visible = (uint32_t*)malloc(kCount * sizeof(uint32_t)),
+  };
+  if (radiant_aabb_soa_count(data.boxes) != kCount || !data.visible) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  // Boxes spread through [-100, 100] on each axis around the camera.
+  uint32_t idx = 0;
+  for (uint32_t x = 0; x < GRID; ++x) {
+    for (uint32_t y = 0; y < GRID; ++y) {
+      for (uint32_t z = 0; z < GRID; ++z) {
+        radiant_point3_t c = {
+            ((float)x / GRID) * 200.f - 100.f,
+            ((float)y / GRID) * 200.f - 100.f,
+            ((float)z / GRID) * 200.f - 100.f,
+        };
+        radiant_aabb_soa_set(
+            data.boxes, idx++,
+            (radiant_aabb_t){{c.x - 1.f, c.y - 1.f, c.z - 1.f},
+                             {c.x + 1.f, c.y + 1.f, c.z + 1.f}});
+      }
+    }
+  }
+
+  batch(&data);
+  printf("Culling %u boxes, %u visible\n", kCount, data.visible_count);
+  radiant_bench_run("frustum_intersects_aabb loop", single, &data,
+                    kIterations, kCount);
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "frustum_cull_aabbs [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, batch, &data, kIterations, kCount);
+  }
+  radiant_simd_set_backend(original);
+
+  radiant_aabb_soa_destroy(data.boxes);
+  free(data.visible);
+  return 0;
+}
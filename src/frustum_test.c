@@ -0,0 +1,167 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/frustum.h"
+
+#include <math.h>
+
+#include "src/angle.h"
+#include "src/test.h"
+
+/// Not a multiple of any vector width.
+#define COUNT 203
+
+/// A camera at the origin looking down -z with a 90 degree field of view.
+static radiant_frustum_t frustum(void) {
+  radiant_mat4x4_t projection =
+      radiant_mat4x4_perspective(1.5707964f, 1.f, 1.f, 100.f);
+  radiant_mat4x4_t view =
+      radiant_mat4x4_look_at((radiant_point3_t){0.f, 0.f, 0.f},
+                             (radiant_point3_t){0.f, 0.f, -1.f},
+                             (radiant_vec3_t){0.f, 1.f, 0.f});
+  return radiant_frustum_from_mat4x4(radiant_mat4x4_mul(projection, view));
+}
+
+static radiant_aabb_t box_at(float x, float y, float z, float half) {
+  return (radiant_aabb_t){
+      .min = {x - half, y - half, z - half},
+      .max = {x + half, y + half, z + half},
+  };
+}
+
+static bool planes() {
+  radiant_frustum_t f = frustum();
+  radiant_plane_t near = f.planes[radiant_frustum_plane_near];
+  RADIANT_EXPECT_FLOAT_EQ(near.normal.z, -1.f);
+  RADIANT_EXPECT_FLOAT_EQ(near.distance, -1.f);
+  radiant_plane_t far = f.planes[radiant_frustum_plane_far];
+  RADIANT_EXPECT_FLOAT_EQ(far.normal.z, 1.f);
+  // Far plane precision suffers from the cancellation in the extraction.
+  RADIANT_EXPECT_TRUE(fabsf(far.distance - 100.f) < 1e-3f);
+
+  // The side planes are at 45 degrees.
+  radiant_plane_t left = f.planes[radiant_frustum_plane_left];
+  RADIANT_EXPECT_FLOAT_EQ(left.normal.x, 0.70710677f);
+  RADIANT_EXPECT_FLOAT_EQ(left.normal.z, -0.70710677f);
+  RADIANT_EXPECT_FLOAT_EQ(left.distance, 0.f);
+  return true;
+}
+
+static bool reverse_z() {
+  radiant_mat4x4_t projection =
+      radiant_mat4x4_perspective_reverse_z_infinite(1.5707964f, 1.f, 1.f);
+  radiant_mat4x4_t view =
+      radiant_mat4x4_look_at((radiant_point3_t){0.f, 0.f, 0.f},
+                             (radiant_point3_t){0.f, 0.f, -1.f},
+                             (radiant_vec3_t){0.f, 1.f, 0.f});
+  radiant_frustum_t f = radiant_frustum_from_mat4x4_reverse_z(
+      radiant_mat4x4_mul(projection, view));
+  radiant_plane_t near = f.planes[radiant_frustum_plane_near];
+  RADIANT_EXPECT_FLOAT_EQ(near.normal.z, -1.f);
+  RADIANT_EXPECT_FLOAT_EQ(near.distance, -1.f);
+  radiant_plane_t left = f.planes[radiant_frustum_plane_left];
+  RADIANT_EXPECT_FLOAT_EQ(left.normal.x, 0.70710677f);
+
+  RADIANT_EXPECT_TRUE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, -10.f, 1.f)));
+  // Nothing is too far away.
+  RADIANT_EXPECT_TRUE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, -1e6f, 1.f)));
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, -0.5f, 0.25f)));
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(f, box_at(20.f, 0.f, -10.f, 1.f)));
+  return true;
+}
+
+static bool intersects_aabb() {
+  radiant_frustum_t f = frustum();
+  RADIANT_EXPECT_TRUE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, -10.f, 1.f)));
+  // Behind the camera, beyond the far plane, off to each side.
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, 10.f, 1.f)));
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, -200.f, 1.f)));
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(f, box_at(20.f, 0.f, -10.f, 1.f)));
+  RADIANT_EXPECT_FALSE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, -20.f, -10.f, 1.f)));
+  // Straddling the left plane.
+  RADIANT_EXPECT_TRUE(
+      radiant_frustum_intersects_aabb(f, box_at(-10.5f, 0.f, -10.f, 1.f)));
+  // Holding the whole frustum.
+  RADIANT_EXPECT_TRUE(
+      radiant_frustum_intersects_aabb(f, box_at(0.f, 0.f, 0.f, 500.f)));
+  return true;
+}
+
+static bool intersects_sphere() {
+  radiant_frustum_t f = frustum();
+  radiant_sphere_t s = {.centre = {0.f, 0.f, -10.f}, .radius = 1.f};
+  RADIANT_EXPECT_TRUE(radiant_frustum_intersects_sphere(f, s));
+  s.centre.z = 1.5f;
+  RADIANT_EXPECT_FALSE(radiant_frustum_intersects_sphere(f, s));
+  s.radius = 3.f;
+  RADIANT_EXPECT_TRUE(radiant_frustum_intersects_sphere(f, s));
+  return true;
+}
+
+static bool cull_aabbs() {
+  radiant_frustum_t f = frustum();
+  radiant_aabb_soa_t boxes = radiant_aabb_soa_create(COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    // A spiral of boxes around the camera, some in view and some not.
+    float fi = (float)i;
+    radiant_sincos_t sc = radiant_sincos(fi * 0.37f);
+    radiant_aabb_soa_set(boxes, i,
+                         box_at(sc.cos * fi, (fi - 100.f) * 0.2f, sc.sin * fi,
+                                0.5f + (fi * 0.01f)));
+  }
+
+  uint32_t visible[COUNT];
+  uint32_t ranges[][2] = {{0, COUNT}, {3, 150}, {17, 18}, {40, 40}};
+  for (uint32_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+    uint32_t begin = ranges[r][0];
+    uint32_t end = ranges[r][1];
+    uint32_t count = radiant_frustum_cull_aabbs(f, boxes, begin, end, visible);
+
+    uint32_t expected = 0;
+    for (uint32_t i = begin; i < end; ++i) {
+      if (radiant_frustum_intersects_aabb(f, radiant_aabb_soa_get(boxes, i))) {
+        RADIANT_EXPECT_TRUE(expected < count);
+        RADIANT_EXPECT_EQ(visible[expected], i);
+        ++expected;
+      }
+    }
+    RADIANT_EXPECT_EQ(count, expected);
+    if (end - begin == COUNT) {
+      RADIANT_EXPECT_TRUE(count > 0);
+      RADIANT_EXPECT_TRUE(count < COUNT);
+    }
+  }
+
+  radiant_aabb_soa_destroy(boxes);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("frustum");
+  RADIANT_TEST(planes);
+  RADIANT_TEST(reverse_z);
+  RADIANT_TEST(intersects_aabb);
+  RADIANT_TEST(intersects_sphere);
+  RADIANT_TEST_ALL_BACKENDS(cull_aabbs);
+  return radiant_suite_end();
+}
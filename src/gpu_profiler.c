@@ -0,0 +1,307 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/gpu_profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "src/assert.h"
+
+/// Timestamps each slot holds, two per pass.
+#define SLOT_QUERIES (2 * RADIANT_GPU_PROFILER_MAX_PASSES)
+/// Bytes of timestamps each slot holds. A multiple of 256, the alignment
+/// query sets are resolved at.
+#define SLOT_BYTES (SLOT_QUERIES * sizeof(uint64_t))
+
+static const double kNsPerMs = 1e6;
+
+static void map_callback(WGPUBufferMapAsyncStatus status, void* userdata) {
+  radiant_gpu_profiler_slot_t* slot = (radiant_gpu_profiler_slot_t*)userdata;
+  slot->map_status = status;
+  slot->state = radiant_gpu_profiler_slot_state_mapped;
+}
+
+radiant_gpu_profiler_t radiant_gpu_profiler_create(
+    radiant_gpu_profiler_create_request_t req) {
+  radiant_gpu_profiler_t profiler = {
+      .instance = req.engine.instance,
+      .current = RADIANT_GPU_PROFILER_FRAMES,
+  };
+  if (!(req.engine.features &
+        RADIANT_ADAPTER_FEATURE(WGPUFeatureName_TimestampQuery))) {
+    return profiler;
+  }
+
+  WGPUQuerySetDescriptor query_set_desc = {
+      .label = "GPU profiler timestamps",
+      .type = WGPUQueryType_Timestamp,
+      .count = SLOT_QUERIES * RADIANT_GPU_PROFILER_FRAMES,
+  };
+  profiler.query_set =
+      wgpuDeviceCreateQuerySet(req.engine.device, &query_set_desc);
+  profiler.queue = wgpuDeviceGetQueue(req.engine.device);
+  profiler.period_ns = wgpuQueueGetTimestampPeriod(profiler.queue);
+  profiler.resolve = radiant_buffer_create((radiant_buffer_create_request_t){
+      .engine = req.engine,
+      .usage =
+          radiant_buffer_usage_query_resolve | radiant_buffer_usage_copy_src,
+      .label = "GPU profiler resolve",
+      .size_in_bytes = SLOT_BYTES * RADIANT_GPU_PROFILER_FRAMES,
+  });
+  for (uint32_t i = 0; i < RADIANT_GPU_PROFILER_FRAMES; ++i) {
+    profiler.slots[i].readback =
+        radiant_buffer_create((radiant_buffer_create_request_t){
+            .engine = req.engine,
+            .usage =
+                radiant_buffer_usage_map_read | radiant_buffer_usage_copy_dst,
+            .label = "GPU profiler readback",
+            .size_in_bytes = SLOT_BYTES,
+        });
+  }
+  return profiler;
+}
+
+void radiant_gpu_profiler_destroy(radiant_gpu_profiler_t* profiler) {
+  if (!radiant_gpu_profiler_available(profiler)) {
+    return;
+  }
+  for (uint32_t i = 0; i < RADIANT_GPU_PROFILER_FRAMES; ++i) {
+    radiant_buffer_destroy(profiler->slots[i].readback);
+  }
+  radiant_buffer_destroy(profiler->resolve);
+  wgpuQuerySetDestroy(profiler->query_set);
+  wgpuQuerySetRelease(profiler->query_set);
+  wgpuQueueRelease(profiler->queue);
+}
+
+bool radiant_gpu_profiler_available(const radiant_gpu_profiler_t* profiler) {
+  return profiler->query_set != NULL;
+}
+
+void radiant_gpu_profiler_pass_stats_add(
+    radiant_gpu_profiler_pass_stats_t* stats,
+    double ms) {
+  stats->last_ms = ms;
+  stats->history[stats->next] = ms;
+  stats->next = (stats->next + 1) % RADIANT_GPU_PROFILER_HISTORY;
+  ++stats->samples;
+
+  uint32_t count = stats->samples < RADIANT_GPU_PROFILER_HISTORY
+                       ? stats->samples
+                       : RADIANT_GPU_PROFILER_HISTORY;
+  double sum = 0.0;
+  for (uint32_t i = 0; i < count; ++i) {
+    sum += stats->history[i];
+  }
+  stats->average_ms = sum / (double)count;
+}
+
+/// Adds the timings of the mapped |slot| to |profiler| and frees it.
+static void read_slot(radiant_gpu_profiler_t* profiler,
+                      radiant_gpu_profiler_slot_t* slot) {
+  if (slot->map_status != WGPUBufferMapAsyncStatus_Success) {
+    fprintf(stderr, "Failed to read back GPU timings: %d\n",
+            (int)slot->map_status);
+    slot->state = radiant_gpu_profiler_slot_state_free;
+    return;
+  }
+
+  const uint64_t* timestamps = (const uint64_t*)wgpuBufferGetConstMappedRange(
+      slot->readback.buffer, 0, SLOT_BYTES);
+  for (uint32_t i = 0; i < slot->pass_count; ++i) {
+    uint64_t begin = timestamps[2 * i];
+    uint64_t end = timestamps[(2 * i) + 1];
+    // Timestamps can go backwards across a power state change, drop those.
+    if (end < begin) {
+      continue;
+    }
+    double ms = (double)(end - begin) * (double)profiler->period_ns / kNsPerMs;
+    radiant_gpu_profiler_pass_stats_add(&profiler->passes[slot->pass_ids[i]],
+                                        ms);
+  }
+  radiant_buffer_unmap(slot->readback);
+  slot->state = radiant_gpu_profiler_slot_state_free;
+}
+
+/// Returns the mapped slot of the earliest frame, or NULL if there is none.
+static radiant_gpu_profiler_slot_t* oldest_mapped(
+    radiant_gpu_profiler_t* profiler) {
+  radiant_gpu_profiler_slot_t* oldest = NULL;
+  for (uint32_t i = 0; i < RADIANT_GPU_PROFILER_FRAMES; ++i) {
+    radiant_gpu_profiler_slot_t* slot = &profiler->slots[i];
+    if (slot->state == radiant_gpu_profiler_slot_state_mapped &&
+        (!oldest || slot->frame < oldest->frame)) {
+      oldest = slot;
+    }
+  }
+  return oldest;
+}
+
+void radiant_gpu_profiler_begin_frame(radiant_gpu_profiler_t* profiler) {
+  RADIANT_ASSERT(profiler->current == RADIANT_GPU_PROFILER_FRAMES);
+  ++profiler->frame;
+  if (!radiant_gpu_profiler_available(profiler)) {
+    return;
+  }
+
+  // Picks up maps that finished without waiting on any.
+  wgpuInstanceProcessEvents(profiler->instance);
+  radiant_gpu_profiler_slot_t* mapped = NULL;
+  while ((mapped = oldest_mapped(profiler))) {
+    read_slot(profiler, mapped);
+  }
+
+  for (uint32_t i = 0; i < RADIANT_GPU_PROFILER_FRAMES; ++i) {
+    radiant_gpu_profiler_slot_t* slot = &profiler->slots[i];
+    if (slot->state == radiant_gpu_profiler_slot_state_free) {
+      slot->state = radiant_gpu_profiler_slot_state_recording;
+      slot->frame = profiler->frame;
+      slot->pass_count = 0;
+      profiler->current = i;
+      return;
+    }
+  }
+  ++profiler->skipped_frames;
+}
+
+/// Returns the index of the pass |name| in |profiler->passes|, adding it if
+/// it is new. Returns RADIANT_GPU_PROFILER_MAX_PASSES if there is no room.
+static uint32_t pass_id(radiant_gpu_profiler_t* profiler, const char* name) {
+  const radiant_gpu_profiler_pass_stats_t* stats =
+      radiant_gpu_profiler_find(profiler, name);
+  if (stats) {
+    return (uint32_t)(stats - profiler->passes);
+  }
+  if (profiler->pass_count == RADIANT_GPU_PROFILER_MAX_PASSES) {
+    return RADIANT_GPU_PROFILER_MAX_PASSES;
+  }
+  profiler->passes[profiler->pass_count] =
+      (radiant_gpu_profiler_pass_stats_t){.name = name};
+  return profiler->pass_count++;
+}
+
+/// Adds the pass |name| to the frame being timed. Returns the first of its
+/// two queries, or false if it is not timed.
+static bool add_pass(radiant_gpu_profiler_t* profiler,
+                     const char* name,
+                     uint32_t* first_query) {
+  if (profiler->current == RADIANT_GPU_PROFILER_FRAMES) {
+    return false;
+  }
+  radiant_gpu_profiler_slot_t* slot = &profiler->slots[profiler->current];
+  uint32_t id = pass_id(profiler, name);
+  if (id == RADIANT_GPU_PROFILER_MAX_PASSES ||
+      slot->pass_count == RADIANT_GPU_PROFILER_MAX_PASSES) {
+    return false;
+  }
+  *first_query = (profiler->current * SLOT_QUERIES) + (2 * slot->pass_count);
+  slot->pass_ids[slot->pass_count++] = id;
+  return true;
+}
+
+radiant_gpu_profiler_render_writes_t radiant_gpu_profiler_render_pass(
+    radiant_gpu_profiler_t* profiler,
+    const char* name) {
+  uint32_t query = 0;
+  if (!add_pass(profiler, name, &query)) {
+    return (radiant_gpu_profiler_render_writes_t){0};
+  }
+  return (radiant_gpu_profiler_render_writes_t){
+      .writes =
+          {
+              {
+                  .querySet = profiler->query_set,
+                  .queryIndex = query,
+                  .location = WGPURenderPassTimestampLocation_Beginning,
+              },
+              {
+                  .querySet = profiler->query_set,
+                  .queryIndex = query + 1,
+                  .location = WGPURenderPassTimestampLocation_End,
+              },
+          },
+      .count = 2,
+  };
+}
+
+radiant_gpu_profiler_compute_writes_t radiant_gpu_profiler_compute_pass(
+    radiant_gpu_profiler_t* profiler,
+    const char* name) {
+  uint32_t query = 0;
+  if (!add_pass(profiler, name, &query)) {
+    return (radiant_gpu_profiler_compute_writes_t){0};
+  }
+  return (radiant_gpu_profiler_compute_writes_t){
+      .writes =
+          {
+              {
+                  .querySet = profiler->query_set,
+                  .queryIndex = query,
+                  .location = WGPUComputePassTimestampLocation_Beginning,
+              },
+              {
+                  .querySet = profiler->query_set,
+                  .queryIndex = query + 1,
+                  .location = WGPUComputePassTimestampLocation_End,
+              },
+          },
+      .count = 2,
+  };
+}
+
+void radiant_gpu_profiler_resolve(radiant_gpu_profiler_t* profiler,
+                                  WGPUCommandEncoder encoder) {
+  if (profiler->current == RADIANT_GPU_PROFILER_FRAMES) {
+    return;
+  }
+  radiant_gpu_profiler_slot_t* slot = &profiler->slots[profiler->current];
+  if (slot->pass_count == 0) {
+    return;
+  }
+  uint64_t offset = profiler->current * SLOT_BYTES;
+  uint64_t size = 2 * slot->pass_count * sizeof(uint64_t);
+  wgpuCommandEncoderResolveQuerySet(encoder, profiler->query_set,
+                                    profiler->current * SLOT_QUERIES,
+                                    2 * slot->pass_count,
+                                    profiler->resolve.buffer, offset);
+  wgpuCommandEncoderCopyBufferToBuffer(encoder, profiler->resolve.buffer,
+                                       offset, slot->readback.buffer, 0, size);
+}
+
+void radiant_gpu_profiler_end_frame(radiant_gpu_profiler_t* profiler) {
+  if (profiler->current == RADIANT_GPU_PROFILER_FRAMES) {
+    return;
+  }
+  radiant_gpu_profiler_slot_t* slot = &profiler->slots[profiler->current];
+  profiler->current = RADIANT_GPU_PROFILER_FRAMES;
+  if (slot->pass_count == 0) {
+    slot->state = radiant_gpu_profiler_slot_state_free;
+    return;
+  }
+  slot->state = radiant_gpu_profiler_slot_state_mapping;
+  wgpuBufferMapAsync(slot->readback.buffer, WGPUMapMode_Read, 0, SLOT_BYTES,
+                     map_callback, slot);
+}
+
+const radiant_gpu_profiler_pass_stats_t* radiant_gpu_profiler_find(
+    const radiant_gpu_profiler_t* profiler,
+    const char* name) {
+  for (uint32_t i = 0; i < profiler->pass_count; ++i) {
+    if (strcmp(profiler->passes[i].name, name) == 0) {
+      return &profiler->passes[i];
+    }
+  }
+  return NULL;
+}
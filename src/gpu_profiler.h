@@ -0,0 +1,177 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/buffer.h"
+#include "src/engine.h"
+#include "src/pad.h"
+#include "src/wgpu.h"
+
+/// The most passes timed in a frame.
+#define RADIANT_GPU_PROFILER_MAX_PASSES 16
+/// Frames of timestamps that can be waiting for readback at once. Frames
+/// begun while all are waiting go untimed rather than stalling.
+#define RADIANT_GPU_PROFILER_FRAMES 4
+/// Frames |average_ms| is taken over.
+#define RADIANT_GPU_PROFILER_HISTORY 32
+
+/// Timings of a pass, by name
+typedef struct radiant_gpu_profiler_pass_stats_t {
+  /// The name the pass was timed under
+  const char* name;
+  /// GPU milliseconds of the latest frame read back
+  double last_ms;
+  /// GPU milliseconds averaged over up to RADIANT_GPU_PROFILER_HISTORY frames
+  double average_ms;
+  /// @private
+  /// The latest timings, a ring starting at |next|
+  double history[RADIANT_GPU_PROFILER_HISTORY];
+  /// Frames read back, |history| holds the last of them
+  uint32_t samples;
+  /// @private
+  uint32_t next;
+} radiant_gpu_profiler_pass_stats_t;
+
+/// @private
+/// Where the timestamps of a frame are
+typedef enum radiant_gpu_profiler_slot_state_t {
+  /// Free for a frame to write
+  radiant_gpu_profiler_slot_state_free,
+  /// Passes are being timed
+  radiant_gpu_profiler_slot_state_recording,
+  /// Submitted, waiting for the readback buffer to map
+  radiant_gpu_profiler_slot_state_mapping,
+  /// The readback buffer is mapped, or failed to map, and can be read
+  radiant_gpu_profiler_slot_state_mapped,
+} radiant_gpu_profiler_slot_state_t;
+
+/// @private
+/// The timestamps of a frame
+typedef struct radiant_gpu_profiler_slot_t {
+  /// Holds the resolved timestamps, mapped to read them back
+  radiant_buffer_t readback;
+  /// The frame the timestamps are of, to read back frames in order
+  uint64_t frame;
+  radiant_gpu_profiler_slot_state_t state;
+  WGPUBufferMapAsyncStatus map_status;
+  /// Passes timed, query 2i and 2i + 1 bracket the pass |pass_ids[i]|
+  uint32_t pass_count;
+  uint32_t pass_ids[RADIANT_GPU_PROFILER_MAX_PASSES];
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_gpu_profiler_slot_t;
+
+/// Structure for requesting a GPU profiler
+typedef struct radiant_gpu_profiler_create_request_t {
+  /// The engine, timing only if it has the timestamp query feature
+  radiant_engine_t engine;
+} radiant_gpu_profiler_create_request_t;
+
+/// Times render and compute passes on the GPU with timestamp queries. The
+/// timestamps of a frame are resolved into a buffer and read back once the
+/// GPU is done with it, a few frames later, without waiting for it.
+///
+/// Note: buffer maps report back through the profiler's address, it must not
+/// move while frames are being read back.
+typedef struct radiant_gpu_profiler_t {
+  WGPUInstance instance;
+  /// NULL if timing is unavailable
+  WGPUQueue queue;
+  /// Two timestamps per pass for each slot, NULL if timing is unavailable
+  WGPUQuerySet query_set;
+  /// The timestamps of every slot, resolved before copying to its readback
+  radiant_buffer_t resolve;
+  radiant_gpu_profiler_slot_t slots[RADIANT_GPU_PROFILER_FRAMES];
+  /// The passes timed so far, in the order first seen
+  radiant_gpu_profiler_pass_stats_t passes[RADIANT_GPU_PROFILER_MAX_PASSES];
+  uint32_t pass_count;
+  /// Nanoseconds per timestamp tick
+  float period_ns;
+  /// Frames begun so far
+  uint64_t frame;
+  /// The slot of the frame being recorded, RADIANT_GPU_PROFILER_FRAMES if it
+  /// is not being timed
+  uint32_t current;
+  /// Frames that went untimed as every slot was waiting for readback
+  uint32_t skipped_frames;
+} radiant_gpu_profiler_t;
+
+/// Timestamp writes for a render pass descriptor
+typedef struct radiant_gpu_profiler_render_writes_t {
+  WGPURenderPassTimestampWrite writes[2];
+  /// The writes to use, zero when the pass is not timed
+  size_t count;
+} radiant_gpu_profiler_render_writes_t;
+
+/// Timestamp writes for a compute pass descriptor
+typedef struct radiant_gpu_profiler_compute_writes_t {
+  WGPUComputePassTimestampWrite writes[2];
+  /// The writes to use, zero when the pass is not timed
+  size_t count;
+} radiant_gpu_profiler_compute_writes_t;
+
+/// Creates a GPU profiler. It times nothing, but can be used as usual, if
+/// |req.engine| lacks the WGPUFeatureName_TimestampQuery feature; request it
+/// as an optional feature of the adapter selection.
+radiant_gpu_profiler_t radiant_gpu_profiler_create(
+    radiant_gpu_profiler_create_request_t req);
+
+/// Destroys |profiler|, dropping frames not yet read back.
+void radiant_gpu_profiler_destroy(radiant_gpu_profiler_t* profiler);
+
+/// Returns true if |profiler| can time passes.
+bool radiant_gpu_profiler_available(const radiant_gpu_profiler_t* profiler);
+
+/// Reads back the frames the GPU has finished, updating |profiler->passes|,
+/// and starts timing a new frame. Never blocks.
+void radiant_gpu_profiler_begin_frame(radiant_gpu_profiler_t* profiler);
+
+/// Returns the timestamp writes timing a render pass as |name|, which must
+/// outlive |profiler|. Set them as the |timestampWrites| and
+/// |timestampWriteCount| of its descriptor. Passes past
+/// RADIANT_GPU_PROFILER_MAX_PASSES go untimed.
+radiant_gpu_profiler_render_writes_t radiant_gpu_profiler_render_pass(
+    radiant_gpu_profiler_t* profiler,
+    const char* name);
+
+/// Returns the timestamp writes timing a compute pass as |name|, see
+/// radiant_gpu_profiler_render_pass.
+radiant_gpu_profiler_compute_writes_t radiant_gpu_profiler_compute_pass(
+    radiant_gpu_profiler_t* profiler,
+    const char* name);
+
+/// Records copying the frame's timestamps for readback into |encoder|, which
+/// must be submitted after every timed pass.
+void radiant_gpu_profiler_resolve(radiant_gpu_profiler_t* profiler,
+                                  WGPUCommandEncoder encoder);
+
+/// Ends the frame, call after submitting the encoder given to
+/// radiant_gpu_profiler_resolve.
+void radiant_gpu_profiler_end_frame(radiant_gpu_profiler_t* profiler);
+
+/// Returns the timings of the pass timed as |name|, or NULL if it has not
+/// been.
+const radiant_gpu_profiler_pass_stats_t* radiant_gpu_profiler_find(
+    const radiant_gpu_profiler_t* profiler,
+    const char* name);
+
+/// @private
+/// Adds |ms| to the timings of |stats|.
+void radiant_gpu_profiler_pass_stats_add(
+    radiant_gpu_profiler_pass_stats_t* stats,
+    double ms);
@@ -0,0 +1,151 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/gpu_profiler.h"
+
+#include <stdio.h>
+
+#include "src/test.h"
+
+/// Frames run before giving up on the GPU reporting timings.
+#define MAX_FRAMES 1000
+
+static radiant_engine_create_result_t create_engine(
+    radiant_adapter_features_t features) {
+  return radiant_engine_create_headless(
+      (radiant_engine_headless_create_request_t){
+          .adapter =
+              {
+                  .policy = radiant_adapter_policy_software,
+                  .requirements = {.optional_features = features},
+              },
+          .size = {.width = 16, .height = 16},
+          .format = WGPUTextureFormat_BGRA8Unorm,
+      });
+}
+
+/// Clears the target of |engine| in a pass timed by |profiler|.
+static void run_frame(radiant_engine_t engine,
+                      radiant_gpu_profiler_t* profiler) {
+  radiant_gpu_profiler_begin_frame(profiler);
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(engine.device, NULL);
+  radiant_gpu_profiler_render_writes_t timestamps =
+      radiant_gpu_profiler_render_pass(profiler, "Clear");
+  WGPURenderPassColorAttachment colour_attach = {
+      .view = radiant_engine_current_view(engine),
+      .loadOp = WGPULoadOp_Clear,
+      .storeOp = WGPUStoreOp_Store,
+  };
+  WGPURenderPassDescriptor pass_desc = {
+      .colorAttachmentCount = 1,
+      .colorAttachments = &colour_attach,
+      .timestampWriteCount = timestamps.count,
+      .timestampWrites = timestamps.writes,
+  };
+  WGPURenderPassEncoder pass =
+      wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
+  wgpuRenderPassEncoderEnd(pass);
+  wgpuRenderPassEncoderRelease(pass);
+
+  radiant_gpu_profiler_resolve(profiler, encoder);
+  WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, NULL);
+  wgpuCommandEncoderRelease(encoder);
+  WGPUQueue queue = wgpuDeviceGetQueue(engine.device);
+  wgpuQueueSubmit(queue, 1, &commands);
+  wgpuCommandBufferRelease(commands);
+  radiant_gpu_profiler_end_frame(profiler);
+}
+
+/// The average covers the last RADIANT_GPU_PROFILER_HISTORY timings.
+static bool rolling_average() {
+  radiant_gpu_profiler_pass_stats_t stats = {.name = "Pass"};
+  radiant_gpu_profiler_pass_stats_add(&stats, 2.0);
+  RADIANT_EXPECT_DOUBLE_EQ(stats.last_ms, 2.0);
+  RADIANT_EXPECT_DOUBLE_EQ(stats.average_ms, 2.0);
+  radiant_gpu_profiler_pass_stats_add(&stats, 4.0);
+  RADIANT_EXPECT_DOUBLE_EQ(stats.average_ms, 3.0);
+
+  for (uint32_t i = 0; i < RADIANT_GPU_PROFILER_HISTORY; ++i) {
+    radiant_gpu_profiler_pass_stats_add(&stats, 1.0);
+  }
+  RADIANT_EXPECT_EQ(stats.samples, RADIANT_GPU_PROFILER_HISTORY + 2);
+  RADIANT_EXPECT_DOUBLE_EQ(stats.last_ms, 1.0);
+  RADIANT_EXPECT_DOUBLE_EQ(stats.average_ms, 1.0);
+  return true;
+}
+
+/// Without timestamp queries passes go untimed, but frames still run.
+static bool unavailable() {
+  radiant_engine_create_result_t result = create_engine(0);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_gpu_profiler_t profiler = radiant_gpu_profiler_create(
+      (radiant_gpu_profiler_create_request_t){.engine = result.engine});
+  RADIANT_EXPECT_FALSE(radiant_gpu_profiler_available(&profiler));
+
+  for (uint32_t i = 0; i < RADIANT_GPU_PROFILER_FRAMES * 2; ++i) {
+    run_frame(result.engine, &profiler);
+  }
+  RADIANT_EXPECT_EQ(profiler.pass_count, 0);
+  RADIANT_EXPECT_TRUE(radiant_gpu_profiler_find(&profiler, "Clear") == NULL);
+  radiant_gpu_profiler_destroy(&profiler);
+  radiant_engine_destroy(result.engine);
+  return true;
+}
+
+/// Timed passes are read back a few frames later.
+static bool times_passes() {
+  radiant_engine_create_result_t result =
+      create_engine(RADIANT_ADAPTER_FEATURE(WGPUFeatureName_TimestampQuery));
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_gpu_profiler_t profiler = radiant_gpu_profiler_create(
+      (radiant_gpu_profiler_create_request_t){.engine = result.engine});
+  if (!radiant_gpu_profiler_available(&profiler)) {
+    printf("No timestamp queries, skipping ... ");
+    radiant_engine_destroy(result.engine);
+    return true;
+  }
+
+  const radiant_gpu_profiler_pass_stats_t* stats = NULL;
+  for (uint32_t i = 0; i < MAX_FRAMES; ++i) {
+    run_frame(result.engine, &profiler);
+    stats = radiant_gpu_profiler_find(&profiler, "Clear");
+    if (stats && stats->samples > 0) {
+      break;
+    }
+  }
+  RADIANT_EXPECT_TRUE(stats != NULL);
+  RADIANT_EXPECT_TRUE(stats->samples > 0);
+  RADIANT_EXPECT_TRUE(stats->last_ms >= 0.0);
+  RADIANT_EXPECT_EQ(profiler.pass_count, 1);
+  radiant_gpu_profiler_destroy(&profiler);
+  radiant_engine_destroy(result.engine);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("gpu_profiler");
+  RADIANT_TEST(rolling_average);
+
+  radiant_engine_create_result_t probe = create_engine(0);
+  if (!probe.succeeded) {
+    printf("No software adapter, skipping\n");
+    return radiant_suite_end();
+  }
+  radiant_engine_destroy(probe.engine);
+
+  RADIANT_TEST(unavailable);
+  RADIANT_TEST(times_passes);
+  return radiant_suite_end();
+}
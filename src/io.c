@@ -35,6 +35,20 @@ radiant_file_result_t radiant_file_open(const char* path) {
                                  }};
 }
 
+radiant_file_result_t radiant_file_create(const char* path) {
+  RADIANT_ASSERT(path);
+
+  FILE* file = fopen(path, "w+");
+  if (!file) {
+    return (radiant_file_result_t){0};
+  }
+  return (radiant_file_result_t){.succeeded = true,
+                                 .file = (radiant_file_t){
+                                     .open = true,
+                                     .handle = (uint64_t)file,
+                                 }};
+}
+
 radiant_file_result_t radiant_file_mem_open(void* buf, uint32_t len) {
   RADIANT_ASSERT(buf);
   RADIANT_ASSERT(len > 0);
@@ -43,6 +43,11 @@ typedef struct radiant_file_result_t {
 /// Note: |path| must not be a nullptr.
 radiant_file_result_t radiant_file_open(const char* path);
 
+/// Returns the result of creating the file at |path| for writing, emptying it
+/// if it exists.
+/// Note: |path| must not be a nullptr.
+radiant_file_result_t radiant_file_create(const char* path);
+
 /// Returns the result of opening |buf| of |len| as a file stream.
 /// Note: |buf| must not be a nullptr. |len| must be greater then 0.
 radiant_file_result_t radiant_file_mem_open(void* buf, uint32_t len);
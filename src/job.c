@@ -0,0 +1,231 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/job.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "src/assert.h"
+#include "src/pad.h"
+
+/// Upper bound on the threads a parallel for runs on, the pool has one fewer
+/// as the calling thread is one of them.
+#define MAX_THREADS 256
+
+/// A parallel for, on the stack of its caller. Queued in the pool while
+/// workers may still join it.
+typedef struct job_t {
+  radiant_job_fn_t fn;
+  void* userdata;
+  /// The next job in the queue
+  struct job_t* next_job;
+  /// The next index to run
+  atomic_uint_fast32_t next;
+  uint32_t count;
+  /// Workers that may still join, guarded by the pool mutex
+  uint32_t open_slots;
+  /// Workers running the job, guarded by the pool mutex
+  uint32_t running;
+  /// Unused padding
+  RADIANT_PAD(4);
+} job_t;
+
+/// The worker threads every parallel for shares, started on first use and
+/// kept for the life of the process.
+typedef struct pool_t {
+  pthread_mutex_t mutex;
+  /// Signalled when a job is queued
+  pthread_cond_t queued;
+  /// Signalled when a worker leaves a job
+  pthread_cond_t left;
+  /// Jobs workers may join, oldest first
+  job_t* head;
+  job_t* tail;
+  uint32_t worker_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} pool_t;
+
+static pool_t pool = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .queued = PTHREAD_COND_INITIALIZER,
+    .left = PTHREAD_COND_INITIALIZER,
+};
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+static void run(job_t* job) {
+  for (;;) {
+    uint_fast32_t idx =
+        atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+    if (idx >= job->count) {
+      return;
+    }
+    job->fn(job->userdata, (uint32_t)idx);
+  }
+}
+
+/// Takes |job| out of the queue if it is still there. Requires the mutex.
+static void dequeue(job_t* job) {
+  job_t* prev = NULL;
+  for (job_t* j = pool.head; j; prev = j, j = j->next_job) {
+    if (j != job) {
+      continue;
+    }
+    if (prev) {
+      prev->next_job = job->next_job;
+    } else {
+      pool.head = job->next_job;
+    }
+    if (pool.tail == job) {
+      pool.tail = prev;
+    }
+    job->next_job = NULL;
+    return;
+  }
+}
+
+static void* work(void* /* arg */) {
+  pthread_mutex_lock(&pool.mutex);
+  for (;;) {
+    while (!pool.head) {
+      pthread_cond_wait(&pool.queued, &pool.mutex);
+    }
+    job_t* job = pool.head;
+    ++job->running;
+    if (--job->open_slots == 0) {
+      dequeue(job);
+    }
+    pthread_mutex_unlock(&pool.mutex);
+
+    run(job);
+
+    pthread_mutex_lock(&pool.mutex);
+    // Every index is taken, later workers have nothing to join.
+    dequeue(job);
+    if (--job->running == 0) {
+      pthread_cond_broadcast(&pool.left);
+    }
+  }
+  return NULL;
+}
+
+static void start_pool(void) {
+  uint32_t count = radiant_job_processor_count() - 1;
+  if (count > MAX_THREADS - 1) {
+    count = MAX_THREADS - 1;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, work, NULL) != 0) {
+      break;
+    }
+    pthread_detach(thread);
+    ++pool.worker_count;
+  }
+}
+
+uint32_t radiant_job_processor_count(void) {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (uint32_t)count : 1;
+}
+
+void radiant_job_parallel_for(uint32_t count,
+                              uint32_t thread_count,
+                              radiant_job_fn_t fn,
+                              void* userdata) {
+  RADIANT_ASSERT(fn);
+  pthread_once(&pool_once, start_pool);
+  if (thread_count == 0 || thread_count > pool.worker_count + 1) {
+    thread_count = pool.worker_count + 1;
+  }
+  if (thread_count > count) {
+    thread_count = count;
+  }
+
+  job_t job = {
+      .fn = fn,
+      .userdata = userdata,
+      .count = count,
+      .open_slots = thread_count > 1 ? thread_count - 1 : 0,
+  };
+  atomic_init(&job.next, 0);
+
+  bool queued = job.open_slots > 0;
+  if (queued) {
+    pthread_mutex_lock(&pool.mutex);
+    if (pool.tail) {
+      pool.tail->next_job = &job;
+    } else {
+      pool.head = &job;
+    }
+    pool.tail = &job;
+    for (uint32_t i = 0; i < job.open_slots; ++i) {
+      pthread_cond_signal(&pool.queued);
+    }
+    pthread_mutex_unlock(&pool.mutex);
+  }
+
+  // The calling thread is one of the workers. It always runs its own job, so
+  // a parallel for nested in another finishes even with every worker busy.
+  run(&job);
+
+  if (queued) {
+    pthread_mutex_lock(&pool.mutex);
+    dequeue(&job);
+    while (job.running > 0) {
+      pthread_cond_wait(&pool.left, &pool.mutex);
+    }
+    pthread_mutex_unlock(&pool.mutex);
+  }
+}
+
+typedef struct task_t {
+  pthread_t thread;
+  radiant_job_task_fn_t fn;
+  void* userdata;
+} task_t;
+
+static void* run_task(void* arg) {
+  task_t* task = (task_t*)arg;
+  task->fn(task->userdata);
+  return NULL;
+}
+
+radiant_job_future_t radiant_job_async(radiant_job_task_fn_t fn,
+                                       void* userdata) {
+  RADIANT_ASSERT(fn);
+  task_t* task = (task_t*)malloc(sizeof(task_t));
+  if (task) {
+    task->fn = fn;
+    task->userdata = userdata;
+    if (pthread_create(&task->thread, NULL, run_task, task) == 0) {
+      return (radiant_job_future_t){.thread = task};
+    }
+    free(task);
+  }
+  fn(userdata);
+  return (radiant_job_future_t){0};
+}
+
+void radiant_job_wait(radiant_job_future_t future) {
+  task_t* task = (task_t*)future.thread;
+  if (!task) {
+    return;
+  }
+  pthread_join(task->thread, NULL);
+  free(task);
+}
@@ -0,0 +1,60 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// The function run for each index of a radiant_job_parallel_for. |userdata|
+/// is passed through unchanged.
+typedef void (*radiant_job_fn_t)(void* userdata, uint32_t index);
+
+/// The function run by radiant_job_async. |userdata| is passed through
+/// unchanged.
+typedef void (*radiant_job_task_fn_t)(void* userdata);
+
+/// A task started by radiant_job_async. Must be waited on exactly once.
+typedef struct radiant_job_future_t {
+  /// Opaque thread handle, NULL if the task already ran on the caller
+  void* thread;
+} radiant_job_future_t;
+
+/// Returns the number of processors available to run jobs, at least one.
+uint32_t radiant_job_processor_count(void);
+
+/// Calls |fn| for each index in [0, |count|) spread over |thread_count|
+/// threads, including the calling thread, and returns once every call has
+/// finished. Indices are handed out in increasing order as threads become
+/// free, so put the largest pieces of work first.
+///
+/// The other threads come from a pool of radiant_job_processor_count() - 1
+/// workers started on the first call and kept for the life of the process.
+/// A |thread_count| of zero, or more than the pool holds, uses every worker.
+/// Workers busy with other calls join once free, and if none are the calling
+/// thread runs every index, so calls may nest and run from several threads.
+void radiant_job_parallel_for(uint32_t count,
+                              uint32_t thread_count,
+                              radiant_job_fn_t fn,
+                              void* userdata);
+
+/// Starts calling |fn| with |userdata| on a new thread and returns at once.
+/// Anything |fn| writes through |userdata| is visible to the caller after
+/// radiant_job_wait. If a thread cannot be started |fn| runs on the calling
+/// thread before returning.
+radiant_job_future_t radiant_job_async(radiant_job_task_fn_t fn,
+                                       void* userdata);
+
+/// Blocks until the task of |future| has finished.
+void radiant_job_wait(radiant_job_future_t future);
@@ -0,0 +1,134 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/job.h"
+
+#include <stdatomic.h>
+
+#include "src/test.h"
+
+#define COUNT 1000
+
+typedef struct counts_t {
+  atomic_uint calls[COUNT];
+} counts_t;
+
+static void count_call(void* userdata, uint32_t index) {
+  counts_t* counts = (counts_t*)userdata;
+  atomic_fetch_add(&counts->calls[index], 1);
+}
+
+static bool runs_each_index_once(uint32_t count, uint32_t thread_count) {
+  static counts_t counts;
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    atomic_init(&counts.calls[i], 0);
+  }
+  radiant_job_parallel_for(count, thread_count, count_call, &counts);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    RADIANT_EXPECT_EQ(atomic_load(&counts.calls[i]), i < count ? 1u : 0u);
+  }
+  return true;
+}
+
+static bool processor_count() {
+  RADIANT_EXPECT_TRUE(radiant_job_processor_count() >= 1);
+  return true;
+}
+
+static bool parallel_for() {
+  RADIANT_EXPECT_TRUE(runs_each_index_once(COUNT, 0));
+  RADIANT_EXPECT_TRUE(runs_each_index_once(COUNT, 1));
+  RADIANT_EXPECT_TRUE(runs_each_index_once(COUNT, 7));
+  // More threads than work, and no work at all.
+  RADIANT_EXPECT_TRUE(runs_each_index_once(3, 16));
+  RADIANT_EXPECT_TRUE(runs_each_index_once(0, 4));
+  return true;
+}
+
+#define NESTED 8
+
+static void count_nested_call(void* userdata, uint32_t index) {
+  atomic_uint* calls = (atomic_uint*)userdata;
+  atomic_fetch_add(&calls[index], 1);
+}
+
+static void nested_call(void* userdata, uint32_t index) {
+  counts_t* counts = (counts_t*)userdata;
+  radiant_job_parallel_for(NESTED, 0, count_nested_call,
+                           &counts->calls[index * NESTED]);
+}
+
+/// Calls made from within a call run every index, even with every worker
+/// busy with the outer one.
+static bool nested() {
+  static counts_t counts;
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    atomic_init(&counts.calls[i], 0);
+  }
+  radiant_job_parallel_for(COUNT / NESTED, 0, nested_call, &counts);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    RADIANT_EXPECT_EQ(atomic_load(&counts.calls[i]), 1u);
+  }
+  return true;
+}
+
+static void run_parallel_for(void* userdata) {
+  radiant_job_parallel_for(COUNT, 0, count_call, userdata);
+}
+
+/// Calls from several threads at once share the workers.
+static bool concurrent() {
+  static counts_t counts[4];
+  radiant_job_future_t futures[4];
+  for (uint32_t t = 0; t < 4; ++t) {
+    for (uint32_t i = 0; i < COUNT; ++i) {
+      atomic_init(&counts[t].calls[i], 0);
+    }
+    futures[t] = radiant_job_async(run_parallel_for, &counts[t]);
+  }
+  for (uint32_t t = 0; t < 4; ++t) {
+    radiant_job_wait(futures[t]);
+    for (uint32_t i = 0; i < COUNT; ++i) {
+      RADIANT_EXPECT_EQ(atomic_load(&counts[t].calls[i]), 1u);
+    }
+  }
+  return true;
+}
+
+static void set_flag(void* userdata) {
+  *(bool*)userdata = true;
+}
+
+static bool async_wait() {
+  bool flags[8] = {false};
+  radiant_job_future_t futures[8];
+  for (uint32_t i = 0; i < 8; ++i) {
+    futures[i] = radiant_job_async(set_flag, &flags[i]);
+  }
+  for (uint32_t i = 0; i < 8; ++i) {
+    radiant_job_wait(futures[i]);
+    RADIANT_EXPECT_TRUE(flags[i]);
+  }
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("job");
+  RADIANT_TEST(processor_count);
+  RADIANT_TEST(parallel_for);
+  RADIANT_TEST(nested);
+  RADIANT_TEST(concurrent);
+  RADIANT_TEST(async_wait);
+  return radiant_suite_end();
+}
@@ -0,0 +1,69 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mat3x3.h"
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+radiant_mat3x3_t radiant_mat3x3_identity(void) {
+  return (radiant_mat3x3_t){
+      // clang-format off
+      .data = {
+          1.f, 0.f, 0.f, 0.f,
+          0.f, 1.f, 0.f, 0.f,
+          0.f, 0.f, 1.f, 0.f,
+      },
+      // clang-format on
+  };
+}
+
+radiant_mat3x3_t radiant_mat3x3_from_mat4x4(radiant_mat4x4_t m) {
+  return (radiant_mat3x3_t){
+      // clang-format off
+      .data = {
+          m.data[0], m.data[1], m.data[2], 0.f,
+          m.data[4], m.data[5], m.data[6], 0.f,
+          m.data[8], m.data[9], m.data[10], 0.f,
+      },
+      // clang-format on
+  };
+}
+
+radiant_vec3_t radiant_mat3x3_mul_vec3(radiant_mat3x3_t m, radiant_vec3_t v) {
+  const float* d = m.data;
+  return (radiant_vec3_t){
+      .x = (d[0] * v.x) + (d[4] * v.y) + (d[8] * v.z),
+      .y = (d[1] * v.x) + (d[5] * v.y) + (d[9] * v.z),
+      .z = (d[2] * v.x) + (d[6] * v.y) + (d[10] * v.z),
+  };
+}
+
+radiant_mat3x3_t radiant_mat3x3_normal_matrix(radiant_mat4x4_t model) {
+  radiant_mat3x3_t r;
+  radiant_simd_ops()->normal_matrix_batch(&r, &model, 1);
+  return r;
+}
+
+void radiant_mat3x3_normal_matrix_batch(const radiant_mat4x4_t* models,
+                                        radiant_mat3x3_t* out,
+                                        uint32_t begin,
+                                        uint32_t end) {
+  RADIANT_ASSERT(begin <= end);
+  if (begin == end) {
+    return;
+  }
+  radiant_simd_ops()->normal_matrix_batch(out + begin, models + begin,
+                                          end - begin);
+}
@@ -0,0 +1,57 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/mat4x4.h"
+#include "src/vec3.h"
+
+/// A 3x3 matrix in column-major order. Each column is padded to 4 floats so
+/// the layout matches mat3x3f in WGSL buffers.
+typedef struct radiant_mat3x3_t {
+  /// Matrix data.
+  ///
+  /// | a b c |
+  /// | d e f |
+  /// | g h i |
+  ///
+  /// Stored as:
+  /// [a d g 0 b e h 0 c f i 0]
+  ///
+  float data[12];
+} radiant_mat3x3_t;
+
+/// Returns the identity matrix.
+radiant_mat3x3_t radiant_mat3x3_identity(void);
+
+/// Returns the upper left 3x3 of |m|.
+radiant_mat3x3_t radiant_mat3x3_from_mat4x4(radiant_mat4x4_t m);
+
+/// Returns |m| * |v|
+radiant_vec3_t radiant_mat3x3_mul_vec3(radiant_mat3x3_t m, radiant_vec3_t v);
+
+/// Returns the normal matrix for |model|, the inverse transpose of its upper
+/// 3x3. If that is singular the cofactor matrix is returned instead, which
+/// still maps normals to the right direction but not the right length.
+radiant_mat3x3_t radiant_mat3x3_normal_matrix(radiant_mat4x4_t model);
+
+/// Stores radiant_mat3x3_normal_matrix(|models|[i]) into |out|[i] for each i
+/// in [|begin|, |end|). As with radiant_mvp_compute, calls over disjoint
+/// ranges may run on different threads.
+void radiant_mat3x3_normal_matrix_batch(const radiant_mat4x4_t* models,
+                                        radiant_mat3x3_t* out,
+                                        uint32_t begin,
+                                        uint32_t end);
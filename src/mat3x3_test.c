@@ -0,0 +1,96 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mat3x3.h"
+
+#include "src/test.h"
+
+/// Not a multiple of any vector width.
+#define COUNT 11
+
+static bool identity() {
+  radiant_mat3x3_t m = radiant_mat3x3_identity();
+  radiant_vec3_t v =
+      radiant_mat3x3_mul_vec3(m, (radiant_vec3_t){1.f, 2.f, 3.f});
+  RADIANT_EXPECT_FLOAT_EQ(v.x, 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(v.y, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(v.z, 3.f);
+  RADIANT_EXPECT_EQ((uint32_t)sizeof(radiant_mat3x3_t), 48u);
+  return true;
+}
+
+static bool from_mat4x4() {
+  radiant_mat4x4_t m =
+      radiant_mat4x4_rotate((radiant_point3_t){0.3f, 0.f, 1.f});
+  radiant_vec3_t v = {1.f, -2.f, 0.5f};
+  radiant_vec3_t e = radiant_mat4x4_mul(m, v);
+  radiant_vec3_t r = radiant_mat3x3_mul_vec3(radiant_mat3x3_from_mat4x4(m), v);
+  RADIANT_EXPECT_FLOAT_EQ(e.x, r.x);
+  RADIANT_EXPECT_FLOAT_EQ(e.y, r.y);
+  RADIANT_EXPECT_FLOAT_EQ(e.z, r.z);
+  return true;
+}
+
+static radiant_mat4x4_t model(uint32_t i) {
+  float f = (float)i;
+  return radiant_mat4x4_mul(
+      radiant_mat4x4_translate((radiant_vec3_t){f, 1.f, -f}),
+      radiant_mat4x4_mul(
+          radiant_mat4x4_rotate((radiant_point3_t){f * 0.3f, f * 0.7f, 0.2f}),
+          radiant_mat4x4_scale(1.f + f, 2.f, 0.5f)));
+}
+
+static bool normal_matrix() {
+  radiant_mat4x4_t models[COUNT];
+  radiant_mat3x3_t normals[COUNT];
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    models[i] = model(i);
+  }
+  radiant_mat3x3_normal_matrix_batch(models, normals, 0, 4);
+  radiant_mat3x3_normal_matrix_batch(models, normals, 4, COUNT);
+
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_mat4x4_inverse_result_t inv = radiant_mat4x4_inverse(models[i]);
+    RADIANT_EXPECT_TRUE(inv.succeeded);
+    radiant_mat3x3_t expected =
+        radiant_mat3x3_from_mat4x4(radiant_mat4x4_transpose(inv.inverse));
+
+    radiant_mat3x3_t single = radiant_mat3x3_normal_matrix(models[i]);
+    for (uint32_t j = 0; j < 12; ++j) {
+      RADIANT_EXPECT_FLOAT_EQ(expected.data[j], normals[i].data[j]);
+      RADIANT_EXPECT_FLOAT_EQ(expected.data[j], single.data[j]);
+    }
+  }
+  return true;
+}
+
+static bool normal_matrix_singular() {
+  radiant_mat3x3_t n =
+      radiant_mat3x3_normal_matrix(radiant_mat4x4_scale(2.f, 3.f, 0.f));
+  // Only the z column survives, and it is not scaled by the determinant.
+  for (uint32_t j = 0; j < 8; ++j) {
+    RADIANT_EXPECT_FLOAT_EQ(n.data[j], 0.f);
+  }
+  RADIANT_EXPECT_FLOAT_EQ(n.data[10], 6.f);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("mat3x3");
+  RADIANT_TEST(identity);
+  RADIANT_TEST(from_mat4x4);
+  RADIANT_TEST_ALL_BACKENDS(normal_matrix);
+  RADIANT_TEST_ALL_BACKENDS(normal_matrix_singular);
+  return radiant_suite_end();
+}
@@ -16,7 +16,11 @@
 
 #include <math.h>
 
+#include "src/angle.h"
 #include "src/equal.h"
+#include "src/quat.h"
+#include "src/simd.h"
+#include "src/vec4.h"
 
 radiant_mat4x4_t radiant_mat4x4_identity(void) {
   return (radiant_mat4x4_t){
@@ -75,33 +79,36 @@ radiant_mat4x4_t radiant_mat4x4_perspective(float fov_y_radians,
   };
 }
 
-radiant_mat4x4_t radiant_mat4x4_rotate(radiant_point3_t angles_in_radians) {
-  // TODO(dsinclair): Do this is a single matrix instead of multiplying
-  radiant_mat4x4_t rot_x = radiant_mat4x4_identity();
-  radiant_mat4x4_t rot_y = radiant_mat4x4_identity();
-  radiant_mat4x4_t rot_z = radiant_mat4x4_identity();
+radiant_mat4x4_t radiant_mat4x4_perspective_reverse_z_infinite(
+    float fov_y_radians,
+    float aspect,
+    float near) {
+  float tan_half_fov_y = 1.f / tanf(fov_y_radians / 2);
 
-  if (angles_in_radians.x != 0.f) {
-    rot_x = radiant_mat4x4_rotate_x(angles_in_radians.x);
-  }
-  if (angles_in_radians.y != 0.f) {
-    rot_y = radiant_mat4x4_rotate_y(angles_in_radians.y);
-  }
-  if (angles_in_radians.z != 0.f) {
-    rot_z = radiant_mat4x4_rotate_z(angles_in_radians.x);
-  }
+  return (radiant_mat4x4_t){
+      // clang-format off
+      .data = {
+          tan_half_fov_y / aspect, 0.f, 0.f, 0.f,
+          0.f, tan_half_fov_y, 0.f, 0.f,
+          0.f, 0.f, 0.f, -1.f,
+          0.f, 0.f, near, 0.f,
+      },
+      // clang-format on
+  };
+}
 
-  radiant_mat4x4_t rot_yz = radiant_mat4x4_mul(rot_y, rot_z);
-  return radiant_mat4x4_mul(rot_x, rot_yz);
+radiant_mat4x4_t radiant_mat4x4_rotate(radiant_point3_t angles_in_radians) {
+  return radiant_quat_to_mat4x4(radiant_quat_from_euler(angles_in_radians));
 }
 
 radiant_mat4x4_t radiant_mat4x4_rotate_x(float angle_radians) {
+  radiant_sincos_t sc = radiant_sincos(angle_radians);
   return (radiant_mat4x4_t){
       // clang-format off
       .data = {
           1.f, 0.f, 0.f, 0.f,
-          0.f, cosf(angle_radians), sinf(angle_radians), 0.f,
-          0.f, -sinf(angle_radians), cosf(angle_radians), 0.f,
+          0.f, sc.cos, sc.sin, 0.f,
+          0.f, -sc.sin, sc.cos, 0.f,
           0.f, 0.f, 0.f, 1.f,
       },
       // clang-format on
@@ -109,12 +116,13 @@ radiant_mat4x4_t radiant_mat4x4_rotate_x(float angle_radians) {
 }
 
 radiant_mat4x4_t radiant_mat4x4_rotate_y(float angle_radians) {
+  radiant_sincos_t sc = radiant_sincos(angle_radians);
   return (radiant_mat4x4_t){
       // clang-format off
       .data = {
-          cosf(angle_radians), 0.f, -sinf(angle_radians), 0.f,
+          sc.cos, 0.f, -sc.sin, 0.f,
           0.f, 1.f, 0.f, 0.f,
-          sinf(angle_radians), 0.f, cosf(angle_radians), 0.f,
+          sc.sin, 0.f, sc.cos, 0.f,
           0.f, 0.f, 0.f, 1.f,
       },
       // clang-format on
@@ -122,11 +130,12 @@ radiant_mat4x4_t radiant_mat4x4_rotate_y(float angle_radians) {
 }
 
 radiant_mat4x4_t radiant_mat4x4_rotate_z(float angle_radians) {
+  radiant_sincos_t sc = radiant_sincos(angle_radians);
   return (radiant_mat4x4_t){
       // clang-format off
       .data = {
-          cosf(angle_radians), sinf(angle_radians), 0.f, 0.f,
-          -sinf(angle_radians), cosf(angle_radians), 0.f, 0.f,
+          sc.cos, sc.sin, 0.f, 0.f,
+          -sc.sin, sc.cos, 0.f, 0.f,
           0.f, 0.f, 1.f, 0.f,
           0.f, 0.f, 0.f, 1.f,
       },
@@ -151,61 +160,52 @@ radiant_mat4x4_t radiant_mat4x4_scale(float x, float y, float z) {
 }
 
 radiant_mat4x4_t radiant_mat4x4_transpose(radiant_mat4x4_t m) {
-  // clang-format off
-    return (radiant_mat4x4_t){
-      .data = {
-        m.data[0], m.data[4], m.data[8], m.data[12],
-        m.data[1], m.data[5], m.data[9], m.data[13],
-        m.data[2], m.data[6], m.data[10], m.data[14],
-        m.data[3], m.data[7], m.data[11], m.data[15],
-      }
-    };
-  // clang-format on
+  radiant_mat4x4_t r;
+  radiant_simd_ops()->mat4x4_transpose(&r, &m);
+  return r;
+}
+
+radiant_mat4x4_inverse_result_t radiant_mat4x4_inverse(radiant_mat4x4_t m) {
+  radiant_mat4x4_inverse_result_t result = {0};
+  result.succeeded = radiant_simd_ops()->mat4x4_inverse(&result.inverse, &m);
+  return result;
 }
 
 radiant_mat4x4_t radiant_mat4x4_mul_mat4x4(radiant_mat4x4_t m,
                                            radiant_mat4x4_t b) {
-  radiant_mat4x4_t r = radiant_mat4x4_identity();
-  for (uint32_t i = 0; i < 4; ++i) {
-    for (uint32_t j = 0; j < 4; ++j) {
-      uint32_t row = j * 4;
-      r.data[i + (j * 4)] = (m.data[i + 0] * b.data[row + 0]) +
-                            (m.data[i + 4] * b.data[row + 1]) +
-                            (m.data[i + 8] * b.data[row + 2]) +
-                            (m.data[i + 12] * b.data[row + 3]);
-    }
-  }
+  radiant_mat4x4_t r;
+  radiant_simd_ops()->mat4x4_mul(&r, &m, &b);
   return r;
 }
 
 radiant_point3_t radiant_mat4x4_mul_point3(radiant_mat4x4_t m,
                                            radiant_point3_t p) {
-  float x = m.data[0] * p.x + m.data[4] * p.y + m.data[8] * p.z + m.data[12];
-  float y = m.data[1] * p.x + m.data[5] * p.y + m.data[9] * p.z + m.data[13];
-  float z = m.data[2] * p.x + m.data[6] * p.y + m.data[10] * p.z + m.data[14];
-  float w = m.data[3] * p.x + m.data[7] * p.y + m.data[11] * p.z + m.data[15];
+  radiant_vec4_t v = {p.x, p.y, p.z, 1.f};
+  radiant_simd_ops()->mat4x4_mul_vec4(&v, &m, &v);
 
-  if (radiant_equal(w, 1.0f)) {
+  if (radiant_equal(v.w, 1.0f)) {
     return (radiant_point3_t){
-        .x = x,
-        .y = y,
-        .z = z,
+        .x = v.x,
+        .y = v.y,
+        .z = v.z,
     };
   }
 
-  float inv = 1.f / w;
+  float inv = 1.f / v.w;
   return (radiant_point3_t){
-      .x = x * inv,
-      .y = y * inv,
-      .z = z * inv,
+      .x = v.x * inv,
+      .y = v.y * inv,
+      .z = v.z * inv,
   };
 }
 
 radiant_vec3_t radiant_mat4x4_mul_vec3(radiant_mat4x4_t m, radiant_vec3_t v) {
+  radiant_vec4_t r = {v.x, v.y, v.z, 0.f};
+  radiant_simd_ops()->mat4x4_mul_vec4(&r, &m, &r);
   return (radiant_vec3_t){
-      .x = m.data[0] * v.x + m.data[4] * v.y + m.data[8] * v.z,
-      .y = m.data[1] * v.x + m.data[5] * v.y + m.data[9] * v.z,
-      .z = m.data[2] * v.x + m.data[6] * v.y + m.data[10] * v.z,
+      .x = r.x,
+      .y = r.y,
+      .z = r.z,
   };
 }
 
@@ -14,8 +14,10 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "src/pad.h"
 #include "src/point3.h"
 #include "src/vec3.h"
 
@@ -49,7 +51,19 @@ radiant_mat4x4_t radiant_mat4x4_perspective(float fov_y_radians,
                                             float near,
                                             float far);
 
-/// Returns the matrix to rotate around the given axis
+/// Returns the reverse-Z perspective matrix with a field of view
+/// |fov_y_radians| and |aspect| ratio, and no far plane. Clip space depth
+/// goes from 1 at the |near| plane to 0 at infinity, which spreads float
+/// depth precision evenly over distance. Clear depth to 0 and draw with a
+/// greater depth test.
+radiant_mat4x4_t radiant_mat4x4_perspective_reverse_z_infinite(
+    float fov_y_radians,
+    float aspect,
+    float near);
+
+/// Returns the matrix to rotate around the X, Y and Z axes by
+/// |angles_in_radians|, equal to rotate_x * rotate_y * rotate_z. Prefer
+/// radiant_quat_t when composing or interpolating rotations.
 radiant_mat4x4_t radiant_mat4x4_rotate(radiant_point3_t angles_in_radians);
 
 /// Returns the matrix to rotate around the X axis by |angle_radians|.
@@ -70,6 +84,21 @@ radiant_mat4x4_t radiant_mat4x4_scale(float x, float y, float z);
 /// Returns the transpose of |m|
 radiant_mat4x4_t radiant_mat4x4_transpose(radiant_mat4x4_t m);
 
+/// The result of inverting a matrix.
+typedef struct radiant_mat4x4_inverse_result_t {
+  /// The inverse. Only valid if |succeeded| is true.
+  radiant_mat4x4_t inverse;
+  /// True if the matrix was invertible. False if it is singular.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(3);
+} radiant_mat4x4_inverse_result_t;
+
+/// Returns the inverse of |m|. Fails if |m| is singular, or so close to it
+/// that 1 / determinant overflows. Prefer radiant_affine_inverse when |m| is
+/// known to be affine.
+radiant_mat4x4_inverse_result_t radiant_mat4x4_inverse(radiant_mat4x4_t m);
+
 /// Returns |A| * |B|
 #define radiant_mat4x4_mul(A, B)                   \
   _Generic((B),                                    \
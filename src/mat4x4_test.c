@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "src/mat4x4.h"
+
+#include <math.h>
+
 #include "src/constants.h"
 #include "src/test.h"
 
@@ -95,6 +98,27 @@ static bool perspective() {
   return true;
 }
 
+static bool perspective_reverse_z_infinite() {
+  radiant_mat4x4_t m = radiant_mat4x4_perspective_reverse_z_infinite(
+      45.0f * (RADIANT_PI / 180.f), 640.f / 480.f, 0.1f);
+  RADIANT_EXPECT_FLOAT_EQ(1.81066f, radiant_mat4x4_get(m, 0));
+  RADIANT_EXPECT_FLOAT_EQ(2.414213f, radiant_mat4x4_get(m, 5));
+
+  // Depth is 1 at the near plane and falls towards 0 with distance.
+  radiant_point3_t near =
+      radiant_mat4x4_mul_point3(m, (radiant_point3_t){0.f, 0.f, -0.1f});
+  RADIANT_EXPECT_FLOAT_EQ(near.z, 1.f);
+  radiant_point3_t mid =
+      radiant_mat4x4_mul_point3(m, (radiant_point3_t){0.f, 0.f, -0.2f});
+  RADIANT_EXPECT_FLOAT_EQ(mid.z, 0.5f);
+  radiant_point3_t far =
+      radiant_mat4x4_mul_point3(m, (radiant_point3_t){0.f, 0.f, -1e6f});
+  RADIANT_EXPECT_TRUE(far.z > 0.f);
+  RADIANT_EXPECT_TRUE(far.z < 1e-6f);
+  RADIANT_EXPECT_TRUE(radiant_mat4x4_inverse(m).succeeded);
+  return true;
+}
+
 static bool rotate_x() {
   radiant_mat4x4_t m = radiant_mat4x4_rotate_x(45.0f);
 
@@ -170,6 +194,21 @@ static bool rotate_z() {
   return true;
 }
 
+static bool rotate() {
+  radiant_mat4x4_t m =
+      radiant_mat4x4_rotate((radiant_point3_t){0.3f, -1.2f, 2.f});
+  radiant_mat4x4_t expected = radiant_mat4x4_mul(
+      radiant_mat4x4_rotate_x(0.3f),
+      radiant_mat4x4_mul(radiant_mat4x4_rotate_y(-1.2f),
+                         radiant_mat4x4_rotate_z(2.f)));
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    RADIANT_EXPECT_FLOAT_EQ(radiant_mat4x4_get(expected, i),
+                            radiant_mat4x4_get(m, i));
+  }
+  return true;
+}
+
 static bool transpose() {
   radiant_mat4x4_t m = {
       // clang-format off
@@ -200,6 +239,116 @@ static bool transpose() {
   return true;
 }
 
+/// Inverts |m| in double precision with Gauss-Jordan elimination, as a
+/// reference independent of the cofactor method under test.
+static bool reference_inverse(const radiant_mat4x4_t* m, double out[16]) {
+  double a[4][8];
+  for (uint32_t r = 0; r < 4; ++r) {
+    for (uint32_t c = 0; c < 4; ++c) {
+      a[r][c] = (double)m->data[(c * 4) + r];
+      a[r][c + 4] = r == c ? 1.0 : 0.0;
+    }
+  }
+
+  for (uint32_t col = 0; col < 4; ++col) {
+    uint32_t pivot = col;
+    for (uint32_t r = col + 1; r < 4; ++r) {
+      if (fabs(a[r][col]) > fabs(a[pivot][col])) {
+        pivot = r;
+      }
+    }
+    if (fabs(a[pivot][col]) < 1e-12) {
+      return false;
+    }
+    for (uint32_t c = 0; c < 8; ++c) {
+      double tmp = a[col][c];
+      a[col][c] = a[pivot][c];
+      a[pivot][c] = tmp;
+    }
+
+    double inv = 1.0 / a[col][col];
+    for (uint32_t c = 0; c < 8; ++c) {
+      a[col][c] *= inv;
+    }
+    for (uint32_t r = 0; r < 4; ++r) {
+      if (r == col) {
+        continue;
+      }
+      double f = a[r][col];
+      for (uint32_t c = 0; c < 8; ++c) {
+        a[r][c] -= f * a[col][c];
+      }
+    }
+  }
+
+  for (uint32_t r = 0; r < 4; ++r) {
+    for (uint32_t c = 0; c < 4; ++c) {
+      out[(c * 4) + r] = a[r][c + 4];
+    }
+  }
+  return true;
+}
+
+static bool inverse() {
+  uint32_t rng = 7;
+  for (uint32_t i = 0; i < 64; ++i) {
+    radiant_mat4x4_t m;
+    for (uint32_t j = 0; j < 16; ++j) {
+      rng = rng * 1664525u + 1013904223u;
+      m.data[j] = ((float)(rng >> 8) / (float)(1u << 24)) * 2.f - 1.f;
+    }
+    // Keep the matrix well conditioned.
+    m.data[0] += 4.f;
+    m.data[5] += 4.f;
+    m.data[10] += 4.f;
+    m.data[15] += 4.f;
+
+    double expected[16];
+    RADIANT_EXPECT_TRUE(reference_inverse(&m, expected));
+
+    radiant_mat4x4_inverse_result_t r = radiant_mat4x4_inverse(m);
+    RADIANT_EXPECT_TRUE(r.succeeded);
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(fabs(expected[j] - (double)r.inverse.data[j]) <
+                          1e-5);
+    }
+  }
+
+  // A perspective matrix, as used to unproject.
+  radiant_mat4x4_t p = radiant_mat4x4_perspective(1.f, 1.5f, 0.1f, 100.f);
+  double expected[16];
+  RADIANT_EXPECT_TRUE(reference_inverse(&p, expected));
+  radiant_mat4x4_inverse_result_t r = radiant_mat4x4_inverse(p);
+  RADIANT_EXPECT_TRUE(r.succeeded);
+  for (uint32_t j = 0; j < 16; ++j) {
+    RADIANT_EXPECT_TRUE(
+        fabs(expected[j] - (double)r.inverse.data[j]) <
+        1e-5 * (1.0 + fabs(expected[j])));
+  }
+  return true;
+}
+
+static bool inverse_singular() {
+  radiant_mat4x4_t zero = {0};
+  RADIANT_EXPECT_FALSE(radiant_mat4x4_inverse(zero).succeeded);
+
+  // Rows are linearly dependent.
+  radiant_mat4x4_t m = {
+      // clang-format off
+      1.f, 5.f,  9.f, 13.f,
+      2.f, 6.f, 10.f, 14.f,
+      3.f, 7.f, 11.f, 15.f,
+      4.f, 8.f, 12.f, 16.f,
+      // clang-format on
+  };
+  RADIANT_EXPECT_FALSE(radiant_mat4x4_inverse(m).succeeded);
+
+  // Projects everything onto a plane.
+  RADIANT_EXPECT_FALSE(
+      radiant_mat4x4_inverse(radiant_mat4x4_scale(1.f, 0.f, 1.f)).succeeded);
+  return true;
+}
+
 static bool mul() {
   // clang-format off
   // Matrix is column-major so in memory appears as:
@@ -341,17 +490,21 @@ static bool scale() {
 
 int main() {
   radiant_suite_begin("mat4x4");
-  RADIANT_TEST(identity);
-  RADIANT_TEST(look_at);
-  RADIANT_TEST(perspective);
-  RADIANT_TEST(rotate_x);
-  RADIANT_TEST(rotate_y);
-  RADIANT_TEST(rotate_z);
-  RADIANT_TEST(transpose);
-  RADIANT_TEST(mul);
-  RADIANT_TEST(mul_point3);
-  RADIANT_TEST(mul_vec3);
-  RADIANT_TEST(translate);
-  RADIANT_TEST(scale);
+  RADIANT_TEST_ALL_BACKENDS(identity);
+  RADIANT_TEST_ALL_BACKENDS(look_at);
+  RADIANT_TEST_ALL_BACKENDS(perspective);
+  RADIANT_TEST_ALL_BACKENDS(perspective_reverse_z_infinite);
+  RADIANT_TEST_ALL_BACKENDS(rotate_x);
+  RADIANT_TEST_ALL_BACKENDS(rotate_y);
+  RADIANT_TEST_ALL_BACKENDS(rotate_z);
+  RADIANT_TEST_ALL_BACKENDS(rotate);
+  RADIANT_TEST_ALL_BACKENDS(transpose);
+  RADIANT_TEST_ALL_BACKENDS(inverse);
+  RADIANT_TEST_ALL_BACKENDS(inverse_singular);
+  RADIANT_TEST_ALL_BACKENDS(mul);
+  RADIANT_TEST_ALL_BACKENDS(mul_point3);
+  RADIANT_TEST_ALL_BACKENDS(mul_vec3);
+  RADIANT_TEST_ALL_BACKENDS(translate);
+  RADIANT_TEST_ALL_BACKENDS(scale);
   return radiant_suite_end();
 }
@@ -0,0 +1,69 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mvp.h"
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+/// Number of model matrices built on the stack at a time by
+/// radiant_mvp_compute_trs before handing them to the batch multiply.
+#define TRS_CHUNK 64
+
+radiant_mat4x4_t radiant_trs_to_mat4x4(radiant_trs_t trs) {
+  radiant_mat4x4_t m = radiant_quat_to_mat4x4(trs.rotation);
+  for (uint32_t i = 0; i < 3; ++i) {
+    m.data[i + 0] *= trs.scale.x;
+    m.data[i + 4] *= trs.scale.y;
+    m.data[i + 8] *= trs.scale.z;
+  }
+  m.data[12] = trs.translation.x;
+  m.data[13] = trs.translation.y;
+  m.data[14] = trs.translation.z;
+  return m;
+}
+
+void radiant_mvp_compute(radiant_mat4x4_t view_projection,
+                         const radiant_mat4x4_t* models,
+                         radiant_mat4x4_t* out,
+                         uint32_t begin,
+                         uint32_t end) {
+  RADIANT_ASSERT(begin <= end);
+  RADIANT_ASSERT(((uintptr_t)out % RADIANT_MVP_ALIGNMENT) == 0);
+  if (begin == end) {
+    return;
+  }
+
+  radiant_simd_ops()->mat4x4_mul_batch(out + begin, &view_projection,
+                                       models + begin, end - begin);
+}
+
+void radiant_mvp_compute_trs(radiant_mat4x4_t view_projection,
+                             const radiant_trs_t* trs,
+                             radiant_mat4x4_t* out,
+                             uint32_t begin,
+                             uint32_t end) {
+  RADIANT_ASSERT(begin <= end);
+  RADIANT_ASSERT(((uintptr_t)out % RADIANT_MVP_ALIGNMENT) == 0);
+
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+  radiant_mat4x4_t models[TRS_CHUNK];
+  for (uint32_t i = begin; i < end; i += TRS_CHUNK) {
+    uint32_t count = end - i < TRS_CHUNK ? end - i : TRS_CHUNK;
+    for (uint32_t j = 0; j < count; ++j) {
+      models[j] = radiant_trs_to_mat4x4(trs[i + j]);
+    }
+    ops->mat4x4_mul_batch(out + i, &view_projection, models, count);
+  }
+}
@@ -0,0 +1,48 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/mat4x4.h"
+#include "src/trs.h"
+
+/// Required alignment, in bytes, of the output buffers of the
+/// radiant_mvp_compute functions.
+#define RADIANT_MVP_ALIGNMENT 16
+
+/// Returns the model matrix translation * rotation * scale for |trs|.
+radiant_mat4x4_t radiant_trs_to_mat4x4(radiant_trs_t trs);
+
+/// Stores |view_projection| * |models|[i] into |out|[i] for each i in
+/// [|begin|, |end|). |out| must be RADIANT_MVP_ALIGNMENT aligned and hold at
+/// least |end| matrices, the layout matches an array of mat4x4f in WGSL so it
+/// can be handed directly to radiant_buffer_write. |out| is only written, never
+/// read.
+///
+/// Calls over disjoint ranges touch disjoint memory, so a large instance set
+/// can be split across threads.
+void radiant_mvp_compute(radiant_mat4x4_t view_projection,
+                         const radiant_mat4x4_t* models,
+                         radiant_mat4x4_t* out,
+                         uint32_t begin,
+                         uint32_t end);
+
+/// As radiant_mvp_compute but building each model matrix from |trs|[i].
+void radiant_mvp_compute_trs(radiant_mat4x4_t view_projection,
+                             const radiant_trs_t* trs,
+                             radiant_mat4x4_t* out,
+                             uint32_t begin,
+                             uint32_t end);
@@ -0,0 +1,104 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares computing model-view-projection matrices one radiant_mat4x4_mul at
+// a time against the batched radiant_mvp_compute, for each supported SIMD
+// backend.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/mvp.h"
+#include "src/simd.h"
+
+static const uint32_t kCount = 100000;
+static const uint32_t kIterations = 100;
+
+typedef struct bench_data_t {
+  radiant_mat4x4_t view_projection;
+  radiant_trs_t* trs;
+  radiant_mat4x4_t* models;
+  radiant_mat4x4_t* out;
+} bench_data_t;
+
+static void mul_loop(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data->out[i] = radiant_mat4x4_mul(data->view_projection, data->models[i]);
+  }
+}
+
+static void batch(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_mvp_compute(data->view_projection, data->models, data->out, 0,
+                      kCount);
+}
+
+static void batch_trs(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_mvp_compute_trs(data->view_projection, data->trs, data->out, 0,
+                          kCount);
+}
+
+int main() {
+  bench_data_t data = {
+      .view_projection = radiant_mat4x4_perspective(1.f, 1.5f, 0.1f, 100.f),
+      .trs = (radiant_trs_t*)malloc(kCount * sizeof(radiant_trs_t)),
+      .models = (radiant_mat4x4_t*)malloc(kCount * sizeof(radiant_mat4x4_t)),
+      .out = (radiant_mat4x4_t*)aligned_alloc(
+          RADIANT_MVP_ALIGNMENT, kCount * sizeof(radiant_mat4x4_t)),
+  };
+  if (!data.trs || !data.models || !data.out) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    float f = (float)i;
+    data.trs[i] = (radiant_trs_t){
+        .translation = {f, f * 0.5f, -f},
+        .rotation = radiant_quat_from_euler(
+            (radiant_point3_t){f * 0.01f, f * 0.02f, f * 0.03f}),
+        .scale = {1.f, 2.f, 1.f},
+    };
+    data.models[i] = radiant_trs_to_mat4x4(data.trs[i]);
+  }
+
+  printf("Computing %u MVP matrices\n", kCount);
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "mat4x4_mul loop [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, mul_loop, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "mvp_compute [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, batch, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "mvp_compute_trs [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, batch_trs, &data, kIterations, kCount);
+  }
+  radiant_simd_set_backend(original);
+
+  free(data.trs);
+  free(data.models);
+  free(data.out);
+  return 0;
+}
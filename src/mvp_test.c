@@ -0,0 +1,116 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mvp.h"
+
+#include <stdalign.h>
+
+#include "src/test.h"
+
+/// Not a multiple of the TRS chunk size so the partial chunk runs.
+#define COUNT 150
+
+static uint32_t rng_state = 1;
+
+/// Returns a pseudo random float in [-4, 4).
+static float next_float(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((float)(rng_state >> 8) / (float)(1u << 24)) * 8.0f - 4.0f;
+}
+
+static radiant_trs_t random_trs(void) {
+  return (radiant_trs_t){
+      .translation = {next_float(), next_float(), next_float()},
+      .rotation = radiant_quat_from_euler(
+          (radiant_point3_t){next_float(), next_float(), next_float()}),
+      .scale = {next_float(), next_float(), next_float()},
+  };
+}
+
+/// Returns true if |a| and |b| are equal within a tolerance relative to their
+/// magnitude.
+static bool nearly_equal(float a, float b) {
+  float mag = (a < 0.f ? -a : a) + (b < 0.f ? -b : b);
+  return radiant_equal(a / (1.f + mag), b / (1.f + mag));
+}
+
+static radiant_mat4x4_t view_projection(void) {
+  return radiant_mat4x4_mul(
+      radiant_mat4x4_perspective(1.f, 1.5f, 0.1f, 100.f),
+      radiant_mat4x4_look_at((radiant_point3_t){2.f, 3.f, 4.f},
+                             (radiant_point3_t){0.f, 0.f, 0.f},
+                             (radiant_vec3_t){0.f, 1.f, 0.f}));
+}
+
+static bool trs_to_mat4x4() {
+  for (uint32_t i = 0; i < 32; ++i) {
+    radiant_point3_t angles = {next_float(), next_float(), next_float()};
+    radiant_trs_t trs = random_trs();
+    trs.rotation = radiant_quat_from_euler(angles);
+
+    radiant_mat4x4_t rot = radiant_mat4x4_mul(
+        radiant_mat4x4_rotate_x(angles.x),
+        radiant_mat4x4_mul(radiant_mat4x4_rotate_y(angles.y),
+                           radiant_mat4x4_rotate_z(angles.z)));
+    radiant_mat4x4_t expected = radiant_mat4x4_mul(
+        radiant_mat4x4_translate(trs.translation),
+        radiant_mat4x4_mul(rot, radiant_mat4x4_scale(trs.scale.x, trs.scale.y,
+                                                     trs.scale.z)));
+
+    radiant_mat4x4_t m = radiant_trs_to_mat4x4(trs);
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(nearly_equal(expected.data[j], m.data[j]));
+    }
+  }
+  return true;
+}
+
+static bool compute() {
+  radiant_mat4x4_t vp = view_projection();
+  radiant_trs_t trs[COUNT];
+  radiant_mat4x4_t models[COUNT];
+  alignas(RADIANT_MVP_ALIGNMENT) radiant_mat4x4_t out[COUNT];
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    trs[i] = random_trs();
+    models[i] = radiant_trs_to_mat4x4(trs[i]);
+  }
+
+  // Split into uneven ranges, as a job system would.
+  radiant_mvp_compute(vp, models, out, 0, 7);
+  radiant_mvp_compute(vp, models, out, 7, 7);
+  radiant_mvp_compute(vp, models, out, 7, COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_mat4x4_t expected = radiant_mat4x4_mul(vp, models[i]);
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(nearly_equal(expected.data[j], out[i].data[j]));
+    }
+  }
+
+  radiant_mvp_compute_trs(vp, trs, out, 0, 70);
+  radiant_mvp_compute_trs(vp, trs, out, 70, COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_mat4x4_t expected = radiant_mat4x4_mul(vp, models[i]);
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(nearly_equal(expected.data[j], out[i].data[j]));
+    }
+  }
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("mvp");
+  RADIANT_TEST(trs_to_mat4x4);
+  RADIANT_TEST_ALL_BACKENDS(compute);
+  return radiant_suite_end();
+}
@@ -0,0 +1,111 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/pacer.h"
+
+#include <stdio.h>
+
+#include "src/assert.h"
+
+/// Time slept between polls for finished frames, short next to a frame
+static const radiant_time_diff_t POLL_SLEEP_NS = 100000;
+
+static void work_done_callback(WGPUQueueWorkDoneStatus status,
+                               void* userdata) {
+  radiant_pacer_t* pacer = (radiant_pacer_t*)userdata;
+  if (status != WGPUQueueWorkDoneStatus_Success) {
+    fprintf(stderr, "Frame did not finish: %d\n", (int)status);
+  }
+  // Work finishes in submission order, so this is the oldest frame.
+  uint32_t slot = (uint32_t)(pacer->completed % pacer->frames_in_flight);
+  pacer->stats.latency_ms = radiant_time_diff_to_ms(
+      radiant_time_sub(radiant_time(), pacer->submit_times[slot]));
+  ++pacer->completed;
+}
+
+/// Blocks, processing events, until at most |depth| frames are on the GPU.
+/// Sleeps between polls rather than spinning a core on them.
+static void wait_for_depth(radiant_pacer_t* pacer, uint64_t depth) {
+  while (pacer->submitted - pacer->completed > depth) {
+    wgpuInstanceProcessEvents(pacer->instance);
+    if (pacer->submitted - pacer->completed > depth) {
+      radiant_time_sleep(POLL_SLEEP_NS);
+    }
+  }
+}
+
+radiant_pacer_t radiant_pacer_create(radiant_pacer_create_request_t req) {
+  RADIANT_ASSERT(req.frames_in_flight >= 1);
+  RADIANT_ASSERT(req.frames_in_flight <= RADIANT_PACER_MAX_FRAMES);
+  RADIANT_ASSERT(req.max_latency_ms >= 0.0);
+  return (radiant_pacer_t){
+      .instance = req.engine.instance,
+      .queue = wgpuDeviceGetQueue(req.engine.device),
+      .max_latency_ms = req.max_latency_ms,
+      .frames_in_flight = req.frames_in_flight,
+  };
+}
+
+void radiant_pacer_destroy(radiant_pacer_t* pacer) {
+  RADIANT_ASSERT(!pacer->in_frame);
+  radiant_pacer_wait_idle(pacer);
+  wgpuQueueRelease(pacer->queue);
+}
+
+uint32_t radiant_pacer_begin_frame(radiant_pacer_t* pacer) {
+  RADIANT_ASSERT(!pacer->in_frame);
+  // Pick up frames that finished since the last one.
+  wgpuInstanceProcessEvents(pacer->instance);
+  uint32_t depth = (uint32_t)(pacer->submitted - pacer->completed);
+  pacer->stats.queue_depth = depth;
+  if (depth > pacer->stats.max_queue_depth) {
+    pacer->stats.max_queue_depth = depth;
+  }
+
+  radiant_time_t begin = radiant_time();
+  wait_for_depth(pacer, pacer->frames_in_flight - 1);
+  // Each finished frame updates the latency, so drain one at a time until
+  // it is back under the target. An empty queue starts the next frame
+  // without GPU work ahead of it, the lowest latency the pacer can give.
+  if (pacer->max_latency_ms > 0.0) {
+    bool throttled = false;
+    while (pacer->stats.latency_ms > pacer->max_latency_ms &&
+           pacer->submitted > pacer->completed) {
+      wait_for_depth(pacer, pacer->submitted - pacer->completed - 1);
+      throttled = true;
+    }
+    if (throttled) {
+      ++pacer->stats.latency_throttled;
+    }
+  }
+  pacer->stats.wait_ms =
+      radiant_time_diff_to_ms(radiant_time_sub(radiant_time(), begin));
+  pacer->stats.total_wait_ms += pacer->stats.wait_ms;
+
+  pacer->in_frame = true;
+  return (uint32_t)(pacer->submitted % pacer->frames_in_flight);
+}
+
+void radiant_pacer_end_frame(radiant_pacer_t* pacer) {
+  RADIANT_ASSERT(pacer->in_frame);
+  pacer->in_frame = false;
+  uint32_t slot = (uint32_t)(pacer->submitted % pacer->frames_in_flight);
+  pacer->submit_times[slot] = radiant_time();
+  ++pacer->submitted;
+  wgpuQueueOnSubmittedWorkDone(pacer->queue, 0, work_done_callback, pacer);
+}
+
+void radiant_pacer_wait_idle(radiant_pacer_t* pacer) {
+  wait_for_depth(pacer, 0);
+}
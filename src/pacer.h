@@ -0,0 +1,105 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/engine.h"
+#include "src/pad.h"
+#include "src/time.h"
+
+/// The most frames a pacer lets the CPU run ahead of the GPU.
+#define RADIANT_PACER_MAX_FRAMES 4
+
+/// Structure for requesting a pacer
+typedef struct radiant_pacer_create_request_t {
+  /// The engine
+  radiant_engine_t engine;
+  /// Milliseconds from ending a frame to the GPU finishing it that the pacer
+  /// aims to stay under, or 0 for no target. While the measured
+  /// |stats.latency_ms| is over it, frames begin only once the GPU has
+  /// caught up further, down to none in flight.
+  double max_latency_ms;
+  /// Frames that may be submitted and not yet finished on the GPU, from 1 to
+  /// RADIANT_PACER_MAX_FRAMES. Fewer lowers latency, more keeps the GPU
+  /// busier.
+  uint32_t frames_in_flight;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_pacer_create_request_t;
+
+/// How the pacer has been holding the CPU back
+typedef struct radiant_pacer_stats_t {
+  /// Milliseconds the last radiant_pacer_begin_frame blocked for
+  double wait_ms;
+  /// Milliseconds every radiant_pacer_begin_frame so far blocked for
+  double total_wait_ms;
+  /// Milliseconds from the end of the last finished frame to the GPU
+  /// finishing it, as seen by the CPU
+  double latency_ms;
+  /// Frames on the GPU when the last frame began, before waiting
+  uint32_t queue_depth;
+  /// The highest |queue_depth| so far
+  uint32_t max_queue_depth;
+  /// Frames that began with fewer frames in flight than allowed to bring the
+  /// latency back under |max_latency_ms|
+  uint64_t latency_throttled;
+} radiant_pacer_stats_t;
+
+/// Keeps the CPU at most |frames_in_flight| frames ahead of the GPU, and
+/// fewer while the latency is over |max_latency_ms|, using
+/// wgpuQueueOnSubmittedWorkDone to learn when each frame finishes. Each frame
+/// gets a slot, the index of the per frame resources it may write to without
+/// touching those the GPU is still reading.
+///
+/// Note: the GPU reports back through the pacer's address, it must not move
+/// while frames are in flight.
+typedef struct radiant_pacer_t {
+  WGPUInstance instance;
+  WGPUQueue queue;
+  /// When each slot's frame was ended
+  radiant_time_t submit_times[RADIANT_PACER_MAX_FRAMES];
+  /// Frames ended so far
+  uint64_t submitted;
+  /// Frames the GPU has finished so far
+  uint64_t completed;
+  radiant_pacer_stats_t stats;
+  double max_latency_ms;
+  uint32_t frames_in_flight;
+  /// True between radiant_pacer_begin_frame and radiant_pacer_end_frame
+  bool in_frame;
+  /// Unused padding
+  RADIANT_PAD(3);
+} radiant_pacer_t;
+
+/// Creates a pacer for the queue of |req.engine|.
+radiant_pacer_t radiant_pacer_create(radiant_pacer_create_request_t req);
+
+/// Waits for the frames in flight to finish, then destroys |pacer|.
+void radiant_pacer_destroy(radiant_pacer_t* pacer);
+
+/// Blocks, processing events, until fewer than |pacer->frames_in_flight|
+/// frames are on the GPU, then while the latency of the last finished frame
+/// is over |pacer->max_latency_ms|, until another frame finishes or none are
+/// left. Returns the slot of the new frame, below
+/// |pacer->frames_in_flight|.
+uint32_t radiant_pacer_begin_frame(radiant_pacer_t* pacer);
+
+/// Ends the frame begun last. Call after submitting all of its work.
+void radiant_pacer_end_frame(radiant_pacer_t* pacer);
+
+/// Blocks, processing events, until every ended frame has finished.
+void radiant_pacer_wait_idle(radiant_pacer_t* pacer);
@@ -0,0 +1,134 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/pacer.h"
+
+#include <stdio.h>
+
+#include "src/test.h"
+
+#define FRAMES 32
+
+static radiant_engine_t engine;
+
+/// Submits an empty frame, enough for the queue to report it done.
+static void submit_frame() {
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(engine.device, NULL);
+  WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, NULL);
+  wgpuCommandEncoderRelease(encoder);
+  WGPUQueue queue = wgpuDeviceGetQueue(engine.device);
+  wgpuQueueSubmit(queue, 1, &commands);
+  wgpuCommandBufferRelease(commands);
+}
+
+/// Frames take the slots in turn and never queue up beyond the limit.
+static bool limits_frames_in_flight() {
+  for (uint32_t frames = 1; frames <= RADIANT_PACER_MAX_FRAMES; ++frames) {
+    radiant_pacer_t pacer =
+        radiant_pacer_create((radiant_pacer_create_request_t){
+            .engine = engine,
+            .frames_in_flight = frames,
+        });
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+      uint32_t slot = radiant_pacer_begin_frame(&pacer);
+      uint32_t expected = i % frames;
+      RADIANT_EXPECT_EQ(slot, expected);
+      RADIANT_EXPECT_TRUE(pacer.submitted - pacer.completed < frames);
+      RADIANT_EXPECT_TRUE(pacer.stats.queue_depth <= frames);
+      submit_frame();
+      radiant_pacer_end_frame(&pacer);
+    }
+    RADIANT_EXPECT_TRUE(pacer.stats.max_queue_depth <= frames);
+    RADIANT_EXPECT_TRUE(pacer.stats.total_wait_ms >= 0.0);
+    RADIANT_EXPECT_TRUE(pacer.submitted == FRAMES);
+    radiant_pacer_destroy(&pacer);
+    RADIANT_EXPECT_TRUE(pacer.completed == FRAMES);
+  }
+  return true;
+}
+
+/// A latency target under any frame's keeps the queue drained, even with
+/// more frames allowed in flight.
+static bool limits_latency() {
+  radiant_pacer_t pacer = radiant_pacer_create((radiant_pacer_create_request_t){
+      .engine = engine,
+      .max_latency_ms = 1e-9,
+      .frames_in_flight = RADIANT_PACER_MAX_FRAMES,
+  });
+  // The first frame to finish gives the pacer a latency to go by.
+  radiant_pacer_begin_frame(&pacer);
+  submit_frame();
+  radiant_pacer_end_frame(&pacer);
+  radiant_pacer_wait_idle(&pacer);
+  for (uint32_t i = 0; i < FRAMES; ++i) {
+    radiant_pacer_begin_frame(&pacer);
+    RADIANT_EXPECT_TRUE(pacer.submitted == pacer.completed);
+    submit_frame();
+    radiant_pacer_end_frame(&pacer);
+  }
+  RADIANT_EXPECT_TRUE(pacer.stats.latency_throttled < FRAMES);
+  radiant_pacer_destroy(&pacer);
+  return true;
+}
+
+/// Waiting for idle lets every submitted frame finish.
+static bool wait_idle() {
+  radiant_pacer_t pacer = radiant_pacer_create((radiant_pacer_create_request_t){
+      .engine = engine,
+      .frames_in_flight = RADIANT_PACER_MAX_FRAMES,
+  });
+  radiant_pacer_wait_idle(&pacer);
+  RADIANT_EXPECT_TRUE(pacer.completed == 0);
+
+  for (uint32_t i = 0; i < RADIANT_PACER_MAX_FRAMES - 1; ++i) {
+    radiant_pacer_begin_frame(&pacer);
+    submit_frame();
+    radiant_pacer_end_frame(&pacer);
+  }
+  radiant_pacer_wait_idle(&pacer);
+  RADIANT_EXPECT_TRUE(pacer.completed == pacer.submitted);
+  RADIANT_EXPECT_TRUE(pacer.stats.latency_ms >= 0.0);
+
+  // With nothing in flight the next frame starts at once.
+  radiant_pacer_begin_frame(&pacer);
+  RADIANT_EXPECT_EQ(pacer.stats.queue_depth, 0);
+  submit_frame();
+  radiant_pacer_end_frame(&pacer);
+  radiant_pacer_destroy(&pacer);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("pacer");
+
+  radiant_engine_create_result_t engine_result =
+      radiant_engine_create_headless((radiant_engine_headless_create_request_t){
+          .adapter = {.policy = radiant_adapter_policy_software},
+          .size = {.width = 16, .height = 16},
+          .format = WGPUTextureFormat_BGRA8Unorm,
+      });
+  if (!engine_result.succeeded) {
+    printf("No software adapter, skipping\n");
+    return radiant_suite_end();
+  }
+  engine = engine_result.engine;
+
+  RADIANT_TEST(limits_frames_in_flight);
+  RADIANT_TEST(limits_latency);
+  RADIANT_TEST(wait_idle);
+
+  radiant_engine_destroy(engine);
+  return radiant_suite_end();
+}
@@ -0,0 +1,141 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/pack.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+static uint32_t float_bits(float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static float bits_float(uint32_t u) {
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+uint16_t radiant_pack_f16(float f) {
+  // From Fabian Giesen's float_to_half_fast3_rtne.
+  uint32_t u = float_bits(f);
+  uint32_t sign = u & 0x80000000u;
+  u ^= sign;
+
+  uint32_t h;
+  if (u >= RADIANT_PACK_F16_MAX) {
+    // Infinity, or quiet NaN.
+    h = u > 0x7f800000u ? 0x7e00u : 0x7c00u;
+  } else if (u < RADIANT_PACK_F16_MIN_NORMAL) {
+    // The add rounds the mantissa into the low bits.
+    h = float_bits(bits_float(u) + bits_float(RADIANT_PACK_F16_SUBNORMAL)) -
+        RADIANT_PACK_F16_SUBNORMAL;
+  } else {
+    // Rebias the exponent and round, with ties going to the even mantissa.
+    uint32_t odd = (u >> 13) & 1u;
+    h = (u + RADIANT_PACK_F16_NORMAL_BIAS + odd) >> 13;
+  }
+  return (uint16_t)(h | (sign >> 16));
+}
+
+float radiant_unpack_f16(uint16_t h) {
+  uint32_t u = ((uint32_t)h & 0x7fffu) << 13;
+  uint32_t exponent = u & 0x0f800000u;
+  u += (127u - 15u) << 23;
+  if (exponent == 0x0f800000u) {
+    // Infinity or NaN.
+    u += (128u - 16u) << 23;
+  } else if (exponent == 0) {
+    // Zero or subnormal, renormalize.
+    u += 1u << 23;
+    u = float_bits(bits_float(u) - bits_float(113u << 23));
+  }
+  return bits_float(u | (((uint32_t)h & 0x8000u) << 16));
+}
+
+uint8_t radiant_pack_unorm8(float f) {
+  f = f > 0.f ? f : 0.f;
+  f = f < 1.f ? f : 1.f;
+  return (uint8_t)nearbyintf(f * 255.f);
+}
+
+float radiant_unpack_unorm8(uint8_t v) {
+  return (float)v / 255.f;
+}
+
+int16_t radiant_pack_snorm16(float f) {
+  f = f > -1.f ? f : -1.f;
+  f = f < 1.f ? f : 1.f;
+  return (int16_t)nearbyintf(f * 32767.f);
+}
+
+float radiant_unpack_snorm16(int16_t v) {
+  float f = (float)v / 32767.f;
+  return f > -1.f ? f : -1.f;
+}
+
+uint32_t radiant_pack_octahedral(radiant_vec3_t n) {
+  float sum = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+  float inv = sum > 0.f ? 1.f / sum : 0.f;
+  float x = n.x * inv;
+  float y = n.y * inv;
+  if (n.z < 0.f) {
+    // Fold the lower half over the diagonals.
+    float fx = (1.f - fabsf(y)) * copysignf(1.f, x);
+    float fy = (1.f - fabsf(x)) * copysignf(1.f, y);
+    x = fx;
+    y = fy;
+  }
+  return (uint32_t)(uint16_t)radiant_pack_snorm16(x) |
+         ((uint32_t)(uint16_t)radiant_pack_snorm16(y) << 16);
+}
+
+radiant_vec3_t radiant_unpack_octahedral(uint32_t packed) {
+  float x = radiant_unpack_snorm16((int16_t)(uint16_t)(packed & 0xffffu));
+  float y = radiant_unpack_snorm16((int16_t)(uint16_t)(packed >> 16));
+  float z = 1.f - fabsf(x) - fabsf(y);
+  float t = z < 0.f ? -z : 0.f;
+  x -= copysignf(t, x);
+  y -= copysignf(t, y);
+
+  float inv = 1.f / sqrtf((x * x) + (y * y) + (z * z));
+  return (radiant_vec3_t){x * inv, y * inv, z * inv};
+}
+
+void radiant_pack_f16_batch(const float* in, uint16_t* out, uint32_t count) {
+  RADIANT_ASSERT((in && out) || count == 0);
+  radiant_simd_ops()->pack_f16_batch(out, in, count);
+}
+
+void radiant_pack_unorm8_batch(const float* in, uint8_t* out, uint32_t count) {
+  RADIANT_ASSERT((in && out) || count == 0);
+  radiant_simd_ops()->pack_unorm8_batch(out, in, count);
+}
+
+void radiant_pack_snorm16_batch(const float* in,
+                                int16_t* out,
+                                uint32_t count) {
+  RADIANT_ASSERT((in && out) || count == 0);
+  radiant_simd_ops()->pack_snorm16_batch(out, in, count);
+}
+
+void radiant_pack_octahedral_batch(radiant_vec3_soa_t normals, uint32_t* out) {
+  RADIANT_ASSERT(out || normals.count == 0);
+  radiant_simd_ops()->pack_octahedral_batch(out, &normals);
+}
@@ -0,0 +1,65 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/soa.h"
+#include "src/vec3.h"
+
+// Conversions from float to the compact vertex formats. Rounding is to
+// nearest even throughout, matching what the GPU does when decoding. See
+// vertex_format.h for the formats to use in a pipeline layout.
+
+/// Returns |f| as an IEEE half. Values beyond the half range become infinity
+/// and NaNs stay NaN. Matches radiant_vertex_format_float16x*.
+uint16_t radiant_pack_f16(float f);
+/// Returns the float holding the half |h| exactly.
+float radiant_unpack_f16(uint16_t h);
+
+/// Returns |f| clamped to [0, 1] and scaled to [0, 255]. NaN becomes 0.
+/// Matches radiant_vertex_format_unorm8x*.
+uint8_t radiant_pack_unorm8(float f);
+/// Returns |v| as a float in [0, 1].
+float radiant_unpack_unorm8(uint8_t v);
+
+/// Returns |f| clamped to [-1, 1] and scaled to [-32767, 32767]. NaN becomes
+/// -32767. Matches radiant_vertex_format_snorm16x*.
+int16_t radiant_pack_snorm16(float f);
+/// Returns |v| as a float in [-1, 1].
+float radiant_unpack_snorm16(int16_t v);
+
+/// Returns the unit vector |n| mapped onto an octahedron and unfolded to a
+/// square, as two snorm16 values with x in the low 16 bits. The angular error
+/// is below 0.01 degrees. Decode in a shader from a
+/// radiant_vertex_format_octahedral attribute.
+uint32_t radiant_pack_octahedral(radiant_vec3_t n);
+/// Returns the unit vector encoded in |packed|.
+radiant_vec3_t radiant_unpack_octahedral(uint32_t packed);
+
+/// Stores radiant_pack_f16(|in|[i]) into |out|[i] for |count| floats.
+void radiant_pack_f16_batch(const float* in, uint16_t* out, uint32_t count);
+
+/// Stores radiant_pack_unorm8(|in|[i]) into |out|[i] for |count| floats.
+void radiant_pack_unorm8_batch(const float* in, uint8_t* out, uint32_t count);
+
+/// Stores radiant_pack_snorm16(|in|[i]) into |out|[i] for |count| floats.
+void radiant_pack_snorm16_batch(const float* in,
+                                int16_t* out,
+                                uint32_t count);
+
+/// Stores radiant_pack_octahedral of each of |normals| into |out|, which
+/// must hold |normals.count| values.
+void radiant_pack_octahedral_batch(radiant_vec3_soa_t normals, uint32_t* out);
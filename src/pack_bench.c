@@ -0,0 +1,107 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the vertex packing kernels for each supported SIMD backend.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/pack.h"
+#include "src/simd.h"
+
+static const uint32_t kCount = 1u << 20;
+static const uint32_t kIterations = 100;
+
+typedef struct bench_data_t {
+  float* in;
+  radiant_vec3_soa_t normals;
+  uint16_t* f16;
+  uint8_t* unorm8;
+  int16_t* snorm16;
+  uint32_t* octahedral;
+} bench_data_t;
+
+static void f16(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_pack_f16_batch(data->in, data->f16, kCount);
+}
+
+static void unorm8(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_pack_unorm8_batch(data->in, data->unorm8, kCount);
+}
+
+static void snorm16(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_pack_snorm16_batch(data->in, data->snorm16, kCount);
+}
+
+static void octahedral(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_pack_octahedral_batch(data->normals, data->octahedral);
+}
+
+int main() {
+  bench_data_t data = {
+      .in = (float*)malloc(kCount * sizeof(float)),
+      .normals = radiant_vec3_soa_create(kCount),
+      .f16 = (uint16_t*)malloc(kCount * sizeof(uint16_t)),
+      .unorm8 = (uint8_t*)malloc(kCount * sizeof(uint8_t)),
+      .snorm16 = (int16_t*)malloc(kCount * sizeof(int16_t)),
+      .octahedral = (uint32_t*)malloc(kCount * sizeof(uint32_t)),
+  };
+  if (!data.in || data.normals.count != kCount || !data.f16 ||
+      !data.unorm8 || !data.snorm16 || !data.octahedral) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    float f = (float)i / (float)kCount;
+    data.in[i] = (f * 2.f) - 1.f;
+    radiant_vec3_soa_set(data.normals, i,
+                         radiant_vec3_normalize((radiant_vec3_t){
+                             f - .5f, .25f - f, (f * 3.f) - 1.f}));
+  }
+
+  printf("Packing %u values\n", kCount);
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    const char* backend_name = radiant_simd_backend_name(backend);
+    char name[64];
+    snprintf(name, sizeof(name), "pack_f16_batch [%s]", backend_name);
+    radiant_bench_run(name, f16, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "pack_unorm8_batch [%s]", backend_name);
+    radiant_bench_run(name, unorm8, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "pack_snorm16_batch [%s]", backend_name);
+    radiant_bench_run(name, snorm16, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "pack_octahedral_batch [%s]", backend_name);
+    radiant_bench_run(name, octahedral, &data, kIterations, kCount);
+  }
+  radiant_simd_set_backend(original);
+
+  free(data.in);
+  radiant_vec3_soa_destroy(data.normals);
+  free(data.f16);
+  free(data.unorm8);
+  free(data.snorm16);
+  free(data.octahedral);
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/pack.h"
+
+#include <math.h>
+
+#include "src/test.h"
+
+/// Not a multiple of any vector width.
+#define COUNT 101
+
+static bool f16() {
+  RADIANT_EXPECT_EQ(radiant_pack_f16(0.f), 0x0000);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(-0.f), 0x8000);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(1.f), 0x3c00);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(-2.f), 0xc000);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(65504.f), 0x7bff);
+  // Halfway to the next half rounds to infinity.
+  RADIANT_EXPECT_EQ(radiant_pack_f16(65520.f), 0x7c00);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(1e10f), 0x7c00);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(-INFINITY), 0xfc00);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(NAN), 0x7e00);
+  // The smallest subnormal, and below half of it.
+  RADIANT_EXPECT_EQ(radiant_pack_f16(0x1p-24f), 0x0001);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(0x1p-26f), 0x0000);
+  // Ties go to even.
+  RADIANT_EXPECT_EQ(radiant_pack_f16(1.f + 0x1p-11f), 0x3c00);
+  RADIANT_EXPECT_EQ(radiant_pack_f16(1.f + 0x3p-11f), 0x3c02);
+  return true;
+}
+
+static bool f16_round_trip() {
+  for (uint32_t h = 0; h <= 0xffff; ++h) {
+    float f = radiant_unpack_f16((uint16_t)h);
+    if (isnan(f)) {
+      continue;
+    }
+    RADIANT_EXPECT_EQ(radiant_pack_f16(f), h);
+  }
+  RADIANT_EXPECT_FLOAT_EQ(radiant_unpack_f16(0x3555), 0.33325195f);
+  RADIANT_EXPECT_TRUE(isnan(radiant_unpack_f16(0x7e00)));
+  return true;
+}
+
+static bool unorm8() {
+  RADIANT_EXPECT_EQ(radiant_pack_unorm8(0.f), 0);
+  RADIANT_EXPECT_EQ(radiant_pack_unorm8(1.f), 255);
+  RADIANT_EXPECT_EQ(radiant_pack_unorm8(0.5f), 128);
+  RADIANT_EXPECT_EQ(radiant_pack_unorm8(-3.f), 0);
+  RADIANT_EXPECT_EQ(radiant_pack_unorm8(7.f), 255);
+  RADIANT_EXPECT_EQ(radiant_pack_unorm8(NAN), 0);
+  for (uint32_t v = 0; v < 256; ++v) {
+    RADIANT_EXPECT_EQ(radiant_pack_unorm8(radiant_unpack_unorm8((uint8_t)v)),
+                      v);
+  }
+  return true;
+}
+
+static bool snorm16() {
+  RADIANT_EXPECT_EQ((uint32_t)radiant_pack_snorm16(0.f), 0u);
+  RADIANT_EXPECT_EQ((uint32_t)radiant_pack_snorm16(1.f), 32767u);
+  RADIANT_EXPECT_EQ(radiant_pack_snorm16(-1.f), -32767);
+  RADIANT_EXPECT_EQ(radiant_pack_snorm16(-5.f), -32767);
+  RADIANT_EXPECT_EQ(radiant_pack_snorm16(NAN), -32767);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_unpack_snorm16(-32768), -1.f);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_unpack_snorm16(16384), 0.50001526f);
+  return true;
+}
+
+static radiant_vec3_t direction(uint32_t i) {
+  // A spiral over the sphere, touching both poles.
+  float z = 1.f - (2.f * (float)i / (COUNT - 1));
+  float r = sqrtf(fmaxf(0.f, 1.f - (z * z)));
+  float a = (float)i * 2.39996323f;
+  return (radiant_vec3_t){r * cosf(a), r * sinf(a), z};
+}
+
+static bool octahedral() {
+  const radiant_vec3_t axes[] = {
+      {1.f, 0.f, 0.f},  {-1.f, 0.f, 0.f}, {0.f, 1.f, 0.f},
+      {0.f, -1.f, 0.f}, {0.f, 0.f, 1.f},  {0.f, 0.f, -1.f},
+  };
+  for (uint32_t i = 0; i < 6; ++i) {
+    radiant_vec3_t n =
+        radiant_unpack_octahedral(radiant_pack_octahedral(axes[i]));
+    RADIANT_EXPECT_FLOAT_EQ(n.x, axes[i].x);
+    RADIANT_EXPECT_FLOAT_EQ(n.y, axes[i].y);
+    RADIANT_EXPECT_FLOAT_EQ(n.z, axes[i].z);
+  }
+
+  // Within 0.01 degrees.
+  const double max_angle = 0.01 * 3.14159265358979 / 180.0;
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_vec3_t f = direction(i);
+    radiant_vec3_t g = radiant_unpack_octahedral(radiant_pack_octahedral(f));
+    double n[3] = {(double)f.x, (double)f.y, (double)f.z};
+    double d[3] = {(double)g.x, (double)g.y, (double)g.z};
+    double cx = (n[1] * d[2]) - (n[2] * d[1]);
+    double cy = (n[2] * d[0]) - (n[0] * d[2]);
+    double cz = (n[0] * d[1]) - (n[1] * d[0]);
+    double dot = (n[0] * d[0]) + (n[1] * d[1]) + (n[2] * d[2]);
+    double angle = atan2(sqrt((cx * cx) + (cy * cy) + (cz * cz)), dot);
+    RADIANT_EXPECT_TRUE(angle < max_angle);
+  }
+  return true;
+}
+
+static bool batches() {
+  float in[COUNT];
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    in[i] = ((float)i - 50.f) * 0.0371f;
+  }
+  in[3] = NAN;
+  in[4] = INFINITY;
+  in[5] = 1e-6f;
+  in[6] = -70000.f;
+  in[7] = 0x1p-25f;
+
+  uint16_t f16_out[COUNT];
+  uint8_t unorm8_out[COUNT];
+  int16_t snorm16_out[COUNT];
+  radiant_pack_f16_batch(in, f16_out, COUNT);
+  radiant_pack_unorm8_batch(in, unorm8_out, COUNT);
+  radiant_pack_snorm16_batch(in, snorm16_out, COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    RADIANT_EXPECT_EQ(f16_out[i], radiant_pack_f16(in[i]));
+    RADIANT_EXPECT_EQ(unorm8_out[i], radiant_pack_unorm8(in[i]));
+    RADIANT_EXPECT_EQ(snorm16_out[i], radiant_pack_snorm16(in[i]));
+  }
+
+  radiant_vec3_soa_t normals = radiant_vec3_soa_create(COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_vec3_soa_set(normals, i, direction(i));
+  }
+  radiant_vec3_soa_set(normals, 10, (radiant_vec3_t){0.f, 0.f, 0.f});
+  uint32_t oct_out[COUNT];
+  radiant_pack_octahedral_batch(normals, oct_out);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    RADIANT_EXPECT_EQ(oct_out[i], radiant_pack_octahedral(
+                                      radiant_vec3_soa_get(normals, i)));
+  }
+  radiant_vec3_soa_destroy(normals);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("pack");
+  RADIANT_TEST(f16);
+  RADIANT_TEST(f16_round_trip);
+  RADIANT_TEST(unorm8);
+  RADIANT_TEST(snorm16);
+  RADIANT_TEST(octahedral);
+  RADIANT_TEST_ALL_BACKENDS(batches);
+  return radiant_suite_end();
+}
@@ -0,0 +1,343 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/profile.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/pad.h"
+
+/// A begin or end of a scope. The fields are atomic so that readers may copy
+/// a slot while its thread overwrites it, see |load_event|.
+typedef struct event_t {
+  /// The name of the scope, NULL for an end
+  const char* _Atomic name;
+  _Atomic radiant_time_t time;
+  /// The thread the event was recorded on
+  _Atomic uint32_t thread;
+  /// Unused padding
+  RADIANT_PAD(4);
+} event_t;
+
+/// A copy of an event_t
+typedef struct event_copy_t {
+  const char* name;
+  radiant_time_t time;
+  uint32_t thread;
+  /// Unused padding
+  RADIANT_PAD(4);
+} event_copy_t;
+
+/// The events of a thread, written only by the thread that owns it.
+typedef struct ring_t {
+  event_t events[RADIANT_PROFILE_THREAD_EVENTS];
+  /// Events written, the last RADIANT_PROFILE_THREAD_EVENTS are in |events|
+  atomic_uint_fast64_t head;
+  /// Events before this were reset
+  atomic_uint_fast64_t start;
+  /// True while a thread writes to the ring. Rings of threads that exited
+  /// are taken by new threads.
+  atomic_bool owned;
+  /// Unused padding
+  RADIANT_PAD(7);
+} ring_t;
+
+static ring_t* _Atomic rings[RADIANT_PROFILE_MAX_THREADS];
+static atomic_uint ring_count;
+/// Numbers threads in the order they first record
+static atomic_uint thread_count;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+/// Gives up the ring of a thread as it exits
+static pthread_key_t ring_key;
+
+static _Thread_local ring_t* thread_ring;
+static _Thread_local uint32_t thread_id;
+/// True once the thread has failed to get a ring
+static _Thread_local bool thread_dropped;
+
+static void release_ring(void* value) {
+  ring_t* ring = (ring_t*)value;
+  atomic_store_explicit(&ring->owned, false, memory_order_release);
+}
+
+static void create_key(void) {
+  pthread_key_create(&ring_key, release_ring);
+}
+
+/// Takes the ring of an exited thread, or a new one. Returns NULL if every
+/// ring is taken.
+static ring_t* claim_ring(void) {
+  uint32_t count = atomic_load_explicit(&ring_count, memory_order_acquire);
+  for (uint32_t i = 0; i < count; ++i) {
+    ring_t* ring = atomic_load_explicit(&rings[i], memory_order_acquire);
+    bool owned = false;
+    if (ring && atomic_compare_exchange_strong(&ring->owned, &owned, true)) {
+      return ring;
+    }
+  }
+
+  uint32_t idx = atomic_fetch_add(&ring_count, 1);
+  if (idx >= RADIANT_PROFILE_MAX_THREADS) {
+    atomic_store(&ring_count, RADIANT_PROFILE_MAX_THREADS);
+    return NULL;
+  }
+  ring_t* ring = (ring_t*)calloc(1, sizeof(ring_t));
+  if (!ring) {
+    return NULL;
+  }
+  atomic_init(&ring->owned, true);
+  atomic_store_explicit(&rings[idx], ring, memory_order_release);
+  return ring;
+}
+
+/// Returns the ring of this thread, claiming one on its first event.
+static ring_t* current_ring(void) {
+  if (thread_ring || thread_dropped) {
+    return thread_ring;
+  }
+  pthread_once(&key_once, create_key);
+  thread_ring = claim_ring();
+  if (!thread_ring) {
+    thread_dropped = true;
+    return NULL;
+  }
+  pthread_setspecific(ring_key, thread_ring);
+  thread_id = atomic_fetch_add(&thread_count, 1);
+  return thread_ring;
+}
+
+static void record(const char* name) {
+  ring_t* ring = current_ring();
+  if (!ring) {
+    return;
+  }
+  uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  event_t* event = &ring->events[head % RADIANT_PROFILE_THREAD_EVENTS];
+  atomic_store_explicit(&event->name, name, memory_order_relaxed);
+  atomic_store_explicit(&event->time, radiant_time(), memory_order_relaxed);
+  atomic_store_explicit(&event->thread, thread_id, memory_order_relaxed);
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void radiant_profile_begin(const char* name) {
+  record(name);
+}
+
+void radiant_profile_end(void) {
+  record(NULL);
+}
+
+radiant_profile_scope_t radiant_profile_scope_begin(const char* name) {
+  radiant_profile_begin(name);
+  return (radiant_profile_scope_t){.name = name};
+}
+
+void radiant_profile_scope_end(radiant_profile_scope_t* /* scope */) {
+  radiant_profile_end();
+}
+
+void radiant_profile_reset(void) {
+  uint32_t count = atomic_load_explicit(&ring_count, memory_order_acquire);
+  for (uint32_t i = 0; i < count && i < RADIANT_PROFILE_MAX_THREADS; ++i) {
+    ring_t* ring = atomic_load_explicit(&rings[i], memory_order_acquire);
+    if (ring) {
+      atomic_store(&ring->start, atomic_load(&ring->head));
+    }
+  }
+}
+
+/// A scope with both ends recorded
+typedef struct scope_t {
+  const char* name;
+  radiant_time_t begin;
+  radiant_time_t end;
+  /// Time spent in the scopes directly nested in this one
+  radiant_time_diff_t children;
+  uint32_t thread;
+  /// Scopes this is nested in
+  uint32_t depth;
+} scope_t;
+
+typedef void (*scope_fn_t)(void* userdata, const scope_t* scope);
+
+/// Copies event |index| of |ring| to |copy|. Returns false if the owning
+/// thread may have overwritten the event, in part or whole, with a later one.
+static bool load_event(ring_t* ring, uint64_t index, event_copy_t* copy) {
+  event_t* event = &ring->events[index % RADIANT_PROFILE_THREAD_EVENTS];
+  copy->name = atomic_load_explicit(&event->name, memory_order_relaxed);
+  copy->time = atomic_load_explicit(&event->time, memory_order_relaxed);
+  copy->thread = atomic_load_explicit(&event->thread, memory_order_relaxed);
+  // Orders the copy before |head| is read again. The slot is rewritten once
+  // the thread reaches event |index| + RADIANT_PROFILE_THREAD_EVENTS, while
+  // |head| still holds that index.
+  atomic_thread_fence(memory_order_acquire);
+  uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  return head < index + RADIANT_PROFILE_THREAD_EVENTS;
+}
+
+/// Calls |fn| for each scope recorded with both ends, as they end.
+static void for_each_scope(scope_fn_t fn, void* userdata) {
+  uint32_t count = atomic_load_explicit(&ring_count, memory_order_acquire);
+  for (uint32_t i = 0; i < count && i < RADIANT_PROFILE_MAX_THREADS; ++i) {
+    ring_t* ring = atomic_load_explicit(&rings[i], memory_order_acquire);
+    if (!ring) {
+      continue;
+    }
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t first = atomic_load(&ring->start);
+    // The oldest event is the next one overwritten, so is left out.
+    if (head - first >= RADIANT_PROFILE_THREAD_EVENTS) {
+      first = head - RADIANT_PROFILE_THREAD_EVENTS + 1;
+    }
+
+    scope_t stack[RADIANT_PROFILE_MAX_DEPTH];
+    // May exceed RADIANT_PROFILE_MAX_DEPTH, deeper scopes are not kept.
+    uint32_t depth = 0;
+    uint32_t thread = UINT32_MAX;
+    for (uint64_t e = first; e < head; ++e) {
+      event_copy_t copy;
+      // Events overwritten while reading lose the scopes around them.
+      if (!load_event(ring, e, &copy)) {
+        depth = 0;
+        thread = UINT32_MAX;
+        continue;
+      }
+      const event_copy_t* event = &copy;
+      // A ring taken over by another thread starts afresh.
+      if (event->thread != thread) {
+        thread = event->thread;
+        depth = 0;
+      }
+      if (event->name) {
+        if (depth < RADIANT_PROFILE_MAX_DEPTH) {
+          stack[depth] = (scope_t){
+              .name = event->name,
+              .begin = event->time,
+              .thread = thread,
+              .depth = depth,
+          };
+        }
+        ++depth;
+        continue;
+      }
+      // Ends whose begin was overwritten have nothing to match.
+      if (depth == 0) {
+        continue;
+      }
+      --depth;
+      if (depth >= RADIANT_PROFILE_MAX_DEPTH) {
+        continue;
+      }
+      scope_t* scope = &stack[depth];
+      scope->end = event->time;
+      fn(userdata, scope);
+      if (depth > 0) {
+        stack[depth - 1].children += radiant_time_sub(scope->begin, scope->end);
+      }
+    }
+  }
+}
+
+typedef struct aggregate_t {
+  radiant_profile_stats_t* stats;
+  uint32_t capacity;
+  uint32_t count;
+} aggregate_t;
+
+static void aggregate_scope(void* userdata, const scope_t* scope) {
+  aggregate_t* aggregate = (aggregate_t*)userdata;
+  radiant_profile_stats_t* stats = NULL;
+  for (uint32_t i = 0; i < aggregate->count; ++i) {
+    if (strcmp(aggregate->stats[i].name, scope->name) == 0) {
+      stats = &aggregate->stats[i];
+      break;
+    }
+  }
+  if (!stats) {
+    if (aggregate->count == aggregate->capacity) {
+      return;
+    }
+    stats = &aggregate->stats[aggregate->count++];
+    *stats = (radiant_profile_stats_t){.name = scope->name};
+  }
+
+  radiant_time_diff_t inclusive = radiant_time_sub(scope->begin, scope->end);
+  ++stats->calls;
+  stats->inclusive_ms += radiant_time_diff_to_ms(inclusive);
+  stats->exclusive_ms += radiant_time_diff_to_ms(inclusive - scope->children);
+}
+
+static int compare_inclusive(const void* a, const void* b) {
+  double a_ms = ((const radiant_profile_stats_t*)a)->inclusive_ms;
+  double b_ms = ((const radiant_profile_stats_t*)b)->inclusive_ms;
+  return (a_ms < b_ms) - (a_ms > b_ms);
+}
+
+uint32_t radiant_profile_aggregate(radiant_profile_stats_t* stats,
+                                   uint32_t capacity) {
+  aggregate_t aggregate = {
+      .stats = stats,
+      .capacity = capacity,
+  };
+  for_each_scope(aggregate_scope, &aggregate);
+  qsort(stats, aggregate.count, sizeof(radiant_profile_stats_t),
+        compare_inclusive);
+  return aggregate.count;
+}
+
+typedef struct trace_t {
+  radiant_file_t file;
+  /// True once an event has been written, the rest need a comma before
+  bool written;
+  /// Unused padding
+  RADIANT_PAD(7);
+} trace_t;
+
+/// Nanoseconds in a microsecond, the unit of trace event times.
+static const double kNsPerUs = 1e3;
+
+static void write_scope(void* userdata, const scope_t* scope) {
+  trace_t* trace = (trace_t*)userdata;
+  radiant_file_printf(trace->file, "%s\n{\"name\":\"",
+                      trace->written ? "," : "");
+  trace->written = true;
+  // Escape the characters JSON strings cannot hold as they are.
+  for (const char* c = scope->name; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      radiant_file_printf(trace->file, "\\%c", *c);
+    } else if ((unsigned char)*c < 0x20) {
+      radiant_file_printf(trace->file, "\\u%04x", (unsigned)*c);
+    } else {
+      radiant_file_printf(trace->file, "%c", *c);
+    }
+  }
+  radiant_file_printf(
+      trace->file,
+      "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+      (double)scope->begin / kNsPerUs,
+      (double)radiant_time_sub(scope->begin, scope->end) / kNsPerUs,
+      scope->thread);
+}
+
+void radiant_profile_write_chrome_trace(radiant_file_t file) {
+  trace_t trace = {.file = file};
+  radiant_file_printf(file, "{\"traceEvents\":[");
+  for_each_scope(write_scope, &trace);
+  radiant_file_printf(file, "\n]}\n");
+}
@@ -0,0 +1,98 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/io.h"
+#include "src/time.h"
+
+/// Events each thread keeps, a begin or end of a scope each. Older events are
+/// overwritten, and the oldest kept is not read as it is overwritten next.
+#define RADIANT_PROFILE_THREAD_EVENTS (1u << 16)
+/// The most threads recording at once. Threads past this record nothing.
+#define RADIANT_PROFILE_MAX_THREADS 64
+/// The deepest scopes are nested. Deeper scopes are not reported.
+#define RADIANT_PROFILE_MAX_DEPTH 64
+
+#if defined(RADIANT_PROFILE_ENABLED)
+/// @private
+#define RADIANT_PROFILE_CONCAT_INNER(a, b) a##b
+/// @private
+#define RADIANT_PROFILE_CONCAT(a, b) RADIANT_PROFILE_CONCAT_INNER(a, b)
+
+/// Records the time from here to the end of the enclosing block as a scope
+/// called |name|, a string that must outlive the profile.
+#define RADIANT_PROFILE_SCOPE(name)                                      \
+  radiant_profile_scope_t RADIANT_PROFILE_CONCAT(profile_scope_, __LINE__) \
+      __attribute__((cleanup(radiant_profile_scope_end))) =              \
+          radiant_profile_scope_begin(name)
+/// Begins a scope called |name| that RADIANT_PROFILE_END ends, for scopes
+/// that are not a block.
+#define RADIANT_PROFILE_BEGIN(name) radiant_profile_begin(name)
+/// Ends the scope begun last on this thread.
+#define RADIANT_PROFILE_END() radiant_profile_end()
+#else
+#define RADIANT_PROFILE_SCOPE(name) ((void)0)
+#define RADIANT_PROFILE_BEGIN(name) ((void)0)
+#define RADIANT_PROFILE_END() ((void)0)
+#endif
+
+/// @private
+/// The scope RADIANT_PROFILE_SCOPE is recording.
+typedef struct radiant_profile_scope_t {
+  const char* name;
+} radiant_profile_scope_t;
+
+/// Time spent in the scopes of a name
+typedef struct radiant_profile_stats_t {
+  /// The name of the scopes
+  const char* name;
+  /// Scopes of |name| that ended
+  uint64_t calls;
+  /// Milliseconds from begin to end, summed over the scopes
+  double inclusive_ms;
+  /// |inclusive_ms| less the time in scopes nested in them
+  double exclusive_ms;
+} radiant_profile_stats_t;
+
+/// Records the begin of a scope called |name| on this thread. Allocates
+/// nothing but the thread's events on its first scope.
+void radiant_profile_begin(const char* name);
+
+/// Records the end of the scope begun last on this thread.
+void radiant_profile_end(void);
+
+/// @private
+radiant_profile_scope_t radiant_profile_scope_begin(const char* name);
+/// @private
+void radiant_profile_scope_end(radiant_profile_scope_t* scope);
+
+/// Forgets every event recorded so far.
+void radiant_profile_reset(void);
+
+/// Fills |stats| with the time spent in each scope name recorded, up to
+/// |capacity| names, most inclusive time first. Returns the names filled in.
+/// Only scopes with both ends still recorded are counted.
+///
+/// Note: may run while other threads record. Events recorded meanwhile may
+/// or may not be counted, and scopes whose events are overwritten while this
+/// reads them are dropped.
+uint32_t radiant_profile_aggregate(radiant_profile_stats_t* stats,
+                                   uint32_t capacity);
+
+/// Writes the recorded scopes to |file| as Chrome trace event JSON, to load
+/// in chrome://tracing or Perfetto.
+void radiant_profile_write_chrome_trace(radiant_file_t file);
@@ -0,0 +1,261 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/profile.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "src/job.h"
+#include "src/test.h"
+
+#define STATS 8
+#define THREAD_SCOPES 100
+#define JOBS 16
+/// Enough for a few scopes of JSON
+#define TRACE_BYTES 4096
+
+/// Returns the stats of |name| in the first |count| of |stats|, or NULL.
+static const radiant_profile_stats_t* find(const radiant_profile_stats_t* stats,
+                                           uint32_t count,
+                                           const char* name) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (strcmp(stats[i].name, name) == 0) {
+      return &stats[i];
+    }
+  }
+  return NULL;
+}
+
+/// Spins until the clock moves so scopes take some time.
+static void spin() {
+  radiant_time_t begin = radiant_time();
+  while (radiant_time() == begin) {
+  }
+}
+
+/// Nested scopes count towards the inclusive time of their parents but not
+/// the exclusive.
+static bool nested() {
+  radiant_profile_reset();
+  radiant_profile_begin("outer");
+  spin();
+  for (uint32_t i = 0; i < 3; ++i) {
+    radiant_profile_begin("inner");
+    spin();
+    radiant_profile_end();
+  }
+  radiant_profile_end();
+
+  radiant_profile_stats_t stats[STATS];
+  uint32_t count = radiant_profile_aggregate(stats, STATS);
+  RADIANT_EXPECT_EQ(count, 2);
+  // Most inclusive time first.
+  RADIANT_EXPECT_TRUE(strcmp(stats[0].name, "outer") == 0);
+  const radiant_profile_stats_t* outer = find(stats, count, "outer");
+  const radiant_profile_stats_t* inner = find(stats, count, "inner");
+  RADIANT_EXPECT_NOT_NULL(outer);
+  RADIANT_EXPECT_NOT_NULL(inner);
+  RADIANT_EXPECT_TRUE(outer->calls == 1);
+  RADIANT_EXPECT_TRUE(inner->calls == 3);
+  RADIANT_EXPECT_TRUE(inner->inclusive_ms > 0.0);
+  RADIANT_EXPECT_DOUBLE_EQ(inner->exclusive_ms, inner->inclusive_ms);
+  RADIANT_EXPECT_TRUE(outer->inclusive_ms >= inner->inclusive_ms);
+  RADIANT_EXPECT_DOUBLE_EQ(outer->exclusive_ms,
+                           outer->inclusive_ms - inner->inclusive_ms);
+  return true;
+}
+
+/// Resetting forgets what was recorded, and ends without a begin are
+/// ignored.
+static bool reset() {
+  radiant_profile_begin("forgotten");
+  radiant_profile_end();
+  radiant_profile_reset();
+  radiant_profile_end();
+
+  radiant_profile_stats_t stats[STATS];
+  RADIANT_EXPECT_EQ(radiant_profile_aggregate(stats, STATS), 0);
+  return true;
+}
+
+/// Names past the capacity are left out.
+static bool capacity() {
+  radiant_profile_reset();
+  radiant_profile_begin("a");
+  radiant_profile_end();
+  radiant_profile_begin("b");
+  radiant_profile_end();
+
+  radiant_profile_stats_t stats[1];
+  RADIANT_EXPECT_EQ(radiant_profile_aggregate(stats, 1), 1);
+  RADIANT_EXPECT_TRUE(strcmp(stats[0].name, "a") == 0);
+  return true;
+}
+
+/// Only the latest RADIANT_PROFILE_THREAD_EVENTS - 1 events are read.
+static bool overwrites_oldest() {
+  radiant_profile_reset();
+  for (uint32_t i = 0; i < RADIANT_PROFILE_THREAD_EVENTS; ++i) {
+    radiant_profile_begin("scope");
+    radiant_profile_end();
+  }
+  radiant_profile_begin("latest");
+  radiant_profile_end();
+
+  radiant_profile_stats_t stats[STATS];
+  uint32_t count = radiant_profile_aggregate(stats, STATS);
+  RADIANT_EXPECT_EQ(count, 2);
+  const radiant_profile_stats_t* scope = find(stats, count, "scope");
+  RADIANT_EXPECT_NOT_NULL(scope);
+  // The oldest event read is the end of a scope whose begin is gone.
+  RADIANT_EXPECT_TRUE(scope->calls == (RADIANT_PROFILE_THREAD_EVENTS / 2) - 2);
+  return true;
+}
+
+static void record_scopes(void* /* userdata */, uint32_t /* index */) {
+  for (uint32_t i = 0; i < THREAD_SCOPES; ++i) {
+    radiant_profile_begin("job");
+    radiant_profile_end();
+  }
+}
+
+static void record_task(void* /* userdata */) {
+  record_scopes(NULL, 0);
+}
+
+/// Each thread records into its own events, and threads that exit hand
+/// theirs on, so more threads than rings may record one after another.
+static bool threads() {
+  radiant_profile_reset();
+  for (uint32_t i = 0; i < 4; ++i) {
+    radiant_job_parallel_for(JOBS, 4, record_scopes, NULL);
+  }
+  for (uint32_t i = 0; i < 2 * RADIANT_PROFILE_MAX_THREADS; ++i) {
+    radiant_job_wait(radiant_job_async(record_task, NULL));
+  }
+
+  radiant_profile_stats_t stats[STATS];
+  uint32_t count = radiant_profile_aggregate(stats, STATS);
+  RADIANT_EXPECT_EQ(count, 1);
+  RADIANT_EXPECT_TRUE(stats[0].calls ==
+                      ((4 * JOBS) + (2 * RADIANT_PROFILE_MAX_THREADS)) *
+                          THREAD_SCOPES);
+  return true;
+}
+
+static atomic_bool recording;
+
+/// Records nested scopes until |recording| is cleared, wrapping the ring.
+static void* record_nested(void* /* userdata */) {
+  while (atomic_load(&recording)) {
+    radiant_profile_begin("outer");
+    radiant_profile_begin("inner");
+    radiant_profile_end();
+    radiant_profile_end();
+  }
+  return NULL;
+}
+
+/// Aggregating while a thread overwrites its events pairs only whole
+/// events.
+static bool reads_while_recording() {
+  radiant_profile_reset();
+  atomic_store(&recording, true);
+  pthread_t thread;
+  RADIANT_EXPECT_EQ(pthread_create(&thread, NULL, record_nested, NULL), 0);
+
+  bool paired = true;
+  for (uint32_t i = 0; i < 64 && paired; ++i) {
+    radiant_profile_stats_t stats[STATS];
+    uint32_t count = radiant_profile_aggregate(stats, STATS);
+    for (uint32_t s = 0; s < count; ++s) {
+      paired &= strcmp(stats[s].name, "outer") == 0 ||
+                strcmp(stats[s].name, "inner") == 0;
+    }
+    const radiant_profile_stats_t* inner = find(stats, count, "inner");
+    if (inner) {
+      paired &= inner->exclusive_ms == inner->inclusive_ms;
+    }
+  }
+
+  atomic_store(&recording, false);
+  pthread_join(thread, NULL);
+  RADIANT_EXPECT_TRUE(paired);
+  return true;
+}
+
+static bool chrome_trace() {
+  radiant_profile_reset();
+  radiant_profile_begin("frame");
+  radiant_profile_begin("say \"hi\"");
+  radiant_profile_end();
+  radiant_profile_end();
+
+  char buffer[TRACE_BYTES] = {0};
+  radiant_file_result_t result = radiant_file_mem_open(buffer, TRACE_BYTES);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_profile_write_chrome_trace(result.file);
+  radiant_file_close(result.file);
+
+  RADIANT_EXPECT_TRUE(strncmp(buffer, "{\"traceEvents\":[", 16) == 0);
+  RADIANT_EXPECT_TRUE(strstr(buffer, "\"name\":\"frame\",\"ph\":\"X\""));
+  RADIANT_EXPECT_TRUE(strstr(buffer, "\"name\":\"say \\\"hi\\\"\""));
+  // Inner scopes end first.
+  RADIANT_EXPECT_TRUE(strstr(buffer, "say") < strstr(buffer, "frame"));
+  RADIANT_EXPECT_TRUE(strstr(buffer, "\n]}\n"));
+  return true;
+}
+
+#if defined(RADIANT_PROFILE_ENABLED)
+/// RADIANT_PROFILE_SCOPE ends its scope with the block.
+static bool scope_macro() {
+  radiant_profile_reset();
+  {
+    RADIANT_PROFILE_SCOPE("block");
+    RADIANT_PROFILE_SCOPE("nested");
+  }
+  RADIANT_PROFILE_BEGIN("after");
+  RADIANT_PROFILE_END();
+
+  radiant_profile_stats_t stats[STATS];
+  uint32_t count = radiant_profile_aggregate(stats, STATS);
+  RADIANT_EXPECT_EQ(count, 3);
+  const radiant_profile_stats_t* block = find(stats, count, "block");
+  const radiant_profile_stats_t* nested = find(stats, count, "nested");
+  RADIANT_EXPECT_NOT_NULL(block);
+  RADIANT_EXPECT_NOT_NULL(nested);
+  RADIANT_EXPECT_NOT_NULL(find(stats, count, "after"));
+  // Declared later, the nested scope ends first.
+  RADIANT_EXPECT_TRUE(block->inclusive_ms >= nested->inclusive_ms);
+  RADIANT_EXPECT_TRUE(block->calls == 1 && nested->calls == 1);
+  return true;
+}
+#endif
+
+int main() {
+  radiant_suite_begin("profile");
+  RADIANT_TEST(nested);
+  RADIANT_TEST(reset);
+  RADIANT_TEST(capacity);
+  RADIANT_TEST(overwrites_oldest);
+  RADIANT_TEST(threads);
+  RADIANT_TEST(reads_while_recording);
+  RADIANT_TEST(chrome_trace);
+#if defined(RADIANT_PROFILE_ENABLED)
+  RADIANT_TEST(scope_macro);
+#endif
+  return radiant_suite_end();
+}
@@ -0,0 +1,199 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/quat.h"
+
+#include <math.h>
+
+#include "src/angle.h"
+#include "src/assert.h"
+#include "src/simd.h"
+
+/// Above this dot product radiant_quat_slerp falls back to nlerp, the angle
+/// is too small for the sin divide to be accurate.
+static const float kSlerpThreshold = 0.9995f;
+
+radiant_quat_t radiant_quat_identity(void) {
+  return (radiant_quat_t){
+      .x = 0.f,
+      .y = 0.f,
+      .z = 0.f,
+      .w = 1.f,
+  };
+}
+
+radiant_quat_t radiant_quat_from_axis_angle(radiant_vec3_t axis,
+                                            float angle_radians) {
+  radiant_sincos_t sc = radiant_sincos(angle_radians * 0.5f);
+  return (radiant_quat_t){
+      .x = axis.x * sc.sin,
+      .y = axis.y * sc.sin,
+      .z = axis.z * sc.sin,
+      .w = sc.cos,
+  };
+}
+
+radiant_quat_t radiant_quat_from_euler(radiant_point3_t angles_in_radians) {
+  radiant_sincos_t x = radiant_sincos(angles_in_radians.x * 0.5f);
+  radiant_sincos_t y = radiant_sincos(angles_in_radians.y * 0.5f);
+  radiant_sincos_t z = radiant_sincos(angles_in_radians.z * 0.5f);
+  float sx = x.sin;
+  float cx = x.cos;
+  float sy = y.sin;
+  float cy = y.cos;
+  float sz = z.sin;
+  float cz = z.cos;
+
+  // qx * qy * qz expanded.
+  return (radiant_quat_t){
+      .x = (sx * cy * cz) + (cx * sy * sz),
+      .y = (cx * sy * cz) - (sx * cy * sz),
+      .z = (cx * cy * sz) + (sx * sy * cz),
+      .w = (cx * cy * cz) - (sx * sy * sz),
+  };
+}
+
+radiant_quat_t radiant_quat_mul(radiant_quat_t a, radiant_quat_t b) {
+  return (radiant_quat_t){
+      .x = (a.w * b.x) + (a.x * b.w) + (a.y * b.z) - (a.z * b.y),
+      .y = (a.w * b.y) - (a.x * b.z) + (a.y * b.w) + (a.z * b.x),
+      .z = (a.w * b.z) + (a.x * b.y) - (a.y * b.x) + (a.z * b.w),
+      .w = (a.w * b.w) - (a.x * b.x) - (a.y * b.y) - (a.z * b.z),
+  };
+}
+
+radiant_quat_t radiant_quat_conjugate(radiant_quat_t q) {
+  return (radiant_quat_t){
+      .x = -q.x,
+      .y = -q.y,
+      .z = -q.z,
+      .w = q.w,
+  };
+}
+
+float radiant_quat_dot(radiant_quat_t a, radiant_quat_t b) {
+  return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
+}
+
+radiant_quat_t radiant_quat_normalize(radiant_quat_t q) {
+  float len = sqrtf(radiant_quat_dot(q, q));
+  RADIANT_ASSERT(len != 0.f);
+
+  float inv = 1.f / len;
+  return (radiant_quat_t){
+      .x = q.x * inv,
+      .y = q.y * inv,
+      .z = q.z * inv,
+      .w = q.w * inv,
+  };
+}
+
+radiant_quat_t radiant_quat_nlerp(radiant_quat_t a, radiant_quat_t b, float t) {
+  // q and -q are the same rotation, flip |b| so the blend takes the short way.
+  float bt = radiant_quat_dot(a, b) < 0.f ? -t : t;
+  float at = 1.f - t;
+  return radiant_quat_normalize((radiant_quat_t){
+      .x = (at * a.x) + (bt * b.x),
+      .y = (at * a.y) + (bt * b.y),
+      .z = (at * a.z) + (bt * b.z),
+      .w = (at * a.w) + (bt * b.w),
+  });
+}
+
+radiant_quat_t radiant_quat_slerp(radiant_quat_t a, radiant_quat_t b, float t) {
+  float d = radiant_quat_dot(a, b);
+  if (d < 0.f) {
+    b = (radiant_quat_t){-b.x, -b.y, -b.z, -b.w};
+    d = -d;
+  }
+  if (d > kSlerpThreshold) {
+    return radiant_quat_nlerp(a, b, t);
+  }
+
+  float theta = acosf(d);
+  float inv_sin = 1.f / sinf(theta);
+  float at = sinf((1.f - t) * theta) * inv_sin;
+  float bt = sinf(t * theta) * inv_sin;
+  return (radiant_quat_t){
+      .x = (at * a.x) + (bt * b.x),
+      .y = (at * a.y) + (bt * b.y),
+      .z = (at * a.z) + (bt * b.z),
+      .w = (at * a.w) + (bt * b.w),
+  };
+}
+
+radiant_mat3x3_t radiant_quat_to_mat3x3(radiant_quat_t q) {
+  float xx = q.x * q.x;
+  float yy = q.y * q.y;
+  float zz = q.z * q.z;
+  float xy = q.x * q.y;
+  float xz = q.x * q.z;
+  float yz = q.y * q.z;
+  float wx = q.w * q.x;
+  float wy = q.w * q.y;
+  float wz = q.w * q.z;
+
+  return (radiant_mat3x3_t){
+      // clang-format off
+      .data = {
+          1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f,
+          2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f,
+          2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f,
+      },
+      // clang-format on
+  };
+}
+
+radiant_mat4x4_t radiant_quat_to_mat4x4(radiant_quat_t q) {
+  radiant_mat3x3_t r = radiant_quat_to_mat3x3(q);
+  return (radiant_mat4x4_t){
+      // clang-format off
+      .data = {
+          r.data[0], r.data[1], r.data[2], 0.f,
+          r.data[4], r.data[5], r.data[6], 0.f,
+          r.data[8], r.data[9], r.data[10], 0.f,
+          0.f, 0.f, 0.f, 1.f,
+      },
+      // clang-format on
+  };
+}
+
+radiant_vec3_t radiant_quat_rotate_vec3(radiant_quat_t q, radiant_vec3_t v) {
+  // v + w * t + u x t where u is the vector part of |q| and t = 2 * (u x v).
+  radiant_vec3_t u = {q.x, q.y, q.z};
+  radiant_vec3_t t = radiant_vec3_mul(radiant_vec3_cross(u, v), 2.f);
+  radiant_vec3_t ut = radiant_vec3_cross(u, t);
+  return (radiant_vec3_t){
+      .x = v.x + (q.w * t.x) + ut.x,
+      .y = v.y + (q.w * t.y) + ut.y,
+      .z = v.z + (q.w * t.z) + ut.z,
+  };
+}
+
+radiant_point3_t radiant_quat_rotate_point3(radiant_quat_t q,
+                                            radiant_point3_t p) {
+  radiant_vec3_t v =
+      radiant_quat_rotate_vec3(q, (radiant_vec3_t){p.x, p.y, p.z});
+  return (radiant_point3_t){v.x, v.y, v.z};
+}
+
+void radiant_quat_nlerp_batch(const radiant_quat_t* a,
+                              const radiant_quat_t* b,
+                              float t,
+                              radiant_quat_t* out,
+                              uint32_t count) {
+  RADIANT_ASSERT(!(t < 0.0f));
+  RADIANT_ASSERT(!(t > 1.0f));
+  radiant_simd_ops()->quat_nlerp_batch(out, a, b, t, count);
+}
@@ -0,0 +1,86 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/mat3x3.h"
+#include "src/mat4x4.h"
+#include "src/point3.h"
+#include "src/vec3.h"
+
+/// A rotation quaternion, x, y, z is the vector part and w the scalar part.
+typedef struct radiant_quat_t {
+  float x;
+  float y;
+  float z;
+  float w;
+} radiant_quat_t;
+
+/// Returns the identity rotation.
+radiant_quat_t radiant_quat_identity(void);
+
+/// Returns the rotation of |angle_radians| around |axis|. |axis| must be
+/// normalized.
+radiant_quat_t radiant_quat_from_axis_angle(radiant_vec3_t axis,
+                                            float angle_radians);
+
+/// Returns the rotation built by radiant_mat4x4_rotate for the same
+/// |angles_in_radians|.
+radiant_quat_t radiant_quat_from_euler(radiant_point3_t angles_in_radians);
+
+/// Returns |a| * |b|, the rotation |b| followed by |a|.
+radiant_quat_t radiant_quat_mul(radiant_quat_t a, radiant_quat_t b);
+
+/// Returns the conjugate of |q|, which is the inverse rotation when |q| is
+/// normalized.
+radiant_quat_t radiant_quat_conjugate(radiant_quat_t q);
+
+/// Returns the dot product of |a| and |b|.
+float radiant_quat_dot(radiant_quat_t a, radiant_quat_t b);
+
+/// Returns a normalized copy of |q|.
+radiant_quat_t radiant_quat_normalize(radiant_quat_t q);
+
+/// Normalized linear interpolation between |a| and |b| based on time |t|,
+/// taking the shortest path. Cheaper than radiant_quat_slerp but does not
+/// move at a constant angular velocity.
+radiant_quat_t radiant_quat_nlerp(radiant_quat_t a, radiant_quat_t b, float t);
+
+/// Spherical linear interpolation between |a| and |b| based on time |t|,
+/// taking the shortest path.
+radiant_quat_t radiant_quat_slerp(radiant_quat_t a, radiant_quat_t b, float t);
+
+/// Returns the rotation matrix for |q|. |q| must be normalized.
+radiant_mat3x3_t radiant_quat_to_mat3x3(radiant_quat_t q);
+
+/// Returns the rotation matrix for |q|. |q| must be normalized.
+radiant_mat4x4_t radiant_quat_to_mat4x4(radiant_quat_t q);
+
+/// Returns |v| rotated by |q|. |q| must be normalized.
+radiant_vec3_t radiant_quat_rotate_vec3(radiant_quat_t q, radiant_vec3_t v);
+
+/// Returns |p| rotated about the origin by |q|. |q| must be normalized.
+radiant_point3_t radiant_quat_rotate_point3(radiant_quat_t q,
+                                            radiant_point3_t p);
+
+/// Stores radiant_quat_nlerp(|a|[i], |b|[i], |t|) into |out|[i] for |count|
+/// quaternions, as when blending two animation poses. |out| may be |a| or
+/// |b|.
+void radiant_quat_nlerp_batch(const radiant_quat_t* a,
+                              const radiant_quat_t* b,
+                              float t,
+                              radiant_quat_t* out,
+                              uint32_t count);
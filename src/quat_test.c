@@ -0,0 +1,194 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/quat.h"
+
+#include <math.h>
+
+#include "src/test.h"
+
+/// Not a multiple of any vector width so the remainder paths run.
+#define COUNT 19
+
+static uint32_t rng_state = 1;
+
+/// Returns a pseudo random float in [-4, 4).
+static float next_float(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((float)(rng_state >> 8) / (float)(1u << 24)) * 8.0f - 4.0f;
+}
+
+static radiant_quat_t random_quat(void) {
+  return radiant_quat_from_euler(
+      (radiant_point3_t){next_float(), next_float(), next_float()});
+}
+
+static bool mat4x4_equal(radiant_mat4x4_t a, radiant_mat4x4_t b) {
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (!radiant_equal(a.data[i], b.data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool identity() {
+  radiant_quat_t q = radiant_quat_identity();
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_quat_to_mat4x4(q), radiant_mat4x4_identity()));
+  return true;
+}
+
+static bool from_axis_angle() {
+  RADIANT_EXPECT_TRUE(mat4x4_equal(
+      radiant_quat_to_mat4x4(radiant_quat_from_axis_angle(
+          (radiant_vec3_t){1.f, 0.f, 0.f}, 0.7f)),
+      radiant_mat4x4_rotate_x(0.7f)));
+  RADIANT_EXPECT_TRUE(mat4x4_equal(
+      radiant_quat_to_mat4x4(radiant_quat_from_axis_angle(
+          (radiant_vec3_t){0.f, 1.f, 0.f}, -1.3f)),
+      radiant_mat4x4_rotate_y(-1.3f)));
+  RADIANT_EXPECT_TRUE(mat4x4_equal(
+      radiant_quat_to_mat4x4(radiant_quat_from_axis_angle(
+          (radiant_vec3_t){0.f, 0.f, 1.f}, 2.5f)),
+      radiant_mat4x4_rotate_z(2.5f)));
+  return true;
+}
+
+static bool from_euler() {
+  radiant_point3_t angles = {0.4f, -0.9f, 1.7f};
+  RADIANT_EXPECT_TRUE(
+      mat4x4_equal(radiant_quat_to_mat4x4(radiant_quat_from_euler(angles)),
+                   radiant_mat4x4_rotate(angles)));
+  return true;
+}
+
+static bool mul() {
+  for (uint32_t i = 0; i < 16; ++i) {
+    radiant_quat_t a = random_quat();
+    radiant_quat_t b = random_quat();
+    RADIANT_EXPECT_TRUE(
+        mat4x4_equal(radiant_quat_to_mat4x4(radiant_quat_mul(a, b)),
+                     radiant_mat4x4_mul(radiant_quat_to_mat4x4(a),
+                                        radiant_quat_to_mat4x4(b))));
+
+    // The conjugate undoes the rotation
+    radiant_quat_t r = radiant_quat_mul(a, radiant_quat_conjugate(a));
+    RADIANT_EXPECT_FLOAT_EQ(r.x, 0.f);
+    RADIANT_EXPECT_FLOAT_EQ(r.y, 0.f);
+    RADIANT_EXPECT_FLOAT_EQ(r.z, 0.f);
+    RADIANT_EXPECT_FLOAT_EQ(r.w, 1.f);
+  }
+  return true;
+}
+
+static bool normalize() {
+  radiant_quat_t q =
+      radiant_quat_normalize((radiant_quat_t){1.f, 2.f, 2.f, 4.f});
+  RADIANT_EXPECT_FLOAT_EQ(q.x, 0.2f);
+  RADIANT_EXPECT_FLOAT_EQ(q.y, 0.4f);
+  RADIANT_EXPECT_FLOAT_EQ(q.z, 0.4f);
+  RADIANT_EXPECT_FLOAT_EQ(q.w, 0.8f);
+  return true;
+}
+
+static bool rotate_vec3() {
+  for (uint32_t i = 0; i < 16; ++i) {
+    radiant_quat_t q = random_quat();
+    radiant_vec3_t v = {next_float(), next_float(), next_float()};
+
+    radiant_vec3_t expected = radiant_mat4x4_mul(radiant_quat_to_mat4x4(q), v);
+    radiant_vec3_t r = radiant_quat_rotate_vec3(q, v);
+    RADIANT_EXPECT_FLOAT_EQ(expected.x, r.x);
+    RADIANT_EXPECT_FLOAT_EQ(expected.y, r.y);
+    RADIANT_EXPECT_FLOAT_EQ(expected.z, r.z);
+
+    radiant_point3_t p =
+        radiant_quat_rotate_point3(q, (radiant_point3_t){v.x, v.y, v.z});
+    RADIANT_EXPECT_FLOAT_EQ(expected.x, p.x);
+    RADIANT_EXPECT_FLOAT_EQ(expected.y, p.y);
+    RADIANT_EXPECT_FLOAT_EQ(expected.z, p.z);
+  }
+  return true;
+}
+
+static bool interpolate() {
+  radiant_vec3_t axis = {0.f, 1.f, 0.f};
+  radiant_quat_t a = radiant_quat_from_axis_angle(axis, 0.f);
+  radiant_quat_t b = radiant_quat_from_axis_angle(axis, 1.f);
+
+  // Slerp moves at a constant angular velocity
+  radiant_quat_t s = radiant_quat_slerp(a, b, 0.25f);
+  radiant_quat_t e = radiant_quat_from_axis_angle(axis, 0.25f);
+  RADIANT_EXPECT_FLOAT_EQ(s.y, e.y);
+  RADIANT_EXPECT_FLOAT_EQ(s.w, e.w);
+
+  // Nlerp matches at the midpoint
+  radiant_quat_t n = radiant_quat_nlerp(a, b, 0.5f);
+  e = radiant_quat_from_axis_angle(axis, 0.5f);
+  RADIANT_EXPECT_FLOAT_EQ(n.y, e.y);
+  RADIANT_EXPECT_FLOAT_EQ(n.w, e.w);
+
+  // The negated quaternion is the same rotation, the short path is taken
+  radiant_quat_t neg_b = {-b.x, -b.y, -b.z, -b.w};
+  s = radiant_quat_slerp(a, neg_b, 0.25f);
+  e = radiant_quat_from_axis_angle(axis, 0.25f);
+  RADIANT_EXPECT_FLOAT_EQ(s.y, e.y);
+  RADIANT_EXPECT_FLOAT_EQ(s.w, e.w);
+  n = radiant_quat_nlerp(a, neg_b, 0.5f);
+  e = radiant_quat_from_axis_angle(axis, 0.5f);
+  RADIANT_EXPECT_FLOAT_EQ(n.y, e.y);
+  RADIANT_EXPECT_FLOAT_EQ(n.w, e.w);
+  return true;
+}
+
+static bool nlerp_batch() {
+  radiant_quat_t a[COUNT];
+  radiant_quat_t b[COUNT];
+  radiant_quat_t out[COUNT];
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    a[i] = random_quat();
+    b[i] = random_quat();
+  }
+
+  radiant_quat_nlerp_batch(a, b, 0.3f, out, COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_quat_t e = radiant_quat_nlerp(a[i], b[i], 0.3f);
+    RADIANT_EXPECT_FLOAT_EQ(e.x, out[i].x);
+    RADIANT_EXPECT_FLOAT_EQ(e.y, out[i].y);
+    RADIANT_EXPECT_FLOAT_EQ(e.z, out[i].z);
+    RADIANT_EXPECT_FLOAT_EQ(e.w, out[i].w);
+  }
+
+  // In place
+  radiant_quat_nlerp_batch(a, b, 0.3f, a, COUNT);
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    RADIANT_EXPECT_FLOAT_EQ(a[i].x, out[i].x);
+    RADIANT_EXPECT_FLOAT_EQ(a[i].w, out[i].w);
+  }
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("quat");
+  RADIANT_TEST(identity);
+  RADIANT_TEST(from_axis_angle);
+  RADIANT_TEST(from_euler);
+  RADIANT_TEST_ALL_BACKENDS(mul);
+  RADIANT_TEST(normalize);
+  RADIANT_TEST(rotate_vec3);
+  RADIANT_TEST(interpolate);
+  RADIANT_TEST_ALL_BACKENDS(nlerp_batch);
+  return radiant_suite_end();
+}
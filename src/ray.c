@@ -0,0 +1,163 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ray.h"
+
+#include <float.h>
+#include <math.h>
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+radiant_point3_t radiant_ray_at(radiant_ray_t ray, float t) {
+  return (radiant_point3_t){
+      .x = ray.origin.x + (ray.direction.x * t),
+      .y = ray.origin.y + (ray.direction.y * t),
+      .z = ray.origin.z + (ray.direction.z * t),
+  };
+}
+
+radiant_ray_triangle_hit_t radiant_ray_intersect_triangle(radiant_ray_t ray,
+                                                          radiant_point3_t a,
+                                                          radiant_point3_t b,
+                                                          radiant_point3_t c) {
+  // A one element stream viewing the stack, so there is a single
+  // implementation of the test.
+  float v0[3] = {a.x, a.y, a.z};
+  float edge1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+  float edge2[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+  radiant_triangle_soa_t triangle = {
+      .v0 = {.x = &v0[0], .y = &v0[1], .z = &v0[2], .count = 1},
+      .edge1 = {.x = &edge1[0], .y = &edge1[1], .z = &edge1[2], .count = 1},
+      .edge2 = {.x = &edge2[0], .y = &edge2[1], .z = &edge2[2], .count = 1},
+  };
+  return radiant_simd_ops()->ray_intersect_triangles(&ray, &triangle, 0, 1);
+}
+
+/// Returns 1 / |x| clamped to the finite floats.
+static float finite_reciprocal(float x) {
+  return fminf(fmaxf(1.f / x, -FLT_MAX), FLT_MAX);
+}
+
+radiant_vec3_t radiant_ray_inv_direction(radiant_vec3_t direction) {
+  return (radiant_vec3_t){
+      .x = finite_reciprocal(direction.x),
+      .y = finite_reciprocal(direction.y),
+      .z = finite_reciprocal(direction.z),
+  };
+}
+
+radiant_ray_aabb_hit_t radiant_ray_intersect_aabb(radiant_ray_t ray,
+                                                  radiant_aabb_t box) {
+  radiant_vec3_t inv = radiant_ray_inv_direction(ray.direction);
+  float x1 = (box.min.x - ray.origin.x) * inv.x;
+  float x2 = (box.max.x - ray.origin.x) * inv.x;
+  float y1 = (box.min.y - ray.origin.y) * inv.y;
+  float y2 = (box.max.y - ray.origin.y) * inv.y;
+  float z1 = (box.min.z - ray.origin.z) * inv.z;
+  float z2 = (box.max.z - ray.origin.z) * inv.z;
+
+  float t_near = fmaxf(fmaxf(fminf(x1, x2), fminf(y1, y2)),
+                       fmaxf(fminf(z1, z2), ray.t_min));
+  float t_far = fminf(fminf(fmaxf(x1, x2), fmaxf(y1, y2)),
+                      fminf(fmaxf(z1, z2), ray.t_max));
+  return (radiant_ray_aabb_hit_t){
+      .t_near = t_near,
+      .t_far = t_far,
+      .hit = t_near <= t_far,
+  };
+}
+
+radiant_triangle_soa_t radiant_triangle_soa_create(uint32_t count) {
+  radiant_triangle_soa_t soa = {
+      .v0 = radiant_point3_soa_create(count),
+      .edge1 = radiant_vec3_soa_create(count),
+      .edge2 = radiant_vec3_soa_create(count),
+  };
+  if (soa.v0.count != count || soa.edge1.count != count ||
+      soa.edge2.count != count) {
+    radiant_triangle_soa_destroy(soa);
+    return (radiant_triangle_soa_t){0};
+  }
+  return soa;
+}
+
+void radiant_triangle_soa_destroy(radiant_triangle_soa_t soa) {
+  radiant_point3_soa_destroy(soa.v0);
+  radiant_vec3_soa_destroy(soa.edge1);
+  radiant_vec3_soa_destroy(soa.edge2);
+}
+
+uint32_t radiant_triangle_soa_count(radiant_triangle_soa_t soa) {
+  return soa.v0.count;
+}
+
+void radiant_triangle_soa_set(radiant_triangle_soa_t soa,
+                              uint32_t idx,
+                              radiant_point3_t a,
+                              radiant_point3_t b,
+                              radiant_point3_t c) {
+  radiant_point3_soa_set(soa.v0, idx, a);
+  radiant_vec3_soa_set(soa.edge1, idx, radiant_point3_sub(b, a));
+  radiant_vec3_soa_set(soa.edge2, idx, radiant_point3_sub(c, a));
+}
+
+radiant_ray_triangle_hit_t radiant_ray_intersect_triangles(
+    radiant_ray_t ray,
+    radiant_triangle_soa_t triangles,
+    uint32_t begin,
+    uint32_t end) {
+  RADIANT_ASSERT(begin <= end);
+  RADIANT_ASSERT(end <= radiant_triangle_soa_count(triangles));
+  return radiant_simd_ops()->ray_intersect_triangles(&ray, &triangles, begin,
+                                                     end);
+}
+
+radiant_ray_soa_t radiant_ray_soa_create(uint32_t count) {
+  radiant_ray_soa_t soa = {
+      .origins = radiant_point3_soa_create(count),
+      .inv_directions = radiant_vec3_soa_create(count),
+  };
+  if (soa.origins.count != count || soa.inv_directions.count != count) {
+    radiant_ray_soa_destroy(soa);
+    return (radiant_ray_soa_t){0};
+  }
+  return soa;
+}
+
+void radiant_ray_soa_destroy(radiant_ray_soa_t soa) {
+  radiant_point3_soa_destroy(soa.origins);
+  radiant_vec3_soa_destroy(soa.inv_directions);
+}
+
+uint32_t radiant_ray_soa_count(radiant_ray_soa_t soa) {
+  return soa.origins.count;
+}
+
+void radiant_ray_soa_set(radiant_ray_soa_t soa,
+                         uint32_t idx,
+                         radiant_point3_t origin,
+                         radiant_vec3_t direction) {
+  radiant_point3_soa_set(soa.origins, idx, origin);
+  radiant_vec3_soa_set(soa.inv_directions, idx,
+                       radiant_ray_inv_direction(direction));
+}
+
+void radiant_ray_soa_intersect_aabb(radiant_ray_soa_t rays,
+                                    radiant_aabb_t box,
+                                    float t_max,
+                                    float* t_out) {
+  RADIANT_ASSERT(t_out || radiant_ray_soa_count(rays) == 0);
+  radiant_simd_ops()->ray_soa_intersect_aabb(t_out, &rays, &box, t_max);
+}
@@ -0,0 +1,158 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/bounds.h"
+#include "src/pad.h"
+#include "src/point3.h"
+#include "src/soa.h"
+#include "src/vec3.h"
+
+/// A ray, covering the points |origin| + t * |direction| for t in
+/// [|t_min|, |t_max|].
+typedef struct radiant_ray_t {
+  /// The start of the ray
+  radiant_point3_t origin;
+  /// The direction, not necessarily normalized
+  radiant_vec3_t direction;
+  /// The closest distance, in multiples of |direction|, that counts as a hit
+  float t_min;
+  /// The furthest distance, in multiples of |direction|, that counts as a hit
+  float t_max;
+} radiant_ray_t;
+
+/// Returns the point at |t| along |ray|.
+radiant_point3_t radiant_ray_at(radiant_ray_t ray, float t);
+
+/// The result of intersecting a ray with triangles.
+typedef struct radiant_ray_triangle_hit_t {
+  /// The distance along the ray. Only valid if |hit| is true.
+  float t;
+  /// The barycentric weight of the second vertex at the hit
+  float u;
+  /// The barycentric weight of the third vertex at the hit
+  float v;
+  /// The index of the triangle hit
+  uint32_t index;
+  /// True if a triangle was hit
+  bool hit;
+  /// Unused padding
+  RADIANT_PAD(3);
+} radiant_ray_triangle_hit_t;
+
+/// The result of intersecting a ray with a box.
+typedef struct radiant_ray_aabb_hit_t {
+  /// The distance along the ray where it enters the box, clamped to the
+  /// start of the ray. Only valid if |hit| is true.
+  float t_near;
+  /// The distance along the ray where it leaves the box, clamped to the end
+  /// of the ray.
+  float t_far;
+  /// True if the ray passes through the box
+  bool hit;
+  /// Unused padding
+  RADIANT_PAD(3);
+} radiant_ray_aabb_hit_t;
+
+/// Intersects |ray| with the triangle |a|, |b|, |c| using the Moller-Trumbore
+/// test. Both sides of the triangle count, and degenerate triangles are never
+/// hit.
+radiant_ray_triangle_hit_t radiant_ray_intersect_triangle(radiant_ray_t ray,
+                                                          radiant_point3_t a,
+                                                          radiant_point3_t b,
+                                                          radiant_point3_t c);
+
+/// Returns the reciprocal of each component of |direction| for slab tests.
+/// Zero components give the largest finite float, rather than infinity, so
+/// the tests never produce NaNs.
+radiant_vec3_t radiant_ray_inv_direction(radiant_vec3_t direction);
+
+/// Intersects |ray| with |box| using the slab test. A ray lying in the plane
+/// of a face shared by two boxes passes through exactly one of them.
+radiant_ray_aabb_hit_t radiant_ray_intersect_aabb(radiant_ray_t ray,
+                                                  radiant_aabb_t box);
+
+/// A stream of triangles stored as structure-of-arrays, as the first vertex
+/// and the two edges leaving it, which is what the intersection kernels
+/// consume.
+typedef struct radiant_triangle_soa_t {
+  /// The first vertex of each triangle
+  radiant_point3_soa_t v0;
+  /// The second vertex minus the first
+  radiant_vec3_soa_t edge1;
+  /// The third vertex minus the first
+  radiant_vec3_soa_t edge2;
+} radiant_triangle_soa_t;
+
+/// Creates a stream of |count| triangles. Returns an empty stream, with a
+/// count of zero, if the allocation fails.
+radiant_triangle_soa_t radiant_triangle_soa_create(uint32_t count);
+/// Destroys |soa|.
+void radiant_triangle_soa_destroy(radiant_triangle_soa_t soa);
+
+/// Returns the number of triangles in |soa|.
+uint32_t radiant_triangle_soa_count(radiant_triangle_soa_t soa);
+
+/// Sets the triangle at |idx| in |soa| to |a|, |b|, |c|.
+void radiant_triangle_soa_set(radiant_triangle_soa_t soa,
+                              uint32_t idx,
+                              radiant_point3_t a,
+                              radiant_point3_t b,
+                              radiant_point3_t c);
+
+/// Returns the closest hit of |ray| against the triangles [|begin|, |end|)
+/// of |triangles|. Matches calling radiant_ray_intersect_triangle on each,
+/// with ties going to the lowest index, up to rounding: backends with fused
+/// multiply add can differ in the last bits of |t|, |u| and |v|.
+radiant_ray_triangle_hit_t radiant_ray_intersect_triangles(
+    radiant_ray_t ray,
+    radiant_triangle_soa_t triangles,
+    uint32_t begin,
+    uint32_t end);
+
+/// A packet of rays stored as structure-of-arrays, sharing [0, t_max].
+typedef struct radiant_ray_soa_t {
+  /// The ray origins
+  radiant_point3_soa_t origins;
+  /// The reciprocal of each direction, from radiant_ray_inv_direction
+  radiant_vec3_soa_t inv_directions;
+} radiant_ray_soa_t;
+
+/// Creates a packet of |count| rays. Returns an empty packet, with a count of
+/// zero, if the allocation fails.
+radiant_ray_soa_t radiant_ray_soa_create(uint32_t count);
+/// Destroys |soa|.
+void radiant_ray_soa_destroy(radiant_ray_soa_t soa);
+
+/// Returns the number of rays in |soa|.
+uint32_t radiant_ray_soa_count(radiant_ray_soa_t soa);
+
+/// Sets the ray at |idx| in |soa| to start at |origin| heading along
+/// |direction|.
+void radiant_ray_soa_set(radiant_ray_soa_t soa,
+                         uint32_t idx,
+                         radiant_point3_t origin,
+                         radiant_vec3_t direction);
+
+/// Intersects each ray of |rays| with |box| over [0, |t_max|], storing the
+/// distance at which each enters the box into |t_out|, or infinity for rays
+/// that miss it. |t_out| must hold a value per ray.
+void radiant_ray_soa_intersect_aabb(radiant_ray_soa_t rays,
+                                    radiant_aabb_t box,
+                                    float t_max,
+                                    float* t_out);
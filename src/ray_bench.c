@@ -0,0 +1,157 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Intersects a ray with a soup of triangles, and a packet of rays with a box,
+// for each supported SIMD backend, compared against intersecting one at a
+// time.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/ray.h"
+#include "src/simd.h"
+
+static const uint32_t kTriangles = 10000;
+static const uint32_t kRays = 10000;
+static const uint32_t kIterations = 200;
+
+typedef struct bench_data_t {
+  radiant_triangle_soa_t triangles;
+  radiant_ray_soa_t rays;
+  radiant_ray_t ray;
+  radiant_aabb_t box;
+  float* t;
+  radiant_ray_triangle_hit_t hit;
+  /// Unused padding
+  RADIANT_PAD(4);
+} bench_data_t;
+
+static void triangles_single(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_ray_triangle_hit_t best = {.t = INFINITY};
+  const radiant_triangle_soa_t* tris = &data->triangles;
+  for (uint32_t i = 0; i < kTriangles; ++i) {
+    radiant_point3_t a = radiant_point3_soa_get(tris->v0, i);
+    radiant_ray_triangle_hit_t hit = radiant_ray_intersect_triangle(
+        data->ray, a,
+        radiant_point3_add(a, radiant_vec3_soa_get(tris->edge1, i)),
+        radiant_point3_add(a, radiant_vec3_soa_get(tris->edge2, i)));
+    if (hit.hit && hit.t < best.t) {
+      best = hit;
+      best.index = i;
+    }
+  }
+  data->hit = best;
+}
+
+static void triangles_batch(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  data->hit = radiant_ray_intersect_triangles(data->ray, data->triangles, 0,
+                                              kTriangles);
+}
+
+static void aabb_single(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  const radiant_ray_soa_t* rays = &data->rays;
+  for (uint32_t i = 0; i < kRays; ++i) {
+    radiant_vec3_t inv = radiant_vec3_soa_get(rays->inv_directions, i);
+    radiant_ray_t ray = {
+        .origin = radiant_point3_soa_get(rays->origins, i),
+        .direction = {1.f / inv.x, 1.f / inv.y, 1.f / inv.z},
+        .t_max = 100.f,
+    };
+    radiant_ray_aabb_hit_t hit = radiant_ray_intersect_aabb(ray, data->box);
+    data->t[i] = hit.hit ? hit.t_near : INFINITY;
+  }
+}
+
+static void aabb_batch(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_ray_soa_intersect_aabb(data->rays, data->box, 100.f, data->t);
+}
+
+static void run(const char* name,
+                radiant_bench_fn_t fn,
+                bench_data_t* data,
+                uint32_t items) {
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s [%s]", name,
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(label, fn, data, kIterations, items);
+  }
+  radiant_simd_set_backend(original);
+}
+
+int main() {
+  bench_data_t data = {
+      .triangles = radiant_triangle_soa_create(kTriangles),
+      .rays = radiant_ray_soa_create(kRays),
+      .ray = {.origin = {0.f, 0.f, 0.f},
+              .direction = {0.1f, -0.05f, -1.f},
+              .t_max = INFINITY},
+      .box = {.min = {-5.f, -5.f, -30.f}, .max = {5.f, 5.f, -20.f}},
+      .t = (float*)malloc(kRays * sizeof(float)),
+  };
+  if (radiant_triangle_soa_count(data.triangles) != kTriangles ||
+      radiant_ray_soa_count(data.rays) != kRays || !data.t) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  // Small triangles scattered through a slab in front of the ray, and rays
+  // fanning out from a grid of origins.
+  for (uint32_t i = 0; i < kTriangles; ++i) {
+    float fi = (float)i;
+    radiant_point3_t a = {fmodf(fi * 0.37f, 20.f) - 10.f,
+                          fmodf(fi * 0.61f, 20.f) - 10.f,
+                          -5.f - fmodf(fi * 1.3f, 50.f)};
+    radiant_triangle_soa_set(
+        data.triangles, i, a,
+        (radiant_point3_t){a.x + 0.5f, a.y + 0.1f, a.z - 0.2f},
+        (radiant_point3_t){a.x - 0.1f, a.y + 0.4f, a.z + 0.3f});
+  }
+  for (uint32_t i = 0; i < kRays; ++i) {
+    float fi = (float)i;
+    radiant_ray_soa_set(data.rays, i,
+                        (radiant_point3_t){fmodf(fi * 0.7f, 20.f) - 10.f,
+                                           fmodf(fi * 0.3f, 20.f) - 10.f, 0.f},
+                        (radiant_vec3_t){fmodf(fi * 0.11f, 1.f) - 0.5f,
+                                         fmodf(fi * 0.17f, 1.f) - 0.5f, -1.f});
+  }
+
+  triangles_batch(&data);
+  printf("Ray against %u triangles, hit %u at %f\n", kTriangles,
+         data.hit.index, (double)data.hit.t);
+  radiant_bench_run("ray_intersect_triangle loop", triangles_single, &data,
+                    kIterations, kTriangles);
+  run("ray_intersect_triangles", triangles_batch, &data, kTriangles);
+
+  radiant_bench_run("ray_intersect_aabb loop", aabb_single, &data,
+                    kIterations, kRays);
+  run("ray_soa_intersect_aabb", aabb_batch, &data, kRays);
+
+  radiant_triangle_soa_destroy(data.triangles);
+  radiant_ray_soa_destroy(data.rays);
+  free(data.t);
+  return 0;
+}
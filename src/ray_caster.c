@@ -0,0 +1,315 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ray_caster.h"
+
+#include "src/array_element_count.h"
+#include "src/shader.h"
+
+static radiant_buffer_t create_storage_buffer(radiant_engine_t engine,
+                                              const char* label,
+                                              uint64_t size_in_bytes,
+                                              const void* data) {
+  radiant_buffer_create_request_t req = {
+      .engine = engine,
+      .usage = radiant_buffer_usage_stoage,
+      .label = label,
+      .size_in_bytes = size_in_bytes,
+  };
+  return radiant_buffer_create_with_data(req, data);
+}
+
+static void create_pipelines(radiant_ray_caster_t* caster,
+                             radiant_shader_t shader,
+                             WGPUTextureFormat present_format) {
+  WGPUComputePipelineDescriptor compute_desc = {
+      .label = "Ray cast pipeline",
+      .compute =
+          {
+              .module = shader.mod,
+              .entryPoint = "cs_main",
+          },
+  };
+  caster->pipeline =
+      wgpuDeviceCreateComputePipeline(caster->engine.device, &compute_desc);
+
+  WGPUColorTargetState target[] = {
+      {
+          .format = present_format,
+          .writeMask = WGPUColorWriteMask_All,
+      },
+  };
+  WGPUFragmentState frag_state = {
+      .module = shader.mod,
+      .entryPoint = "fs_present",
+      .targetCount = RADIANT_ARRAY_ELEMENT_COUNT(target),
+      .targets = target,
+  };
+  WGPURenderPipelineDescriptor present_desc = {
+      .label = "Ray cast present pipeline",
+      .primitive =
+          {
+              .topology = WGPUPrimitiveTopology_TriangleList,
+          },
+      .vertex =
+          {
+              .module = shader.mod,
+              .entryPoint = "vs_present",
+          },
+      .fragment = &frag_state,
+      .multisample =
+          {
+              .count = 1,
+              .mask = 0xffffffff,
+          },
+  };
+  caster->present_pipeline =
+      wgpuDeviceCreateRenderPipeline(caster->engine.device, &present_desc);
+}
+
+static void create_bind_groups(radiant_ray_caster_t* caster) {
+  WGPUBindGroupEntry entries[] = {
+      {
+          .binding = 0,
+          .buffer = caster->uniform_buffer.buffer,
+          .size = sizeof(radiant_ray_caster_uniforms_t),
+      },
+      {
+          .binding = 1,
+          .buffer = caster->node_buffer.buffer,
+          .size = WGPU_WHOLE_SIZE,
+      },
+      {
+          .binding = 2,
+          .buffer = caster->triangle_buffer.buffer,
+          .size = WGPU_WHOLE_SIZE,
+      },
+      {
+          .binding = 3,
+          .textureView = caster->output_view.view,
+      },
+  };
+  WGPUBindGroupLayout layout =
+      wgpuComputePipelineGetBindGroupLayout(caster->pipeline, 0);
+  WGPUBindGroupDescriptor desc = {
+      .label = "Ray cast bind group",
+      .layout = layout,
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(entries),
+      .entries = entries,
+  };
+  caster->bind_group = wgpuDeviceCreateBindGroup(caster->engine.device, &desc);
+  wgpuBindGroupLayoutRelease(layout);
+
+  WGPUBindGroupEntry present_entries[] = {
+      {
+          .binding = 4,
+          .textureView = caster->output_view.view,
+      },
+  };
+  WGPUBindGroupLayout present_layout =
+      wgpuRenderPipelineGetBindGroupLayout(caster->present_pipeline, 0);
+  WGPUBindGroupDescriptor present_desc = {
+      .label = "Ray cast present bind group",
+      .layout = present_layout,
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(present_entries),
+      .entries = present_entries,
+  };
+  caster->present_bind_group =
+      wgpuDeviceCreateBindGroup(caster->engine.device, &present_desc);
+  wgpuBindGroupLayoutRelease(present_layout);
+}
+
+radiant_ray_caster_create_result_t radiant_ray_caster_create(
+    radiant_ray_caster_create_request_t req) {
+  radiant_ray_caster_create_result_t result = {0};
+  if (req.width == 0 || req.height == 0) {
+    return result;
+  }
+
+  radiant_ray_caster_t* caster = &result.caster;
+  caster->engine = req.engine;
+  caster->uniforms = (radiant_ray_caster_uniforms_t){
+      .width = req.width,
+      .height = req.height,
+      .sun_direction = radiant_vec3_normalize(req.lighting.sun_direction),
+      .sun_colour = req.lighting.sun_colour,
+      .sky_zenith = req.lighting.sky_zenith,
+      .shadows = req.shadows ? 1 : 0,
+      .sky_horizon = req.lighting.sky_horizon,
+  };
+  if (!radiant_ray_caster_set_camera(caster, &req.camera)) {
+    return result;
+  }
+
+  radiant_bvh_t bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = req.mesh,
+  });
+  radiant_bvh_gpu_t gpu =
+      radiant_bvh_gpu_create((radiant_bvh_gpu_create_request_t){
+          .bvh = &bvh,
+          .mesh = req.mesh,
+          .colour_offset = req.colour_offset,
+          .albedo = req.albedo,
+      });
+  if (req.mesh.triangle_count > 0 && gpu.triangle_count == 0) {
+    radiant_bvh_destroy(bvh);
+    return result;
+  }
+
+  radiant_shader_create_result_t shader_result =
+      radiant_shader_create_from_file(req.engine, req.manager,
+                                      "Ray cast shader",
+                                      "shaders/ray_cast.wgsl");
+  if (!shader_result.succeeded) {
+    radiant_bvh_gpu_destroy(gpu);
+    radiant_bvh_destroy(bvh);
+    return result;
+  }
+
+  // Storage buffers cannot be empty, an empty scene binds one zeroed node
+  // and triangle that are never read.
+  caster->uniforms.node_count = bvh.node_count;
+  radiant_bvh_node_t empty_node = {0};
+  radiant_bvh_gpu_triangle_t empty_triangle = {0};
+  caster->node_buffer = create_storage_buffer(
+      req.engine, "Ray cast nodes",
+      (bvh.node_count > 0 ? bvh.node_count : 1) * sizeof(radiant_bvh_node_t),
+      bvh.node_count > 0 ? (const void*)bvh.nodes : &empty_node);
+  caster->triangle_buffer = create_storage_buffer(
+      req.engine, "Ray cast triangles",
+      (gpu.triangle_count > 0 ? gpu.triangle_count : 1) *
+          sizeof(radiant_bvh_gpu_triangle_t),
+      gpu.triangle_count > 0 ? (const void*)gpu.triangles : &empty_triangle);
+  radiant_bvh_gpu_destroy(gpu);
+  radiant_bvh_destroy(bvh);
+
+  radiant_buffer_create_request_t uniform_req = {
+      .engine = req.engine,
+      .usage = radiant_buffer_usage_uniform,
+      .label = "Ray cast uniforms",
+      .size_in_bytes = sizeof(radiant_ray_caster_uniforms_t),
+  };
+  caster->uniform_buffer =
+      radiant_buffer_create_with_data(uniform_req, &caster->uniforms);
+
+  radiant_texture_create_request_t output_req = {
+      .engine = req.engine,
+      .label = "Ray cast output",
+      .size =
+          {
+              .width = req.width,
+              .height = req.height,
+          },
+      .format = RADIANT_RAY_CASTER_FORMAT,
+      .usage = WGPUTextureUsage_StorageBinding |
+               WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopySrc,
+  };
+  caster->output = radiant_texture_create(output_req);
+  caster->output_view = radiant_texture_view_create(caster->output);
+
+  create_pipelines(caster, shader_result.shader, req.present_format);
+  create_bind_groups(caster);
+  radiant_shader_destroy(shader_result.shader);
+
+  result.succeeded = true;
+  return result;
+}
+
+void radiant_ray_caster_destroy(radiant_ray_caster_t caster) {
+  wgpuBindGroupRelease(caster.present_bind_group);
+  wgpuBindGroupRelease(caster.bind_group);
+  wgpuRenderPipelineRelease(caster.present_pipeline);
+  wgpuComputePipelineRelease(caster.pipeline);
+  radiant_texture_view_destroy(caster.output_view);
+  radiant_texture_destroy(caster.output);
+  radiant_buffer_destroy(caster.triangle_buffer);
+  radiant_buffer_destroy(caster.node_buffer);
+  radiant_buffer_destroy(caster.uniform_buffer);
+}
+
+bool radiant_ray_caster_set_camera(radiant_ray_caster_t* caster,
+                                   radiant_camera_t* camera) {
+  if (camera->view_version == caster->camera_view_version &&
+      camera->projection_version == caster->camera_projection_version) {
+    return true;
+  }
+  radiant_mat4x4_inverse_result_t inverse =
+      radiant_camera_inverse_projection_view_matrix(camera);
+  if (!inverse.succeeded) {
+    return false;
+  }
+  caster->uniforms.inverse_projection_view = inverse.inverse;
+  caster->uniforms.eye = radiant_camera_position(camera);
+  caster->camera_view_version = camera->view_version;
+  caster->camera_projection_version = camera->projection_version;
+  // Not yet uploaded while the caster is being created.
+  if (caster->uniform_buffer.buffer) {
+    radiant_buffer_write(caster->uniform_buffer,
+                         sizeof(radiant_ray_caster_uniforms_t),
+                         &caster->uniforms);
+  }
+  return true;
+}
+
+void radiant_ray_caster_encode(const radiant_ray_caster_t* caster,
+                               WGPUCommandEncoder encoder) {
+  WGPUComputePassDescriptor pass_desc = {
+      .label = "Ray cast pass",
+  };
+  WGPUComputePassEncoder pass =
+      wgpuCommandEncoderBeginComputePass(encoder, &pass_desc);
+  wgpuComputePassEncoderSetPipeline(pass, caster->pipeline);
+  wgpuComputePassEncoderSetBindGroup(pass, 0, caster->bind_group, 0, NULL);
+  wgpuComputePassEncoderDispatchWorkgroups(
+      pass,
+      (caster->uniforms.width + RADIANT_RAY_CASTER_WORKGROUP_SIZE - 1) /
+          RADIANT_RAY_CASTER_WORKGROUP_SIZE,
+      (caster->uniforms.height + RADIANT_RAY_CASTER_WORKGROUP_SIZE - 1) /
+          RADIANT_RAY_CASTER_WORKGROUP_SIZE,
+      1);
+  wgpuComputePassEncoderEnd(pass);
+  wgpuComputePassEncoderRelease(pass);
+}
+
+void radiant_ray_caster_present(const radiant_ray_caster_t* caster,
+                                WGPUCommandEncoder encoder,
+                                WGPUTextureView target) {
+  WGPURenderPassColorAttachment colour_attach[] = {
+      {
+          .view = target,
+          .loadOp = WGPULoadOp_Clear,
+          .storeOp = WGPUStoreOp_Store,
+          .clearValue =
+              {
+                  .r = 0.,
+                  .g = 0.,
+                  .b = 0.,
+                  .a = 1.,
+              },
+      },
+  };
+  WGPURenderPassDescriptor pass_desc = {
+      .label = "Ray cast present pass",
+      .colorAttachmentCount = RADIANT_ARRAY_ELEMENT_COUNT(colour_attach),
+      .colorAttachments = colour_attach,
+  };
+  WGPURenderPassEncoder pass =
+      wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
+  wgpuRenderPassEncoderSetPipeline(pass, caster->present_pipeline);
+  wgpuRenderPassEncoderSetBindGroup(pass, 0, caster->present_bind_group, 0,
+                                    NULL);
+  wgpuRenderPassEncoderDraw(pass, 3, 1, 0, 0);
+  wgpuRenderPassEncoderEnd(pass);
+  wgpuRenderPassEncoderRelease(pass);
+}
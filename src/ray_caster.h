@@ -0,0 +1,169 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/buffer.h"
+#include "src/bvh.h"
+#include "src/bvh_gpu.h"
+#include "src/camera.h"
+#include "src/colour3.h"
+#include "src/engine.h"
+#include "src/mat4x4.h"
+#include "src/pad.h"
+#include "src/point3.h"
+#include "src/resource_manager.h"
+#include "src/texture.h"
+#include "src/tracer.h"
+#include "src/vec3.h"
+#include "src/wgpu.h"
+
+/// Pixels per side of the square workgroups of shaders/ray_cast.wgsl.
+#define RADIANT_RAY_CASTER_WORKGROUP_SIZE 8
+
+/// The format of the texture the rays are cast into. Storage textures cannot
+/// be BGRA8Unorm, the swapchain format, without an optional feature, so the
+/// texture is drawn to the swapchain by radiant_ray_caster_present.
+#define RADIANT_RAY_CASTER_FORMAT WGPUTextureFormat_RGBA8Unorm
+
+/// The uniforms of shaders/ray_cast.wgsl, in the WGSL layout.
+typedef struct radiant_ray_caster_uniforms_t {
+  /// Maps normalized device coordinates back into the world
+  radiant_mat4x4_t inverse_projection_view;
+  /// Where the camera is, every primary ray starts here
+  radiant_point3_t eye;
+  /// The width of the frame in pixels
+  uint32_t width;
+  /// The normalized direction towards the sun
+  radiant_vec3_t sun_direction;
+  /// The height of the frame in pixels
+  uint32_t height;
+  /// The irradiance of the sun on a surface facing it
+  radiant_colour3_t sun_colour;
+  /// The number of BVH nodes, zero for an empty scene
+  uint32_t node_count;
+  /// The radiance of the sky straight up
+  radiant_colour3_t sky_zenith;
+  /// Non zero to cast shadow rays
+  uint32_t shadows;
+  /// The radiance of the sky at and below the horizon
+  radiant_colour3_t sky_horizon;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_ray_caster_uniforms_t;
+
+/// A GPU ray caster. A compute shader traverses a radiant_bvh_t uploaded into
+/// storage buffers, casting one primary ray per pixel and a shadow ray
+/// towards the sun from each hit. Surfaces are diffuse and lit as by a
+/// radiant_tracer_t limited to direct light, except that the sky is never
+/// blocked, so the two agree wherever the sky is black.
+typedef struct radiant_ray_caster_t {
+  /// The engine
+  radiant_engine_t engine;
+  /// Casts the rays into |output|
+  WGPUComputePipeline pipeline;
+  /// The buffers and |output| as bound for |pipeline|
+  WGPUBindGroup bind_group;
+  /// Draws |output| into a render target
+  WGPURenderPipeline present_pipeline;
+  /// |output| as bound for |present_pipeline|
+  WGPUBindGroup present_bind_group;
+  /// Holds |uniforms|
+  radiant_buffer_t uniform_buffer;
+  /// The radiant_bvh_node_ts of the BVH
+  radiant_buffer_t node_buffer;
+  /// The radiant_bvh_gpu_triangle_ts of the BVH
+  radiant_buffer_t triangle_buffer;
+  /// The texture the rays are cast into, in RADIANT_RAY_CASTER_FORMAT
+  radiant_texture_t output;
+  /// A view of |output|
+  radiant_texture_view_t output_view;
+  /// The current uniforms
+  radiant_ray_caster_uniforms_t uniforms;
+  /// The radiant_camera_t::view_version of the camera in |uniforms|
+  uint32_t camera_view_version;
+  /// The radiant_camera_t::projection_version of the camera in |uniforms|
+  uint32_t camera_projection_version;
+} radiant_ray_caster_t;
+
+/// Structure for requesting a ray caster.
+typedef struct radiant_ray_caster_create_request_t {
+  /// The engine
+  radiant_engine_t engine;
+  /// Loads shaders/ray_cast.wgsl
+  radiant_resource_manager_t manager;
+  /// The triangles to render, in the layout uploaded for rasterizing. Only
+  /// read while creating the caster.
+  radiant_bvh_mesh_t mesh;
+  /// The byte offset of a radiant_colour3_t in each vertex, the colour of
+  /// the surface, or RADIANT_BVH_GPU_NO_COLOUR to use |albedo| everywhere
+  uint32_t colour_offset;
+  /// The colour of surfaces if the mesh has no vertex colours
+  radiant_colour3_t albedo;
+  /// The light falling on the scene
+  radiant_tracer_lighting_t lighting;
+  /// The camera the scene is seen from, as for rasterizing
+  radiant_camera_t camera;
+  /// The width of the frame in pixels
+  uint32_t width;
+  /// The height of the frame in pixels
+  uint32_t height;
+  /// The format of the targets radiant_ray_caster_present draws into,
+  /// usually that of the swapchain
+  WGPUTextureFormat present_format;
+  /// True to cast shadow rays, false to light every surface facing the sun
+  bool shadows;
+  /// Unused padding
+  RADIANT_PAD(3);
+} radiant_ray_caster_create_request_t;
+
+/// Results of creating a ray caster
+typedef struct radiant_ray_caster_create_result_t {
+  /// The ray caster. Only valid if |succeeded| is true.
+  radiant_ray_caster_t caster;
+  /// True if the ray caster was successfully created. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_ray_caster_create_result_t;
+
+/// Creates a ray caster for |req|, building a BVH over the mesh and
+/// uploading it. Fails if the frame is empty, the camera cannot be inverted,
+/// an allocation fails or the shader cannot be loaded.
+radiant_ray_caster_create_result_t radiant_ray_caster_create(
+    radiant_ray_caster_create_request_t req);
+
+/// Destroys |caster|.
+void radiant_ray_caster_destroy(radiant_ray_caster_t caster);
+
+/// Moves the camera of |caster| to |camera|, uploading the uniforms only if
+/// the camera changed since the last call. Returns false, leaving the camera
+/// unchanged, if |camera| cannot be inverted.
+bool radiant_ray_caster_set_camera(radiant_ray_caster_t* caster,
+                                   radiant_camera_t* camera);
+
+/// Records a compute pass into |encoder| casting a ray for every pixel of
+/// |caster->output|.
+void radiant_ray_caster_encode(const radiant_ray_caster_t* caster,
+                               WGPUCommandEncoder encoder);
+
+/// Records a render pass into |encoder| drawing |caster->output| over all of
+/// |target|, for example the current swapchain texture. |target| must have
+/// the present format of the create request.
+void radiant_ray_caster_present(const radiant_ray_caster_t* caster,
+                                WGPUCommandEncoder encoder,
+                                WGPUTextureView target);
@@ -0,0 +1,415 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Renders a dense heightfield on the software adapter by rasterizing it and
+// by ray casting it, to compare the GPU cost of the two for dense meshes.
+// Throughput is in pixels per second. Run from the build directory so the
+// shaders are found.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/array_element_count.h"
+#include "src/bench.h"
+#include "src/constants.h"
+#include "src/ray_caster.h"
+#include "src/shader.h"
+
+/// Cells per side of the heightfield, two triangles each.
+#define SIZE 512
+
+#define WIDTH 640
+#define HEIGHT 360
+
+static const uint32_t kVertexCount = (SIZE + 1) * (SIZE + 1);
+static const uint32_t kTriangleCount = 2 * SIZE * SIZE;
+static const uint32_t kIterations = 10;
+
+/// The uniforms of shaders/checker.wgsl, padded as the radiant target does.
+typedef struct raster_uniforms_t {
+  radiant_mat4x4_t model_view_projection_matrix;
+  uint32_t frame;
+  float frame_radians;
+  uint32_t image_width;
+  uint32_t image_height;
+  /// Unused padding
+  RADIANT_PAD(sizeof(radiant_mat4x4_t) - (3 * sizeof(uint32_t)) -
+              sizeof(float));
+} raster_uniforms_t;
+
+typedef struct raster_t {
+  WGPURenderPipeline pipeline;
+  WGPUBindGroup bind_group;
+  radiant_buffer_t uniform_buffer;
+  radiant_buffer_t vertex_buffer;
+  radiant_buffer_t index_buffer;
+  radiant_texture_t depth;
+  radiant_texture_view_t depth_view;
+} raster_t;
+
+static radiant_engine_t engine;
+
+/// Copied into |fence| after each frame, mapping it waits for the frame.
+static radiant_buffer_t fence_source;
+static radiant_buffer_t fence;
+
+/// Submits |encoder| and waits for the GPU to finish it.
+static void submit_and_wait(WGPUCommandEncoder encoder) {
+  wgpuCommandEncoderCopyBufferToBuffer(encoder, fence_source.buffer, 0,
+                                       fence.buffer, 0, sizeof(uint32_t));
+  WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, NULL);
+  wgpuCommandEncoderRelease(encoder);
+  wgpuQueueSubmit(wgpuDeviceGetQueue(engine.device), 1, &commands);
+  wgpuCommandBufferRelease(commands);
+  if (radiant_buffer_map_read(fence, sizeof(uint32_t)).succeeded) {
+    radiant_buffer_unmap(fence);
+  }
+}
+
+static raster_t raster_create(radiant_resource_manager_t manager,
+                              const radiant_point3_t* vertices,
+                              const uint32_t* indices,
+                              radiant_camera_t* cam) {
+  raster_t raster = {0};
+  radiant_shader_create_result_t shader_result =
+      radiant_shader_create_from_file(engine, manager, "Checker shader",
+                                      "shaders/checker.wgsl");
+  if (!shader_result.succeeded) {
+    return raster;
+  }
+
+  WGPUVertexAttribute vert_attrs[] = {
+      {
+          .format = WGPUVertexFormat_Float32x3,
+          .offset = 0,
+          .shaderLocation = 0,
+      },
+  };
+  WGPUVertexBufferLayout vert_buf_layout[] = {
+      {
+          .arrayStride = sizeof(radiant_point3_t),
+          .attributeCount = RADIANT_ARRAY_ELEMENT_COUNT(vert_attrs),
+          .attributes = vert_attrs,
+      },
+  };
+  WGPUColorTargetState target[] = {
+      {
+          .format = RADIANT_RAY_CASTER_FORMAT,
+          .writeMask = WGPUColorWriteMask_All,
+      },
+  };
+  WGPUFragmentState frag_state = {
+      .module = shader_result.shader.mod,
+      .entryPoint = "fs_main",
+      .targetCount = RADIANT_ARRAY_ELEMENT_COUNT(target),
+      .targets = target,
+  };
+  WGPUDepthStencilState depth_stencil = {
+      .format = WGPUTextureFormat_Depth24Plus,
+      .depthWriteEnabled = true,
+      .depthCompare = WGPUCompareFunction_Less,
+      .stencilFront =
+          {
+              .compare = WGPUCompareFunction_Always,
+              .failOp = WGPUStencilOperation_Keep,
+              .depthFailOp = WGPUStencilOperation_Keep,
+              .passOp = WGPUStencilOperation_Keep,
+          },
+      .stencilBack =
+          {
+              .compare = WGPUCompareFunction_Always,
+              .failOp = WGPUStencilOperation_Keep,
+              .depthFailOp = WGPUStencilOperation_Keep,
+              .passOp = WGPUStencilOperation_Keep,
+          },
+      .stencilReadMask = 0xffffffff,
+      .stencilWriteMask = 0xffffffff,
+  };
+  WGPURenderPipelineDescriptor pipeline_desc = {
+      .label = "Heightfield raster pipeline",
+      .primitive =
+          {
+              .topology = WGPUPrimitiveTopology_TriangleList,
+              .cullMode = WGPUCullMode_None,
+          },
+      .vertex =
+          {
+              .module = shader_result.shader.mod,
+              .entryPoint = "vs_main",
+              .bufferCount = RADIANT_ARRAY_ELEMENT_COUNT(vert_buf_layout),
+              .buffers = vert_buf_layout,
+          },
+      .fragment = &frag_state,
+      .depthStencil = &depth_stencil,
+      .multisample =
+          {
+              .count = 1,
+              .mask = 0xffffffff,
+          },
+  };
+  raster.pipeline =
+      wgpuDeviceCreateRenderPipeline(engine.device, &pipeline_desc);
+  radiant_shader_destroy(shader_result.shader);
+
+  raster_uniforms_t uniforms = {
+      .model_view_projection_matrix =
+          radiant_camera_projection_view_matrix(cam),
+      .image_width = WIDTH,
+      .image_height = HEIGHT,
+  };
+  raster.uniform_buffer = radiant_buffer_create_with_data(
+      (radiant_buffer_create_request_t){
+          .engine = engine,
+          .usage = radiant_buffer_usage_uniform,
+          .label = "Heightfield uniforms",
+          .size_in_bytes = sizeof(uniforms),
+      },
+      &uniforms);
+  raster.vertex_buffer = radiant_buffer_create_with_data(
+      (radiant_buffer_create_request_t){
+          .engine = engine,
+          .usage = radiant_buffer_usage_vertex,
+          .label = "Heightfield vertices",
+          .size_in_bytes = kVertexCount * sizeof(radiant_point3_t),
+      },
+      vertices);
+  raster.index_buffer = radiant_buffer_create_with_data(
+      (radiant_buffer_create_request_t){
+          .engine = engine,
+          .usage = radiant_buffer_usage_index,
+          .label = "Heightfield indices",
+          .size_in_bytes = 3 * kTriangleCount * sizeof(uint32_t),
+      },
+      indices);
+
+  WGPUBindGroupEntry bind_entries[] = {
+      {
+          .binding = 0,
+          .buffer = raster.uniform_buffer.buffer,
+          .size = sizeof(raster_uniforms_t),
+      },
+  };
+  WGPUBindGroupLayout bind_group_layout =
+      wgpuRenderPipelineGetBindGroupLayout(raster.pipeline, 0);
+  WGPUBindGroupDescriptor bind_group_desc = {
+      .label = "Heightfield bind group",
+      .layout = bind_group_layout,
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(bind_entries),
+      .entries = bind_entries,
+  };
+  raster.bind_group =
+      wgpuDeviceCreateBindGroup(engine.device, &bind_group_desc);
+  wgpuBindGroupLayoutRelease(bind_group_layout);
+
+  radiant_size_t size = {.width = WIDTH, .height = HEIGHT};
+  raster.depth = radiant_texture_create((radiant_texture_create_request_t){
+      .engine = engine,
+      .label = "Heightfield depth",
+      .size = size,
+      .format = WGPUTextureFormat_Depth24Plus,
+  });
+  raster.depth_view = radiant_texture_view_create(raster.depth);
+  return raster;
+}
+
+static void raster_destroy(raster_t raster) {
+  radiant_texture_view_destroy(raster.depth_view);
+  radiant_texture_destroy(raster.depth);
+  wgpuBindGroupRelease(raster.bind_group);
+  wgpuRenderPipelineRelease(raster.pipeline);
+  radiant_buffer_destroy(raster.index_buffer);
+  radiant_buffer_destroy(raster.vertex_buffer);
+  radiant_buffer_destroy(raster.uniform_buffer);
+}
+
+static void raster_frame(void* userdata) {
+  const raster_t* raster = (const raster_t*)userdata;
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(engine.device, NULL);
+  WGPURenderPassColorAttachment colour_attach[] = {
+      {
+          .view = radiant_engine_current_view(engine),
+          .loadOp = WGPULoadOp_Clear,
+          .storeOp = WGPUStoreOp_Store,
+      },
+  };
+  WGPURenderPassDepthStencilAttachment depth_attach = {
+      .view = raster->depth_view.view,
+      .depthClearValue = 1.f,
+      .depthLoadOp = WGPULoadOp_Clear,
+      .depthStoreOp = WGPUStoreOp_Store,
+  };
+  WGPURenderPassDescriptor pass_desc = {
+      .label = "Heightfield raster pass",
+      .colorAttachmentCount = RADIANT_ARRAY_ELEMENT_COUNT(colour_attach),
+      .colorAttachments = colour_attach,
+      .depthStencilAttachment = &depth_attach,
+  };
+  WGPURenderPassEncoder pass =
+      wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
+  wgpuRenderPassEncoderSetPipeline(pass, raster->pipeline);
+  wgpuRenderPassEncoderSetBindGroup(pass, 0, raster->bind_group, 0, NULL);
+  wgpuRenderPassEncoderSetVertexBuffer(pass, 0, raster->vertex_buffer.buffer,
+                                       0, WGPU_WHOLE_SIZE);
+  wgpuRenderPassEncoderSetIndexBuffer(pass, raster->index_buffer.buffer,
+                                      WGPUIndexFormat_Uint32, 0,
+                                      WGPU_WHOLE_SIZE);
+  wgpuRenderPassEncoderDrawIndexed(pass, 3 * kTriangleCount, 1, 0, 0, 0);
+  wgpuRenderPassEncoderEnd(pass);
+  wgpuRenderPassEncoderRelease(pass);
+  submit_and_wait(encoder);
+}
+
+static void cast_frame(void* userdata) {
+  const radiant_ray_caster_t* caster = (const radiant_ray_caster_t*)userdata;
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(engine.device, NULL);
+  radiant_ray_caster_encode(caster, encoder);
+  submit_and_wait(encoder);
+}
+
+int main() {
+  radiant_resource_manager_create_result_t manager_result =
+      radiant_resource_manager_create("./resources");
+  if (!manager_result.succeeded) {
+    printf("Failed to create resource manager\n");
+    return 1;
+  }
+  radiant_resource_manager_t manager = manager_result.manager;
+  radiant_engine_create_result_t engine_result =
+      radiant_engine_create_headless((radiant_engine_headless_create_request_t){
+          .size = {.width = WIDTH, .height = HEIGHT},
+          .format = RADIANT_RAY_CASTER_FORMAT,
+          .adapter = {.policy = radiant_adapter_policy_software},
+      });
+  if (!engine_result.succeeded) {
+    printf("No software adapter\n");
+    radiant_resource_manager_destroy(manager);
+    return 1;
+  }
+  engine = engine_result.engine;
+
+  radiant_point3_t* vertices =
+      (radiant_point3_t*)malloc(kVertexCount * sizeof(radiant_point3_t));
+  uint32_t* indices = (uint32_t*)malloc(3 * kTriangleCount * sizeof(uint32_t));
+  if (!vertices || !indices) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+  for (uint32_t z = 0; z <= SIZE; ++z) {
+    for (uint32_t x = 0; x <= SIZE; ++x) {
+      float fx = (float)x * 0.25f;
+      float fz = (float)z * 0.25f;
+      vertices[(z * (SIZE + 1)) + x] = (radiant_point3_t){
+          fx, sinf(fx * 0.4f) * cosf(fz * 0.28f) * 4.f, fz};
+    }
+  }
+  uint32_t i = 0;
+  for (uint32_t z = 0; z < SIZE; ++z) {
+    for (uint32_t x = 0; x < SIZE; ++x) {
+      uint32_t v = (z * (SIZE + 1)) + x;
+      uint32_t quad[6] = {v, v + 1, v + SIZE + 1, v + 1, v + SIZE + 2,
+                          v + SIZE + 1};
+      for (uint32_t k = 0; k < 6; ++k) {
+        indices[i++] = quad[k];
+      }
+    }
+  }
+
+  radiant_view_t view = {
+      .size = {.width = WIDTH, .height = HEIGHT},
+      .fov_y_radians = (2.f * RADIANT_PI) / 5.f,
+      .planes = {.near = 1.f, .far = 500.f},
+  };
+  float centre = (float)SIZE * 0.125f;
+  radiant_camera_t cam = radiant_camera_create(
+      (radiant_point3_t){centre, 40.f, -20.f},
+      (radiant_point3_t){centre, 0.f, centre}, (radiant_vec3_t){0.f, 1.f, 0.f},
+      view);
+
+  fence_source = radiant_buffer_create_with_data(
+      (radiant_buffer_create_request_t){
+          .engine = engine,
+          .usage = radiant_buffer_usage_copy_src,
+          .label = "Fence source",
+          .size_in_bytes = sizeof(uint32_t),
+      },
+      &(uint32_t){0});
+  fence = radiant_buffer_create((radiant_buffer_create_request_t){
+      .engine = engine,
+      .usage = radiant_buffer_usage_map_read | radiant_buffer_usage_copy_dst,
+      .label = "Fence",
+      .size_in_bytes = sizeof(uint32_t),
+  });
+
+  radiant_ray_caster_create_request_t req = {
+      .engine = engine,
+      .manager = manager,
+      .mesh =
+          {
+              .vertices = vertices,
+              .indices = indices,
+              .vertex_stride = sizeof(radiant_point3_t),
+              .vertex_count = kVertexCount,
+              .triangle_count = kTriangleCount,
+              .index_format = radiant_bvh_index_format_uint32,
+          },
+      .colour_offset = RADIANT_BVH_GPU_NO_COLOUR,
+      .albedo = {0.8f, 0.8f, 0.8f},
+      .lighting =
+          {
+              .sky_zenith = {0.3f, 0.45f, 0.8f},
+              .sky_horizon = {0.8f, 0.85f, 0.9f},
+              .sun_direction = {0.5f, 1.f, 0.8f},
+              .sun_colour = {2.5f, 2.4f, 2.2f},
+          },
+      .camera = cam,
+      .width = WIDTH,
+      .height = HEIGHT,
+      .present_format = RADIANT_RAY_CASTER_FORMAT,
+  };
+  radiant_ray_caster_create_result_t primary = radiant_ray_caster_create(req);
+  req.shadows = true;
+  radiant_ray_caster_create_result_t shadowed = radiant_ray_caster_create(req);
+  raster_t raster = raster_create(manager, vertices, indices, &cam);
+  if (!primary.succeeded || !shadowed.succeeded || !raster.pipeline) {
+    printf("Failed to create the renderers\n");
+    return 1;
+  }
+
+  WGPUAdapterProperties adapter_properties = {0};
+  wgpuAdapterGetProperties(engine.adapter, &adapter_properties);
+  printf("%s on %s\n", adapter_properties.name,
+         radiant_adapter_backend_name(adapter_properties.backendType));
+  printf("%u triangles at %ux%u\n", kTriangleCount, WIDTH, HEIGHT);
+  uint32_t pixels = WIDTH * HEIGHT;
+  radiant_bench_run("raster", raster_frame, &raster, kIterations, pixels);
+  radiant_bench_run("cast primary", cast_frame, &primary.caster, kIterations,
+                    pixels);
+  radiant_bench_run("cast primary+shadow", cast_frame, &shadowed.caster,
+                    kIterations, pixels);
+
+  raster_destroy(raster);
+  radiant_ray_caster_destroy(shadowed.caster);
+  radiant_ray_caster_destroy(primary.caster);
+  radiant_buffer_destroy(fence);
+  radiant_buffer_destroy(fence_source);
+  radiant_camera_destroy(cam);
+  radiant_engine_destroy(engine);
+  radiant_resource_manager_destroy(manager);
+  free(indices);
+  free(vertices);
+  return 0;
+}
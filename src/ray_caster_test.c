@@ -0,0 +1,414 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ray_caster.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/constants.h"
+#include "src/pack.h"
+#include "src/test.h"
+
+/// The frame size, not a multiple of the workgroup size so edge workgroups
+/// are partial.
+#define WIDTH 60
+#define HEIGHT 36
+/// Texture copies need rows padded to 256 bytes.
+#define ROW_BYTES 256
+
+typedef struct vertex_t {
+  radiant_point3_t position;
+  radiant_colour3_t colour;
+} vertex_t;
+
+/// A large red ground plane at y = 0 followed by a small green roof at y = 1
+/// over x in [-1, 1] and z in [-2, 0], as in the tracer tests.
+static const vertex_t kVertices[] = {
+    {{-1000.f, 0.f, -1000.f}, {1.f, 0.f, 0.f}},
+    {{1000.f, 0.f, -1000.f}, {1.f, 0.f, 0.f}},
+    {{-1000.f, 0.f, 1000.f}, {1.f, 0.f, 0.f}},
+    {{1000.f, 0.f, 1000.f}, {1.f, 0.f, 0.f}},
+    {{-1.f, 1.f, -2.f}, {0.f, 1.f, 0.f}},
+    {{1.f, 1.f, -2.f}, {0.f, 1.f, 0.f}},
+    {{-1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}},
+    {{1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}},
+};
+
+static const uint16_t kIndices[] = {0, 1, 2, 1, 3, 2, 4, 5, 6, 5, 7, 6};
+
+static radiant_engine_t engine;
+static radiant_resource_manager_t manager;
+static bool gpu_error = false;
+
+/// Fails the running test on any validation error.
+static void error_callback(WGPUErrorType /* type */,
+                           char const* message,
+                           void* /* userdata */) {
+  printf("WebGPU error: %s\n", message);
+  gpu_error = true;
+}
+
+static radiant_camera_t camera() {
+  radiant_view_t view = {
+      .size = {.width = WIDTH, .height = HEIGHT},
+      .fov_y_radians = (2.f * RADIANT_PI) / 5.f,
+      .planes = {.near = 1.f, .far = 100.f},
+  };
+  // Looking steeply down at the ground, every primary ray hits it.
+  return radiant_camera_create((radiant_point3_t){0.f, 5.f, 0.f},
+                               (radiant_point3_t){0.f, 0.f, -1.f},
+                               (radiant_vec3_t){0.f, 1.f, 0.f}, view);
+}
+
+/// Sun only lighting, 45 degrees up so the shadow of the roof is not under
+/// it. An irradiance of 0.8 * pi * sqrt(2) lights the ground and roof to 0.8.
+static radiant_tracer_lighting_t lighting() {
+  float sun = 0.8f * RADIANT_PI * sqrtf(2.f);
+  return (radiant_tracer_lighting_t){
+      .sun_direction = {1.f, 1.f, 0.f},
+      .sun_colour = {sun, sun, sun},
+  };
+}
+
+static radiant_ray_caster_create_request_t request(bool shadows) {
+  return (radiant_ray_caster_create_request_t){
+      .engine = engine,
+      .manager = manager,
+      .mesh =
+          {
+              .vertices = kVertices,
+              .indices = kIndices,
+              .vertex_stride = sizeof(vertex_t),
+              .vertex_count = 8,
+              .triangle_count = 4,
+              .index_format = radiant_bvh_index_format_uint16,
+          },
+      .colour_offset = offsetof(vertex_t, colour),
+      .lighting = lighting(),
+      .camera = camera(),
+      .width = WIDTH,
+      .height = HEIGHT,
+      .present_format = WGPUTextureFormat_BGRA8Unorm,
+      .shadows = shadows,
+  };
+}
+
+/// Copies |texture| into |pixels| after the commands in |encoder|, four bytes
+/// per pixel, then submits them and waits for the copy.
+static bool read_back(WGPUCommandEncoder encoder,
+                      WGPUTexture texture,
+                      uint8_t* pixels) {
+  radiant_buffer_create_request_t readback_req = {
+      .engine = engine,
+      .usage = radiant_buffer_usage_map_read | radiant_buffer_usage_copy_dst,
+      .label = "Readback",
+      .size_in_bytes = ROW_BYTES * HEIGHT,
+  };
+  radiant_buffer_t readback = radiant_buffer_create(readback_req);
+
+  WGPUImageCopyTexture source = {
+      .texture = texture,
+  };
+  WGPUImageCopyBuffer destination = {
+      .layout =
+          {
+              .bytesPerRow = ROW_BYTES,
+              .rowsPerImage = HEIGHT,
+          },
+      .buffer = readback.buffer,
+  };
+  WGPUExtent3D size = {
+      .width = WIDTH,
+      .height = HEIGHT,
+      .depthOrArrayLayers = 1,
+  };
+  wgpuCommandEncoderCopyTextureToBuffer(encoder, &source, &destination,
+                                        &size);
+  WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, NULL);
+  wgpuCommandEncoderRelease(encoder);
+  wgpuQueueSubmit(wgpuDeviceGetQueue(engine.device), 1, &commands);
+  wgpuCommandBufferRelease(commands);
+
+  radiant_buffer_map_result_t map =
+      radiant_buffer_map_read(readback, readback_req.size_in_bytes);
+  if (map.succeeded) {
+    for (uint32_t y = 0; y < HEIGHT; ++y) {
+      memcpy(pixels + (y * WIDTH * 4),
+             (const uint8_t*)map.data + (y * ROW_BYTES), WIDTH * 4);
+    }
+    radiant_buffer_unmap(readback);
+  }
+  radiant_buffer_destroy(readback);
+  return map.succeeded && !gpu_error;
+}
+
+/// Casts the rays of |caster| and reads the frame back into |pixels|, four
+/// bytes per pixel.
+static bool cast(const radiant_ray_caster_t* caster, uint8_t* pixels) {
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(engine.device, NULL);
+  radiant_ray_caster_encode(caster, encoder);
+  return read_back(encoder, caster->output.texture, pixels);
+}
+
+static bool empty_frame_fails() {
+  radiant_ray_caster_create_request_t req = request(true);
+  req.height = 0;
+  RADIANT_EXPECT_FALSE(radiant_ray_caster_create(req).succeeded);
+  return true;
+}
+
+static bool sky_only() {
+  radiant_ray_caster_create_request_t req = request(true);
+  req.mesh.triangle_count = 0;
+  req.lighting.sky_zenith = (radiant_colour3_t){0.2f, 0.4f, 0.6f};
+  req.lighting.sky_horizon = req.lighting.sky_zenith;
+  radiant_ray_caster_create_result_t result = radiant_ray_caster_create(req);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+
+  uint8_t* pixels = (uint8_t*)malloc(WIDTH * HEIGHT * 4);
+  RADIANT_EXPECT_TRUE(cast(&result.caster, pixels));
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i) {
+    RADIANT_EXPECT_EQ(pixels[4 * i], radiant_pack_unorm8(0.2f));
+    RADIANT_EXPECT_EQ(pixels[(4 * i) + 1], radiant_pack_unorm8(0.4f));
+    RADIANT_EXPECT_EQ(pixels[(4 * i) + 2], radiant_pack_unorm8(0.6f));
+    RADIANT_EXPECT_EQ(pixels[(4 * i) + 3], 255);
+  }
+  free(pixels);
+  radiant_ray_caster_destroy(result.caster);
+  return true;
+}
+
+/// Returns true if |a| and |b| are within a few unorm8 steps.
+static bool near_unorm8(uint8_t a, float b) {
+  return fabsf(((float)a / 255.f) - b) <= 3.f / 255.f;
+}
+
+static bool matches_tracer() {
+  radiant_ray_caster_create_request_t req = request(true);
+  radiant_ray_caster_create_result_t result = radiant_ray_caster_create(req);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  uint8_t* pixels = (uint8_t*)malloc(WIDTH * HEIGHT * 4);
+  RADIANT_EXPECT_TRUE(cast(&result.caster, pixels));
+
+  // The reference, direct light only so the two estimate the same thing.
+  radiant_tracer_create_result_t reference =
+      radiant_tracer_create((radiant_tracer_create_request_t){
+          .mesh = req.mesh,
+          .colour_offset = req.colour_offset,
+          .lighting = req.lighting,
+          .camera = req.camera,
+          .width = WIDTH,
+          .height = HEIGHT,
+      });
+  RADIANT_EXPECT_TRUE(reference.succeeded);
+  radiant_tracer_render(&reference.tracer, 16);
+  float* expected = (float*)malloc(WIDTH * HEIGHT * 4 * sizeof(float));
+  radiant_tracer_resolve(&reference.tracer, expected);
+
+  // The tracer jitters its samples over each pixel and the caster sends one
+  // ray through the centre, so only pixels on an edge may differ.
+  uint32_t differ = 0;
+  uint32_t shadowed = 0;
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i) {
+    if (!near_unorm8(pixels[4 * i], expected[4 * i]) ||
+        !near_unorm8(pixels[(4 * i) + 1], expected[(4 * i) + 1]) ||
+        !near_unorm8(pixels[(4 * i) + 2], expected[(4 * i) + 2])) {
+      ++differ;
+    }
+    if (pixels[4 * i] == 0 && pixels[(4 * i) + 1] == 0) {
+      ++shadowed;
+    }
+  }
+  RADIANT_EXPECT_TRUE(differ * 20 < WIDTH * HEIGHT);
+  RADIANT_EXPECT_TRUE(shadowed > 0);
+
+  free(expected);
+  radiant_tracer_destroy(reference.tracer);
+  free(pixels);
+  radiant_ray_caster_destroy(result.caster);
+  return true;
+}
+
+static bool no_shadows() {
+  radiant_ray_caster_create_result_t result =
+      radiant_ray_caster_create(request(false));
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  uint8_t* pixels = (uint8_t*)malloc(WIDTH * HEIGHT * 4);
+  RADIANT_EXPECT_TRUE(cast(&result.caster, pixels));
+
+  // Every pixel sees either the lit red ground or the lit green roof.
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i) {
+    uint8_t r = pixels[4 * i];
+    uint8_t g = pixels[(4 * i) + 1];
+    RADIANT_EXPECT_TRUE(near_unorm8(r > g ? r : g, 0.8f));
+    RADIANT_EXPECT_EQ(r > g ? g : r, 0);
+    RADIANT_EXPECT_EQ(pixels[(4 * i) + 2], 0);
+  }
+  free(pixels);
+  radiant_ray_caster_destroy(result.caster);
+  return true;
+}
+
+static bool set_camera() {
+  radiant_ray_caster_create_result_t result =
+      radiant_ray_caster_create(request(true));
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_camera_t cam = camera();
+  radiant_camera_rotate(&cam, (radiant_point3_t){0.f, 0.5f, 0.f});
+  RADIANT_EXPECT_TRUE(radiant_ray_caster_set_camera(&result.caster, &cam));
+  RADIANT_EXPECT_FLOAT_EQ(result.caster.uniforms.eye.x, cam.position.current.x);
+  RADIANT_EXPECT_FLOAT_EQ(result.caster.uniforms.eye.z, cam.position.current.z);
+
+  // Unchanged, nothing to upload.
+  uint32_t version = result.caster.camera_view_version;
+  RADIANT_EXPECT_TRUE(radiant_ray_caster_set_camera(&result.caster, &cam));
+  RADIANT_EXPECT_EQ(result.caster.camera_view_version, version);
+
+  // Looking straight down along up has no view matrix.
+  radiant_camera_t singular = radiant_camera_create(
+      (radiant_point3_t){0.f, 5.f, 0.f}, (radiant_point3_t){0.f, 0.f, 0.f},
+      (radiant_vec3_t){0.f, 1.f, 0.f}, cam.view);
+  RADIANT_EXPECT_FALSE(
+      radiant_ray_caster_set_camera(&result.caster, &singular));
+  RADIANT_EXPECT_EQ(result.caster.camera_view_version, version);
+  radiant_ray_caster_destroy(result.caster);
+  return !gpu_error;
+}
+
+/// Presenting into the offscreen target of the headless engine gives the
+/// cast frame, swizzled to BGRA.
+static bool presents_to_target() {
+  radiant_ray_caster_create_result_t result =
+      radiant_ray_caster_create(request(true));
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  uint8_t* cast_pixels = (uint8_t*)malloc(WIDTH * HEIGHT * 4);
+  uint8_t* target_pixels = (uint8_t*)malloc(WIDTH * HEIGHT * 4);
+  RADIANT_EXPECT_TRUE(cast(&result.caster, cast_pixels));
+
+  WGPUCommandEncoder encoder =
+      wgpuDeviceCreateCommandEncoder(engine.device, NULL);
+  radiant_ray_caster_encode(&result.caster, encoder);
+  radiant_ray_caster_present(&result.caster, encoder,
+                             radiant_engine_current_view(engine));
+  RADIANT_EXPECT_TRUE(read_back(encoder, engine.target, target_pixels));
+  radiant_engine_present(engine);
+
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i) {
+    RADIANT_EXPECT_EQ(target_pixels[4 * i], cast_pixels[(4 * i) + 2]);
+    RADIANT_EXPECT_EQ(target_pixels[(4 * i) + 1], cast_pixels[(4 * i) + 1]);
+    RADIANT_EXPECT_EQ(target_pixels[(4 * i) + 2], cast_pixels[4 * i]);
+  }
+  free(target_pixels);
+  free(cast_pixels);
+  radiant_ray_caster_destroy(result.caster);
+  return true;
+}
+
+/// The engine reports the device it got, and will not create one beyond the
+/// adapter.
+static bool device_requirements() {
+  RADIANT_EXPECT_TRUE(engine.limits.max_bind_groups >= 4);
+  RADIANT_EXPECT_TRUE(engine.limits.max_storage_buffer_binding_size > 0);
+
+  radiant_engine_headless_create_request_t req = {
+      .adapter = {.policy = radiant_adapter_policy_software},
+      .size = {.width = WIDTH, .height = HEIGHT},
+      .format = WGPUTextureFormat_BGRA8Unorm,
+  };
+  req.adapter.requirements.limits.max_bind_groups = UINT32_MAX;
+  RADIANT_EXPECT_FALSE(radiant_engine_create_headless(req).succeeded);
+
+  // Clamped, the device gets what the adapter has.
+  req.adapter.requirements.clamp_limits = true;
+  req.adapter.requirements.optional_features =
+      RADIANT_ADAPTER_FEATURE(WGPUFeatureName_TimestampQuery);
+  radiant_engine_create_result_t result = radiant_engine_create_headless(req);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  RADIANT_EXPECT_TRUE(result.engine.limits.max_bind_groups >=
+                      engine.limits.max_bind_groups);
+  RADIANT_EXPECT_TRUE((result.engine.features &
+                       ~req.adapter.requirements.optional_features) == 0);
+  radiant_engine_destroy(result.engine);
+  return true;
+}
+
+/// Resizing a headless engine replaces its target.
+static bool resizes_target() {
+  radiant_engine_create_result_t result =
+      radiant_engine_create_headless((radiant_engine_headless_create_request_t){
+          .adapter = {.policy = radiant_adapter_policy_software},
+          .size = {.width = WIDTH, .height = HEIGHT},
+          .format = WGPUTextureFormat_BGRA8Unorm,
+      });
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_engine_t resized = result.engine;
+  RADIANT_EXPECT_EQ(resized.size.width, WIDTH);
+  WGPUTexture target = resized.target;
+
+  radiant_engine_resize(&resized, resized.size);
+  RADIANT_EXPECT_TRUE(resized.target == target);
+
+  radiant_engine_resize(&resized, (radiant_size_t){.width = 8, .height = 4});
+  RADIANT_EXPECT_FALSE(resized.target == target);
+  RADIANT_EXPECT_EQ(resized.size.width, 8);
+  RADIANT_EXPECT_EQ(resized.size.height, 4);
+  RADIANT_EXPECT_EQ(resized.format, WGPUTextureFormat_BGRA8Unorm);
+  RADIANT_EXPECT_TRUE(radiant_engine_current_view(resized) ==
+                      resized.target_view);
+  radiant_engine_destroy(resized);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("ray_caster");
+
+  radiant_resource_manager_create_result_t manager_result =
+      radiant_resource_manager_create("./resources");
+  if (!manager_result.succeeded) {
+    printf("Failed to create resource manager\n");
+    return 1;
+  }
+  manager = manager_result.manager;
+
+  radiant_engine_create_result_t engine_result =
+      radiant_engine_create_headless((radiant_engine_headless_create_request_t){
+          .size = {.width = WIDTH, .height = HEIGHT},
+          .format = WGPUTextureFormat_BGRA8Unorm,
+          .adapter = {.policy = radiant_adapter_policy_software},
+      });
+  if (!engine_result.succeeded) {
+    printf("No software adapter, skipping\n");
+    radiant_resource_manager_destroy(manager);
+    return radiant_suite_end();
+  }
+  engine = engine_result.engine;
+  wgpuDeviceSetUncapturedErrorCallback(engine.device, error_callback, NULL);
+
+  RADIANT_TEST(empty_frame_fails);
+  RADIANT_TEST(sky_only);
+  RADIANT_TEST(matches_tracer);
+  RADIANT_TEST(no_shadows);
+  RADIANT_TEST(set_camera);
+  RADIANT_TEST(presents_to_target);
+  RADIANT_TEST(device_requirements);
+  RADIANT_TEST(resizes_target);
+
+  radiant_engine_destroy(engine);
+  radiant_resource_manager_destroy(manager);
+  return radiant_suite_end();
+}
@@ -0,0 +1,292 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ray.h"
+
+#include <math.h>
+
+#include "src/simd.h"
+#include "src/test.h"
+
+/// Not a multiple of any vector width.
+#define COUNT 203
+
+static radiant_ray_t ray(radiant_point3_t origin, radiant_vec3_t direction) {
+  return (radiant_ray_t){
+      .origin = origin,
+      .direction = direction,
+      .t_min = 0.f,
+      .t_max = INFINITY,
+  };
+}
+
+static bool at() {
+  radiant_ray_t r = ray((radiant_point3_t){1.f, 2.f, 3.f},
+                        (radiant_vec3_t){0.f, 0.f, -2.f});
+  radiant_point3_t p = radiant_ray_at(r, 1.5f);
+  RADIANT_EXPECT_FLOAT_EQ(p.x, 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(p.y, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(p.z, 0.f);
+  return true;
+}
+
+static bool intersect_triangle() {
+  radiant_point3_t a = {0.f, 0.f, -5.f};
+  radiant_point3_t b = {2.f, 0.f, -5.f};
+  radiant_point3_t c = {0.f, 2.f, -5.f};
+
+  radiant_ray_t r = ray((radiant_point3_t){0.5f, 0.25f, 0.f},
+                        (radiant_vec3_t){0.f, 0.f, -1.f});
+  radiant_ray_triangle_hit_t hit = radiant_ray_intersect_triangle(r, a, b, c);
+  RADIANT_EXPECT_TRUE(hit.hit);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t, 5.f);
+  RADIANT_EXPECT_FLOAT_EQ(hit.u, 0.25f);
+  RADIANT_EXPECT_FLOAT_EQ(hit.v, 0.125f);
+  radiant_point3_t p = radiant_ray_at(r, hit.t);
+  RADIANT_EXPECT_FLOAT_EQ(p.z, -5.f);
+
+  // The back face counts too.
+  hit = radiant_ray_intersect_triangle(r, a, c, b);
+  RADIANT_EXPECT_TRUE(hit.hit);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t, 5.f);
+
+  // Outside the hypotenuse, and pointing away.
+  r.origin.x = 1.5f;
+  r.origin.y = 1.5f;
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+  r.origin = (radiant_point3_t){0.5f, 0.25f, 0.f};
+  r.direction.z = 1.f;
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+
+  // Vertices and edges are inside.
+  r = ray((radiant_point3_t){0.f, 0.f, 0.f}, (radiant_vec3_t){0.f, 0.f, -1.f});
+  RADIANT_EXPECT_TRUE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+  r.origin.x = 1.f;
+  RADIANT_EXPECT_TRUE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+  return true;
+}
+
+static bool intersect_triangle_range() {
+  radiant_point3_t a = {0.f, 0.f, -5.f};
+  radiant_point3_t b = {2.f, 0.f, -5.f};
+  radiant_point3_t c = {0.f, 2.f, -5.f};
+  radiant_ray_t r = ray((radiant_point3_t){0.5f, 0.5f, 0.f},
+                        (radiant_vec3_t){0.f, 0.f, -1.f});
+
+  r.t_max = 4.f;
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+  r.t_max = 5.f;
+  RADIANT_EXPECT_TRUE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+  r.t_min = 6.f;
+  r.t_max = INFINITY;
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_triangle(r, a, b, c).hit);
+  return true;
+}
+
+static bool intersect_triangle_degenerate() {
+  // Collinear vertices, and a ray in the plane of the triangle.
+  radiant_ray_t r = ray((radiant_point3_t){0.5f, 0.f, 0.f},
+                        (radiant_vec3_t){0.f, 0.f, -1.f});
+  RADIANT_EXPECT_FALSE(
+      radiant_ray_intersect_triangle(r, (radiant_point3_t){0.f, 0.f, -5.f},
+                                     (radiant_point3_t){1.f, 0.f, -5.f},
+                                     (radiant_point3_t){2.f, 0.f, -5.f})
+          .hit);
+  r = ray((radiant_point3_t){-1.f, 0.5f, -5.f},
+          (radiant_vec3_t){1.f, 0.f, 0.f});
+  RADIANT_EXPECT_FALSE(
+      radiant_ray_intersect_triangle(r, (radiant_point3_t){0.f, 0.f, -5.f},
+                                     (radiant_point3_t){2.f, 0.f, -5.f},
+                                     (radiant_point3_t){0.f, 2.f, -5.f})
+          .hit);
+  return true;
+}
+
+static bool intersect_aabb() {
+  radiant_aabb_t box = {.min = {-1.f, -1.f, -6.f}, .max = {1.f, 1.f, -4.f}};
+  radiant_ray_t r = ray((radiant_point3_t){0.f, 0.f, 0.f},
+                        (radiant_vec3_t){0.f, 0.f, -1.f});
+  radiant_ray_aabb_hit_t hit = radiant_ray_intersect_aabb(r, box);
+  RADIANT_EXPECT_TRUE(hit.hit);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t_near, 4.f);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t_far, 6.f);
+
+  // Clamped to the extent of the ray.
+  r.t_max = 5.f;
+  hit = radiant_ray_intersect_aabb(r, box);
+  RADIANT_EXPECT_TRUE(hit.hit);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t_far, 5.f);
+  r.t_max = 3.f;
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_aabb(r, box).hit);
+
+  // Starting inside the box.
+  r = ray((radiant_point3_t){0.f, 0.f, -5.f}, (radiant_vec3_t){1.f, 1.f, 0.f});
+  hit = radiant_ray_intersect_aabb(r, box);
+  RADIANT_EXPECT_TRUE(hit.hit);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t_near, 0.f);
+  RADIANT_EXPECT_FLOAT_EQ(hit.t_far, 1.f);
+
+  // Sliding along the face shared with a neighbour counts for one of them.
+  radiant_aabb_t neighbour = {.min = {1.f, -1.f, -6.f},
+                              .max = {3.f, 1.f, -4.f}};
+  r = ray((radiant_point3_t){1.f, 0.f, 0.f}, (radiant_vec3_t){0.f, 0.f, -1.f});
+  RADIANT_EXPECT_TRUE(radiant_ray_intersect_aabb(r, box).hit !=
+                      radiant_ray_intersect_aabb(r, neighbour).hit);
+  r.direction.x = -0.f;
+  RADIANT_EXPECT_TRUE(radiant_ray_intersect_aabb(r, box).hit !=
+                      radiant_ray_intersect_aabb(r, neighbour).hit);
+
+  // Passing beside and pointing away.
+  r = ray((radiant_point3_t){2.f, 0.f, 0.f}, (radiant_vec3_t){0.f, 0.f, -1.f});
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_aabb(r, box).hit);
+  r = ray((radiant_point3_t){0.f, 0.f, 0.f}, (radiant_vec3_t){0.f, 0.f, 1.f});
+  RADIANT_EXPECT_FALSE(radiant_ray_intersect_aabb(r, box).hit);
+  return true;
+}
+
+/// Returns the vertices of the |i|th of a scatter of small triangles at
+/// varying depths in front of the origin, some overlapping along -z.
+static void triangle(uint32_t i,
+                     radiant_point3_t* a,
+                     radiant_point3_t* b,
+                     radiant_point3_t* c) {
+  float fi = (float)i;
+  float x = fmodf(fi * 0.37f, 2.f) - 1.f;
+  float y = fmodf(fi * 0.61f, 2.f) - 1.f;
+  float z = -2.f - fmodf(fi * 1.3f, 17.f);
+  *a = (radiant_point3_t){x, y, z};
+  *b = (radiant_point3_t){x + 0.9f, y + 0.1f, z - 0.2f};
+  *c = (radiant_point3_t){x - 0.1f, y + 0.8f, z + 0.3f};
+}
+
+static void fill_triangles(radiant_triangle_soa_t triangles) {
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    // Triangle 12 duplicates 5, so hitting either must report 5.
+    radiant_point3_t a;
+    radiant_point3_t b;
+    radiant_point3_t c;
+    triangle(i == 12 ? 5 : i, &a, &b, &c);
+    radiant_triangle_soa_set(triangles, i, a, b, c);
+  }
+}
+
+static bool intersect_triangles() {
+  radiant_triangle_soa_t triangles = radiant_triangle_soa_create(COUNT);
+  RADIANT_EXPECT_EQ(radiant_triangle_soa_count(triangles), COUNT);
+  fill_triangles(triangles);
+
+  uint32_t ranges[][2] = {{0, COUNT}, {3, 150}, {17, 18}, {40, 40}};
+  uint32_t hits = 0;
+  for (uint32_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+    uint32_t begin = ranges[r][0];
+    uint32_t end = ranges[r][1];
+    for (uint32_t j = 0; j < 64; ++j) {
+      float fj = (float)j;
+      radiant_ray_t ray_j = ray(
+          (radiant_point3_t){0.f, 0.f, 0.f},
+          (radiant_vec3_t){fmodf(fj * 0.13f, 0.8f) - 0.4f,
+                           fmodf(fj * 0.29f, 0.8f) - 0.4f, -1.f});
+      radiant_ray_triangle_hit_t hit =
+          radiant_ray_intersect_triangles(ray_j, triangles, begin, end);
+
+      radiant_ray_triangle_hit_t expected = {.t = INFINITY};
+      for (uint32_t i = begin; i < end; ++i) {
+        radiant_point3_t a = radiant_point3_soa_get(triangles.v0, i);
+        radiant_ray_triangle_hit_t h = radiant_ray_intersect_triangle(
+            ray_j, a,
+            radiant_point3_add(a, radiant_vec3_soa_get(triangles.edge1, i)),
+            radiant_point3_add(a, radiant_vec3_soa_get(triangles.edge2, i)));
+        if (h.hit && h.t < expected.t) {
+          expected = h;
+          expected.index = i;
+        }
+      }
+
+      RADIANT_EXPECT_EQ(hit.hit, expected.hit);
+      if (expected.hit) {
+        ++hits;
+        RADIANT_EXPECT_EQ(hit.index, expected.index);
+        RADIANT_EXPECT_TRUE(fabsf(hit.t - expected.t) < 1e-5f);
+        RADIANT_EXPECT_TRUE(fabsf(hit.u - expected.u) < 1e-5f);
+        RADIANT_EXPECT_TRUE(fabsf(hit.v - expected.v) < 1e-5f);
+      }
+    }
+  }
+  RADIANT_EXPECT_TRUE(hits > 0);
+
+  // Straight through the duplicated triangle.
+  radiant_point3_t a;
+  radiant_point3_t b;
+  radiant_point3_t c;
+  triangle(5, &a, &b, &c);
+  radiant_ray_t through = ray((radiant_point3_t){a.x + 0.2f, a.y + 0.2f, 0.f},
+                              (radiant_vec3_t){0.f, 0.f, -1.f});
+  for (uint32_t begin = 0; begin <= 5; begin += 5) {
+    radiant_ray_triangle_hit_t hit =
+        radiant_ray_intersect_triangles(through, triangles, begin, COUNT);
+    RADIANT_EXPECT_TRUE(hit.hit);
+    RADIANT_EXPECT_TRUE(hit.index != 12);
+  }
+
+  radiant_triangle_soa_destroy(triangles);
+  return true;
+}
+
+static bool ray_soa_intersect_aabb() {
+  radiant_aabb_t box = {.min = {-1.f, -2.f, -8.f}, .max = {2.f, 1.f, -4.f}};
+  radiant_ray_soa_t rays = radiant_ray_soa_create(COUNT);
+  RADIANT_EXPECT_EQ(radiant_ray_soa_count(rays), COUNT);
+
+  radiant_ray_t single[COUNT];
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    float fi = (float)i;
+    single[i] = ray((radiant_point3_t){fmodf(fi * 0.7f, 6.f) - 3.f,
+                                       fmodf(fi * 0.3f, 6.f) - 3.f,
+                                       fmodf(fi * 0.9f, 14.f) - 12.f},
+                    (radiant_vec3_t){fmodf(fi * 0.11f, 1.f) - 0.5f,
+                                     fmodf(fi * 0.17f, 1.f) - 0.5f, -1.f});
+    single[i].t_max = 10.f;
+    radiant_ray_soa_set(rays, i, single[i].origin, single[i].direction);
+  }
+
+  float t[COUNT];
+  radiant_ray_soa_intersect_aabb(rays, box, 10.f, t);
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < COUNT; ++i) {
+    radiant_ray_aabb_hit_t expected =
+        radiant_ray_intersect_aabb(single[i], box);
+    RADIANT_EXPECT_EQ(!isinf(t[i]), expected.hit);
+    if (expected.hit) {
+      ++hits;
+      RADIANT_EXPECT_FLOAT_EQ(t[i], expected.t_near);
+    }
+  }
+  RADIANT_EXPECT_TRUE(hits > 0);
+  RADIANT_EXPECT_TRUE(hits < COUNT);
+
+  radiant_ray_soa_destroy(rays);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("ray");
+  RADIANT_TEST(at);
+  RADIANT_TEST(intersect_triangle);
+  RADIANT_TEST(intersect_triangle_range);
+  RADIANT_TEST(intersect_triangle_degenerate);
+  RADIANT_TEST(intersect_aabb);
+  RADIANT_TEST_ALL_BACKENDS(intersect_triangles);
+  RADIANT_TEST_ALL_BACKENDS(ray_soa_intersect_aabb);
+  return radiant_suite_end();
+}
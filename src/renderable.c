@@ -0,0 +1,234 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/renderable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/array_element_count.h"
+#include "src/assert.h"
+#include "src/mvp.h"
+
+radiant_renderables_t radiant_renderables_register(radiant_ecs_t* ecs) {
+  return (radiant_renderables_t){
+      .transform = radiant_ecs_register(ecs, sizeof(radiant_mat4x4_t)),
+      .bounds = radiant_ecs_register(ecs, sizeof(radiant_aabb_t)),
+      .draw = radiant_ecs_register(ecs, sizeof(radiant_draw_t)),
+  };
+}
+
+radiant_ecs_signature_t radiant_renderables_signature(
+    radiant_renderables_t renderables) {
+  return RADIANT_ECS_SIGNATURE(renderables.transform) |
+         RADIANT_ECS_SIGNATURE(renderables.bounds) |
+         RADIANT_ECS_SIGNATURE(renderables.draw);
+}
+
+WGPUBindGroupLayout radiant_renderables_mvp_layout_create(
+    radiant_engine_t engine) {
+  WGPUBindGroupLayoutEntry entries[] = {
+      {
+          .binding = 0,
+          .visibility = WGPUShaderStage_Vertex,
+          .buffer =
+              {
+                  .type = WGPUBufferBindingType_Uniform,
+                  .hasDynamicOffset = true,
+                  .minBindingSize = sizeof(radiant_mat4x4_t),
+              },
+      },
+  };
+  WGPUBindGroupLayoutDescriptor desc = {
+      .label = "Renderable MVP layout",
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(entries),
+      .entries = entries,
+  };
+  return wgpuDeviceCreateBindGroupLayout(engine.device, &desc);
+}
+
+radiant_renderables_batch_t radiant_renderables_batch_create(
+    radiant_renderables_batch_create_request_t req) {
+  return (radiant_renderables_batch_t){
+      .engine = req.engine,
+      .layout = req.layout,
+  };
+}
+
+/// Frees the memory of |batch|.
+static void release_batch(radiant_renderables_batch_t* batch) {
+  if (batch->capacity == 0) {
+    return;
+  }
+  wgpuBindGroupRelease(batch->bind_group);
+  radiant_buffer_destroy(batch->mvp_buffer);
+  radiant_aabb_soa_destroy(batch->world_bounds);
+  free(batch->visible);
+  free(batch->draws);
+  free(batch->models);
+  free(batch->mvps);
+  free(batch->staging);
+  batch->capacity = 0;
+}
+
+void radiant_renderables_batch_destroy(radiant_renderables_batch_t* batch) {
+  release_batch(batch);
+}
+
+/// Makes room in |batch| for at least |count| entities.
+static void reserve(radiant_renderables_batch_t* batch, uint32_t count) {
+  if (count <= batch->capacity) {
+    return;
+  }
+  uint32_t capacity = batch->capacity > 0 ? batch->capacity : 64;
+  while (capacity < count) {
+    capacity *= 2;
+  }
+  release_batch(batch);
+
+  size_t matrix_bytes = capacity * sizeof(radiant_mat4x4_t);
+  batch->world_bounds = radiant_aabb_soa_create(capacity);
+  batch->visible = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+  batch->draws =
+      (const radiant_draw_t**)malloc(capacity * sizeof(radiant_draw_t*));
+  batch->models = (radiant_mat4x4_t*)aligned_alloc(RADIANT_MVP_ALIGNMENT,
+                                                   matrix_bytes);
+  batch->mvps = (radiant_mat4x4_t*)aligned_alloc(RADIANT_MVP_ALIGNMENT,
+                                                 matrix_bytes);
+  batch->staging =
+      (uint8_t*)calloc(capacity, RADIANT_RENDERABLES_MVP_STRIDE);
+  RADIANT_ASSERT(radiant_aabb_soa_count(batch->world_bounds) == capacity);
+  RADIANT_ASSERT(batch->visible && batch->draws && batch->models &&
+                 batch->mvps && batch->staging);
+
+  batch->mvp_buffer = radiant_buffer_create((radiant_buffer_create_request_t){
+      .engine = batch->engine,
+      .usage = radiant_buffer_usage_uniform | radiant_buffer_usage_copy_dst,
+      .label = "Renderable MVPs",
+      .size_in_bytes = (uint64_t)capacity * RADIANT_RENDERABLES_MVP_STRIDE,
+  });
+  WGPUBindGroupEntry entries[] = {
+      {
+          .binding = 0,
+          .buffer = batch->mvp_buffer.buffer,
+          .size = sizeof(radiant_mat4x4_t),
+      },
+  };
+  WGPUBindGroupDescriptor desc = {
+      .label = "Renderable MVPs",
+      .layout = batch->layout,
+      .entryCount = RADIANT_ARRAY_ELEMENT_COUNT(entries),
+      .entries = entries,
+  };
+  batch->bind_group = wgpuDeviceCreateBindGroup(batch->engine.device, &desc);
+  batch->capacity = capacity;
+}
+
+/// The state of a radiant_renderables_draw.
+typedef struct draw_state_t {
+  radiant_frustum_t frustum;
+  radiant_renderables_t renderables;
+  /// The entities found visible so far
+  uint32_t visible;
+  radiant_renderables_batch_t* batch;
+} draw_state_t;
+
+/// Culls the entities of |chunk| and appends the visible ones to the batch.
+static void cull_chunk(void* userdata, const radiant_ecs_chunk_t* chunk) {
+  draw_state_t* state = (draw_state_t*)userdata;
+  radiant_renderables_batch_t* batch = state->batch;
+  const radiant_mat4x4_t* transforms = (const radiant_mat4x4_t*)
+      radiant_ecs_chunk_column(chunk, state->renderables.transform);
+  const radiant_aabb_t* bounds = (const radiant_aabb_t*)
+      radiant_ecs_chunk_column(chunk, state->renderables.bounds);
+  const radiant_draw_t* draws = (const radiant_draw_t*)
+      radiant_ecs_chunk_column(chunk, state->renderables.draw);
+
+  for (uint32_t i = 0; i < chunk->count; ++i) {
+    radiant_aabb_soa_set(batch->world_bounds, i,
+                         radiant_aabb_transform(bounds[i], transforms[i]));
+  }
+  uint32_t visible = radiant_frustum_cull_aabbs(
+      state->frustum, batch->world_bounds, 0, chunk->count, batch->visible);
+  for (uint32_t i = 0; i < visible; ++i) {
+    uint32_t idx = batch->visible[i];
+    batch->draws[state->visible] = &draws[idx];
+    batch->models[state->visible] = transforms[idx];
+    ++state->visible;
+  }
+}
+
+uint32_t radiant_renderables_draw(const radiant_ecs_t* ecs,
+                                  radiant_renderables_t renderables,
+                                  radiant_frustum_t frustum,
+                                  radiant_mat4x4_t view_projection,
+                                  radiant_renderables_batch_t* batch,
+                                  WGPURenderPassEncoder pass) {
+  radiant_ecs_query_t query = {
+      .all = radiant_renderables_signature(renderables),
+  };
+  uint32_t count = radiant_ecs_query_count(ecs, query);
+  if (count == 0) {
+    return 0;
+  }
+  reserve(batch, count);
+
+  draw_state_t state = {
+      .frustum = frustum,
+      .renderables = renderables,
+      .batch = batch,
+  };
+  radiant_ecs_query_for_each(ecs, query, cull_chunk, &state);
+  if (state.visible == 0) {
+    return 0;
+  }
+
+  radiant_mvp_compute(view_projection, batch->models, batch->mvps, 0,
+                      state.visible);
+  for (uint32_t i = 0; i < state.visible; ++i) {
+    memcpy(batch->staging + ((size_t)i * RADIANT_RENDERABLES_MVP_STRIDE),
+           &batch->mvps[i], sizeof(radiant_mat4x4_t));
+  }
+  radiant_buffer_write(batch->mvp_buffer,
+                       (uint64_t)state.visible * RADIANT_RENDERABLES_MVP_STRIDE,
+                       batch->staging);
+
+  // Entities drawn the same way run back to back, so only changes are set.
+  const radiant_draw_t* last = NULL;
+  for (uint32_t i = 0; i < state.visible; ++i) {
+    const radiant_draw_t* d = batch->draws[i];
+    if (!last || last->pipeline != d->pipeline) {
+      wgpuRenderPassEncoderSetPipeline(pass, d->pipeline);
+    }
+    if (!last || last->bind_group != d->bind_group) {
+      wgpuRenderPassEncoderSetBindGroup(pass, 0, d->bind_group, 0, NULL);
+    }
+    if (!last || last->vertex_buffer.buffer != d->vertex_buffer.buffer) {
+      wgpuRenderPassEncoderSetVertexBuffer(pass, 0, d->vertex_buffer.buffer, 0,
+                                           WGPU_WHOLE_SIZE);
+    }
+    if (!last || last->index_buffer.buffer != d->index_buffer.buffer ||
+        last->index_format != d->index_format) {
+      wgpuRenderPassEncoderSetIndexBuffer(pass, d->index_buffer.buffer,
+                                          d->index_format, 0, WGPU_WHOLE_SIZE);
+    }
+    uint32_t offset = i * RADIANT_RENDERABLES_MVP_STRIDE;
+    wgpuRenderPassEncoderSetBindGroup(pass, RADIANT_RENDERABLES_MVP_GROUP,
+                                      batch->bind_group, 1, &offset);
+    wgpuRenderPassEncoderDrawIndexed(pass, d->index_count, d->instance_count,
+                                     0, 0, 0);
+    last = d;
+  }
+  return state.visible;
+}
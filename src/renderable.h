@@ -0,0 +1,136 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/bounds.h"
+#include "src/buffer.h"
+#include "src/ecs.h"
+#include "src/engine.h"
+#include "src/frustum.h"
+#include "src/mat4x4.h"
+#include "src/pad.h"
+#include "src/wgpu.h"
+
+/// The bind group radiant_renderables_draw sets for the model view
+/// projection matrix of each entity.
+#define RADIANT_RENDERABLES_MVP_GROUP 1
+/// Bytes between the model view projection matrices of consecutive draws in
+/// a radiant_renderables_batch_t, the WebGPU default
+/// minUniformBufferOffsetAlignment.
+#define RADIANT_RENDERABLES_MVP_STRIDE 256
+
+/// The draw component of a renderable: an indexed draw of its buffers.
+typedef struct radiant_draw_t {
+  /// The pipeline to draw with. Its layout must have the layout of
+  /// radiant_renderables_mvp_layout_create at RADIANT_RENDERABLES_MVP_GROUP.
+  WGPURenderPipeline pipeline;
+  /// Bound to group 0
+  WGPUBindGroup bind_group;
+  /// Bound to vertex buffer slot 0
+  radiant_buffer_t vertex_buffer;
+  /// The indices into |vertex_buffer|
+  radiant_buffer_t index_buffer;
+  /// The format of |index_buffer|
+  WGPUIndexFormat index_format;
+  /// The number of indices to draw
+  uint32_t index_count;
+  /// The number of instances to draw
+  uint32_t instance_count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_draw_t;
+
+/// The components of an entity drawn by radiant_renderables_draw.
+typedef struct radiant_renderables_t {
+  /// A radiant_mat4x4_t, the model matrix of the entity
+  radiant_ecs_component_t transform;
+  /// A radiant_aabb_t, the bounds of the entity before |transform|
+  radiant_ecs_component_t bounds;
+  /// A radiant_draw_t
+  radiant_ecs_component_t draw;
+} radiant_renderables_t;
+
+/// Registers the renderable components with |ecs|.
+radiant_renderables_t radiant_renderables_register(radiant_ecs_t* ecs);
+
+/// Returns the signature of an entity with every renderable component.
+radiant_ecs_signature_t radiant_renderables_signature(
+    radiant_renderables_t renderables);
+
+/// Creates the layout of the bind group at RADIANT_RENDERABLES_MVP_GROUP:
+/// the mat4x4f model view projection matrix of the entity drawn, a uniform
+/// at binding 0 read by the vertex stage at a dynamic offset. The caller
+/// releases it.
+WGPUBindGroupLayout radiant_renderables_mvp_layout_create(
+    radiant_engine_t engine);
+
+/// Structure for requesting a batch
+typedef struct radiant_renderables_batch_create_request_t {
+  /// The engine
+  radiant_engine_t engine;
+  /// From radiant_renderables_mvp_layout_create, must outlive the batch
+  WGPUBindGroupLayout layout;
+} radiant_renderables_batch_create_request_t;
+
+/// What radiant_renderables_draw keeps from frame to frame: the culling
+/// scratch memory and the uniform buffer the model view projection matrices
+/// of the visible entities are uploaded to, all grown as needed. Use one per
+/// frame in flight so a frame never overwrites matrices the GPU still reads.
+typedef struct radiant_renderables_batch_t {
+  radiant_engine_t engine;
+  WGPUBindGroupLayout layout;
+  /// The matrices, RADIANT_RENDERABLES_MVP_STRIDE bytes apart
+  radiant_buffer_t mvp_buffer;
+  /// Binds |mvp_buffer| at RADIANT_RENDERABLES_MVP_GROUP
+  WGPUBindGroup bind_group;
+  /// The bounds of the entities of a chunk after their transform
+  radiant_aabb_soa_t world_bounds;
+  /// The indices of the visible entities of a chunk
+  uint32_t* visible;
+  /// The draws of the visible entities
+  const radiant_draw_t** draws;
+  /// The model matrices of the visible entities
+  radiant_mat4x4_t* models;
+  /// The model view projection matrices of the visible entities
+  radiant_mat4x4_t* mvps;
+  /// |mvps| laid out as in |mvp_buffer|
+  uint8_t* staging;
+  /// The entities the members above have room for
+  uint32_t capacity;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_renderables_batch_t;
+
+/// Creates an empty batch, the memory is allocated on first draw.
+radiant_renderables_batch_t radiant_renderables_batch_create(
+    radiant_renderables_batch_create_request_t req);
+
+/// Destroys |batch|.
+void radiant_renderables_batch_destroy(radiant_renderables_batch_t* batch);
+
+/// Records the draws of every entity with the renderable components whose
+/// transformed bounds intersect |frustum| into |pass|. The bounds of each
+/// chunk are culled together, then the model view projection matrices of
+/// the visible entities, |view_projection| by their transform, are computed
+/// together and uploaded to |batch| in a single write. Returns the number of
+/// entities drawn.
+uint32_t radiant_renderables_draw(const radiant_ecs_t* ecs,
+                                  radiant_renderables_t renderables,
+                                  radiant_frustum_t frustum,
+                                  radiant_mat4x4_t view_projection,
+                                  radiant_renderables_batch_t* batch,
+                                  WGPURenderPassEncoder pass);
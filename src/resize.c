@@ -0,0 +1,53 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/resize.h"
+
+static bool size_equal(radiant_size_t a, radiant_size_t b) {
+  return a.width == b.width && a.height == b.height;
+}
+
+bool radiant_size_empty(radiant_size_t size) {
+  return size.width == 0 || size.height == 0;
+}
+
+radiant_resize_t radiant_resize_create(radiant_size_t size, double settle_ms) {
+  return (radiant_resize_t){
+      .current = size,
+      .pending = size,
+      .settle_ms = settle_ms,
+  };
+}
+
+bool radiant_resize_update(radiant_resize_t* resize,
+                           radiant_size_t size,
+                           radiant_time_t now) {
+  if (!size_equal(size, resize->pending)) {
+    resize->pending = size;
+    resize->changed = now;
+  }
+  if (!radiant_resize_pending(resize) || radiant_size_empty(resize->pending)) {
+    return false;
+  }
+  if (radiant_time_diff_to_ms(radiant_time_sub(now, resize->changed)) <
+      resize->settle_ms) {
+    return false;
+  }
+  resize->current = resize->pending;
+  return true;
+}
+
+bool radiant_resize_pending(const radiant_resize_t* resize) {
+  return !size_equal(resize->current, resize->pending);
+}
@@ -0,0 +1,52 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "src/pad.h"
+#include "src/size.h"
+#include "src/time.h"
+
+/// Holds back size changes until they settle, so dragging a window edge
+/// recreates the size dependent resources once rather than every frame.
+typedef struct radiant_resize_t {
+  /// The size the resources have
+  radiant_size_t current;
+  /// The latest size seen, applied once it holds for |settle_ms|
+  radiant_size_t pending;
+  /// When |pending| last changed
+  radiant_time_t changed;
+  /// Milliseconds |pending| must hold before it is applied
+  double settle_ms;
+} radiant_resize_t;
+
+/// Creates a resize tracker for resources of |size|, applying changes once
+/// they hold for |settle_ms|.
+radiant_resize_t radiant_resize_create(radiant_size_t size, double settle_ms);
+
+/// Records that the size is |size| at |now|. Returns true when the resources
+/// should be recreated at |resize->current|, the last size seen once it held
+/// for the settle time. Empty sizes, as for a minimized window, are never
+/// applied.
+bool radiant_resize_update(radiant_resize_t* resize,
+                           radiant_size_t size,
+                           radiant_time_t now);
+
+/// Returns true if |resize| has seen a size it has not applied yet.
+bool radiant_resize_pending(const radiant_resize_t* resize);
+
+/// Returns true if |size| has no area.
+bool radiant_size_empty(radiant_size_t size);
@@ -0,0 +1,99 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/resize.h"
+
+#include "src/test.h"
+
+/// Nanoseconds, the unit of radiant_time_t
+#define MS 1000000
+
+static const radiant_size_t kStart = {.width = 640, .height = 480};
+
+static bool applies_once_settled() {
+  radiant_resize_t resize = radiant_resize_create(kStart, 100.0);
+  RADIANT_EXPECT_FALSE(radiant_resize_pending(&resize));
+  RADIANT_EXPECT_FALSE(radiant_resize_update(&resize, kStart, 0));
+
+  RADIANT_EXPECT_FALSE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 800, .height = 600}, 1000 * MS));
+  RADIANT_EXPECT_TRUE(radiant_resize_pending(&resize));
+  RADIANT_EXPECT_FALSE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 800, .height = 600}, 1050 * MS));
+  RADIANT_EXPECT_EQ(resize.current.width, 640);
+
+  RADIANT_EXPECT_TRUE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 800, .height = 600}, 1100 * MS));
+  RADIANT_EXPECT_EQ(resize.current.width, 800);
+  RADIANT_EXPECT_EQ(resize.current.height, 600);
+  RADIANT_EXPECT_FALSE(radiant_resize_pending(&resize));
+
+  // Applied sizes are not applied again.
+  RADIANT_EXPECT_FALSE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 800, .height = 600}, 2000 * MS));
+  return true;
+}
+
+/// While the size keeps changing, as when dragging an edge, nothing is
+/// applied until the last size holds.
+static bool debounces_drags() {
+  radiant_resize_t resize = radiant_resize_create(kStart, 100.0);
+  uint32_t applied = 0;
+  radiant_time_t now = 0;
+  for (uint32_t width = 641; width < 700; ++width) {
+    now += 16 * MS;
+    if (radiant_resize_update(
+            &resize, (radiant_size_t){.width = width, .height = 480}, now)) {
+      ++applied;
+    }
+  }
+  RADIANT_EXPECT_EQ(applied, 0);
+  RADIANT_EXPECT_EQ(resize.current.width, 640);
+
+  now += 100 * MS;
+  RADIANT_EXPECT_TRUE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 699, .height = 480}, now));
+  RADIANT_EXPECT_EQ(resize.current.width, 699);
+
+  // Returning to the applied size before it settles cancels the change.
+  RADIANT_EXPECT_FALSE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 720, .height = 480}, now + MS));
+  RADIANT_EXPECT_FALSE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 699, .height = 480}, now + (2 * MS)));
+  RADIANT_EXPECT_FALSE(radiant_resize_pending(&resize));
+  return true;
+}
+
+/// A minimized window has no size to render at.
+static bool ignores_empty() {
+  radiant_resize_t resize = radiant_resize_create(kStart, 0.0);
+  RADIANT_EXPECT_TRUE(radiant_size_empty((radiant_size_t){.width = 640}));
+  RADIANT_EXPECT_FALSE(radiant_resize_update(
+      &resize, (radiant_size_t){.width = 0, .height = 0}, 1000 * MS));
+  RADIANT_EXPECT_TRUE(radiant_resize_pending(&resize));
+  RADIANT_EXPECT_EQ(resize.current.width, 640);
+
+  // Restored at the old size there is nothing to do.
+  RADIANT_EXPECT_FALSE(radiant_resize_update(&resize, kStart, 2000 * MS));
+  RADIANT_EXPECT_FALSE(radiant_resize_pending(&resize));
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("resize");
+  RADIANT_TEST(applies_once_settled);
+  RADIANT_TEST(debounces_drags);
+  RADIANT_TEST(ignores_empty);
+  return radiant_suite_end();
+}
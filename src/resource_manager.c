@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "src/profile.h"
+
 radiant_resource_manager_create_result_t radiant_resource_manager_create(
     const char* root_dir) {
   radiant_resource_manager_create_result_t result = {
@@ -55,3 +57,29 @@ radiant_file_result_t radiant_resource_manager_open(
 
   return file_result;
 }
+
+radiant_resource_read_result_t radiant_resource_manager_read(
+    radiant_resource_manager_t manager,
+    const char* relative_path) {
+  RADIANT_PROFILE_SCOPE("Read resource");
+  radiant_resource_read_result_t result = {0};
+  radiant_file_result_t file_result =
+      radiant_resource_manager_open(manager, relative_path);
+  if (!file_result.succeeded) {
+    return result;
+  }
+
+  radiant_file_t file = file_result.file;
+  uint64_t size = radiant_file_size(file);
+  char* data = (char*)malloc(size + 1);
+  if (data && radiant_file_read(file, data, size)) {
+    data[size] = '\0';
+    result.data = data;
+    result.size_in_bytes = size;
+    result.succeeded = true;
+  } else {
+    free(data);
+  }
+  radiant_file_close(file);
+  return result;
+}
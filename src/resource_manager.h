@@ -28,3 +28,22 @@ void radiant_resource_manager_destroy(radiant_resource_manager_t manager);
 radiant_file_result_t radiant_resource_manager_open(
     radiant_resource_manager_t manager,
     const char* relative_path);
+
+/// Result of reading a file
+typedef struct radiant_resource_read_result_t {
+  /// The file contents followed by a \0. The caller owns it and must free it.
+  /// Only valid if |succeeded| is true.
+  char* data;
+  /// The size of the file, not counting the \0
+  uint64_t size_in_bytes;
+  /// True if the whole file was read. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_resource_read_result_t;
+
+/// Reads the whole file at |relative_path| to the |manager.root_dir|. Safe to
+/// call from any thread.
+radiant_resource_read_result_t radiant_resource_manager_read(
+    radiant_resource_manager_t manager,
+    const char* relative_path);
@@ -0,0 +1,130 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/scene.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/assert.h"
+
+radiant_scene_create_result_t radiant_scene_create(uint32_t capacity) {
+  radiant_scene_create_result_t result = {0};
+  if (capacity == 0) {
+    return result;
+  }
+
+  radiant_scene_t scene = {
+      .parents = (uint32_t*)malloc(capacity * sizeof(uint32_t)),
+      .locals = (radiant_trs_t*)malloc(capacity * sizeof(radiant_trs_t)),
+      .worlds =
+          (radiant_affine_t*)malloc(capacity * sizeof(radiant_affine_t)),
+      .dirty = (uint8_t*)calloc(capacity, sizeof(uint8_t)),
+      .capacity = capacity,
+  };
+  if (!scene.parents || !scene.locals || !scene.worlds || !scene.dirty) {
+    radiant_scene_destroy(scene);
+    return result;
+  }
+
+  result.scene = scene;
+  result.succeeded = true;
+  return result;
+}
+
+void radiant_scene_destroy(radiant_scene_t scene) {
+  free(scene.dirty);
+  free(scene.worlds);
+  free(scene.locals);
+  free(scene.parents);
+}
+
+/// Marks |node| dirty.
+static void mark_dirty(radiant_scene_t* scene, uint32_t node) {
+  scene->dirty[node] = 1;
+  if (node < scene->first_dirty) {
+    scene->first_dirty = node;
+  }
+}
+
+uint32_t radiant_scene_add(radiant_scene_t* scene,
+                           uint32_t parent,
+                           radiant_trs_t local) {
+  RADIANT_ASSERT(parent == RADIANT_SCENE_NO_NODE || parent < scene->count);
+  if (scene->count == scene->capacity) {
+    return RADIANT_SCENE_NO_NODE;
+  }
+
+  uint32_t node = scene->count++;
+  scene->parents[node] = parent;
+  scene->locals[node] = local;
+  mark_dirty(scene, node);
+  return node;
+}
+
+void radiant_scene_set_local(radiant_scene_t* scene,
+                             uint32_t node,
+                             radiant_trs_t local) {
+  RADIANT_ASSERT(node < scene->count);
+  scene->locals[node] = local;
+  mark_dirty(scene, node);
+}
+
+radiant_trs_t radiant_scene_local(const radiant_scene_t* scene,
+                                  uint32_t node) {
+  RADIANT_ASSERT(node < scene->count);
+  return scene->locals[node];
+}
+
+radiant_affine_t radiant_scene_world(const radiant_scene_t* scene,
+                                     uint32_t node) {
+  RADIANT_ASSERT(node < scene->count);
+  RADIANT_ASSERT(!scene->dirty[node]);
+  return scene->worlds[node];
+}
+
+uint32_t radiant_scene_update(radiant_scene_t* scene) {
+  uint32_t first = scene->first_dirty;
+  if (first >= scene->count) {
+    return 0;
+  }
+
+  const uint32_t* parents = scene->parents;
+  uint8_t* dirty = scene->dirty;
+  // Parents come first, so one pass carries the flags down every subtree.
+  // Roots and nodes whose parent lies before |first| keep their own flag.
+  for (uint32_t i = first; i < scene->count; ++i) {
+    uint32_t parent = parents[i];
+    if (parent != RADIANT_SCENE_NO_NODE && parent >= first) {
+      dirty[i] |= dirty[parent];
+    }
+  }
+
+  uint32_t updated = 0;
+  for (uint32_t i = first; i < scene->count; ++i) {
+    if (!dirty[i]) {
+      continue;
+    }
+    radiant_affine_t local = radiant_trs_to_affine(scene->locals[i]);
+    uint32_t parent = parents[i];
+    scene->worlds[i] = parent == RADIANT_SCENE_NO_NODE
+                           ? local
+                           : radiant_affine_mul(scene->worlds[parent], local);
+    ++updated;
+  }
+
+  memset(dirty + first, 0, scene->count - first);
+  scene->first_dirty = scene->count;
+  return updated;
+}
@@ -0,0 +1,96 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/affine.h"
+#include "src/pad.h"
+#include "src/trs.h"
+
+/// The parent of root nodes, and the node returned when a scene is full.
+#define RADIANT_SCENE_NO_NODE UINT32_MAX
+
+/// A transform hierarchy. Nodes are stored as flat arrays in topological
+/// order, every parent before its children, so the world transforms are
+/// brought up to date in a single pass from the first changed node. Setting a
+/// local transform only marks the node dirty, the work happens in
+/// radiant_scene_update and skips everything before the first dirty node.
+typedef struct radiant_scene_t {
+  /// The parent of each node, RADIANT_SCENE_NO_NODE for roots. Always less
+  /// than the index of the node itself.
+  uint32_t* parents;
+  /// The transform of each node relative to its parent: scale, then
+  /// rotation, then translation
+  radiant_trs_t* locals;
+  /// The transform of each node relative to the world, valid once the scene
+  /// has been updated
+  radiant_affine_t* worlds;
+  /// Nonzero for nodes whose local transform changed since the last update
+  uint8_t* dirty;
+  /// The number of nodes
+  uint32_t count;
+  /// The most nodes the scene can hold
+  uint32_t capacity;
+  /// The lowest dirty node, |count| when nothing is dirty
+  uint32_t first_dirty;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_scene_t;
+
+/// Results of creating a scene
+typedef struct radiant_scene_create_result_t {
+  /// The scene. Only valid if |succeeded| is true.
+  radiant_scene_t scene;
+  /// True if the scene was successfully created. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_scene_create_result_t;
+
+/// Creates an empty scene with room for |capacity| nodes. Fails if
+/// |capacity| is zero or an allocation fails.
+radiant_scene_create_result_t radiant_scene_create(uint32_t capacity);
+
+/// Destroys |scene|.
+void radiant_scene_destroy(radiant_scene_t scene);
+
+/// Adds a node at |local| relative to |parent|, an existing node or
+/// RADIANT_SCENE_NO_NODE for a root. Returns the new node, or
+/// RADIANT_SCENE_NO_NODE if the scene is full. The node is dirty until the
+/// next update.
+uint32_t radiant_scene_add(radiant_scene_t* scene,
+                           uint32_t parent,
+                           radiant_trs_t local);
+
+/// Moves |node| to |local| relative to its parent. It and its descendants
+/// have new world transforms after the next update.
+void radiant_scene_set_local(radiant_scene_t* scene,
+                             uint32_t node,
+                             radiant_trs_t local);
+
+/// Returns the transform of |node| relative to its parent.
+radiant_trs_t radiant_scene_local(const radiant_scene_t* scene,
+                                  uint32_t node);
+
+/// Returns the world transform of |node| as of the last update.
+radiant_affine_t radiant_scene_world(const radiant_scene_t* scene,
+                                     uint32_t node);
+
+/// Recomputes the world transforms of the dirty nodes and their descendants
+/// and marks every node clean. Returns the number of world transforms that
+/// changed, zero, and no work, when nothing is dirty.
+uint32_t radiant_scene_update(radiant_scene_t* scene);
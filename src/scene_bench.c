@@ -0,0 +1,118 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Updates a scene where a small fraction of the nodes move each frame,
+// against recomputing every world transform, for each supported SIMD backend.
+
+#include <stdio.h>
+
+#include "src/bench.h"
+#include "src/scene.h"
+#include "src/simd.h"
+
+/// Nodes per level below the roots, a four level tree.
+#define FANOUT 16
+
+static const uint32_t kRoots = 25;
+static const uint32_t kIterations = 200;
+/// One in this many nodes moves each frame, about 5%.
+static const uint32_t kMoveStride = 20;
+
+typedef struct bench_data_t {
+  radiant_scene_t scene;
+  uint32_t frame;
+  /// Unused padding
+  RADIANT_PAD(4);
+} bench_data_t;
+
+static radiant_trs_t wobble(uint32_t node, uint32_t frame) {
+  radiant_trs_t t = radiant_trs_identity();
+  t.translation = (radiant_vec3_t){(float)(node % 7), (float)(frame % 5),
+                                   (float)(node % 3)};
+  return t;
+}
+
+static void add_children(radiant_scene_t* scene,
+                         uint32_t parent,
+                         uint32_t depth) {
+  for (uint32_t i = 0; depth > 0 && i < FANOUT; ++i) {
+    uint32_t child =
+        radiant_scene_add(scene, parent, wobble(scene->count, 0));
+    add_children(scene, child, depth - 1);
+  }
+}
+
+static void move_few(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  ++data->frame;
+  for (uint32_t i = data->frame % kMoveStride; i < data->scene.count;
+       i += kMoveStride) {
+    radiant_scene_set_local(&data->scene, i, wobble(i, data->frame));
+  }
+  radiant_scene_update(&data->scene);
+}
+
+static void move_none(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_scene_update(&data->scene);
+}
+
+static void move_all(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  ++data->frame;
+  for (uint32_t i = 0; i < data->scene.count; ++i) {
+    radiant_scene_set_local(&data->scene, i, wobble(i, data->frame));
+  }
+  radiant_scene_update(&data->scene);
+}
+
+int main() {
+  uint32_t capacity = kRoots * (1 + FANOUT + (FANOUT * FANOUT) +
+                                (FANOUT * FANOUT * FANOUT));
+  radiant_scene_create_result_t result = radiant_scene_create(capacity);
+  if (!result.succeeded) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+  bench_data_t data = {.scene = result.scene};
+  for (uint32_t i = 0; i < kRoots; ++i) {
+    uint32_t root = radiant_scene_add(&data.scene, RADIANT_SCENE_NO_NODE,
+                                      wobble(data.scene.count, 0));
+    add_children(&data.scene, root, 3);
+  }
+
+  printf("Updating %u nodes\n", data.scene.count);
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "none moved [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, move_none, &data, kIterations, data.scene.count);
+    snprintf(name, sizeof(name), "5%% moved [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, move_few, &data, kIterations, data.scene.count);
+    snprintf(name, sizeof(name), "all moved [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, move_all, &data, kIterations, data.scene.count);
+  }
+  radiant_simd_set_backend(original);
+
+  radiant_scene_destroy(data.scene);
+  return 0;
+}
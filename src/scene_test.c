@@ -0,0 +1,177 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/scene.h"
+
+#include "src/equal.h"
+#include "src/mat4x4.h"
+#include "src/test.h"
+
+static bool affine_equal(radiant_affine_t a, radiant_affine_t b) {
+  for (uint32_t i = 0; i < 12; ++i) {
+    if (!radiant_equal(a.data[i], b.data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static radiant_trs_t transform_a(void) {
+  return (radiant_trs_t){
+      .translation = {1.f, -2.f, 3.f},
+      .rotation =
+          radiant_quat_from_euler((radiant_point3_t){0.3f, 1.1f, -0.4f}),
+      .scale = {2.f, 0.5f, 1.5f},
+  };
+}
+
+static radiant_trs_t translation(float x, float y, float z) {
+  radiant_trs_t t = radiant_trs_identity();
+  t.translation = (radiant_vec3_t){x, y, z};
+  return t;
+}
+
+static bool trs_to_affine() {
+  RADIANT_EXPECT_TRUE(
+      affine_equal(radiant_trs_to_affine(radiant_trs_identity()),
+                   radiant_affine_identity()));
+
+  radiant_trs_t t = transform_a();
+  radiant_mat4x4_t expected = radiant_mat4x4_mul(
+      radiant_mat4x4_translate(t.translation),
+      radiant_mat4x4_mul(radiant_quat_to_mat4x4(t.rotation),
+                         radiant_mat4x4_scale(t.scale.x, t.scale.y,
+                                              t.scale.z)));
+  RADIANT_EXPECT_TRUE(affine_equal(radiant_trs_to_affine(t),
+                                   radiant_affine_from_mat4x4(expected)));
+  return true;
+}
+
+static bool create() {
+  RADIANT_EXPECT_FALSE(radiant_scene_create(0).succeeded);
+
+  radiant_scene_create_result_t result = radiant_scene_create(2);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_scene_t scene = result.scene;
+  RADIANT_EXPECT_EQ(scene.count, 0u);
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 0u);
+
+  RADIANT_EXPECT_EQ(radiant_scene_add(&scene, RADIANT_SCENE_NO_NODE,
+                                      radiant_trs_identity()),
+                    0u);
+  RADIANT_EXPECT_EQ(
+      radiant_scene_add(&scene, 0, radiant_trs_identity()), 1u);
+  RADIANT_EXPECT_EQ(
+      radiant_scene_add(&scene, 0, radiant_trs_identity()),
+      RADIANT_SCENE_NO_NODE);
+  RADIANT_EXPECT_EQ(scene.count, 2u);
+  radiant_scene_destroy(scene);
+  return true;
+}
+
+static bool hierarchy() {
+  radiant_scene_t scene = radiant_scene_create(4).scene;
+  uint32_t root =
+      radiant_scene_add(&scene, RADIANT_SCENE_NO_NODE, transform_a());
+  uint32_t child = radiant_scene_add(&scene, root, translation(0.f, 1.f, 0.f));
+  uint32_t grandchild =
+      radiant_scene_add(&scene, child, translation(2.f, 0.f, 0.f));
+  uint32_t other =
+      radiant_scene_add(&scene, RADIANT_SCENE_NO_NODE, translation(5.f, 0.f,
+                                                                   0.f));
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 4u);
+
+  radiant_affine_t a = radiant_trs_to_affine(transform_a());
+  radiant_affine_t expected_child = radiant_affine_mul(
+      a, radiant_trs_to_affine(translation(0.f, 1.f, 0.f)));
+  radiant_affine_t expected_grandchild = radiant_affine_mul(
+      expected_child, radiant_trs_to_affine(translation(2.f, 0.f, 0.f)));
+  RADIANT_EXPECT_TRUE(affine_equal(radiant_scene_world(&scene, root), a));
+  RADIANT_EXPECT_TRUE(
+      affine_equal(radiant_scene_world(&scene, child), expected_child));
+  RADIANT_EXPECT_TRUE(affine_equal(radiant_scene_world(&scene, grandchild),
+                                   expected_grandchild));
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, other).data[3], 5.f);
+  radiant_scene_destroy(scene);
+  return true;
+}
+
+static bool dirty_subtree() {
+  radiant_scene_t scene = radiant_scene_create(5).scene;
+  uint32_t root = radiant_scene_add(&scene, RADIANT_SCENE_NO_NODE,
+                                    radiant_trs_identity());
+  uint32_t left = radiant_scene_add(&scene, root, translation(1.f, 0.f, 0.f));
+  uint32_t right =
+      radiant_scene_add(&scene, root, translation(-1.f, 0.f, 0.f));
+  uint32_t left_leaf =
+      radiant_scene_add(&scene, left, translation(0.f, 1.f, 0.f));
+  uint32_t right_leaf =
+      radiant_scene_add(&scene, right, translation(0.f, 1.f, 0.f));
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 5u);
+
+  // Nothing changed, nothing is recomputed.
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 0u);
+  RADIANT_EXPECT_EQ(scene.first_dirty, scene.count);
+
+  // Moving a subtree only touches it, not its sibling.
+  radiant_scene_set_local(&scene, left, translation(3.f, 0.f, 0.f));
+  RADIANT_EXPECT_EQ(scene.first_dirty, left);
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 2u);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, left_leaf).data[3], 3.f);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, left_leaf).data[7], 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, right_leaf).data[3],
+                          -1.f);
+
+  // Moving the root moves everything.
+  radiant_scene_set_local(&scene, root, translation(0.f, 0.f, 2.f));
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 5u);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, right_leaf).data[11],
+                          2.f);
+
+  // Setting a leaf and then its parent counts each node once.
+  radiant_scene_set_local(&scene, right_leaf, translation(0.f, 4.f, 0.f));
+  radiant_scene_set_local(&scene, right, translation(-2.f, 0.f, 0.f));
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 2u);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, right_leaf).data[3],
+                          -2.f);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, right_leaf).data[7],
+                          4.f);
+  RADIANT_EXPECT_FLOAT_EQ(
+      radiant_scene_local(&scene, right_leaf).translation.y, 4.f);
+  radiant_scene_destroy(scene);
+  return true;
+}
+
+static bool add_after_update() {
+  radiant_scene_t scene = radiant_scene_create(3).scene;
+  uint32_t root = radiant_scene_add(&scene, RADIANT_SCENE_NO_NODE,
+                                    translation(1.f, 0.f, 0.f));
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 1u);
+
+  uint32_t child = radiant_scene_add(&scene, root, translation(1.f, 0.f, 0.f));
+  RADIANT_EXPECT_EQ(radiant_scene_update(&scene), 1u);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_scene_world(&scene, child).data[3], 2.f);
+  radiant_scene_destroy(scene);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("scene");
+  RADIANT_TEST(trs_to_affine);
+  RADIANT_TEST(create);
+  RADIANT_TEST_ALL_BACKENDS(hierarchy);
+  RADIANT_TEST(dirty_subtree);
+  RADIANT_TEST(add_after_update);
+  return radiant_suite_end();
+}
@@ -3,9 +3,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "src/profile.h"
+
 radiant_shader_t radiant_shader_create(radiant_engine_t engine,
                                        const char* label,
                                        const char* data) {
+  RADIANT_PROFILE_SCOPE("Create shader");
   WGPUShaderModuleWGSLDescriptor wgsl_desc = {
       .chain =
           {
@@ -32,34 +35,22 @@ radiant_shader_create_result_t radiant_shader_create_from_file(
     radiant_resource_manager_t manager,
     const char* label,
     const char* path) {
+  RADIANT_PROFILE_SCOPE("Load shader");
   radiant_shader_create_result_t result = {
       .shader = {0},
       .succeeded = true,
   };
 
-  radiant_file_result_t shader_file_result =
-      radiant_resource_manager_open(manager, path);
-  if (!shader_file_result.succeeded) {
+  radiant_resource_read_result_t read_result =
+      radiant_resource_manager_read(manager, path);
+  if (!read_result.succeeded) {
     fprintf(stderr, "Unable to load %s shader", path);
     result.succeeded = false;
     return result;
   }
 
-  radiant_file_t shader_file = shader_file_result.file;
-  uint64_t shader_file_size = radiant_file_size(shader_file);
-
-  char* shader_data = (char*)malloc((uint32_t)shader_file_size);
-  if (!radiant_file_read(shader_file, shader_data, shader_file_size)) {
-    fprintf(stderr, "Failed to read %s shader", path);
-    result.succeeded = false;
-    goto cleanup;
-  }
-
-  result.shader = radiant_shader_create(engine, label, shader_data);
-
-cleanup:
-  radiant_file_close(shader_file);
-  free(shader_data);
+  result.shader = radiant_shader_create(engine, label, read_result.data);
+  free(read_result.data);
 
   return result;
 }
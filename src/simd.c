@@ -0,0 +1,127 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/simd.h"
+
+#include <pthread.h>
+
+#include "src/array_element_count.h"
+
+static radiant_simd_ops_t ops;
+static radiant_simd_backend_t current_backend = radiant_simd_backend_scalar;
+/// Selects the backend on first use, which may be on any thread.
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+bool radiant_simd_backend_supported(radiant_simd_backend_t backend) {
+  switch (backend) {
+    case radiant_simd_backend_scalar:
+      return true;
+    case radiant_simd_backend_sse:
+#if defined(RADIANT_SIMD_X86)
+      return true;
+#else
+      return false;
+#endif
+    case radiant_simd_backend_avx2:
+#if defined(RADIANT_SIMD_X86)
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+             __builtin_cpu_supports("f16c");
+#else
+      return false;
+#endif
+    case radiant_simd_backend_neon:
+#if defined(RADIANT_SIMD_NEON)
+      return true;
+#else
+      return false;
+#endif
+    case radiant_simd_backend_count:
+      break;
+  }
+  return false;
+}
+
+static void install(radiant_simd_backend_t backend) {
+  radiant_simd_install_scalar(&ops);
+
+#if defined(RADIANT_SIMD_X86)
+  if (backend == radiant_simd_backend_sse ||
+      backend == radiant_simd_backend_avx2) {
+    radiant_simd_install_sse(&ops);
+  }
+  if (backend == radiant_simd_backend_avx2) {
+    radiant_simd_install_avx2(&ops);
+  }
+#endif
+#if defined(RADIANT_SIMD_NEON)
+  if (backend == radiant_simd_backend_neon) {
+    radiant_simd_install_neon(&ops);
+  }
+#endif
+
+  current_backend = backend;
+}
+
+static void initialize(void) {
+  static const radiant_simd_backend_t preferred[] = {
+      radiant_simd_backend_avx2,
+      radiant_simd_backend_sse,
+      radiant_simd_backend_neon,
+  };
+
+  for (uint32_t i = 0; i < RADIANT_ARRAY_ELEMENT_COUNT(preferred); ++i) {
+    if (radiant_simd_backend_supported(preferred[i])) {
+      install(preferred[i]);
+      return;
+    }
+  }
+  install(radiant_simd_backend_scalar);
+}
+
+radiant_simd_backend_t radiant_simd_backend(void) {
+  pthread_once(&init_once, initialize);
+  return current_backend;
+}
+
+bool radiant_simd_set_backend(radiant_simd_backend_t backend) {
+  if (!radiant_simd_backend_supported(backend)) {
+    return false;
+  }
+  // Keeps a later first use from replacing |backend|.
+  pthread_once(&init_once, initialize);
+  install(backend);
+  return true;
+}
+
+const char* radiant_simd_backend_name(radiant_simd_backend_t backend) {
+  switch (backend) {
+    case radiant_simd_backend_scalar:
+      return "scalar";
+    case radiant_simd_backend_sse:
+      return "sse";
+    case radiant_simd_backend_avx2:
+      return "avx2";
+    case radiant_simd_backend_neon:
+      return "neon";
+    case radiant_simd_backend_count:
+      break;
+  }
+  return "unknown";
+}
+
+const radiant_simd_ops_t* radiant_simd_ops(void) {
+  pthread_once(&init_once, initialize);
+  return &ops;
+}
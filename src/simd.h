@@ -0,0 +1,252 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "src/affine.h"
+#include "src/angle.h"
+#include "src/bounds.h"
+#include "src/frustum.h"
+#include "src/mat3x3.h"
+#include "src/mat4x4.h"
+#include "src/pack.h"
+#include "src/quat.h"
+#include "src/ray.h"
+#include "src/soa.h"
+#include "src/vec4.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+/// Set when the SSE and AVX2 backends are compiled in.
+#define RADIANT_SIMD_X86 1
+#elif defined(__aarch64__)
+/// Set when the NEON backend is compiled in.
+#define RADIANT_SIMD_NEON 1
+#endif
+
+/// The instruction sets the math kernels can be executed with.
+typedef enum radiant_simd_backend_t {
+  /// Plain C. Always available and used as the reference implementation.
+  radiant_simd_backend_scalar,
+  /// SSE2, the x86-64 baseline.
+  radiant_simd_backend_sse,
+  /// AVX2 with FMA and F16C.
+  radiant_simd_backend_avx2,
+  /// AArch64 NEON.
+  radiant_simd_backend_neon,
+
+  /// Number of backends
+  radiant_simd_backend_count,
+} radiant_simd_backend_t;
+
+/// @private
+/// Constants shared by the radiant_sincos implementations. pi / 2 is split so
+/// |q| * RADIANT_SINCOS_PI_BY_2_HI is exact for every q below
+/// RADIANT_SINCOS_MAX_FAST * 2 / pi. The polynomials are minimax fits of sin
+/// and cos over [-pi/4, pi/4] (from Cephes).
+#define RADIANT_SINCOS_2_BY_PI 0.636619772f
+#define RADIANT_SINCOS_PI_BY_2_HI 1.5703125f
+#define RADIANT_SINCOS_PI_BY_2_MID 4.837512969970703125e-4f
+#define RADIANT_SINCOS_PI_BY_2_LO 7.54978995489188216e-8f
+#define RADIANT_SINCOS_S1 -1.6666654611e-1f
+#define RADIANT_SINCOS_S2 8.3321608736e-3f
+#define RADIANT_SINCOS_S3 -1.9515295891e-4f
+#define RADIANT_SINCOS_C1 4.166664568298827e-2f
+#define RADIANT_SINCOS_C2 -1.388731625493765e-3f
+#define RADIANT_SINCOS_C3 2.443315711809948e-5f
+
+/// @private
+/// Constants shared by the radiant_pack_f16 implementations, as float bit
+/// patterns. Floats from RADIANT_PACK_F16_MAX up round to infinity, below
+/// RADIANT_PACK_F16_MIN_NORMAL they become subnormal halves. Adding
+/// RADIANT_PACK_F16_SUBNORMAL, 0.5, rounds a subnormal into the low mantissa
+/// bits. RADIANT_PACK_F16_NORMAL_BIAS rebiases the exponent and adds the
+/// rounding bias for the 13 dropped mantissa bits.
+#define RADIANT_PACK_F16_MAX 0x47800000u
+#define RADIANT_PACK_F16_MIN_NORMAL 0x38800000u
+#define RADIANT_PACK_F16_SUBNORMAL 0x3f000000u
+#define RADIANT_PACK_F16_NORMAL_BIAS 0xc8000fffu
+
+/// Table of math kernels for a backend. Output pointers may alias the inputs.
+typedef struct radiant_simd_ops_t {
+  /// Stores |a| * |b| into |out|.
+  void (*mat4x4_mul)(radiant_mat4x4_t* out,
+                     const radiant_mat4x4_t* a,
+                     const radiant_mat4x4_t* b);
+  /// Stores |m| * |v| into |out|.
+  void (*mat4x4_mul_vec4)(radiant_vec4_t* out,
+                          const radiant_mat4x4_t* m,
+                          const radiant_vec4_t* v);
+  /// Stores the transpose of |m| into |out|.
+  void (*mat4x4_transpose)(radiant_mat4x4_t* out, const radiant_mat4x4_t* m);
+  /// Stores the inverse of |m| into |out| and returns true. Returns false,
+  /// leaving |out| untouched, if |m| is singular.
+  bool (*mat4x4_inverse)(radiant_mat4x4_t* out, const radiant_mat4x4_t* m);
+  /// Stores |a| * |b|[i] into |out|[i] for |count| matrices. |out| must be 16
+  /// byte aligned.
+  void (*mat4x4_mul_batch)(radiant_mat4x4_t* out,
+                           const radiant_mat4x4_t* a,
+                           const radiant_mat4x4_t* b,
+                           uint32_t count);
+
+  /// Stores the normal matrix of |m|[i] into |out|[i] for |count| matrices.
+  /// See radiant_mat3x3_normal_matrix.
+  void (*normal_matrix_batch)(radiant_mat3x3_t* out,
+                              const radiant_mat4x4_t* m,
+                              uint32_t count);
+
+  /// Stores |a| * |b| into |out|.
+  void (*affine_mul)(radiant_affine_t* out,
+                     const radiant_affine_t* a,
+                     const radiant_affine_t* b);
+
+  /// Returns the dot product of |a| and |b|.
+  float (*vec4_dot)(const radiant_vec4_t* a, const radiant_vec4_t* b);
+  /// Stores a normalized copy of |a| into |out|.
+  void (*vec4_normalize)(radiant_vec4_t* out, const radiant_vec4_t* a);
+
+  /// Stores radiant_quat_nlerp(|a|[i], |b|[i], |t|) into |out|[i] for |count|
+  /// quaternions.
+  void (*quat_nlerp_batch)(radiant_quat_t* out,
+                           const radiant_quat_t* a,
+                           const radiant_quat_t* b,
+                           float t,
+                           uint32_t count);
+
+  /// See radiant_sincos_batch.
+  void (*sincos_batch)(float* sin_out,
+                       float* cos_out,
+                       const float* radians,
+                       uint32_t count);
+
+  /// See radiant_pack_f16_batch.
+  void (*pack_f16_batch)(uint16_t* out, const float* in, uint32_t count);
+  /// See radiant_pack_unorm8_batch.
+  void (*pack_unorm8_batch)(uint8_t* out, const float* in, uint32_t count);
+  /// See radiant_pack_snorm16_batch.
+  void (*pack_snorm16_batch)(int16_t* out, const float* in, uint32_t count);
+  /// See radiant_pack_octahedral_batch.
+  void (*pack_octahedral_batch)(uint32_t* out,
+                                const radiant_vec3_soa_t* normals);
+
+  /// See radiant_point3_soa_transform.
+  void (*point3_soa_transform)(const radiant_mat4x4_t* m,
+                               const radiant_point3_soa_t* in,
+                               const radiant_point3_soa_t* out);
+  /// See radiant_point3_soa_transform_affine.
+  void (*point3_soa_transform_affine)(const radiant_mat4x4_t* m,
+                                      const radiant_point3_soa_t* in,
+                                      const radiant_point3_soa_t* out);
+  /// See radiant_point3_soa_lerp.
+  void (*point3_soa_lerp)(const radiant_point3_soa_t* a,
+                          const radiant_point3_soa_t* b,
+                          float t,
+                          const radiant_point3_soa_t* out);
+  /// See radiant_vec3_soa_transform.
+  void (*vec3_soa_transform)(const radiant_mat4x4_t* m,
+                             const radiant_vec3_soa_t* in,
+                             const radiant_vec3_soa_t* out);
+  /// See radiant_vec3_soa_normalize.
+  void (*vec3_soa_normalize)(const radiant_vec3_soa_t* in,
+                             const radiant_vec3_soa_t* out);
+  /// See radiant_vec3_soa_dot.
+  void (*vec3_soa_dot)(const radiant_vec3_soa_t* a,
+                       const radiant_vec3_soa_t* b,
+                       float* out);
+  /// See radiant_vec3_soa_cross.
+  void (*vec3_soa_cross)(const radiant_vec3_soa_t* a,
+                         const radiant_vec3_soa_t* b,
+                         const radiant_vec3_soa_t* out);
+
+  /// See radiant_frustum_cull_aabbs.
+  uint32_t (*frustum_cull_aabbs)(const radiant_frustum_t* frustum,
+                                 const radiant_aabb_soa_t* boxes,
+                                 uint32_t begin,
+                                 uint32_t end,
+                                 uint32_t* visible);
+
+  /// See radiant_ray_intersect_triangles.
+  radiant_ray_triangle_hit_t (*ray_intersect_triangles)(
+      const radiant_ray_t* ray,
+      const radiant_triangle_soa_t* triangles,
+      uint32_t begin,
+      uint32_t end);
+  /// See radiant_ray_soa_intersect_aabb.
+  void (*ray_soa_intersect_aabb)(float* t_out,
+                                 const radiant_ray_soa_t* rays,
+                                 const radiant_aabb_t* box,
+                                 float t_max);
+  /// Intersects |ray| with |width| boxes, a multiple of 4 up to 8, stored as
+  /// structure-of-arrays at |bounds|: |width| minimum x, then the minimum y,
+  /// minimum z, maximum x, maximum y and maximum z. |inv| is
+  /// radiant_ray_inv_direction of the ray. Stores where the ray enters each
+  /// box into |t_out| and returns a mask with bit i set if box i is hit.
+  uint32_t (*ray_intersect_aabbs)(float* t_out,
+                                  const radiant_ray_t* ray,
+                                  const radiant_vec3_t* inv,
+                                  const float* bounds,
+                                  uint32_t width);
+} radiant_simd_ops_t;
+
+/// Returns true if |backend| is compiled in and supported by the CPU.
+bool radiant_simd_backend_supported(radiant_simd_backend_t backend);
+
+/// Returns the backend currently in use. The fastest supported backend is
+/// selected on first use.
+radiant_simd_backend_t radiant_simd_backend(void);
+
+/// Switches the math kernels to |backend|. Returns false, leaving the current
+/// backend in place, if |backend| is not supported.
+///
+/// Note: not thread safe, select the backend before starting worker threads.
+bool radiant_simd_set_backend(radiant_simd_backend_t backend);
+
+/// Returns a printable name for |backend|.
+const char* radiant_simd_backend_name(radiant_simd_backend_t backend);
+
+/// Returns the kernels for the current backend.
+const radiant_simd_ops_t* radiant_simd_ops(void);
+
+/// @private
+/// Returns the scalar kernels. The SIMD backends use these for the elements
+/// left over after their last full vector.
+const radiant_simd_ops_t* radiant_simd_scalar_ops(void);
+
+/// @private
+/// Reduces the per lane closest hits of a SIMD ray_intersect_triangles kernel,
+/// |lanes| wide, and the |tail| hit from the scalar kernel to the closest hit.
+/// Ties go to the lowest index. Lanes with an infinite |t| were not hit.
+radiant_ray_triangle_hit_t radiant_simd_closest_hit(
+    const float* t,
+    const float* u,
+    const float* v,
+    const uint32_t* index,
+    uint32_t lanes,
+    radiant_ray_triangle_hit_t tail);
+
+/// @private
+/// Each backend overrides the entries of |ops| it accelerates. Backends are
+/// layered, scalar first, so a backend only provides what it improves on.
+void radiant_simd_install_scalar(radiant_simd_ops_t* ops);
+#if defined(RADIANT_SIMD_X86)
+/// @private
+void radiant_simd_install_sse(radiant_simd_ops_t* ops);
+/// @private
+void radiant_simd_install_avx2(radiant_simd_ops_t* ops);
+#endif
+#if defined(RADIANT_SIMD_NEON)
+/// @private
+void radiant_simd_install_neon(radiant_simd_ops_t* ops);
+#endif
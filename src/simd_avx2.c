@@ -0,0 +1,751 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// AVX2 + FMA + F16C kernels. This file is compiled with -mavx2 -mfma -mf16c and
+// must only be called after radiant_simd_backend_supported() confirmed the
+// CPU has them.
+// Kernels that don't benefit from 256-bit registers are left to the SSE
+// backend which is installed underneath this one.
+
+#include "src/simd.h"
+
+#include <immintrin.h>
+#include <math.h>
+
+/// Loads 4 floats from |p| into both 128-bit halves.
+static __m256 load_dup(const float* p) {
+  __m128 v = _mm_loadu_ps(p);
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+}
+
+/// Returns |v| with lane |i| of each 128-bit half copied across that half.
+#define SPLAT(v, i) _mm256_shuffle_ps((v), (v), _MM_SHUFFLE(i, i, i, i))
+
+static void mat4x4_mul(radiant_mat4x4_t* out,
+                       const radiant_mat4x4_t* a,
+                       const radiant_mat4x4_t* b) {
+  __m256 a0 = load_dup(&a->data[0]);
+  __m256 a1 = load_dup(&a->data[4]);
+  __m256 a2 = load_dup(&a->data[8]);
+  __m256 a3 = load_dup(&a->data[12]);
+
+  // Two result columns per register: the low half computes column j, the
+  // high half column j + 1.
+  __m256 b01 = _mm256_loadu_ps(&b->data[0]);
+  __m256 b23 = _mm256_loadu_ps(&b->data[8]);
+
+  __m256 r01 = _mm256_mul_ps(a0, SPLAT(b01, 0));
+  r01 = _mm256_fmadd_ps(a1, SPLAT(b01, 1), r01);
+  r01 = _mm256_fmadd_ps(a2, SPLAT(b01, 2), r01);
+  r01 = _mm256_fmadd_ps(a3, SPLAT(b01, 3), r01);
+
+  __m256 r23 = _mm256_mul_ps(a0, SPLAT(b23, 0));
+  r23 = _mm256_fmadd_ps(a1, SPLAT(b23, 1), r23);
+  r23 = _mm256_fmadd_ps(a2, SPLAT(b23, 2), r23);
+  r23 = _mm256_fmadd_ps(a3, SPLAT(b23, 3), r23);
+
+  _mm256_storeu_ps(&out->data[0], r01);
+  _mm256_storeu_ps(&out->data[8], r23);
+}
+
+static void mat4x4_mul_batch(radiant_mat4x4_t* out,
+                             const radiant_mat4x4_t* a,
+                             const radiant_mat4x4_t* b,
+                             uint32_t count) {
+  // |a| stays in registers across the whole batch.
+  __m256 a0 = load_dup(&a->data[0]);
+  __m256 a1 = load_dup(&a->data[4]);
+  __m256 a2 = load_dup(&a->data[8]);
+  __m256 a3 = load_dup(&a->data[12]);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    __m256 b01 = _mm256_loadu_ps(&b[i].data[0]);
+    __m256 b23 = _mm256_loadu_ps(&b[i].data[8]);
+
+    __m256 r01 = _mm256_mul_ps(a0, SPLAT(b01, 0));
+    r01 = _mm256_fmadd_ps(a1, SPLAT(b01, 1), r01);
+    r01 = _mm256_fmadd_ps(a2, SPLAT(b01, 2), r01);
+    r01 = _mm256_fmadd_ps(a3, SPLAT(b01, 3), r01);
+
+    __m256 r23 = _mm256_mul_ps(a0, SPLAT(b23, 0));
+    r23 = _mm256_fmadd_ps(a1, SPLAT(b23, 1), r23);
+    r23 = _mm256_fmadd_ps(a2, SPLAT(b23, 2), r23);
+    r23 = _mm256_fmadd_ps(a3, SPLAT(b23, 3), r23);
+
+    // |out| is only guaranteed 16 byte aligned, so store by halves.
+    _mm_store_ps(&out[i].data[0], _mm256_castps256_ps128(r01));
+    _mm_store_ps(&out[i].data[4], _mm256_extractf128_ps(r01, 1));
+    _mm_store_ps(&out[i].data[8], _mm256_castps256_ps128(r23));
+    _mm_store_ps(&out[i].data[12], _mm256_extractf128_ps(r23, 1));
+  }
+}
+
+static void mat4x4_mul_vec4(radiant_vec4_t* out,
+                            const radiant_mat4x4_t* m,
+                            const radiant_vec4_t* v) {
+  __m128 p = _mm_loadu_ps(&v->x);
+  __m128 r = _mm_mul_ps(_mm_loadu_ps(&m->data[0]), _mm_broadcastss_ps(p));
+  r = _mm_fmadd_ps(_mm_loadu_ps(&m->data[4]),
+                   _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), r);
+  r = _mm_fmadd_ps(_mm_loadu_ps(&m->data[8]),
+                   _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), r);
+  r = _mm_fmadd_ps(_mm_loadu_ps(&m->data[12]),
+                   _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)), r);
+  _mm_storeu_ps(&out->x, r);
+}
+
+static void affine_mul(radiant_affine_t* out,
+                       const radiant_affine_t* a,
+                       const radiant_affine_t* b) {
+  __m128 b0 = _mm_loadu_ps(&b->data[0]);
+  __m128 b1 = _mm_loadu_ps(&b->data[4]);
+  __m128 b2 = _mm_loadu_ps(&b->data[8]);
+  // The implicit bottom row of |b|.
+  __m128 b3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+  __m128 r[3];
+  for (uint32_t i = 0; i < 3; ++i) {
+    const float* ai = &a->data[i * 4];
+    r[i] = _mm_mul_ps(_mm_broadcast_ss(&ai[3]), b3);
+    r[i] = _mm_fmadd_ps(_mm_broadcast_ss(&ai[2]), b2, r[i]);
+    r[i] = _mm_fmadd_ps(_mm_broadcast_ss(&ai[1]), b1, r[i]);
+    r[i] = _mm_fmadd_ps(_mm_broadcast_ss(&ai[0]), b0, r[i]);
+  }
+  _mm_storeu_ps(&out->data[0], r[0]);
+  _mm_storeu_ps(&out->data[4], r[1]);
+  _mm_storeu_ps(&out->data[8], r[2]);
+}
+
+/// Transposes the 4x4 block in each 128-bit half of |r0| to |r3|.
+static void transpose4x2(__m256* r0, __m256* r1, __m256* r2, __m256* r3) {
+  __m256 t0 = _mm256_unpacklo_ps(*r0, *r1);
+  __m256 t1 = _mm256_unpacklo_ps(*r2, *r3);
+  __m256 t2 = _mm256_unpackhi_ps(*r0, *r1);
+  __m256 t3 = _mm256_unpackhi_ps(*r2, *r3);
+  *r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+  *r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+  *r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  *r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+/// Loads quaternion |q|[k] into the low half and |q|[k + 4] into the high
+/// half of a register, for k in 0..3, transposed to one component per
+/// register.
+static void load_quat8(const radiant_quat_t* q, __m256 r[4]) {
+  for (uint32_t k = 0; k < 4; ++k) {
+    r[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&q[k].x)),
+                                _mm_loadu_ps(&q[k + 4].x), 1);
+  }
+  transpose4x2(&r[0], &r[1], &r[2], &r[3]);
+}
+
+static void quat_nlerp_batch(radiant_quat_t* out,
+                             const radiant_quat_t* a,
+                             const radiant_quat_t* b,
+                             float t,
+                             uint32_t count) {
+  __m256 vt = _mm256_set1_ps(t);
+  __m256 at = _mm256_set1_ps(1.0f - t);
+  __m256 sign_bit = _mm256_set1_ps(-0.0f);
+
+  uint32_t n = count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 qa[4];
+    __m256 qb[4];
+    load_quat8(a + i, qa);
+    load_quat8(b + i, qb);
+
+    __m256 d = _mm256_mul_ps(qa[3], qb[3]);
+    d = _mm256_fmadd_ps(qa[2], qb[2], d);
+    d = _mm256_fmadd_ps(qa[1], qb[1], d);
+    d = _mm256_fmadd_ps(qa[0], qb[0], d);
+    // Negate t where the dot product is negative to take the short way.
+    __m256 bt = _mm256_xor_ps(vt, _mm256_and_ps(d, sign_bit));
+
+    __m256 r[4];
+    for (uint32_t k = 0; k < 4; ++k) {
+      r[k] = _mm256_fmadd_ps(at, qa[k], _mm256_mul_ps(bt, qb[k]));
+    }
+
+    __m256 len2 = _mm256_mul_ps(r[3], r[3]);
+    len2 = _mm256_fmadd_ps(r[2], r[2], len2);
+    len2 = _mm256_fmadd_ps(r[1], r[1], len2);
+    len2 = _mm256_fmadd_ps(r[0], r[0], len2);
+    __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len2));
+    for (uint32_t k = 0; k < 4; ++k) {
+      r[k] = _mm256_mul_ps(r[k], inv);
+    }
+
+    transpose4x2(&r[0], &r[1], &r[2], &r[3]);
+    for (uint32_t k = 0; k < 4; ++k) {
+      _mm_storeu_ps(&out[i + k].x, _mm256_castps256_ps128(r[k]));
+      _mm_storeu_ps(&out[i + k + 4].x, _mm256_extractf128_ps(r[k], 1));
+    }
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->quat_nlerp_batch(out + n, a + n, b + n, t,
+                                                count - n);
+  }
+}
+
+/// Returns row |row| of |d| * (|x|, |y|, |z|, |w|) for 8 vectors at once.
+static __m256 transform_row(const float* d,
+                            uint32_t row,
+                            __m256 x,
+                            __m256 y,
+                            __m256 z,
+                            __m256 w) {
+  __m256 r = _mm256_mul_ps(_mm256_set1_ps(d[row + 12]), w);
+  r = _mm256_fmadd_ps(_mm256_set1_ps(d[row + 8]), z, r);
+  r = _mm256_fmadd_ps(_mm256_set1_ps(d[row + 4]), y, r);
+  return _mm256_fmadd_ps(_mm256_set1_ps(d[row + 0]), x, r);
+}
+
+static void sincos_batch(float* sin_out,
+                         float* cos_out,
+                         const float* radians,
+                         uint32_t count) {
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i two = _mm256_set1_epi32(2);
+  uint32_t n = count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 x = _mm256_loadu_ps(radians + i);
+    // Large and non-finite angles take the exact libm reduction.
+    __m256 slow = _mm256_cmp_ps(_mm256_and_ps(x, abs_mask),
+                                _mm256_set1_ps(RADIANT_SINCOS_MAX_FAST),
+                                _CMP_NLE_UQ);
+    if (_mm256_movemask_ps(slow)) {
+      radiant_simd_scalar_ops()->sincos_batch(sin_out + i, cos_out + i,
+                                              radians + i, 8);
+      continue;
+    }
+
+    __m256i q = _mm256_cvtps_epi32(
+        _mm256_mul_ps(x, _mm256_set1_ps(RADIANT_SINCOS_2_BY_PI)));
+    __m256 j = _mm256_cvtepi32_ps(q);
+    __m256 r =
+        _mm256_fnmadd_ps(j, _mm256_set1_ps(RADIANT_SINCOS_PI_BY_2_HI), x);
+    r = _mm256_fnmadd_ps(j, _mm256_set1_ps(RADIANT_SINCOS_PI_BY_2_MID), r);
+    r = _mm256_fnmadd_ps(j, _mm256_set1_ps(RADIANT_SINCOS_PI_BY_2_LO), r);
+
+    __m256 r2 = _mm256_mul_ps(r, r);
+    __m256 s = _mm256_set1_ps(RADIANT_SINCOS_S3);
+    s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(RADIANT_SINCOS_S2));
+    s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(RADIANT_SINCOS_S1));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, r2), r, r);
+    __m256 c = _mm256_set1_ps(RADIANT_SINCOS_C3);
+    c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(RADIANT_SINCOS_C2));
+    c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(RADIANT_SINCOS_C1));
+    c = _mm256_fmadd_ps(_mm256_mul_ps(c, r2), r2,
+                        _mm256_fnmadd_ps(_mm256_set1_ps(.5f), r2,
+                                         _mm256_set1_ps(1.f)));
+
+    // Odd quadrants swap sin and cos, the signs follow bit 1 of q and q + 1.
+    __m256 swap = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256 sin_sign =
+        _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+    _mm256_storeu_ps(sin_out + i,
+                     _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sin_sign));
+    _mm256_storeu_ps(cos_out + i,
+                     _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cos_sign));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->sincos_batch(sin_out + n, cos_out + n,
+                                            radians + n, count - n);
+  }
+}
+
+static void pack_f16_batch(uint16_t* out, const float* in, uint32_t count) {
+  uint32_t n = count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128((void*)(out + i), h);
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_f16_batch(out + n, in + n, count - n);
+  }
+}
+
+static void point3_soa_transform(const radiant_mat4x4_t* m,
+                                 const radiant_point3_soa_t* in,
+                                 const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  __m256 one = _mm256_set1_ps(1.0f);
+
+  uint32_t n = in->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 px = _mm256_loadu_ps(in->x + i);
+    __m256 py = _mm256_loadu_ps(in->y + i);
+    __m256 pz = _mm256_loadu_ps(in->z + i);
+
+    __m256 inv = _mm256_div_ps(one, transform_row(d, 3, px, py, pz, one));
+    _mm256_storeu_ps(out->x + i,
+                     _mm256_mul_ps(transform_row(d, 0, px, py, pz, one), inv));
+    _mm256_storeu_ps(out->y + i,
+                     _mm256_mul_ps(transform_row(d, 1, px, py, pz, one), inv));
+    _mm256_storeu_ps(out->z + i,
+                     _mm256_mul_ps(transform_row(d, 2, px, py, pz, one), inv));
+  }
+  if (n < in->count) {
+    radiant_point3_soa_t tail_in = radiant_point3_soa_range(*in, n, in->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_transform(m, &tail_in, &tail_out);
+  }
+}
+
+static void point3_soa_transform_affine(const radiant_mat4x4_t* m,
+                                        const radiant_point3_soa_t* in,
+                                        const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  __m256 one = _mm256_set1_ps(1.0f);
+
+  uint32_t n = in->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 px = _mm256_loadu_ps(in->x + i);
+    __m256 py = _mm256_loadu_ps(in->y + i);
+    __m256 pz = _mm256_loadu_ps(in->z + i);
+
+    _mm256_storeu_ps(out->x + i, transform_row(d, 0, px, py, pz, one));
+    _mm256_storeu_ps(out->y + i, transform_row(d, 1, px, py, pz, one));
+    _mm256_storeu_ps(out->z + i, transform_row(d, 2, px, py, pz, one));
+  }
+  if (n < in->count) {
+    radiant_point3_soa_t tail_in = radiant_point3_soa_range(*in, n, in->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_transform_affine(m, &tail_in,
+                                                           &tail_out);
+  }
+}
+
+static void point3_soa_lerp(const radiant_point3_soa_t* a,
+                            const radiant_point3_soa_t* b,
+                            float t,
+                            const radiant_point3_soa_t* out) {
+  __m256 vt = _mm256_set1_ps(t);
+  __m256 sub = _mm256_set1_ps(1.0f - t);
+
+  uint32_t n = a->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 x = _mm256_mul_ps(vt, _mm256_loadu_ps(b->x + i));
+    __m256 y = _mm256_mul_ps(vt, _mm256_loadu_ps(b->y + i));
+    __m256 z = _mm256_mul_ps(vt, _mm256_loadu_ps(b->z + i));
+    _mm256_storeu_ps(out->x + i,
+                     _mm256_fmadd_ps(sub, _mm256_loadu_ps(a->x + i), x));
+    _mm256_storeu_ps(out->y + i,
+                     _mm256_fmadd_ps(sub, _mm256_loadu_ps(a->y + i), y));
+    _mm256_storeu_ps(out->z + i,
+                     _mm256_fmadd_ps(sub, _mm256_loadu_ps(a->z + i), z));
+  }
+  if (n < a->count) {
+    radiant_point3_soa_t tail_a = radiant_point3_soa_range(*a, n, a->count);
+    radiant_point3_soa_t tail_b = radiant_point3_soa_range(*b, n, b->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_lerp(&tail_a, &tail_b, t, &tail_out);
+  }
+}
+
+static void vec3_soa_transform(const radiant_mat4x4_t* m,
+                               const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  const float* d = m->data;
+  __m256 zero = _mm256_setzero_ps();
+
+  uint32_t n = in->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 vx = _mm256_loadu_ps(in->x + i);
+    __m256 vy = _mm256_loadu_ps(in->y + i);
+    __m256 vz = _mm256_loadu_ps(in->z + i);
+
+    _mm256_storeu_ps(out->x + i, transform_row(d, 0, vx, vy, vz, zero));
+    _mm256_storeu_ps(out->y + i, transform_row(d, 1, vx, vy, vz, zero));
+    _mm256_storeu_ps(out->z + i, transform_row(d, 2, vx, vy, vz, zero));
+  }
+  if (n < in->count) {
+    radiant_vec3_soa_t tail_in = radiant_vec3_soa_range(*in, n, in->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_transform(m, &tail_in, &tail_out);
+  }
+}
+
+static void vec3_soa_normalize(const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  __m256 one = _mm256_set1_ps(1.0f);
+  __m256 zero = _mm256_setzero_ps();
+
+  uint32_t n = in->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 x = _mm256_loadu_ps(in->x + i);
+    __m256 y = _mm256_loadu_ps(in->y + i);
+    __m256 z = _mm256_loadu_ps(in->z + i);
+
+    __m256 len2 =
+        _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z)));
+    __m256 len = _mm256_sqrt_ps(len2);
+    // Zero length lanes get an inverse of 0 instead of inf.
+    __m256 inv = _mm256_and_ps(_mm256_cmp_ps(len, zero, _CMP_NEQ_OQ),
+                               _mm256_div_ps(one, len));
+
+    _mm256_storeu_ps(out->x + i, _mm256_mul_ps(x, inv));
+    _mm256_storeu_ps(out->y + i, _mm256_mul_ps(y, inv));
+    _mm256_storeu_ps(out->z + i, _mm256_mul_ps(z, inv));
+  }
+  if (n < in->count) {
+    radiant_vec3_soa_t tail_in = radiant_vec3_soa_range(*in, n, in->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_normalize(&tail_in, &tail_out);
+  }
+}
+
+static void vec3_soa_dot(const radiant_vec3_soa_t* a,
+                         const radiant_vec3_soa_t* b,
+                         float* out) {
+  uint32_t n = a->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 r =
+        _mm256_mul_ps(_mm256_loadu_ps(a->z + i), _mm256_loadu_ps(b->z + i));
+    r = _mm256_fmadd_ps(_mm256_loadu_ps(a->y + i), _mm256_loadu_ps(b->y + i),
+                        r);
+    r = _mm256_fmadd_ps(_mm256_loadu_ps(a->x + i), _mm256_loadu_ps(b->x + i),
+                        r);
+    _mm256_storeu_ps(out + i, r);
+  }
+  if (n < a->count) {
+    radiant_vec3_soa_t tail_a = radiant_vec3_soa_range(*a, n, a->count);
+    radiant_vec3_soa_t tail_b = radiant_vec3_soa_range(*b, n, b->count);
+    radiant_simd_scalar_ops()->vec3_soa_dot(&tail_a, &tail_b, out + n);
+  }
+}
+
+static void vec3_soa_cross(const radiant_vec3_soa_t* a,
+                           const radiant_vec3_soa_t* b,
+                           const radiant_vec3_soa_t* out) {
+  uint32_t n = a->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 ax = _mm256_loadu_ps(a->x + i);
+    __m256 ay = _mm256_loadu_ps(a->y + i);
+    __m256 az = _mm256_loadu_ps(a->z + i);
+    __m256 bx = _mm256_loadu_ps(b->x + i);
+    __m256 by = _mm256_loadu_ps(b->y + i);
+    __m256 bz = _mm256_loadu_ps(b->z + i);
+
+    _mm256_storeu_ps(out->x + i,
+                     _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by)));
+    _mm256_storeu_ps(out->y + i,
+                     _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz)));
+    _mm256_storeu_ps(out->z + i,
+                     _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx)));
+  }
+  if (n < a->count) {
+    radiant_vec3_soa_t tail_a = radiant_vec3_soa_range(*a, n, a->count);
+    radiant_vec3_soa_t tail_b = radiant_vec3_soa_range(*b, n, b->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_cross(&tail_a, &tail_b, &tail_out);
+  }
+}
+
+static uint32_t frustum_cull_aabbs(const radiant_frustum_t* frustum,
+                                   const radiant_aabb_soa_t* boxes,
+                                   uint32_t begin,
+                                   uint32_t end,
+                                   uint32_t* visible) {
+  __m256 nx[radiant_frustum_plane_count];
+  __m256 ny[radiant_frustum_plane_count];
+  __m256 nz[radiant_frustum_plane_count];
+  __m256 d[radiant_frustum_plane_count];
+  __m256 ax[radiant_frustum_plane_count];
+  __m256 ay[radiant_frustum_plane_count];
+  __m256 az[radiant_frustum_plane_count];
+  for (uint32_t j = 0; j < radiant_frustum_plane_count; ++j) {
+    radiant_plane_t p = frustum->planes[j];
+    nx[j] = _mm256_set1_ps(p.normal.x);
+    ny[j] = _mm256_set1_ps(p.normal.y);
+    nz[j] = _mm256_set1_ps(p.normal.z);
+    d[j] = _mm256_set1_ps(p.distance);
+    ax[j] = _mm256_set1_ps(fabsf(p.normal.x));
+    ay[j] = _mm256_set1_ps(fabsf(p.normal.y));
+    az[j] = _mm256_set1_ps(fabsf(p.normal.z));
+  }
+
+  const radiant_point3_soa_t* c = &boxes->centres;
+  const radiant_vec3_soa_t* e = &boxes->half_extents;
+  uint32_t count = 0;
+  uint32_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 cx = _mm256_loadu_ps(c->x + i);
+    __m256 cy = _mm256_loadu_ps(c->y + i);
+    __m256 cz = _mm256_loadu_ps(c->z + i);
+    __m256 ex = _mm256_loadu_ps(e->x + i);
+    __m256 ey = _mm256_loadu_ps(e->y + i);
+    __m256 ez = _mm256_loadu_ps(e->z + i);
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (uint32_t j = 0; j < radiant_frustum_plane_count; ++j) {
+      // dist + radius, the box is outside if it is negative.
+      __m256 r = _mm256_fmadd_ps(nx[j], cx, d[j]);
+      r = _mm256_fmadd_ps(ny[j], cy, r);
+      r = _mm256_fmadd_ps(nz[j], cz, r);
+      r = _mm256_fmadd_ps(ax[j], ex, r);
+      r = _mm256_fmadd_ps(ay[j], ey, r);
+      r = _mm256_fmadd_ps(az[j], ez, r);
+      inside = _mm256_and_ps(
+          inside, _mm256_cmp_ps(r, _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+
+    // See the SSE kernel for the compaction.
+    uint32_t mask = (uint32_t)_mm256_movemask_ps(inside);
+    for (uint32_t lane = 0; lane < 8; ++lane) {
+      visible[count] = i + lane;
+      count += (mask >> lane) & 1u;
+    }
+  }
+  if (i < end) {
+    count += radiant_simd_scalar_ops()->frustum_cull_aabbs(
+        frustum, boxes, i, end, visible + count);
+  }
+  return count;
+}
+
+static radiant_ray_triangle_hit_t ray_intersect_triangles(
+    const radiant_ray_t* ray,
+    const radiant_triangle_soa_t* triangles,
+    uint32_t begin,
+    uint32_t end) {
+  const __m256 ox = _mm256_set1_ps(ray->origin.x);
+  const __m256 oy = _mm256_set1_ps(ray->origin.y);
+  const __m256 oz = _mm256_set1_ps(ray->origin.z);
+  const __m256 dx = _mm256_set1_ps(ray->direction.x);
+  const __m256 dy = _mm256_set1_ps(ray->direction.y);
+  const __m256 dz = _mm256_set1_ps(ray->direction.z);
+  const __m256 t_min = _mm256_set1_ps(ray->t_min);
+  const __m256 t_max = _mm256_set1_ps(ray->t_max);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.f);
+  const radiant_point3_soa_t* v0 = &triangles->v0;
+  const radiant_vec3_soa_t* e1 = &triangles->edge1;
+  const radiant_vec3_soa_t* e2 = &triangles->edge2;
+
+  // The closest hit seen by each lane.
+  __m256 best_t = _mm256_set1_ps(INFINITY);
+  __m256 best_u = zero;
+  __m256 best_v = zero;
+  __m256 best_index = zero;
+  __m256i index = _mm256_add_epi32(_mm256_set1_epi32((int32_t)begin),
+                                   _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+  uint32_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 e1x = _mm256_loadu_ps(e1->x + i);
+    __m256 e1y = _mm256_loadu_ps(e1->y + i);
+    __m256 e1z = _mm256_loadu_ps(e1->z + i);
+    __m256 e2x = _mm256_loadu_ps(e2->x + i);
+    __m256 e2y = _mm256_loadu_ps(e2->y + i);
+    __m256 e2z = _mm256_loadu_ps(e2->z + i);
+
+    __m256 px = _mm256_fmsub_ps(dy, e2z, _mm256_mul_ps(dz, e2y));
+    __m256 py = _mm256_fmsub_ps(dz, e2x, _mm256_mul_ps(dx, e2z));
+    __m256 pz = _mm256_fmsub_ps(dx, e2y, _mm256_mul_ps(dy, e2x));
+    __m256 det = _mm256_fmadd_ps(
+        e1z, pz, _mm256_fmadd_ps(e1y, py, _mm256_mul_ps(e1x, px)));
+    __m256 inv = _mm256_div_ps(one, det);
+
+    __m256 tx = _mm256_sub_ps(ox, _mm256_loadu_ps(v0->x + i));
+    __m256 ty = _mm256_sub_ps(oy, _mm256_loadu_ps(v0->y + i));
+    __m256 tz = _mm256_sub_ps(oz, _mm256_loadu_ps(v0->z + i));
+    __m256 u = _mm256_mul_ps(
+        _mm256_fmadd_ps(tz, pz,
+                        _mm256_fmadd_ps(ty, py, _mm256_mul_ps(tx, px))),
+        inv);
+
+    __m256 qx = _mm256_fmsub_ps(ty, e1z, _mm256_mul_ps(tz, e1y));
+    __m256 qy = _mm256_fmsub_ps(tz, e1x, _mm256_mul_ps(tx, e1z));
+    __m256 qz = _mm256_fmsub_ps(tx, e1y, _mm256_mul_ps(ty, e1x));
+    __m256 v = _mm256_mul_ps(
+        _mm256_fmadd_ps(dz, qz,
+                        _mm256_fmadd_ps(dy, qy, _mm256_mul_ps(dx, qx))),
+        inv);
+    __m256 t = _mm256_mul_ps(
+        _mm256_fmadd_ps(e2z, qz,
+                        _mm256_fmadd_ps(e2y, qy, _mm256_mul_ps(e2x, qx))),
+        inv);
+
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ),
+                               _mm256_cmp_ps(u, one, _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+    hit = _mm256_and_ps(
+        hit, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, t_min, _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, t_max, _CMP_LE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, best_t, _CMP_LT_OQ));
+
+    best_t = _mm256_blendv_ps(best_t, t, hit);
+    best_u = _mm256_blendv_ps(best_u, u, hit);
+    best_v = _mm256_blendv_ps(best_v, v, hit);
+    best_index = _mm256_blendv_ps(best_index, _mm256_castsi256_ps(index), hit);
+    index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+  }
+
+  float lane_t[8];
+  float lane_u[8];
+  float lane_v[8];
+  uint32_t lane_index[8];
+  _mm256_storeu_ps(lane_t, best_t);
+  _mm256_storeu_ps(lane_u, best_u);
+  _mm256_storeu_ps(lane_v, best_v);
+  _mm256_storeu_si256((void*)lane_index, _mm256_castps_si256(best_index));
+  return radiant_simd_closest_hit(
+      lane_t, lane_u, lane_v, lane_index, 8,
+      radiant_simd_scalar_ops()->ray_intersect_triangles(ray, triangles, i,
+                                                         end));
+}
+
+static void ray_soa_intersect_aabb(float* t_out,
+                                   const radiant_ray_soa_t* rays,
+                                   const radiant_aabb_t* box,
+                                   float t_max) {
+  const __m256 min_x = _mm256_set1_ps(box->min.x);
+  const __m256 min_y = _mm256_set1_ps(box->min.y);
+  const __m256 min_z = _mm256_set1_ps(box->min.z);
+  const __m256 max_x = _mm256_set1_ps(box->max.x);
+  const __m256 max_y = _mm256_set1_ps(box->max.y);
+  const __m256 max_z = _mm256_set1_ps(box->max.z);
+  const __m256 far = _mm256_set1_ps(t_max);
+  const __m256 miss = _mm256_set1_ps(INFINITY);
+  const radiant_point3_soa_t* o = &rays->origins;
+  const radiant_vec3_soa_t* inv = &rays->inv_directions;
+
+  uint32_t n = o->count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m256 ox = _mm256_loadu_ps(o->x + i);
+    __m256 oy = _mm256_loadu_ps(o->y + i);
+    __m256 oz = _mm256_loadu_ps(o->z + i);
+    __m256 ix = _mm256_loadu_ps(inv->x + i);
+    __m256 iy = _mm256_loadu_ps(inv->y + i);
+    __m256 iz = _mm256_loadu_ps(inv->z + i);
+
+    // Kept as a subtract and multiply, rather than a fused multiply add of
+    // pre-scaled origins, so the distances match the scalar kernel.
+    __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(min_x, ox), ix);
+    __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(max_x, ox), ix);
+    __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(min_y, oy), iy);
+    __m256 y2 = _mm256_mul_ps(_mm256_sub_ps(max_y, oy), iy);
+    __m256 z1 = _mm256_mul_ps(_mm256_sub_ps(min_z, oz), iz);
+    __m256 z2 = _mm256_mul_ps(_mm256_sub_ps(max_z, oz), iz);
+
+    __m256 t_near = _mm256_max_ps(
+        _mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)),
+        _mm256_max_ps(_mm256_min_ps(z1, z2), _mm256_setzero_ps()));
+    __m256 t_far = _mm256_min_ps(
+        _mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2)),
+        _mm256_min_ps(_mm256_max_ps(z1, z2), far));
+    __m256 hit = _mm256_cmp_ps(t_near, t_far, _CMP_LE_OQ);
+    _mm256_storeu_ps(t_out + i, _mm256_blendv_ps(miss, t_near, hit));
+  }
+  if (n < o->count) {
+    radiant_ray_soa_t tail = {
+        .origins = radiant_point3_soa_range(*o, n, o->count),
+        .inv_directions = radiant_vec3_soa_range(*inv, n, inv->count),
+    };
+    radiant_simd_scalar_ops()->ray_soa_intersect_aabb(t_out + n, &tail, box,
+                                                       t_max);
+  }
+}
+
+static uint32_t ray_intersect_aabbs(float* t_out,
+                                    const radiant_ray_t* ray,
+                                    const radiant_vec3_t* inv,
+                                    const float* bounds,
+                                    uint32_t width) {
+  // No FMA here: (min - o) * inv is exact where the ray starts on a face,
+  // min * inv - o * inv is not, and overflows for axis aligned rays.
+  if (width == 4) {
+    const __m128 ox = _mm_set1_ps(ray->origin.x);
+    const __m128 oy = _mm_set1_ps(ray->origin.y);
+    const __m128 oz = _mm_set1_ps(ray->origin.z);
+    const __m128 ix = _mm_set1_ps(inv->x);
+    const __m128 iy = _mm_set1_ps(inv->y);
+    const __m128 iz = _mm_set1_ps(inv->z);
+    __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds), ox), ix);
+    __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + 4), oy), iy);
+    __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + 8), oz), iz);
+    __m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + 12), ox), ix);
+    __m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + 16), oy), iy);
+    __m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + 20), oz), iz);
+
+    __m128 t_near = _mm_max_ps(
+        _mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)),
+        _mm_max_ps(_mm_min_ps(z1, z2), _mm_set1_ps(ray->t_min)));
+    __m128 t_far = _mm_min_ps(
+        _mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)),
+        _mm_min_ps(_mm_max_ps(z1, z2), _mm_set1_ps(ray->t_max)));
+    _mm_storeu_ps(t_out, t_near);
+    return (uint32_t)_mm_movemask_ps(_mm_cmple_ps(t_near, t_far));
+  }
+
+  const __m256 ox = _mm256_set1_ps(ray->origin.x);
+  const __m256 oy = _mm256_set1_ps(ray->origin.y);
+  const __m256 oz = _mm256_set1_ps(ray->origin.z);
+  const __m256 ix = _mm256_set1_ps(inv->x);
+  const __m256 iy = _mm256_set1_ps(inv->y);
+  const __m256 iz = _mm256_set1_ps(inv->z);
+  __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds), ox), ix);
+  __m256 y1 =
+      _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + 8), oy), iy);
+  __m256 z1 =
+      _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + 16), oz), iz);
+  __m256 x2 =
+      _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + 24), ox), ix);
+  __m256 y2 =
+      _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + 32), oy), iy);
+  __m256 z2 =
+      _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + 40), oz), iz);
+
+  __m256 t_near = _mm256_max_ps(
+      _mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)),
+      _mm256_max_ps(_mm256_min_ps(z1, z2), _mm256_set1_ps(ray->t_min)));
+  __m256 t_far = _mm256_min_ps(
+      _mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2)),
+      _mm256_min_ps(_mm256_max_ps(z1, z2), _mm256_set1_ps(ray->t_max)));
+  _mm256_storeu_ps(t_out, t_near);
+  __m256 hit = _mm256_cmp_ps(t_near, t_far, _CMP_LE_OQ);
+  return (uint32_t)_mm256_movemask_ps(hit);
+}
+
+void radiant_simd_install_avx2(radiant_simd_ops_t* ops) {
+  ops->mat4x4_mul = mat4x4_mul;
+  ops->mat4x4_mul_vec4 = mat4x4_mul_vec4;
+  ops->mat4x4_mul_batch = mat4x4_mul_batch;
+  ops->affine_mul = affine_mul;
+  ops->quat_nlerp_batch = quat_nlerp_batch;
+  ops->sincos_batch = sincos_batch;
+  ops->pack_f16_batch = pack_f16_batch;
+  ops->point3_soa_transform = point3_soa_transform;
+  ops->point3_soa_transform_affine = point3_soa_transform_affine;
+  ops->point3_soa_lerp = point3_soa_lerp;
+  ops->vec3_soa_transform = vec3_soa_transform;
+  ops->vec3_soa_normalize = vec3_soa_normalize;
+  ops->vec3_soa_dot = vec3_soa_dot;
+  ops->vec3_soa_cross = vec3_soa_cross;
+  ops->frustum_cull_aabbs = frustum_cull_aabbs;
+  ops->ray_intersect_triangles = ray_intersect_triangles;
+  ops->ray_soa_intersect_aabb = ray_soa_intersect_aabb;
+  ops->ray_intersect_aabbs = ray_intersect_aabbs;
+}
@@ -0,0 +1,689 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// AArch64 NEON kernels. NEON is mandatory on AArch64 so no runtime check is
+// needed.
+
+#include "src/simd.h"
+
+#include <arm_neon.h>
+#include <math.h>
+
+static void mat4x4_mul(radiant_mat4x4_t* out,
+                       const radiant_mat4x4_t* a,
+                       const radiant_mat4x4_t* b) {
+  float32x4_t a0 = vld1q_f32(&a->data[0]);
+  float32x4_t a1 = vld1q_f32(&a->data[4]);
+  float32x4_t a2 = vld1q_f32(&a->data[8]);
+  float32x4_t a3 = vld1q_f32(&a->data[12]);
+
+  float32x4_t b0 = vld1q_f32(&b->data[0]);
+  float32x4_t b1 = vld1q_f32(&b->data[4]);
+  float32x4_t b2 = vld1q_f32(&b->data[8]);
+  float32x4_t b3 = vld1q_f32(&b->data[12]);
+
+  float32x4_t r[4];
+  float32x4_t bs[4] = {b0, b1, b2, b3};
+  for (uint32_t j = 0; j < 4; ++j) {
+    r[j] = vmulq_laneq_f32(a0, bs[j], 0);
+    r[j] = vfmaq_laneq_f32(r[j], a1, bs[j], 1);
+    r[j] = vfmaq_laneq_f32(r[j], a2, bs[j], 2);
+    r[j] = vfmaq_laneq_f32(r[j], a3, bs[j], 3);
+  }
+
+  vst1q_f32(&out->data[0], r[0]);
+  vst1q_f32(&out->data[4], r[1]);
+  vst1q_f32(&out->data[8], r[2]);
+  vst1q_f32(&out->data[12], r[3]);
+}
+
+static void mat4x4_mul_batch(radiant_mat4x4_t* out,
+                             const radiant_mat4x4_t* a,
+                             const radiant_mat4x4_t* b,
+                             uint32_t count) {
+  // |a| stays in registers across the whole batch.
+  float32x4_t a0 = vld1q_f32(&a->data[0]);
+  float32x4_t a1 = vld1q_f32(&a->data[4]);
+  float32x4_t a2 = vld1q_f32(&a->data[8]);
+  float32x4_t a3 = vld1q_f32(&a->data[12]);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    for (uint32_t j = 0; j < 16; j += 4) {
+      float32x4_t bj = vld1q_f32(&b[i].data[j]);
+      float32x4_t r = vmulq_laneq_f32(a0, bj, 0);
+      r = vfmaq_laneq_f32(r, a1, bj, 1);
+      r = vfmaq_laneq_f32(r, a2, bj, 2);
+      r = vfmaq_laneq_f32(r, a3, bj, 3);
+      vst1q_f32(&out[i].data[j], r);
+    }
+  }
+}
+
+static void mat4x4_mul_vec4(radiant_vec4_t* out,
+                            const radiant_mat4x4_t* m,
+                            const radiant_vec4_t* v) {
+  float32x4_t p = vld1q_f32(&v->x);
+  float32x4_t r = vmulq_laneq_f32(vld1q_f32(&m->data[0]), p, 0);
+  r = vfmaq_laneq_f32(r, vld1q_f32(&m->data[4]), p, 1);
+  r = vfmaq_laneq_f32(r, vld1q_f32(&m->data[8]), p, 2);
+  r = vfmaq_laneq_f32(r, vld1q_f32(&m->data[12]), p, 3);
+  vst1q_f32(&out->x, r);
+}
+
+static void mat4x4_transpose(radiant_mat4x4_t* out, const radiant_mat4x4_t* m) {
+  // The de-interleaving load reads every 4th element into each register,
+  // which is the transpose of a 4x4.
+  float32x4x4_t t = vld4q_f32(m->data);
+  vst1q_f32(&out->data[0], t.val[0]);
+  vst1q_f32(&out->data[4], t.val[1]);
+  vst1q_f32(&out->data[8], t.val[2]);
+  vst1q_f32(&out->data[12], t.val[3]);
+}
+
+static void affine_mul(radiant_affine_t* out,
+                       const radiant_affine_t* a,
+                       const radiant_affine_t* b) {
+  float32x4_t b0 = vld1q_f32(&b->data[0]);
+  float32x4_t b1 = vld1q_f32(&b->data[4]);
+  float32x4_t b2 = vld1q_f32(&b->data[8]);
+
+  float32x4_t r[3];
+  for (uint32_t i = 0; i < 3; ++i) {
+    float32x4_t ai = vld1q_f32(&a->data[i * 4]);
+    // Only the translation column of |a| meets the implicit bottom row of |b|.
+    r[i] = vsetq_lane_f32(vgetq_lane_f32(ai, 3), vdupq_n_f32(0.0f), 3);
+    r[i] = vfmaq_laneq_f32(r[i], b0, ai, 0);
+    r[i] = vfmaq_laneq_f32(r[i], b1, ai, 1);
+    r[i] = vfmaq_laneq_f32(r[i], b2, ai, 2);
+  }
+  vst1q_f32(&out->data[0], r[0]);
+  vst1q_f32(&out->data[4], r[1]);
+  vst1q_f32(&out->data[8], r[2]);
+}
+
+static float vec4_dot(const radiant_vec4_t* a, const radiant_vec4_t* b) {
+  return vaddvq_f32(vmulq_f32(vld1q_f32(&a->x), vld1q_f32(&b->x)));
+}
+
+static void vec4_normalize(radiant_vec4_t* out, const radiant_vec4_t* a) {
+  float32x4_t v = vld1q_f32(&a->x);
+  float len = sqrtf(vaddvq_f32(vmulq_f32(v, v)));
+  if (len == 0.0f) {
+    vst1q_f32(&out->x, vdupq_n_f32(0.0f));
+    return;
+  }
+  vst1q_f32(&out->x, vmulq_n_f32(v, 1.0f / len));
+}
+
+static void quat_nlerp_batch(radiant_quat_t* out,
+                             const radiant_quat_t* a,
+                             const radiant_quat_t* b,
+                             float t,
+                             uint32_t count) {
+  float at = 1.0f - t;
+  uint32x4_t sign_bit = vdupq_n_u32(0x80000000u);
+  uint32x4_t vt = vreinterpretq_u32_f32(vdupq_n_f32(t));
+
+  uint32_t n = count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    // The de-interleaving load gives one component per register.
+    float32x4x4_t qa = vld4q_f32(&a[i].x);
+    float32x4x4_t qb = vld4q_f32(&b[i].x);
+
+    float32x4_t d = vmulq_f32(qa.val[3], qb.val[3]);
+    d = vfmaq_f32(d, qa.val[2], qb.val[2]);
+    d = vfmaq_f32(d, qa.val[1], qb.val[1]);
+    d = vfmaq_f32(d, qa.val[0], qb.val[0]);
+    // Negate t where the dot product is negative to take the short way.
+    float32x4_t bt = vreinterpretq_f32_u32(
+        veorq_u32(vt, vandq_u32(vreinterpretq_u32_f32(d), sign_bit)));
+
+    float32x4x4_t r;
+    for (uint32_t k = 0; k < 4; ++k) {
+      r.val[k] = vfmaq_f32(vmulq_f32(bt, qb.val[k]), qa.val[k],
+                           vdupq_n_f32(at));
+    }
+
+    float32x4_t len2 = vmulq_f32(r.val[3], r.val[3]);
+    len2 = vfmaq_f32(len2, r.val[2], r.val[2]);
+    len2 = vfmaq_f32(len2, r.val[1], r.val[1]);
+    len2 = vfmaq_f32(len2, r.val[0], r.val[0]);
+    float32x4_t inv = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(len2));
+    for (uint32_t k = 0; k < 4; ++k) {
+      r.val[k] = vmulq_f32(r.val[k], inv);
+    }
+
+    vst4q_f32(&out[i].x, r);
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->quat_nlerp_batch(out + n, a + n, b + n, t,
+                                                count - n);
+  }
+}
+
+/// Returns row |row| of |d| * (|x|, |y|, |z|, |w|) for 4 vectors at once.
+static float32x4_t transform_row(const float* d,
+                                 uint32_t row,
+                                 float32x4_t x,
+                                 float32x4_t y,
+                                 float32x4_t z,
+                                 float32x4_t w) {
+  float32x4_t r = vmulq_n_f32(w, d[row + 12]);
+  r = vfmaq_n_f32(r, z, d[row + 8]);
+  r = vfmaq_n_f32(r, y, d[row + 4]);
+  return vfmaq_n_f32(r, x, d[row + 0]);
+}
+
+static void sincos_batch(float* sin_out,
+                         float* cos_out,
+                         const float* radians,
+                         uint32_t count) {
+  const uint32x4_t one = vdupq_n_u32(1);
+  const uint32x4_t two = vdupq_n_u32(2);
+  uint32_t n = count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t x = vld1q_f32(radians + i);
+    // Large and non-finite angles take the exact libm reduction.
+    uint32x4_t fast = vcaleq_f32(x, vdupq_n_f32(RADIANT_SINCOS_MAX_FAST));
+    if (vminvq_u32(fast) == 0) {
+      radiant_simd_scalar_ops()->sincos_batch(sin_out + i, cos_out + i,
+                                              radians + i, 4);
+      continue;
+    }
+
+    int32x4_t qi = vcvtnq_s32_f32(vmulq_n_f32(x, RADIANT_SINCOS_2_BY_PI));
+    uint32x4_t q = vreinterpretq_u32_s32(qi);
+    float32x4_t j = vcvtq_f32_s32(qi);
+    float32x4_t r = vfmsq_n_f32(x, j, RADIANT_SINCOS_PI_BY_2_HI);
+    r = vfmsq_n_f32(r, j, RADIANT_SINCOS_PI_BY_2_MID);
+    r = vfmsq_n_f32(r, j, RADIANT_SINCOS_PI_BY_2_LO);
+
+    float32x4_t r2 = vmulq_f32(r, r);
+    float32x4_t s = vdupq_n_f32(RADIANT_SINCOS_S2);
+    s = vfmaq_n_f32(s, r2, RADIANT_SINCOS_S3);
+    s = vfmaq_f32(vdupq_n_f32(RADIANT_SINCOS_S1), s, r2);
+    s = vfmaq_f32(r, vmulq_f32(s, r2), r);
+    float32x4_t c = vdupq_n_f32(RADIANT_SINCOS_C2);
+    c = vfmaq_n_f32(c, r2, RADIANT_SINCOS_C3);
+    c = vfmaq_f32(vdupq_n_f32(RADIANT_SINCOS_C1), c, r2);
+    c = vfmaq_f32(vfmsq_n_f32(vdupq_n_f32(1.f), r2, .5f), vmulq_f32(c, r2),
+                  r2);
+
+    // Odd quadrants swap sin and cos, the signs follow bit 1 of q and q + 1.
+    uint32x4_t swap = vtstq_u32(q, one);
+    uint32x4_t sin_sign = vshlq_n_u32(vandq_u32(q, two), 30);
+    uint32x4_t cos_sign = vshlq_n_u32(vandq_u32(vaddq_u32(q, one), two), 30);
+    float32x4_t rs = vbslq_f32(swap, c, s);
+    float32x4_t rc = vbslq_f32(swap, s, c);
+    vst1q_f32(sin_out + i, vreinterpretq_f32_u32(
+                               veorq_u32(vreinterpretq_u32_f32(rs), sin_sign)));
+    vst1q_f32(cos_out + i, vreinterpretq_f32_u32(
+                               veorq_u32(vreinterpretq_u32_f32(rc), cos_sign)));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->sincos_batch(sin_out + n, cos_out + n,
+                                            radians + n, count - n);
+  }
+}
+
+static void pack_f16_batch(uint16_t* out, const float* in, uint32_t count) {
+  uint32_t n = count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float16x4_t h = vcvt_f16_f32(vld1q_f32(in + i));
+    vst1_u16(out + i, vreinterpret_u16_f16(h));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_f16_batch(out + n, in + n, count - n);
+  }
+}
+
+/// Returns |v| clamped to [|lo|, 1], scaled by |scale| and rounded to nearest
+/// even. vmaxnmq_f32 turns NaN into |lo|.
+static int32x4_t pack_norm(float32x4_t v, float lo, float scale) {
+  v = vminq_f32(vmaxnmq_f32(v, vdupq_n_f32(lo)), vdupq_n_f32(1.f));
+  return vcvtnq_s32_f32(vmulq_n_f32(v, scale));
+}
+
+static void pack_unorm8_batch(uint8_t* out, const float* in, uint32_t count) {
+  uint32_t n = count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    int16x4_t lo = vmovn_s32(pack_norm(vld1q_f32(in + i), 0.f, 255.f));
+    int16x4_t hi = vmovn_s32(pack_norm(vld1q_f32(in + i + 4), 0.f, 255.f));
+    int16x8_t v = vcombine_s16(lo, hi);
+    vst1_u8(out + i, vqmovun_s16(v));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_unorm8_batch(out + n, in + n, count - n);
+  }
+}
+
+static void pack_snorm16_batch(int16_t* out, const float* in, uint32_t count) {
+  uint32_t n = count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    vst1_s16(out + i, vmovn_s32(pack_norm(vld1q_f32(in + i), -1.f, 32767.f)));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_snorm16_batch(out + n, in + n, count - n);
+  }
+}
+
+static void point3_soa_transform(const radiant_mat4x4_t* m,
+                                 const radiant_point3_soa_t* in,
+                                 const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  float32x4_t one = vdupq_n_f32(1.0f);
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t px = vld1q_f32(in->x + i);
+    float32x4_t py = vld1q_f32(in->y + i);
+    float32x4_t pz = vld1q_f32(in->z + i);
+
+    float32x4_t inv = vdivq_f32(one, transform_row(d, 3, px, py, pz, one));
+    vst1q_f32(out->x + i, vmulq_f32(transform_row(d, 0, px, py, pz, one), inv));
+    vst1q_f32(out->y + i, vmulq_f32(transform_row(d, 1, px, py, pz, one), inv));
+    vst1q_f32(out->z + i, vmulq_f32(transform_row(d, 2, px, py, pz, one), inv));
+  }
+  if (n < in->count) {
+    radiant_point3_soa_t tail_in = radiant_point3_soa_range(*in, n, in->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_transform(m, &tail_in, &tail_out);
+  }
+}
+
+static void point3_soa_transform_affine(const radiant_mat4x4_t* m,
+                                        const radiant_point3_soa_t* in,
+                                        const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  float32x4_t one = vdupq_n_f32(1.0f);
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t px = vld1q_f32(in->x + i);
+    float32x4_t py = vld1q_f32(in->y + i);
+    float32x4_t pz = vld1q_f32(in->z + i);
+
+    vst1q_f32(out->x + i, transform_row(d, 0, px, py, pz, one));
+    vst1q_f32(out->y + i, transform_row(d, 1, px, py, pz, one));
+    vst1q_f32(out->z + i, transform_row(d, 2, px, py, pz, one));
+  }
+  if (n < in->count) {
+    radiant_point3_soa_t tail_in = radiant_point3_soa_range(*in, n, in->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_transform_affine(m, &tail_in,
+                                                           &tail_out);
+  }
+}
+
+static void point3_soa_lerp(const radiant_point3_soa_t* a,
+                            const radiant_point3_soa_t* b,
+                            float t,
+                            const radiant_point3_soa_t* out) {
+  float sub = 1.0f - t;
+
+  uint32_t n = a->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t x = vmulq_n_f32(vld1q_f32(b->x + i), t);
+    float32x4_t y = vmulq_n_f32(vld1q_f32(b->y + i), t);
+    float32x4_t z = vmulq_n_f32(vld1q_f32(b->z + i), t);
+    vst1q_f32(out->x + i, vfmaq_n_f32(x, vld1q_f32(a->x + i), sub));
+    vst1q_f32(out->y + i, vfmaq_n_f32(y, vld1q_f32(a->y + i), sub));
+    vst1q_f32(out->z + i, vfmaq_n_f32(z, vld1q_f32(a->z + i), sub));
+  }
+  if (n < a->count) {
+    radiant_point3_soa_t tail_a = radiant_point3_soa_range(*a, n, a->count);
+    radiant_point3_soa_t tail_b = radiant_point3_soa_range(*b, n, b->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_lerp(&tail_a, &tail_b, t, &tail_out);
+  }
+}
+
+static void vec3_soa_transform(const radiant_mat4x4_t* m,
+                               const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  const float* d = m->data;
+  float32x4_t zero = vdupq_n_f32(0.0f);
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t vx = vld1q_f32(in->x + i);
+    float32x4_t vy = vld1q_f32(in->y + i);
+    float32x4_t vz = vld1q_f32(in->z + i);
+
+    vst1q_f32(out->x + i, transform_row(d, 0, vx, vy, vz, zero));
+    vst1q_f32(out->y + i, transform_row(d, 1, vx, vy, vz, zero));
+    vst1q_f32(out->z + i, transform_row(d, 2, vx, vy, vz, zero));
+  }
+  if (n < in->count) {
+    radiant_vec3_soa_t tail_in = radiant_vec3_soa_range(*in, n, in->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_transform(m, &tail_in, &tail_out);
+  }
+}
+
+static void vec3_soa_normalize(const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  float32x4_t one = vdupq_n_f32(1.0f);
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t x = vld1q_f32(in->x + i);
+    float32x4_t y = vld1q_f32(in->y + i);
+    float32x4_t z = vld1q_f32(in->z + i);
+
+    float32x4_t len =
+        vsqrtq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(z, z), y, y), x, x));
+    // Zero length lanes get an inverse of 0 instead of inf.
+    uint32x4_t nonzero = vmvnq_u32(vceqzq_f32(len));
+    float32x4_t inv = vreinterpretq_f32_u32(
+        vandq_u32(nonzero, vreinterpretq_u32_f32(vdivq_f32(one, len))));
+
+    vst1q_f32(out->x + i, vmulq_f32(x, inv));
+    vst1q_f32(out->y + i, vmulq_f32(y, inv));
+    vst1q_f32(out->z + i, vmulq_f32(z, inv));
+  }
+  if (n < in->count) {
+    radiant_vec3_soa_t tail_in = radiant_vec3_soa_range(*in, n, in->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_normalize(&tail_in, &tail_out);
+  }
+}
+
+static void vec3_soa_dot(const radiant_vec3_soa_t* a,
+                         const radiant_vec3_soa_t* b,
+                         float* out) {
+  uint32_t n = a->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t r = vmulq_f32(vld1q_f32(a->z + i), vld1q_f32(b->z + i));
+    r = vfmaq_f32(r, vld1q_f32(a->y + i), vld1q_f32(b->y + i));
+    r = vfmaq_f32(r, vld1q_f32(a->x + i), vld1q_f32(b->x + i));
+    vst1q_f32(out + i, r);
+  }
+  if (n < a->count) {
+    radiant_vec3_soa_t tail_a = radiant_vec3_soa_range(*a, n, a->count);
+    radiant_vec3_soa_t tail_b = radiant_vec3_soa_range(*b, n, b->count);
+    radiant_simd_scalar_ops()->vec3_soa_dot(&tail_a, &tail_b, out + n);
+  }
+}
+
+static void vec3_soa_cross(const radiant_vec3_soa_t* a,
+                           const radiant_vec3_soa_t* b,
+                           const radiant_vec3_soa_t* out) {
+  uint32_t n = a->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t ax = vld1q_f32(a->x + i);
+    float32x4_t ay = vld1q_f32(a->y + i);
+    float32x4_t az = vld1q_f32(a->z + i);
+    float32x4_t bx = vld1q_f32(b->x + i);
+    float32x4_t by = vld1q_f32(b->y + i);
+    float32x4_t bz = vld1q_f32(b->z + i);
+
+    vst1q_f32(out->x + i, vfmsq_f32(vmulq_f32(ay, bz), az, by));
+    vst1q_f32(out->y + i, vfmsq_f32(vmulq_f32(az, bx), ax, bz));
+    vst1q_f32(out->z + i, vfmsq_f32(vmulq_f32(ax, by), ay, bx));
+  }
+  if (n < a->count) {
+    radiant_vec3_soa_t tail_a = radiant_vec3_soa_range(*a, n, a->count);
+    radiant_vec3_soa_t tail_b = radiant_vec3_soa_range(*b, n, b->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_cross(&tail_a, &tail_b, &tail_out);
+  }
+}
+
+static uint32_t frustum_cull_aabbs(const radiant_frustum_t* frustum,
+                                   const radiant_aabb_soa_t* boxes,
+                                   uint32_t begin,
+                                   uint32_t end,
+                                   uint32_t* visible) {
+  const radiant_point3_soa_t* c = &boxes->centres;
+  const radiant_vec3_soa_t* e = &boxes->half_extents;
+  uint32_t count = 0;
+  uint32_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    float32x4_t cx = vld1q_f32(c->x + i);
+    float32x4_t cy = vld1q_f32(c->y + i);
+    float32x4_t cz = vld1q_f32(c->z + i);
+    float32x4_t ex = vld1q_f32(e->x + i);
+    float32x4_t ey = vld1q_f32(e->y + i);
+    float32x4_t ez = vld1q_f32(e->z + i);
+
+    uint32x4_t inside = vdupq_n_u32(~0u);
+    for (uint32_t j = 0; j < radiant_frustum_plane_count; ++j) {
+      radiant_plane_t p = frustum->planes[j];
+      // dist + radius, the box is outside if it is negative.
+      float32x4_t r = vfmaq_n_f32(vdupq_n_f32(p.distance), cx, p.normal.x);
+      r = vfmaq_n_f32(r, cy, p.normal.y);
+      r = vfmaq_n_f32(r, cz, p.normal.z);
+      r = vfmaq_n_f32(r, ex, fabsf(p.normal.x));
+      r = vfmaq_n_f32(r, ey, fabsf(p.normal.y));
+      r = vfmaq_n_f32(r, ez, fabsf(p.normal.z));
+      inside = vandq_u32(inside, vcgezq_f32(r));
+    }
+
+    // Branchless compaction, see the SSE kernel.
+    uint32_t mask[4];
+    vst1q_u32(mask, inside);
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      visible[count] = i + lane;
+      count += mask[lane] & 1u;
+    }
+  }
+  if (i < end) {
+    count += radiant_simd_scalar_ops()->frustum_cull_aabbs(
+        frustum, boxes, i, end, visible + count);
+  }
+  return count;
+}
+
+static radiant_ray_triangle_hit_t ray_intersect_triangles(
+    const radiant_ray_t* ray,
+    const radiant_triangle_soa_t* triangles,
+    uint32_t begin,
+    uint32_t end) {
+  const float32x4_t ox = vdupq_n_f32(ray->origin.x);
+  const float32x4_t oy = vdupq_n_f32(ray->origin.y);
+  const float32x4_t oz = vdupq_n_f32(ray->origin.z);
+  const radiant_vec3_t d = ray->direction;
+  const float32x4_t t_min = vdupq_n_f32(ray->t_min);
+  const float32x4_t t_max = vdupq_n_f32(ray->t_max);
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const radiant_point3_soa_t* v0 = &triangles->v0;
+  const radiant_vec3_soa_t* e1 = &triangles->edge1;
+  const radiant_vec3_soa_t* e2 = &triangles->edge2;
+
+  // The closest hit seen by each lane.
+  float32x4_t best_t = vdupq_n_f32(INFINITY);
+  float32x4_t best_u = vdupq_n_f32(0.f);
+  float32x4_t best_v = vdupq_n_f32(0.f);
+  uint32x4_t best_index = vdupq_n_u32(0);
+  const uint32_t lanes[4] = {0, 1, 2, 3};
+  uint32x4_t index = vaddq_u32(vdupq_n_u32(begin), vld1q_u32(lanes));
+
+  uint32_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    float32x4_t e1x = vld1q_f32(e1->x + i);
+    float32x4_t e1y = vld1q_f32(e1->y + i);
+    float32x4_t e1z = vld1q_f32(e1->z + i);
+    float32x4_t e2x = vld1q_f32(e2->x + i);
+    float32x4_t e2y = vld1q_f32(e2->y + i);
+    float32x4_t e2z = vld1q_f32(e2->z + i);
+
+    float32x4_t px = vfmsq_n_f32(vmulq_n_f32(e2z, d.y), e2y, d.z);
+    float32x4_t py = vfmsq_n_f32(vmulq_n_f32(e2x, d.z), e2z, d.x);
+    float32x4_t pz = vfmsq_n_f32(vmulq_n_f32(e2y, d.x), e2x, d.y);
+    float32x4_t det =
+        vfmaq_f32(vfmaq_f32(vmulq_f32(e1x, px), e1y, py), e1z, pz);
+    float32x4_t inv = vdivq_f32(one, det);
+
+    float32x4_t tx = vsubq_f32(ox, vld1q_f32(v0->x + i));
+    float32x4_t ty = vsubq_f32(oy, vld1q_f32(v0->y + i));
+    float32x4_t tz = vsubq_f32(oz, vld1q_f32(v0->z + i));
+    float32x4_t u = vmulq_f32(
+        vfmaq_f32(vfmaq_f32(vmulq_f32(tx, px), ty, py), tz, pz), inv);
+
+    float32x4_t qx = vfmsq_f32(vmulq_f32(ty, e1z), tz, e1y);
+    float32x4_t qy = vfmsq_f32(vmulq_f32(tz, e1x), tx, e1z);
+    float32x4_t qz = vfmsq_f32(vmulq_f32(tx, e1y), ty, e1x);
+    float32x4_t v = vmulq_f32(
+        vfmaq_n_f32(vfmaq_n_f32(vmulq_n_f32(qx, d.x), qy, d.y), qz, d.z),
+        inv);
+    float32x4_t t = vmulq_f32(
+        vfmaq_f32(vfmaq_f32(vmulq_f32(e2x, qx), e2y, qy), e2z, qz), inv);
+
+    uint32x4_t hit = vandq_u32(vcgezq_f32(u), vcleq_f32(u, one));
+    hit = vandq_u32(hit, vcgezq_f32(v));
+    hit = vandq_u32(hit, vcleq_f32(vaddq_f32(u, v), one));
+    hit = vandq_u32(hit, vcgeq_f32(t, t_min));
+    hit = vandq_u32(hit, vcleq_f32(t, t_max));
+    hit = vandq_u32(hit, vcltq_f32(t, best_t));
+
+    best_t = vbslq_f32(hit, t, best_t);
+    best_u = vbslq_f32(hit, u, best_u);
+    best_v = vbslq_f32(hit, v, best_v);
+    best_index = vbslq_u32(hit, index, best_index);
+    index = vaddq_u32(index, vdupq_n_u32(4));
+  }
+
+  float lane_t[4];
+  float lane_u[4];
+  float lane_v[4];
+  uint32_t lane_index[4];
+  vst1q_f32(lane_t, best_t);
+  vst1q_f32(lane_u, best_u);
+  vst1q_f32(lane_v, best_v);
+  vst1q_u32(lane_index, best_index);
+  return radiant_simd_closest_hit(
+      lane_t, lane_u, lane_v, lane_index, 4,
+      radiant_simd_scalar_ops()->ray_intersect_triangles(ray, triangles, i,
+                                                         end));
+}
+
+static void ray_soa_intersect_aabb(float* t_out,
+                                   const radiant_ray_soa_t* rays,
+                                   const radiant_aabb_t* box,
+                                   float t_max) {
+  const float32x4_t min_x = vdupq_n_f32(box->min.x);
+  const float32x4_t min_y = vdupq_n_f32(box->min.y);
+  const float32x4_t min_z = vdupq_n_f32(box->min.z);
+  const float32x4_t max_x = vdupq_n_f32(box->max.x);
+  const float32x4_t max_y = vdupq_n_f32(box->max.y);
+  const float32x4_t max_z = vdupq_n_f32(box->max.z);
+  const float32x4_t far = vdupq_n_f32(t_max);
+  const float32x4_t miss = vdupq_n_f32(INFINITY);
+  const radiant_point3_soa_t* o = &rays->origins;
+  const radiant_vec3_soa_t* inv = &rays->inv_directions;
+
+  uint32_t n = o->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    float32x4_t ox = vld1q_f32(o->x + i);
+    float32x4_t oy = vld1q_f32(o->y + i);
+    float32x4_t oz = vld1q_f32(o->z + i);
+    float32x4_t ix = vld1q_f32(inv->x + i);
+    float32x4_t iy = vld1q_f32(inv->y + i);
+    float32x4_t iz = vld1q_f32(inv->z + i);
+
+    float32x4_t x1 = vmulq_f32(vsubq_f32(min_x, ox), ix);
+    float32x4_t x2 = vmulq_f32(vsubq_f32(max_x, ox), ix);
+    float32x4_t y1 = vmulq_f32(vsubq_f32(min_y, oy), iy);
+    float32x4_t y2 = vmulq_f32(vsubq_f32(max_y, oy), iy);
+    float32x4_t z1 = vmulq_f32(vsubq_f32(min_z, oz), iz);
+    float32x4_t z2 = vmulq_f32(vsubq_f32(max_z, oz), iz);
+
+    // vminnmq/vmaxnmq drop a NaN operand, as fminf and fmaxf do.
+    float32x4_t t_near =
+        vmaxnmq_f32(vmaxnmq_f32(vminnmq_f32(x1, x2), vminnmq_f32(y1, y2)),
+                    vmaxnmq_f32(vminnmq_f32(z1, z2), vdupq_n_f32(0.f)));
+    float32x4_t t_far =
+        vminnmq_f32(vminnmq_f32(vmaxnmq_f32(x1, x2), vmaxnmq_f32(y1, y2)),
+                    vminnmq_f32(vmaxnmq_f32(z1, z2), far));
+    uint32x4_t hit = vcleq_f32(t_near, t_far);
+    vst1q_f32(t_out + i, vbslq_f32(hit, t_near, miss));
+  }
+  if (n < o->count) {
+    radiant_ray_soa_t tail = {
+        .origins = radiant_point3_soa_range(*o, n, o->count),
+        .inv_directions = radiant_vec3_soa_range(*inv, n, inv->count),
+    };
+    radiant_simd_scalar_ops()->ray_soa_intersect_aabb(t_out + n, &tail, box,
+                                                       t_max);
+  }
+}
+
+static uint32_t ray_intersect_aabbs(float* t_out,
+                                    const radiant_ray_t* ray,
+                                    const radiant_vec3_t* inv,
+                                    const float* bounds,
+                                    uint32_t width) {
+  const float32x4_t ox = vdupq_n_f32(ray->origin.x);
+  const float32x4_t oy = vdupq_n_f32(ray->origin.y);
+  const float32x4_t oz = vdupq_n_f32(ray->origin.z);
+  const float32x4_t ix = vdupq_n_f32(inv->x);
+  const float32x4_t iy = vdupq_n_f32(inv->y);
+  const float32x4_t iz = vdupq_n_f32(inv->z);
+  const float32x4_t near = vdupq_n_f32(ray->t_min);
+  const float32x4_t far = vdupq_n_f32(ray->t_max);
+  const uint32_t kLaneBits[4] = {1, 2, 4, 8};
+  const uint32x4_t lane_bits = vld1q_u32(kLaneBits);
+
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < width; i += 4) {
+    const float* b = bounds + i;
+    float32x4_t x1 = vmulq_f32(vsubq_f32(vld1q_f32(b), ox), ix);
+    float32x4_t y1 = vmulq_f32(vsubq_f32(vld1q_f32(b + width), oy), iy);
+    float32x4_t z1 = vmulq_f32(vsubq_f32(vld1q_f32(b + (2 * width)), oz), iz);
+    float32x4_t x2 = vmulq_f32(vsubq_f32(vld1q_f32(b + (3 * width)), ox), ix);
+    float32x4_t y2 = vmulq_f32(vsubq_f32(vld1q_f32(b + (4 * width)), oy), iy);
+    float32x4_t z2 = vmulq_f32(vsubq_f32(vld1q_f32(b + (5 * width)), oz), iz);
+
+    float32x4_t t_near =
+        vmaxnmq_f32(vmaxnmq_f32(vminnmq_f32(x1, x2), vminnmq_f32(y1, y2)),
+                    vmaxnmq_f32(vminnmq_f32(z1, z2), near));
+    float32x4_t t_far =
+        vminnmq_f32(vminnmq_f32(vmaxnmq_f32(x1, x2), vmaxnmq_f32(y1, y2)),
+                    vminnmq_f32(vmaxnmq_f32(z1, z2), far));
+    vst1q_f32(t_out + i, t_near);
+    uint32x4_t hit = vandq_u32(vcleq_f32(t_near, t_far), lane_bits);
+    mask |= vaddvq_u32(hit) << i;
+  }
+  return mask;
+}
+
+void radiant_simd_install_neon(radiant_simd_ops_t* ops) {
+  ops->mat4x4_mul = mat4x4_mul;
+  ops->mat4x4_mul_vec4 = mat4x4_mul_vec4;
+  ops->mat4x4_transpose = mat4x4_transpose;
+  ops->mat4x4_mul_batch = mat4x4_mul_batch;
+  ops->affine_mul = affine_mul;
+  ops->vec4_dot = vec4_dot;
+  ops->vec4_normalize = vec4_normalize;
+  ops->quat_nlerp_batch = quat_nlerp_batch;
+  ops->sincos_batch = sincos_batch;
+  ops->pack_f16_batch = pack_f16_batch;
+  ops->pack_unorm8_batch = pack_unorm8_batch;
+  ops->pack_snorm16_batch = pack_snorm16_batch;
+  ops->point3_soa_transform = point3_soa_transform;
+  ops->point3_soa_transform_affine = point3_soa_transform_affine;
+  ops->point3_soa_lerp = point3_soa_lerp;
+  ops->vec3_soa_transform = vec3_soa_transform;
+  ops->vec3_soa_normalize = vec3_soa_normalize;
+  ops->vec3_soa_dot = vec3_soa_dot;
+  ops->vec3_soa_cross = vec3_soa_cross;
+  ops->frustum_cull_aabbs = frustum_cull_aabbs;
+  ops->ray_intersect_triangles = ray_intersect_triangles;
+  ops->ray_soa_intersect_aabb = ray_soa_intersect_aabb;
+  ops->ray_intersect_aabbs = ray_intersect_aabbs;
+}
@@ -0,0 +1,569 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reference implementations of the math kernels. The SIMD backends are tested
+// against these, so keep them simple.
+
+#include "src/simd.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "src/equal.h"
+
+static void mat4x4_mul(radiant_mat4x4_t* out,
+                       const radiant_mat4x4_t* m,
+                       const radiant_mat4x4_t* b) {
+  radiant_mat4x4_t r;
+  for (uint32_t i = 0; i < 4; ++i) {
+    for (uint32_t j = 0; j < 4; ++j) {
+      uint32_t row = j * 4;
+      r.data[i + (j * 4)] = (m->data[i + 0] * b->data[row + 0]) +
+                            (m->data[i + 4] * b->data[row + 1]) +
+                            (m->data[i + 8] * b->data[row + 2]) +
+                            (m->data[i + 12] * b->data[row + 3]);
+    }
+  }
+  *out = r;
+}
+
+static void mat4x4_mul_vec4(radiant_vec4_t* out,
+                            const radiant_mat4x4_t* m,
+                            const radiant_vec4_t* v) {
+  *out = (radiant_vec4_t){
+      .x = m->data[0] * v->x + m->data[4] * v->y + m->data[8] * v->z +
+           m->data[12] * v->w,
+      .y = m->data[1] * v->x + m->data[5] * v->y + m->data[9] * v->z +
+           m->data[13] * v->w,
+      .z = m->data[2] * v->x + m->data[6] * v->y + m->data[10] * v->z +
+           m->data[14] * v->w,
+      .w = m->data[3] * v->x + m->data[7] * v->y + m->data[11] * v->z +
+           m->data[15] * v->w,
+  };
+}
+
+static void mat4x4_transpose(radiant_mat4x4_t* out, const radiant_mat4x4_t* m) {
+  // clang-format off
+  *out = (radiant_mat4x4_t){
+      .data = {
+        m->data[0], m->data[4], m->data[8], m->data[12],
+        m->data[1], m->data[5], m->data[9], m->data[13],
+        m->data[2], m->data[6], m->data[10], m->data[14],
+        m->data[3], m->data[7], m->data[11], m->data[15],
+      }
+  };
+  // clang-format on
+}
+
+static bool mat4x4_inverse(radiant_mat4x4_t* out, const radiant_mat4x4_t* m) {
+  // Laplace expansion using the 2x2 determinants of the first two and last
+  // two rows. Works on either storage order since inverse and transpose
+  // commute.
+  const float* a = m->data;
+  float s0 = (a[0] * a[5]) - (a[4] * a[1]);
+  float s1 = (a[0] * a[6]) - (a[4] * a[2]);
+  float s2 = (a[0] * a[7]) - (a[4] * a[3]);
+  float s3 = (a[1] * a[6]) - (a[5] * a[2]);
+  float s4 = (a[1] * a[7]) - (a[5] * a[3]);
+  float s5 = (a[2] * a[7]) - (a[6] * a[3]);
+
+  float c5 = (a[10] * a[15]) - (a[14] * a[11]);
+  float c4 = (a[9] * a[15]) - (a[13] * a[11]);
+  float c3 = (a[9] * a[14]) - (a[13] * a[10]);
+  float c2 = (a[8] * a[15]) - (a[12] * a[11]);
+  float c1 = (a[8] * a[14]) - (a[12] * a[10]);
+  float c0 = (a[8] * a[13]) - (a[12] * a[9]);
+
+  float det = (s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) +
+              (s5 * c0);
+  float inv = 1.0f / det;
+  if (!isfinite(inv)) {
+    return false;
+  }
+
+  // clang-format off
+  float r[16] = {
+       (a[5] * c5) - (a[6] * c4) + (a[7] * c3),
+      -(a[1] * c5) + (a[2] * c4) - (a[3] * c3),
+       (a[13] * s5) - (a[14] * s4) + (a[15] * s3),
+      -(a[9] * s5) + (a[10] * s4) - (a[11] * s3),
+
+      -(a[4] * c5) + (a[6] * c2) - (a[7] * c1),
+       (a[0] * c5) - (a[2] * c2) + (a[3] * c1),
+      -(a[12] * s5) + (a[14] * s2) - (a[15] * s1),
+       (a[8] * s5) - (a[10] * s2) + (a[11] * s1),
+
+       (a[4] * c4) - (a[5] * c2) + (a[7] * c0),
+      -(a[0] * c4) + (a[1] * c2) - (a[3] * c0),
+       (a[12] * s4) - (a[13] * s2) + (a[15] * s0),
+      -(a[8] * s4) + (a[9] * s2) - (a[11] * s0),
+
+      -(a[4] * c3) + (a[5] * c1) - (a[6] * c0),
+       (a[0] * c3) - (a[1] * c1) + (a[2] * c0),
+      -(a[12] * s3) + (a[13] * s1) - (a[14] * s0),
+       (a[8] * s3) - (a[9] * s1) + (a[10] * s0),
+  };
+  // clang-format on
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    out->data[i] = r[i] * inv;
+  }
+  return true;
+}
+
+static void mat4x4_mul_batch(radiant_mat4x4_t* out,
+                             const radiant_mat4x4_t* a,
+                             const radiant_mat4x4_t* b,
+                             uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    mat4x4_mul(&out[i], a, &b[i]);
+  }
+}
+
+static void affine_mul(radiant_affine_t* out,
+                       const radiant_affine_t* a,
+                       const radiant_affine_t* b) {
+  radiant_affine_t r;
+  for (uint32_t i = 0; i < 3; ++i) {
+    const float* ai = &a->data[i * 4];
+    for (uint32_t j = 0; j < 4; ++j) {
+      r.data[(i * 4) + j] = (ai[0] * b->data[j + 0]) +
+                            (ai[1] * b->data[j + 4]) +
+                            (ai[2] * b->data[j + 8]);
+    }
+    r.data[(i * 4) + 3] += ai[3];
+  }
+  *out = r;
+}
+
+static void normal_matrix_batch(radiant_mat3x3_t* out,
+                                const radiant_mat4x4_t* m,
+                                uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    // With columns a, b and c the inverse transpose has columns b x c, c x a
+    // and a x b over the determinant.
+    const float* a = &m[i].data[0];
+    const float* b = &m[i].data[4];
+    const float* c = &m[i].data[8];
+
+    float r[12] = {
+        (b[1] * c[2]) - (b[2] * c[1]),
+        (b[2] * c[0]) - (b[0] * c[2]),
+        (b[0] * c[1]) - (b[1] * c[0]),
+        0.0f,
+        (c[1] * a[2]) - (c[2] * a[1]),
+        (c[2] * a[0]) - (c[0] * a[2]),
+        (c[0] * a[1]) - (c[1] * a[0]),
+        0.0f,
+        (a[1] * b[2]) - (a[2] * b[1]),
+        (a[2] * b[0]) - (a[0] * b[2]),
+        (a[0] * b[1]) - (a[1] * b[0]),
+        0.0f,
+    };
+
+    float det = (a[0] * r[0]) + (a[1] * r[1]) + (a[2] * r[2]);
+    float inv = det == 0.0f ? 1.0f : 1.0f / det;
+    for (uint32_t j = 0; j < 12; ++j) {
+      r[j] *= inv;
+    }
+    memcpy(out[i].data, r, sizeof(r));
+  }
+}
+
+static float vec4_dot(const radiant_vec4_t* a, const radiant_vec4_t* b) {
+  return (a->x * b->x) + (a->y * b->y) + (a->z * b->z) + (a->w * b->w);
+}
+
+static void vec4_normalize(radiant_vec4_t* out, const radiant_vec4_t* a) {
+  float len = sqrtf(vec4_dot(a, a));
+  if (len == 0.0f) {
+    *out = (radiant_vec4_t){
+        .x = 0.f,
+        .y = 0.f,
+        .z = 0.f,
+        .w = 0.f,
+    };
+    return;
+  }
+
+  float inv = 1.0f / len;
+  *out = (radiant_vec4_t){
+      .x = a->x * inv,
+      .y = a->y * inv,
+      .z = a->z * inv,
+      .w = a->w * inv,
+  };
+}
+
+static void quat_nlerp_batch(radiant_quat_t* out,
+                             const radiant_quat_t* a,
+                             const radiant_quat_t* b,
+                             float t,
+                             uint32_t count) {
+  float at = 1.0f - t;
+  for (uint32_t i = 0; i < count; ++i) {
+    radiant_quat_t qa = a[i];
+    radiant_quat_t qb = b[i];
+
+    float d = (qa.x * qb.x) + (qa.y * qb.y) + (qa.z * qb.z) + (qa.w * qb.w);
+    float bt = d < 0.0f ? -t : t;
+    radiant_quat_t r = {
+        .x = (at * qa.x) + (bt * qb.x),
+        .y = (at * qa.y) + (bt * qb.y),
+        .z = (at * qa.z) + (bt * qb.z),
+        .w = (at * qa.w) + (bt * qb.w),
+    };
+
+    float inv =
+        1.0f / sqrtf((r.x * r.x) + (r.y * r.y) + (r.z * r.z) + (r.w * r.w));
+    out[i] = (radiant_quat_t){
+        .x = r.x * inv,
+        .y = r.y * inv,
+        .z = r.z * inv,
+        .w = r.w * inv,
+    };
+  }
+}
+
+static void sincos_batch(float* sin_out,
+                         float* cos_out,
+                         const float* radians,
+                         uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    radiant_sincos_t sc = radiant_sincos(radians[i]);
+    sin_out[i] = sc.sin;
+    cos_out[i] = sc.cos;
+  }
+}
+
+static void pack_f16_batch(uint16_t* out, const float* in, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    out[i] = radiant_pack_f16(in[i]);
+  }
+}
+
+static void pack_unorm8_batch(uint8_t* out, const float* in, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    out[i] = radiant_pack_unorm8(in[i]);
+  }
+}
+
+static void pack_snorm16_batch(int16_t* out, const float* in, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    out[i] = radiant_pack_snorm16(in[i]);
+  }
+}
+
+static void pack_octahedral_batch(uint32_t* out,
+                                  const radiant_vec3_soa_t* normals) {
+  for (uint32_t i = 0; i < normals->count; ++i) {
+    out[i] = radiant_pack_octahedral(radiant_vec3_soa_get(*normals, i));
+  }
+}
+
+static void point3_soa_transform(const radiant_mat4x4_t* m,
+                                 const radiant_point3_soa_t* in,
+                                 const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  for (uint32_t i = 0; i < in->count; ++i) {
+    float px = in->x[i];
+    float py = in->y[i];
+    float pz = in->z[i];
+
+    float x = d[0] * px + d[4] * py + d[8] * pz + d[12];
+    float y = d[1] * px + d[5] * py + d[9] * pz + d[13];
+    float z = d[2] * px + d[6] * py + d[10] * pz + d[14];
+    float w = d[3] * px + d[7] * py + d[11] * pz + d[15];
+
+    if (!radiant_equal(w, 1.0f)) {
+      float inv = 1.f / w;
+      x *= inv;
+      y *= inv;
+      z *= inv;
+    }
+    out->x[i] = x;
+    out->y[i] = y;
+    out->z[i] = z;
+  }
+}
+
+static void point3_soa_transform_affine(const radiant_mat4x4_t* m,
+                                        const radiant_point3_soa_t* in,
+                                        const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  for (uint32_t i = 0; i < in->count; ++i) {
+    float px = in->x[i];
+    float py = in->y[i];
+    float pz = in->z[i];
+
+    out->x[i] = d[0] * px + d[4] * py + d[8] * pz + d[12];
+    out->y[i] = d[1] * px + d[5] * py + d[9] * pz + d[13];
+    out->z[i] = d[2] * px + d[6] * py + d[10] * pz + d[14];
+  }
+}
+
+static void point3_soa_lerp(const radiant_point3_soa_t* a,
+                            const radiant_point3_soa_t* b,
+                            float t,
+                            const radiant_point3_soa_t* out) {
+  float sub = 1.0f - t;
+  for (uint32_t i = 0; i < a->count; ++i) {
+    out->x[i] = (sub * a->x[i]) + (t * b->x[i]);
+    out->y[i] = (sub * a->y[i]) + (t * b->y[i]);
+    out->z[i] = (sub * a->z[i]) + (t * b->z[i]);
+  }
+}
+
+static void vec3_soa_transform(const radiant_mat4x4_t* m,
+                               const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  const float* d = m->data;
+  for (uint32_t i = 0; i < in->count; ++i) {
+    float vx = in->x[i];
+    float vy = in->y[i];
+    float vz = in->z[i];
+
+    out->x[i] = d[0] * vx + d[4] * vy + d[8] * vz;
+    out->y[i] = d[1] * vx + d[5] * vy + d[9] * vz;
+    out->z[i] = d[2] * vx + d[6] * vy + d[10] * vz;
+  }
+}
+
+static void vec3_soa_normalize(const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  for (uint32_t i = 0; i < in->count; ++i) {
+    float x = in->x[i];
+    float y = in->y[i];
+    float z = in->z[i];
+
+    float len = sqrtf((x * x) + (y * y) + (z * z));
+    float inv = len == 0.0f ? 0.0f : 1.0f / len;
+    out->x[i] = x * inv;
+    out->y[i] = y * inv;
+    out->z[i] = z * inv;
+  }
+}
+
+static void vec3_soa_dot(const radiant_vec3_soa_t* a,
+                         const radiant_vec3_soa_t* b,
+                         float* out) {
+  for (uint32_t i = 0; i < a->count; ++i) {
+    out[i] = (a->x[i] * b->x[i]) + (a->y[i] * b->y[i]) + (a->z[i] * b->z[i]);
+  }
+}
+
+static void vec3_soa_cross(const radiant_vec3_soa_t* a,
+                           const radiant_vec3_soa_t* b,
+                           const radiant_vec3_soa_t* out) {
+  for (uint32_t i = 0; i < a->count; ++i) {
+    float ax = a->x[i];
+    float ay = a->y[i];
+    float az = a->z[i];
+    float bx = b->x[i];
+    float by = b->y[i];
+    float bz = b->z[i];
+
+    out->x[i] = (ay * bz) - (az * by);
+    out->y[i] = (az * bx) - (ax * bz);
+    out->z[i] = (ax * by) - (ay * bx);
+  }
+}
+
+static uint32_t frustum_cull_aabbs(const radiant_frustum_t* frustum,
+                                   const radiant_aabb_soa_t* boxes,
+                                   uint32_t begin,
+                                   uint32_t end,
+                                   uint32_t* visible) {
+  const radiant_point3_soa_t* c = &boxes->centres;
+  const radiant_vec3_soa_t* e = &boxes->half_extents;
+  uint32_t count = 0;
+  for (uint32_t i = begin; i < end; ++i) {
+    bool inside = true;
+    for (uint32_t j = 0; j < radiant_frustum_plane_count; ++j) {
+      radiant_plane_t p = frustum->planes[j];
+      float dist = (p.normal.x * c->x[i]) + (p.normal.y * c->y[i]) +
+                   (p.normal.z * c->z[i]) + p.distance;
+      float radius = (fabsf(p.normal.x) * e->x[i]) +
+                     (fabsf(p.normal.y) * e->y[i]) +
+                     (fabsf(p.normal.z) * e->z[i]);
+      inside = inside && dist + radius >= 0.f;
+    }
+    if (inside) {
+      visible[count++] = i;
+    }
+  }
+  return count;
+}
+
+static radiant_ray_triangle_hit_t ray_intersect_triangles(
+    const radiant_ray_t* ray,
+    const radiant_triangle_soa_t* triangles,
+    uint32_t begin,
+    uint32_t end) {
+  const radiant_point3_t o = ray->origin;
+  const radiant_vec3_t d = ray->direction;
+  const radiant_point3_soa_t* v0 = &triangles->v0;
+  const radiant_vec3_soa_t* e1 = &triangles->edge1;
+  const radiant_vec3_soa_t* e2 = &triangles->edge2;
+
+  radiant_ray_triangle_hit_t best = {.t = INFINITY};
+  for (uint32_t i = begin; i < end; ++i) {
+    // Moller-Trumbore. A zero determinant makes u NaN or infinite, which
+    // fails the range checks, so there is no epsilon test.
+    float px = (d.y * e2->z[i]) - (d.z * e2->y[i]);
+    float py = (d.z * e2->x[i]) - (d.x * e2->z[i]);
+    float pz = (d.x * e2->y[i]) - (d.y * e2->x[i]);
+    float det = (e1->x[i] * px) + (e1->y[i] * py) + (e1->z[i] * pz);
+    float inv = 1.f / det;
+
+    float tx = o.x - v0->x[i];
+    float ty = o.y - v0->y[i];
+    float tz = o.z - v0->z[i];
+    float u = ((tx * px) + (ty * py) + (tz * pz)) * inv;
+
+    float qx = (ty * e1->z[i]) - (tz * e1->y[i]);
+    float qy = (tz * e1->x[i]) - (tx * e1->z[i]);
+    float qz = (tx * e1->y[i]) - (ty * e1->x[i]);
+    float v = ((d.x * qx) + (d.y * qy) + (d.z * qz)) * inv;
+    float t = ((e2->x[i] * qx) + (e2->y[i] * qy) + (e2->z[i] * qz)) * inv;
+
+    if (u >= 0.f && u <= 1.f && v >= 0.f && u + v <= 1.f &&
+        t >= ray->t_min && t <= ray->t_max && t < best.t) {
+      best = (radiant_ray_triangle_hit_t){
+          .t = t,
+          .u = u,
+          .v = v,
+          .index = i,
+          .hit = true,
+      };
+    }
+  }
+  return best;
+}
+
+static void ray_soa_intersect_aabb(float* t_out,
+                                   const radiant_ray_soa_t* rays,
+                                   const radiant_aabb_t* box,
+                                   float t_max) {
+  const radiant_point3_soa_t* o = &rays->origins;
+  const radiant_vec3_soa_t* inv = &rays->inv_directions;
+  for (uint32_t i = 0; i < o->count; ++i) {
+    float x1 = (box->min.x - o->x[i]) * inv->x[i];
+    float x2 = (box->max.x - o->x[i]) * inv->x[i];
+    float y1 = (box->min.y - o->y[i]) * inv->y[i];
+    float y2 = (box->max.y - o->y[i]) * inv->y[i];
+    float z1 = (box->min.z - o->z[i]) * inv->z[i];
+    float z2 = (box->max.z - o->z[i]) * inv->z[i];
+
+    float t_near = fmaxf(fmaxf(fminf(x1, x2), fminf(y1, y2)),
+                         fmaxf(fminf(z1, z2), 0.f));
+    float t_far = fminf(fminf(fmaxf(x1, x2), fmaxf(y1, y2)),
+                        fminf(fmaxf(z1, z2), t_max));
+    t_out[i] = t_near <= t_far ? t_near : INFINITY;
+  }
+}
+
+static uint32_t ray_intersect_aabbs(float* t_out,
+                                    const radiant_ray_t* ray,
+                                    const radiant_vec3_t* inv,
+                                    const float* bounds,
+                                    uint32_t width) {
+  const radiant_point3_t o = ray->origin;
+  const float* min_x = bounds;
+  const float* min_y = bounds + width;
+  const float* min_z = bounds + (2 * width);
+  const float* max_x = bounds + (3 * width);
+  const float* max_y = bounds + (4 * width);
+  const float* max_z = bounds + (5 * width);
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < width; ++i) {
+    float x1 = (min_x[i] - o.x) * inv->x;
+    float x2 = (max_x[i] - o.x) * inv->x;
+    float y1 = (min_y[i] - o.y) * inv->y;
+    float y2 = (max_y[i] - o.y) * inv->y;
+    float z1 = (min_z[i] - o.z) * inv->z;
+    float z2 = (max_z[i] - o.z) * inv->z;
+
+    float t_near = fmaxf(fmaxf(fminf(x1, x2), fminf(y1, y2)),
+                         fmaxf(fminf(z1, z2), ray->t_min));
+    float t_far = fminf(fminf(fmaxf(x1, x2), fmaxf(y1, y2)),
+                        fminf(fmaxf(z1, z2), ray->t_max));
+    t_out[i] = t_near;
+    mask |= (t_near <= t_far ? 1u : 0u) << i;
+  }
+  return mask;
+}
+
+static const radiant_simd_ops_t kScalarOps = {
+    .mat4x4_mul = mat4x4_mul,
+    .mat4x4_mul_vec4 = mat4x4_mul_vec4,
+    .mat4x4_transpose = mat4x4_transpose,
+    .mat4x4_inverse = mat4x4_inverse,
+    .mat4x4_mul_batch = mat4x4_mul_batch,
+    .normal_matrix_batch = normal_matrix_batch,
+    .affine_mul = affine_mul,
+    .vec4_dot = vec4_dot,
+    .vec4_normalize = vec4_normalize,
+    .quat_nlerp_batch = quat_nlerp_batch,
+    .sincos_batch = sincos_batch,
+    .pack_f16_batch = pack_f16_batch,
+    .pack_unorm8_batch = pack_unorm8_batch,
+    .pack_snorm16_batch = pack_snorm16_batch,
+    .pack_octahedral_batch = pack_octahedral_batch,
+    .point3_soa_transform = point3_soa_transform,
+    .point3_soa_transform_affine = point3_soa_transform_affine,
+    .point3_soa_lerp = point3_soa_lerp,
+    .vec3_soa_transform = vec3_soa_transform,
+    .vec3_soa_normalize = vec3_soa_normalize,
+    .vec3_soa_dot = vec3_soa_dot,
+    .vec3_soa_cross = vec3_soa_cross,
+    .frustum_cull_aabbs = frustum_cull_aabbs,
+    .ray_intersect_triangles = ray_intersect_triangles,
+    .ray_soa_intersect_aabb = ray_soa_intersect_aabb,
+    .ray_intersect_aabbs = ray_intersect_aabbs,
+};
+
+const radiant_simd_ops_t* radiant_simd_scalar_ops(void) {
+  return &kScalarOps;
+}
+
+radiant_ray_triangle_hit_t radiant_simd_closest_hit(
+    const float* t,
+    const float* u,
+    const float* v,
+    const uint32_t* index,
+    uint32_t lanes,
+    radiant_ray_triangle_hit_t tail) {
+  radiant_ray_triangle_hit_t best = {.t = INFINITY};
+  for (uint32_t i = 0; i < lanes; ++i) {
+    if (t[i] < best.t || (t[i] == best.t && index[i] < best.index)) {
+      best = (radiant_ray_triangle_hit_t){
+          .t = t[i],
+          .u = u[i],
+          .v = v[i],
+          .index = index[i],
+          .hit = true,
+      };
+    }
+  }
+  // The tail covers higher indices than every lane.
+  if (tail.hit && tail.t < best.t) {
+    return tail;
+  }
+  return best;
+}
+
+void radiant_simd_install_scalar(radiant_simd_ops_t* ops) {
+  *ops = kScalarOps;
+}
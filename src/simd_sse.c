@@ -0,0 +1,959 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// SSE2 kernels. SSE2 is part of x86-64 so this file needs no extra flags.
+
+#include "src/simd.h"
+
+#include <emmintrin.h>
+#include <math.h>
+
+/// Returns |v| with lane |i| copied to all lanes.
+#define SPLAT(v, i) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(i, i, i, i))
+
+static void mat4x4_mul(radiant_mat4x4_t* out,
+                       const radiant_mat4x4_t* a,
+                       const radiant_mat4x4_t* b) {
+  __m128 a0 = _mm_loadu_ps(&a->data[0]);
+  __m128 a1 = _mm_loadu_ps(&a->data[4]);
+  __m128 a2 = _mm_loadu_ps(&a->data[8]);
+  __m128 a3 = _mm_loadu_ps(&a->data[12]);
+
+  // Column j of the result is the columns of |a| weighted by column j of |b|.
+  // Column j of |b| is read before column j of |out| is written, so |out| may
+  // alias either input.
+  for (uint32_t j = 0; j < 16; j += 4) {
+    __m128 bj = _mm_loadu_ps(&b->data[j]);
+    __m128 r = _mm_mul_ps(a0, SPLAT(bj, 0));
+    r = _mm_add_ps(r, _mm_mul_ps(a1, SPLAT(bj, 1)));
+    r = _mm_add_ps(r, _mm_mul_ps(a2, SPLAT(bj, 2)));
+    r = _mm_add_ps(r, _mm_mul_ps(a3, SPLAT(bj, 3)));
+    _mm_storeu_ps(&out->data[j], r);
+  }
+}
+
+/// Returns the horizontal sum of |v| in lane 0.
+static __m128 hsum(__m128 v) {
+  __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(v, shuf);
+  shuf = _mm_movehl_ps(shuf, sums);
+  return _mm_add_ss(sums, shuf);
+}
+
+/// Returns the 2x2 determinants of columns (0,1), (0,2), (0,3), (1,2) and
+/// (1,3), (2,3) of rows |p| and |q|, in |lo| and the first two lanes of |hi|.
+static void det2x2(__m128 p, __m128 q, __m128* lo, __m128* hi) {
+  *lo = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 0, 0, 0)),
+                 _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 2, 1))),
+      _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 0, 0, 0)),
+                 _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 2, 1))));
+  *hi = _mm_sub_ps(
+      _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 2, 1)),
+                 _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 3, 3))),
+      _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 2, 1)),
+                 _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 3, 3))));
+}
+
+static bool mat4x4_inverse(radiant_mat4x4_t* out, const radiant_mat4x4_t* m) {
+  // The same Laplace expansion as the scalar kernel, computing a row of the
+  // result at a time.
+  __m128 r0 = _mm_loadu_ps(&m->data[0]);
+  __m128 r1 = _mm_loadu_ps(&m->data[4]);
+  __m128 r2 = _mm_loadu_ps(&m->data[8]);
+  __m128 r3 = _mm_loadu_ps(&m->data[12]);
+
+  // s0..s5 from the first two rows, c0..c5 from the last two.
+  __m128 s_lo;
+  __m128 s_hi;
+  __m128 c_lo;
+  __m128 c_hi;
+  det2x2(r0, r1, &s_lo, &s_hi);
+  det2x2(r2, r3, &c_lo, &c_hi);
+
+  // Kk = (ck, ck, sk, sk)
+  __m128 k0 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(0, 0, 0, 0));
+  __m128 k1 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(1, 1, 1, 1));
+  __m128 k2 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(2, 2, 2, 2));
+  __m128 k3 = _mm_shuffle_ps(c_lo, s_lo, _MM_SHUFFLE(3, 3, 3, 3));
+  __m128 k4 = _mm_shuffle_ps(c_hi, s_hi, _MM_SHUFFLE(0, 0, 0, 0));
+  __m128 k5 = _mm_shuffle_ps(c_hi, s_hi, _MM_SHUFFLE(1, 1, 1, 1));
+
+  // Aj = (a1j, a0j, a3j, a2j)
+  __m128 t0 = r0;
+  __m128 t1 = r1;
+  __m128 t2 = r2;
+  __m128 t3 = r3;
+  _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+  __m128 a0 = _mm_shuffle_ps(t0, t0, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 a1 = _mm_shuffle_ps(t1, t1, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 a2 = _mm_shuffle_ps(t2, t2, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 a3 = _mm_shuffle_ps(t3, t3, _MM_SHUFFLE(2, 3, 0, 1));
+
+  // Flips the sign of lanes 1 and 3, or lanes 0 and 2.
+  __m128 odd = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+  __m128 even = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+
+  __m128 i0 = _mm_xor_ps(
+      odd, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a1, k5), _mm_mul_ps(a2, k4)),
+                      _mm_mul_ps(a3, k3)));
+  __m128 i1 = _mm_xor_ps(
+      even, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a0, k5), _mm_mul_ps(a2, k2)),
+                       _mm_mul_ps(a3, k1)));
+  __m128 i2 = _mm_xor_ps(
+      odd, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a0, k4), _mm_mul_ps(a1, k2)),
+                      _mm_mul_ps(a3, k0)));
+  __m128 i3 = _mm_xor_ps(
+      even, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a0, k3), _mm_mul_ps(a1, k1)),
+                       _mm_mul_ps(a2, k0)));
+
+  // The determinant is the first row of |m| dotted with the first column of
+  // the adjugate.
+  __m128 col0 = _mm_movelh_ps(_mm_unpacklo_ps(i0, i1), _mm_unpacklo_ps(i2, i3));
+  float inv = 1.0f / _mm_cvtss_f32(hsum(_mm_mul_ps(r0, col0)));
+  if (!isfinite(inv)) {
+    return false;
+  }
+
+  __m128 vinv = _mm_set1_ps(inv);
+  _mm_storeu_ps(&out->data[0], _mm_mul_ps(i0, vinv));
+  _mm_storeu_ps(&out->data[4], _mm_mul_ps(i1, vinv));
+  _mm_storeu_ps(&out->data[8], _mm_mul_ps(i2, vinv));
+  _mm_storeu_ps(&out->data[12], _mm_mul_ps(i3, vinv));
+  return true;
+}
+
+static void mat4x4_mul_batch(radiant_mat4x4_t* out,
+                             const radiant_mat4x4_t* a,
+                             const radiant_mat4x4_t* b,
+                             uint32_t count) {
+  // |a| stays in registers across the whole batch.
+  __m128 a0 = _mm_loadu_ps(&a->data[0]);
+  __m128 a1 = _mm_loadu_ps(&a->data[4]);
+  __m128 a2 = _mm_loadu_ps(&a->data[8]);
+  __m128 a3 = _mm_loadu_ps(&a->data[12]);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    for (uint32_t j = 0; j < 16; j += 4) {
+      __m128 bj = _mm_loadu_ps(&b[i].data[j]);
+      __m128 r = _mm_mul_ps(a0, SPLAT(bj, 0));
+      r = _mm_add_ps(r, _mm_mul_ps(a1, SPLAT(bj, 1)));
+      r = _mm_add_ps(r, _mm_mul_ps(a2, SPLAT(bj, 2)));
+      r = _mm_add_ps(r, _mm_mul_ps(a3, SPLAT(bj, 3)));
+      _mm_store_ps(&out[i].data[j], r);
+    }
+  }
+}
+
+static void mat4x4_mul_vec4(radiant_vec4_t* out,
+                            const radiant_mat4x4_t* m,
+                            const radiant_vec4_t* v) {
+  __m128 p = _mm_loadu_ps(&v->x);
+  __m128 r = _mm_mul_ps(_mm_loadu_ps(&m->data[0]), SPLAT(p, 0));
+  r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m->data[4]), SPLAT(p, 1)));
+  r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m->data[8]), SPLAT(p, 2)));
+  r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m->data[12]), SPLAT(p, 3)));
+  _mm_storeu_ps(&out->x, r);
+}
+
+static void mat4x4_transpose(radiant_mat4x4_t* out, const radiant_mat4x4_t* m) {
+  __m128 c0 = _mm_loadu_ps(&m->data[0]);
+  __m128 c1 = _mm_loadu_ps(&m->data[4]);
+  __m128 c2 = _mm_loadu_ps(&m->data[8]);
+  __m128 c3 = _mm_loadu_ps(&m->data[12]);
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+  _mm_storeu_ps(&out->data[0], c0);
+  _mm_storeu_ps(&out->data[4], c1);
+  _mm_storeu_ps(&out->data[8], c2);
+  _mm_storeu_ps(&out->data[12], c3);
+}
+
+/// Returns |a| x |b|. Lane 3 is 0 when lane 3 of |a| and |b| is 0.
+static __m128 cross(__m128 a, __m128 b) {
+  __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 r = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+  return _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+static void normal_matrix_batch(radiant_mat3x3_t* out,
+                                const radiant_mat4x4_t* m,
+                                uint32_t count) {
+  __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  __m128 one = _mm_set1_ps(1.0f);
+  __m128 zero = _mm_setzero_ps();
+
+  for (uint32_t i = 0; i < count; ++i) {
+    __m128 a = _mm_and_ps(_mm_loadu_ps(&m[i].data[0]), xyz);
+    __m128 b = _mm_and_ps(_mm_loadu_ps(&m[i].data[4]), xyz);
+    __m128 c = _mm_and_ps(_mm_loadu_ps(&m[i].data[8]), xyz);
+
+    __m128 bc = cross(b, c);
+    __m128 ca = cross(c, a);
+    __m128 ab = cross(a, b);
+
+    // Singular matrices keep the unscaled cofactors.
+    __m128 det = hsum(_mm_mul_ps(a, bc));
+    det = SPLAT(det, 0);
+    __m128 singular = _mm_cmpeq_ps(det, zero);
+    __m128 inv = _mm_or_ps(_mm_and_ps(singular, one),
+                           _mm_andnot_ps(singular, _mm_div_ps(one, det)));
+
+    _mm_storeu_ps(&out[i].data[0], _mm_mul_ps(bc, inv));
+    _mm_storeu_ps(&out[i].data[4], _mm_mul_ps(ca, inv));
+    _mm_storeu_ps(&out[i].data[8], _mm_mul_ps(ab, inv));
+  }
+}
+
+static void affine_mul(radiant_affine_t* out,
+                       const radiant_affine_t* a,
+                       const radiant_affine_t* b) {
+  __m128 b0 = _mm_loadu_ps(&b->data[0]);
+  __m128 b1 = _mm_loadu_ps(&b->data[4]);
+  __m128 b2 = _mm_loadu_ps(&b->data[8]);
+  // The implicit bottom row of |b|.
+  __m128 b3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+  // Row i of the result is the rows of |b| weighted by row i of |a|. All of
+  // |b| is loaded up front so |out| may alias either input.
+  __m128 r[3];
+  for (uint32_t i = 0; i < 3; ++i) {
+    __m128 ai = _mm_loadu_ps(&a->data[i * 4]);
+    r[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(SPLAT(ai, 0), b0),
+                                 _mm_mul_ps(SPLAT(ai, 1), b1)),
+                      _mm_add_ps(_mm_mul_ps(SPLAT(ai, 2), b2),
+                                 _mm_mul_ps(SPLAT(ai, 3), b3)));
+  }
+  _mm_storeu_ps(&out->data[0], r[0]);
+  _mm_storeu_ps(&out->data[4], r[1]);
+  _mm_storeu_ps(&out->data[8], r[2]);
+}
+
+static float vec4_dot(const radiant_vec4_t* a, const radiant_vec4_t* b) {
+  __m128 m = _mm_mul_ps(_mm_loadu_ps(&a->x), _mm_loadu_ps(&b->x));
+  return _mm_cvtss_f32(hsum(m));
+}
+
+static void vec4_normalize(radiant_vec4_t* out, const radiant_vec4_t* a) {
+  __m128 v = _mm_loadu_ps(&a->x);
+  float len = _mm_cvtss_f32(_mm_sqrt_ss(hsum(_mm_mul_ps(v, v))));
+  if (len == 0.0f) {
+    _mm_storeu_ps(&out->x, _mm_setzero_ps());
+    return;
+  }
+  _mm_storeu_ps(&out->x, _mm_mul_ps(v, _mm_set1_ps(1.0f / len)));
+}
+
+static void quat_nlerp_batch(radiant_quat_t* out,
+                             const radiant_quat_t* a,
+                             const radiant_quat_t* b,
+                             float t,
+                             uint32_t count) {
+  __m128 vt = _mm_set1_ps(t);
+  __m128 at = _mm_set1_ps(1.0f - t);
+  __m128 sign_bit = _mm_set1_ps(-0.0f);
+
+  uint32_t n = count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    // Transpose 4 quaternions so each register holds one component.
+    __m128 ax = _mm_loadu_ps(&a[i + 0].x);
+    __m128 ay = _mm_loadu_ps(&a[i + 1].x);
+    __m128 az = _mm_loadu_ps(&a[i + 2].x);
+    __m128 aw = _mm_loadu_ps(&a[i + 3].x);
+    _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+    __m128 bx = _mm_loadu_ps(&b[i + 0].x);
+    __m128 by = _mm_loadu_ps(&b[i + 1].x);
+    __m128 bz = _mm_loadu_ps(&b[i + 2].x);
+    __m128 bw = _mm_loadu_ps(&b[i + 3].x);
+    _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+    __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+                          _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    // Negate t where the dot product is negative to take the short way.
+    __m128 bt = _mm_xor_ps(vt, _mm_and_ps(d, sign_bit));
+
+    __m128 rx = _mm_add_ps(_mm_mul_ps(at, ax), _mm_mul_ps(bt, bx));
+    __m128 ry = _mm_add_ps(_mm_mul_ps(at, ay), _mm_mul_ps(bt, by));
+    __m128 rz = _mm_add_ps(_mm_mul_ps(at, az), _mm_mul_ps(bt, bz));
+    __m128 rw = _mm_add_ps(_mm_mul_ps(at, aw), _mm_mul_ps(bt, bw));
+
+    __m128 len = _mm_sqrt_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)),
+                   _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw))));
+    __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), len);
+    rx = _mm_mul_ps(rx, inv);
+    ry = _mm_mul_ps(ry, inv);
+    rz = _mm_mul_ps(rz, inv);
+    rw = _mm_mul_ps(rw, inv);
+
+    _MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+    _mm_storeu_ps(&out[i + 0].x, rx);
+    _mm_storeu_ps(&out[i + 1].x, ry);
+    _mm_storeu_ps(&out[i + 2].x, rz);
+    _mm_storeu_ps(&out[i + 3].x, rw);
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->quat_nlerp_batch(out + n, a + n, b + n, t,
+                                                count - n);
+  }
+}
+
+static void sincos_batch(float* sin_out,
+                         float* cos_out,
+                         const float* radians,
+                         uint32_t count) {
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i two = _mm_set1_epi32(2);
+  uint32_t n = count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 x = _mm_loadu_ps(radians + i);
+    // Large and non-finite angles take the exact libm reduction.
+    __m128 slow = _mm_cmpnle_ps(_mm_and_ps(x, abs_mask),
+                                _mm_set1_ps(RADIANT_SINCOS_MAX_FAST));
+    if (_mm_movemask_ps(slow)) {
+      radiant_simd_scalar_ops()->sincos_batch(sin_out + i, cos_out + i,
+                                              radians + i, 4);
+      continue;
+    }
+
+    __m128i q =
+        _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(RADIANT_SINCOS_2_BY_PI)));
+    __m128 j = _mm_cvtepi32_ps(q);
+    __m128 r =
+        _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(RADIANT_SINCOS_PI_BY_2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(RADIANT_SINCOS_PI_BY_2_MID)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(RADIANT_SINCOS_PI_BY_2_LO)));
+
+    __m128 r2 = _mm_mul_ps(r, r);
+    __m128 s = _mm_set1_ps(RADIANT_SINCOS_S3);
+    s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(RADIANT_SINCOS_S2));
+    s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(RADIANT_SINCOS_S1));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+    __m128 c = _mm_set1_ps(RADIANT_SINCOS_C3);
+    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(RADIANT_SINCOS_C2));
+    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(RADIANT_SINCOS_C1));
+    c = _mm_mul_ps(_mm_mul_ps(c, r2), r2);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(_mm_set1_ps(.5f), r2)),
+                   _mm_set1_ps(1.f));
+
+    // Odd quadrants swap sin and cos, the signs follow bit 1 of q and q + 1.
+    __m128 swap =
+        _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sin_sign =
+        _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cos_sign = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    __m128 rs = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    __m128 rc = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+    _mm_storeu_ps(sin_out + i, _mm_xor_ps(rs, sin_sign));
+    _mm_storeu_ps(cos_out + i, _mm_xor_ps(rc, cos_sign));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->sincos_batch(sin_out + n, cos_out + n,
+                                            radians + n, count - n);
+  }
+}
+
+/// Returns the halves of |f| in the low 16 bits of each lane, sign extended
+/// so _mm_packs_epi32 narrows them exactly. See radiant_pack_f16.
+static __m128i f16x4(__m128 f) {
+  __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32((int32_t)0x80000000u));
+  __m128 sign = _mm_and_ps(f, sign_mask);
+  __m128 abs = _mm_xor_ps(f, sign);
+  __m128i u = _mm_castps_si128(abs);
+
+  __m128i regular =
+      _mm_cmpgt_epi32(_mm_set1_epi32((int32_t)RADIANT_PACK_F16_MAX), u);
+  __m128i nan = _mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(abs, abs)),
+                              _mm_set1_epi32(0x200));
+  __m128i special = _mm_or_si128(nan, _mm_set1_epi32(0x7c00));
+
+  __m128i subnormal =
+      _mm_cmpgt_epi32(_mm_set1_epi32((int32_t)RADIANT_PACK_F16_MIN_NORMAL), u);
+  __m128i magic = _mm_set1_epi32((int32_t)RADIANT_PACK_F16_SUBNORMAL);
+  __m128i sub = _mm_sub_epi32(
+      _mm_castps_si128(_mm_add_ps(abs, _mm_castsi128_ps(magic))), magic);
+
+  // Adding -1 or 0 for the odd mantissa bit rounds ties to even.
+  __m128i odd = _mm_srai_epi32(_mm_slli_epi32(u, 31 - 13), 31);
+  __m128i normal = _mm_add_epi32(
+      u, _mm_set1_epi32((int32_t)RADIANT_PACK_F16_NORMAL_BIAS));
+  normal = _mm_srli_epi32(_mm_sub_epi32(normal, odd), 13);
+
+  __m128i h = _mm_or_si128(_mm_and_si128(subnormal, sub),
+                           _mm_andnot_si128(subnormal, normal));
+  h = _mm_or_si128(_mm_and_si128(regular, h),
+                   _mm_andnot_si128(regular, special));
+  return _mm_or_si128(h, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+
+static void pack_f16_batch(uint16_t* out, const float* in, uint32_t count) {
+  uint32_t n = count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m128i lo = f16x4(_mm_loadu_ps(in + i));
+    __m128i hi = f16x4(_mm_loadu_ps(in + i + 4));
+    _mm_storeu_si128((void*)(out + i), _mm_packs_epi32(lo, hi));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_f16_batch(out + n, in + n, count - n);
+  }
+}
+
+/// Returns |v| clamped to [|lo|, 1], scaled by |scale| and rounded. NaN
+/// becomes |lo| as _mm_max_ps returns the second operand for NaN.
+static __m128i pack_norm(__m128 v, __m128 lo, __m128 scale) {
+  v = _mm_min_ps(_mm_max_ps(v, lo), _mm_set1_ps(1.f));
+  return _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+}
+
+static void pack_unorm8_batch(uint8_t* out, const float* in, uint32_t count) {
+  const __m128 lo = _mm_setzero_ps();
+  const __m128 scale = _mm_set1_ps(255.f);
+  uint32_t n = count & ~15u;
+  for (uint32_t i = 0; i < n; i += 16) {
+    __m128i a = _mm_packs_epi32(pack_norm(_mm_loadu_ps(in + i), lo, scale),
+                                pack_norm(_mm_loadu_ps(in + i + 4), lo, scale));
+    __m128i b =
+        _mm_packs_epi32(pack_norm(_mm_loadu_ps(in + i + 8), lo, scale),
+                        pack_norm(_mm_loadu_ps(in + i + 12), lo, scale));
+    _mm_storeu_si128((void*)(out + i), _mm_packus_epi16(a, b));
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_unorm8_batch(out + n, in + n, count - n);
+  }
+}
+
+static void pack_snorm16_batch(int16_t* out, const float* in, uint32_t count) {
+  const __m128 lo = _mm_set1_ps(-1.f);
+  const __m128 scale = _mm_set1_ps(32767.f);
+  uint32_t n = count & ~7u;
+  for (uint32_t i = 0; i < n; i += 8) {
+    __m128i v = _mm_packs_epi32(pack_norm(_mm_loadu_ps(in + i), lo, scale),
+                                pack_norm(_mm_loadu_ps(in + i + 4), lo, scale));
+    _mm_storeu_si128((void*)(out + i), v);
+  }
+  if (n < count) {
+    radiant_simd_scalar_ops()->pack_snorm16_batch(out + n, in + n, count - n);
+  }
+}
+
+static void pack_octahedral_batch(uint32_t* out,
+                                  const radiant_vec3_soa_t* normals) {
+  const __m128 sign_mask =
+      _mm_castsi128_ps(_mm_set1_epi32((int32_t)0x80000000u));
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 lo = _mm_set1_ps(-1.f);
+  const __m128 scale = _mm_set1_ps(32767.f);
+  uint32_t n = normals->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 x = _mm_loadu_ps(normals->x + i);
+    __m128 y = _mm_loadu_ps(normals->y + i);
+    __m128 z = _mm_loadu_ps(normals->z + i);
+
+    __m128 sum = _mm_add_ps(
+        _mm_add_ps(_mm_andnot_ps(sign_mask, x), _mm_andnot_ps(sign_mask, y)),
+        _mm_andnot_ps(sign_mask, z));
+    __m128 inv = _mm_and_ps(_mm_cmpgt_ps(sum, _mm_setzero_ps()),
+                            _mm_div_ps(one, sum));
+    x = _mm_mul_ps(x, inv);
+    y = _mm_mul_ps(y, inv);
+
+    // Fold the lower half over the diagonals.
+    __m128 fx = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, y)),
+                          _mm_and_ps(sign_mask, x));
+    __m128 fy = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, x)),
+                          _mm_and_ps(sign_mask, y));
+    __m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+    x = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, x));
+    y = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, y));
+
+    __m128i px = _mm_and_si128(pack_norm(x, lo, scale), _mm_set1_epi32(0xffff));
+    __m128i py = _mm_slli_epi32(pack_norm(y, lo, scale), 16);
+    _mm_storeu_si128((void*)(out + i), _mm_or_si128(px, py));
+  }
+  if (n < normals->count) {
+    radiant_vec3_soa_t tail =
+        radiant_vec3_soa_range(*normals, n, normals->count);
+    radiant_simd_scalar_ops()->pack_octahedral_batch(out + n, &tail);
+  }
+}
+
+static void point3_soa_transform(const radiant_mat4x4_t* m,
+                                 const radiant_point3_soa_t* in,
+                                 const radiant_point3_soa_t* out) {
+  const float* d = m->data;
+  __m128 one = _mm_set1_ps(1.0f);
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 px = _mm_loadu_ps(in->x + i);
+    __m128 py = _mm_loadu_ps(in->y + i);
+    __m128 pz = _mm_loadu_ps(in->z + i);
+
+    __m128 r[4];
+    for (uint32_t row = 0; row < 4; ++row) {
+      r[row] = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(d[row + 0]), px),
+                     _mm_mul_ps(_mm_set1_ps(d[row + 4]), py)),
+          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(d[row + 8]), pz),
+                     _mm_set1_ps(d[row + 12])));
+    }
+
+    // Dividing by a w of 1 is exact, so unlike the scalar path there is no
+    // need to special case it.
+    __m128 inv = _mm_div_ps(one, r[3]);
+    _mm_storeu_ps(out->x + i, _mm_mul_ps(r[0], inv));
+    _mm_storeu_ps(out->y + i, _mm_mul_ps(r[1], inv));
+    _mm_storeu_ps(out->z + i, _mm_mul_ps(r[2], inv));
+  }
+  if (n < in->count) {
+    radiant_point3_soa_t tail_in = radiant_point3_soa_range(*in, n, in->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_transform(m, &tail_in, &tail_out);
+  }
+}
+
+/// Stores the upper 3x4 of |m| * (|x|, |y|, |z|, |w|) into |out|.
+static void transform3(const float* d,
+                       __m128 x,
+                       __m128 y,
+                       __m128 z,
+                       __m128 w,
+                       __m128 out[3]) {
+  for (uint32_t row = 0; row < 3; ++row) {
+    out[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(d[row + 0]), x),
+                                     _mm_mul_ps(_mm_set1_ps(d[row + 4]), y)),
+                          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(d[row + 8]), z),
+                                     _mm_mul_ps(_mm_set1_ps(d[row + 12]), w)));
+  }
+}
+
+static void point3_soa_transform_affine(const radiant_mat4x4_t* m,
+                                        const radiant_point3_soa_t* in,
+                                        const radiant_point3_soa_t* out) {
+  __m128 one = _mm_set1_ps(1.0f);
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 r[3];
+    transform3(m->data, _mm_loadu_ps(in->x + i), _mm_loadu_ps(in->y + i),
+               _mm_loadu_ps(in->z + i), one, r);
+    _mm_storeu_ps(out->x + i, r[0]);
+    _mm_storeu_ps(out->y + i, r[1]);
+    _mm_storeu_ps(out->z + i, r[2]);
+  }
+  if (n < in->count) {
+    radiant_point3_soa_t tail_in = radiant_point3_soa_range(*in, n, in->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_transform_affine(m, &tail_in,
+                                                           &tail_out);
+  }
+}
+
+static void point3_soa_lerp(const radiant_point3_soa_t* a,
+                            const radiant_point3_soa_t* b,
+                            float t,
+                            const radiant_point3_soa_t* out) {
+  __m128 vt = _mm_set1_ps(t);
+  __m128 sub = _mm_set1_ps(1.0f - t);
+
+  uint32_t n = a->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    _mm_storeu_ps(out->x + i,
+                  _mm_add_ps(_mm_mul_ps(sub, _mm_loadu_ps(a->x + i)),
+                             _mm_mul_ps(vt, _mm_loadu_ps(b->x + i))));
+    _mm_storeu_ps(out->y + i,
+                  _mm_add_ps(_mm_mul_ps(sub, _mm_loadu_ps(a->y + i)),
+                             _mm_mul_ps(vt, _mm_loadu_ps(b->y + i))));
+    _mm_storeu_ps(out->z + i,
+                  _mm_add_ps(_mm_mul_ps(sub, _mm_loadu_ps(a->z + i)),
+                             _mm_mul_ps(vt, _mm_loadu_ps(b->z + i))));
+  }
+  if (n < a->count) {
+    radiant_point3_soa_t tail_a = radiant_point3_soa_range(*a, n, a->count);
+    radiant_point3_soa_t tail_b = radiant_point3_soa_range(*b, n, b->count);
+    radiant_point3_soa_t tail_out =
+        radiant_point3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->point3_soa_lerp(&tail_a, &tail_b, t, &tail_out);
+  }
+}
+
+static void vec3_soa_transform(const radiant_mat4x4_t* m,
+                               const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  __m128 zero = _mm_setzero_ps();
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 r[3];
+    transform3(m->data, _mm_loadu_ps(in->x + i), _mm_loadu_ps(in->y + i),
+               _mm_loadu_ps(in->z + i), zero, r);
+    _mm_storeu_ps(out->x + i, r[0]);
+    _mm_storeu_ps(out->y + i, r[1]);
+    _mm_storeu_ps(out->z + i, r[2]);
+  }
+  if (n < in->count) {
+    radiant_vec3_soa_t tail_in = radiant_vec3_soa_range(*in, n, in->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_transform(m, &tail_in, &tail_out);
+  }
+}
+
+static void vec3_soa_normalize(const radiant_vec3_soa_t* in,
+                               const radiant_vec3_soa_t* out) {
+  __m128 one = _mm_set1_ps(1.0f);
+  __m128 zero = _mm_setzero_ps();
+
+  uint32_t n = in->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 x = _mm_loadu_ps(in->x + i);
+    __m128 y = _mm_loadu_ps(in->y + i);
+    __m128 z = _mm_loadu_ps(in->z + i);
+
+    __m128 len = _mm_sqrt_ps(_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+    // Zero length lanes get an inverse of 0 instead of inf.
+    __m128 inv = _mm_and_ps(_mm_cmpneq_ps(len, zero), _mm_div_ps(one, len));
+
+    _mm_storeu_ps(out->x + i, _mm_mul_ps(x, inv));
+    _mm_storeu_ps(out->y + i, _mm_mul_ps(y, inv));
+    _mm_storeu_ps(out->z + i, _mm_mul_ps(z, inv));
+  }
+  if (n < in->count) {
+    radiant_vec3_soa_t tail_in = radiant_vec3_soa_range(*in, n, in->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_normalize(&tail_in, &tail_out);
+  }
+}
+
+static void vec3_soa_dot(const radiant_vec3_soa_t* a,
+                         const radiant_vec3_soa_t* b,
+                         float* out) {
+  uint32_t n = a->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(a->x + i), _mm_loadu_ps(b->x + i));
+    __m128 y = _mm_mul_ps(_mm_loadu_ps(a->y + i), _mm_loadu_ps(b->y + i));
+    __m128 z = _mm_mul_ps(_mm_loadu_ps(a->z + i), _mm_loadu_ps(b->z + i));
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_add_ps(x, y), z));
+  }
+  if (n < a->count) {
+    radiant_vec3_soa_t tail_a = radiant_vec3_soa_range(*a, n, a->count);
+    radiant_vec3_soa_t tail_b = radiant_vec3_soa_range(*b, n, b->count);
+    radiant_simd_scalar_ops()->vec3_soa_dot(&tail_a, &tail_b, out + n);
+  }
+}
+
+static void vec3_soa_cross(const radiant_vec3_soa_t* a,
+                           const radiant_vec3_soa_t* b,
+                           const radiant_vec3_soa_t* out) {
+  uint32_t n = a->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 ax = _mm_loadu_ps(a->x + i);
+    __m128 ay = _mm_loadu_ps(a->y + i);
+    __m128 az = _mm_loadu_ps(a->z + i);
+    __m128 bx = _mm_loadu_ps(b->x + i);
+    __m128 by = _mm_loadu_ps(b->y + i);
+    __m128 bz = _mm_loadu_ps(b->z + i);
+
+    _mm_storeu_ps(out->x + i,
+                  _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)));
+    _mm_storeu_ps(out->y + i,
+                  _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)));
+    _mm_storeu_ps(out->z + i,
+                  _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+  }
+  if (n < a->count) {
+    radiant_vec3_soa_t tail_a = radiant_vec3_soa_range(*a, n, a->count);
+    radiant_vec3_soa_t tail_b = radiant_vec3_soa_range(*b, n, b->count);
+    radiant_vec3_soa_t tail_out = radiant_vec3_soa_range(*out, n, out->count);
+    radiant_simd_scalar_ops()->vec3_soa_cross(&tail_a, &tail_b, &tail_out);
+  }
+}
+
+static uint32_t frustum_cull_aabbs(const radiant_frustum_t* frustum,
+                                   const radiant_aabb_soa_t* boxes,
+                                   uint32_t begin,
+                                   uint32_t end,
+                                   uint32_t* visible) {
+  __m128 nx[radiant_frustum_plane_count];
+  __m128 ny[radiant_frustum_plane_count];
+  __m128 nz[radiant_frustum_plane_count];
+  __m128 d[radiant_frustum_plane_count];
+  __m128 ax[radiant_frustum_plane_count];
+  __m128 ay[radiant_frustum_plane_count];
+  __m128 az[radiant_frustum_plane_count];
+  for (uint32_t j = 0; j < radiant_frustum_plane_count; ++j) {
+    radiant_plane_t p = frustum->planes[j];
+    nx[j] = _mm_set1_ps(p.normal.x);
+    ny[j] = _mm_set1_ps(p.normal.y);
+    nz[j] = _mm_set1_ps(p.normal.z);
+    d[j] = _mm_set1_ps(p.distance);
+    ax[j] = _mm_set1_ps(fabsf(p.normal.x));
+    ay[j] = _mm_set1_ps(fabsf(p.normal.y));
+    az[j] = _mm_set1_ps(fabsf(p.normal.z));
+  }
+
+  const radiant_point3_soa_t* c = &boxes->centres;
+  const radiant_vec3_soa_t* e = &boxes->half_extents;
+  uint32_t count = 0;
+  uint32_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 cx = _mm_loadu_ps(c->x + i);
+    __m128 cy = _mm_loadu_ps(c->y + i);
+    __m128 cz = _mm_loadu_ps(c->z + i);
+    __m128 ex = _mm_loadu_ps(e->x + i);
+    __m128 ey = _mm_loadu_ps(e->y + i);
+    __m128 ez = _mm_loadu_ps(e->z + i);
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (uint32_t j = 0; j < radiant_frustum_plane_count; ++j) {
+      __m128 dist = _mm_add_ps(
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[j], cx), _mm_mul_ps(ny[j], cy)),
+                     _mm_mul_ps(nz[j], cz)),
+          d[j]);
+      __m128 radius = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(ax[j], ex), _mm_mul_ps(ay[j], ey)),
+          _mm_mul_ps(az[j], ez));
+      inside = _mm_and_ps(
+          inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+    }
+
+    // Branchless compaction: every lane is written, only visible ones are
+    // kept. The writes stay within the |end| - |begin| entries of |visible|.
+    uint32_t mask = (uint32_t)_mm_movemask_ps(inside);
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      visible[count] = i + lane;
+      count += (mask >> lane) & 1u;
+    }
+  }
+  if (i < end) {
+    count += radiant_simd_scalar_ops()->frustum_cull_aabbs(
+        frustum, boxes, i, end, visible + count);
+  }
+  return count;
+}
+
+static radiant_ray_triangle_hit_t ray_intersect_triangles(
+    const radiant_ray_t* ray,
+    const radiant_triangle_soa_t* triangles,
+    uint32_t begin,
+    uint32_t end) {
+  const __m128 ox = _mm_set1_ps(ray->origin.x);
+  const __m128 oy = _mm_set1_ps(ray->origin.y);
+  const __m128 oz = _mm_set1_ps(ray->origin.z);
+  const __m128 dx = _mm_set1_ps(ray->direction.x);
+  const __m128 dy = _mm_set1_ps(ray->direction.y);
+  const __m128 dz = _mm_set1_ps(ray->direction.z);
+  const __m128 t_min = _mm_set1_ps(ray->t_min);
+  const __m128 t_max = _mm_set1_ps(ray->t_max);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.f);
+  const radiant_point3_soa_t* v0 = &triangles->v0;
+  const radiant_vec3_soa_t* e1 = &triangles->edge1;
+  const radiant_vec3_soa_t* e2 = &triangles->edge2;
+
+  // The closest hit seen by each lane.
+  __m128 best_t = _mm_set1_ps(INFINITY);
+  __m128 best_u = zero;
+  __m128 best_v = zero;
+  __m128i best_index = _mm_setzero_si128();
+  __m128i index = _mm_add_epi32(_mm_set1_epi32((int32_t)begin),
+                                _mm_setr_epi32(0, 1, 2, 3));
+
+  uint32_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 e1x = _mm_loadu_ps(e1->x + i);
+    __m128 e1y = _mm_loadu_ps(e1->y + i);
+    __m128 e1z = _mm_loadu_ps(e1->z + i);
+    __m128 e2x = _mm_loadu_ps(e2->x + i);
+    __m128 e2y = _mm_loadu_ps(e2->y + i);
+    __m128 e2z = _mm_loadu_ps(e2->z + i);
+
+    // The same operations, in the same order, as the scalar kernel.
+    __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+    __m128 det = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+        _mm_mul_ps(e1z, pz));
+    __m128 inv = _mm_div_ps(one, det);
+
+    __m128 tx = _mm_sub_ps(ox, _mm_loadu_ps(v0->x + i));
+    __m128 ty = _mm_sub_ps(oy, _mm_loadu_ps(v0->y + i));
+    __m128 tz = _mm_sub_ps(oz, _mm_loadu_ps(v0->z + i));
+    __m128 u = _mm_mul_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)),
+                   _mm_mul_ps(tz, pz)),
+        inv);
+
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    __m128 v = _mm_mul_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)),
+                   _mm_mul_ps(dz, qz)),
+        inv);
+    __m128 t = _mm_mul_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)),
+                   _mm_mul_ps(e2z, qz)),
+        inv);
+
+    __m128 hit = _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+    hit = _mm_and_ps(hit, _mm_cmpge_ps(t, t_min));
+    hit = _mm_and_ps(hit, _mm_cmple_ps(t, t_max));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(t, best_t));
+
+    best_t = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, best_t));
+    best_u = _mm_or_ps(_mm_and_ps(hit, u), _mm_andnot_ps(hit, best_u));
+    best_v = _mm_or_ps(_mm_and_ps(hit, v), _mm_andnot_ps(hit, best_v));
+    __m128i hit_i = _mm_castps_si128(hit);
+    best_index = _mm_or_si128(_mm_and_si128(hit_i, index),
+                              _mm_andnot_si128(hit_i, best_index));
+    index = _mm_add_epi32(index, _mm_set1_epi32(4));
+  }
+
+  float lane_t[4];
+  float lane_u[4];
+  float lane_v[4];
+  uint32_t lane_index[4];
+  _mm_storeu_ps(lane_t, best_t);
+  _mm_storeu_ps(lane_u, best_u);
+  _mm_storeu_ps(lane_v, best_v);
+  _mm_storeu_si128((void*)lane_index, best_index);
+  return radiant_simd_closest_hit(
+      lane_t, lane_u, lane_v, lane_index, 4,
+      radiant_simd_scalar_ops()->ray_intersect_triangles(ray, triangles, i,
+                                                         end));
+}
+
+static void ray_soa_intersect_aabb(float* t_out,
+                                   const radiant_ray_soa_t* rays,
+                                   const radiant_aabb_t* box,
+                                   float t_max) {
+  const __m128 min_x = _mm_set1_ps(box->min.x);
+  const __m128 min_y = _mm_set1_ps(box->min.y);
+  const __m128 min_z = _mm_set1_ps(box->min.z);
+  const __m128 max_x = _mm_set1_ps(box->max.x);
+  const __m128 max_y = _mm_set1_ps(box->max.y);
+  const __m128 max_z = _mm_set1_ps(box->max.z);
+  const __m128 far = _mm_set1_ps(t_max);
+  const __m128 miss = _mm_set1_ps(INFINITY);
+  const radiant_point3_soa_t* o = &rays->origins;
+  const radiant_vec3_soa_t* inv = &rays->inv_directions;
+
+  uint32_t n = o->count & ~3u;
+  for (uint32_t i = 0; i < n; i += 4) {
+    __m128 ox = _mm_loadu_ps(o->x + i);
+    __m128 oy = _mm_loadu_ps(o->y + i);
+    __m128 oz = _mm_loadu_ps(o->z + i);
+    __m128 ix = _mm_loadu_ps(inv->x + i);
+    __m128 iy = _mm_loadu_ps(inv->y + i);
+    __m128 iz = _mm_loadu_ps(inv->z + i);
+
+    __m128 x1 = _mm_mul_ps(_mm_sub_ps(min_x, ox), ix);
+    __m128 x2 = _mm_mul_ps(_mm_sub_ps(max_x, ox), ix);
+    __m128 y1 = _mm_mul_ps(_mm_sub_ps(min_y, oy), iy);
+    __m128 y2 = _mm_mul_ps(_mm_sub_ps(max_y, oy), iy);
+    __m128 z1 = _mm_mul_ps(_mm_sub_ps(min_z, oz), iz);
+    __m128 z2 = _mm_mul_ps(_mm_sub_ps(max_z, oz), iz);
+
+    __m128 t_near =
+        _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)),
+                   _mm_max_ps(_mm_min_ps(z1, z2), _mm_setzero_ps()));
+    __m128 t_far =
+        _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)),
+                   _mm_min_ps(_mm_max_ps(z1, z2), far));
+    __m128 hit = _mm_cmple_ps(t_near, t_far);
+    _mm_storeu_ps(t_out + i,
+                  _mm_or_ps(_mm_and_ps(hit, t_near), _mm_andnot_ps(hit, miss)));
+  }
+  if (n < o->count) {
+    radiant_ray_soa_t tail = {
+        .origins = radiant_point3_soa_range(*o, n, o->count),
+        .inv_directions = radiant_vec3_soa_range(*inv, n, inv->count),
+    };
+    radiant_simd_scalar_ops()->ray_soa_intersect_aabb(t_out + n, &tail, box,
+                                                       t_max);
+  }
+}
+
+static uint32_t ray_intersect_aabbs(float* t_out,
+                                    const radiant_ray_t* ray,
+                                    const radiant_vec3_t* inv,
+                                    const float* bounds,
+                                    uint32_t width) {
+  const __m128 ox = _mm_set1_ps(ray->origin.x);
+  const __m128 oy = _mm_set1_ps(ray->origin.y);
+  const __m128 oz = _mm_set1_ps(ray->origin.z);
+  const __m128 ix = _mm_set1_ps(inv->x);
+  const __m128 iy = _mm_set1_ps(inv->y);
+  const __m128 iz = _mm_set1_ps(inv->z);
+  const __m128 near = _mm_set1_ps(ray->t_min);
+  const __m128 far = _mm_set1_ps(ray->t_max);
+
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < width; i += 4) {
+    const float* b = bounds + i;
+    __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b), ox), ix);
+    __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + width), oy), iy);
+    __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + (2 * width)), oz), iz);
+    __m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + (3 * width)), ox), ix);
+    __m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + (4 * width)), oy), iy);
+    __m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + (5 * width)), oz), iz);
+
+    __m128 t_near =
+        _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)),
+                   _mm_max_ps(_mm_min_ps(z1, z2), near));
+    __m128 t_far =
+        _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)),
+                   _mm_min_ps(_mm_max_ps(z1, z2), far));
+    _mm_storeu_ps(t_out + i, t_near);
+    mask |= (uint32_t)_mm_movemask_ps(_mm_cmple_ps(t_near, t_far)) << i;
+  }
+  return mask;
+}
+
+void radiant_simd_install_sse(radiant_simd_ops_t* ops) {
+  ops->mat4x4_mul = mat4x4_mul;
+  ops->mat4x4_mul_vec4 = mat4x4_mul_vec4;
+  ops->mat4x4_transpose = mat4x4_transpose;
+  ops->mat4x4_inverse = mat4x4_inverse;
+  ops->mat4x4_mul_batch = mat4x4_mul_batch;
+  ops->normal_matrix_batch = normal_matrix_batch;
+  ops->affine_mul = affine_mul;
+  ops->vec4_dot = vec4_dot;
+  ops->vec4_normalize = vec4_normalize;
+  ops->quat_nlerp_batch = quat_nlerp_batch;
+  ops->sincos_batch = sincos_batch;
+  ops->pack_f16_batch = pack_f16_batch;
+  ops->pack_unorm8_batch = pack_unorm8_batch;
+  ops->pack_snorm16_batch = pack_snorm16_batch;
+  ops->pack_octahedral_batch = pack_octahedral_batch;
+  ops->point3_soa_transform = point3_soa_transform;
+  ops->point3_soa_transform_affine = point3_soa_transform_affine;
+  ops->point3_soa_lerp = point3_soa_lerp;
+  ops->vec3_soa_transform = vec3_soa_transform;
+  ops->vec3_soa_normalize = vec3_soa_normalize;
+  ops->vec3_soa_dot = vec3_soa_dot;
+  ops->vec3_soa_cross = vec3_soa_cross;
+  ops->frustum_cull_aabbs = frustum_cull_aabbs;
+  ops->ray_intersect_triangles = ray_intersect_triangles;
+  ops->ray_soa_intersect_aabb = ray_soa_intersect_aabb;
+  ops->ray_intersect_aabbs = ray_intersect_aabbs;
+}
@@ -0,0 +1,204 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdalign.h>
+#include <string.h>
+
+#include "src/simd.h"
+#include "src/test.h"
+
+static const uint32_t kIterations = 256;
+
+static uint32_t rng_state = 1;
+
+/// Returns a pseudo random float in [-4, 4).
+static float next_float(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((float)(rng_state >> 8) / (float)(1u << 24)) * 8.0f - 4.0f;
+}
+
+static radiant_mat4x4_t random_mat4x4(void) {
+  radiant_mat4x4_t m;
+  for (uint32_t i = 0; i < 16; ++i) {
+    m.data[i] = next_float();
+  }
+  return m;
+}
+
+static radiant_vec4_t random_vec4(void) {
+  return (radiant_vec4_t){next_float(), next_float(), next_float(),
+                          next_float()};
+}
+
+/// Returns true if |a| and |b| are equal within a tolerance relative to their
+/// magnitude. The backends sum in a different order, or fused, so the
+/// absolute error scales with the size of the terms.
+static bool nearly_equal(float a, float b) {
+  float mag = (a < 0.f ? -a : a) + (b < 0.f ? -b : b);
+  return radiant_equal(a / (1.f + mag), b / (1.f + mag));
+}
+
+static bool scalar_supported() {
+  RADIANT_EXPECT_TRUE(radiant_simd_backend_supported(
+      radiant_simd_backend_scalar));
+  RADIANT_EXPECT_FALSE(radiant_simd_backend_supported(
+      radiant_simd_backend_count));
+  return true;
+}
+
+static bool set_backend() {
+  radiant_simd_backend_t original = radiant_simd_backend();
+  RADIANT_EXPECT_TRUE(radiant_simd_backend_supported(original));
+
+  RADIANT_EXPECT_TRUE(radiant_simd_set_backend(radiant_simd_backend_scalar));
+  RADIANT_EXPECT_EQ(radiant_simd_backend(), radiant_simd_backend_scalar);
+
+  RADIANT_EXPECT_FALSE(radiant_simd_set_backend(radiant_simd_backend_count));
+  RADIANT_EXPECT_EQ(radiant_simd_backend(), radiant_simd_backend_scalar);
+
+  RADIANT_EXPECT_TRUE(radiant_simd_set_backend(original));
+  return true;
+}
+
+static bool names() {
+  RADIANT_EXPECT_TRUE(
+      strcmp(radiant_simd_backend_name(radiant_simd_backend_scalar),
+             "scalar") == 0);
+  RADIANT_EXPECT_TRUE(
+      strcmp(radiant_simd_backend_name(radiant_simd_backend_avx2), "avx2") ==
+      0);
+  return true;
+}
+
+static bool mat4x4_mul_matches_scalar() {
+  radiant_simd_ops_t ref;
+  radiant_simd_install_scalar(&ref);
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    radiant_mat4x4_t a = random_mat4x4();
+    radiant_mat4x4_t b = random_mat4x4();
+
+    radiant_mat4x4_t expected;
+    ref.mat4x4_mul(&expected, &a, &b);
+    radiant_mat4x4_t actual;
+    ops->mat4x4_mul(&actual, &a, &b);
+
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(nearly_equal(expected.data[j], actual.data[j]));
+    }
+
+    // Output aliasing an input
+    ops->mat4x4_mul(&a, &a, &b);
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(nearly_equal(expected.data[j], a.data[j]));
+    }
+  }
+  return true;
+}
+
+static bool mat4x4_mul_vec4_matches_scalar() {
+  radiant_simd_ops_t ref;
+  radiant_simd_install_scalar(&ref);
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    radiant_mat4x4_t m = random_mat4x4();
+    radiant_vec4_t v = random_vec4();
+
+    radiant_vec4_t expected;
+    ref.mat4x4_mul_vec4(&expected, &m, &v);
+    ops->mat4x4_mul_vec4(&v, &m, &v);
+
+    RADIANT_EXPECT_TRUE(nearly_equal(expected.x, v.x));
+    RADIANT_EXPECT_TRUE(nearly_equal(expected.y, v.y));
+    RADIANT_EXPECT_TRUE(nearly_equal(expected.z, v.z));
+    RADIANT_EXPECT_TRUE(nearly_equal(expected.w, v.w));
+  }
+  return true;
+}
+
+static bool mat4x4_transpose_matches_scalar() {
+  radiant_simd_ops_t ref;
+  radiant_simd_install_scalar(&ref);
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+
+  radiant_mat4x4_t m = random_mat4x4();
+  radiant_mat4x4_t expected;
+  ref.mat4x4_transpose(&expected, &m);
+  ops->mat4x4_transpose(&m, &m);
+
+  for (uint32_t j = 0; j < 16; ++j) {
+    RADIANT_EXPECT_FLOAT_EQ(expected.data[j], m.data[j]);
+  }
+  return true;
+}
+
+static bool mat4x4_mul_batch_matches_scalar() {
+  radiant_simd_ops_t ref;
+  radiant_simd_install_scalar(&ref);
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+
+  radiant_mat4x4_t a = random_mat4x4();
+  alignas(16) radiant_mat4x4_t b[5];
+  for (uint32_t i = 0; i < 5; ++i) {
+    b[i] = random_mat4x4();
+  }
+
+  radiant_mat4x4_t expected[5];
+  ref.mat4x4_mul_batch(expected, &a, b, 5);
+  // Output aliasing the batch input
+  ops->mat4x4_mul_batch(b, &a, b, 5);
+  for (uint32_t i = 0; i < 5; ++i) {
+    for (uint32_t j = 0; j < 16; ++j) {
+      RADIANT_EXPECT_TRUE(nearly_equal(expected[i].data[j], b[i].data[j]));
+    }
+  }
+  return true;
+}
+
+static bool vec4_matches_scalar() {
+  radiant_simd_ops_t ref;
+  radiant_simd_install_scalar(&ref);
+  const radiant_simd_ops_t* ops = radiant_simd_ops();
+
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    radiant_vec4_t a = random_vec4();
+    radiant_vec4_t b = random_vec4();
+    RADIANT_EXPECT_TRUE(
+        nearly_equal(ref.vec4_dot(&a, &b), ops->vec4_dot(&a, &b)));
+
+    radiant_vec4_t expected;
+    ref.vec4_normalize(&expected, &a);
+    ops->vec4_normalize(&a, &a);
+    RADIANT_EXPECT_FLOAT_EQ(expected.x, a.x);
+    RADIANT_EXPECT_FLOAT_EQ(expected.y, a.y);
+    RADIANT_EXPECT_FLOAT_EQ(expected.z, a.z);
+    RADIANT_EXPECT_FLOAT_EQ(expected.w, a.w);
+  }
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("simd");
+  RADIANT_TEST(scalar_supported);
+  RADIANT_TEST(set_backend);
+  RADIANT_TEST(names);
+  RADIANT_TEST_ALL_BACKENDS(mat4x4_mul_matches_scalar);
+  RADIANT_TEST_ALL_BACKENDS(mat4x4_mul_vec4_matches_scalar);
+  RADIANT_TEST_ALL_BACKENDS(mat4x4_transpose_matches_scalar);
+  RADIANT_TEST_ALL_BACKENDS(mat4x4_mul_batch_matches_scalar);
+  RADIANT_TEST_ALL_BACKENDS(vec4_matches_scalar);
+  return radiant_suite_end();
+}
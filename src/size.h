@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#pragma once
+
+#include <stdint.h>
+
 typedef struct radiant_size_t {
   uint32_t width;
   uint32_t height;
@@ -0,0 +1,185 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/soa.h"
+
+#include <stdlib.h>
+
+#include "src/assert.h"
+#include "src/simd.h"
+
+/// Alignment of each component array, wide enough for AVX loads.
+static const uint32_t kAlignment = 32;
+/// Component arrays are rounded up to a multiple of this many floats so each
+/// array starts aligned.
+static const uint32_t kLanes = 8;
+
+/// Allocates the three component arrays of |count| floats as one block.
+/// Returns false if the allocation fails.
+static bool allocate(uint32_t count, float** x, float** y, float** z) {
+  if (count == 0) {
+    return false;
+  }
+
+  uint64_t stride = ((uint64_t)count + kLanes - 1) / kLanes * kLanes;
+  float* block = (float*)aligned_alloc(kAlignment, 3 * stride * sizeof(float));
+  if (!block) {
+    return false;
+  }
+
+  *x = block;
+  *y = block + stride;
+  *z = block + (2 * stride);
+  return true;
+}
+
+radiant_point3_soa_t radiant_point3_soa_create(uint32_t count) {
+  radiant_point3_soa_t soa = {0};
+  if (allocate(count, &soa.x, &soa.y, &soa.z)) {
+    soa.count = count;
+  }
+  return soa;
+}
+
+void radiant_point3_soa_destroy(radiant_point3_soa_t soa) {
+  free(soa.x);
+}
+
+radiant_point3_t radiant_point3_soa_get(radiant_point3_soa_t soa,
+                                        uint32_t idx) {
+  RADIANT_ASSERT(idx < soa.count);
+  return (radiant_point3_t){
+      .x = soa.x[idx],
+      .y = soa.y[idx],
+      .z = soa.z[idx],
+  };
+}
+
+void radiant_point3_soa_set(radiant_point3_soa_t soa,
+                            uint32_t idx,
+                            radiant_point3_t p) {
+  RADIANT_ASSERT(idx < soa.count);
+  soa.x[idx] = p.x;
+  soa.y[idx] = p.y;
+  soa.z[idx] = p.z;
+}
+
+radiant_point3_soa_t radiant_point3_soa_range(radiant_point3_soa_t soa,
+                                              uint32_t begin,
+                                              uint32_t end) {
+  RADIANT_ASSERT(begin <= end);
+  RADIANT_ASSERT(end <= soa.count);
+  return (radiant_point3_soa_t){
+      .x = soa.x + begin,
+      .y = soa.y + begin,
+      .z = soa.z + begin,
+      .count = end - begin,
+  };
+}
+
+radiant_vec3_soa_t radiant_vec3_soa_create(uint32_t count) {
+  radiant_vec3_soa_t soa = {0};
+  if (allocate(count, &soa.x, &soa.y, &soa.z)) {
+    soa.count = count;
+  }
+  return soa;
+}
+
+void radiant_vec3_soa_destroy(radiant_vec3_soa_t soa) {
+  free(soa.x);
+}
+
+radiant_vec3_t radiant_vec3_soa_get(radiant_vec3_soa_t soa, uint32_t idx) {
+  RADIANT_ASSERT(idx < soa.count);
+  return (radiant_vec3_t){
+      .x = soa.x[idx],
+      .y = soa.y[idx],
+      .z = soa.z[idx],
+  };
+}
+
+void radiant_vec3_soa_set(radiant_vec3_soa_t soa,
+                          uint32_t idx,
+                          radiant_vec3_t v) {
+  RADIANT_ASSERT(idx < soa.count);
+  soa.x[idx] = v.x;
+  soa.y[idx] = v.y;
+  soa.z[idx] = v.z;
+}
+
+radiant_vec3_soa_t radiant_vec3_soa_range(radiant_vec3_soa_t soa,
+                                          uint32_t begin,
+                                          uint32_t end) {
+  RADIANT_ASSERT(begin <= end);
+  RADIANT_ASSERT(end <= soa.count);
+  return (radiant_vec3_soa_t){
+      .x = soa.x + begin,
+      .y = soa.y + begin,
+      .z = soa.z + begin,
+      .count = end - begin,
+  };
+}
+
+void radiant_point3_soa_transform(radiant_mat4x4_t m,
+                                  radiant_point3_soa_t in,
+                                  radiant_point3_soa_t out) {
+  RADIANT_ASSERT(in.count == out.count);
+  radiant_simd_ops()->point3_soa_transform(&m, &in, &out);
+}
+
+void radiant_point3_soa_transform_affine(radiant_mat4x4_t m,
+                                         radiant_point3_soa_t in,
+                                         radiant_point3_soa_t out) {
+  RADIANT_ASSERT(in.count == out.count);
+  radiant_simd_ops()->point3_soa_transform_affine(&m, &in, &out);
+}
+
+void radiant_point3_soa_lerp(radiant_point3_soa_t a,
+                             radiant_point3_soa_t b,
+                             float t,
+                             radiant_point3_soa_t out) {
+  RADIANT_ASSERT(a.count == b.count);
+  RADIANT_ASSERT(a.count == out.count);
+  RADIANT_ASSERT(!(t < 0.0f));
+  RADIANT_ASSERT(!(t > 1.0f));
+  radiant_simd_ops()->point3_soa_lerp(&a, &b, t, &out);
+}
+
+void radiant_vec3_soa_transform(radiant_mat4x4_t m,
+                                radiant_vec3_soa_t in,
+                                radiant_vec3_soa_t out) {
+  RADIANT_ASSERT(in.count == out.count);
+  radiant_simd_ops()->vec3_soa_transform(&m, &in, &out);
+}
+
+void radiant_vec3_soa_normalize(radiant_vec3_soa_t in, radiant_vec3_soa_t out) {
+  RADIANT_ASSERT(in.count == out.count);
+  radiant_simd_ops()->vec3_soa_normalize(&in, &out);
+}
+
+void radiant_vec3_soa_dot(radiant_vec3_soa_t a,
+                          radiant_vec3_soa_t b,
+                          float* out) {
+  RADIANT_ASSERT(a.count == b.count);
+  RADIANT_ASSERT(out || a.count == 0);
+  radiant_simd_ops()->vec3_soa_dot(&a, &b, out);
+}
+
+void radiant_vec3_soa_cross(radiant_vec3_soa_t a,
+                            radiant_vec3_soa_t b,
+                            radiant_vec3_soa_t out) {
+  RADIANT_ASSERT(a.count == b.count);
+  RADIANT_ASSERT(a.count == out.count);
+  radiant_simd_ops()->vec3_soa_cross(&a, &b, &out);
+}
@@ -0,0 +1,133 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/mat4x4.h"
+#include "src/pad.h"
+#include "src/point3.h"
+#include "src/vec3.h"
+
+/// A stream of points stored as structure-of-arrays. Each component array
+/// holds |count| floats.
+typedef struct radiant_point3_soa_t {
+  /// The x components
+  float* x;
+  /// The y components
+  float* y;
+  /// The z components
+  float* z;
+  /// The number of points in the stream
+  uint32_t count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_point3_soa_t;
+
+/// A stream of vectors stored as structure-of-arrays. Each component array
+/// holds |count| floats.
+typedef struct radiant_vec3_soa_t {
+  /// The x components
+  float* x;
+  /// The y components
+  float* y;
+  /// The z components
+  float* z;
+  /// The number of vectors in the stream
+  uint32_t count;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_vec3_soa_t;
+
+/// Creates a stream of |count| points. The component arrays are 32 byte
+/// aligned. Returns an empty stream if the allocation fails.
+radiant_point3_soa_t radiant_point3_soa_create(uint32_t count);
+/// Destroys |soa|. Only streams from radiant_point3_soa_create may be
+/// destroyed.
+void radiant_point3_soa_destroy(radiant_point3_soa_t soa);
+
+/// Returns the point at |idx| in |soa|.
+radiant_point3_t radiant_point3_soa_get(radiant_point3_soa_t soa,
+                                        uint32_t idx);
+/// Sets the point at |idx| in |soa| to |p|.
+void radiant_point3_soa_set(radiant_point3_soa_t soa,
+                            uint32_t idx,
+                            radiant_point3_t p);
+
+/// Returns a view of the points [|begin|, |end|) of |soa|. The view shares
+/// storage with |soa| and must not be destroyed. Used to split a stream
+/// into ranges, for example across threads.
+radiant_point3_soa_t radiant_point3_soa_range(radiant_point3_soa_t soa,
+                                              uint32_t begin,
+                                              uint32_t end);
+
+/// Creates a stream of |count| vectors. The component arrays are 32 byte
+/// aligned. Returns an empty stream if the allocation fails.
+radiant_vec3_soa_t radiant_vec3_soa_create(uint32_t count);
+/// Destroys |soa|. Only streams from radiant_vec3_soa_create may be destroyed.
+void radiant_vec3_soa_destroy(radiant_vec3_soa_t soa);
+
+/// Returns the vector at |idx| in |soa|.
+radiant_vec3_t radiant_vec3_soa_get(radiant_vec3_soa_t soa, uint32_t idx);
+/// Sets the vector at |idx| in |soa| to |v|.
+void radiant_vec3_soa_set(radiant_vec3_soa_t soa,
+                          uint32_t idx,
+                          radiant_vec3_t v);
+
+/// Returns a view of the vectors [|begin|, |end|) of |soa|. The view shares
+/// storage with |soa| and must not be destroyed.
+radiant_vec3_soa_t radiant_vec3_soa_range(radiant_vec3_soa_t soa,
+                                          uint32_t begin,
+                                          uint32_t end);
+
+/// Stores |m| * |in| into |out|, including the divide by w, as
+/// radiant_mat4x4_mul_point3 does. |out| may be |in|.
+void radiant_point3_soa_transform(radiant_mat4x4_t m,
+                                  radiant_point3_soa_t in,
+                                  radiant_point3_soa_t out);
+
+/// Stores |m| * |in| into |out| treating |m| as affine, the bottom row is
+/// ignored and there is no divide by w. |out| may be |in|.
+void radiant_point3_soa_transform_affine(radiant_mat4x4_t m,
+                                         radiant_point3_soa_t in,
+                                         radiant_point3_soa_t out);
+
+/// Linear interpolation between |a| and |b| based on time |t|, stored into
+/// |out|. Mirrors radiant_point3_lerp.
+void radiant_point3_soa_lerp(radiant_point3_soa_t a,
+                             radiant_point3_soa_t b,
+                             float t,
+                             radiant_point3_soa_t out);
+
+/// Stores |m| * |in| into |out|. Translation is ignored as in
+/// radiant_mat4x4_mul_vec3. |out| may be |in|.
+void radiant_vec3_soa_transform(radiant_mat4x4_t m,
+                                radiant_vec3_soa_t in,
+                                radiant_vec3_soa_t out);
+
+/// Stores normalized copies of |in| into |out|. Zero length vectors stay
+/// zero. |out| may be |in|.
+void radiant_vec3_soa_normalize(radiant_vec3_soa_t in, radiant_vec3_soa_t out);
+
+/// Stores the dot products of |a| and |b| into |out| which must hold
+/// |a.count| floats.
+void radiant_vec3_soa_dot(radiant_vec3_soa_t a,
+                          radiant_vec3_soa_t b,
+                          float* out);
+
+/// Stores the cross products of |a| and |b| into |out|.
+void radiant_vec3_soa_cross(radiant_vec3_soa_t a,
+                            radiant_vec3_soa_t b,
+                            radiant_vec3_soa_t out);
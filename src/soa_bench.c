@@ -0,0 +1,97 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the structure-of-arrays kernels against calling the per point
+// functions in a loop, for each supported SIMD backend.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/simd.h"
+#include "src/soa.h"
+
+static const uint32_t kCount = 1 << 16;
+static const uint32_t kIterations = 200;
+
+typedef struct bench_data_t {
+  radiant_mat4x4_t m;
+  radiant_point3_t* points;
+  radiant_point3_soa_t in;
+  radiant_point3_soa_t out;
+} bench_data_t;
+
+static void scalar_loop(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    data->points[i] = radiant_mat4x4_mul_point3(data->m, data->points[i]);
+  }
+}
+
+static void soa_transform(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_point3_soa_transform(data->m, data->in, data->out);
+}
+
+static void soa_transform_affine(void* userdata) {
+  bench_data_t* data = (bench_data_t*)userdata;
+  radiant_point3_soa_transform_affine(data->m, data->in, data->out);
+}
+
+int main() {
+  bench_data_t data = {
+      .m = radiant_mat4x4_mul_mat4x4(
+          radiant_mat4x4_translate((radiant_vec3_t){1.f, 2.f, 3.f}),
+          radiant_mat4x4_rotate_y(0.5f)),
+      .points = (radiant_point3_t*)malloc(kCount * sizeof(radiant_point3_t)),
+      .in = radiant_point3_soa_create(kCount),
+      .out = radiant_point3_soa_create(kCount),
+  };
+  if (!data.points || !data.in.x || !data.out.x) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_point3_t p = {(float)i, (float)(i % 7), (float)(i % 13)};
+    data.points[i] = p;
+    radiant_point3_soa_set(data.in, i, p);
+  }
+
+  printf("Transforming %u points\n", kCount);
+  radiant_simd_backend_t original = radiant_simd_backend();
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "mat4x4_mul_point3 loop [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, scalar_loop, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "point3_soa_transform [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, soa_transform, &data, kIterations, kCount);
+    snprintf(name, sizeof(name), "point3_soa_transform_affine [%s]",
+             radiant_simd_backend_name(backend));
+    radiant_bench_run(name, soa_transform_affine, &data, kIterations, kCount);
+  }
+  radiant_simd_set_backend(original);
+
+  free(data.points);
+  radiant_point3_soa_destroy(data.in);
+  radiant_point3_soa_destroy(data.out);
+  return 0;
+}
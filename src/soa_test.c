@@ -0,0 +1,258 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/soa.h"
+
+#include <stdlib.h>
+
+#include "src/test.h"
+
+/// Not a multiple of any vector width so the remainder paths run.
+static const uint32_t kCount = 37;
+
+static uint32_t rng_state = 1;
+
+/// Returns a pseudo random float in [-4, 4).
+static float next_float(void) {
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((float)(rng_state >> 8) / (float)(1u << 24)) * 8.0f - 4.0f;
+}
+
+/// Returns a random matrix whose w row keeps w well away from 0.
+static radiant_mat4x4_t random_mat4x4(void) {
+  radiant_mat4x4_t m;
+  for (uint32_t i = 0; i < 16; ++i) {
+    m.data[i] = next_float();
+  }
+  m.data[3] *= 0.05f;
+  m.data[7] *= 0.05f;
+  m.data[11] *= 0.05f;
+  m.data[15] = 2.0f;
+  return m;
+}
+
+static radiant_point3_soa_t random_points(uint32_t count) {
+  radiant_point3_soa_t soa = radiant_point3_soa_create(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    radiant_point3_soa_set(soa, i,
+                           (radiant_point3_t){next_float(), next_float(),
+                                              next_float()});
+  }
+  return soa;
+}
+
+static radiant_vec3_soa_t random_vecs(uint32_t count) {
+  radiant_vec3_soa_t soa = radiant_vec3_soa_create(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    radiant_vec3_soa_set(
+        soa, i, (radiant_vec3_t){next_float(), next_float(), next_float()});
+  }
+  return soa;
+}
+
+/// Returns true if |a| and |b| are equal within a tolerance relative to their
+/// magnitude.
+static bool nearly_equal(float a, float b) {
+  float mag = (a < 0.f ? -a : a) + (b < 0.f ? -b : b);
+  return radiant_equal(a / (1.f + mag), b / (1.f + mag));
+}
+
+static bool create() {
+  radiant_point3_soa_t p = radiant_point3_soa_create(kCount);
+  RADIANT_EXPECT_NOT_NULL(p.x);
+  RADIANT_EXPECT_EQ(p.count, kCount);
+  RADIANT_EXPECT_TRUE(((uintptr_t)p.x & 31) == 0);
+  RADIANT_EXPECT_TRUE(((uintptr_t)p.y & 31) == 0);
+  RADIANT_EXPECT_TRUE(((uintptr_t)p.z & 31) == 0);
+
+  radiant_point3_soa_set(p, 3, (radiant_point3_t){1.f, 2.f, 3.f});
+  radiant_point3_t got = radiant_point3_soa_get(p, 3);
+  RADIANT_EXPECT_FLOAT_EQ(got.x, 1.f);
+  RADIANT_EXPECT_FLOAT_EQ(got.y, 2.f);
+  RADIANT_EXPECT_FLOAT_EQ(got.z, 3.f);
+
+  radiant_point3_soa_t r = radiant_point3_soa_range(p, 3, 10);
+  RADIANT_EXPECT_EQ(r.count, 7u);
+  RADIANT_EXPECT_FLOAT_EQ(radiant_point3_soa_get(r, 0).z, 3.f);
+  radiant_point3_soa_destroy(p);
+
+  radiant_vec3_soa_t empty = radiant_vec3_soa_create(0);
+  RADIANT_EXPECT_NULL(empty.x);
+  RADIANT_EXPECT_EQ(empty.count, 0u);
+  return true;
+}
+
+static bool point3_transform() {
+  radiant_mat4x4_t m = random_mat4x4();
+  radiant_point3_soa_t in = random_points(kCount);
+  radiant_point3_soa_t out = radiant_point3_soa_create(kCount);
+
+  radiant_point3_soa_transform(m, in, out);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_point3_t e =
+        radiant_mat4x4_mul_point3(m, radiant_point3_soa_get(in, i));
+    radiant_point3_t a = radiant_point3_soa_get(out, i);
+    RADIANT_EXPECT_TRUE(nearly_equal(e.x, a.x));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.y, a.y));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.z, a.z));
+  }
+
+  // In place
+  radiant_point3_soa_transform(m, in, in);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_point3_t e = radiant_point3_soa_get(out, i);
+    radiant_point3_t a = radiant_point3_soa_get(in, i);
+    RADIANT_EXPECT_FLOAT_EQ(e.x, a.x);
+    RADIANT_EXPECT_FLOAT_EQ(e.y, a.y);
+    RADIANT_EXPECT_FLOAT_EQ(e.z, a.z);
+  }
+
+  radiant_point3_soa_destroy(in);
+  radiant_point3_soa_destroy(out);
+  return true;
+}
+
+static bool point3_transform_affine() {
+  radiant_mat4x4_t m = radiant_mat4x4_mul_mat4x4(
+      radiant_mat4x4_translate((radiant_vec3_t){1.f, -2.f, 3.f}),
+      radiant_mat4x4_rotate_y(0.7f));
+  radiant_point3_soa_t in = random_points(kCount);
+  radiant_point3_soa_t out = radiant_point3_soa_create(kCount);
+
+  radiant_point3_soa_transform_affine(m, in, out);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_point3_t e =
+        radiant_mat4x4_mul_point3(m, radiant_point3_soa_get(in, i));
+    radiant_point3_t a = radiant_point3_soa_get(out, i);
+    RADIANT_EXPECT_TRUE(nearly_equal(e.x, a.x));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.y, a.y));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.z, a.z));
+  }
+
+  radiant_point3_soa_destroy(in);
+  radiant_point3_soa_destroy(out);
+  return true;
+}
+
+static bool point3_lerp() {
+  radiant_point3_soa_t a = random_points(kCount);
+  radiant_point3_soa_t b = random_points(kCount);
+  radiant_point3_soa_t out = radiant_point3_soa_create(kCount);
+
+  radiant_point3_soa_lerp(a, b, 0.3f, out);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_point3_t e = radiant_point3_lerp(radiant_point3_soa_get(a, i),
+                                             radiant_point3_soa_get(b, i),
+                                             0.3f);
+    radiant_point3_t r = radiant_point3_soa_get(out, i);
+    RADIANT_EXPECT_TRUE(nearly_equal(e.x, r.x));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.y, r.y));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.z, r.z));
+  }
+
+  radiant_point3_soa_destroy(a);
+  radiant_point3_soa_destroy(b);
+  radiant_point3_soa_destroy(out);
+  return true;
+}
+
+static bool vec3_transform() {
+  radiant_mat4x4_t m = random_mat4x4();
+  radiant_vec3_soa_t in = random_vecs(kCount);
+  radiant_vec3_soa_t out = radiant_vec3_soa_create(kCount);
+
+  radiant_vec3_soa_transform(m, in, out);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_vec3_t e = radiant_mat4x4_mul_vec3(m, radiant_vec3_soa_get(in, i));
+    radiant_vec3_t a = radiant_vec3_soa_get(out, i);
+    RADIANT_EXPECT_TRUE(nearly_equal(e.x, a.x));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.y, a.y));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.z, a.z));
+  }
+
+  radiant_vec3_soa_destroy(in);
+  radiant_vec3_soa_destroy(out);
+  return true;
+}
+
+static bool vec3_normalize() {
+  radiant_vec3_soa_t in = random_vecs(kCount);
+  radiant_vec3_soa_t out = radiant_vec3_soa_create(kCount);
+  // Zero length in both the vector body and the remainder
+  radiant_vec3_soa_set(in, 1, (radiant_vec3_t){0.f, 0.f, 0.f});
+  radiant_vec3_soa_set(in, kCount - 1, (radiant_vec3_t){0.f, 0.f, 0.f});
+
+  radiant_vec3_soa_normalize(in, out);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_vec3_t e = radiant_vec3_normalize(radiant_vec3_soa_get(in, i));
+    radiant_vec3_t a = radiant_vec3_soa_get(out, i);
+    RADIANT_EXPECT_FLOAT_EQ(e.x, a.x);
+    RADIANT_EXPECT_FLOAT_EQ(e.y, a.y);
+    RADIANT_EXPECT_FLOAT_EQ(e.z, a.z);
+  }
+
+  radiant_vec3_soa_destroy(in);
+  radiant_vec3_soa_destroy(out);
+  return true;
+}
+
+static bool vec3_dot_cross() {
+  radiant_vec3_soa_t a = random_vecs(kCount);
+  radiant_vec3_soa_t b = random_vecs(kCount);
+  radiant_vec3_soa_t cross = radiant_vec3_soa_create(kCount);
+  float* dot = (float*)malloc(kCount * sizeof(float));
+  RADIANT_EXPECT_NOT_NULL(dot);
+
+  radiant_vec3_soa_dot(a, b, dot);
+  radiant_vec3_soa_cross(a, b, cross);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_vec3_t va = radiant_vec3_soa_get(a, i);
+    radiant_vec3_t vb = radiant_vec3_soa_get(b, i);
+    RADIANT_EXPECT_TRUE(nearly_equal(radiant_vec3_dot(va, vb), dot[i]));
+
+    radiant_vec3_t e = radiant_vec3_cross(va, vb);
+    radiant_vec3_t c = radiant_vec3_soa_get(cross, i);
+    RADIANT_EXPECT_TRUE(nearly_equal(e.x, c.x));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.y, c.y));
+    RADIANT_EXPECT_TRUE(nearly_equal(e.z, c.z));
+  }
+
+  // Output aliasing an input
+  radiant_vec3_soa_cross(a, b, a);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    radiant_vec3_t e = radiant_vec3_soa_get(cross, i);
+    radiant_vec3_t c = radiant_vec3_soa_get(a, i);
+    RADIANT_EXPECT_FLOAT_EQ(e.x, c.x);
+    RADIANT_EXPECT_FLOAT_EQ(e.y, c.y);
+    RADIANT_EXPECT_FLOAT_EQ(e.z, c.z);
+  }
+
+  free(dot);
+  radiant_vec3_soa_destroy(a);
+  radiant_vec3_soa_destroy(b);
+  radiant_vec3_soa_destroy(cross);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("soa");
+  RADIANT_TEST(create);
+  RADIANT_TEST_ALL_BACKENDS(point3_transform);
+  RADIANT_TEST_ALL_BACKENDS(point3_transform_affine);
+  RADIANT_TEST_ALL_BACKENDS(point3_lerp);
+  RADIANT_TEST_ALL_BACKENDS(vec3_transform);
+  RADIANT_TEST_ALL_BACKENDS(vec3_normalize);
+  RADIANT_TEST_ALL_BACKENDS(vec3_dot_cross);
+  return radiant_suite_end();
+}
@@ -14,6 +14,8 @@
 
 #include "src/test.h"
 
+#include "src/simd.h"
+
 static bool suite_passed = true;
 
 void radiant_suite_begin(const char* name) {
@@ -24,13 +26,35 @@ int radiant_suite_end() {
   return suite_passed ? 0 : 1;
 }
 
-void radiant_run_test(radiant_test_t test, const char* name) {
-  printf("Running %s ... ", name);
-  fflush(stdout);
-
+static void run(radiant_test_t test) {
   if (!test()) {
     suite_passed = false;
   } else {
     printf(RADIANT_GREEN "PASSED" RADIANT_RESET "\n");
   }
 }
+
+void radiant_run_test(radiant_test_t test, const char* name) {
+  printf("Running %s ... ", name);
+  fflush(stdout);
+
+  run(test);
+}
+
+void radiant_run_test_all_backends(radiant_test_t test, const char* name) {
+  radiant_simd_backend_t original = radiant_simd_backend();
+
+  for (uint32_t i = 0; i < radiant_simd_backend_count; ++i) {
+    radiant_simd_backend_t backend = (radiant_simd_backend_t)i;
+    if (!radiant_simd_set_backend(backend)) {
+      continue;
+    }
+
+    printf("Running %s [%s] ... ", name, radiant_simd_backend_name(backend));
+    fflush(stdout);
+
+    run(test);
+  }
+
+  radiant_simd_set_backend(original);
+}
@@ -34,6 +34,13 @@ typedef bool (*radiant_test_t)(void);
 /// Runs |test| with |name|
 void radiant_run_test(radiant_test_t test, const char* name);
 
+/// Runs the |name| test once for each SIMD backend supported by the CPU
+#define RADIANT_TEST_ALL_BACKENDS(name) \
+  radiant_run_test_all_backends(name, #name)
+
+/// Runs |test| with |name| once for each supported SIMD backend
+void radiant_run_test_all_backends(radiant_test_t test, const char* name);
+
 /// ANSI escape red
 #define RADIANT_RED "\033[0;31m"
 /// ANSI escape gree
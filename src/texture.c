@@ -17,7 +17,8 @@
 radiant_texture_t radiant_texture_create(radiant_texture_create_request_t req) {
   WGPUTextureDescriptor texture_desc = {
       .label = req.label,
-      .usage = WGPUTextureUsage_RenderAttachment,
+      .usage =
+          req.usage != 0 ? req.usage : WGPUTextureUsage_RenderAttachment,
       .dimension = WGPUTextureDimension_2D,
       .format = req.format,
       .size =
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include "src/engine.h"
+#include "src/pad.h"
 #include "src/size.h"
 #include "src/wgpu.h"
 
@@ -26,6 +27,10 @@ typedef struct radiant_texture_create_request_t {
   radiant_size_t size;
   uint32_t samples;
   WGPUTextureFormat format;
+  /// The texture usage, zero for a render attachment
+  WGPUTextureUsageFlags usage;
+  /// Unused padding
+  RADIANT_PAD(4);
 } radiant_texture_create_request_t;
 
 typedef struct radiant_texture_t {
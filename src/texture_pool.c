@@ -0,0 +1,79 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/texture_pool.h"
+
+#include <string.h>
+
+/// Returns what |req| creates, with the defaults of radiant_texture_create
+/// filled in.
+static radiant_texture_pool_entry_t entry_for(
+    radiant_texture_t texture,
+    radiant_texture_create_request_t req) {
+  return (radiant_texture_pool_entry_t){
+      .texture = texture,
+      .size = req.size,
+      .samples = req.samples > 0 ? req.samples : 1,
+      .format = req.format,
+      .usage = req.usage != 0 ? req.usage : WGPUTextureUsage_RenderAttachment,
+  };
+}
+
+static bool matches(const radiant_texture_pool_entry_t* a,
+                    const radiant_texture_pool_entry_t* b) {
+  return a->size.width == b->size.width && a->size.height == b->size.height &&
+         a->samples == b->samples && a->format == b->format &&
+         a->usage == b->usage;
+}
+
+/// Removes entry |idx| from |pool|, keeping the rest oldest first.
+static void remove_entry(radiant_texture_pool_t* pool, uint32_t idx) {
+  memmove(&pool->entries[idx], &pool->entries[idx + 1],
+          (pool->count - idx - 1) * sizeof(radiant_texture_pool_entry_t));
+  --pool->count;
+}
+
+radiant_texture_t radiant_texture_pool_acquire(
+    radiant_texture_pool_t* pool,
+    radiant_texture_create_request_t req) {
+  radiant_texture_pool_entry_t wanted = entry_for((radiant_texture_t){0}, req);
+  // The newest match, the likeliest to still be resident.
+  for (uint32_t i = pool->count; i > 0; --i) {
+    if (matches(&pool->entries[i - 1], &wanted)) {
+      radiant_texture_t texture = pool->entries[i - 1].texture;
+      remove_entry(pool, i - 1);
+      ++pool->reused;
+      return texture;
+    }
+  }
+  ++pool->created;
+  return radiant_texture_create(req);
+}
+
+void radiant_texture_pool_release(radiant_texture_pool_t* pool,
+                                  radiant_texture_t texture,
+                                  radiant_texture_create_request_t req) {
+  if (pool->count == RADIANT_TEXTURE_POOL_CAPACITY) {
+    radiant_texture_destroy(pool->entries[0].texture);
+    remove_entry(pool, 0);
+  }
+  pool->entries[pool->count++] = entry_for(texture, req);
+}
+
+void radiant_texture_pool_destroy(radiant_texture_pool_t* pool) {
+  for (uint32_t i = 0; i < pool->count; ++i) {
+    radiant_texture_destroy(pool->entries[i].texture);
+  }
+  pool->count = 0;
+}
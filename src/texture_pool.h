@@ -0,0 +1,64 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "src/texture.h"
+
+/// The most textures a pool keeps for reuse.
+#define RADIANT_TEXTURE_POOL_CAPACITY 8
+
+/// @private
+/// A texture waiting in a pool, with what it was created for.
+typedef struct radiant_texture_pool_entry_t {
+  radiant_texture_t texture;
+  radiant_size_t size;
+  uint32_t samples;
+  WGPUTextureFormat format;
+  WGPUTextureUsageFlags usage;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_texture_pool_entry_t;
+
+/// Textures released for reuse, so size dependent attachments can be swapped
+/// on a resize without allocating again when a size comes back.
+typedef struct radiant_texture_pool_t {
+  /// The released textures, oldest first
+  radiant_texture_pool_entry_t entries[RADIANT_TEXTURE_POOL_CAPACITY];
+  uint32_t count;
+  /// Textures created by radiant_texture_pool_acquire
+  uint32_t created;
+  /// Textures radiant_texture_pool_acquire took from the pool
+  uint32_t reused;
+  /// Unused padding
+  RADIANT_PAD(4);
+} radiant_texture_pool_t;
+
+/// Returns a texture as radiant_texture_create would for |req|, reusing a
+/// released one of the same size, format, sample count and usage if there is
+/// one. The label of a reused texture is that it was created with.
+radiant_texture_t radiant_texture_pool_acquire(
+    radiant_texture_pool_t* pool,
+    radiant_texture_create_request_t req);
+
+/// Gives |texture|, created for |req|, back to |pool| for reuse. Destroys the
+/// oldest texture in the pool if it is full.
+void radiant_texture_pool_release(radiant_texture_pool_t* pool,
+                                  radiant_texture_t texture,
+                                  radiant_texture_create_request_t req);
+
+/// Destroys the textures in |pool|.
+void radiant_texture_pool_destroy(radiant_texture_pool_t* pool);
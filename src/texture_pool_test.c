@@ -0,0 +1,118 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/texture_pool.h"
+
+#include <stdio.h>
+
+#include "src/test.h"
+
+static radiant_engine_t engine;
+
+static radiant_texture_create_request_t request(uint32_t width,
+                                                uint32_t height) {
+  return (radiant_texture_create_request_t){
+      .engine = engine,
+      .label = "Pooled texture",
+      .format = WGPUTextureFormat_BGRA8Unorm,
+      .size = {.width = width, .height = height},
+  };
+}
+
+/// A released texture comes back for the same request and no other.
+static bool reuses_matching() {
+  radiant_texture_pool_t pool = {0};
+  radiant_texture_t small =
+      radiant_texture_pool_acquire(&pool, request(64, 32));
+  RADIANT_EXPECT_EQ(pool.created, 1);
+  radiant_texture_pool_release(&pool, small, request(64, 32));
+  RADIANT_EXPECT_EQ(pool.count, 1);
+
+  radiant_texture_t large =
+      radiant_texture_pool_acquire(&pool, request(128, 64));
+  RADIANT_EXPECT_EQ(pool.created, 2);
+  RADIANT_EXPECT_EQ(pool.reused, 0);
+
+  radiant_texture_create_request_t multisampled = request(64, 32);
+  multisampled.samples = 4;
+  radiant_texture_t other = radiant_texture_pool_acquire(&pool, multisampled);
+  RADIANT_EXPECT_EQ(pool.created, 3);
+
+  // Defaults match their explicit values.
+  radiant_texture_create_request_t explicit_req = request(64, 32);
+  explicit_req.samples = 1;
+  explicit_req.usage = WGPUTextureUsage_RenderAttachment;
+  radiant_texture_t reused = radiant_texture_pool_acquire(&pool, explicit_req);
+  RADIANT_EXPECT_TRUE(reused.texture == small.texture);
+  RADIANT_EXPECT_EQ(pool.reused, 1);
+  RADIANT_EXPECT_EQ(pool.count, 0);
+
+  radiant_texture_destroy(reused);
+  radiant_texture_destroy(other);
+  radiant_texture_destroy(large);
+  radiant_texture_pool_destroy(&pool);
+  return true;
+}
+
+/// Releasing into a full pool destroys the oldest texture.
+static bool evicts_oldest() {
+  radiant_texture_pool_t pool = {0};
+  radiant_texture_t textures[RADIANT_TEXTURE_POOL_CAPACITY + 1];
+  for (uint32_t i = 0; i < RADIANT_TEXTURE_POOL_CAPACITY + 1; ++i) {
+    textures[i] = radiant_texture_pool_acquire(&pool, request(16 + i, 16));
+  }
+  for (uint32_t i = 0; i < RADIANT_TEXTURE_POOL_CAPACITY + 1; ++i) {
+    radiant_texture_pool_release(&pool, textures[i], request(16 + i, 16));
+  }
+  RADIANT_EXPECT_EQ(pool.count, RADIANT_TEXTURE_POOL_CAPACITY);
+  RADIANT_EXPECT_TRUE(pool.entries[0].texture.texture ==
+                      textures[1].texture);
+
+  // The evicted size is created again, the newest is reused.
+  radiant_texture_t first =
+      radiant_texture_pool_acquire(&pool, request(16, 16));
+  RADIANT_EXPECT_FALSE(first.texture == textures[0].texture);
+  radiant_texture_t last = radiant_texture_pool_acquire(
+      &pool, request(16 + RADIANT_TEXTURE_POOL_CAPACITY, 16));
+  RADIANT_EXPECT_TRUE(last.texture ==
+                      textures[RADIANT_TEXTURE_POOL_CAPACITY].texture);
+
+  radiant_texture_destroy(first);
+  radiant_texture_destroy(last);
+  radiant_texture_pool_destroy(&pool);
+  RADIANT_EXPECT_EQ(pool.count, 0);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("texture_pool");
+
+  radiant_engine_create_result_t engine_result =
+      radiant_engine_create_headless((radiant_engine_headless_create_request_t){
+          .adapter = {.policy = radiant_adapter_policy_software},
+          .size = {.width = 16, .height = 16},
+          .format = WGPUTextureFormat_BGRA8Unorm,
+      });
+  if (!engine_result.succeeded) {
+    printf("No software adapter, skipping\n");
+    return radiant_suite_end();
+  }
+  engine = engine_result.engine;
+
+  RADIANT_TEST(reuses_matching);
+  RADIANT_TEST(evicts_oldest);
+
+  radiant_engine_destroy(engine);
+  return radiant_suite_end();
+}
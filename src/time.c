@@ -14,9 +14,11 @@
 
 #include "src/time.h"
 
+#include <errno.h>
 #include <time.h>
 
 static const double NS_TO_MS = 1.0 / 1000000.0;
+static const uint64_t NS_PER_S = 1000000000u;
 
 radiant_time_diff_t radiant_time_sub(radiant_time_t mark1,
                                      radiant_time_t mark2) {
@@ -26,3 +28,13 @@ radiant_time_diff_t radiant_time_sub(radiant_time_t mark1,
 double radiant_time_diff_to_ms(radiant_time_diff_t diff) {
   return NS_TO_MS * (double)diff;
 }
+
+void radiant_time_sleep(radiant_time_diff_t diff) {
+  struct timespec remaining = {
+      .tv_sec = (time_t)(diff / NS_PER_S),
+      .tv_nsec = (long)(diff % NS_PER_S),
+  };
+  // Signals cut the sleep short, sleep what is left.
+  while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) {
+  }
+}
@@ -33,3 +33,6 @@ radiant_time_diff_t radiant_time_sub(radiant_time_t mark1,
 
 /// Returns the number of milliseconds represented by the given |diff|.
 double radiant_time_diff_to_ms(radiant_time_diff_t diff);
+
+/// Suspends the calling thread for at least |diff|.
+void radiant_time_sleep(radiant_time_diff_t diff);
@@ -31,9 +31,18 @@ static bool to_ms() {
   return true;
 }
 
+static bool sleep() {
+  radiant_time_t begin = radiant_time();
+  radiant_time_sleep(1000000);
+  radiant_time_diff_t slept = radiant_time_sub(begin, radiant_time());
+  RADIANT_EXPECT_TRUE(radiant_time_diff_to_ms(slept) >= 1.0);
+  return true;
+}
+
 int main() {
   radiant_suite_begin("time");
   RADIANT_TEST(sub);
   RADIANT_TEST(to_ms);
+  RADIANT_TEST(sleep);
   return radiant_suite_end();
 }
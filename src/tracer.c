@@ -0,0 +1,333 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/tracer.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/angle.h"
+#include "src/assert.h"
+#include "src/constants.h"
+#include "src/job.h"
+
+/// Surfaces are diffuse, albedo / pi is their BRDF.
+static const float kInvPi = 1.f / RADIANT_PI;
+
+/// One call of radiant_tracer_render, shared by the tile jobs.
+typedef struct pass_t {
+  radiant_tracer_t* tracer;
+  uint32_t samples;
+  uint32_t tiles_x;
+} pass_t;
+
+static radiant_colour3_t colour_add(radiant_colour3_t a, radiant_colour3_t b) {
+  return (radiant_colour3_t){a.r + b.r, a.g + b.g, a.b + b.b};
+}
+
+static radiant_colour3_t colour_mul(radiant_colour3_t a, radiant_colour3_t b) {
+  return (radiant_colour3_t){a.r * b.r, a.g * b.g, a.b * b.b};
+}
+
+static radiant_colour3_t colour_scale(radiant_colour3_t a, float s) {
+  return (radiant_colour3_t){a.r * s, a.g * s, a.b * s};
+}
+
+/// Returns a well mixed hash of |x| (the PCG output permutation).
+static uint32_t hash(uint32_t x) {
+  uint32_t state = (x * 747796405u) + 2891336453u;
+  uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+/// Returns the next float in [0, 1) from the generator |state|.
+static float random_float(uint32_t* state) {
+  *state = hash(*state);
+  return (float)(*state >> 8) * 0x1p-24f;
+}
+
+static radiant_point3_t mesh_position(const radiant_bvh_mesh_t* mesh,
+                                      uint32_t vertex) {
+  radiant_point3_t p;
+  memcpy(&p, (const uint8_t*)mesh->vertices + (vertex * mesh->vertex_stride),
+         sizeof(p));
+  return p;
+}
+
+static radiant_colour3_t mesh_colour(const radiant_tracer_t* tracer,
+                                     uint32_t vertex) {
+  radiant_colour3_t c;
+  memcpy(&c,
+         (const uint8_t*)tracer->mesh.vertices +
+             (vertex * tracer->mesh.vertex_stride) + tracer->colour_offset,
+         sizeof(c));
+  return c;
+}
+
+static uint32_t mesh_index(const radiant_bvh_mesh_t* mesh, uint32_t i) {
+  if (mesh->index_format == radiant_bvh_index_format_uint16) {
+    return ((const uint16_t*)mesh->indices)[i];
+  }
+  return ((const uint32_t*)mesh->indices)[i];
+}
+
+static radiant_colour3_t sky(const radiant_tracer_lighting_t* lighting,
+                             radiant_vec3_t direction) {
+  float height = fmaxf(direction.y, 0.f);
+  return colour_add(
+      colour_scale(lighting->sky_horizon, 1.f - height),
+      colour_scale(lighting->sky_zenith, height));
+}
+
+/// Returns a direction about |n| with a density proportional to the cosine
+/// of its angle to |n|, so a diffuse bounce is weighted by its albedo alone.
+static radiant_vec3_t cosine_direction(radiant_vec3_t n, uint32_t* state) {
+  // Orthonormal basis from "Building an Orthonormal Basis, Revisited".
+  float sign = copysignf(1.f, n.z);
+  float a = -1.f / (sign + n.z);
+  float b = n.x * n.y * a;
+  radiant_vec3_t t = {1.f + (sign * n.x * n.x * a), sign * b, -sign * n.x};
+  radiant_vec3_t s = {b, sign + (n.y * n.y * a), -n.y};
+
+  float u1 = random_float(state);
+  float r = sqrtf(u1);
+  radiant_sincos_t sc = radiant_sincos(2.f * RADIANT_PI * random_float(state));
+  float x = r * sc.cos;
+  float y = r * sc.sin;
+  float z = sqrtf(fmaxf(1.f - u1, 0.f));
+  return (radiant_vec3_t){
+      (t.x * x) + (s.x * y) + (n.x * z),
+      (t.y * x) + (s.y * y) + (n.y * z),
+      (t.z * x) + (s.z * y) + (n.z * z),
+  };
+}
+
+/// Returns the radiance arriving along |ray|.
+static radiant_colour3_t trace_path(const radiant_tracer_t* tracer,
+                                    radiant_ray_t ray,
+                                    uint32_t* state) {
+  const radiant_tracer_lighting_t* lighting = &tracer->lighting;
+  radiant_vec3_t sun = radiant_vec3_normalize(lighting->sun_direction);
+  bool has_sun = lighting->sun_colour.r > 0.f ||
+                 lighting->sun_colour.g > 0.f || lighting->sun_colour.b > 0.f;
+
+  radiant_colour3_t radiance = {0.f, 0.f, 0.f};
+  radiant_colour3_t throughput = {1.f, 1.f, 1.f};
+  for (uint32_t bounce = 0;; ++bounce) {
+    radiant_ray_triangle_hit_t hit =
+        radiant_bvh_wide_intersect(&tracer->wide, ray);
+    if (!hit.hit) {
+      radiant_colour3_t light = sky(lighting, ray.direction);
+      radiance = colour_add(radiance, colour_mul(throughput, light));
+      break;
+    }
+
+    uint32_t i0 = mesh_index(&tracer->mesh, 3 * hit.index);
+    uint32_t i1 = mesh_index(&tracer->mesh, (3 * hit.index) + 1);
+    uint32_t i2 = mesh_index(&tracer->mesh, (3 * hit.index) + 2);
+    radiant_point3_t p0 = mesh_position(&tracer->mesh, i0);
+    radiant_vec3_t n = radiant_vec3_normalize(radiant_vec3_cross(
+        radiant_point3_sub_point(mesh_position(&tracer->mesh, i1), p0),
+        radiant_point3_sub_point(mesh_position(&tracer->mesh, i2), p0)));
+    if (radiant_vec3_dot(n, ray.direction) > 0.f) {
+      n = radiant_vec3_negate(n);
+    }
+
+    radiant_colour3_t albedo = tracer->albedo;
+    if (tracer->colour_offset != RADIANT_TRACER_NO_COLOUR) {
+      float w = 1.f - hit.u - hit.v;
+      albedo = colour_add(
+          colour_add(colour_scale(mesh_colour(tracer, i0), w),
+                     colour_scale(mesh_colour(tracer, i1), hit.u)),
+          colour_scale(mesh_colour(tracer, i2), hit.v));
+    }
+
+    // Lift the next rays off the surface so they do not hit it again.
+    radiant_point3_t p = radiant_ray_at(ray, hit.t);
+    float scale = fmaxf(fmaxf(fabsf(p.x), fabsf(p.y)), fabsf(p.z));
+    radiant_point3_t origin = radiant_point3_add(
+        p, radiant_vec3_mul_scalar(n, 1e-4f * (1.f + scale)));
+
+    float cos_sun = radiant_vec3_dot(n, sun);
+    if (has_sun && cos_sun > 0.f) {
+      radiant_ray_t shadow = {
+          .origin = origin,
+          .direction = sun,
+          .t_max = INFINITY,
+      };
+      if (!radiant_bvh_wide_occluded(&tracer->wide, shadow)) {
+        radiant_colour3_t direct = colour_scale(
+            colour_mul(albedo, lighting->sun_colour), cos_sun * kInvPi);
+        radiance = colour_add(radiance, colour_mul(throughput, direct));
+      }
+    }
+
+    if (bounce == tracer->max_bounces) {
+      break;
+    }
+    throughput = colour_mul(throughput, albedo);
+    ray = (radiant_ray_t){
+        .origin = origin,
+        .direction = cosine_direction(n, state),
+        .t_max = INFINITY,
+    };
+  }
+  return radiance;
+}
+
+/// Returns the primary ray through |x|, |y| in pixels from the top left.
+static radiant_ray_t camera_ray(const radiant_tracer_t* tracer,
+                                float x,
+                                float y) {
+  // Any depth between the planes lies on the ray, halfway suits both depth
+  // ranges.
+  radiant_point3_t ndc = {
+      ((x / (float)tracer->width) * 2.f) - 1.f,
+      1.f - ((y / (float)tracer->height) * 2.f),
+      0.5f,
+  };
+  radiant_point3_t p =
+      radiant_mat4x4_mul_point3(tracer->inverse_projection_view, ndc);
+  return (radiant_ray_t){
+      .origin = tracer->eye,
+      .direction =
+          radiant_vec3_normalize(radiant_point3_sub_point(p, tracer->eye)),
+      .t_max = INFINITY,
+  };
+}
+
+static void render_tile(void* userdata, uint32_t index) {
+  const pass_t* pass = (const pass_t*)userdata;
+  radiant_tracer_t* tracer = pass->tracer;
+  uint32_t x0 = (index % pass->tiles_x) * RADIANT_TRACER_TILE_SIZE;
+  uint32_t y0 = (index / pass->tiles_x) * RADIANT_TRACER_TILE_SIZE;
+  uint32_t x1 = x0 + RADIANT_TRACER_TILE_SIZE;
+  uint32_t y1 = y0 + RADIANT_TRACER_TILE_SIZE;
+  x1 = x1 < tracer->width ? x1 : tracer->width;
+  y1 = y1 < tracer->height ? y1 : tracer->height;
+
+  for (uint32_t y = y0; y < y1; ++y) {
+    for (uint32_t x = x0; x < x1; ++x) {
+      uint32_t pixel = (y * tracer->width) + x;
+      float* out = tracer->accumulation + (3 * pixel);
+      for (uint32_t s = 0; s < pass->samples; ++s) {
+        uint32_t state = hash(pixel ^ hash(tracer->sample_count + s));
+        radiant_ray_t ray = camera_ray(tracer, (float)x + random_float(&state),
+                                       (float)y + random_float(&state));
+        radiant_colour3_t c = trace_path(tracer, ray, &state);
+        out[0] += c.r;
+        out[1] += c.g;
+        out[2] += c.b;
+      }
+    }
+  }
+}
+
+radiant_tracer_create_result_t radiant_tracer_create(
+    radiant_tracer_create_request_t req) {
+  if (req.width == 0 || req.height == 0) {
+    return (radiant_tracer_create_result_t){0};
+  }
+
+  radiant_tracer_t tracer = {
+      .width = req.width,
+      .height = req.height,
+      .max_bounces = req.max_bounces,
+      .thread_count = req.thread_count,
+      .colour_offset = req.colour_offset,
+      .mesh = req.mesh,
+      .albedo = req.albedo,
+      .lighting = req.lighting,
+  };
+  if (!radiant_tracer_set_camera(&tracer, &req.camera)) {
+    return (radiant_tracer_create_result_t){0};
+  }
+
+  tracer.accumulation = (float*)calloc(
+      (size_t)req.width * req.height * 3, sizeof(float));
+  tracer.bvh = radiant_bvh_build((radiant_bvh_build_request_t){
+      .mesh = req.mesh,
+      .thread_count = req.thread_count,
+  });
+  tracer.wide = radiant_bvh_wide_collapse(&tracer.bvh, 8);
+  if (!tracer.accumulation ||
+      (req.mesh.triangle_count > 0 && tracer.wide.node_count == 0)) {
+    radiant_tracer_destroy(tracer);
+    return (radiant_tracer_create_result_t){0};
+  }
+  return (radiant_tracer_create_result_t){
+      .tracer = tracer,
+      .succeeded = true,
+  };
+}
+
+void radiant_tracer_destroy(radiant_tracer_t tracer) {
+  radiant_bvh_wide_destroy(tracer.wide);
+  radiant_bvh_destroy(tracer.bvh);
+  free(tracer.accumulation);
+}
+
+bool radiant_tracer_set_camera(radiant_tracer_t* tracer,
+                               radiant_camera_t* camera) {
+  RADIANT_ASSERT(tracer);
+  RADIANT_ASSERT(camera);
+  radiant_mat4x4_inverse_result_t inverse =
+      radiant_camera_inverse_projection_view_matrix(camera);
+  if (!inverse.succeeded) {
+    return false;
+  }
+  tracer->inverse_projection_view = inverse.inverse;
+  tracer->eye = radiant_camera_position(camera);
+  radiant_tracer_reset(tracer);
+  return true;
+}
+
+void radiant_tracer_reset(radiant_tracer_t* tracer) {
+  RADIANT_ASSERT(tracer);
+  if (tracer->accumulation) {
+    memset(tracer->accumulation, 0,
+           (size_t)tracer->width * tracer->height * 3 * sizeof(float));
+  }
+  tracer->sample_count = 0;
+}
+
+void radiant_tracer_render(radiant_tracer_t* tracer, uint32_t samples) {
+  RADIANT_ASSERT(tracer);
+  pass_t pass = {
+      .tracer = tracer,
+      .samples = samples,
+      .tiles_x = (tracer->width + RADIANT_TRACER_TILE_SIZE - 1) /
+                 RADIANT_TRACER_TILE_SIZE,
+  };
+  uint32_t tiles_y = (tracer->height + RADIANT_TRACER_TILE_SIZE - 1) /
+                     RADIANT_TRACER_TILE_SIZE;
+  radiant_job_parallel_for(pass.tiles_x * tiles_y, tracer->thread_count,
+                           render_tile, &pass);
+  tracer->sample_count += samples;
+}
+
+void radiant_tracer_resolve(const radiant_tracer_t* tracer, float* out) {
+  RADIANT_ASSERT(tracer);
+  RADIANT_ASSERT(out);
+  float scale =
+      tracer->sample_count > 0 ? 1.f / (float)tracer->sample_count : 0.f;
+  uint32_t pixels = tracer->width * tracer->height;
+  for (uint32_t i = 0; i < pixels; ++i) {
+    out[(4 * i) + 0] = tracer->accumulation[(3 * i) + 0] * scale;
+    out[(4 * i) + 1] = tracer->accumulation[(3 * i) + 1] * scale;
+    out[(4 * i) + 2] = tracer->accumulation[(3 * i) + 2] * scale;
+    out[(4 * i) + 3] = 1.f;
+  }
+}
@@ -0,0 +1,144 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "src/bvh.h"
+#include "src/bvh_wide.h"
+#include "src/camera.h"
+#include "src/colour3.h"
+#include "src/mat4x4.h"
+#include "src/pad.h"
+#include "src/point3.h"
+#include "src/vec3.h"
+
+/// Pixels per side of the square tiles a frame is split into, each tile is
+/// rendered by one thread.
+#define RADIANT_TRACER_TILE_SIZE 16
+
+/// A |colour_offset| for meshes without vertex colours.
+#define RADIANT_TRACER_NO_COLOUR UINT32_MAX
+
+/// The light falling on the scene of a radiant_tracer_t. Up is +y.
+typedef struct radiant_tracer_lighting_t {
+  /// The radiance of the sky straight up
+  radiant_colour3_t sky_zenith;
+  /// The radiance of the sky at and below the horizon, blended into
+  /// |sky_zenith| with height
+  radiant_colour3_t sky_horizon;
+  /// The direction towards the sun, not necessarily normalized
+  radiant_vec3_t sun_direction;
+  /// The irradiance of the sun on a surface facing it, black for no sun
+  radiant_colour3_t sun_colour;
+} radiant_tracer_lighting_t;
+
+/// A CPU path tracer. Surfaces are diffuse, lit by the sky and the sun,
+/// and every pixel converges to the same image whatever the thread count.
+typedef struct radiant_tracer_t {
+  /// The summed radiance of every sample so far, three floats per pixel in
+  /// rows from the top left
+  float* accumulation;
+  /// The width of the frame in pixels
+  uint32_t width;
+  /// The height of the frame in pixels
+  uint32_t height;
+  /// The samples per pixel summed into |accumulation|
+  uint32_t sample_count;
+  /// The most times a path bounces before it is cut off
+  uint32_t max_bounces;
+  /// The threads to render with, zero uses every processor
+  uint32_t thread_count;
+  /// The byte offset of the vertex colours, or RADIANT_TRACER_NO_COLOUR
+  uint32_t colour_offset;
+  /// The scene, the arrays are borrowed from the create request
+  radiant_bvh_mesh_t mesh;
+  /// The hierarchy over |mesh|
+  radiant_bvh_t bvh;
+  /// |bvh| collapsed for traversal
+  radiant_bvh_wide_t wide;
+  /// Maps normalized device coordinates back into the world
+  radiant_mat4x4_t inverse_projection_view;
+  /// Where the camera is, every primary ray starts here
+  radiant_point3_t eye;
+  /// The colour of surfaces without vertex colours
+  radiant_colour3_t albedo;
+  /// The light falling on the scene
+  radiant_tracer_lighting_t lighting;
+} radiant_tracer_t;
+
+/// Structure for requesting a tracer.
+typedef struct radiant_tracer_create_request_t {
+  /// The triangles to render, in the layout uploaded for rasterizing. The
+  /// vertex and index arrays must outlive the tracer.
+  radiant_bvh_mesh_t mesh;
+  /// The byte offset of a radiant_colour3_t in each vertex, the colour of
+  /// the surface, or RADIANT_TRACER_NO_COLOUR to use |albedo| everywhere
+  uint32_t colour_offset;
+  /// The colour of surfaces if the mesh has no vertex colours
+  radiant_colour3_t albedo;
+  /// The light falling on the scene
+  radiant_tracer_lighting_t lighting;
+  /// The camera the scene is seen from, as for rasterizing
+  radiant_camera_t camera;
+  /// The width of the frame in pixels
+  uint32_t width;
+  /// The height of the frame in pixels
+  uint32_t height;
+  /// The most times a path bounces, zero only sees direct light
+  uint32_t max_bounces;
+  /// The threads to build and render with, zero uses every processor
+  uint32_t thread_count;
+} radiant_tracer_create_request_t;
+
+/// Results of creating a tracer
+typedef struct radiant_tracer_create_result_t {
+  /// The tracer. Only valid if |succeeded| is true.
+  radiant_tracer_t tracer;
+  /// True if the tracer was successfully created. False otherwise.
+  bool succeeded;
+  /// Unused padding
+  RADIANT_PAD(7);
+} radiant_tracer_create_result_t;
+
+/// Creates a tracer for |req|, building a BVH over the mesh. Fails if the
+/// frame is empty, the camera cannot be inverted or an allocation fails.
+radiant_tracer_create_result_t radiant_tracer_create(
+    radiant_tracer_create_request_t req);
+
+/// Destroys |tracer|.
+void radiant_tracer_destroy(radiant_tracer_t tracer);
+
+/// Moves the camera of |tracer| to |camera| and restarts the accumulation.
+/// Returns false, leaving the camera unchanged, if |camera| cannot be
+/// inverted.
+bool radiant_tracer_set_camera(radiant_tracer_t* tracer,
+                               radiant_camera_t* camera);
+
+/// Restarts the accumulation of |tracer|, for example after the mesh moved
+/// and the BVH was refit.
+void radiant_tracer_reset(radiant_tracer_t* tracer);
+
+/// Adds |samples| more samples to every pixel of |tracer|. The frame is
+/// split into tiles that are rendered in parallel. Each sample is seeded by
+/// its pixel and index, so rendering n samples and then m more gives the
+/// same image as rendering n + m at once.
+void radiant_tracer_render(radiant_tracer_t* tracer, uint32_t samples);
+
+/// Stores the mean of the samples of |tracer| into |out|, four floats per
+/// pixel as for a WGPUTextureFormat_RGBA32Float texture, alpha is one.
+/// |out| must hold |tracer->width| * |tracer->height| pixels.
+void radiant_tracer_resolve(const radiant_tracer_t* tracer, float* out);
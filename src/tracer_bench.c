@@ -0,0 +1,127 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Path traces a sunlit heightfield with increasing thread counts to show how
+// the tiled renderer scales. Throughput is in samples per second.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/bench.h"
+#include "src/constants.h"
+#include "src/job.h"
+#include "src/tracer.h"
+
+/// Cells per side of the heightfield, two triangles each.
+#define SIZE 128
+
+#define WIDTH 320
+#define HEIGHT 180
+
+static const uint32_t kVertexCount = (SIZE + 1) * (SIZE + 1);
+static const uint32_t kTriangleCount = 2 * SIZE * SIZE;
+static const uint32_t kSamples = 2;
+
+static void render(void* userdata) {
+  radiant_tracer_t* tracer = (radiant_tracer_t*)userdata;
+  radiant_tracer_render(tracer, kSamples);
+}
+
+int main() {
+  radiant_point3_t* vertices =
+      (radiant_point3_t*)malloc(kVertexCount * sizeof(radiant_point3_t));
+  uint32_t* indices = (uint32_t*)malloc(3 * kTriangleCount * sizeof(uint32_t));
+  if (!vertices || !indices) {
+    printf("Allocation failed\n");
+    return 1;
+  }
+  for (uint32_t z = 0; z <= SIZE; ++z) {
+    for (uint32_t x = 0; x <= SIZE; ++x) {
+      float fx = (float)x;
+      float fz = (float)z;
+      vertices[(z * (SIZE + 1)) + x] = (radiant_point3_t){
+          fx, sinf(fx * 0.1f) * cosf(fz * 0.07f) * 8.f, fz};
+    }
+  }
+  uint32_t i = 0;
+  for (uint32_t z = 0; z < SIZE; ++z) {
+    for (uint32_t x = 0; x < SIZE; ++x) {
+      uint32_t v = (z * (SIZE + 1)) + x;
+      uint32_t quad[6] = {v, v + 1, v + SIZE + 1, v + 1, v + SIZE + 2,
+                          v + SIZE + 1};
+      for (uint32_t k = 0; k < 6; ++k) {
+        indices[i++] = quad[k];
+      }
+    }
+  }
+
+  radiant_view_t view = {
+      .size = {.width = WIDTH, .height = HEIGHT},
+      .fov_y_radians = (2.f * RADIANT_PI) / 5.f,
+      .planes = {.near = 1.f, .far = 500.f},
+  };
+  radiant_tracer_create_request_t req = {
+      .mesh =
+          {
+              .vertices = vertices,
+              .indices = indices,
+              .vertex_stride = sizeof(radiant_point3_t),
+              .vertex_count = kVertexCount,
+              .triangle_count = kTriangleCount,
+              .index_format = radiant_bvh_index_format_uint32,
+          },
+      .colour_offset = RADIANT_TRACER_NO_COLOUR,
+      .albedo = {0.6f, 0.55f, 0.5f},
+      .lighting =
+          {
+              .sky_zenith = {0.3f, 0.5f, 1.f},
+              .sky_horizon = {0.8f, 0.85f, 0.9f},
+              .sun_direction = {0.4f, 1.f, 0.2f},
+              .sun_colour = {3.f, 2.9f, 2.7f},
+          },
+      .camera = radiant_camera_create((radiant_point3_t){-10.f, 30.f, -10.f},
+                                      (radiant_point3_t){64.f, 0.f, 64.f},
+                                      (radiant_vec3_t){0.f, 1.f, 0.f}, view),
+      .width = WIDTH,
+      .height = HEIGHT,
+      .max_bounces = 3,
+  };
+  radiant_tracer_create_result_t result = radiant_tracer_create(req);
+  if (!result.succeeded) {
+    printf("Creating the tracer failed\n");
+    return 1;
+  }
+
+  uint32_t processors = radiant_job_processor_count();
+  for (uint32_t threads = 1;; threads *= 2) {
+    if (threads > processors) {
+      threads = processors;
+    }
+    result.tracer.thread_count = threads;
+    char name[64];
+    snprintf(name, sizeof(name), "tracer_render [%u threads]", threads);
+    radiant_bench_run(name, render, &result.tracer, 3,
+                      WIDTH * HEIGHT * kSamples);
+    if (threads == processors) {
+      break;
+    }
+  }
+  printf("%u samples per pixel accumulated\n", result.tracer.sample_count);
+
+  radiant_tracer_destroy(result.tracer);
+  free(vertices);
+  free(indices);
+  return 0;
+}
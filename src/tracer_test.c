@@ -0,0 +1,235 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/tracer.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/constants.h"
+#include "src/test.h"
+
+/// The frame size, not a multiple of the tile size so edge tiles are
+/// partial.
+#define WIDTH 40
+#define HEIGHT 24
+
+typedef struct vertex_t {
+  radiant_point3_t position;
+  radiant_colour3_t colour;
+} vertex_t;
+
+/// A large ground plane at y = 0 followed by a small roof at y = 1 over
+/// x in [-1, 1] and z in [-2, 0].
+static const vertex_t kVertices[] = {
+    {{-1000.f, 0.f, -1000.f}, {1.f, 0.f, 0.f}},
+    {{1000.f, 0.f, -1000.f}, {1.f, 0.f, 0.f}},
+    {{-1000.f, 0.f, 1000.f}, {1.f, 0.f, 0.f}},
+    {{1000.f, 0.f, 1000.f}, {1.f, 0.f, 0.f}},
+    {{-1.f, 1.f, -2.f}, {0.f, 1.f, 0.f}},
+    {{1.f, 1.f, -2.f}, {0.f, 1.f, 0.f}},
+    {{-1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}},
+    {{1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}},
+};
+
+static const uint16_t kIndices[] = {0, 1, 2, 1, 3, 2, 4, 5, 6, 5, 7, 6};
+
+static radiant_tracer_create_request_t request(uint32_t triangle_count) {
+  radiant_view_t view = {
+      .size = {.width = WIDTH, .height = HEIGHT},
+      .fov_y_radians = (2.f * RADIANT_PI) / 5.f,
+      .planes = {.near = 1.f, .far = 100.f},
+  };
+  return (radiant_tracer_create_request_t){
+      .mesh =
+          {
+              .vertices = kVertices,
+              .indices = kIndices,
+              .vertex_stride = sizeof(vertex_t),
+              .vertex_count = 8,
+              .triangle_count = triangle_count,
+              .index_format = radiant_bvh_index_format_uint16,
+          },
+      .colour_offset = RADIANT_TRACER_NO_COLOUR,
+      .albedo = {0.5f, 0.5f, 0.5f},
+      .lighting =
+          {
+              .sky_zenith = {1.f, 1.f, 1.f},
+              .sky_horizon = {1.f, 1.f, 1.f},
+              .sun_direction = {0.f, 1.f, 0.f},
+          },
+      // Looking steeply down at the ground, every primary ray hits it.
+      .camera = radiant_camera_create((radiant_point3_t){0.f, 5.f, 0.f},
+                                      (radiant_point3_t){0.f, 0.f, -1.f},
+                                      (radiant_vec3_t){0.f, 1.f, 0.f}, view),
+      .width = WIDTH,
+      .height = HEIGHT,
+      .max_bounces = 2,
+      .thread_count = 1,
+  };
+}
+
+/// Checks every pixel of |tracer| resolves to |expected|.
+static bool every_pixel(const radiant_tracer_t* tracer,
+                        radiant_colour3_t expected) {
+  float* pixels = (float*)malloc(WIDTH * HEIGHT * 4 * sizeof(float));
+  radiant_tracer_resolve(tracer, pixels);
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i) {
+    RADIANT_EXPECT_FLOAT_EQ(pixels[(4 * i) + 0], expected.r);
+    RADIANT_EXPECT_FLOAT_EQ(pixels[(4 * i) + 1], expected.g);
+    RADIANT_EXPECT_FLOAT_EQ(pixels[(4 * i) + 2], expected.b);
+    RADIANT_EXPECT_FLOAT_EQ(pixels[(4 * i) + 3], 1.f);
+  }
+  free(pixels);
+  return true;
+}
+
+static bool empty_frame_fails() {
+  radiant_tracer_create_request_t req = request(2);
+  req.width = 0;
+  RADIANT_EXPECT_FALSE(radiant_tracer_create(req).succeeded);
+  return true;
+}
+
+static bool sky_only() {
+  radiant_tracer_create_request_t req = request(0);
+  req.lighting.sky_zenith = (radiant_colour3_t){0.25f, 0.5f, 0.75f};
+  req.lighting.sky_horizon = req.lighting.sky_zenith;
+  radiant_tracer_create_result_t result = radiant_tracer_create(req);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_tracer_render(&result.tracer, 2);
+  RADIANT_EXPECT_EQ(result.tracer.sample_count, 2);
+  RADIANT_EXPECT_TRUE(every_pixel(&result.tracer, req.lighting.sky_zenith));
+  radiant_tracer_destroy(result.tracer);
+  return true;
+}
+
+static bool furnace() {
+  // Every bounce off the ground reaches a uniform sky, so each sample is
+  // exactly the albedo times the sky, whatever direction was chosen.
+  radiant_tracer_create_result_t result = radiant_tracer_create(request(2));
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_tracer_render(&result.tracer, 4);
+  RADIANT_EXPECT_TRUE(
+      every_pixel(&result.tracer, (radiant_colour3_t){0.5f, 0.5f, 0.5f}));
+
+  // Without bounces the ground only sees the sun, and there is none.
+  result.tracer.max_bounces = 0;
+  radiant_tracer_reset(&result.tracer);
+  radiant_tracer_render(&result.tracer, 1);
+  RADIANT_EXPECT_TRUE(
+      every_pixel(&result.tracer, (radiant_colour3_t){0.f, 0.f, 0.f}));
+  radiant_tracer_destroy(result.tracer);
+  return true;
+}
+
+static bool sun_and_shadow() {
+  radiant_tracer_create_request_t req = request(4);
+  req.lighting.sky_zenith = (radiant_colour3_t){0.f, 0.f, 0.f};
+  req.lighting.sky_horizon = req.lighting.sky_zenith;
+  // The sun is 45 degrees up so the shadow of the roof is not under it. An
+  // irradiance of pi * sqrt(2) cancels the cosine and the 1 / pi of the
+  // diffuse BRDF.
+  float sun = RADIANT_PI * sqrtf(2.f);
+  req.lighting.sun_direction = (radiant_vec3_t){1.f, 1.f, 0.f};
+  req.lighting.sun_colour = (radiant_colour3_t){sun, sun, 0.f};
+  req.colour_offset = offsetof(vertex_t, colour);
+  req.max_bounces = 0;
+  radiant_tracer_create_result_t result = radiant_tracer_create(req);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_tracer_render(&result.tracer, 1);
+
+  float* pixels = (float*)malloc(WIDTH * HEIGHT * 4 * sizeof(float));
+  radiant_tracer_resolve(&result.tracer, pixels);
+  uint32_t lit = 0;
+  uint32_t shadowed = 0;
+  uint32_t roof = 0;
+  for (uint32_t i = 0; i < WIDTH * HEIGHT; ++i) {
+    float r = pixels[4 * i];
+    float g = pixels[(4 * i) + 1];
+    if (radiant_equal(r, 1.f)) {
+      // Lit red ground.
+      RADIANT_EXPECT_FLOAT_EQ(g, 0.f);
+      ++lit;
+    } else if (radiant_equal(g, 1.f)) {
+      // The green roof, lit from above.
+      RADIANT_EXPECT_FLOAT_EQ(r, 0.f);
+      ++roof;
+    } else {
+      // Ground in the shadow of the roof.
+      RADIANT_EXPECT_FLOAT_EQ(r, 0.f);
+      RADIANT_EXPECT_FLOAT_EQ(g, 0.f);
+      ++shadowed;
+    }
+  }
+  RADIANT_EXPECT_TRUE(lit > 0);
+  RADIANT_EXPECT_TRUE(roof > 0);
+  RADIANT_EXPECT_TRUE(shadowed > 0);
+  free(pixels);
+  radiant_tracer_destroy(result.tracer);
+  return true;
+}
+
+static bool thread_count_independent() {
+  radiant_tracer_create_request_t req = request(4);
+  req.lighting.sky_zenith = (radiant_colour3_t){0.2f, 0.4f, 1.f};
+  req.lighting.sun_colour = (radiant_colour3_t){2.f, 2.f, 2.f};
+  req.lighting.sun_direction = (radiant_vec3_t){1.f, 2.f, 0.5f};
+  req.colour_offset = offsetof(vertex_t, colour);
+  radiant_tracer_create_result_t serial = radiant_tracer_create(req);
+  req.thread_count = 4;
+  radiant_tracer_create_result_t parallel = radiant_tracer_create(req);
+  RADIANT_EXPECT_TRUE(serial.succeeded);
+  RADIANT_EXPECT_TRUE(parallel.succeeded);
+
+  // Progressive passes add up to one long pass.
+  radiant_tracer_render(&serial.tracer, 3);
+  radiant_tracer_render(&parallel.tracer, 1);
+  radiant_tracer_render(&parallel.tracer, 2);
+  RADIANT_EXPECT_EQ(parallel.tracer.sample_count, 3);
+  RADIANT_EXPECT_EQ(memcmp(serial.tracer.accumulation,
+                           parallel.tracer.accumulation,
+                           WIDTH * HEIGHT * 3 * sizeof(float)),
+                    0);
+  radiant_tracer_destroy(serial.tracer);
+  radiant_tracer_destroy(parallel.tracer);
+  return true;
+}
+
+static bool set_camera_resets() {
+  radiant_tracer_create_request_t req = request(2);
+  radiant_tracer_create_result_t result = radiant_tracer_create(req);
+  RADIANT_EXPECT_TRUE(result.succeeded);
+  radiant_tracer_render(&result.tracer, 1);
+  RADIANT_EXPECT_EQ(result.tracer.sample_count, 1);
+  RADIANT_EXPECT_TRUE(radiant_tracer_set_camera(&result.tracer, &req.camera));
+  RADIANT_EXPECT_EQ(result.tracer.sample_count, 0);
+  RADIANT_EXPECT_TRUE(
+      every_pixel(&result.tracer, (radiant_colour3_t){0.f, 0.f, 0.f}));
+  radiant_tracer_destroy(result.tracer);
+  return true;
+}
+
+int main() {
+  radiant_suite_begin("tracer");
+  RADIANT_TEST(empty_frame_fails);
+  RADIANT_TEST(sky_only);
+  RADIANT_TEST(furnace);
+  RADIANT_TEST(sun_and_shadow);
+  RADIANT_TEST(thread_count_independent);
+  RADIANT_TEST(set_camera_resets);
+  return radiant_suite_end();
+}
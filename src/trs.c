@@ -0,0 +1,23 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/trs.h"
+
+radiant_trs_t radiant_trs_identity(void) {
+  return (radiant_trs_t){
+      .translation = {0.f, 0.f, 0.f},
+      .rotation = radiant_quat_identity(),
+      .scale = {1.f, 1.f, 1.f},
+  };
+}
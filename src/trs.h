@@ -0,0 +1,31 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "src/quat.h"
+#include "src/vec3.h"
+
+/// The translation, rotation and scale components of a model matrix.
+typedef struct radiant_trs_t {
+  /// Translation
+  radiant_vec3_t translation;
+  /// Rotation, must be normalized
+  radiant_quat_t rotation;
+  /// Scale along each axis
+  radiant_vec3_t scale;
+} radiant_trs_t;
+
+/// Returns the transform that changes nothing.
+radiant_trs_t radiant_trs_identity(void);
@@ -17,6 +17,7 @@
 #include <math.h>
 
 #include "src/assert.h"
+#include "src/simd.h"
 #include "src/unreachable.h"
 
 radiant_vec4_t radiant_vec4_add(radiant_vec4_t a, radiant_vec4_t b) {
@@ -83,18 +84,10 @@ float radiant_vec4_length_squared(radiant_vec4_t a) {
 }
 
 float radiant_vec4_dot(radiant_vec4_t a, radiant_vec4_t b) {
-  return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
+  return radiant_simd_ops()->vec4_dot(&a, &b);
 }
 
 radiant_vec4_t radiant_vec4_normalize(radiant_vec4_t a) {
-  float len = radiant_vec4_length(a);
-  if (len == 0.0f) {
-    return (radiant_vec4_t){
-        .x = 0.f,
-        .y = 0.f,
-        .z = 0.f,
-        .w = 0.f,
-    };
-  }
-  return radiant_vec4_div(a, radiant_vec4_length(a));
+  radiant_simd_ops()->vec4_normalize(&a, &a);
+  return a;
 }
@@ -208,16 +208,16 @@ static bool normalize_zero() {
 
 int main() {
   radiant_suite_begin("vec4");
-  RADIANT_TEST(add);
-  RADIANT_TEST(sub);
-  RADIANT_TEST(mul);
-  RADIANT_TEST(div);
-  RADIANT_TEST(scale);
-  RADIANT_TEST(negate);
-  RADIANT_TEST(length);
-  RADIANT_TEST(length_squared);
-  RADIANT_TEST(dot);
-  RADIANT_TEST(normalize);
-  RADIANT_TEST(normalize_zero);
+  RADIANT_TEST_ALL_BACKENDS(add);
+  RADIANT_TEST_ALL_BACKENDS(sub);
+  RADIANT_TEST_ALL_BACKENDS(mul);
+  RADIANT_TEST_ALL_BACKENDS(div);
+  RADIANT_TEST_ALL_BACKENDS(scale);
+  RADIANT_TEST_ALL_BACKENDS(negate);
+  RADIANT_TEST_ALL_BACKENDS(length);
+  RADIANT_TEST_ALL_BACKENDS(length_squared);
+  RADIANT_TEST_ALL_BACKENDS(dot);
+  RADIANT_TEST_ALL_BACKENDS(normalize);
+  RADIANT_TEST_ALL_BACKENDS(normalize_zero);
   return radiant_suite_end();
 }
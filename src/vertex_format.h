@@ -0,0 +1,43 @@
+// Copyright 2023 The Radiant Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "src/wgpu.h"
+
+/// Vertex attribute formats, with the values of the matching
+/// WGPUVertexFormat. The compact formats are produced by the functions in
+/// pack.h.
+typedef enum radiant_vertex_format_t {
+  /// Three floats, 12 bytes
+  radiant_vertex_format_float32x3 = WGPUVertexFormat_Float32x3,
+  /// Four floats, 16 bytes
+  radiant_vertex_format_float32x4 = WGPUVertexFormat_Float32x4,
+  /// Two halves from radiant_pack_f16, 4 bytes
+  radiant_vertex_format_float16x2 = WGPUVertexFormat_Float16x2,
+  /// Four halves from radiant_pack_f16, 8 bytes. Also used for positions,
+  /// with the fourth half unused, as there is no three half format.
+  radiant_vertex_format_float16x4 = WGPUVertexFormat_Float16x4,
+  /// Four bytes from radiant_pack_unorm8, read as floats in [0, 1]
+  radiant_vertex_format_unorm8x4 = WGPUVertexFormat_Unorm8x4,
+  /// Two values from radiant_pack_snorm16, read as floats in [-1, 1]
+  radiant_vertex_format_snorm16x2 = WGPUVertexFormat_Snorm16x2,
+  /// Four values from radiant_pack_snorm16, read as floats in [-1, 1]
+  radiant_vertex_format_snorm16x4 = WGPUVertexFormat_Snorm16x4,
+  /// A normal from radiant_pack_octahedral, read as a vec2f the shader
+  /// unfolds.
+  radiant_vertex_format_octahedral = WGPUVertexFormat_Snorm16x2,
+
+  radiant_vertex_format_enum_sizer = WGPUVertexFormat_Force32,
+} radiant_vertex_format_t;
@@ -38,6 +38,10 @@ void radiant_windows_poll_events() {
   glfwPollEvents();
 }
 
+void radiant_windows_wait_events() {
+  glfwWaitEvents();
+}
+
 radiant_window_create_result_t radiant_window_create(radiant_view_t view) {
   glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
   glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_FALSE);
@@ -65,3 +69,13 @@ void radiant_window_destroy(radiant_window_t window) {
 bool radiant_window_should_close(radiant_window_t window) {
   return glfwWindowShouldClose(window.glfw_window);
 }
+
+radiant_size_t radiant_window_framebuffer_size(radiant_window_t window) {
+  int width = 0;
+  int height = 0;
+  glfwGetFramebufferSize(window.glfw_window, &width, &height);
+  return (radiant_size_t){
+      .width = (uint32_t)width,
+      .height = (uint32_t)height,
+  };
+}
@@ -16,6 +16,7 @@
 
 #include "src/glfw.h"
 #include "src/pad.h"
+#include "src/size.h"
 #include "src/view.h"
 
 #include <stdbool.h>
@@ -42,6 +43,8 @@ void radiant_windows_shutdown(void);
 
 /// Polls the window system for new events
 void radiant_windows_poll_events(void);
+/// Blocks until the window system has new events, then processes them
+void radiant_windows_wait_events(void);
 
 /// Creates a new window
 radiant_window_create_result_t radiant_window_create(radiant_view_t view);
@@ -50,3 +53,8 @@ void radiant_window_destroy(radiant_window_t window);
 
 /// Returns true if |window| should close
 bool radiant_window_should_close(radiant_window_t window);
+
+/// Returns the size of the framebuffer of |window| in pixels, empty while it
+/// is minimized. Changes as the window is resized, after
+/// radiant_windows_poll_events delivers the resize.
+radiant_size_t radiant_window_framebuffer_size(radiant_window_t window);